@@ -0,0 +1,135 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScene.h"
+
+#include <sofa/component/topology/container/dynamic/TetrahedronSetGeometryAlgorithms.h>
+#include <sofa/simulation/Simulation.h>
+
+#include <array>
+
+namespace sofa::benchmarks
+{
+
+TetrahedralMesh createTetrahedralMesh(sofa::Size cellsPerSide)
+{
+    TetrahedralMesh mesh;
+
+    const sofa::Size n = cellsPerSide + 1;
+    const auto vertex = [n](sofa::Size i, sofa::Size j, sofa::Size k)
+    {
+        return static_cast<sofa::Index>(i + n * (j + n * k));
+    };
+
+    mesh.positions.reserve(n * n * n);
+    for (sofa::Size k = 0; k < n; ++k)
+    {
+        for (sofa::Size j = 0; j < n; ++j)
+        {
+            for (sofa::Size i = 0; i < n; ++i)
+            {
+                mesh.positions.emplace_back(i, j, k);
+            }
+        }
+    }
+
+    // the 6 tetrahedra share the diagonal from corner 0 to corner 7, so that the faces match between cells
+    static constexpr std::array<std::array<sofa::Index, 4>, 6> cellTetrahedra {{
+        {0, 1, 3, 7}, {0, 1, 5, 7}, {0, 2, 3, 7}, {0, 2, 6, 7}, {0, 4, 5, 7}, {0, 4, 6, 7}
+    }};
+
+    mesh.tetrahedra.reserve(6 * cellsPerSide * cellsPerSide * cellsPerSide);
+    for (sofa::Size k = 0; k < cellsPerSide; ++k)
+    {
+        for (sofa::Size j = 0; j < cellsPerSide; ++j)
+        {
+            for (sofa::Size i = 0; i < cellsPerSide; ++i)
+            {
+                std::array<sofa::Index, 8> corners;
+                for (sofa::Index c = 0; c < 8; ++c)
+                {
+                    corners[c] = vertex(i + (c & 1), j + ((c >> 1) & 1), k + ((c >> 2) & 1));
+                }
+
+                for (const auto& t : cellTetrahedra)
+                {
+                    core::topology::BaseMeshTopology::Tetrahedron tetrahedron(corners[t[0]], corners[t[1]], corners[t[2]], corners[t[3]]);
+
+                    // positive orientation
+                    const auto& p = mesh.positions;
+                    const auto volume = dot(p[tetrahedron[1]] - p[tetrahedron[0]],
+                        cross(p[tetrahedron[2]] - p[tetrahedron[0]], p[tetrahedron[3]] - p[tetrahedron[0]]));
+                    if (volume < 0)
+                    {
+                        std::swap(tetrahedron[2], tetrahedron[3]);
+                    }
+                    mesh.tetrahedra.push_back(tetrahedron);
+                }
+            }
+        }
+    }
+
+    return mesh;
+}
+
+TetrahedralScene::TetrahedralScene(sofa::Size cellsPerSide)
+{
+    const TetrahedralMesh mesh = createTetrahedralMesh(cellsPerSide);
+
+    root = simulation::getSimulation()->createNewGraph("root");
+
+    topology = core::objectmodel::New<TetrahedronSetTopologyContainer>();
+    topology->d_initPoints.setValue(mesh.positions);
+    topology->d_tetrahedron.setValue(mesh.tetrahedra);
+    root->addObject(topology);
+
+    root->addObject(core::objectmodel::New<component::topology::container::dynamic::TetrahedronSetGeometryAlgorithms<defaulttype::Vec3Types> >());
+
+    state = core::objectmodel::New<MechanicalObject3>();
+    state->resize(static_cast<sofa::Size>(mesh.positions.size()));
+    {
+        auto x = helper::getWriteOnlyAccessor(state->x);
+        auto x0 = helper::getWriteOnlyAccessor(state->x0);
+        for (std::size_t i = 0; i < mesh.positions.size(); ++i)
+        {
+            x[i] = mesh.positions[i];
+            x0[i] = mesh.positions[i];
+        }
+    }
+    root->addObject(state);
+}
+
+TetrahedralScene::~TetrahedralScene()
+{
+    simulation::node::unload(root);
+}
+
+void TetrahedralScene::init()
+{
+    simulation::node::initRoot(root.get());
+}
+
+void meshSizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->RangeMultiplier(2)->Range(minCellsPerSide, maxCellsPerSide)->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace sofa::benchmarks
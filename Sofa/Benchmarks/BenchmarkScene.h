@@ -0,0 +1,94 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyContainer.h>
+#include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/type/Mat.h>
+
+#include <benchmark/benchmark.h>
+
+namespace sofa::benchmarks
+{
+
+using MechanicalObject3 = sofa::component::statecontainer::MechanicalObject<defaulttype::Vec3Types>;
+using TetrahedronSetTopologyContainer = sofa::component::topology::container::dynamic::TetrahedronSetTopologyContainer;
+
+/// Cells per side of the meshes used by the benchmarks depending on the mesh size
+inline constexpr int minCellsPerSide = 4;
+inline constexpr int maxCellsPerSide = 32;
+
+/// Regular tetrahedral mesh of a cube made of n x n x n cells, each cell is split in 6 tetrahedra
+struct TetrahedralMesh
+{
+    type::vector<type::Vec3> positions;
+    type::vector<core::topology::BaseMeshTopology::Tetrahedron> tetrahedra;
+};
+
+TetrahedralMesh createTetrahedralMesh(sofa::Size cellsPerSide);
+
+/// Add a 3x3 block for each pair of vertices of each tetrahedron, as the assembly of a stiffness matrix.
+/// The resulting matrix is symmetric positive definite.
+template<class TMatrix>
+void assembleTetrahedra(TMatrix& matrix, const TetrahedralMesh& mesh)
+{
+    const type::Mat3x3d diagonalBlock(type::Vec3d(5, 1, 1), type::Vec3d(1, 5, 1), type::Vec3d(1, 1, 5));
+    const type::Mat3x3d offDiagonalBlock(type::Vec3d(-1, 0, 0), type::Vec3d(0, -1, 0), type::Vec3d(0, 0, -1));
+
+    const auto n = static_cast<sofa::SignedIndex>(3 * mesh.positions.size());
+    matrix.resize(n, n);
+    for (const auto& tetrahedron : mesh.tetrahedra)
+    {
+        for (sofa::Index a = 0; a < 4; ++a)
+        {
+            for (sofa::Index b = 0; b < 4; ++b)
+            {
+                matrix.add(3 * tetrahedron[a], 3 * tetrahedron[b], a == b ? diagonalBlock : offDiagonalBlock);
+            }
+        }
+    }
+    matrix.compress();
+}
+
+/**
+ * Graph made of a tetrahedral mesh (topology container, geometry algorithms and mechanical object)
+ * in the root node. The benchmarks add the components to measure, then call init().
+ */
+struct TetrahedralScene
+{
+    explicit TetrahedralScene(sofa::Size cellsPerSide);
+    ~TetrahedralScene();
+
+    void init();
+
+    simulation::Node::SPtr root;
+    TetrahedronSetTopologyContainer::SPtr topology;
+    MechanicalObject3::SPtr state;
+};
+
+/// Register the mesh sizes from minCellsPerSide to maxCellsPerSide
+void meshSizes(benchmark::internal::Benchmark* benchmark);
+
+} // namespace sofa::benchmarks
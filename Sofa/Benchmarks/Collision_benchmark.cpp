@@ -0,0 +1,183 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScene.h"
+
+#include <sofa/component/collision/detection/algorithm/BVHNarrowPhase.h>
+#include <sofa/component/collision/detection/algorithm/BruteForceBroadPhase.h>
+#include <sofa/component/collision/detection/intersection/MinProximityIntersection.h>
+#include <sofa/component/collision/geometry/SphereModel.h>
+#include <sofa/simulation/Simulation.h>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+using component::collision::detection::algorithm::BruteForceBroadPhase;
+using component::collision::detection::algorithm::BVHNarrowPhase;
+using component::collision::detection::intersection::MinProximityIntersection;
+using SphereCollisionModel3 = component::collision::geometry::SphereCollisionModel<defaulttype::Vec3Types>;
+
+/**
+ * Two interleaved grids of n x n x n spheres, each sphere of a grid is in contact
+ * with the closest spheres of the other grid.
+ */
+struct SphereGridsScene
+{
+    explicit SphereGridsScene(sofa::Size n)
+    {
+        root = simulation::getSimulation()->createNewGraph("root");
+
+        intersection = core::objectmodel::New<MinProximityIntersection>();
+        intersection->setAlarmDistance(0.1);
+        intersection->setContactDistance(0.05);
+        root->addObject(intersection);
+
+        broadPhase = core::objectmodel::New<BruteForceBroadPhase>();
+        root->addObject(broadPhase);
+        narrowPhase = core::objectmodel::New<BVHNarrowPhase>();
+        root->addObject(narrowPhase);
+
+        for (const SReal offset : { 0.0, 0.5 })
+        {
+            const simulation::Node::SPtr node = root->createChild(offset == 0 ? "grid1" : "grid2");
+
+            const auto state = core::objectmodel::New<MechanicalObject3>();
+            state->resize(n * n * n);
+            {
+                auto x = helper::getWriteOnlyAccessor(state->x);
+                for (sofa::Size i = 0; i < x.size(); ++i)
+                {
+                    x[i] = type::Vec3(i % n, (i / n) % n, i / (n * n)) + type::Vec3(offset, offset, offset);
+                }
+            }
+            node->addObject(state);
+
+            const auto spheres = core::objectmodel::New<SphereCollisionModel3>();
+            spheres->d_defaultRadius.setValue(0.45);
+            node->addObject(spheres);
+            collisionModels.push_back(spheres.get());
+        }
+
+        simulation::node::initRoot(root.get());
+
+        broadPhase->setIntersectionMethod(intersection.get());
+        narrowPhase->setIntersectionMethod(intersection.get());
+    }
+
+    ~SphereGridsScene()
+    {
+        simulation::node::unload(root);
+    }
+
+    void computeBoundingTrees()
+    {
+        for (auto* model : collisionModels)
+        {
+            model->computeBoundingTree(6);
+        }
+    }
+
+    void broadPhaseDetection()
+    {
+        sofa::type::vector<core::CollisionModel*> models;
+        for (auto* model : collisionModels)
+        {
+            models.push_back(model->getFirst());
+        }
+
+        intersection->beginBroadPhase();
+        broadPhase->beginBroadPhase();
+        broadPhase->addCollisionModels(models);
+        broadPhase->endBroadPhase();
+        intersection->endBroadPhase();
+    }
+
+    void narrowPhaseDetection()
+    {
+        intersection->beginNarrowPhase();
+        narrowPhase->beginNarrowPhase();
+        narrowPhase->addCollisionPairs(broadPhase->getCollisionModelPairs());
+        narrowPhase->endNarrowPhase();
+        intersection->endNarrowPhase();
+    }
+
+    simulation::Node::SPtr root;
+    MinProximityIntersection::SPtr intersection;
+    BruteForceBroadPhase::SPtr broadPhase;
+    BVHNarrowPhase::SPtr narrowPhase;
+    sofa::type::vector<core::CollisionModel*> collisionModels;
+};
+
+void BM_SphereCollision_boundingTree(benchmark::State& state)
+{
+    SphereGridsScene scene(static_cast<sofa::Size>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        scene.computeBoundingTrees();
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2 * state.range(0) * state.range(0) * state.range(0));
+}
+
+void BM_SphereCollision_broadPhase(benchmark::State& state)
+{
+    SphereGridsScene scene(static_cast<sofa::Size>(state.range(0)));
+    scene.computeBoundingTrees();
+
+    for (auto _ : state)
+    {
+        scene.broadPhaseDetection();
+    }
+
+    state.counters["pairs"] = static_cast<double>(scene.broadPhase->getCollisionModelPairs().size());
+}
+
+void BM_SphereCollision_narrowPhase(benchmark::State& state)
+{
+    SphereGridsScene scene(static_cast<sofa::Size>(state.range(0)));
+    scene.computeBoundingTrees();
+    scene.broadPhaseDetection();
+
+    for (auto _ : state)
+    {
+        scene.narrowPhaseDetection();
+    }
+
+    std::size_t nbContacts = 0;
+    for (const auto& [pair, outputs] : scene.narrowPhase->getDetectionOutputs())
+    {
+        nbContacts += outputs ? outputs->size() : 0;
+    }
+    state.counters["contacts"] = static_cast<double>(nbContacts);
+    state.counters["primitiveTests"] = static_cast<double>(scene.narrowPhase->getPrimitiveTestCount());
+}
+
+}
+
+BENCHMARK(BM_SphereCollision_boundingTree)->Apply(meshSizes);
+BENCHMARK(BM_SphereCollision_broadPhase)->Apply(meshSizes);
+BENCHMARK(BM_SphereCollision_narrowPhase)->Apply(meshSizes);
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,109 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScene.h"
+
+#include <sofa/component/constraint/lagrangian/model/UnilateralConstraintResolution.h>
+#include <sofa/component/constraint/lagrangian/solver/GenericConstraintProblem.h>
+#include <sofa/component/constraint/lagrangian/solver/GenericConstraintSolver.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+using component::constraint::lagrangian::solver::GenericConstraintProblem;
+using component::constraint::lagrangian::solver::GenericConstraintSolver;
+
+/**
+ * Frictional contacts (3 lines each) coupled by a dense compliance matrix W = A A^T / m + 0.1 I,
+ * where A plays the role of the constraint Jacobian. All the contacts are penetrating.
+ */
+void createContactProblem(GenericConstraintProblem& problem, int nbContacts)
+{
+    const int dimension = 3 * nbContacts;
+    const int nbDofs = dimension;
+    problem.clear(dimension);
+
+    std::vector<SReal> jacobian(static_cast<std::size_t>(dimension) * nbDofs);
+    for (int i = 0; i < dimension; ++i)
+    {
+        for (int k = 0; k < nbDofs; ++k)
+        {
+            jacobian[i * nbDofs + k] = std::sin(static_cast<SReal>(7 * i + 3 * k + 1));
+        }
+    }
+
+    SReal** w = problem.getW();
+    for (int i = 0; i < dimension; ++i)
+    {
+        for (int j = 0; j <= i; ++j)
+        {
+            SReal wij = 0;
+            for (int k = 0; k < nbDofs; ++k)
+            {
+                wij += jacobian[i * nbDofs + k] * jacobian[j * nbDofs + k];
+            }
+            wij /= nbDofs;
+            w[i][j] = w[j][i] = wij + (i == j ? 0.1 : 0.0);
+        }
+    }
+
+    SReal* dFree = problem.getDfree();
+    for (int c = 0; c < nbContacts; ++c)
+    {
+        dFree[3 * c] = -0.01 * (1 + c % 3);
+        dFree[3 * c + 1] = 0.001 * std::cos(static_cast<SReal>(c));
+        dFree[3 * c + 2] = 0.001 * std::sin(static_cast<SReal>(c));
+        problem.constraintsResolutions[3 * c] = new component::constraint::lagrangian::model::UnilateralConstraintResolutionWithFriction(0.3);
+    }
+
+    problem.tolerance = 1e-6;
+    problem.maxIterations = 1000;
+}
+
+/// Projected Gauss-Seidel on the built compliance matrix, without warm start
+void BM_GenericConstraintProblem_gaussSeidel(benchmark::State& state)
+{
+    const auto solver = core::objectmodel::New<GenericConstraintSolver>();
+
+    GenericConstraintProblem problem;
+    createContactProblem(problem, static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::fill(problem.getF(), problem.getF() + problem.getDimension(), SReal(0));
+        problem.gaussSeidel(0, solver.get());
+    }
+
+    state.counters["iterations"] = problem.currentIterations;
+    state.counters["error"] = problem.currentError;
+}
+
+}
+
+BENCHMARK(BM_GenericConstraintProblem_gaussSeidel)->RangeMultiplier(2)->Range(16, 256)->ArgName("contacts")->Unit(benchmark::kMicrosecond);
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,116 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScene.h"
+
+#include <sofa/component/solidmechanics/fem/elastic/TetrahedronFEMForceField.h>
+#include <sofa/core/MechanicalParams.h>
+
+#include <array>
+#include <cmath>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+using TetrahedronFEMForceField3 = sofa::component::solidmechanics::fem::elastic::TetrahedronFEMForceField<defaulttype::Vec3Types>;
+
+/// Mesh slightly deformed, so that the rotations are not the identity
+core::behavior::BaseForceField::SPtr createTetrahedronFEMScene(TetrahedralScene& scene, int method)
+{
+    const auto forceField = core::objectmodel::New<TetrahedronFEMForceField3>();
+    forceField->setMethod(method);
+    scene.root->addObject(forceField);
+    scene.init();
+
+    auto x = helper::getWriteAccessor(scene.state->x);
+    auto dx = helper::getWriteOnlyAccessor(scene.state->dx);
+    dx.resize(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        const SReal t = static_cast<SReal>(i);
+        x[i] += type::Vec3(0.1 * std::sin(t), 0.1 * std::cos(t), 0.05 * std::sin(2 * t));
+        dx[i] = type::Vec3(0.01 * std::cos(t), 0.01, -0.01 * std::sin(t));
+    }
+    return forceField;
+}
+
+const char* methodName(int method)
+{
+    static constexpr std::array<const char*, 4> names { "small", "large", "polar", "svd" };
+    return names[method];
+}
+
+void BM_TetrahedronFEMForceField_addForce(benchmark::State& state)
+{
+    TetrahedralScene scene(static_cast<sofa::Size>(state.range(0)));
+    const auto method = static_cast<int>(state.range(1));
+    const auto forceField = createTetrahedronFEMScene(scene, method);
+    const auto nbElements = scene.topology->getNbTetrahedra();
+
+    const core::MechanicalParams* mparams = core::mechanicalparams::defaultInstance();
+    for (auto _ : state)
+    {
+        forceField->addForce(mparams, core::VecDerivId::force());
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbElements);
+    state.SetLabel(methodName(method));
+}
+
+void BM_TetrahedronFEMForceField_addDForce(benchmark::State& state)
+{
+    TetrahedralScene scene(static_cast<sofa::Size>(state.range(0)));
+    const auto method = static_cast<int>(state.range(1));
+    const auto forceField = createTetrahedronFEMScene(scene, method);
+    const auto nbElements = scene.topology->getNbTetrahedra();
+
+    core::MechanicalParams mparams;
+    mparams.setKFactor(1.0);
+
+    // the rotations used by addDForce are computed in addForce
+    forceField->addForce(&mparams, core::VecDerivId::force());
+
+    for (auto _ : state)
+    {
+        forceField->addDForce(&mparams, core::VecDerivId::force());
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbElements);
+    state.SetLabel(methodName(method));
+}
+
+void meshSizesAndMethods(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgsProduct({
+        benchmark::CreateRange(minCellsPerSide, maxCellsPerSide, 2),
+        { TetrahedronFEMForceField3::SMALL, TetrahedronFEMForceField3::LARGE, TetrahedronFEMForceField3::POLAR }
+    })->ArgNames({ "cells", "method" })->Unit(benchmark::kMicrosecond);
+}
+
+}
+
+BENCHMARK(BM_TetrahedronFEMForceField_addForce)->Apply(meshSizesAndMethods);
+BENCHMARK(BM_TetrahedronFEMForceField_addDForce)->Apply(meshSizesAndMethods);
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,113 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScene.h"
+
+#include <sofa/component/linearsolver/direct/SparseLDLSolver.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/linearalgebra/FullVector.h>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+using Matrix = linearalgebra::CompressedRowSparseMatrix<SReal>;
+using Vector = linearalgebra::FullVector<SReal>;
+using SparseLDLSolver = component::linearsolver::direct::SparseLDLSolver<Matrix, Vector>;
+
+/// Direct solver of the assembled matrix of a tetrahedral mesh, in full (0) or mixed (1) precision
+SparseLDLSolver::SPtr createSparseLDLSolver(const benchmark::State& state, Matrix& matrix)
+{
+    assembleTetrahedra(matrix, createTetrahedralMesh(static_cast<sofa::Size>(state.range(0))));
+
+    const SparseLDLSolver::SPtr solver = core::objectmodel::New<SparseLDLSolver>();
+    solver->d_mixedPrecision.setValue(state.range(1) != 0);
+    solver->init();
+    return solver;
+}
+
+/// Number of non-zero values of the factor L, the main driver of the cost of the factorization and of the solves
+double factorNonZeros(const SparseLDLSolver& solver)
+{
+    const auto* L_nnz = dynamic_cast<const core::objectmodel::Data<int>*>(solver.findData("L_nnz"));
+    return L_nnz ? static_cast<double>(L_nnz->getValue()) : 0.;
+}
+
+void BM_SparseLDLSolver_factorize(benchmark::State& state)
+{
+    Matrix matrix;
+    const auto solver = createSparseLDLSolver(state, matrix);
+
+    for (auto _ : state)
+    {
+        solver->invert(matrix);
+    }
+
+    state.counters["dofs"] = static_cast<double>(matrix.rowSize());
+    state.counters["L_nnz"] = factorNonZeros(*solver);
+    state.SetLabel(state.range(1) ? "mixed precision" : "full precision");
+}
+
+void BM_SparseLDLSolver_solve(benchmark::State& state)
+{
+    Matrix matrix;
+    const auto solver = createSparseLDLSolver(state, matrix);
+    solver->invert(matrix);
+
+    const auto n = matrix.rowSize();
+    Vector x(n), b(n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        b[i] = static_cast<SReal>(i % 5) - 2;
+    }
+
+    for (auto _ : state)
+    {
+        solver->solve(matrix, x, b);
+        benchmark::DoNotOptimize(x.ptr());
+    }
+
+    // relative residual |b - Ax| / |b| of the solution, reached after the iterative refinement in mixed precision
+    Vector r(n);
+    matrix.mul(r, x);
+    r.eq(b, r, -1);
+
+    state.counters["dofs"] = static_cast<double>(n);
+    state.counters["L_nnz"] = factorNonZeros(*solver);
+    state.counters["residual"] = r.norm() / b.norm();
+    state.SetLabel(state.range(1) ? "mixed precision" : "full precision");
+}
+
+/// The factorization of the largest meshes would take most of the run time
+void directSolverSizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgsProduct({ benchmark::CreateRange(minCellsPerSide, maxCellsPerSide / 2, 2), { 0, 1 } })
+        ->ArgNames({ "cells", "mixed" })->Unit(benchmark::kMillisecond);
+}
+
+}
+
+BENCHMARK(BM_SparseLDLSolver_factorize)->Apply(directSolverSizes);
+BENCHMARK(BM_SparseLDLSolver_solve)->Apply(directSolverSizes);
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,95 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/init.h>
+#include <sofa/helper/logging/ConsoleMessageHandler.h>
+#include <sofa/helper/logging/Messaging.h>
+#include <sofa/simulation/graph/init.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+/// Print only the errors, on the standard error: the other messages would be mixed with the results
+class ErrorMessageHandler : public sofa::helper::logging::MessageHandler
+{
+public:
+    void process(sofa::helper::logging::Message& m) override
+    {
+        if (m.type() >= sofa::helper::logging::Message::Error)
+        {
+            m_console.process(m);
+        }
+    }
+
+private:
+    sofa::helper::logging::ConsoleMessageHandler m_console;
+};
+
+}
+
+/**
+ * Micro-benchmarks of the computational kernels of the components.
+ *
+ * The arguments are the ones of google benchmark (e.g. --benchmark_filter=addForce).
+ * The results are written in JSON on the standard output, unless another format is
+ * requested with --benchmark_format. Use --benchmark_out=<file> to write them in a file,
+ * and compare the files of two commits with the compare.py script of google benchmark.
+ */
+int main(int argc, char** argv)
+{
+    std::vector<char*> arguments(argv, argv + argc);
+
+    std::string jsonFormat = "--benchmark_format=json";
+    bool hasFormat = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        hasFormat = hasFormat || std::string_view(argv[i]).rfind("--benchmark_format", 0) == 0;
+    }
+    if (!hasFormat)
+    {
+        arguments.push_back(jsonFormat.data());
+    }
+
+    int nbArguments = static_cast<int>(arguments.size());
+    benchmark::Initialize(&nbArguments, arguments.data());
+    if (benchmark::ReportUnrecognizedArguments(nbArguments, arguments.data()))
+    {
+        return 1;
+    }
+
+    sofa::simulation::graph::init();
+    sofa::component::init();
+
+    static ErrorMessageHandler errorHandler;
+    sofa::helper::logging::MessageDispatcher::clearHandlers();
+    sofa::helper::logging::MessageDispatcher::addHandler(&errorHandler);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    sofa::simulation::graph::cleanup();
+    return 0;
+}
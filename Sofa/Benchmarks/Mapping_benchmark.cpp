@@ -0,0 +1,107 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScene.h"
+
+#include <sofa/component/mapping/linear/BarycentricMapping.h>
+#include <sofa/core/MechanicalParams.h>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+using BarycentricMapping3 = sofa::component::mapping::linear::BarycentricMapping<defaulttype::Vec3Types, defaulttype::Vec3Types>;
+
+/// One mapped point at the center of each tetrahedron
+core::BaseMapping::SPtr createBarycentricMappingScene(TetrahedralScene& scene, MechanicalObject3::SPtr& mappedState)
+{
+    const simulation::Node::SPtr child = scene.root->createChild("mapped");
+
+    const auto& positions = scene.topology->d_initPoints.getValue();
+    const auto& tetrahedra = scene.topology->d_tetrahedron.getValue();
+
+    mappedState = core::objectmodel::New<MechanicalObject3>();
+    mappedState->resize(static_cast<sofa::Size>(tetrahedra.size()));
+    {
+        auto x = helper::getWriteOnlyAccessor(mappedState->x);
+        for (std::size_t i = 0; i < tetrahedra.size(); ++i)
+        {
+            const auto& t = tetrahedra[i];
+            x[i] = (positions[t[0]] + positions[t[1]] + positions[t[2]] + positions[t[3]]) * 0.25;
+        }
+    }
+    child->addObject(mappedState);
+
+    const auto mapping = core::objectmodel::New<BarycentricMapping3>();
+    mapping->setModels(scene.state.get(), mappedState.get());
+    child->addObject(mapping);
+
+    scene.init();
+    return mapping;
+}
+
+void BM_BarycentricMapping_apply(benchmark::State& state)
+{
+    TetrahedralScene scene(static_cast<sofa::Size>(state.range(0)));
+    MechanicalObject3::SPtr mappedState;
+    const auto mapping = createBarycentricMappingScene(scene, mappedState);
+
+    const core::MechanicalParams* mparams = core::mechanicalparams::defaultInstance();
+    for (auto _ : state)
+    {
+        mapping->apply(mparams, core::VecCoordId::position(), core::ConstVecCoordId::position());
+    }
+
+    state.SetItemsProcessed(state.iterations() * mappedState->getSize());
+}
+
+void BM_BarycentricMapping_applyJT(benchmark::State& state)
+{
+    TetrahedralScene scene(static_cast<sofa::Size>(state.range(0)));
+    MechanicalObject3::SPtr mappedState;
+    const auto mapping = createBarycentricMappingScene(scene, mappedState);
+
+    {
+        auto f = helper::getWriteOnlyAccessor(mappedState->f);
+        f.resize(mappedState->getSize());
+        for (std::size_t i = 0; i < f.size(); ++i)
+        {
+            f[i] = type::Vec3(0, -1, 0);
+        }
+    }
+
+    const core::MechanicalParams* mparams = core::mechanicalparams::defaultInstance();
+    for (auto _ : state)
+    {
+        mapping->applyJT(mparams, core::VecDerivId::force(), core::ConstVecDerivId::force());
+    }
+
+    state.SetItemsProcessed(state.iterations() * mappedState->getSize());
+}
+
+}
+
+BENCHMARK(BM_BarycentricMapping_apply)->Apply(meshSizes);
+BENCHMARK(BM_BarycentricMapping_applyJT)->Apply(meshSizes);
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,68 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScene.h"
+
+#include <sofa/component/mass/MeshMatrixMass.h>
+#include <sofa/component/mass/UniformMass.h>
+#include <sofa/core/MechanicalParams.h>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+template<class TMass>
+void BM_Mass_addMDx(benchmark::State& state)
+{
+    TetrahedralScene scene(static_cast<sofa::Size>(state.range(0)));
+    const core::behavior::BaseMass::SPtr mass = core::objectmodel::New<TMass>();
+    scene.root->addObject(mass);
+    scene.init();
+
+    {
+        auto dx = helper::getWriteOnlyAccessor(scene.state->dx);
+        dx.resize(scene.state->getSize());
+        for (std::size_t i = 0; i < dx.size(); ++i)
+        {
+            dx[i] = type::Vec3(1, 0.5, -1);
+        }
+    }
+
+    const core::MechanicalParams* mparams = core::mechanicalparams::defaultInstance();
+    for (auto _ : state)
+    {
+        mass->addMDx(mparams, core::VecDerivId::force(), 1.0);
+    }
+
+    state.SetItemsProcessed(state.iterations() * scene.state->getSize());
+}
+
+using UniformMass3 = sofa::component::mass::UniformMass<defaulttype::Vec3Types>;
+using MeshMatrixMass3 = sofa::component::mass::MeshMatrixMass<defaulttype::Vec3Types>;
+
+}
+
+BENCHMARK_TEMPLATE(BM_Mass_addMDx, UniformMass3)->Apply(meshSizes);
+BENCHMARK_TEMPLATE(BM_Mass_addMDx, MeshMatrixMass3)->Apply(meshSizes);
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,130 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScene.h"
+
+#include <sofa/component/linearsolver/iterative/ParallelMatrixVectorProduct.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/linearalgebra/FullVector.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+template<class TMatrix>
+void BM_SparseMatrix_assembly(benchmark::State& state)
+{
+    const TetrahedralMesh mesh = createTetrahedralMesh(static_cast<sofa::Size>(state.range(0)));
+
+    TMatrix matrix;
+    for (auto _ : state)
+    {
+        matrix.clear();
+        assembleTetrahedra(matrix, mesh);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.tetrahedra.size());
+}
+
+/// Sequential product of an assembled matrix with a vector: scalar path for scalar blocks, block kernels for 3x3 blocks
+template<class TMatrix>
+void BM_SparseMatrix_product(benchmark::State& state)
+{
+    using Vector = linearalgebra::FullVector<SReal>;
+
+    const TetrahedralMesh mesh = createTetrahedralMesh(static_cast<sofa::Size>(state.range(0)));
+    TMatrix matrix;
+    assembleTetrahedra(matrix, mesh);
+    matrix.compress();
+
+    const auto n = matrix.rowSize();
+    Vector x(n), res(n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        x[i] = static_cast<SReal>(i % 7) - 3;
+    }
+
+    for (auto _ : state)
+    {
+        matrix.mul(res, x);
+        benchmark::DoNotOptimize(res.ptr());
+    }
+
+    // scalar non-zero values, so that both paths are compared on the same work
+    state.SetItemsProcessed(state.iterations() * matrix.colsValue.size() * TMatrix::NL * TMatrix::NC);
+}
+
+/// Product of an assembled block matrix with a vector, in a single thread (0) or with the task scheduler (1)
+void BM_SparseMatrix_blockProduct(benchmark::State& state)
+{
+    using Matrix = linearalgebra::CompressedRowSparseMatrix<type::Mat3x3>;
+    using Vector = linearalgebra::FullVector<SReal>;
+
+    const TetrahedralMesh mesh = createTetrahedralMesh(static_cast<sofa::Size>(state.range(0)));
+    Matrix matrix;
+    assembleTetrahedra(matrix, mesh);
+
+    const auto n = matrix.rowSize();
+    Vector x(n), res(n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        x[i] = static_cast<SReal>(i % 7) - 3;
+    }
+
+    simulation::TaskScheduler* taskScheduler = nullptr;
+    if (state.range(1))
+    {
+        taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+    }
+
+    component::linearsolver::iterative::ParallelMatrixVectorProduct<Matrix, Vector> product;
+    for (auto _ : state)
+    {
+        product.multiply(taskScheduler, matrix, res, x);
+        benchmark::DoNotOptimize(res.ptr());
+    }
+
+    state.SetItemsProcessed(state.iterations() * matrix.colsValue.size());
+    state.SetLabel(taskScheduler ? "parallel" : "sequential");
+}
+
+using CRSMatrix = linearalgebra::CompressedRowSparseMatrix<SReal>;
+using CRSMatrix3x3 = linearalgebra::CompressedRowSparseMatrix<type::Mat3x3>;
+
+}
+
+BENCHMARK_TEMPLATE(BM_SparseMatrix_assembly, CRSMatrix)->Apply(meshSizes);
+BENCHMARK_TEMPLATE(BM_SparseMatrix_assembly, CRSMatrix3x3)->Apply(meshSizes);
+BENCHMARK_TEMPLATE(BM_SparseMatrix_product, CRSMatrix)->Apply(meshSizes);
+BENCHMARK_TEMPLATE(BM_SparseMatrix_product, CRSMatrix3x3)->Apply(meshSizes);
+BENCHMARK(BM_SparseMatrix_blockProduct)
+    ->ArgsProduct({ benchmark::CreateRange(minCellsPerSide, maxCellsPerSide, 2), { 0, 1 } })
+    ->ArgNames({ "cells", "parallel" })->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+} // namespace sofa::benchmarks
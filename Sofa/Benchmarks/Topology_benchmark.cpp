@@ -0,0 +1,58 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScene.h"
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+/// Creation of the edges, triangles and neighborhood buffers from the tetrahedra
+void BM_TetrahedronSetTopologyContainer_init(benchmark::State& state)
+{
+    const TetrahedralMesh mesh = createTetrahedralMesh(static_cast<sofa::Size>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        TetrahedronSetTopologyContainer::SPtr topology = core::objectmodel::New<TetrahedronSetTopologyContainer>();
+        topology->d_initPoints.setValue(mesh.positions);
+        topology->d_tetrahedron.setValue(mesh.tetrahedra);
+        state.ResumeTiming();
+
+        topology->init();
+
+        state.PauseTiming();
+        benchmark::DoNotOptimize(topology->getNbTriangles());
+        topology.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.tetrahedra.size());
+}
+
+}
+
+BENCHMARK(BM_TetrahedronSetTopologyContainer_init)->Apply(meshSizes);
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,378 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/animationloop/MultiRateAnimationLoop.h>
+
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/core/ConstraintParams.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/defaulttype/RigidTypes.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/VectorOperations.h>
+#include <sofa/simulation/UpdateContextVisitor.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <sofa/simulation/BaseMechanicalVisitor.h>
+#include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyPositionAndVelocityVisitor.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+
+#include <algorithm>
+#include <map>
+
+namespace sofa::component::animationloop
+{
+
+namespace
+{
+
+template<class DataTypes>
+bool computeCoordDifference(core::behavior::BaseMechanicalState* mm, core::VecDerivId result,
+                            core::ConstVecCoordId x1, core::ConstVecCoordId x0)
+{
+    auto* state = dynamic_cast<core::behavior::MechanicalState<DataTypes>*>(mm);
+    if (!state)
+    {
+        return false;
+    }
+
+    const auto& c1 = state->read(x1)->getValue();
+    const auto& c0 = state->read(x0)->getValue();
+    helper::WriteOnlyAccessor<Data<typename DataTypes::VecDeriv> > d = *state->write(result);
+    d.resize(c1.size());
+    for (std::size_t i = 0; i < c1.size(); ++i)
+    {
+        d[i] = DataTypes::coordDifference(c1[i], c0[i]);
+    }
+    return true;
+}
+
+/// Compute result = x1 - x0 on the independent mechanical states, the difference of positions being a Deriv
+class MechanicalCoordDifferenceVisitor : public simulation::BaseMechanicalVisitor
+{
+public:
+    MechanicalCoordDifferenceVisitor(const core::ExecParams* params, core::MultiVecDerivId result,
+                                     core::ConstMultiVecCoordId x1, core::ConstMultiVecCoordId x0)
+        : BaseMechanicalVisitor(params), m_result(result), m_x1(x1), m_x0(x0)
+    {}
+
+    Result fwdMechanicalState(simulation::Node* /*node*/, core::behavior::BaseMechanicalState* mm) override
+    {
+        const core::VecDerivId result = m_result.getId(mm);
+        const core::ConstVecCoordId x1 = m_x1.getId(mm);
+        const core::ConstVecCoordId x0 = m_x0.getId(mm);
+
+        const bool isComputed =
+            computeCoordDifference<defaulttype::Vec1Types>(mm, result, x1, x0) ||
+            computeCoordDifference<defaulttype::Vec2Types>(mm, result, x1, x0) ||
+            computeCoordDifference<defaulttype::Vec3Types>(mm, result, x1, x0) ||
+            computeCoordDifference<defaulttype::Vec6Types>(mm, result, x1, x0) ||
+            computeCoordDifference<defaulttype::Rigid3Types>(mm, result, x1, x0);
+
+        msg_error_when(!isComputed, mm) << "The positions of the template " << mm->getTemplateName()
+                                        << " cannot be interpolated";
+        return RESULT_CONTINUE;
+    }
+
+    const char* getClassName() const override { return "MechanicalCoordDifferenceVisitor"; }
+
+private:
+    core::MultiVecDerivId m_result;
+    core::ConstMultiVecCoordId m_x1;
+    core::ConstMultiVecCoordId m_x0;
+};
+
+}
+
+int MultiRateAnimationLoopClass = core::RegisterObject("Animation loop where each ODE solver subtree advances with its own number of substeps, the coupling with slower subtrees being interpolated.")
+        .add< MultiRateAnimationLoop >()
+        ;
+
+MultiRateAnimationLoop::MultiRateAnimationLoop()
+    : l_odeSolvers(initLink("odeSolvers", "ODE solvers advancing with their own number of substeps"))
+    , d_substeps(initData(&d_substeps, "substeps", "Number of substeps per animation step of each ODE solver of the list odeSolvers. The other ODE solvers take a single step"))
+{
+}
+
+void MultiRateAnimationLoop::init()
+{
+    Inherit1::init();
+
+    if (l_odeSolvers.size() != d_substeps.getValue().size())
+    {
+        msg_error() << "The number of substeps (" << d_substeps.getValue().size()
+                    << ") must be equal to the number of ODE solvers (" << l_odeSolvers.size() << ")";
+        this->d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    for (const unsigned int substeps : d_substeps.getValue())
+    {
+        if (substeps == 0)
+        {
+            msg_error() << "The number of substeps must be strictly positive";
+            this->d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+            return;
+        }
+    }
+
+    if (d_parallelODESolving.getValue())
+    {
+        initTaskScheduler();
+    }
+}
+
+unsigned int MultiRateAnimationLoop::getSubsteps(const simulation::Node* node) const
+{
+    const auto& substeps = d_substeps.getValue();
+    for (std::size_t i = 0; i < l_odeSolvers.size(); ++i)
+    {
+        for (const auto& solver : node->solver)
+        {
+            if (solver == l_odeSolvers.get(i))
+            {
+                return substeps[i];
+            }
+        }
+    }
+    return 1;
+}
+
+void MultiRateAnimationLoop::collectSubtrees(simulation::Node* node, std::set<simulation::Node*>& visited)
+{
+    if (!visited.insert(node).second)
+    {
+        return;
+    }
+
+    if (!node->solver.empty())
+    {
+        m_subtrees.push_back({node, getSubsteps(node)});
+        return;
+    }
+
+    for (auto* forceField : node->interactionForceField)
+    {
+        m_couplingForceFields.push_back(forceField);
+    }
+
+    for (const auto& child : node->child)
+    {
+        collectSubtrees(child.get(), visited);
+    }
+}
+
+void MultiRateAnimationLoop::interpolateSubtree(const core::ExecParams* params, const SolverSubtree& subtree,
+                                                const SReal alpha, const SReal dt,
+                                                core::ConstMultiVecCoordId startPosition, core::ConstMultiVecDerivId startVelocity,
+                                                core::ConstMultiVecDerivId displacement, core::ConstMultiVecDerivId endVelocity) const
+{
+    simulation::common::VectorOperations vop(params, subtree.node);
+
+    // x = x0 + alpha * (x1 - x0)
+    vop.v_op(core::VecCoordId::position(), startPosition, displacement, alpha);
+    // v = (1 - alpha) * v0 + alpha * v1
+    vop.v_eq(core::VecDerivId::velocity(), startVelocity, 1 - alpha);
+    vop.v_peq(core::VecDerivId::velocity(), endVelocity, alpha);
+
+    sofa::core::MechanicalParams mparams(*params);
+    mparams.setDt(dt);
+    simulation::mechanicalvisitor::MechanicalPropagateOnlyPositionAndVelocityVisitor(&mparams, m_node->getTime() + alpha * dt,
+        core::VecCoordId::position(), core::VecDerivId::velocity()).execute(subtree.node);
+}
+
+void MultiRateAnimationLoop::computeCouplingForces(const core::ExecParams* params, const SReal dt) const
+{
+    sofa::core::MechanicalParams mparams(*params);
+    mparams.setDt(dt);
+    for (auto* forceField : m_couplingForceFields)
+    {
+        forceField->addForce(&mparams, core::VecDerivId::externalForce());
+    }
+}
+
+void MultiRateAnimationLoop::animateMultiRate(const core::ExecParams* params, const SReal dt)
+{
+    const SReal startTime = m_node->getTime();
+    const SReal nextTime = startTime + dt;
+
+    sofa::core::MechanicalParams mparams(*params);
+    mparams.setDt(dt);
+
+    behaviorUpdatePosition(params, dt);
+    updateInternalData(params);
+
+    collisionDetection(params);
+
+    m_subtrees.clear();
+    m_couplingForceFields.clear();
+    {
+        std::set<simulation::Node*> visited;
+        collectSubtrees(m_node, visited);
+    }
+
+    // subtrees grouped by rate, from the slowest to the fastest
+    std::map<unsigned int, sofa::type::vector<const SolverSubtree*> > rates;
+    for (const auto& subtree : m_subtrees)
+    {
+        rates[subtree.substeps].push_back(&subtree);
+    }
+
+    beginIntegration(params, dt);
+    {
+        const core::ConstraintParams cparams;
+        accumulateMatrixDeriv(cparams);
+
+        simulation::common::VectorOperations vop(params, m_node);
+
+        // the external forces not coming from the coupling are applied at each substep
+        core::behavior::MultiVecDeriv externalForce(&vop);
+        vop.v_eq(externalForce, core::VecDerivId::externalForce());
+
+        core::behavior::MultiVecCoord startPosition(&vop);
+        core::behavior::MultiVecDeriv startVelocity(&vop);
+        core::behavior::MultiVecCoord endPosition(&vop);
+        core::behavior::MultiVecDeriv endVelocity(&vop);
+        core::behavior::MultiVecDeriv displacement(&vop);
+        if (rates.size() > 1)
+        {
+            vop.v_eq(startPosition, core::VecCoordId::position());
+            vop.v_eq(startVelocity, core::VecDerivId::velocity());
+        }
+
+        const simulation::ForEachExecutionPolicy execution = d_parallelODESolving.getValue() ?
+            simulation::ForEachExecutionPolicy::PARALLEL :
+            simulation::ForEachExecutionPolicy::SEQUENTIAL;
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler);
+
+        sofa::type::vector<const SolverSubtree*> slowerSubtrees;
+        for (const auto& [substeps, subtrees] : rates)
+        {
+            SCOPED_TIMER_VARNAME(rateTimer, "solveRate");
+            const SReal substepDt = dt / substeps;
+
+            for (unsigned int k = 0; k < substeps; ++k)
+            {
+                const SReal alpha = static_cast<SReal>(k + 1) / substeps;
+                for (const auto* subtree : slowerSubtrees)
+                {
+                    interpolateSubtree(params, *subtree, alpha, dt, startPosition, startVelocity, displacement, endVelocity);
+                }
+
+                for (const auto* subtree : subtrees)
+                {
+                    simulation::common::VectorOperations subtreeOps(params, subtree->node);
+                    subtreeOps.v_eq(core::VecDerivId::externalForce(), externalForce);
+                }
+                if (rates.size() > 1)
+                {
+                    computeCouplingForces(params, substepDt);
+                }
+
+                simulation::forEachRange(execution, *taskScheduler, std::size_t{0}, subtrees.size(),
+                    [&subtrees, params, startTime, substepDt, k](const auto& range)
+                    {
+                        for (auto i = range.start; i != range.end; ++i)
+                        {
+                            simulation::Node* node = subtrees[i]->node;
+                            node->setTime(startTime + k * substepDt);
+                            node->execute<simulation::UpdateSimulationContextVisitor>(params);
+
+                            for (auto* solver : node->solver)
+                            {
+                                SCOPED_TIMER_TR("Mechanical");
+                                solver->solve(params, substepDt, core::VecCoordId::position(), core::VecDerivId::velocity());
+                            }
+                        }
+                    });
+            }
+
+            if (rates.size() > 1)
+            {
+                for (const auto* subtree : subtrees)
+                {
+                    simulation::common::VectorOperations subtreeOps(params, subtree->node);
+                    subtreeOps.v_eq(endPosition, core::VecCoordId::position());
+                    subtreeOps.v_eq(endVelocity, core::VecDerivId::velocity());
+                    MechanicalCoordDifferenceVisitor(params, displacement, endPosition, startPosition).execute(subtree->node);
+                }
+            }
+            slowerSubtrees.insert(slowerSubtrees.end(), subtrees.begin(), subtrees.end());
+        }
+
+        // the interpolated subtrees are set back to their state at the end of the step
+        if (rates.size() > 1)
+        {
+            const auto& fastestSubtrees = rates.rbegin()->second;
+            for (const auto* subtree : slowerSubtrees)
+            {
+                if (std::find(fastestSubtrees.begin(), fastestSubtrees.end(), subtree) != fastestSubtrees.end())
+                {
+                    continue;
+                }
+                simulation::common::VectorOperations subtreeOps(params, subtree->node);
+                subtreeOps.v_eq(core::VecCoordId::position(), endPosition);
+                subtreeOps.v_eq(core::VecDerivId::velocity(), endVelocity);
+            }
+        }
+
+        projectPositionAndVelocity(nextTime, mparams);
+        propagateOnlyPositionAndVelocity(nextTime, mparams);
+    }
+    endIntegration(params, dt);
+}
+
+void MultiRateAnimationLoop::step(const core::ExecParams* params, SReal dt)
+{
+    if (this->d_componentState.getValue() != sofa::core::objectmodel::ComponentState::Valid)
+    {
+        return;
+    }
+
+    m_node = dynamic_cast<sofa::simulation::Node*>(this->l_node.get());
+    assert(m_node);
+
+    if (dt == 0_sreal)
+    {
+        dt = m_node->getDt();
+    }
+
+#ifdef SOFA_DUMP_VISITOR_INFO
+    simulation::Visitor::printNode("Step");
+#endif
+
+    propagateAnimateBeginEvent(params, dt);
+    evaluateEngines();
+    animateMultiRate(params, dt);
+    updateSimulationContext(params, dt, m_node->getTime());
+    propagateAnimateEndEvent(params, dt);
+
+    updateMapping(params, dt);
+    computeBoundingBox(params);
+
+#ifdef SOFA_DUMP_VISITOR_INFO
+    simulation::Visitor::printCloseNode("Step");
+#endif
+}
+
+} // namespace sofa::component::animationloop
@@ -0,0 +1,91 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/animationloop/config.h>
+
+#include <sofa/simulation/DefaultAnimationLoop.h>
+#include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/core/behavior/BaseInteractionForceField.h>
+#include <sofa/core/behavior/MultiVec.h>
+
+#include <set>
+
+namespace sofa::component::animationloop
+{
+
+/**
+ * Animation loop where each ODE solver subtree advances with its own number of substeps per animation step.
+ *
+ * The subtrees are integrated from the slowest to the fastest rate. While a subtree takes its substeps,
+ * the slower subtrees, already integrated over the whole step, are interpolated at the end time of each
+ * substep, and the mappings of these subtrees are applied. The interaction force fields coupling the
+ * subtrees (placed in nodes without ODE solver) are evaluated again before each substep, with the
+ * interpolated states. The faster subtrees are seen at the beginning of the step.
+ * The subtrees sharing the same rate are independent during a substep, and can be solved in parallel.
+ *
+ * The positions are interpolated linearly between the start and the end of the step, whatever the
+ * integration scheme and the number of substeps of the slower subtrees, and so are the velocities.
+ * With a single rate, the coupling force fields are not evaluated, as in the DefaultAnimationLoop, and
+ * this loop is equivalent to the DefaultAnimationLoop.
+ */
+class SOFA_COMPONENT_ANIMATIONLOOP_API MultiRateAnimationLoop : public sofa::simulation::DefaultAnimationLoop
+{
+public:
+    SOFA_CLASS(MultiRateAnimationLoop, sofa::simulation::DefaultAnimationLoop);
+
+    MultiLink<MultiRateAnimationLoop, core::behavior::OdeSolver, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_odeSolvers;
+    Data<type::vector<unsigned int> > d_substeps; ///< Number of substeps per animation step of each ODE solver of the list odeSolvers. The other ODE solvers take a single step
+
+    void init() override;
+
+    void step(const sofa::core::ExecParams* params, SReal dt) override;
+
+protected:
+    MultiRateAnimationLoop();
+
+    /// Node containing at least one ODE solver, and the number of substeps of its solvers
+    struct SolverSubtree
+    {
+        simulation::Node* node { nullptr };
+        unsigned int substeps { 1 };
+    };
+
+    /// Find the ODE solver subtrees, and the interaction force fields coupling them
+    void collectSubtrees(simulation::Node* node, std::set<simulation::Node*>& visited);
+    unsigned int getSubsteps(const simulation::Node* node) const;
+
+    void animateMultiRate(const sofa::core::ExecParams* params, SReal dt);
+
+    /// Set the independent states of a subtree at the fraction alpha of the step, and apply its mappings.
+    /// The displacement is the difference between the positions at the end and at the start of the step.
+    void interpolateSubtree(const sofa::core::ExecParams* params, const SolverSubtree& subtree, SReal alpha, SReal dt,
+                            core::ConstMultiVecCoordId startPosition, core::ConstMultiVecDerivId startVelocity,
+                            core::ConstMultiVecDerivId displacement, core::ConstMultiVecDerivId endVelocity) const;
+
+    void computeCouplingForces(const sofa::core::ExecParams* params, SReal dt) const;
+
+    sofa::type::vector<SolverSubtree> m_subtrees;
+    sofa::type::vector<core::behavior::BaseInteractionForceField*> m_couplingForceFields;
+};
+
+} // namespace sofa::component::animationloop
@@ -0,0 +1,111 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/simulation/Node.h>
+
+#include <array>
+#include <cmath>
+
+namespace
+{
+
+using namespace sofa;
+
+/** Two particles coupled by a weak spring: the particle of the node "Soft" is attached by a soft spring
+and starts with a velocity, the particle of the node "Stiff" is attached by a stiff spring. The two nodes
+are integrated with their own ODE solver, or with a single ODE solver in the root node */
+struct MultiRateAnimationLoop_test : public BaseSimulationTest
+{
+    static std::string createScene(const std::string& animationLoop, const bool solverPerSubtree)
+    {
+        const std::string solver = R"(
+            <EulerImplicitSolver name="odesolver" rayleighStiffness="0" rayleighMass="0"/>
+            <SparseLDLSolver template="CompressedRowSparseMatrixMat3x3"/>)";
+
+        return R"(
+            <Node name="root" gravity="0 0 0">
+                <RequiredPlugin name="Sofa.Component"/>
+                )" + animationLoop + (solverPerSubtree ? "" : solver) + R"(
+                <Node name="Soft">)" + (solverPerSubtree ? solver : "") + R"(
+                    <MechanicalObject template="Vec3" name="dofs" position="0 0 0  1 0 0" velocity="0 0 0  1 0 0"/>
+                    <UniformMass totalMass="2"/>
+                    <FixedProjectiveConstraint indices="0"/>
+                    <StiffSpringForceField template="Vec3" spring="0 1 1 0 1"/>
+                </Node>
+                <Node name="Stiff">)" + (solverPerSubtree ? solver : "") + R"(
+                    <MechanicalObject template="Vec3" name="dofs" position="2 0 0  3 0 0"/>
+                    <UniformMass totalMass="2"/>
+                    <FixedProjectiveConstraint indices="1"/>
+                    <StiffSpringForceField template="Vec3" spring="0 1 10000 0 1"/>
+                </Node>
+                <StiffSpringForceField template="Vec3" name="coupling" object1="@Soft/dofs" object2="@Stiff/dofs" spring="1 0 10 0 1"/>
+            </Node>)";
+    }
+
+    /// Positions along x of the free particles of the nodes Soft and Stiff, after nbSteps animation steps
+    static std::array<SReal, 2> simulate(const std::string& animationLoop, const bool solverPerSubtree,
+                                         const SReal dt, const unsigned int nbSteps)
+    {
+        SceneInstance scene("xml", createScene(animationLoop, solverPerSubtree));
+        scene.initScene();
+        for (unsigned int i = 0; i < nbSteps; ++i)
+        {
+            scene.simulate(dt);
+        }
+
+        const auto* soft = scene.root->getChild("Soft")->getMechanicalState();
+        const auto* stiff = scene.root->getChild("Stiff")->getMechanicalState();
+        return { soft->getPX(1), stiff->getPX(0) };
+    }
+};
+
+TEST_F(MultiRateAnimationLoop_test, SingleRateIsEquivalentToDefaultAnimationLoop)
+{
+    const auto reference = simulate("<DefaultAnimationLoop/>", true, 0.01, 20);
+    const auto multiRate = simulate("<MultiRateAnimationLoop/>", true, 0.01, 20);
+
+    // as with the DefaultAnimationLoop, the coupling spring between the two ODE solvers is not evaluated
+    for (std::size_t i = 0; i < reference.size(); ++i)
+    {
+        EXPECT_NEAR(multiRate[i], reference[i], 1e-12);
+    }
+}
+
+TEST_F(MultiRateAnimationLoop_test, TwoRatesMatchFullySubsteppedScene)
+{
+    // the whole scene integrated with the time step of the stiff node
+    const auto reference = simulate("<DefaultAnimationLoop/>", false, 0.001, 200);
+    // the whole scene integrated with the time step of the soft node
+    const auto coarse = simulate("<DefaultAnimationLoop/>", false, 0.01, 20);
+    const auto multiRate = simulate(R"(<MultiRateAnimationLoop odeSolvers="@Stiff/odesolver" substeps="10"/>)", true, 0.01, 20);
+
+    for (std::size_t i = 0; i < reference.size(); ++i)
+    {
+        EXPECT_NEAR(multiRate[i], reference[i], 2e-4);
+        EXPECT_LT(std::abs(multiRate[i] - reference[i]), 0.1 * std::abs(coarse[i] - reference[i]));
+    }
+}
+
+}
@@ -24,15 +24,65 @@
 
 #include <sofa/core/behavior/ConstraintCorrection.h>
 #include <sofa/core/objectmodel/DataFileName.h>
+#include <sofa/core/behavior/LinearSolver.h>
+#include <sofa/helper/OptionsGroup.h>
 
 #include <sofa/linearalgebra/FullMatrix.h>
 
 #include <sofa/type/Mat.h>
 #include <sofa/type/Vec.h>
 
+#include <cstdint>
+#include <memory>
+
 namespace sofa::component::constraint::lagrangian::correction
 {
 
+/**
+ *  \brief Read-only memory mapping of a precomputed compliance file.
+ *
+ *  The pages of the file are shared between all the processes mapping the same file,
+ *  so that several simulations can use a single copy of a large compliance matrix.
+ */
+class SOFA_COMPONENT_CONSTRAINT_LAGRANGIAN_CORRECTION_API MappedComplianceFile
+{
+public:
+    MappedComplianceFile() = default;
+    MappedComplianceFile(const MappedComplianceFile&) = delete;
+    MappedComplianceFile& operator=(const MappedComplianceFile&) = delete;
+    ~MappedComplianceFile();
+
+    /// Map the whole file in memory. Returns false if the file cannot be mapped.
+    bool open(const std::string& path);
+    void close();
+
+    const char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    const char* m_data { nullptr };
+    std::size_t m_size { 0 };
+#ifdef WIN32
+    void* m_file { nullptr };
+    void* m_mapping { nullptr };
+#endif
+};
+
+/// Header of the float32/float64 compliance files. The data follows the header, stored row by row.
+struct ComplianceFileHeader
+{
+    static constexpr char Magic[8] = {'S', 'O', 'F', 'A', 'C', 'O', 'M', 'P'};
+    static constexpr std::uint32_t CurrentVersion = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t scalarSize; ///< 4 for float32, 8 for float64
+    std::uint64_t nbRows;
+    std::uint64_t nbCols;
+    char padding[32]; ///< keeps the data aligned on 64 bytes
+};
+static_assert(sizeof(ComplianceFileHeader) == 64);
+
 /**
  *  \brief Component computing constraint forces within a simulated body using the compliance method.
  */
@@ -83,7 +133,12 @@ public:
     Data<SReal> d_debugViewFrameScale; ///< Scale on computed node's frame
     sofa::core::objectmodel::DataFileName d_fileCompliance; ///< Precomputed compliance matrix data file
     Data<std::string> d_fileDir; ///< If not empty, the compliance will be saved in this repertory
-    
+    Data<helper::OptionsGroup> d_precomputationMethod; ///< Method used to precompute the compliance
+    Data<unsigned int> d_precomputationBlockSize; ///< Number of right-hand sides solved together by the factorization-based precomputation
+    Data<bool> d_multithreading; ///< If true, the blocks of the factorization-based precomputation are solved in parallel
+    Data<helper::OptionsGroup> d_complianceFileFormat; ///< Format of the saved compliance file
+    Data<bool> d_memoryMapping; ///< If true, a float32/float64 compliance file is memory-mapped instead of being copied in memory
+
 protected:
     PrecomputedConstraintCorrection(sofa::core::behavior::MechanicalState<DataTypes> *mm = nullptr);
 
@@ -139,6 +194,7 @@ public:
     {
         Real* data;
         int nbref;
+        std::shared_ptr<MappedComplianceFile> mapping; ///< set when data points into a memory-mapped file
         InverseStorage() : data(nullptr), nbref(0) {}
     };
 
@@ -198,6 +254,23 @@ protected:
      */
     void saveCompliance(const std::string& fileName);
 
+    /**
+     * @brief Read a compliance file, either a raw dump of the matrix or a float32/float64 file
+     * starting with a ComplianceFileHeader. The latter is memory-mapped if d_memoryMapping is set
+     * and its precision matches Real.
+     *
+     * @return Loading success.
+     */
+    bool readComplianceFile(const std::string& path);
+
+    /**
+     * @brief Compute the compliance from a single factorization of the system matrix assembled by
+     * the linear solver, solving the unit right-hand sides by blocks.
+     *
+     * @return false if the linear system cannot be factorized this way.
+     */
+    bool precomputeWithFactorization(core::behavior::LinearSolver* linearSolver, SReal velocityFactor);
+
     /**
      * @brief Builds the compliance file name using the SOFA component internal data.
      */
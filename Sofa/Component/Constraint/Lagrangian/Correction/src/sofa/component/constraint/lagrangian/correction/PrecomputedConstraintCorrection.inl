@@ -33,16 +33,24 @@
 #include <sofa/component/linearsolver/iterative/CGLinearSolver.h>
 
 #include <sofa/core/behavior/RotationFinder.h>
+#include <sofa/core/behavior/ProjectiveConstraintSet.h>
 
 #include <sofa/helper/system/FileRepository.h>
 #include <sofa/type/Quat.h>
 
 #include <sofa/simulation/fwd.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+
+#include <Eigen/SparseCholesky>
 
 #include <fstream>
 #include <sstream>
 #include <list>
 #include <iomanip>
+#include <cstring>
 #include <sofa/helper/system/FileSystem.h>
 
 //#define NEW_METHOD_UNBUILT
@@ -59,6 +67,19 @@ PrecomputedConstraintCorrection<DataTypes>::PrecomputedConstraintCorrection(sofa
     , d_debugViewFrameScale(initData(&d_debugViewFrameScale, 1.0_sreal, "debugViewFrameScale", "Scale on computed node's frame"))
     , d_fileCompliance(initData(&d_fileCompliance, "fileCompliance", "Precomputed compliance matrix data file"))
     , d_fileDir(initData(&d_fileDir, "fileDir", "If not empty, the compliance will be saved in this repertory"))
+    , d_precomputationMethod(initData(&d_precomputationMethod, helper::OptionsGroup{{"Integration", "Factorization"}}, "precomputationMethod",
+        "Method used to precompute the compliance:\n"
+        "- Integration: one time integration per degree of freedom, using the ODE and linear solvers of the context\n"
+        "- Factorization: the system matrix assembled by the linear solver is factorized once, and the unit "
+        "right-hand sides are solved by blocks. Falls back to Integration if the linear solver does not assemble the matrix"))
+    , d_precomputationBlockSize(initData(&d_precomputationBlockSize, 64u, "precomputationBlockSize", "Number of right-hand sides solved together by the factorization-based precomputation"))
+    , d_multithreading(initData(&d_multithreading, false, "multithreading", "If true, the blocks of the factorization-based precomputation are solved in parallel"))
+    , d_complianceFileFormat(initData(&d_complianceFileFormat, helper::OptionsGroup{{"raw", "float64", "float32"}}, "complianceFileFormat",
+        "Format of the saved compliance file:\n"
+        "- raw: dump of the matrix in the precision of the template\n"
+        "- float64/float32: matrix preceded by a header, which can be memory-mapped"))
+    , d_memoryMapping(initData(&d_memoryMapping, false, "memoryMapping", "If true, a float32/float64 compliance file in the precision of the template is memory-mapped "
+        "instead of being copied in memory. The simulations loading the same file share its pages"))
     , invM(nullptr)
     , appCompliance(nullptr)
     , nbRows(0), nbCols(0), dof_on_node(0), nbNodes(0)
@@ -101,7 +122,8 @@ void PrecomputedConstraintCorrection<DataTypes>::releaseInverse(std::string name
     std::map< std::string, InverseStorage >& registry = getInverseMap();
     if (--inv->nbref == 0)
     {
-        if (inv->data) delete[] inv->data;
+        if (inv->mapping) inv->mapping.reset();
+        else if (inv->data) delete[] inv->data;
         registry.erase(name);
     }
 }
@@ -142,36 +164,14 @@ bool PrecomputedConstraintCorrection<DataTypes>::loadCompliance(std::string file
         if (!dir.empty())
         {
             const std::string path = helper::system::FileSystem::append(dir, fileName);
-            std::ifstream compFileIn(path, std::ifstream::binary);
-            if (compFileIn.is_open())
-            {
-                invM->data = new Real[nbRows * nbCols];
-
-                msg_info() << "File " << path << " found. Loading..." ;
-
-                compFileIn.read((char*)invM->data, nbCols * nbRows * sizeof(Real));
-                compFileIn.close();
-
-                return true;
-            }
-            else
-                return false;
+            return readComplianceFile(path);
         }
         else if (d_recompute.getValue() == false)
         {
             std::stringstream ss;
             if (sofa::helper::system::DataRepository.findFile(fileName, "", &ss))
             {
-                invM->data = new Real[nbRows * nbCols];
-
-                std::ifstream compFileIn(fileName.c_str(), std::ifstream::binary);
-
-                msg_info() << "File " << fileName << " found. Loading..." ;
-
-                compFileIn.read((char*)invM->data, nbCols * nbRows * sizeof(Real));
-                compFileIn.close();
-
-                return true;
+                return readComplianceFile(fileName);
             }
             else
             {
@@ -209,8 +209,296 @@ void PrecomputedConstraintCorrection<DataTypes>::saveCompliance(const std::strin
     this->f_printLog.setValue(printLog);
 
     std::ofstream compFileOut(filePathInSofaShare.c_str(), std::fstream::out | std::fstream::binary);
-    compFileOut.write((char*)invM->data, nbCols * nbRows * sizeof(Real));
+
+    const auto format = d_complianceFileFormat.getValue().getSelectedId();
+    if (format == 0)
+    {
+        compFileOut.write((char*)invM->data, nbCols * nbRows * sizeof(Real));
+        compFileOut.close();
+        return;
+    }
+
+    ComplianceFileHeader header {};
+    std::memcpy(header.magic, ComplianceFileHeader::Magic, sizeof(header.magic));
+    header.version = ComplianceFileHeader::CurrentVersion;
+    header.scalarSize = (format == 1) ? 8 : 4;
+    header.nbRows = nbRows;
+    header.nbCols = nbCols;
+    compFileOut.write((const char*)&header, sizeof(header));
+
+    const auto writeRows = [&](auto scalar)
+    {
+        using Scalar = decltype(scalar);
+        std::vector<Scalar> row(nbCols);
+        for (unsigned int i = 0; i < nbRows; ++i)
+        {
+            std::copy_n(invM->data + std::size_t(i) * nbCols, nbCols, row.begin());
+            compFileOut.write((const char*)row.data(), nbCols * sizeof(Scalar));
+        }
+    };
+    if (header.scalarSize == 8)
+        writeRows(double());
+    else
+        writeRows(float());
     compFileOut.close();
+
+    // Replace the private copy of the compliance by a mapping of the file that has just been written
+    if (d_memoryMapping.getValue() && header.scalarSize == sizeof(Real) && !invM->mapping)
+    {
+        Real* computed = invM->data;
+        invM->data = nullptr;
+        if (readComplianceFile(filePathInSofaShare))
+            delete[] computed;
+        else
+            invM->data = computed;
+    }
+}
+
+
+
+template<class DataTypes>
+bool PrecomputedConstraintCorrection<DataTypes>::readComplianceFile(const std::string& path)
+{
+    std::ifstream compFileIn(path, std::ifstream::binary);
+    if (!compFileIn.is_open())
+    {
+        return false;
+    }
+
+    msg_info() << "File " << path << " found. Loading..." ;
+
+    const std::size_t nbValues = std::size_t(nbRows) * nbCols;
+
+    ComplianceFileHeader header {};
+    compFileIn.read((char*)&header, sizeof(header));
+    const bool hasHeader = compFileIn.gcount() == sizeof(header)
+        && std::memcmp(header.magic, ComplianceFileHeader::Magic, sizeof(header.magic)) == 0;
+
+    if (!hasHeader)
+    {
+        // raw dump of the matrix
+        compFileIn.clear();
+        compFileIn.seekg(0);
+        Real* data = new Real[nbValues];
+        compFileIn.read((char*)data, nbValues * sizeof(Real));
+        if (compFileIn.gcount() != std::streamsize(nbValues * sizeof(Real)))
+        {
+            msg_error() << "Compliance file " << path << " is too short to store a " << nbRows << "x" << nbCols << " matrix";
+            delete[] data;
+            return false;
+        }
+        invM->data = data;
+        return true;
+    }
+
+    if (header.nbRows != nbRows || header.nbCols != nbCols || (header.scalarSize != 4 && header.scalarSize != 8))
+    {
+        msg_error() << "Compliance file " << path << " stores a " << header.nbRows << "x" << header.nbCols
+                    << " matrix of " << header.scalarSize << "-byte values, but a " << nbRows << "x" << nbCols
+                    << " matrix is expected";
+        return false;
+    }
+
+    if (d_memoryMapping.getValue())
+    {
+        if (header.scalarSize == sizeof(Real))
+        {
+            auto mapping = std::make_shared<MappedComplianceFile>();
+            if (mapping->open(path) && mapping->size() >= sizeof(header) + nbValues * sizeof(Real))
+            {
+                invM->mapping = mapping;
+                invM->data = reinterpret_cast<Real*>(const_cast<char*>(mapping->data()) + sizeof(header));
+                return true;
+            }
+            msg_warning() << "Compliance file " << path << " cannot be memory-mapped: it is loaded in memory";
+        }
+        else
+        {
+            msg_warning() << "Compliance file " << path << " stores " << header.scalarSize << "-byte values, but "
+                          << sizeof(Real) << "-byte values are required to be memory-mapped: it is converted in memory";
+        }
+    }
+
+    Real* data = new Real[nbValues];
+
+    const auto readRows = [&](auto scalar)
+    {
+        using Scalar = decltype(scalar);
+        std::vector<Scalar> row(nbCols);
+        for (unsigned int i = 0; i < nbRows && compFileIn; ++i)
+        {
+            compFileIn.read((char*)row.data(), nbCols * sizeof(Scalar));
+            std::copy(row.begin(), row.end(), data + std::size_t(i) * nbCols);
+        }
+    };
+    if (header.scalarSize == 8)
+        readRows(double());
+    else
+        readRows(float());
+
+    if (!compFileIn)
+    {
+        msg_error() << "Compliance file " << path << " is too short to store a " << nbRows << "x" << nbCols << " matrix";
+        delete[] data;
+        return false;
+    }
+
+    invM->data = data;
+    return true;
+}
+
+
+
+template<class DataTypes>
+bool PrecomputedConstraintCorrection<DataTypes>::precomputeWithFactorization(core::behavior::LinearSolver* linearSolver, SReal velocityFactor)
+{
+    linearalgebra::BaseMatrix* systemMatrix = linearSolver ? linearSolver->getSystemBaseMatrix() : nullptr;
+    if (!systemMatrix)
+    {
+        msg_warning() << "The linear solver does not assemble the system matrix: the compliance is precomputed by integration";
+        return false;
+    }
+    if (systemMatrix->rowSize() != nbRows || systemMatrix->colSize() != nbCols)
+    {
+        msg_warning() << "The system matrix (" << systemMatrix->rowSize() << "x" << systemMatrix->colSize()
+                      << ") does not match the " << nbRows << " degrees of freedom of the state: the compliance is precomputed by integration";
+        return false;
+    }
+
+    using EigenSparseMatrix = Eigen::SparseMatrix<SReal>;
+    using EigenDenseMatrix = Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic>;
+
+    // Copy of the assembled system matrix
+    std::vector<Eigen::Triplet<SReal> > triplets;
+    if (auto* crs = dynamic_cast<linearalgebra::CompressedRowSparseMatrix<SReal>*>(systemMatrix))
+    {
+        crs->compress();
+        const auto& rowIndex = crs->getRowIndex();
+        const auto& rowBegin = crs->getRowBegin();
+        const auto& colsIndex = crs->getColsIndex();
+        const auto& colsValue = crs->getColsValue();
+        triplets.reserve(colsValue.size());
+        for (std::size_t i = 0; i < rowIndex.size(); ++i)
+        {
+            for (auto k = rowBegin[i]; k < rowBegin[i + 1]; ++k)
+            {
+                triplets.emplace_back(rowIndex[i], colsIndex[k], colsValue[k]);
+            }
+        }
+    }
+    else
+    {
+        for (unsigned int r = 0; r < nbRows; ++r)
+        {
+            for (unsigned int c = 0; c < nbCols; ++c)
+            {
+                const SReal value = systemMatrix->element(r, c);
+                if (value != 0)
+                    triplets.emplace_back(r, c, value);
+            }
+        }
+    }
+
+    EigenSparseMatrix A(nbRows, nbCols);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    triplets.clear();
+    triplets.shrink_to_fit();
+
+    msg_info() << "Factorizing the system matrix (" << A.nonZeros() << " non-zeros)";
+
+    const Eigen::SimplicialLDLT<EigenSparseMatrix> factorization(A);
+    if (factorization.info() != Eigen::Success)
+    {
+        msg_warning() << "The factorization of the system matrix failed: the compliance is precomputed by integration";
+        return false;
+    }
+
+    // Unit right-hand sides, projected the same way the ODE solver projects its right-hand side
+    Data<MatrixDeriv> unitForces;
+    {
+        helper::WriteOnlyAccessor< Data<MatrixDeriv> > c = unitForces;
+        for (unsigned int f = 0; f < nbNodes; ++f)
+        {
+            for (unsigned int i = 0; i < dof_on_node; ++i)
+            {
+                Deriv unitary_force;
+                unitary_force.clear();
+                unitary_force[i] = 1.0;
+                c->writeLine(f * dof_on_node + i).addCol(f, unitary_force);
+            }
+        }
+    }
+
+    type::vector< core::behavior::ProjectiveConstraintSet<DataTypes>* > projectiveConstraints;
+    this->getContext()->template get< core::behavior::ProjectiveConstraintSet<DataTypes> >(&projectiveConstraints, core::objectmodel::BaseContext::Local);
+    for (auto* constraint : projectiveConstraints)
+    {
+        if (constraint->getMState() == this->mstate && constraint->isActive())
+            constraint->projectJacobianMatrix(core::mechanicalparams::defaultInstance(), unitForces);
+    }
+
+    // Sparse columns of the projected right-hand side, gathered once so that the blocks can be filled concurrently
+    type::vector< type::vector< std::pair<unsigned int, SReal> > > rhsColumns(nbCols);
+    const MatrixDeriv& projectedForces = unitForces.getValue();
+    for (auto rowIt = projectedForces.begin(), rowItEnd = projectedForces.end(); rowIt != rowItEnd; ++rowIt)
+    {
+        auto& column = rhsColumns[rowIt.index()];
+        for (auto colIt = rowIt.begin(), colItEnd = rowIt.end(); colIt != colItEnd; ++colIt)
+        {
+            const Deriv& value = colIt.val();
+            for (unsigned int j = 0; j < dof_on_node; ++j)
+            {
+                if (value[j] != 0)
+                    column.emplace_back(colIt.index() * dof_on_node + j, value[j]);
+            }
+        }
+    }
+
+    const unsigned int blockSize = std::max(1u, d_precomputationBlockSize.getValue());
+    const unsigned int nbBlocks = (nbCols + blockSize - 1) / blockSize;
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+    const simulation::ForEachExecutionPolicy execution = d_multithreading.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+    if (d_multithreading.getValue() && taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    msg_info() << "Solving " << nbCols << " right-hand sides in " << nbBlocks << " blocks";
+
+    // Each block writes its own columns of the compliance
+    simulation::forEachRange(execution, *taskScheduler, 0u, nbBlocks,
+        [&](const auto& range)
+        {
+            EigenDenseMatrix rhs;
+            EigenDenseMatrix solution;
+            for (auto b = range.start; b != range.end; ++b)
+            {
+                const unsigned int firstCol = b * blockSize;
+                const unsigned int blockCols = std::min(blockSize, nbCols - firstCol);
+
+                rhs.setZero(nbRows, blockCols);
+                for (unsigned int k = 0; k < blockCols; ++k)
+                {
+                    for (const auto& [row, value] : rhsColumns[firstCol + k])
+                        rhs(row, k) = value;
+                }
+
+                solution = factorization.solve(rhs);
+
+                for (unsigned int r = 0; r < nbRows; ++r)
+                {
+                    Real* line = invM->data + std::size_t(r) * nbCols + firstCol;
+                    for (unsigned int k = 0; k < blockCols; ++k)
+                        line[k] = (Real)(velocityFactor * solution(r, k));
+                }
+            }
+        });
+
+    return true;
 }
 
 
@@ -245,7 +533,11 @@ void PrecomputedConstraintCorrection<DataTypes>::bwdInit()
         if (!complianceLoaded) 
         {
             msg_error() << "A fileCompliance was given at path: " << invName << ", but could not be loaded.";
+            // the compliance is computed and shared under the default name
+            releaseInverse(invName, invM);
             invName = buildFileName();
+            invM = getInverse(invName);
+            complianceLoaded = invM->data != nullptr;
         }
     }
     else
@@ -328,10 +620,23 @@ void PrecomputedConstraintCorrection<DataTypes>::bwdInit()
             eulerSolver->solve(core::execparams::defaultInstance(), dt, core::VecCoordId::position(), core::VecDerivId::velocity());
         }
 
+        bool precomputed = false;
+        if (eulerSolver && d_precomputationMethod.getValue().getSelectedId() == 1)
+        {
+            // The integration computes velocity = b * A^-1 * e for a unit force e, with b the factor the
+            // ODE solver applies to the forces in its right-hand side
+            SReal rhsFactor = 1.0_sreal;
+            if (!eulerSolver->d_firstOrder.getValue())
+                rhsFactor = dt * (eulerSolver->d_trapezoidalScheme.getValue() ? 0.5_sreal : 1.0_sreal);
+
+            const SReal fact = eulerSolver->getPositionIntegrationFactor() / dt;
+            precomputed = precomputeWithFactorization(linearSolver, fact * rhsFactor);
+        }
+
         Deriv unitary_force;
 
         std::stringstream tmpStr;
-        for (unsigned int f = 0; f < nbNodes; f++)
+        for (unsigned int f = 0; f < nbNodes && !precomputed; f++)
         {
             tmpStr.precision(2);
             tmpStr << "Precomputing constraint correction : " << std::fixed << (float)f / (float)nbNodes * 100.0f << " %   " << '\xd';
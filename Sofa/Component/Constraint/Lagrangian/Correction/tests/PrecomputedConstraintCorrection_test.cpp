@@ -0,0 +1,255 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/constraint/lagrangian/correction/PrecomputedConstraintCorrection.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/simpleapi/SimpleApi.h>
+#include <sofa/simulation/Node.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+
+using namespace sofa;
+using PrecomputedConstraintCorrection3 = component::constraint::lagrangian::correction::PrecomputedConstraintCorrection<defaulttype::Vec3Types>;
+using ComplianceFileHeader = component::constraint::lagrangian::correction::ComplianceFileHeader;
+
+/** Test the precomputation of PrecomputedConstraintCorrection and the reading of its compliance files,
+on a small hexahedral beam clamped at one end */
+struct PrecomputedConstraintCorrection_test : public BaseSimulationTest
+{
+    static constexpr SReal dt = 0.01;
+
+    /// Directory where the compliance files are written
+    std::filesystem::path m_dir;
+
+    void SetUp() override
+    {
+        m_dir = std::filesystem::temp_directory_path() / "PrecomputedConstraintCorrection_test";
+        std::filesystem::remove_all(m_dir);
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_dir);
+    }
+
+    /// The compliance file of a beam, named after its node by buildFileName()
+    std::filesystem::path complianceFile(const std::string& beamName) const
+    {
+        std::stringstream ss;
+        ss << beamName << "-" << 16 * 3 << "-" << dt << ".comp";
+        return m_dir / ss.str();
+    }
+
+    /// Create a scene with a beam whose compliance is precomputed, or loaded from the file of a beam of the same name
+    PrecomputedConstraintCorrection3::SPtr createBeam(SceneInstance& scene, const std::string& beamName, const std::string& method,
+                                                      const std::string& fileFormat, bool memoryMapping) const
+    {
+        const simulation::Node::SPtr root = scene.root;
+        root->setGravity({ 0, -10, 0 });
+        root->setDt(dt);
+
+        simpleapi::createObject(root, "RequiredPlugin", {{"pluginName", "Sofa.Component"}});
+        simpleapi::createObject(root, "DefaultAnimationLoop");
+
+        const simulation::Node::SPtr beam = simpleapi::createChild(root, beamName);
+        simpleapi::createObject(beam, "EulerImplicitSolver");
+        simpleapi::createObject(beam, "SparseLDLSolver", {{"template", "CompressedRowSparseMatrixd"}});
+        simpleapi::createObject(beam, "RegularGridTopology", {{"name", "grid"}, {"min", "0 0 0"}, {"max", "3 1 1"}, {"n", "4 2 2"}});
+        simpleapi::createObject(beam, "MechanicalObject", {{"template", "Vec3"}, {"src", "@grid"}});
+        simpleapi::createObject(beam, "UniformMass", {{"totalMass", "1"}});
+        simpleapi::createObject(beam, "HexahedronFEMForceField", {{"youngModulus", "1000"}, {"poissonRatio", "0.3"}});
+        simpleapi::createObject(beam, "FixedProjectiveConstraint", {{"indices", "0 4 8 12"}});
+
+        const auto correction = simpleapi::createObject(beam, "PrecomputedConstraintCorrection", {
+            {"precomputationMethod", method},
+            {"complianceFileFormat", fileFormat},
+            {"memoryMapping", simpleapi::str(memoryMapping)},
+            {"fileDir", m_dir.string()}
+        });
+
+        scene.initScene();
+
+        return core::objectmodel::SPtr_dynamic_cast<PrecomputedConstraintCorrection3>(correction);
+    }
+
+    /// Copy of the compliance of a beam
+    static std::vector<SReal> compliance(PrecomputedConstraintCorrection3& correction)
+    {
+        const SReal* data = correction.getInverse();
+        EXPECT_NE(data, nullptr);
+        if (!data)
+            return {};
+        return std::vector<SReal>(data, data + std::size_t(correction.nbRows) * correction.nbCols);
+    }
+
+    static void expectEqualCompliances(const std::vector<SReal>& a, const std::vector<SReal>& b, SReal relativeTolerance)
+    {
+        ASSERT_EQ(a.size(), b.size());
+        ASSERT_FALSE(a.empty());
+
+        SReal maxValue = 0;
+        for (const SReal v : a)
+            maxValue = std::max(maxValue, std::abs(v));
+        ASSERT_GT(maxValue, 0);
+
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_NEAR(a[i], b[i], relativeTolerance * maxValue) << "entry " << i;
+        }
+    }
+
+    /// Compliance precomputed by integration, used as a reference
+    std::vector<SReal> referenceCompliance()
+    {
+        SceneInstance scene;
+        const auto correction = createBeam(scene, "reference", "Integration", "raw", false);
+        EXPECT_NE(correction, nullptr);
+        return correction ? compliance(*correction) : std::vector<SReal>{};
+    }
+
+    /// Save the compliance in a file, then load it in a new scene
+    void fileRoundTrip(const std::string& fileFormat, bool memoryMapping, SReal relativeTolerance)
+    {
+        const std::string beamName = "roundTrip" + fileFormat + (memoryMapping ? "Mapped" : "");
+
+        std::vector<SReal> saved;
+        {
+            SceneInstance scene;
+            const auto correction = createBeam(scene, beamName, "Factorization", fileFormat, memoryMapping);
+            ASSERT_NE(correction, nullptr);
+            saved = compliance(*correction);
+        }
+        ASSERT_TRUE(std::filesystem::exists(complianceFile(beamName)));
+
+        SceneInstance scene;
+        const auto correction = createBeam(scene, beamName, "Factorization", fileFormat, memoryMapping);
+        ASSERT_NE(correction, nullptr);
+
+        // only a file in the precision of the template is mapped
+        const bool mapped = memoryMapping && fileFormat == "float64";
+        EXPECT_EQ(correction->invM->mapping != nullptr, mapped);
+
+        expectEqualCompliances(saved, compliance(*correction), relativeTolerance);
+        expectEqualCompliances(referenceCompliance(), compliance(*correction), relativeTolerance + 1e-8);
+    }
+
+    /// Save a compliance file, damage it, then check that the file is rejected and the compliance recomputed
+    template<class Damage>
+    void damagedFileIsRejected(bool memoryMapping, const Damage& damage)
+    {
+        const std::string beamName = std::string("damaged") + (memoryMapping ? "Mapped" : "");
+        {
+            SceneInstance scene;
+            ASSERT_NE(createBeam(scene, beamName, "Factorization", "float64", memoryMapping), nullptr);
+        }
+        ASSERT_TRUE(std::filesystem::exists(complianceFile(beamName)));
+        damage(complianceFile(beamName));
+
+        SceneInstance scene;
+        PrecomputedConstraintCorrection3::SPtr correction;
+        {
+            EXPECT_MSG_EMIT(Error);
+            correction = createBeam(scene, beamName, "Factorization", "float64", memoryMapping);
+        }
+        ASSERT_NE(correction, nullptr);
+        expectEqualCompliances(referenceCompliance(), compliance(*correction), 1e-8);
+    }
+
+    static void truncate(const std::filesystem::path& file)
+    {
+        std::filesystem::resize_file(file, std::filesystem::file_size(file) / 2);
+    }
+
+    static void changeNumberOfRows(const std::filesystem::path& file)
+    {
+        std::fstream stream(file, std::ios::in | std::ios::out | std::ios::binary);
+        ComplianceFileHeader header {};
+        stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+        header.nbRows += 3;
+        stream.seekp(0);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+};
+
+TEST_F(PrecomputedConstraintCorrection_test, factorizationEqualsIntegration)
+{
+    const std::vector<SReal> integration = referenceCompliance();
+
+    SceneInstance scene;
+    const auto correction = createBeam(scene, "factorization", "Factorization", "raw", false);
+    ASSERT_NE(correction, nullptr);
+
+    expectEqualCompliances(integration, compliance(*correction), 1e-8);
+}
+
+TEST_F(PrecomputedConstraintCorrection_test, float64FileRoundTrip)
+{
+    fileRoundTrip("float64", false, 1e-14);
+}
+
+TEST_F(PrecomputedConstraintCorrection_test, float64MappedFileRoundTrip)
+{
+    fileRoundTrip("float64", true, 1e-14);
+}
+
+TEST_F(PrecomputedConstraintCorrection_test, float32FileRoundTrip)
+{
+    fileRoundTrip("float32", false, 1e-6);
+}
+
+TEST_F(PrecomputedConstraintCorrection_test, float32FileRoundTripWithMappingRequested)
+{
+    // float32 values cannot be mapped by a double precision component: they are converted in memory
+    fileRoundTrip("float32", true, 1e-6);
+}
+
+TEST_F(PrecomputedConstraintCorrection_test, truncatedFileIsRejected)
+{
+    damagedFileIsRejected(false, truncate);
+}
+
+TEST_F(PrecomputedConstraintCorrection_test, truncatedMappedFileIsRejected)
+{
+    damagedFileIsRejected(true, truncate);
+}
+
+TEST_F(PrecomputedConstraintCorrection_test, mismatchedFileIsRejected)
+{
+    damagedFileIsRejected(false, changeNumberOfRows);
+}
+
+TEST_F(PrecomputedConstraintCorrection_test, mismatchedMappedFileIsRejected)
+{
+    damagedFileIsRejected(true, changeNumberOfRows);
+}
+
+}
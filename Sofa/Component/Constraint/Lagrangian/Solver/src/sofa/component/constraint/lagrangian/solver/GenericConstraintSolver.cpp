@@ -25,6 +25,7 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/simulation/VectorOperations.h>
 #include <sofa/helper/AdvancedTimer.h>
+#include <sofa/helper/io/BinaryStream.h>
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/core/behavior/MultiMatrixAccessor.h>
 #include <sofa/component/constraint/lagrangian/solver/visitors/ConstraintStoreLambdaVisitor.h>
@@ -174,6 +175,27 @@ void GenericConstraintSolver::cleanup()
     sofa::component::constraint::lagrangian::solver::ConstraintSolverImpl::cleanup();
 }
 
+void GenericConstraintSolver::storeInternalState(std::ostream& out) const
+{
+    type::vector<SReal> forces(current_cp->getDimension());
+    std::copy_n(current_cp->f.ptr(), forces.size(), forces.begin());
+    helper::io::binary::write(out, forces);
+}
+
+void GenericConstraintSolver::restoreInternalState(std::istream& in)
+{
+    type::vector<SReal> forces;
+    if (!helper::io::binary::read(in, forces))
+    {
+        msg_error() << "Cannot restore the constraint forces";
+        return;
+    }
+
+    current_cp->clear(static_cast<int>(forces.size()));
+    std::copy(forces.begin(), forces.end(), current_cp->f.ptr());
+    last_cp = current_cp;
+}
+
 bool GenericConstraintSolver::prepareStates(const core::ConstraintParams *cParams, MultiVecId /*res1*/, MultiVecId /*res2*/)
 {
     last_cp = current_cp;
@@ -303,9 +325,17 @@ void GenericConstraintSolver::buildSystem_matrixFree(unsigned int numConstraints
         current_cp->change_sequence=true;
 }
 
-GenericConstraintSolver::ComplianceWrapper::ComplianceMatrixType& GenericConstraintSolver::
-ComplianceWrapper::matrix()
+linearalgebra::BaseMatrix& GenericConstraintSolver::ComplianceWrapper::matrix()
 {
+    if (m_isMultiThreaded && m_isSparse)
+    {
+        if (!m_sparseMatrix)
+        {
+            m_sparseMatrix = std::make_unique<SparseComplianceMatrixType>();
+            m_sparseMatrix->resize(m_complianceMatrix.rowSize(), m_complianceMatrix.colSize());
+        }
+        return *m_sparseMatrix;
+    }
     if (m_isMultiThreaded)
     {
         if (!m_threadMatrix)
@@ -320,6 +350,21 @@ ComplianceWrapper::matrix()
 
 void GenericConstraintSolver::ComplianceWrapper::assembleMatrix() const
 {
+    if (m_sparseMatrix)
+    {
+        m_sparseMatrix->compress();
+        const auto& rowIndex = m_sparseMatrix->getRowIndex();
+        const auto& rowBegin = m_sparseMatrix->getRowBegin();
+        const auto& colsIndex = m_sparseMatrix->getColsIndex();
+        const auto& colsValue = m_sparseMatrix->getColsValue();
+        for (std::size_t r = 0; r < rowIndex.size(); ++r)
+        {
+            for (auto k = rowBegin[r]; k < rowBegin[r + 1]; ++k)
+            {
+                m_complianceMatrix.add(rowIndex[r], colsIndex[k], colsValue[k]);
+            }
+        }
+    }
     if (m_threadMatrix)
     {
         for (linearalgebra::BaseMatrix::Index j = 0; j < m_threadMatrix->rowSize(); ++j)
@@ -346,27 +391,37 @@ void GenericConstraintSolver::buildSystem_matrixAssembly(const core::ConstraintP
     simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
     assert(taskScheduler);
 
-    //Used to prevent simultaneous accesses to the main compliance matrix
-    std::mutex mutex;
-
     //Visits all constraint corrections to compute the compliance matrix projected
-    //in the constraint space.
-    simulation::forEachRange(execution, *taskScheduler, l_constraintCorrections.begin(), l_constraintCorrections.end(),
-        [&cParams, this, &multithreading, &mutex](const auto& range)
+    //in the constraint space. The matrices of the threads are added to the main compliance matrix one at a time.
+    //In deterministic execution, each constraint correction has its own sparse matrix, storing only the entries
+    //of its constraints, added in the order of the constraint corrections, so that the result does not depend
+    //on the number of threads.
+    simulation::forEachRangeWithMerge(execution, *taskScheduler, l_constraintCorrections.begin(), l_constraintCorrections.end(),
+        [&cParams, this, &multithreading](const auto& range)
         {
-            ComplianceWrapper compliance(current_cp->W, multithreading);
+            const bool oneMatrixPerConstraintCorrection = simulation::isDeterministicExecution();
+            std::vector<ComplianceWrapper> compliances;
 
             for (auto it = range.start; it != range.end; ++it)
             {
                 core::behavior::BaseConstraintCorrection* cc = *it;
                 if (cc->isActive())
                 {
-                    cc->addComplianceInConstraintSpace(cParams, &compliance.matrix());
+                    if (compliances.empty() || oneMatrixPerConstraintCorrection)
+                    {
+                        compliances.emplace_back(current_cp->W, multithreading, oneMatrixPerConstraintCorrection);
+                    }
+                    cc->addComplianceInConstraintSpace(cParams, &compliances.back().matrix());
                 }
             }
-
-            std::lock_guard guard(mutex);
-            compliance.assembleMatrix();
+            return compliances;
+        },
+        [](const auto&, std::vector<ComplianceWrapper>& compliances)
+        {
+            for (const auto& compliance : compliances)
+            {
+                compliance.assembleMatrix();
+            }
         });
 
     dmsg_info() << " computeCompliance_done "  ;
@@ -27,6 +27,7 @@
 #include <sofa/core/behavior/BaseConstraintCorrection.h>
 #include <sofa/core/behavior/BaseConstraint.h>
 #include <sofa/helper/map.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
 
 #include <sofa/simulation/CpuTask.h>
 #include <sofa/helper/OptionsGroup.h>
@@ -49,6 +50,10 @@ public:
 
     void cleanup() override;
 
+    /// Store the forces of the last constraint problem, used to warm-start the next resolution
+    void storeInternalState(std::ostream& out) const override;
+    void restoreInternalState(std::istream& in) override;
+
     bool prepareStates(const core::ConstraintParams * /*cParams*/, MultiVecId res1, MultiVecId res2=MultiVecId::null()) override;
     bool buildSystem(const core::ConstraintParams * /*cParams*/, MultiVecId res1, MultiVecId res2=MultiVecId::null()) override;
     void rebuildSystem(SReal massFactor, SReal forceFactor) override;
@@ -152,18 +157,22 @@ private:
     struct ComplianceWrapper
     {
         using ComplianceMatrixType = sofa::linearalgebra::LPtrFullMatrix<SReal>;
+        using SparseComplianceMatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
 
-        ComplianceWrapper(ComplianceMatrixType& complianceMatrix, bool isMultiThreaded)
-        : m_isMultiThreaded(isMultiThreaded), m_complianceMatrix(complianceMatrix) {}
+        /// If isSparse, the compliance is recorded in a sparse matrix storing only the entries it touches
+        ComplianceWrapper(ComplianceMatrixType& complianceMatrix, bool isMultiThreaded, bool isSparse = false)
+        : m_isMultiThreaded(isMultiThreaded), m_isSparse(isSparse), m_complianceMatrix(complianceMatrix) {}
 
-        ComplianceMatrixType& matrix();
+        linearalgebra::BaseMatrix& matrix();
 
         void assembleMatrix() const;
 
     private:
         bool m_isMultiThreaded { false };
+        bool m_isSparse { false };
         ComplianceMatrixType& m_complianceMatrix;
         std::unique_ptr<ComplianceMatrixType> m_threadMatrix;
+        std::unique_ptr<SparseComplianceMatrixType> m_sparseMatrix;
     };
 
 
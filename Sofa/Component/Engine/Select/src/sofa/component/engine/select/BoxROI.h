@@ -28,6 +28,7 @@
 #include <sofa/core/behavior/MechanicalState.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/defaulttype/RigidTypes.h>
+#include <sofa/component/engine/select/ROISpatialIndex.h>
 
 namespace sofa::component::engine::select::boxroi
 {
@@ -80,6 +81,7 @@ public:
 public:
     void init() override;
     void reinit() override;
+    bool isThreadSafe() const override { return true; }
     void doUpdate() override;
     void draw(const VisualParams*) override;
 
@@ -165,6 +167,31 @@ protected:
 
     vector<OrientedBox> m_orientedBoxes;
 
+    /// State kept between two updates to select one type of element.
+    struct ElementSelection
+    {
+        int topologyCounter { -1 };
+        int positionCounter { -1 };
+        sofa::Size nbPoints { 0 };
+        vector<CPos> centers; ///< element centers, used by the non-strict selection
+        ROISpatialIndex<CPos> centerIndex;
+        vector<sofa::Index> vertexElementsBegin; ///< vertex to elements adjacency, used by the strict selection
+        vector<sofa::Index> vertexElements;
+    };
+
+    /// Index over the rest positions, updated incrementally when they change
+    ROISpatialIndex<CPos> m_pointIndex;
+    int m_indexedPositionCounter { -1 };
+    /// Points selected by the last update, and the corresponding flags
+    SetIndex m_selectedPoints;
+    std::vector<bool> m_isPointSelected;
+
+    ElementSelection m_edgeSelection;
+    ElementSelection m_triangleSelection;
+    ElementSelection m_tetrahedronSelection;
+    ElementSelection m_hexahedronSelection;
+    ElementSelection m_quadSelection;
+
     BoxROI();
     ~BoxROI() override {}
 
@@ -186,6 +213,20 @@ protected:
     bool isQuadInBoxesStrict(const Quad& q);
 
     void getPointsFromOrientedBox(const Vec10& box, vector<type::Vec3> &points);
+
+    template <class Element>
+    CPos getElementCenter(const Element& e) const;
+
+    /// Call f(bmin, bmax) with the axis-aligned bounds of each box.
+    template <class F>
+    void forEachBoxBounds(F&& f);
+
+    void updatePointIndex();
+    void selectPoints(SetIndex& indices);
+
+    template <class Element>
+    void selectElements(const Data<vector<Element> >& elements, ElementSelection& selection,
+                        SetIndex& elementIndices, vector<Element>& elementsInROI);
 };
 
 #if !defined(SOFA_COMPONENT_ENGINE_BOXROI_CPP)
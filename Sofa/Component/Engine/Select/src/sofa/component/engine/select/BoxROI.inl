@@ -27,6 +27,7 @@
 #include <sofa/core/topology/BaseTopology.h>
 #include <sofa/core/loader/MeshLoader.h>
 #include <sofa/helper/accessor.h>
+#include <algorithm>
 
 namespace sofa::component::engine::select::boxroi
 {
@@ -321,9 +322,6 @@ void BoxROI<DataTypes>::computeOrientedBoxes()
 
     const vector<Vec10>& orientedBoxes = d_orientedBoxes.getValue();
 
-    if(orientedBoxes.empty())
-        return;
-
     m_orientedBoxes.resize(orientedBoxes.size());
 
     for(unsigned int i=0; i<orientedBoxes.size(); i++)
@@ -442,12 +440,7 @@ bool BoxROI<DataTypes>::isPointInBoxes(const PointID& pid)
 template <class DataTypes>
 bool BoxROI<DataTypes>::isEdgeInBoxes(const Edge& e)
 {
-    const VecCoord& x0 = d_X0.getValue();
-    CPos p0 =  DataTypes::getCPos(x0[e[0]]);
-    CPos p1 =  DataTypes::getCPos(x0[e[1]]);
-    CPos c = (p1+p0)*0.5;
-
-    return isPointInBoxes(c);
+    return isPointInBoxes(getElementCenter(e));
 }
 
 template <class DataTypes>
@@ -463,13 +456,7 @@ bool BoxROI<DataTypes>::isEdgeInBoxesStrict(const Edge& e)
 template <class DataTypes>
 bool BoxROI<DataTypes>::isTriangleInBoxes(const Triangle& t)
 {
-    const VecCoord& x0 = d_X0.getValue();
-    CPos p0 =  DataTypes::getCPos(x0[t[0]]);
-    CPos p1 =  DataTypes::getCPos(x0[t[1]]);
-    CPos p2 =  DataTypes::getCPos(x0[t[2]]);
-    CPos c = (p2+p1+p0)/3.0;
-
-    return (isPointInBoxes(c));
+    return isPointInBoxes(getElementCenter(t));
 }
 
 template <class DataTypes>
@@ -486,14 +473,7 @@ bool BoxROI<DataTypes>::isTriangleInBoxesStrict(const Triangle& t)
 template <class DataTypes>
 bool BoxROI<DataTypes>::isTetrahedronInBoxes(const Tetra &t)
 {
-    const VecCoord& x0 = d_X0.getValue();
-    CPos p0 =  DataTypes::getCPos(x0[t[0]]);
-    CPos p1 =  DataTypes::getCPos(x0[t[1]]);
-    CPos p2 =  DataTypes::getCPos(x0[t[2]]);
-    CPos p3 =  DataTypes::getCPos(x0[t[3]]);
-    CPos c = (p3+p2+p1+p0)/4.0;
-
-    return (isPointInBoxes(c));
+    return isPointInBoxes(getElementCenter(t));
 }
 
 template <class DataTypes>
@@ -511,18 +491,7 @@ bool BoxROI<DataTypes>::isTetrahedronInBoxesStrict(const Tetra &t)
 template <class DataTypes>
 bool BoxROI<DataTypes>::isHexahedronInBoxes(const Hexa &t)
 {
-    const VecCoord& x0 = d_X0.getValue();
-    CPos p0 =  DataTypes::getCPos(x0[t[0]]);
-    CPos p1 =  DataTypes::getCPos(x0[t[1]]);
-    CPos p2 =  DataTypes::getCPos(x0[t[2]]);
-    CPos p3 =  DataTypes::getCPos(x0[t[3]]);
-    CPos p4 =  DataTypes::getCPos(x0[t[4]]);
-    CPos p5 =  DataTypes::getCPos(x0[t[5]]);
-    CPos p6 =  DataTypes::getCPos(x0[t[6]]);
-    CPos p7 =  DataTypes::getCPos(x0[t[7]]);
-    CPos c = (p7+p6+p5+p4+p3+p2+p1+p0)/8.0;
-
-    return (isPointInBoxes(c));
+    return isPointInBoxes(getElementCenter(t));
 }
 
 template <class DataTypes>
@@ -545,14 +514,7 @@ bool BoxROI<DataTypes>::isHexahedronInBoxesStrict(const Hexa &t)
 template <class DataTypes>
 bool BoxROI<DataTypes>::isQuadInBoxes(const Quad& q)
 {
-    const VecCoord& x0 = d_X0.getValue();
-    CPos p0 =  DataTypes::getCPos(x0[q[0]]);
-    CPos p1 =  DataTypes::getCPos(x0[q[1]]);
-    CPos p2 =  DataTypes::getCPos(x0[q[2]]);
-    CPos p3 =  DataTypes::getCPos(x0[q[3]]);
-    CPos c = (p3+p2+p1+p0)/4.0;
-
-    return (isPointInBoxes(c));
+    return isPointInBoxes(getElementCenter(q));
 }
 
 template <class DataTypes>
@@ -567,164 +529,282 @@ bool BoxROI<DataTypes>::isQuadInBoxesStrict(const Quad& q)
     return (isPointInBoxes(p0) && isPointInBoxes(p1) && isPointInBoxes(p2) && isPointInBoxes(p3));
 }
 
-// The update method is called when the engine is marked as dirty.
 template <class DataTypes>
-void BoxROI<DataTypes>::doUpdate()
+template <class Element>
+typename DataTypes::CPos BoxROI<DataTypes>::getElementCenter(const Element& e) const
 {
-    if(d_componentState.getValue() == ComponentState::Invalid){
-        return ;
-    }
+    const VecCoord& x0 = d_X0.getValue();
+    const auto n = e.size();
 
+    CPos c = DataTypes::getCPos(x0[e[n-1]]);
+    for (auto i = n-1; i > 0; --i)
+        c += DataTypes::getCPos(x0[e[i-1]]);
 
-    if(d_doUpdate.getValue()){
+    return c / Real(n);
+}
 
-        // Check whether an element can partially be inside the box or if all of its nodes must be inside
-        const bool strict = d_strict.getValue();
-
-        // Write accessor for topological element indices in BOX
-        SetIndex& indices = *d_indices.beginWriteOnly();
-        SetIndex& edgeIndices = *d_edgeIndices.beginWriteOnly();
-        SetIndex& triangleIndices = *d_triangleIndices.beginWriteOnly();
-        SetIndex& tetrahedronIndices = *d_tetrahedronIndices.beginWriteOnly();
-        SetIndex& hexahedronIndices = *d_hexahedronIndices.beginWriteOnly();
-        SetIndex& quadIndices = *d_quadIndices.beginWriteOnly();
-
-        // Write accessor for toplogical element in BOX
-        WriteOnlyAccessor< Data<VecCoord > > pointsInROI = d_pointsInROI;
-        WriteOnlyAccessor< Data<vector<Edge> > > edgesInROI = d_edgesInROI;
-        WriteOnlyAccessor< Data<vector<Triangle> > > trianglesInROI = d_trianglesInROI;
-        WriteOnlyAccessor< Data<vector<Tetra> > > tetrahedraInROI = d_tetrahedraInROI;
-        WriteOnlyAccessor< Data<vector<Hexa> > > hexahedraInROI = d_hexahedraInROI;
-        WriteOnlyAccessor< Data<vector<Quad> > > quadInROI = d_quadInROI;
-
-        // Clear lists
-        indices.clear();
-        edgeIndices.clear();
-        triangleIndices.clear();
-        tetrahedronIndices.clear();
-        hexahedronIndices.clear();
-        quadIndices.clear();
-
-
-        pointsInROI.clear();
-        edgesInROI.clear();
-        trianglesInROI.clear();
-        tetrahedraInROI.clear();
-        hexahedraInROI.clear();
-        quadInROI.clear();
-
-
-        if (d_X0.getValue().size() == 0)
+template <class DataTypes>
+template <class F>
+void BoxROI<DataTypes>::forEachBoxBounds(F&& f)
+{
+    constexpr sofa::Size dim = ROISpatialIndex<CPos>::Dim;
+
+    for (const type::Vec6& box : d_alignedBoxes.getValue())
+    {
+        CPos bmin, bmax;
+        for (sofa::Size d = 0; d < dim; ++d)
         {
-            msg_warning() << "No rest position yet defined. Box might not work properly. \n"
-                            "This may be caused by an early call of init() on the box before  \n"
-                            "the mesh or the MechanicalObject of the node was initialized too";
-            return;
+            bmin[d] = box[d];
+            bmax[d] = box[d + 3];
         }
+        f(bmin, bmax);
+    }
 
-        const vector<type::Vec6>&  alignedBoxes  = d_alignedBoxes.getValue();
-        const vector<Vec10>& orientedBoxes = d_orientedBoxes.getValue();
+    if constexpr (DataTypes::spatial_dimensions == 3)
+    {
+        vector<type::Vec3> points;
+        for (const Vec10& box : d_orientedBoxes.getValue())
+        {
+            getPointsFromOrientedBox(box, points);
 
-        if (alignedBoxes.empty() && orientedBoxes.empty()) { return; }
+            type::Vec3 pmin = points[0], pmax = points[0];
+            for (const auto& p : points)
+            {
+                for (sofa::Size d = 0; d < 3; ++d)
+                {
+                    pmin[d] = std::min(pmin[d], p[d]);
+                    pmax[d] = std::max(pmax[d], p[d]);
+                }
+            }
 
+            // the inclusion test is done on the plane equations, so leave
+            // some room for the rounding of the corners
+            const SReal margin = (pmax - pmin).norm() * 1e-6;
+            CPos bmin, bmax;
+            for (sofa::Size d = 0; d < 3; ++d)
+            {
+                bmin[d] = Real(pmin[d] - margin);
+                bmax[d] = Real(pmax[d] + margin);
+            }
+            f(bmin, bmax);
+        }
+    }
+}
 
-        // Read accessor for input topology
-        const ReadAccessor< Data<vector<Edge> > > edges = d_edges;
-        const ReadAccessor< Data<vector<Triangle> > > triangles = d_triangles;
-        const ReadAccessor< Data<vector<Tetra> > > tetrahedra = d_tetrahedra;
-        const ReadAccessor< Data<vector<Hexa> > > hexahedra = d_hexahedra;
-        const ReadAccessor< Data<vector<Quad> > > quad = d_quad;
+template <class DataTypes>
+void BoxROI<DataTypes>::updatePointIndex()
+{
+    const VecCoord& x0 = d_X0.getValue();
+    if (m_indexedPositionCounter == d_X0.getCounter() && m_pointIndex.size() == x0.size())
+        return;
 
-        const VecCoord& x0 = d_X0.getValue();
+    m_pointIndex.update(sofa::Size(x0.size()), [&x0](sofa::Index i) { return DataTypes::getCPos(x0[i]); });
+    m_indexedPositionCounter = d_X0.getCounter();
+}
 
+template <class DataTypes>
+void BoxROI<DataTypes>::selectPoints(SetIndex& indices)
+{
+    const VecCoord& x0 = d_X0.getValue();
 
-        //Points
-        for( unsigned i=0; i<x0.size(); ++i )
+    if (m_isPointSelected.size() != x0.size())
+    {
+        m_isPointSelected.assign(x0.size(), false);
+    }
+    else
+    {
+        for (const auto i : m_selectedPoints)
+            m_isPointSelected[i] = false;
+    }
+
+    // only the points in the cells overlapping a box are tested
+    indices.clear();
+    forEachBoxBounds([&](const CPos& bmin, const CPos& bmax)
+    {
+        m_pointIndex.query(bmin, bmax, [&](sofa::Index i)
         {
-            if (isPointInBoxes(i))
+            if (!m_isPointSelected[i] && isPointInBoxes(DataTypes::getCPos(x0[i])))
             {
+                m_isPointSelected[i] = true;
                 indices.push_back(i);
-                pointsInROI.push_back(x0[i]);
             }
-        }
+        });
+    });
+    std::sort(indices.begin(), indices.end());
 
-        //Edges
-        if (d_computeEdges.getValue())
+    m_selectedPoints = indices;
+}
+
+template <class DataTypes>
+template <class Element>
+void BoxROI<DataTypes>::selectElements(const Data<vector<Element> >& d_elements, ElementSelection& selection,
+                                       SetIndex& elementIndices, vector<Element>& elementsInROI)
+{
+    const vector<Element>& elements = d_elements.getValue();
+    const sofa::Size nbPoints = sofa::Size(d_X0.getValue().size());
+    const bool topologyChanged = selection.topologyCounter != d_elements.getCounter() || selection.nbPoints != nbPoints;
+
+    elementIndices.clear();
+
+    if (d_strict.getValue())
+    {
+        // an element is inside if all its vertices are, so the candidates
+        // are the elements around the selected points
+        if (topologyChanged)
         {
-            for(unsigned int i=0 ; i<edges.size() ; i++)
-            {
-                Edge e = edges[i];
-                const bool is_in_box = (strict) ? isEdgeInBoxesStrict(e) : isEdgeInBoxes(e);
-                if (is_in_box)
-                {
-                    edgeIndices.push_back(i);
-                    edgesInROI.push_back(e);
-                }
-            }
+            selection.vertexElementsBegin.assign(nbPoints + 1, 0);
+            for (const Element& e : elements)
+                for (const auto v : e)
+                    if (v < nbPoints)
+                        ++selection.vertexElementsBegin[v + 1];
+            for (sofa::Size v = 0; v < nbPoints; ++v)
+                selection.vertexElementsBegin[v + 1] += selection.vertexElementsBegin[v];
+
+            selection.vertexElements.resize(selection.vertexElementsBegin[nbPoints]);
+            vector<sofa::Index> next(selection.vertexElementsBegin.begin(), selection.vertexElementsBegin.end() - 1);
+            for (sofa::Index i = 0; i < elements.size(); ++i)
+                for (const auto v : elements[i])
+                    if (v < nbPoints)
+                        selection.vertexElements[next[v]++] = i;
         }
 
-        //Triangles
-        if (d_computeTriangles.getValue())
+        for (const auto p : m_selectedPoints)
         {
-            for(unsigned int i=0 ; i<triangles.size() ; i++)
+            for (auto k = selection.vertexElementsBegin[p]; k < selection.vertexElementsBegin[p + 1]; ++k)
             {
-                Triangle t = triangles[i];
-                const bool is_in_box = (strict) ? isTriangleInBoxesStrict(t) : isTriangleInBoxes(t);
-                if (is_in_box)
-                {
-                    triangleIndices.push_back(i);
-                    trianglesInROI.push_back(t);
-                }
+                const sofa::Index i = selection.vertexElements[k];
+                const Element& e = elements[i];
+                // the element is kept when reached from its first vertex only
+                if (e[0] != p)
+                    continue;
+
+                bool inside = true;
+                for (const auto v : e)
+                    inside = inside && v < nbPoints && m_isPointSelected[v];
+                if (inside)
+                    elementIndices.push_back(i);
             }
         }
-
-        //Tetrahedra
-        if (d_computeTetrahedra.getValue())
+    }
+    else
+    {
+        // the element centers are indexed as the points are
+        if (topologyChanged || selection.positionCounter != d_X0.getCounter())
         {
-            for(unsigned int i=0 ; i<tetrahedra.size() ; i++)
-            {
-                Tetra t = tetrahedra[i];
-                const bool is_in_box = (strict) ? isTetrahedronInBoxesStrict(t) : isTetrahedronInBoxes(t);
-                if (is_in_box)
-                {
-                    tetrahedronIndices.push_back(i);
-                    tetrahedraInROI.push_back(t);
-                }
-            }
+            selection.centers.resize(elements.size());
+            for (sofa::Index i = 0; i < elements.size(); ++i)
+                selection.centers[i] = getElementCenter(elements[i]);
+            selection.centerIndex.update(sofa::Size(elements.size()), [&selection](sofa::Index i) { return selection.centers[i]; });
+            selection.positionCounter = d_X0.getCounter();
         }
 
-        //Hexahedra
-        if (d_computeHexahedra.getValue())
+        forEachBoxBounds([&](const CPos& bmin, const CPos& bmax)
         {
-            for(unsigned int i=0 ; i<hexahedra.size() ; i++)
+            selection.centerIndex.query(bmin, bmax, [&](sofa::Index i)
             {
-                Hexa t = hexahedra[i];
-                const bool is_in_box = (strict) ? isHexahedronInBoxesStrict(t) : isHexahedronInBoxes(t);
-                if (is_in_box)
-                {
-                    hexahedronIndices.push_back(i);
-                    hexahedraInROI.push_back(t);
-                }
-            }
-        }
+                if (isPointInBoxes(selection.centers[i]))
+                    elementIndices.push_back(i);
+            });
+        });
+    }
+
+    if (topologyChanged)
+    {
+        selection.topologyCounter = d_elements.getCounter();
+        selection.nbPoints = nbPoints;
+    }
+
+    // an element center may be reached from several boxes
+    std::sort(elementIndices.begin(), elementIndices.end());
+    elementIndices.erase(std::unique(elementIndices.begin(), elementIndices.end()), elementIndices.end());
+
+    elementsInROI.resize(elementIndices.size());
+    for (std::size_t i = 0; i < elementIndices.size(); ++i)
+        elementsInROI[i] = elements[elementIndices[i]];
+}
+
+// The update method is called when the engine is marked as dirty.
+// The points and the element centers are kept in spatial indices, so that only the
+// candidates close to the boxes are tested. The outputs are only written when the
+// selection changed, so that the components using them are not invalidated when a
+// box moves without changing the selection.
+template <class DataTypes>
+void BoxROI<DataTypes>::doUpdate()
+{
+    if(d_componentState.getValue() == ComponentState::Invalid){
+        return ;
+    }
+
+
+    if(d_doUpdate.getValue()){
+
+        SetIndex indices, edgeIndices, triangleIndices, tetrahedronIndices, hexahedronIndices, quadIndices;
+        VecCoord pointsInROI;
+        vector<Edge> edgesInROI;
+        vector<Triangle> trianglesInROI;
+        vector<Tetra> tetrahedraInROI;
+        vector<Hexa> hexahedraInROI;
+        vector<Quad> quadInROI;
+
+        const VecCoord& x0 = d_X0.getValue();
+        const vector<type::Vec6>&  alignedBoxes  = d_alignedBoxes.getValue();
+        const vector<Vec10>& orientedBoxes = d_orientedBoxes.getValue();
 
-        //Quads
-        if (d_computeQuad.getValue())
+        if (x0.size() == 0)
         {
-            for(unsigned int i=0 ; i<quad.size() ; i++)
-            {
-                Quad q = quad[i];
-                const bool is_in_box = (strict) ? isQuadInBoxesStrict(q) : isQuadInBoxes(q);
-                if (is_in_box)
-                {
-                    quadIndices.push_back(i);
-                    quadInROI.push_back(q);
-                }
-            }
+            msg_warning() << "No rest position yet defined. Box might not work properly. \n"
+                            "This may be caused by an early call of init() on the box before  \n"
+                            "the mesh or the MechanicalObject of the node was initialized too";
         }
+        else if (!alignedBoxes.empty() || !orientedBoxes.empty())
+        {
+            // follow the oriented boxes when they are moved during the simulation
+            computeOrientedBoxes();
+
+            updatePointIndex();
+
+            //Points
+            selectPoints(indices);
+            pointsInROI.resize(indices.size());
+            for (std::size_t i = 0; i < indices.size(); ++i)
+                pointsInROI[i] = x0[indices[i]];
+
+            //Edges
+            if (d_computeEdges.getValue())
+                selectElements(d_edges, m_edgeSelection, edgeIndices, edgesInROI);
 
+            //Triangles
+            if (d_computeTriangles.getValue())
+                selectElements(d_triangles, m_triangleSelection, triangleIndices, trianglesInROI);
+
+            //Tetrahedra
+            if (d_computeTetrahedra.getValue())
+                selectElements(d_tetrahedra, m_tetrahedronSelection, tetrahedronIndices, tetrahedraInROI);
+
+            //Hexahedra
+            if (d_computeHexahedra.getValue())
+                selectElements(d_hexahedra, m_hexahedronSelection, hexahedronIndices, hexahedraInROI);
+
+            //Quads
+            if (d_computeQuad.getValue())
+                selectElements(d_quad, m_quadSelection, quadIndices, quadInROI);
+        }
 
-        d_nbIndices.setValue(sofa::Size(indices.size()));
+        setValueIfChanged(d_indices, indices);
+        setValueIfChanged(d_edgeIndices, edgeIndices);
+        setValueIfChanged(d_triangleIndices, triangleIndices);
+        setValueIfChanged(d_tetrahedronIndices, tetrahedronIndices);
+        setValueIfChanged(d_hexahedronIndices, hexahedronIndices);
+        setValueIfChanged(d_quadIndices, quadIndices);
+
+        setValueIfChanged(d_pointsInROI, pointsInROI);
+        setValueIfChanged(d_edgesInROI, edgesInROI);
+        setValueIfChanged(d_trianglesInROI, trianglesInROI);
+        setValueIfChanged(d_tetrahedraInROI, tetrahedraInROI);
+        setValueIfChanged(d_hexahedraInROI, hexahedraInROI);
+        setValueIfChanged(d_quadInROI, quadInROI);
+
+        setValueIfChanged(d_nbIndices, sofa::Size(indices.size()));
     }
 }
 
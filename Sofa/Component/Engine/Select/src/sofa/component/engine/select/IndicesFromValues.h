@@ -56,6 +56,8 @@ public:
 
     void reinit() override;
 
+    bool isThreadSafe() const override { return true; }
+
     void doUpdate() override;
 
     core::objectmodel::Data<VecValue> f_values; ///< input values
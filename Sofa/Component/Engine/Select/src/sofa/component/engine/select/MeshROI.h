@@ -31,6 +31,7 @@
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/core/loader/MeshLoader.h>
 #include <sofa/defaulttype/RigidTypes.h>
+#include <sofa/component/engine/select/ROISpatialIndex.h>
 
 namespace sofa::component::engine::select
 {
@@ -64,6 +65,7 @@ public:
 
     void init() override;
     void reinit() override;
+    bool isThreadSafe() const override { return true; }
     void doUpdate() override;
     void draw(const core::visual::VisualParams*) override;
 
@@ -100,6 +102,13 @@ protected:
     void checkInputData();
     void computeBoundingBox();
 
+    /// Flag the points inside the mesh, testing only the ones close to its bounding box
+    void selectPointsInMesh();
+
+    ROISpatialIndex<CPos> m_pointIndex;
+    int m_indexedPositionCounter { -1 };
+    std::vector<bool> m_isPointInMesh;
+
 public:
     //Input
     // Global mesh
@@ -369,13 +369,39 @@ bool MeshROI<DataTypes>::isPointInMesh(const typename DataTypes::CPos& p)
 template <class DataTypes>
 bool MeshROI<DataTypes>::isPointInIndices(const unsigned int &pointId)
 {
-    const ReadAccessor<Data<SetIndex>> indices = d_indices;
+    return pointId < m_isPointInMesh.size() && m_isPointInMesh[pointId];
+}
 
-    for (unsigned int i=0; i<indices.size(); i++)
-        if(indices[i]==pointId)
-            return true;
+template <class DataTypes>
+void MeshROI<DataTypes>::selectPointsInMesh()
+{
+    const VecCoord& x0 = d_X0.getValue();
 
-    return false;
+    if(!d_computeTemplateTriangles.getValue())
+    {
+        m_isPointInMesh.assign(x0.size(), true);
+        return;
+    }
+
+    if (m_indexedPositionCounter != d_X0.getCounter() || m_pointIndex.size() != x0.size())
+    {
+        m_pointIndex.update(sofa::Size(x0.size()), [&x0](sofa::Index i) { return DataTypes::getCPos(x0[i]); });
+        m_indexedPositionCounter = d_X0.getCounter();
+    }
+
+    // only the points in the cells overlapping the bounding box of the mesh are tested
+    m_isPointInMesh.assign(x0.size(), false);
+    const Vec6 b = d_box.getValue();
+    CPos bmin, bmax;
+    for (sofa::Size d = 0; d < ROISpatialIndex<CPos>::Dim; ++d)
+    {
+        bmin[d] = b[d];
+        bmax[d] = b[d + 3];
+    }
+    m_pointIndex.query(bmin, bmax, [&](sofa::Index i)
+    {
+        m_isPointInMesh[i] = isPointInMesh(DataTypes::getCPos(x0[i]));
+    });
 }
 
 template <class DataTypes>
@@ -453,53 +479,21 @@ void MeshROI<DataTypes>::compute()
 
     cleanDirty();
 
-    // Write accessor for topological element indices in MESH
-    SetIndex& indices = *d_indices.beginWriteOnly();
-    SetIndex& edgeIndices = *d_edgeIndices.beginWriteOnly();
-    SetIndex& triangleIndices = *d_triangleIndices.beginWriteOnly();
-    SetIndex& tetrahedronIndices = *d_tetrahedronIndices.beginWriteOnly();
-    SetIndex& indicesOut = *d_indicesOut.beginWriteOnly();
-    SetIndex& edgeOutIndices = *d_edgeOutIndices.beginWriteOnly();
-    SetIndex& triangleOutIndices = *d_triangleOutIndices.beginWriteOnly();
-    SetIndex& tetrahedronOutIndices = *d_tetrahedronOutIndices.beginWriteOnly();
-
-    // Write accessor for toplogical element in MESH
-    WriteOnlyAccessor< Data<VecCoord > > pointsInROI = d_pointsInROI;
-    WriteOnlyAccessor< Data<vector<Edge> > > edgesInROI = d_edgesInROI;
-    WriteOnlyAccessor< Data<vector<Triangle> > > trianglesInROI = d_trianglesInROI;
-    WriteOnlyAccessor< Data<vector<Tetra> > > tetrahedraInROI = d_tetrahedraInROI;
-    WriteOnlyAccessor< Data<VecCoord > > pointsOutROI = d_pointsOutROI;
-    WriteOnlyAccessor< Data<vector<Edge> > > edgesOutROI = d_edgesOutROI;
-    WriteOnlyAccessor< Data<vector<Triangle> > > trianglesOutROI = d_trianglesOutROI;
-    WriteOnlyAccessor< Data<vector<Tetra> > > tetrahedraOutROI = d_tetrahedraOutROI;
-
-    // Clear lists
-    indices.clear();
-    edgeIndices.clear();
-    triangleIndices.clear();
-    tetrahedronIndices.clear();
-
-    pointsInROI.clear();
-    edgesInROI.clear();
-    trianglesInROI.clear();
-    tetrahedraInROI.clear();
-    indicesOut.clear();
-    edgeOutIndices.clear();
-    triangleOutIndices.clear();
-    tetrahedronOutIndices.clear();
-
-    pointsOutROI.clear();
-    edgesOutROI.clear();
-    trianglesOutROI.clear();
-    tetrahedraOutROI.clear();
-
+    // Selected topological element indices and elements in and out of the MESH
+    SetIndex indices, edgeIndices, triangleIndices, tetrahedronIndices;
+    SetIndex indicesOut, edgeOutIndices, triangleOutIndices, tetrahedronOutIndices;
+    VecCoord pointsInROI, pointsOutROI;
+    vector<Edge> edgesInROI, edgesOutROI;
+    vector<Triangle> trianglesInROI, trianglesOutROI;
+    vector<Tetra> tetrahedraInROI, tetrahedraOutROI;
 
     const VecCoord* x0 = &d_X0.getValue();
+    selectPointsInMesh();
+
     //Points
     for( unsigned i=0; i<x0->size(); ++i )
     {
-        CPos p =  DataTypes::getCPos((*x0)[i]);
-        if (isPointInMesh(p))
+        if (m_isPointInMesh[i])
         {
             indices.push_back(i);
             pointsInROI.push_back((*x0)[i]);
@@ -567,15 +561,24 @@ void MeshROI<DataTypes>::compute()
             }
         }
     }
-    d_indices.endEdit();
-    d_edgeIndices.endEdit();
-    d_triangleIndices.endEdit();
-    d_tetrahedronIndices.endEdit();
-
-    d_indicesOut.endEdit();
-    d_edgeOutIndices.endEdit();
-    d_triangleOutIndices.endEdit();
-    d_tetrahedronOutIndices.endEdit();
+    // Only the outputs which changed are written
+    setValueIfChanged(d_indices, indices);
+    setValueIfChanged(d_edgeIndices, edgeIndices);
+    setValueIfChanged(d_triangleIndices, triangleIndices);
+    setValueIfChanged(d_tetrahedronIndices, tetrahedronIndices);
+    setValueIfChanged(d_pointsInROI, pointsInROI);
+    setValueIfChanged(d_edgesInROI, edgesInROI);
+    setValueIfChanged(d_trianglesInROI, trianglesInROI);
+    setValueIfChanged(d_tetrahedraInROI, tetrahedraInROI);
+
+    setValueIfChanged(d_indicesOut, indicesOut);
+    setValueIfChanged(d_edgeOutIndices, edgeOutIndices);
+    setValueIfChanged(d_triangleOutIndices, triangleOutIndices);
+    setValueIfChanged(d_tetrahedronOutIndices, tetrahedronOutIndices);
+    setValueIfChanged(d_pointsOutROI, pointsOutROI);
+    setValueIfChanged(d_edgesOutROI, edgesOutROI);
+    setValueIfChanged(d_trianglesOutROI, trianglesOutROI);
+    setValueIfChanged(d_tetrahedraOutROI, tetrahedraOutROI);
 }
 
 
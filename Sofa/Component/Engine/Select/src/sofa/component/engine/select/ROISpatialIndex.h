@@ -0,0 +1,327 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/engine/select/config.h>
+
+#include <sofa/core/objectmodel/Data.h>
+#include <sofa/type/vector.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace sofa::component::engine::select
+{
+
+/**
+ * Uniform grid over a set of points, shared by the ROI engines to restrict
+ * their inclusion tests to the points lying close to the regions of interest.
+ *
+ * The grid is fitted to the bounding box of the points when it is built. On
+ * the next updates only the points which changed cell are moved, and the grid
+ * is fitted again when the number of points changed or when the points left
+ * (or shrank well inside) the fitted bounds. Points outside the bounds are
+ * stored in the border cells, so queries never miss a point.
+ *
+ * Only the first three coordinates of CPos are indexed.
+ */
+template <class CPos>
+class ROISpatialIndex
+{
+public:
+    typedef typename CPos::value_type Real;
+    typedef sofa::Index Index;
+    static constexpr sofa::Size Dim = std::min<sofa::Size>(CPos::static_size, 3);
+
+    /// Number of indexed points
+    sofa::Size size() const { return sofa::Size(m_cellOfPoint.size()); }
+
+    /// Number of cells of the grid
+    sofa::Size getNbCells() const { return sofa::Size(m_cells.size()); }
+
+    void clear()
+    {
+        m_cells.clear();
+        m_cellOfPoint.clear();
+        m_slotOfPoint.clear();
+    }
+
+    /// Update the index with the positions returned by getPos(i), for i in [0, nbPoints).
+    /// Return the number of points which changed cell (nbPoints if the grid was rebuilt).
+    template <class GetPos>
+    sofa::Size update(sofa::Size nbPoints, const GetPos& getPos)
+    {
+        if (nbPoints != m_cellOfPoint.size())
+        {
+            build(nbPoints, getPos);
+            return nbPoints;
+        }
+
+        CPos bmin, bmax;
+        computeBounds(nbPoints, getPos, bmin, bmax);
+        if (!fits(bmin, bmax))
+        {
+            build(nbPoints, getPos);
+            return nbPoints;
+        }
+
+        sofa::Size nbMoved = 0;
+        for (Index i = 0; i < nbPoints; ++i)
+        {
+            const Index cell = cellOf(getPos(i));
+            if (cell != m_cellOfPoint[i])
+            {
+                removeFromCell(i);
+                addToCell(i, cell);
+                ++nbMoved;
+            }
+        }
+        return nbMoved;
+    }
+
+    /// Call f(i) for every point i whose cell overlaps the box [bmin, bmax].
+    /// Every point inside the box is visited, together with some points close to it.
+    template <class F>
+    void query(const CPos& bmin, const CPos& bmax, F&& f) const
+    {
+        if (m_cells.empty())
+            return;
+
+        std::array<int, Dim> lo, hi;
+        for (sofa::Size d = 0; d < Dim; ++d)
+        {
+            if (!(bmin[d] <= bmax[d]))
+                return;
+            lo[d] = coordOf(bmin[d], d);
+            hi[d] = coordOf(bmax[d], d);
+        }
+
+        std::array<int, Dim> c = lo;
+        while (true)
+        {
+            Index cell = 0;
+            for (int d = int(Dim) - 1; d >= 0; --d)
+                cell = cell * Index(m_dims[d]) + Index(c[d]);
+            for (const Index i : m_cells[cell])
+                f(i);
+
+            sofa::Size d = 0;
+            while (d < Dim && c[d] == hi[d])
+            {
+                c[d] = lo[d];
+                ++d;
+            }
+            if (d == Dim)
+                break;
+            ++c[d];
+        }
+    }
+
+protected:
+    template <class GetPos>
+    static void computeBounds(sofa::Size nbPoints, const GetPos& getPos, CPos& bmin, CPos& bmax)
+    {
+        for (sofa::Size d = 0; d < Dim; ++d)
+        {
+            bmin[d] = std::numeric_limits<Real>::max();
+            bmax[d] = std::numeric_limits<Real>::lowest();
+        }
+        for (Index i = 0; i < nbPoints; ++i)
+        {
+            const CPos& p = getPos(i);
+            for (sofa::Size d = 0; d < Dim; ++d)
+            {
+                bmin[d] = std::min(bmin[d], p[d]);
+                bmax[d] = std::max(bmax[d], p[d]);
+            }
+        }
+    }
+
+    /// The grid is kept as long as the points stay within one cell of the
+    /// fitted bounds and still cover at least half of them.
+    bool fits(const CPos& bmin, const CPos& bmax) const
+    {
+        for (sofa::Size d = 0; d < Dim; ++d)
+        {
+            if (bmin[d] < m_min[d] - m_cellSize || bmax[d] > m_max[d] + m_cellSize)
+                return false;
+            const Real fitted = m_max[d] - m_min[d];
+            if (fitted > m_cellSize && 2 * (bmax[d] - bmin[d]) < fitted)
+                return false;
+        }
+        return true;
+    }
+
+    template <class GetPos>
+    void build(sofa::Size nbPoints, const GetPos& getPos)
+    {
+        clear();
+        computeBounds(nbPoints, getPos, m_min, m_max);
+
+        // about two points per cell, the cell size being computed on the
+        // dimensions whose extent is larger than a cell
+        std::array<Real, Dim> extent;
+        std::array<bool, Dim> active;
+        for (sofa::Size d = 0; d < Dim; ++d)
+        {
+            extent[d] = m_max[d] - m_min[d];
+            active[d] = extent[d] > 0 && std::isfinite(extent[d]);
+        }
+
+        m_cellSize = 1;
+        bool changed = (nbPoints > 0);
+        while (changed)
+        {
+            double volume = 1;
+            int nbActiveDims = 0;
+            for (sofa::Size d = 0; d < Dim; ++d)
+            {
+                if (active[d])
+                {
+                    volume *= extent[d];
+                    ++nbActiveDims;
+                }
+            }
+            if (nbActiveDims == 0)
+                break;
+
+            m_cellSize = Real(std::pow(2.0 * volume / nbPoints, 1.0 / nbActiveDims));
+            changed = false;
+            for (sofa::Size d = 0; d < Dim; ++d)
+            {
+                if (active[d] && extent[d] < m_cellSize)
+                {
+                    active[d] = false;
+                    changed = true;
+                }
+            }
+        }
+        if (!(m_cellSize > 0) || !std::isfinite(m_cellSize))
+            m_cellSize = 1;
+        m_invCellSize = 1 / m_cellSize;
+
+        std::size_t nbCells = 1;
+        for (sofa::Size d = 0; d < Dim; ++d)
+        {
+            const double n = std::isfinite(extent[d]) ? std::floor(double(extent[d]) * m_invCellSize) + 1 : 1;
+            m_dims[d] = int(std::clamp(n, 1.0, double(s_maxCellsPerDim)));
+            nbCells *= std::size_t(m_dims[d]);
+        }
+
+        m_cells.resize(nbCells);
+        m_cellOfPoint.resize(nbPoints);
+        m_slotOfPoint.resize(nbPoints);
+        for (Index i = 0; i < nbPoints; ++i)
+            addToCell(i, cellOf(getPos(i)));
+    }
+
+    int coordOf(Real x, sofa::Size d) const
+    {
+        // clamping is done before the conversion to int, and keeps the
+        // cell coordinate monotonic in x, which makes the queries exact
+        const Real t = (x - m_min[d]) * m_invCellSize;
+        if (!(t > 0))
+            return 0;
+        if (t >= Real(m_dims[d]))
+            return m_dims[d] - 1;
+        return int(t);
+    }
+
+    Index cellOf(const CPos& p) const
+    {
+        Index cell = 0;
+        for (int d = int(Dim) - 1; d >= 0; --d)
+            cell = cell * Index(m_dims[d]) + Index(coordOf(p[d], d));
+        return cell;
+    }
+
+    void addToCell(Index i, Index cell)
+    {
+        m_cellOfPoint[i] = cell;
+        m_slotOfPoint[i] = Index(m_cells[cell].size());
+        m_cells[cell].push_back(i);
+    }
+
+    void removeFromCell(Index i)
+    {
+        auto& points = m_cells[m_cellOfPoint[i]];
+        const Index slot = m_slotOfPoint[i];
+        points[slot] = points.back();
+        m_slotOfPoint[points[slot]] = slot;
+        points.pop_back();
+    }
+
+    static constexpr int s_maxCellsPerDim = 1 << 20;
+
+    CPos m_min, m_max;
+    Real m_cellSize { 1 };
+    Real m_invCellSize { 1 };
+    std::array<int, Dim> m_dims {};
+
+    type::vector< type::vector<Index> > m_cells;
+    type::vector<Index> m_cellOfPoint;
+    type::vector<Index> m_slotOfPoint;
+};
+
+namespace roispatialindex
+{
+
+template <class T, class = void>
+struct HasEqualOperator : std::false_type {};
+
+template <class T>
+struct HasEqualOperator<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())> > : std::true_type {};
+
+/// The topological elements do not define operator==, they are compared as arrays
+template <class T>
+bool isSameValue(const T& a, const T& b)
+{
+    if constexpr (HasEqualOperator<T>::value)
+        return a == b;
+    else
+        return std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <class T>
+bool isSameValue(const type::vector<T>& a, const type::vector<T>& b)
+{
+    return a.size() == b.size()
+        && std::equal(a.begin(), a.end(), b.begin(), [](const T& x, const T& y) { return isSameValue(x, y); });
+}
+
+} // namespace roispatialindex
+
+/// Set the value of an output of a ROI engine only if it differs from the current one.
+/// Unchanged outputs keep their counter, so the components reading them do not see
+/// a modification when the selection is stable from one step to the next.
+template <class T>
+bool setValueIfChanged(core::objectmodel::Data<T>& data, const T& value)
+{
+    if (roispatialindex::isSameValue(data.getValue(), value))
+        return false;
+    data.setValue(value);
+    return true;
+}
+
+} // namespace sofa::component::engine::select
@@ -30,6 +30,7 @@
 #include <sofa/core/behavior/MechanicalState.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/core/loader/MeshLoader.h>
+#include <sofa/component/engine/select/ROISpatialIndex.h>
 
 namespace sofa::component::engine::select
 {
@@ -102,6 +103,13 @@ protected:
     bool isQuadInSphere(const Vec3& c, const Real& r, const sofa::core::topology::BaseMeshTopology::Quad& quad);
     bool isTetrahedronInSphere(const Vec3& c, const Real& r, const sofa::core::topology::BaseMeshTopology::Tetra& tetrahedron);
 
+    /// Flag the points contained in at least one sphere, using the index over the rest positions
+    void selectPointsInSpheres();
+
+    ROISpatialIndex<CPos> m_pointIndex;
+    int m_indexedPositionCounter { -1 };
+    std::vector<bool> m_isPointInSpheres;
+
 public:
     //Input
     Data< type::vector<Vec3> > centers; ///< Center(s) of the sphere(s)
@@ -304,60 +304,44 @@ void SphereROI<DataTypes>::doUpdate()
 
     const VecCoord* x0 = &f_X0.getValue();
 
-
-    // Write accessor for topological element indices in SPHERE
-    SetIndex& indices = *(f_indices.beginWriteOnly());
-    SetIndex& edgeIndices = *(f_edgeIndices.beginWriteOnly());
-    SetIndex& triangleIndices = *(f_triangleIndices.beginWriteOnly());
-    SetIndex& quadIndices = *(f_quadIndices.beginWriteOnly());
-    SetIndex& tetrahedronIndices = *f_tetrahedronIndices.beginWriteOnly();
-    SetIndex& indicesOut = *(f_indicesOut.beginWriteOnly());
-
-    // Write accessor for toplogical element in SPHERE
-    helper::WriteOnlyAccessor< Data<VecCoord > > pointsInROI = f_pointsInROI;
-    helper::WriteOnlyAccessor< Data<type::vector<Edge> > > edgesInROI = f_edgesInROI;
-    helper::WriteOnlyAccessor< Data<type::vector<Triangle> > > trianglesInROI = f_trianglesInROI;
-    helper::WriteOnlyAccessor< Data<type::vector<Quad> > > quadsInROI = f_quadsInROI;
-    helper::WriteOnlyAccessor< Data<type::vector<Tetra> > > tetrahedraInROI = f_tetrahedraInROI;
-
-    // Clear lists
-    indices.clear();
-    edgeIndices.clear();
-    triangleIndices.clear();
-    quadIndices.clear();
-    tetrahedronIndices.clear();
-    indicesOut.clear();
-
-    pointsInROI.clear();
-    edgesInROI.clear();
-    trianglesInROI.clear();
-    quadsInROI.clear();
-    tetrahedraInROI.clear();
-
+    // Selected topological element indices and elements in SPHERE
+    SetIndex indices, edgeIndices, triangleIndices, quadIndices, tetrahedronIndices, indicesOut;
+    VecCoord pointsInROI;
+    type::vector<Edge> edgesInROI;
+    type::vector<Triangle> trianglesInROI;
+    type::vector<Quad> quadsInROI;
+    type::vector<Tetra> tetrahedraInROI;
 
     //Points
+    selectPointsInSpheres();
     for( unsigned i=0; i<x0->size(); ++i )
     {
-        bool isInSpheres = false;
-        for (unsigned int j=0; j<cen.size(); ++j)
+        if (m_isPointInSpheres[i])
         {
-            if (isPointInSphere(cen[j], rad[j], (*x0)[i]))
-            {
-                indices.push_back(i);
-                pointsInROI.push_back((*x0)[i]);
-                isInSpheres = true;
-                break;
-            }
+            indices.push_back(i);
+            pointsInROI.push_back((*x0)[i]);
         }
-        if (!isInSpheres) indicesOut.push_back(i);
+        else
+            indicesOut.push_back(i);
     }
 
+    // An element is in a sphere only if all its vertices are in it, so the
+    // elements with a vertex outside all the spheres are not tested
+    const auto hasAllPointsInSpheres = [this, x0](const auto& element)
+    {
+        for (const auto v : element)
+            if (v >= x0->size() || !m_isPointInSpheres[v])
+                return false;
+        return true;
+    };
+
     //Edges
     if (f_computeEdges.getValue())
     {
         for(unsigned int i=0 ; i<edges.size() ; i++)
         {
             Edge edge = edges[i];
+            if (!hasAllPointsInSpheres(edge)) continue;
             for (unsigned int j=0; j<cen.size(); ++j)
             {
                 if (isEdgeInSphere(cen[j], rad[j], edge))
@@ -382,6 +366,7 @@ void SphereROI<DataTypes>::doUpdate()
         for(unsigned int i=0 ; i<triangles.size() ; i++)
         {
             Triangle tri = triangles[i];
+            if (!hasAllPointsInSpheres(tri)) continue;
             for (unsigned int j=0; j<cen.size(); ++j)
             {
                 if (isTriangleInSphere(cen[j], rad[j], tri))
@@ -406,6 +391,7 @@ void SphereROI<DataTypes>::doUpdate()
         for(unsigned int i=0 ; i<quads.size() ; i++)
         {
             Quad qua = quads[i];
+            if (!hasAllPointsInSpheres(qua)) continue;
             for (unsigned int j=0; j<cen.size(); ++j)
             {
                 if (isQuadInSphere(cen[j], rad[j], qua))
@@ -424,6 +410,7 @@ void SphereROI<DataTypes>::doUpdate()
         for(unsigned int i=0 ; i<tetrahedra.size() ; i++)
         {
             Tetra t = tetrahedra[i];
+            if (!hasAllPointsInSpheres(t)) continue;
             for (unsigned int j=0; j<cen.size(); ++j)
             {
                 if (isTetrahedronInSphere(cen[j], rad[j], t))
@@ -437,11 +424,53 @@ void SphereROI<DataTypes>::doUpdate()
         }
     }
 
-    f_indices.endEdit();
-    f_edgeIndices.endEdit();
-    f_triangleIndices.endEdit();
-    f_quadIndices.endEdit();
-    f_tetrahedronIndices.endEdit();
+    // Only the outputs which changed are written
+    setValueIfChanged(f_indices, indices);
+    setValueIfChanged(f_edgeIndices, edgeIndices);
+    setValueIfChanged(f_triangleIndices, triangleIndices);
+    setValueIfChanged(f_quadIndices, quadIndices);
+    setValueIfChanged(f_tetrahedronIndices, tetrahedronIndices);
+    setValueIfChanged(f_indicesOut, indicesOut);
+
+    setValueIfChanged(f_pointsInROI, pointsInROI);
+    setValueIfChanged(f_edgesInROI, edgesInROI);
+    setValueIfChanged(f_trianglesInROI, trianglesInROI);
+    setValueIfChanged(f_quadsInROI, quadsInROI);
+    setValueIfChanged(f_tetrahedraInROI, tetrahedraInROI);
+}
+
+template <class DataTypes>
+void SphereROI<DataTypes>::selectPointsInSpheres()
+{
+    const VecCoord& x0 = f_X0.getValue();
+    const type::vector<Vec3>& cen = centers.getValue();
+    const type::vector<Real>& rad = radii.getValue();
+
+    if (m_indexedPositionCounter != f_X0.getCounter() || m_pointIndex.size() != x0.size())
+    {
+        m_pointIndex.update(sofa::Size(x0.size()), [&x0](sofa::Index i) { return DataTypes::getCPos(x0[i]); });
+        m_indexedPositionCounter = f_X0.getCounter();
+    }
+
+    // only the points in the cells overlapping the bounds of a sphere are tested
+    m_isPointInSpheres.assign(x0.size(), false);
+    for (unsigned int j = 0; j < cen.size() && j < rad.size(); ++j)
+    {
+        // leave some room for the rounding of the distance computation
+        const Real margin = rad[j] * Real(1e-6);
+        CPos bmin, bmax;
+        for (sofa::Size d = 0; d < ROISpatialIndex<CPos>::Dim; ++d)
+        {
+            bmin[d] = cen[j][d] - rad[j] - margin;
+            bmax[d] = cen[j][d] + rad[j] + margin;
+        }
+
+        m_pointIndex.query(bmin, bmax, [&](sofa::Index i)
+        {
+            if (!m_isPointInSpheres[i] && isPointInSphere(cen[j], rad[j], x0[i]))
+                m_isPointInSpheres[i] = true;
+        });
+    }
 }
 
 template <class DataTypes>
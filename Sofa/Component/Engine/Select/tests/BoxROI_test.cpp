@@ -26,6 +26,8 @@ using std::vector;
 #include <string>
 using std::string;
 
+#include <sstream>
+
 #include <gtest/gtest.h>
 using ::testing::Types;
 #include <sofa/core/fwd.h>
@@ -341,6 +343,77 @@ struct BoxROITest :  public sofa::testing::BaseTest
         EXPECT_EQ(m_boxroi->f_bbox.getValue().maxBBox(), Vec3(2,2,1));
     }
 
+
+    /// Move a box over a grid of points, the selection being done through the spatial
+    /// index, and compare it with a direct test of every point and edge.
+    void movingBoxTest()
+    {
+        std::ostringstream positions, edges;
+        for (int k = 0; k < 10; ++k)
+            for (int j = 0; j < 10; ++j)
+                for (int i = 0; i < 10; ++i)
+                {
+                    positions << i << " " << j << " " << k << " ";
+                    if (i < 9)
+                        edges << (i + 10 * (j + 10 * k)) << " " << (i + 1 + 10 * (j + 10 * k)) << " ";
+                }
+        m_boxroi->findData("position")->read(positions.str());
+        m_boxroi->findData("edges")->read(edges.str());
+
+        const auto isInside = [](int i, int j, int k, double x)
+        {
+            return i >= x && i <= x + 2.5 && j >= 2 && j <= 5.5 && k >= 3 && k <= 6;
+        };
+
+        for (int step = 0; step < 12; ++step)
+        {
+            const double x = -1 + 0.7 * step;
+            std::ostringstream box;
+            box << x << " 2 3 " << x + 2.5 << " 5.5 6";
+            m_boxroi->findData("box")->read(box.str());
+            m_boxroi->update();
+
+            std::ostringstream expectedPoints, expectedEdges;
+            int edgeId = 0;
+            for (int k = 0; k < 10; ++k)
+                for (int j = 0; j < 10; ++j)
+                    for (int i = 0; i < 10; ++i)
+                    {
+                        if (isInside(i, j, k, x))
+                            expectedPoints << (expectedPoints.tellp() > 0 ? " " : "") << (i + 10 * (j + 10 * k));
+                        if (i < 9)
+                        {
+                            if (isInside(i, j, k, x) && isInside(i + 1, j, k, x))
+                                expectedEdges << (expectedEdges.tellp() > 0 ? " " : "") << edgeId;
+                            ++edgeId;
+                        }
+                    }
+
+            EXPECT_EQ(m_boxroi->findData("indices")->getValueString(), expectedPoints.str()) << "step " << step;
+            EXPECT_EQ(m_boxroi->findData("edgeIndices")->getValueString(), expectedEdges.str()) << "step " << step;
+        }
+    }
+
+
+    /// The outputs are left untouched when the box moves without changing the selection
+    void unchangedSelectionTest()
+    {
+        m_boxroi->findData("box")->read("0. 0. 0. 1. 1. 1.");
+        m_boxroi->findData("position")->read("0. 0. 0. 1. 1. 1. 2. 2. 2.");
+        m_boxroi->update();
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"0 1");
+        const int counter = m_boxroi->findData("indices")->getCounter();
+
+        m_boxroi->findData("box")->read("-0.5 -0.5 -0.5 1.5 1.5 1.5");
+        m_boxroi->update();
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"0 1");
+        EXPECT_EQ(m_boxroi->findData("indices")->getCounter(), counter);
+
+        m_boxroi->findData("box")->read("1.5 1.5 1.5 2.5 2.5 2.5");
+        m_boxroi->update();
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"2");
+        EXPECT_NE(m_boxroi->findData("indices")->getCounter(), counter);
+    }
 };
 
 
@@ -416,3 +489,10 @@ TYPED_TEST(BoxROITest, computeBBoxTest) {
     ASSERT_NO_THROW(this->computeBBoxTest());
 }
 
+TYPED_TEST(BoxROITest, movingBoxTest) {
+    ASSERT_NO_THROW(this->movingBoxTest());
+}
+
+TYPED_TEST(BoxROITest, unchangedSelectionTest) {
+    ASSERT_NO_THROW(this->unchangedSelectionTest());
+}
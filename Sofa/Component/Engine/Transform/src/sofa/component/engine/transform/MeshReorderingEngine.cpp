@@ -0,0 +1,153 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_COMPONENT_ENGINE_MESHREORDERINGENGINE_CPP
+#include <sofa/component/engine/transform/MeshReorderingEngine.inl>
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/defaulttype/VecTypes.h>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/cuthill_mckee_ordering.hpp>
+
+namespace sofa::component::engine::transform
+{
+
+using namespace sofa::defaulttype;
+
+namespace
+{
+
+/// Interleave the bits of the coordinates, from the most significant bit of the first coordinate
+std::uint64_t interleaveBits(const type::vector<std::uint32_t>& x, const unsigned int bitsPerAxis)
+{
+    std::uint64_t key = 0;
+    for (int bit = static_cast<int>(bitsPerAxis) - 1; bit >= 0; --bit)
+    {
+        for (const std::uint32_t xi : x)
+        {
+            key = (key << 1) | ((xi >> bit) & 1u);
+        }
+    }
+    return key;
+}
+
+}
+
+std::uint64_t computeMortonKey(const type::vector<std::uint32_t>& x, const unsigned int bitsPerAxis)
+{
+    return interleaveBits(x, bitsPerAxis);
+}
+
+std::uint64_t computeHilbertKey(type::vector<std::uint32_t> x, const unsigned int bitsPerAxis)
+{
+    // J. Skilling, "Programming the Hilbert curve", AIP Conference Proceedings 707, 2004:
+    // the coordinates are transformed in place into the transposed Hilbert index
+    const std::size_t n = x.size();
+    if (n == 0 || bitsPerAxis == 0)
+    {
+        return 0;
+    }
+    const std::uint32_t m = std::uint32_t(1) << (bitsPerAxis - 1);
+
+    // inverse undo
+    for (std::uint32_t q = m; q > 1; q >>= 1)
+    {
+        const std::uint32_t p = q - 1;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (x[i] & q)
+            {
+                x[0] ^= p; // invert
+            }
+            else
+            {
+                const std::uint32_t t = (x[0] ^ x[i]) & p; // exchange
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        x[i] ^= x[i - 1];
+    }
+    std::uint32_t t = 0;
+    for (std::uint32_t q = m; q > 1; q >>= 1)
+    {
+        if (x[n - 1] & q)
+        {
+            t ^= q - 1;
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        x[i] ^= t;
+    }
+
+    return interleaveBits(x, bitsPerAxis);
+}
+
+void computeReverseCuthillMcKeeOrdering(const type::vector<Index>& adjacencyBegin,
+                                        const type::vector<Index>& adjacency,
+                                        type::vector<Index>& permutation)
+{
+    typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS,
+            boost::property<boost::vertex_color_t, boost::default_color_type,
+            boost::property<boost::vertex_degree_t, int> > > Graph;
+    typedef boost::graph_traits<Graph>::vertex_descriptor Vertex;
+
+    const std::size_t nbVertices = adjacencyBegin.empty() ? 0 : adjacencyBegin.size() - 1;
+
+    Graph graph(nbVertices);
+    for (std::size_t v = 0; v < nbVertices; ++v)
+    {
+        for (Index k = adjacencyBegin[v]; k < adjacencyBegin[v + 1]; ++k)
+        {
+            if (v < adjacency[k])
+            {
+                boost::add_edge(v, adjacency[k], graph);
+            }
+        }
+    }
+
+    std::vector<Vertex> inversePermutation(nbVertices);
+    boost::cuthill_mckee_ordering(graph, inversePermutation.rbegin(),
+        boost::get(boost::vertex_color, graph), boost::make_degree_map(graph));
+
+    const auto indexMap = boost::get(boost::vertex_index, graph);
+    permutation.resize(nbVertices);
+    for (std::size_t i = 0; i < nbVertices; ++i)
+    {
+        permutation[i] = static_cast<Index>(indexMap[inversePermutation[i]]);
+    }
+}
+
+int MeshReorderingEngineClass = core::RegisterObject("Renumber the vertices of a mesh along a space-filling curve or with the reverse Cuthill-McKee ordering, and sort its elements, to improve the memory locality")
+        .add< MeshReorderingEngine<Vec3Types> >(true)
+        .add< MeshReorderingEngine<Vec2Types> >()
+        ;
+
+template class SOFA_COMPONENT_ENGINE_TRANSFORM_API MeshReorderingEngine<Vec3Types>;
+template class SOFA_COMPONENT_ENGINE_TRANSFORM_API MeshReorderingEngine<Vec2Types>;
+
+} //namespace sofa::component::engine::transform
@@ -0,0 +1,135 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/engine/transform/config.h>
+
+#include <sofa/core/DataEngine.h>
+#include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/helper/OptionsGroup.h>
+
+#include <cstdint>
+
+namespace sofa::component::engine::transform
+{
+
+/**
+ * Renumber the vertices of a mesh so that the vertices close in space (space-filling curves) or in the mesh graph
+ * (reverse Cuthill-McKee) are close in memory, and sort the elements by their lowest vertex index.
+ *
+ * Meshes generated by external tools are often numbered randomly: the gathers and scatters of the force fields,
+ * mappings and collision models then access the memory without locality. This engine is inserted between a loader
+ * and the components using the mesh (topology, mechanical object...). It is opt-in: the output is the input if the
+ * method is "none" and the elements are not sorted.
+ *
+ * The permutations are given as outputs, so that other data can be renumbered consistently:
+ * - the vertex indices given in "indices" (e.g. fixed points) are renumbered in "outputIndices",
+ * - any other list of vertex indices can be renumbered with a MapIndices engine whose indices are vertexPermutation,
+ * - the values of a quantity computed on the reordered mesh can be brought back to the original numbering with a
+ *   ValuesFromIndices engine whose indices are inverseVertexPermutation.
+ */
+template <class DataTypes>
+class MeshReorderingEngine : public core::DataEngine
+{
+public:
+    SOFA_CLASS(SOFA_TEMPLATE(MeshReorderingEngine,DataTypes),core::DataEngine);
+
+    typedef typename DataTypes::Real Real;
+    typedef typename DataTypes::Coord Coord;
+    typedef typename DataTypes::VecCoord VecCoord;
+    typedef core::topology::BaseMeshTopology::SeqEdges SeqEdges;
+    typedef core::topology::BaseMeshTopology::SeqTriangles SeqTriangles;
+    typedef core::topology::BaseMeshTopology::SeqQuads SeqQuads;
+    typedef core::topology::BaseMeshTopology::SeqTetrahedra SeqTetrahedra;
+    typedef core::topology::BaseMeshTopology::SeqHexahedra SeqHexahedra;
+    typedef type::vector<Index> VecIndex;
+
+protected:
+    MeshReorderingEngine();
+
+    ~MeshReorderingEngine() override {}
+
+public:
+    void init() override;
+    void reinit() override;
+    void doUpdate() override;
+
+    /// inputs
+    Data<sofa::helper::OptionsGroup> d_method; ///< Vertex ordering: none, morton (Z-order curve), hilbert (Hilbert curve) or reverseCuthillMcKee
+    Data<bool> d_sortElements; ///< Sort the elements by their lowest vertex index
+    Data<VecCoord> d_inputPosition; ///< Input vertices
+    Data<SeqEdges> d_inputEdges; ///< Input edges
+    Data<SeqTriangles> d_inputTriangles; ///< Input triangles
+    Data<SeqQuads> d_inputQuads; ///< Input quads
+    Data<SeqTetrahedra> d_inputTetrahedra; ///< Input tetrahedra
+    Data<SeqHexahedra> d_inputHexahedra; ///< Input hexahedra
+    Data<VecIndex> d_indices; ///< Vertex indices in the input numbering, renumbered in outputIndices
+
+    /// outputs
+    Data<VecCoord> d_position; ///< Reordered vertices
+    Data<SeqEdges> d_edges; ///< Reordered edges
+    Data<SeqTriangles> d_triangles; ///< Reordered triangles
+    Data<SeqQuads> d_quads; ///< Reordered quads
+    Data<SeqTetrahedra> d_tetrahedra; ///< Reordered tetrahedra
+    Data<SeqHexahedra> d_hexahedra; ///< Reordered hexahedra
+    Data<VecIndex> d_outputIndices; ///< Vertex indices given in indices, in the output numbering
+    Data<VecIndex> d_vertexPermutation; ///< Input index of each output vertex
+    Data<VecIndex> d_inverseVertexPermutation; ///< Output index of each input vertex
+    Data<VecIndex> d_edgePermutation; ///< Input index of each output edge
+    Data<VecIndex> d_trianglePermutation; ///< Input index of each output triangle
+    Data<VecIndex> d_quadPermutation; ///< Input index of each output quad
+    Data<VecIndex> d_tetrahedronPermutation; ///< Input index of each output tetrahedron
+    Data<VecIndex> d_hexahedronPermutation; ///< Input index of each output hexahedron
+
+protected:
+    /// Order of the vertices along a space-filling curve, the key of a vertex being computed from its integer coordinates
+    template<class ComputeKey>
+    void computeSpaceFillingCurveOrder(const VecCoord& position, VecIndex& permutation, ComputeKey computeKey) const;
+
+    void computeReverseCuthillMcKeeOrder(Size nbVertices, VecIndex& permutation) const;
+
+    /// Renumber the vertices of the elements and sort the elements by their lowest vertex index if required
+    template<class VecElement>
+    void reorderElements(const Data<VecElement>& input, Data<VecElement>& output, Data<VecIndex>& permutation,
+                         const VecIndex& inverseVertexPermutation, bool sortElements) const;
+};
+
+/// Index of the cell of integer coordinates x (bitsPerAxis bits each) along the Z-order (Morton) curve
+SOFA_COMPONENT_ENGINE_TRANSFORM_API std::uint64_t computeMortonKey(const type::vector<std::uint32_t>& x, unsigned int bitsPerAxis);
+
+/// Index of the cell of integer coordinates x (bitsPerAxis bits each) along the Hilbert curve
+SOFA_COMPONENT_ENGINE_TRANSFORM_API std::uint64_t computeHilbertKey(type::vector<std::uint32_t> x, unsigned int bitsPerAxis);
+
+/**
+ * Reverse Cuthill-McKee ordering of the vertices of a graph: permutation[i] is the vertex placed at the position i.
+ * The neighbors of the vertex v are adjacency[adjacencyBegin[v]] to adjacency[adjacencyBegin[v + 1] - 1].
+ */
+SOFA_COMPONENT_ENGINE_TRANSFORM_API void computeReverseCuthillMcKeeOrdering(const type::vector<Index>& adjacencyBegin,
+                                                                           const type::vector<Index>& adjacency,
+                                                                           type::vector<Index>& permutation);
+
+#if !defined(SOFA_COMPONENT_ENGINE_MESHREORDERINGENGINE_CPP)
+extern template class SOFA_COMPONENT_ENGINE_TRANSFORM_API MeshReorderingEngine<defaulttype::Vec3Types>;
+extern template class SOFA_COMPONENT_ENGINE_TRANSFORM_API MeshReorderingEngine<defaulttype::Vec2Types>;
+#endif
+
+} //namespace sofa::component::engine::transform
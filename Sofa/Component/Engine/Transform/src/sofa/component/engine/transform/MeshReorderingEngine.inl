@@ -0,0 +1,298 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/engine/transform/MeshReorderingEngine.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace sofa::component::engine::transform
+{
+
+template <class DataTypes>
+MeshReorderingEngine<DataTypes>::MeshReorderingEngine()
+    : d_method(initData(&d_method, helper::OptionsGroup{{"none", "morton", "hilbert", "reverseCuthillMcKee"}}.setSelectedItem(2), "method",
+                        "Vertex ordering: none, morton (Z-order curve), hilbert (Hilbert curve) or reverseCuthillMcKee"))
+    , d_sortElements(initData(&d_sortElements, true, "sortElements", "Sort the elements by their lowest vertex index"))
+    , d_inputPosition(initData(&d_inputPosition, "inputPosition", "Input vertices"))
+    , d_inputEdges(initData(&d_inputEdges, "inputEdges", "Input edges"))
+    , d_inputTriangles(initData(&d_inputTriangles, "inputTriangles", "Input triangles"))
+    , d_inputQuads(initData(&d_inputQuads, "inputQuads", "Input quads"))
+    , d_inputTetrahedra(initData(&d_inputTetrahedra, "inputTetrahedra", "Input tetrahedra"))
+    , d_inputHexahedra(initData(&d_inputHexahedra, "inputHexahedra", "Input hexahedra"))
+    , d_indices(initData(&d_indices, "indices", "Vertex indices in the input numbering, renumbered in outputIndices"))
+    , d_position(initData(&d_position, "position", "Reordered vertices"))
+    , d_edges(initData(&d_edges, "edges", "Reordered edges"))
+    , d_triangles(initData(&d_triangles, "triangles", "Reordered triangles"))
+    , d_quads(initData(&d_quads, "quads", "Reordered quads"))
+    , d_tetrahedra(initData(&d_tetrahedra, "tetrahedra", "Reordered tetrahedra"))
+    , d_hexahedra(initData(&d_hexahedra, "hexahedra", "Reordered hexahedra"))
+    , d_outputIndices(initData(&d_outputIndices, "outputIndices", "Vertex indices given in indices, in the output numbering"))
+    , d_vertexPermutation(initData(&d_vertexPermutation, "vertexPermutation", "Input index of each output vertex"))
+    , d_inverseVertexPermutation(initData(&d_inverseVertexPermutation, "inverseVertexPermutation", "Output index of each input vertex"))
+    , d_edgePermutation(initData(&d_edgePermutation, "edgePermutation", "Input index of each output edge"))
+    , d_trianglePermutation(initData(&d_trianglePermutation, "trianglePermutation", "Input index of each output triangle"))
+    , d_quadPermutation(initData(&d_quadPermutation, "quadPermutation", "Input index of each output quad"))
+    , d_tetrahedronPermutation(initData(&d_tetrahedronPermutation, "tetrahedronPermutation", "Input index of each output tetrahedron"))
+    , d_hexahedronPermutation(initData(&d_hexahedronPermutation, "hexahedronPermutation", "Input index of each output hexahedron"))
+{
+    addInput(&d_method);
+    addInput(&d_sortElements);
+    addInput(&d_inputPosition);
+    addInput(&d_inputEdges);
+    addInput(&d_inputTriangles);
+    addInput(&d_inputQuads);
+    addInput(&d_inputTetrahedra);
+    addInput(&d_inputHexahedra);
+    addInput(&d_indices);
+
+    addOutput(&d_position);
+    addOutput(&d_edges);
+    addOutput(&d_triangles);
+    addOutput(&d_quads);
+    addOutput(&d_tetrahedra);
+    addOutput(&d_hexahedra);
+    addOutput(&d_outputIndices);
+    addOutput(&d_vertexPermutation);
+    addOutput(&d_inverseVertexPermutation);
+    addOutput(&d_edgePermutation);
+    addOutput(&d_trianglePermutation);
+    addOutput(&d_quadPermutation);
+    addOutput(&d_tetrahedronPermutation);
+    addOutput(&d_hexahedronPermutation);
+}
+
+template <class DataTypes>
+void MeshReorderingEngine<DataTypes>::init()
+{
+    setDirtyValue();
+}
+
+template <class DataTypes>
+void MeshReorderingEngine<DataTypes>::reinit()
+{
+    update();
+}
+
+template <class DataTypes>
+void MeshReorderingEngine<DataTypes>::doUpdate()
+{
+    const helper::ReadAccessor<Data<VecCoord> > inputPosition = d_inputPosition;
+    const Size nbVertices = static_cast<Size>(inputPosition.size());
+
+    auto vertexPermutation = sofa::helper::getWriteOnlyAccessor(d_vertexPermutation);
+    const std::string& method = d_method.getValue().getSelectedItem();
+    if (method == "morton")
+    {
+        computeSpaceFillingCurveOrder(inputPosition.ref(), vertexPermutation.wref(), &computeMortonKey);
+    }
+    else if (method == "hilbert")
+    {
+        computeSpaceFillingCurveOrder(inputPosition.ref(), vertexPermutation.wref(), &computeHilbertKey);
+    }
+    else if (method == "reverseCuthillMcKee")
+    {
+        computeReverseCuthillMcKeeOrder(nbVertices, vertexPermutation.wref());
+    }
+    else
+    {
+        vertexPermutation.resize(nbVertices);
+        std::iota(vertexPermutation.begin(), vertexPermutation.end(), 0);
+    }
+
+    auto inverseVertexPermutation = sofa::helper::getWriteOnlyAccessor(d_inverseVertexPermutation);
+    inverseVertexPermutation.resize(nbVertices);
+    for (Index i = 0; i < nbVertices; ++i)
+    {
+        inverseVertexPermutation[vertexPermutation[i]] = i;
+    }
+
+    auto position = sofa::helper::getWriteOnlyAccessor(d_position);
+    position.resize(nbVertices);
+    for (Index i = 0; i < nbVertices; ++i)
+    {
+        position[i] = inputPosition[vertexPermutation[i]];
+    }
+
+    const bool sortElements = d_sortElements.getValue();
+    reorderElements(d_inputEdges, d_edges, d_edgePermutation, inverseVertexPermutation.ref(), sortElements);
+    reorderElements(d_inputTriangles, d_triangles, d_trianglePermutation, inverseVertexPermutation.ref(), sortElements);
+    reorderElements(d_inputQuads, d_quads, d_quadPermutation, inverseVertexPermutation.ref(), sortElements);
+    reorderElements(d_inputTetrahedra, d_tetrahedra, d_tetrahedronPermutation, inverseVertexPermutation.ref(), sortElements);
+    reorderElements(d_inputHexahedra, d_hexahedra, d_hexahedronPermutation, inverseVertexPermutation.ref(), sortElements);
+
+    const helper::ReadAccessor<Data<VecIndex> > indices = d_indices;
+    auto outputIndices = sofa::helper::getWriteOnlyAccessor(d_outputIndices);
+    outputIndices.clear();
+    outputIndices.reserve(indices.size());
+    for (const Index i : indices)
+    {
+        if (i < nbVertices)
+        {
+            outputIndices.push_back(inverseVertexPermutation[i]);
+        }
+        else
+        {
+            msg_warning() << "Index " << i << " is out of bounds (" << nbVertices << " vertices): it is ignored";
+        }
+    }
+}
+
+template <class DataTypes>
+template <class ComputeKey>
+void MeshReorderingEngine<DataTypes>::computeSpaceFillingCurveOrder(const VecCoord& position, VecIndex& permutation, ComputeKey computeKey) const
+{
+    static constexpr unsigned int dimension = DataTypes::spatial_dimensions;
+    static constexpr unsigned int bitsPerAxis = 63 / dimension;
+
+    permutation.resize(position.size());
+    std::iota(permutation.begin(), permutation.end(), 0);
+    if (position.empty())
+    {
+        return;
+    }
+
+    // the vertices are snapped on a grid of 2^bitsPerAxis cells along the largest side of their bounding box
+    Coord minBBox = position.front();
+    Coord maxBBox = position.front();
+    for (const auto& p : position)
+    {
+        for (unsigned int d = 0; d < dimension; ++d)
+        {
+            minBBox[d] = std::min(minBBox[d], p[d]);
+            maxBBox[d] = std::max(maxBBox[d], p[d]);
+        }
+    }
+    Real extent = 0;
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+        extent = std::max(extent, maxBBox[d] - minBBox[d]);
+    }
+    const double maxCoordinate = static_cast<double>((std::uint64_t(1) << bitsPerAxis) - 1);
+    const double scale = extent > 0 ? maxCoordinate / static_cast<double>(extent) : 0.;
+
+    type::vector<std::uint64_t> keys(position.size());
+    type::vector<std::uint32_t> cell(dimension);
+    for (std::size_t i = 0; i < position.size(); ++i)
+    {
+        for (unsigned int d = 0; d < dimension; ++d)
+        {
+            const double x = std::clamp(static_cast<double>(position[i][d] - minBBox[d]) * scale, 0., maxCoordinate);
+            cell[d] = static_cast<std::uint32_t>(x);
+        }
+        keys[i] = computeKey(cell, bitsPerAxis);
+    }
+
+    std::stable_sort(permutation.begin(), permutation.end(),
+        [&keys](const Index a, const Index b) { return keys[a] < keys[b]; });
+}
+
+template <class DataTypes>
+void MeshReorderingEngine<DataTypes>::computeReverseCuthillMcKeeOrder(const Size nbVertices, VecIndex& permutation) const
+{
+    // two vertices are adjacent if they belong to a same element
+    type::vector<type::vector<Index> > neighbors(nbVertices);
+    const auto addElements = [&neighbors, nbVertices](const auto& elements)
+    {
+        for (const auto& element : elements)
+        {
+            for (const Index a : element)
+            {
+                for (const Index b : element)
+                {
+                    if (a != b && a < nbVertices && b < nbVertices)
+                    {
+                        neighbors[a].push_back(b);
+                    }
+                }
+            }
+        }
+    };
+    addElements(d_inputEdges.getValue());
+    addElements(d_inputTriangles.getValue());
+    addElements(d_inputQuads.getValue());
+    addElements(d_inputTetrahedra.getValue());
+    addElements(d_inputHexahedra.getValue());
+
+    type::vector<Index> adjacencyBegin(nbVertices + 1, 0);
+    type::vector<Index> adjacency;
+    for (Index v = 0; v < nbVertices; ++v)
+    {
+        auto& n = neighbors[v];
+        std::sort(n.begin(), n.end());
+        n.erase(std::unique(n.begin(), n.end()), n.end());
+        adjacency.insert(adjacency.end(), n.begin(), n.end());
+        adjacencyBegin[v + 1] = static_cast<Index>(adjacency.size());
+    }
+
+    computeReverseCuthillMcKeeOrdering(adjacencyBegin, adjacency, permutation);
+}
+
+template <class DataTypes>
+template <class VecElement>
+void MeshReorderingEngine<DataTypes>::reorderElements(const Data<VecElement>& input, Data<VecElement>& output, Data<VecIndex>& permutation,
+                                                     const VecIndex& inverseVertexPermutation, const bool sortElements) const
+{
+    const helper::ReadAccessor<Data<VecElement> > inputElements = input;
+    auto outputElements = sofa::helper::getWriteOnlyAccessor(output);
+    auto elementPermutation = sofa::helper::getWriteOnlyAccessor(permutation);
+
+    const Size nbVertices = static_cast<Size>(inverseVertexPermutation.size());
+
+    VecElement renumbered(inputElements.size());
+    for (std::size_t e = 0; e < inputElements.size(); ++e)
+    {
+        renumbered[e] = inputElements[e];
+        for (auto& v : renumbered[e])
+        {
+            if (v < nbVertices)
+            {
+                v = inverseVertexPermutation[v];
+            }
+            else
+            {
+                msg_error() << "Element " << e << " refers to the vertex " << v << " which does not exist (" << nbVertices << " vertices)";
+            }
+        }
+    }
+
+    elementPermutation.resize(inputElements.size());
+    std::iota(elementPermutation.begin(), elementPermutation.end(), 0);
+    if (sortElements)
+    {
+        type::vector<Index> lowestVertex(renumbered.size());
+        for (std::size_t e = 0; e < renumbered.size(); ++e)
+        {
+            lowestVertex[e] = *std::min_element(renumbered[e].begin(), renumbered[e].end());
+        }
+        std::stable_sort(elementPermutation.begin(), elementPermutation.end(),
+            [&lowestVertex](const Index a, const Index b) { return lowestVertex[a] < lowestVertex[b]; });
+    }
+
+    outputElements.resize(renumbered.size());
+    for (std::size_t e = 0; e < renumbered.size(); ++e)
+    {
+        outputElements[e] = renumbered[elementPermutation[e]];
+    }
+}
+
+} //namespace sofa::component::engine::transform
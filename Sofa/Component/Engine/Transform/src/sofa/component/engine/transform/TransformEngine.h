@@ -55,6 +55,7 @@ protected:
 public:
     void init() override;
     void reinit() override;
+    bool isThreadSafe() const override { return true; }
 
 protected:
     void doUpdate() override;
@@ -0,0 +1,234 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <sofa/component/engine/transform/MeshReorderingEngine.h>
+using sofa::component::engine::transform::MeshReorderingEngine;
+using sofa::component::engine::transform::computeHilbertKey;
+using sofa::component::engine::transform::computeMortonKey;
+
+#include <sofa/core/objectmodel/BaseObject.h>
+using sofa::core::objectmodel::New;
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace sofa
+{
+
+namespace
+{
+
+using Engine = MeshReorderingEngine<defaulttype::Vec3Types>;
+using VecIndex = type::vector<Index>;
+
+/// Cells of a grid of n^3 cells, sorted by their key along a space-filling curve
+template<class ComputeKey>
+type::vector<type::vector<std::uint32_t> > sortCells(const unsigned int bitsPerAxis, ComputeKey computeKey)
+{
+    const std::uint32_t n = 1u << bitsPerAxis;
+    type::vector<type::vector<std::uint32_t> > cells;
+    for (std::uint32_t k = 0; k < n; ++k)
+        for (std::uint32_t j = 0; j < n; ++j)
+            for (std::uint32_t i = 0; i < n; ++i)
+                cells.push_back({i, j, k});
+
+    std::sort(cells.begin(), cells.end(), [&](const auto& a, const auto& b)
+    {
+        return computeKey(a, bitsPerAxis) < computeKey(b, bitsPerAxis);
+    });
+    return cells;
+}
+
+/// Grid of (n+1)^3 vertices and n^3 hexahedra, the vertices and the elements being shuffled
+void makeShuffledGrid(const unsigned int n, Engine::VecCoord& position, Engine::SeqHexahedra& hexahedra)
+{
+    const auto id = [n](unsigned int i, unsigned int j, unsigned int k) { return static_cast<Index>(i + (n + 1) * (j + (n + 1) * k)); };
+
+    position.clear();
+    for (unsigned int k = 0; k <= n; ++k)
+        for (unsigned int j = 0; j <= n; ++j)
+            for (unsigned int i = 0; i <= n; ++i)
+                position.emplace_back(i, j, k);
+
+    hexahedra.clear();
+    for (unsigned int k = 0; k < n; ++k)
+        for (unsigned int j = 0; j < n; ++j)
+            for (unsigned int i = 0; i < n; ++i)
+                hexahedra.emplace_back(
+                    id(i, j, k), id(i + 1, j, k), id(i + 1, j + 1, k), id(i, j + 1, k),
+                    id(i, j, k + 1), id(i + 1, j, k + 1), id(i + 1, j + 1, k + 1), id(i, j + 1, k + 1));
+
+    std::mt19937 generator(0);
+    VecIndex shuffle(position.size());
+    std::iota(shuffle.begin(), shuffle.end(), 0);
+    std::shuffle(shuffle.begin(), shuffle.end(), generator);
+
+    Engine::VecCoord shuffledPosition(position.size());
+    for (std::size_t i = 0; i < position.size(); ++i)
+    {
+        shuffledPosition[shuffle[i]] = position[i];
+    }
+    position = shuffledPosition;
+    for (auto& hexa : hexahedra)
+    {
+        for (auto& v : hexa)
+        {
+            v = shuffle[v];
+        }
+    }
+    std::shuffle(hexahedra.begin(), hexahedra.end(), generator);
+}
+
+/// Largest and mean differences between the indices of two vertices of a same element
+std::pair<Index, double> computeElementSpans(const Engine::SeqHexahedra& hexahedra)
+{
+    Index maxSpan = 0;
+    double meanSpan = 0;
+    for (const auto& hexa : hexahedra)
+    {
+        const auto [minVertex, maxVertex] = std::minmax_element(hexa.begin(), hexa.end());
+        maxSpan = std::max(maxSpan, *maxVertex - *minVertex);
+        meanSpan += static_cast<double>(*maxVertex - *minVertex);
+    }
+    return { maxSpan, meanSpan / static_cast<double>(hexahedra.size()) };
+}
+
+bool isPermutation(VecIndex permutation, const std::size_t size)
+{
+    std::sort(permutation.begin(), permutation.end());
+    VecIndex identity(size);
+    std::iota(identity.begin(), identity.end(), 0);
+    return permutation == identity;
+}
+
+}
+
+TEST(MeshReorderingEngine_test, hilbertCurveIsContinuous)
+{
+    // two consecutive cells along the Hilbert curve are neighbors
+    const auto cells = sortCells(3, [](const auto& x, unsigned int bits) { return computeHilbertKey(x, bits); });
+    for (std::size_t c = 1; c < cells.size(); ++c)
+    {
+        unsigned int distance = 0;
+        for (unsigned int d = 0; d < 3; ++d)
+        {
+            distance += static_cast<unsigned int>(std::abs(static_cast<int>(cells[c][d]) - static_cast<int>(cells[c - 1][d])));
+        }
+        EXPECT_EQ(distance, 1) << "between the cells " << c - 1 << " and " << c;
+    }
+}
+
+TEST(MeshReorderingEngine_test, mortonKeys)
+{
+    const auto cells = sortCells(2, [](const auto& x, unsigned int bits) { return computeMortonKey(x, bits); });
+
+    // the first 8 cells along the Z-order curve form the first octant
+    for (std::size_t c = 0; c < 8; ++c)
+    {
+        for (unsigned int d = 0; d < 3; ++d)
+        {
+            EXPECT_LT(cells[c][d], 2u);
+        }
+    }
+}
+
+TEST(MeshReorderingEngine_test, permutations)
+{
+    Engine::VecCoord position;
+    Engine::SeqHexahedra hexahedra;
+    makeShuffledGrid(6, position, hexahedra);
+
+    for (const std::string method : {"none", "morton", "hilbert", "reverseCuthillMcKee"})
+    {
+        const Engine::SPtr engine = New<Engine>();
+        engine->findData("method")->read(method);
+        engine->d_inputPosition.setValue(position);
+        engine->d_inputHexahedra.setValue(hexahedra);
+        engine->d_indices.setValue({0, 10, 100});
+        engine->init();
+        engine->update();
+
+        const auto& permutation = engine->d_vertexPermutation.getValue();
+        const auto& inverse = engine->d_inverseVertexPermutation.getValue();
+        ASSERT_TRUE(isPermutation(permutation, position.size())) << method;
+        ASSERT_TRUE(isPermutation(inverse, position.size())) << method;
+
+        const auto& outputPosition = engine->d_position.getValue();
+        ASSERT_EQ(outputPosition.size(), position.size());
+        for (Index i = 0; i < position.size(); ++i)
+        {
+            EXPECT_EQ(inverse[permutation[i]], i);
+            EXPECT_EQ(outputPosition[i], position[permutation[i]]);
+        }
+
+        const auto& hexahedronPermutation = engine->d_hexahedronPermutation.getValue();
+        const auto& outputHexahedra = engine->d_hexahedra.getValue();
+        ASSERT_TRUE(isPermutation(hexahedronPermutation, hexahedra.size())) << method;
+        ASSERT_EQ(outputHexahedra.size(), hexahedra.size());
+        Index previousLowestVertex = 0;
+        for (std::size_t e = 0; e < hexahedra.size(); ++e)
+        {
+            for (unsigned int k = 0; k < 8; ++k)
+            {
+                EXPECT_EQ(outputHexahedra[e][k], inverse[hexahedra[hexahedronPermutation[e]][k]]);
+            }
+            const Index lowestVertex = *std::min_element(outputHexahedra[e].begin(), outputHexahedra[e].end());
+            EXPECT_LE(previousLowestVertex, lowestVertex);
+            previousLowestVertex = lowestVertex;
+        }
+
+        EXPECT_EQ(engine->d_outputIndices.getValue(), VecIndex({inverse[0], inverse[10], inverse[100]}));
+    }
+}
+
+TEST(MeshReorderingEngine_test, locality)
+{
+    Engine::VecCoord position;
+    Engine::SeqHexahedra hexahedra;
+    makeShuffledGrid(8, position, hexahedra);
+
+    const auto spans = [&](const std::string& method)
+    {
+        const Engine::SPtr engine = New<Engine>();
+        engine->findData("method")->read(method);
+        engine->d_inputPosition.setValue(position);
+        engine->d_inputHexahedra.setValue(hexahedra);
+        engine->init();
+        engine->update();
+        return computeElementSpans(engine->d_hexahedra.getValue());
+    };
+
+    const auto [shuffledMaxSpan, shuffledMeanSpan] = spans("none");
+
+    // the reverse Cuthill-McKee ordering reduces the bandwidth
+    const auto [rcmMaxSpan, rcmMeanSpan] = spans("reverseCuthillMcKee");
+    EXPECT_LT(rcmMaxSpan, shuffledMaxSpan / 2);
+    EXPECT_LT(rcmMeanSpan, shuffledMeanSpan / 3);
+
+    // the space-filling curves keep most of the elements compact, but not all of them
+    EXPECT_LT(spans("hilbert").second, shuffledMeanSpan / 3);
+    EXPECT_LT(spans("morton").second, shuffledMeanSpan / 3);
+}
+
+}
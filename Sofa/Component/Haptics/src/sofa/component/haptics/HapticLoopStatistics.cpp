@@ -0,0 +1,109 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/haptics/HapticLoopStatistics.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace sofa::component::haptics
+{
+
+HapticLoopStatistics::HapticLoopStatistics(const std::size_t windowSize)
+    : m_windowSize(std::max<std::size_t>(windowSize, 1))
+    , m_solveTimes(std::make_unique<std::atomic<double>[]>(m_windowSize))
+    , m_staleness(std::make_unique<std::atomic<double>[]>(m_windowSize))
+{
+    clear();
+}
+
+void HapticLoopStatistics::addSample(const double solveTime, const double staleness)
+{
+    const std::size_t n = m_nbSamples.load(std::memory_order_relaxed);
+    m_solveTimes[n % m_windowSize].store(solveTime, std::memory_order_relaxed);
+    m_staleness[n % m_windowSize].store(staleness, std::memory_order_relaxed);
+    m_nbSamples.store(n + 1, std::memory_order_release);
+}
+
+void HapticLoopStatistics::addSkippedIteration()
+{
+    m_nbSkippedIterations.fetch_add(1, std::memory_order_relaxed);
+}
+
+HapticLoopStatistics::Percentiles HapticLoopStatistics::getSolveTimePercentiles() const
+{
+    return computePercentiles(m_solveTimes);
+}
+
+HapticLoopStatistics::Percentiles HapticLoopStatistics::getStalenessPercentiles() const
+{
+    return computePercentiles(m_staleness);
+}
+
+std::size_t HapticLoopStatistics::getNbSamples() const
+{
+    return m_nbSamples.load(std::memory_order_acquire);
+}
+
+std::size_t HapticLoopStatistics::getNbSkippedIterations() const
+{
+    return m_nbSkippedIterations.load(std::memory_order_relaxed);
+}
+
+void HapticLoopStatistics::clear()
+{
+    for (std::size_t i = 0; i < m_windowSize; ++i)
+    {
+        m_solveTimes[i].store(0., std::memory_order_relaxed);
+        m_staleness[i].store(0., std::memory_order_relaxed);
+    }
+    m_nbSkippedIterations.store(0, std::memory_order_relaxed);
+    m_nbSamples.store(0, std::memory_order_release);
+}
+
+HapticLoopStatistics::Percentiles HapticLoopStatistics::computePercentiles(
+    const std::unique_ptr<std::atomic<double>[]>& samples) const
+{
+    // the samples are copied: the haptic thread may keep writing while they are sorted
+    const std::size_t nbSamples = std::min(getNbSamples(), m_windowSize);
+    if (nbSamples == 0)
+    {
+        return {};
+    }
+
+    std::vector<double> values(nbSamples);
+    for (std::size_t i = 0; i < nbSamples; ++i)
+    {
+        values[i] = samples[i].load(std::memory_order_relaxed);
+    }
+
+    Percentiles percentiles;
+    const double ranks[3] = { 0.5, 0.9, 0.99 };
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        const auto nth = values.begin() + static_cast<std::ptrdiff_t>(ranks[i] * static_cast<double>(nbSamples - 1));
+        std::nth_element(values.begin(), nth, values.end());
+        percentiles[i] = *nth;
+    }
+    return percentiles;
+}
+
+} // namespace sofa::component::haptics
@@ -0,0 +1,79 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/haptics/config.h>
+
+#include <sofa/type/Vec.h>
+
+#include <atomic>
+#include <memory>
+
+namespace sofa::component::haptics
+{
+
+/**
+ * Timings of the iterations of a haptic loop, kept over a sliding window of iterations.
+ *
+ * Each iteration records the time spent to compute the force, and the staleness of the constraint
+ * problem it used, i.e. the time elapsed since the simulation published it.
+ * The samples are written by the haptic thread without lock, and can be read from any other thread.
+ */
+class SOFA_COMPONENT_HAPTICS_API HapticLoopStatistics
+{
+public:
+    /// Percentiles 50, 90 and 99 of a quantity
+    using Percentiles = sofa::type::Vec3d;
+
+    explicit HapticLoopStatistics(std::size_t windowSize = 1000);
+
+    /// Records an iteration of the haptic loop. Only one thread can add samples.
+    void addSample(double solveTime, double staleness);
+
+    /// Records an iteration of the haptic loop which did not compute the force (the problem was in use)
+    void addSkippedIteration();
+
+    /// Percentiles of the solve time of the last iterations, in seconds
+    Percentiles getSolveTimePercentiles() const;
+
+    /// Percentiles of the staleness of the last iterations, in seconds
+    Percentiles getStalenessPercentiles() const;
+
+    /// Total number of recorded iterations
+    std::size_t getNbSamples() const;
+
+    /// Total number of iterations which did not compute the force
+    std::size_t getNbSkippedIterations() const;
+
+    void clear();
+
+protected:
+    Percentiles computePercentiles(const std::unique_ptr<std::atomic<double>[]>& samples) const;
+
+    std::size_t m_windowSize;
+    std::unique_ptr<std::atomic<double>[]> m_solveTimes;
+    std::unique_ptr<std::atomic<double>[]> m_staleness;
+    std::atomic<std::size_t> m_nbSamples { 0 };
+    std::atomic<std::size_t> m_nbSkippedIterations { 0 };
+};
+
+} // namespace sofa::component::haptics
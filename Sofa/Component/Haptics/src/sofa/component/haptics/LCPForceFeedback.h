@@ -24,7 +24,10 @@
 
 #include <sofa/component/haptics/MechanicalStateForceFeedback.h>
 #include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/component/haptics/HapticLoopStatistics.h>
 #include <sofa/helper/system/thread/CTime.h>
+#include <atomic>
+#include <chrono>
 #include <mutex>
 
 #include <sofa/component/constraint/lagrangian/solver/ConstraintSolverImpl.h>
@@ -34,6 +37,12 @@ namespace sofa::component::haptics
 
 /**
 * LCP force field
+*
+* The constraint problem of the last simulation step is solved in the haptic thread, for the
+* current position of the device.
+* The simulation thread publishes the constraint problems through a triple buffer: it writes a
+* buffer which is not used by the haptic thread, then exchanges it atomically with the published
+* buffer. The haptic thread takes the last published buffer without waiting for the simulation.
 */
 template <class TDataTypes>
 class LCPForceFeedback : public MechanicalStateForceFeedback<TDataTypes>
@@ -72,6 +81,9 @@ public:
     // Enable/disable constraint haptic influence from all frames
     Data< bool > d_localHapticConstraintAllFrames; ///< Flag to enable/disable constraint haptic influence from all frames
 
+    Data< sofa::type::Vec3d > d_solveTimePercentiles; ///< Percentiles 50, 90 and 99 of the time to compute the force in the haptic loop (ms)
+    Data< sofa::type::Vec3d > d_stalenessPercentiles; ///< Percentiles 50, 90 and 99 of the age of the constraint problem used in the haptic loop (ms)
+
     void computeForce(SReal x, SReal y, SReal z,
                       SReal u, SReal v, SReal w,
                       SReal q, SReal& fx, SReal& fy, SReal& fz) override;
@@ -112,6 +124,9 @@ public:
     /// Overide method to lock or unlock the force feedback computation. According to parameter, value == true (resp. false) will lock (resp. unlock) mutex @sa lockForce
     void setLock(bool value) override;
 
+    /// Timings of the last iterations of the haptic loop. Can be read from any thread.
+    const HapticLoopStatistics& getHapticLoopStatistics() const { return m_hapticLoopStatistics; }
+
 protected:
     core::behavior::MechanicalState<DataTypes> *mState; ///< The device try to follow this mechanical state.
     VecCoord mVal[3];
@@ -119,9 +134,19 @@ protected:
     std::vector<int> mId_buf[3];
     component::constraint::lagrangian::solver::ConstraintProblem* mCP[3];
 
-    unsigned char mNextBufferId; // Next buffer id to be use
-    unsigned char mCurBufferId; // Current buffer id in use
-    bool mIsCuBufferInUse; // Is current buffer currently in use right now
+    std::chrono::steady_clock::time_point mPublicationTime[3];
+
+    /// Flag of the published buffer id (mNextBufferId) meaning that it has not been used by the haptic thread yet
+    static constexpr unsigned char NewBufferFlag = 4;
+
+    std::atomic<unsigned char> mNextBufferId; // Last published buffer id, to be used by the haptic thread
+    unsigned char mCurBufferId; // Current buffer id in use by the haptic thread
+    unsigned char mWriteBufferId; // Buffer id written by the simulation thread
+
+    /// Forces of the last iteration, used when the force cannot be computed
+    VecDeriv mLastForces;
+
+    HapticLoopStatistics m_hapticLoopStatistics;
 
     sofa::component::constraint::lagrangian::solver::ConstraintSolverImpl* constraintSolver;
 
@@ -133,6 +158,7 @@ protected:
     unsigned int num_constraints;
 
     /// mutex used in method @doComputeForce which can be touched from outside using method @sa setLock if components are modified in another thread.
+    /// The haptic thread does not wait for it: the forces of the previous iteration are used while it is locked.
     std::mutex lockForce;
 };
 
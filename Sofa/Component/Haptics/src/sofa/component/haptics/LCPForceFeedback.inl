@@ -28,6 +28,7 @@
 #include <sofa/simulation/AnimateEndEvent.h>
 
 #include <algorithm>
+#include <atomic>
 #include <mutex>
 
 namespace
@@ -126,10 +127,12 @@ LCPForceFeedback<DataTypes>::LCPForceFeedback()
     , d_solverMaxIt(initData(&d_solverMaxIt, 100, "solverMaxIt", "max iteration to spend solving constraints"))
     , d_derivRotations(initData(&d_derivRotations, false, "derivRotations", "if true, deriv the rotations when updating the violations"))
     , d_localHapticConstraintAllFrames(initData(&d_localHapticConstraintAllFrames, false, "localHapticConstraintAllFrames", "Flag to enable/disable constraint haptic influence from all frames"))
+    , d_solveTimePercentiles(initData(&d_solveTimePercentiles, "solveTimePercentiles", "Percentiles 50, 90 and 99 of the time to compute the force in the haptic loop (ms)"))
+    , d_stalenessPercentiles(initData(&d_stalenessPercentiles, "stalenessPercentiles", "Percentiles 50, 90 and 99 of the age of the constraint problem used in the haptic loop (ms)"))
     , mState(nullptr)
-    , mNextBufferId(0)
+    , mNextBufferId(1)
     , mCurBufferId(0)
-    , mIsCuBufferInUse(false)
+    , mWriteBufferId(2)
     , constraintSolver(nullptr)
     , _timer(nullptr)
     , time_buf(0)
@@ -138,6 +141,8 @@ LCPForceFeedback<DataTypes>::LCPForceFeedback()
     , num_constraints(0)
 {
     this->f_listening.setValue(true);
+    d_solveTimePercentiles.setReadOnly(true);
+    d_stalenessPercentiles.setReadOnly(true);
     mCP[0] = nullptr;
     mCP[1] = nullptr;
     mCP[2] = nullptr;
@@ -182,7 +187,8 @@ void LCPForceFeedback<DataTypes>::setLock(bool value)
 }
 
 
-static std::mutex s_mtx;
+/// Set while a haptic thread modifies a constraint problem, which can be shared by several LCPForceFeedback
+static std::atomic_flag s_constraintProblemInUse = ATOMIC_FLAG_INIT;
 
 template <class DataTypes>
 void LCPForceFeedback<DataTypes>::computeForce(const VecCoord& state,  VecDeriv& forces)
@@ -193,10 +199,29 @@ void LCPForceFeedback<DataTypes>::computeForce(const VecCoord& state,  VecDeriv&
     }
     updateStats();
 
-    lockForce.lock(); // check if computation has not been locked using setLock method.
+    // check if computation has not been locked using setLock method, without waiting
+    std::unique_lock lock(lockForce, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        forces = mLastForces;
+        forces.resize(state.size());
+        m_hapticLoopStatistics.addSkippedIteration();
+        return;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
     updateConstraintProblem();
     doComputeForce(state, forces);
-    lockForce.unlock();
+    mLastForces = forces;
+
+    if (mCP[mCurBufferId])
+    {
+        const auto endTime = std::chrono::steady_clock::now();
+        m_hapticLoopStatistics.addSample(
+            std::chrono::duration<double>(endTime - startTime).count(),
+            std::chrono::duration<double>(endTime - mPublicationTime[mCurBufferId]).count());
+    }
 }
 template <class DataTypes>
 void LCPForceFeedback<DataTypes>::updateStats()
@@ -219,25 +244,16 @@ bool LCPForceFeedback<DataTypes>::updateConstraintProblem()
     const int prevId = mCurBufferId;
 
     //
-    // Retrieve the last LCP and constraints computed by the Sofa thread.
+    // Retrieve the last LCP and constraints computed by the Sofa thread, if it has not been retrieved yet.
+    // The current buffer is given back in exchange.
     //
-    mIsCuBufferInUse = true;
-
+    if (mNextBufferId.load(std::memory_order_relaxed) & NewBufferFlag)
     {
-        // TODO: Lock and/or memory barrier HERE
-        mCurBufferId = mNextBufferId;
+        const unsigned char nextBufferId = mNextBufferId.exchange(mCurBufferId, std::memory_order_acq_rel);
+        mCurBufferId = nextBufferId & ~NewBufferFlag;
     }
 
-    const bool changed = (prevId != mCurBufferId);
-
-    const sofa::component::constraint::lagrangian::solver::ConstraintProblem* cp = mCP[mCurBufferId];
-
-    if(!cp)
-    {
-        mIsCuBufferInUse = false;
-    }
-
-    return changed;
+    return prevId != mCurBufferId;
 }
 
 template <class DataTypes>
@@ -270,6 +286,15 @@ void LCPForceFeedback<DataTypes>::doComputeForce(const VecCoord& state,  VecDeri
 
         const bool localHapticConstraintAllFrames = d_localHapticConstraintAllFrames.getValue();
 
+        // the constraint problem is used by another haptic thread: the previous forces are kept
+        if (s_constraintProblemInUse.test_and_set(std::memory_order_acquire))
+        {
+            forces = mLastForces;
+            forces.resize(stateSize);
+            m_hapticLoopStatistics.addSkippedIteration();
+            return;
+        }
+
         // Modify Dfree
         MatrixDerivRowConstIterator rowItEnd = constraints.end();
         num_constraints = constraints.size();
@@ -284,8 +309,6 @@ void LCPForceFeedback<DataTypes>::doComputeForce(const VecCoord& state,  VecDeri
             }
         }
 
-        s_mtx.lock();
-
         // Solving constraints
         cp->solveTimed(cp->tolerance * 0.001, d_solverMaxIt.getValue(), solverTimeout.getValue());	// d_tol, maxIt, timeout
 
@@ -300,7 +323,7 @@ void LCPForceFeedback<DataTypes>::doComputeForce(const VecCoord& state,  VecDeri
             }
         }
 
-        s_mtx.unlock();
+        s_constraintProblemInUse.clear(std::memory_order_release);
 
         VecDeriv tempForces;
         tempForces.resize(val.size());
@@ -343,18 +366,9 @@ void LCPForceFeedback<DataTypes>::handleEvent(sofa::core::objectmodel::Event *ev
     if (!new_cp)
         return;
 
-    // Find available buffer
+    // The buffer which is neither used by the haptic thread nor published
 
-    unsigned char buf_index=0;
-    const unsigned char cbuf_index=mCurBufferId;
-    const unsigned char nbuf_index=mNextBufferId;
-
-    if (buf_index == cbuf_index || buf_index == nbuf_index)
-    {
-        buf_index++;
-        if (buf_index == cbuf_index || buf_index == nbuf_index)
-            buf_index++;
-    }
+    const unsigned char buf_index = mWriteBufferId;
 
     // Compute constraints, id_buf lcp and val for the current lcp.
 
@@ -385,18 +399,25 @@ void LCPForceFeedback<DataTypes>::handleEvent(sofa::core::objectmodel::Event *ev
     // make sure the MatrixDeriv has been compressed
     constraints.compress();
 
-    // valid buffer
+    // publish the buffer: the previously published buffer, if the haptic thread did not take it, will be written next time
 
-    {
-        // TODO: Lock and/or memory barrier HERE
-        mNextBufferId = buf_index;
-    }
+    mPublicationTime[buf_index] = std::chrono::steady_clock::now();
+    const unsigned char prevBufferId = mNextBufferId.exchange(buf_index | NewBufferFlag, std::memory_order_acq_rel);
+    mWriteBufferId = prevBufferId & ~NewBufferFlag;
 
-    // Lock lcp to prevent its use by the SOFA thread while it is used by haptic thread
-    if(mIsCuBufferInUse)
-        constraintSolver->lockConstraintProblem(this, mCP[mCurBufferId], mCP[mNextBufferId]);
+    // Lock lcp to prevent its use by the SOFA thread while it is used by haptic thread.
+    // The haptic thread may use the published buffer, or the remaining one.
+    const unsigned char usedBufferId = 3 - buf_index - mWriteBufferId;
+    if(mCP[usedBufferId])
+        constraintSolver->lockConstraintProblem(this, mCP[usedBufferId], mCP[buf_index]);
     else
-        constraintSolver->lockConstraintProblem(this, mCP[mNextBufferId]);
+        constraintSolver->lockConstraintProblem(this, mCP[buf_index]);
+
+    if (m_hapticLoopStatistics.getNbSamples() > 0)
+    {
+        d_solveTimePercentiles.setValue(m_hapticLoopStatistics.getSolveTimePercentiles() * 1000.);
+        d_stalenessPercentiles.setValue(m_hapticLoopStatistics.getStalenessPercentiles() * 1000.);
+    }
 }
 
 
@@ -0,0 +1,204 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/haptics/SimulatedHapticDevice.h>
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/simulation/AnimateEndEvent.h>
+
+#include <chrono>
+#include <cmath>
+
+namespace sofa::component::haptics
+{
+
+SimulatedHapticDevice::SimulatedHapticDevice()
+    : d_frequency(initData(&d_frequency, 1000., "frequency", "Frequency of the haptic loop (Hz)"))
+    , d_position(initData(&d_position, "position", "Center position of the tool"))
+    , d_amplitude(initData(&d_amplitude, type::Vec3(), "amplitude", "Amplitude of the oscillations of the tool around its center position"))
+    , d_period(initData(&d_period, 1., "period", "Period of the oscillations of the tool (s)"))
+    , d_startAtInit(initData(&d_startAtInit, true, "startAtInit", "Start the haptic loop once the scene is initialized"))
+    , d_nbIterations(initData(&d_nbIterations, 0u, "nbIterations", "Number of iterations of the haptic loop"))
+    , d_measuredFrequency(initData(&d_measuredFrequency, 0., "measuredFrequency", "Frequency of the haptic loop measured between the two last simulation steps (Hz)"))
+    , d_force(initData(&d_force, "force", "Force computed at the last iteration of the haptic loop"))
+    , l_forceFeedback(initLink("forceFeedback", "Force feedback computing the wrench applied on the tool"))
+{
+    this->f_listening.setValue(true);
+    d_nbIterations.setReadOnly(true);
+    d_measuredFrequency.setReadOnly(true);
+    d_force.setReadOnly(true);
+
+    for (auto& f : m_force)
+    {
+        f.store(0);
+    }
+}
+
+SimulatedHapticDevice::~SimulatedHapticDevice()
+{
+    stop();
+}
+
+void SimulatedHapticDevice::init()
+{
+    BaseController::init();
+
+    if (!l_forceFeedback)
+    {
+        l_forceFeedback.set(this->getContext()->get<ForceFeedback>(core::objectmodel::BaseContext::SearchDown));
+    }
+
+    if (!l_forceFeedback)
+    {
+        msg_error() << "No ForceFeedback found. Set the link '" << l_forceFeedback.getName() << "'.";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    if (d_frequency.getValue() <= 0)
+    {
+        msg_error() << "The frequency must be positive.";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    this->d_componentState.setValue(core::objectmodel::ComponentState::Valid);
+}
+
+void SimulatedHapticDevice::bwdInit()
+{
+    // the force feedback may be initialized after this component: the haptic loop
+    // calls it only once the whole scene is initialized
+    if (d_startAtInit.getValue())
+    {
+        start();
+    }
+}
+
+void SimulatedHapticDevice::cleanup()
+{
+    stop();
+    BaseController::cleanup();
+}
+
+void SimulatedHapticDevice::start()
+{
+    if (!this->isComponentStateValid() || isRunning())
+    {
+        return;
+    }
+
+    m_position = d_position.getValue();
+    m_amplitude = d_amplitude.getValue();
+    m_period = d_period.getValue();
+    m_frequency = d_frequency.getValue();
+
+    m_nbIterationsAtLastStep = m_nbIterations.load();
+    m_lastStepTime = std::chrono::steady_clock::now();
+
+    m_running = true;
+    m_thread = std::thread(&SimulatedHapticDevice::hapticLoop, this);
+}
+
+void SimulatedHapticDevice::stop()
+{
+    m_running = false;
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+bool SimulatedHapticDevice::isRunning() const
+{
+    return m_running.load();
+}
+
+SimulatedHapticDevice::Coord SimulatedHapticDevice::getToolPosition(const double time) const
+{
+    Coord position = m_position;
+    if (m_period > 0)
+    {
+        position.getCenter() += m_amplitude * std::sin(2 * M_PI * time / m_period);
+    }
+    return position;
+}
+
+void SimulatedHapticDevice::step(const double time)
+{
+    const Coord position = getToolPosition(time);
+    const type::Transform<SReal> world_H_tool(position.getCenter(), position.getOrientation());
+
+    type::SpatialVector<SReal> velocity;
+    velocity.clear();
+    type::SpatialVector<SReal> wrench;
+    wrench.clear();
+
+    l_forceFeedback->computeWrench(world_H_tool, velocity, wrench);
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        m_force[i].store(wrench.getForce()[i], std::memory_order_relaxed);
+    }
+    m_nbIterations.fetch_add(1, std::memory_order_release);
+}
+
+void SimulatedHapticDevice::hapticLoop()
+{
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1. / m_frequency));
+
+    const auto startTime = std::chrono::steady_clock::now();
+    auto nextIterationTime = startTime;
+
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        step(std::chrono::duration<double>(nextIterationTime - startTime).count());
+
+        // the iterations are not delayed by a late one
+        nextIterationTime += period;
+        std::this_thread::sleep_until(nextIterationTime);
+    }
+}
+
+void SimulatedHapticDevice::handleEvent(core::objectmodel::Event* event)
+{
+    if (!simulation::AnimateEndEvent::checkEventType(event))
+        return;
+
+    const unsigned int nbIterations = m_nbIterations.load(std::memory_order_acquire);
+    const auto now = std::chrono::steady_clock::now();
+
+    const double elapsed = std::chrono::duration<double>(now - m_lastStepTime).count();
+    if (elapsed > 0)
+    {
+        d_measuredFrequency.setValue((nbIterations - m_nbIterationsAtLastStep) / elapsed);
+    }
+    m_nbIterationsAtLastStep = nbIterations;
+    m_lastStepTime = now;
+
+    d_nbIterations.setValue(nbIterations);
+    d_force.setValue(type::Vec3(m_force[0].load(), m_force[1].load(), m_force[2].load()));
+}
+
+int SimulatedHapticDeviceClass = core::RegisterObject("Haptic device without hardware, running a haptic loop at a fixed frequency in its own thread")
+        .add< SimulatedHapticDevice >();
+
+} // namespace sofa::component::haptics
@@ -0,0 +1,103 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/haptics/config.h>
+
+#include <sofa/component/haptics/ForceFeedback.h>
+#include <sofa/core/behavior/BaseController.h>
+#include <sofa/defaulttype/RigidTypes.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace sofa::component::haptics
+{
+
+/**
+ * Haptic device without hardware, running a haptic loop at a fixed frequency in its own thread.
+ *
+ * At each iteration, the tool moves on a sinusoidal trajectory around a center position, and
+ * its wrench is computed by a ForceFeedback component, as a device driver would do.
+ * It allows to run, test and measure a haptic loop headless.
+ */
+class SOFA_COMPONENT_HAPTICS_API SimulatedHapticDevice : public core::behavior::BaseController
+{
+public:
+    SOFA_CLASS(SimulatedHapticDevice, core::behavior::BaseController);
+
+    using Coord = defaulttype::Rigid3Types::Coord;
+
+    Data<double> d_frequency; ///< Frequency of the haptic loop (Hz)
+    Data<Coord> d_position; ///< Center position of the tool
+    Data<type::Vec3> d_amplitude; ///< Amplitude of the oscillations of the tool around its center position
+    Data<double> d_period; ///< Period of the oscillations of the tool (s)
+    Data<bool> d_startAtInit; ///< Start the haptic loop once the scene is initialized
+    Data<unsigned int> d_nbIterations; ///< Number of iterations of the haptic loop
+    Data<double> d_measuredFrequency; ///< Frequency of the haptic loop measured between the two last simulation steps (Hz)
+    Data<type::Vec3> d_force; ///< Force computed at the last iteration of the haptic loop
+
+    SingleLink<SimulatedHapticDevice, ForceFeedback, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_forceFeedback;
+
+    void init() override;
+    void bwdInit() override;
+    void cleanup() override;
+    void handleEvent(core::objectmodel::Event* event) override;
+
+    /// Starts the haptic loop in its own thread
+    void start();
+
+    /// Stops the haptic loop and waits for its thread to finish
+    void stop();
+
+    bool isRunning() const;
+
+    /// Computes an iteration of the haptic loop in the calling thread, at the given time (s) of the trajectory
+    void step(double time);
+
+    /// Position of the tool at the given time (s)
+    Coord getToolPosition(double time) const;
+
+protected:
+    SimulatedHapticDevice();
+    ~SimulatedHapticDevice() override;
+
+    void hapticLoop();
+
+    /// Copy of the parameters used by the haptic thread, updated when the loop starts
+    Coord m_position;
+    type::Vec3 m_amplitude;
+    double m_period { 1. };
+    double m_frequency { 1000. };
+
+    std::thread m_thread;
+    std::atomic<bool> m_running { false };
+    std::atomic<unsigned int> m_nbIterations { 0 };
+    std::array<std::atomic<SReal>, 3> m_force;
+
+    unsigned int m_nbIterationsAtLastStep { 0 };
+    std::chrono::steady_clock::time_point m_lastStepTime;
+};
+
+} // namespace sofa::component::haptics
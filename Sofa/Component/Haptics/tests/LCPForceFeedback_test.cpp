@@ -26,6 +26,7 @@
 
 #include <sofa/component/statecontainer/MechanicalObject.h>
 #include <sofa/component/haptics/LCPForceFeedback.h>
+#include <sofa/component/haptics/SimulatedHapticDevice.h>
 #include <thread>
 #include <sofa/simulation/Node.h>
 
@@ -57,6 +58,8 @@ public:
 
     bool test_multiThread();
 
+    bool test_simulatedDevice();
+
     /// General Haptic thread methods
     static void HapticsThread(std::atomic<bool>& terminate, void * p_this);
 
@@ -397,6 +400,61 @@ bool LCPForceFeedback_test::test_multiThread()
 }
 
 
+bool LCPForceFeedback_test::test_simulatedDevice()
+{
+    loadTestScene("ToolvsFloorCollision_test.scn");
+
+    const simulation::Node::SPtr instruNode = m_root->getChild("Instrument");
+    EXPECT_NE(instruNode, nullptr);
+    m_LCPFFBack = instruNode->get<LCPRig>(instruNode->SearchDown);
+    EXPECT_NE(m_LCPFFBack, nullptr);
+
+    // Force only 2 iteration max for ci tests
+    m_LCPFFBack->d_solverMaxIt.setValue(2);
+
+    // the tool goes through the floor
+    const auto device = sofa::core::objectmodel::New<sofa::component::haptics::SimulatedHapticDevice>();
+    device->d_position.setValue(Coord(sofa::type::Vec3(0, -10, 0), sofa::type::Quat<SReal>(0, 0, 0, 1)));
+    device->d_amplitude.setValue(sofa::type::Vec3(0, 0.5, 0));
+    device->d_period.setValue(0.1);
+    device->l_forceFeedback.set(m_LCPFFBack.get());
+    instruNode->addObject(device);
+    device->init();
+    EXPECT_FALSE(device->isRunning()); // the force feedback may not be initialized yet
+    device->bwdInit();
+    EXPECT_TRUE(device->isRunning());
+
+    for (int step = 0; step < 300; step++)
+    {
+        sofa::simulation::node::animate(m_root.get());
+        CTime::sleep(0.001);
+    }
+
+    device->stop();
+    EXPECT_FALSE(device->isRunning());
+
+    // get back info from haptic thread
+    sofa::simulation::node::animate(m_root.get());
+    EXPECT_GT(device->d_nbIterations.getValue(), 300);
+    EXPECT_GT(device->d_measuredFrequency.getValue(), 0.);
+
+    const auto& statistics = m_LCPFFBack->getHapticLoopStatistics();
+    EXPECT_GT(statistics.getNbSamples(), 0);
+
+    const auto solveTime = statistics.getSolveTimePercentiles();
+    EXPECT_GT(solveTime[2], 0.);
+    EXPECT_LE(solveTime[0], solveTime[1]);
+    EXPECT_LE(solveTime[1], solveTime[2]);
+
+    const auto staleness = statistics.getStalenessPercentiles();
+    EXPECT_GT(staleness[0], 0.);
+    EXPECT_LE(staleness[0], staleness[2]);
+
+    EXPECT_GT(m_LCPFFBack->d_solveTimePercentiles.getValue()[2], 0.);
+
+    return true;
+}
+
 
 TEST_F(LCPForceFeedback_test, test_InitScene)
 {
@@ -418,5 +476,10 @@ TEST_F(LCPForceFeedback_test, test_multiThread)
     ASSERT_TRUE(test_multiThread());
 }
 
+TEST_F(LCPForceFeedback_test, test_simulatedDevice)
+{
+    ASSERT_TRUE(test_simulatedDevice());
+}
+
 
 } // namespace sofa
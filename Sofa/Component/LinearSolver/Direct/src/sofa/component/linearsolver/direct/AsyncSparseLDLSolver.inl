@@ -32,6 +32,14 @@ template <class TMatrix, class TVector, class TThreadManager>
 void AsyncSparseLDLSolver<TMatrix, TVector, TThreadManager>::init()
 {
     Inherit1::init();
+
+    if (this->d_mixedPrecision.getValue())
+    {
+        msg_warning() << "Mixed precision is not supported with an asynchronous factorization. "
+                         "The factorization is done in the precision of the matrix.";
+        this->d_mixedPrecision.setValue(false);
+    }
+
     waitForAsyncTask = true;
     m_asyncThreadInvertData = &m_secondInvertData;
     m_mainThreadInvertData = static_cast<InvertData*>(this->invertData.get());
@@ -0,0 +1,159 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/direct/config.h>
+#include <sofa/component/linearsolver/iterative/MatrixLinearSolver.h>
+#include <sofa/component/linearsolver/ordering/OrderingMethodAccessor.h>
+#include <sofa/component/linearsolver/direct/EigenSolverFactory.h>
+#include <Eigen/SparseCore>
+#include <Eigen/Dense>
+
+namespace sofa::component::linearsolver::direct
+{
+
+/**
+ * Direct linear solver based on a non-overlapping domain decomposition.
+ *
+ * The rows of the assembled matrix are partitioned into subdomains. The rows coupled
+ * with another subdomain form the interface, the other rows are the interiors of
+ * the subdomains. The interiors are independent: they are factorized and solved in
+ * parallel with a sparse LDL^T factorization, using the permutation of the linked
+ * ordering method. The interface unknowns are solved first, with a dense
+ * factorization of the Schur complement
+ *
+ *   S = A_GG - sum_k A_Gk A_kk^-1 A_kG
+ *
+ * then the interior unknowns are recovered independently in each subdomain.
+ *
+ * The partition is kept as long as the sparsity pattern of the matrix does not change.
+ * The matrix is expected to be symmetric.
+ */
+template<class TBlockType>
+class DomainDecompositionSolver
+    : public ordering::OrderingMethodAccessor<
+        sofa::component::linearsolver::MatrixLinearSolver<
+            sofa::linearalgebra::CompressedRowSparseMatrix<TBlockType>,
+            sofa::linearalgebra::FullVector<typename sofa::linearalgebra::CompressedRowSparseMatrix<TBlockType>::Real>
+        >
+    >
+{
+public:
+    using Matrix = sofa::linearalgebra::CompressedRowSparseMatrix<TBlockType>;
+    using Real = typename Matrix::Real;
+    using Vector = sofa::linearalgebra::FullVector<Real>;
+
+    SOFA_CLASS(SOFA_TEMPLATE(DomainDecompositionSolver, TBlockType),
+        SOFA_TEMPLATE(ordering::OrderingMethodAccessor, SOFA_TEMPLATE2(sofa::component::linearsolver::MatrixLinearSolver, Matrix, Vector)));
+
+    void init() override;
+    void reinit() override;
+
+    void solve (Matrix& A, Vector& x, Vector& b) override;
+    void invert(Matrix& A) override;
+
+    Data<unsigned int> d_nbSubdomains; ///< Number of subdomains. If 0, the number of threads of the task scheduler is used
+    Data<bool> d_parallelSubdomains; ///< If true, the subdomains are factorized and solved in parallel
+    Data<unsigned int> d_interfaceSize; ///< Number of rows in the interface between the subdomains, computed with the last partition
+    Data<unsigned int> d_nbPartitions; ///< Number of times the matrix has been partitioned, i.e. the number of sparsity pattern changes
+
+protected:
+
+    DomainDecompositionSolver();
+
+    using EigenSparseMatrixMap = BaseEigenSolverProxy::EigenSparseMatrixMap<Real>;
+    using EigenVectorXdMap = BaseEigenSolverProxy::EigenVectorXdMap<Real>;
+    using DenseMatrix = Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic>;
+    using DenseVector = Eigen::Matrix<Real, Eigen::Dynamic, 1>;
+
+    /// Interior of a subdomain, and its coupling with the interface
+    struct Subdomain
+    {
+        /// Global indices of the interior rows, in increasing order
+        sofa::type::vector<int> rows;
+        /// Global interface indices coupled with the interior
+        sofa::type::vector<int> interface;
+
+        /// Interior block A_kk in CSR format
+        sofa::type::vector<int> interiorRowBegin;
+        sofa::type::vector<int> interiorColsIndex;
+        sofa::type::vector<Real> interiorValues;
+        /// Position in the filtered matrix of each value of the interior block
+        sofa::type::vector<int> interiorValueIndex;
+
+        /// Coupling block A_kG in CSR format, the columns being local interface indices
+        sofa::type::vector<int> couplingRowBegin;
+        sofa::type::vector<int> couplingColsIndex;
+        sofa::type::vector<Real> couplingValues;
+        /// Position in the filtered matrix of each value of the coupling block
+        sofa::type::vector<int> couplingValueIndex;
+
+        std::unique_ptr<BaseEigenSolverProxy> solver;
+
+        /// Contribution A_Gk A_kk^-1 A_kG to the Schur complement, on the local interface
+        DenseMatrix schurContribution;
+
+        /// Work vectors of the size of the interior
+        DenseVector rhs;
+        DenseVector solution;
+        /// Work vector of the size of the local interface
+        DenseVector interfaceRhs;
+    };
+
+    void updateSolverOrderingMethod();
+
+    /// Partition the filtered matrix and build the subdomains from its pattern
+    void buildSubdomains();
+    /// Copy the values of the filtered matrix into the interior and coupling blocks
+    void updateSubdomainValues(Subdomain& subdomain) const;
+    /// Factorize the interior block and compute its contribution to the Schur complement
+    void factorizeSubdomain(Subdomain& subdomain, bool analyzePattern);
+    /// solution = A_kk^-1 rhs
+    void solveInterior(Subdomain& subdomain) const;
+
+    unsigned int getNbSubdomains() const;
+
+    std::string m_selectedOrderingMethod;
+
+    sofa::linearalgebra::CompressedRowSparseMatrix<Real> Mfiltered;
+    typename sofa::linearalgebra::CompressedRowSparseMatrix<Real>::VecIndex MfilteredrowBegin;
+    typename sofa::linearalgebra::CompressedRowSparseMatrix<Real>::VecIndex MfilteredcolsIndex;
+    unsigned int m_partitionedNbSubdomains { 0 };
+
+    sofa::type::vector<Subdomain> m_subdomains;
+
+    /// Global indices of the interface rows
+    sofa::type::vector<int> m_interfaceRows;
+    /// Entries of A_GG: position in the filtered matrix, and row and column in the interface
+    sofa::type::vector<std::tuple<int, int, int> > m_interfaceEntries;
+
+    DenseMatrix m_schurComplement;
+    Eigen::LDLT<DenseMatrix> m_schurFactorization;
+    DenseVector m_interfaceRhs;
+    DenseVector m_interfaceSolution;
+};
+
+#ifndef SOFA_COMPONENT_LINEARSOLVER_DIRECT_DOMAINDECOMPOSITIONSOLVER_CPP
+    extern template class SOFA_COMPONENT_LINEARSOLVER_DIRECT_API DomainDecompositionSolver< SReal >;
+    extern template class SOFA_COMPONENT_LINEARSOLVER_DIRECT_API DomainDecompositionSolver< sofa::type::Mat<3,3,SReal> >;
+#endif
+
+}
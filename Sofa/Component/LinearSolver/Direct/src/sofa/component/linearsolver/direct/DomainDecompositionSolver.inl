@@ -0,0 +1,495 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/direct/DomainDecompositionSolver.h>
+#include <sofa/component/linearsolver/ordering/GraphPartitioning.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+
+namespace sofa::component::linearsolver::direct
+{
+
+template <class TBlockType>
+DomainDecompositionSolver<TBlockType>::DomainDecompositionSolver()
+    : d_nbSubdomains(initData(&d_nbSubdomains, 0u, "nbSubdomains", "Number of subdomains. If 0, the number of threads of the task scheduler is used"))
+    , d_parallelSubdomains(initData(&d_parallelSubdomains, true, "parallelSubdomains", "If true, the subdomains are factorized and solved in parallel"))
+    , d_interfaceSize(initData(&d_interfaceSize, 0u, "interfaceSize", "Number of rows in the interface between the subdomains, computed with the last partition", true, true))
+    , d_nbPartitions(initData(&d_nbPartitions, 0u, "nbPartitions", "Number of times the matrix has been partitioned, i.e. the number of sparsity pattern changes", true, true))
+{}
+
+template <class TBlockType>
+void DomainDecompositionSolver<TBlockType>::init()
+{
+    Inherit1::init();
+
+    // the subdomains are processed by the task scheduler, and their default number is its number of threads
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+        msg_info() << "Task scheduler initialized on " << taskScheduler->getThreadCount() << " threads";
+    }
+
+    updateSolverOrderingMethod();
+}
+
+template <class TBlockType>
+void DomainDecompositionSolver<TBlockType>::reinit()
+{
+    updateSolverOrderingMethod();
+}
+
+template <class TBlockType>
+void DomainDecompositionSolver<TBlockType>::updateSolverOrderingMethod()
+{
+    if (!this->l_orderingMethod)
+    {
+        msg_fatal() << "OrderingMethod missing.";
+        this->d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    if (m_selectedOrderingMethod != this->l_orderingMethod->methodName())
+    {
+        m_selectedOrderingMethod = this->l_orderingMethod->methodName();
+
+        if (!MainSimplicialLDLTFactory::template hasSolver<Real>(m_selectedOrderingMethod))
+        {
+            msg_error() << "This solver does not support the ordering method called '"
+                << m_selectedOrderingMethod << "' found in the component "
+                << this->l_orderingMethod->getPathName() << ".";
+            this->d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+            return;
+        }
+
+        // the subdomain solvers are created again with the new ordering method
+        MfilteredrowBegin.clear();
+        MfilteredcolsIndex.clear();
+    }
+}
+
+template <class TBlockType>
+unsigned int DomainDecompositionSolver<TBlockType>::getNbSubdomains() const
+{
+    if (const unsigned int nbSubdomains = d_nbSubdomains.getValue())
+    {
+        return nbSubdomains;
+    }
+
+    const simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+    return std::max(1u, taskScheduler->getThreadCount());
+}
+
+template <class TBlockType>
+void DomainDecompositionSolver<TBlockType>::buildSubdomains()
+{
+    const int n = static_cast<int>(Mfiltered.rowSize());
+    const auto& rowBegin = Mfiltered.rowBegin;
+    const auto& colsIndex = Mfiltered.colsIndex;
+
+    const unsigned int nbSubdomains = getNbSubdomains();
+
+    sofa::type::vector<int> part;
+    {
+        SCOPED_TIMER_VARNAME(partitionTimer, "partition");
+
+        core::behavior::BaseOrderingMethod::SparseMatrixPattern pattern;
+        pattern.matrixSize = n;
+        pattern.numberOfNonZeros = static_cast<int>(colsIndex.size());
+        pattern.rowBegin = (int*)rowBegin.data();
+        pattern.colsIndex = (int*)colsIndex.data();
+
+        ordering::partitionGraph(pattern, nbSubdomains, part);
+    }
+
+    // An edge between two subdomains puts one of its vertices in the interface,
+    // so that the interiors are not coupled with each other
+    sofa::type::vector<bool> isInterface(n, false);
+    for (int i = 0; i < n; ++i)
+    {
+        for (int k = rowBegin[i]; k < rowBegin[i + 1]; ++k)
+        {
+            const int j = colsIndex[k];
+            if (part[i] != part[j])
+            {
+                isInterface[part[i] > part[j] ? i : j] = true;
+            }
+        }
+    }
+
+    m_subdomains.clear();
+    m_subdomains.resize(nbSubdomains);
+    m_interfaceRows.clear();
+
+    // index of each row in the interface or in the interior of its subdomain
+    sofa::type::vector<int> localIndex(n);
+    for (int i = 0; i < n; ++i)
+    {
+        auto& rows = isInterface[i] ? m_interfaceRows : m_subdomains[part[i]].rows;
+        localIndex[i] = static_cast<int>(rows.size());
+        rows.push_back(i);
+    }
+
+    sofa::type::vector<int> localInterfaceIndex(m_interfaceRows.size(), -1);
+    for (auto& subdomain : m_subdomains)
+    {
+        subdomain.interiorRowBegin.assign(1, 0);
+        subdomain.interiorColsIndex.clear();
+        subdomain.interiorValueIndex.clear();
+        subdomain.couplingRowBegin.assign(1, 0);
+        subdomain.couplingColsIndex.clear();
+        subdomain.couplingValueIndex.clear();
+
+        for (const int i : subdomain.rows)
+        {
+            for (int k = rowBegin[i]; k < rowBegin[i + 1]; ++k)
+            {
+                const int j = colsIndex[k];
+                if (!isInterface[j])
+                {
+                    subdomain.interiorColsIndex.push_back(localIndex[j]);
+                    subdomain.interiorValueIndex.push_back(k);
+                }
+                else
+                {
+                    int& local = localInterfaceIndex[localIndex[j]];
+                    if (local < 0)
+                    {
+                        local = static_cast<int>(subdomain.interface.size());
+                        subdomain.interface.push_back(localIndex[j]);
+                    }
+                    subdomain.couplingColsIndex.push_back(local);
+                    subdomain.couplingValueIndex.push_back(k);
+                }
+            }
+            subdomain.interiorRowBegin.push_back(static_cast<int>(subdomain.interiorColsIndex.size()));
+            subdomain.couplingRowBegin.push_back(static_cast<int>(subdomain.couplingColsIndex.size()));
+        }
+
+        for (const int g : subdomain.interface)
+        {
+            localInterfaceIndex[g] = -1;
+        }
+
+        subdomain.interiorValues.resize(subdomain.interiorValueIndex.size());
+        subdomain.couplingValues.resize(subdomain.couplingValueIndex.size());
+        subdomain.rhs.resize(subdomain.rows.size());
+        subdomain.solution.resize(subdomain.rows.size());
+        subdomain.interfaceRhs.resize(subdomain.interface.size());
+        subdomain.solver = std::unique_ptr<BaseEigenSolverProxy>(MainSimplicialLDLTFactory::template getSolver<Real>(m_selectedOrderingMethod));
+    }
+
+    m_interfaceEntries.clear();
+    for (std::size_t g = 0; g < m_interfaceRows.size(); ++g)
+    {
+        const int i = m_interfaceRows[g];
+        for (int k = rowBegin[i]; k < rowBegin[i + 1]; ++k)
+        {
+            const int j = colsIndex[k];
+            if (isInterface[j])
+            {
+                m_interfaceEntries.emplace_back(k, static_cast<int>(g), localIndex[j]);
+            }
+        }
+    }
+
+    m_partitionedNbSubdomains = nbSubdomains;
+    d_interfaceSize.setValue(static_cast<unsigned int>(m_interfaceRows.size()));
+    d_nbPartitions.setValue(d_nbPartitions.getValue() + 1);
+
+    msg_info() << "Matrix of size " << n << " partitioned into " << nbSubdomains
+               << " subdomains with an interface of size " << m_interfaceRows.size();
+}
+
+template <class TBlockType>
+void DomainDecompositionSolver<TBlockType>::updateSubdomainValues(Subdomain& subdomain) const
+{
+    const auto& values = Mfiltered.colsValue;
+    for (std::size_t k = 0; k < subdomain.interiorValueIndex.size(); ++k)
+    {
+        subdomain.interiorValues[k] = values[subdomain.interiorValueIndex[k]];
+    }
+    for (std::size_t k = 0; k < subdomain.couplingValueIndex.size(); ++k)
+    {
+        subdomain.couplingValues[k] = values[subdomain.couplingValueIndex[k]];
+    }
+}
+
+template <class TBlockType>
+void DomainDecompositionSolver<TBlockType>::factorizeSubdomain(Subdomain& subdomain, bool analyzePattern)
+{
+    const auto n = static_cast<Eigen::Index>(subdomain.rows.size());
+    const auto m = static_cast<Eigen::Index>(subdomain.interface.size());
+
+    subdomain.schurContribution.setZero(m, m);
+    if (n == 0)
+    {
+        return;
+    }
+
+    const EigenSparseMatrixMap interior(n, n, static_cast<Eigen::Index>(subdomain.interiorValues.size()),
+        subdomain.interiorRowBegin.data(), subdomain.interiorColsIndex.data(), subdomain.interiorValues.data());
+
+    if (analyzePattern)
+    {
+        subdomain.solver->analyzePattern(interior);
+    }
+    subdomain.solver->factorize(interior);
+
+    if (subdomain.solver->info() != Eigen::ComputationInfo::Success)
+    {
+        return;
+    }
+
+    // Column c of the contribution is A_Gk A_kk^-1 (column c of A_kG)
+    sofa::type::vector<sofa::type::vector<std::pair<int, Real> > > couplingColumns(m);
+    for (Eigen::Index i = 0; i < n; ++i)
+    {
+        for (int k = subdomain.couplingRowBegin[i]; k < subdomain.couplingRowBegin[i + 1]; ++k)
+        {
+            couplingColumns[subdomain.couplingColsIndex[k]].emplace_back(static_cast<int>(i), subdomain.couplingValues[k]);
+        }
+    }
+
+    for (Eigen::Index c = 0; c < m; ++c)
+    {
+        subdomain.rhs.setZero();
+        for (const auto& [row, value] : couplingColumns[c])
+        {
+            subdomain.rhs[row] = value;
+        }
+
+        solveInterior(subdomain);
+
+        for (Eigen::Index i = 0; i < n; ++i)
+        {
+            for (int k = subdomain.couplingRowBegin[i]; k < subdomain.couplingRowBegin[i + 1]; ++k)
+            {
+                subdomain.schurContribution(subdomain.couplingColsIndex[k], c) += subdomain.couplingValues[k] * subdomain.solution[i];
+            }
+        }
+    }
+}
+
+template <class TBlockType>
+void DomainDecompositionSolver<TBlockType>::solveInterior(Subdomain& subdomain) const
+{
+    const auto n = static_cast<Eigen::Index>(subdomain.rows.size());
+    const EigenVectorXdMap rhs(subdomain.rhs.data(), n);
+    EigenVectorXdMap solution(subdomain.solution.data(), n);
+    subdomain.solver->solve(rhs, solution);
+}
+
+template <class TBlockType>
+void DomainDecompositionSolver<TBlockType>::invert(Matrix& A)
+{
+    if (this->d_componentState.getValue() == sofa::core::objectmodel::ComponentState::Invalid)
+    {
+        return;
+    }
+
+    {
+        SCOPED_TIMER_VARNAME(copyTimer, "copyMatrixData");
+        Mfiltered.copyNonZeros(A);
+        Mfiltered.compress();
+    }
+
+    const bool patternChanged = (MfilteredrowBegin != Mfiltered.rowBegin)
+        || (MfilteredcolsIndex != Mfiltered.colsIndex)
+        || (m_partitionedNbSubdomains != getNbSubdomains());
+
+    if (patternChanged)
+    {
+        buildSubdomains();
+        MfilteredrowBegin = Mfiltered.rowBegin;
+        MfilteredcolsIndex = Mfiltered.colsIndex;
+    }
+
+    const simulation::ForEachExecutionPolicy execution = d_parallelSubdomains.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    {
+        SCOPED_TIMER_VARNAME(factorizeTimer, "factorizeSubdomains");
+        simulation::forEachRange(execution, *taskScheduler, 0u, static_cast<unsigned int>(m_subdomains.size()),
+            [this, patternChanged](const auto& range)
+            {
+                for (auto s = range.start; s != range.end; ++s)
+                {
+                    updateSubdomainValues(m_subdomains[s]);
+                    factorizeSubdomain(m_subdomains[s], patternChanged);
+                }
+            });
+    }
+
+    for (std::size_t s = 0; s < m_subdomains.size(); ++s)
+    {
+        const auto& subdomain = m_subdomains[s];
+        msg_error_when(!subdomain.rows.empty() && subdomain.solver->info() != Eigen::ComputationInfo::Success)
+            << "Solver cannot factorize the interior of the subdomain " << s;
+    }
+
+    {
+        SCOPED_TIMER_VARNAME(schurTimer, "SchurComplement");
+        const auto nbInterfaceRows = static_cast<Eigen::Index>(m_interfaceRows.size());
+        m_schurComplement.setZero(nbInterfaceRows, nbInterfaceRows);
+
+        for (const auto& [valueIndex, row, col] : m_interfaceEntries)
+        {
+            m_schurComplement(row, col) += Mfiltered.colsValue[valueIndex];
+        }
+
+        for (const auto& subdomain : m_subdomains)
+        {
+            const auto m = static_cast<Eigen::Index>(subdomain.interface.size());
+            for (Eigen::Index c = 0; c < m; ++c)
+            {
+                for (Eigen::Index r = 0; r < m; ++r)
+                {
+                    m_schurComplement(subdomain.interface[r], subdomain.interface[c]) -= subdomain.schurContribution(r, c);
+                }
+            }
+        }
+
+        if (nbInterfaceRows > 0)
+        {
+            m_schurFactorization.compute(m_schurComplement);
+            msg_error_when(m_schurFactorization.info() != Eigen::ComputationInfo::Success)
+                << "Solver cannot factorize the Schur complement of the interface";
+        }
+    }
+}
+
+template <class TBlockType>
+void DomainDecompositionSolver<TBlockType>::solve(Matrix& A, Vector& x, Vector& b)
+{
+    SOFA_UNUSED(A);
+
+    if (this->d_componentState.getValue() == sofa::core::objectmodel::ComponentState::Invalid)
+    {
+        return;
+    }
+
+    const simulation::ForEachExecutionPolicy execution = d_parallelSubdomains.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    const auto nbSubdomains = static_cast<unsigned int>(m_subdomains.size());
+
+    // interface right-hand side: b_G - sum_k A_Gk A_kk^-1 b_k
+    simulation::forEachRange(execution, *taskScheduler, 0u, nbSubdomains,
+        [this, &b](const auto& range)
+        {
+            for (auto s = range.start; s != range.end; ++s)
+            {
+                auto& subdomain = m_subdomains[s];
+                subdomain.interfaceRhs.setZero();
+                if (subdomain.rows.empty())
+                {
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < subdomain.rows.size(); ++i)
+                {
+                    subdomain.rhs[i] = b[subdomain.rows[i]];
+                }
+                solveInterior(subdomain);
+
+                for (std::size_t i = 0; i < subdomain.rows.size(); ++i)
+                {
+                    for (int k = subdomain.couplingRowBegin[i]; k < subdomain.couplingRowBegin[i + 1]; ++k)
+                    {
+                        subdomain.interfaceRhs[subdomain.couplingColsIndex[k]] += subdomain.couplingValues[k] * subdomain.solution[i];
+                    }
+                }
+            }
+        });
+
+    const auto nbInterfaceRows = static_cast<Eigen::Index>(m_interfaceRows.size());
+    m_interfaceRhs.resize(nbInterfaceRows);
+    for (Eigen::Index g = 0; g < nbInterfaceRows; ++g)
+    {
+        m_interfaceRhs[g] = b[m_interfaceRows[g]];
+    }
+    for (const auto& subdomain : m_subdomains)
+    {
+        for (std::size_t c = 0; c < subdomain.interface.size(); ++c)
+        {
+            m_interfaceRhs[subdomain.interface[c]] -= subdomain.interfaceRhs[c];
+        }
+    }
+
+    if (nbInterfaceRows > 0)
+    {
+        m_interfaceSolution = m_schurFactorization.solve(m_interfaceRhs);
+    }
+    else
+    {
+        m_interfaceSolution.resize(0);
+    }
+
+    for (Eigen::Index g = 0; g < nbInterfaceRows; ++g)
+    {
+        x[m_interfaceRows[g]] = m_interfaceSolution[g];
+    }
+
+    // interior solutions: A_kk^-1 (b_k - A_kG x_G)
+    simulation::forEachRange(execution, *taskScheduler, 0u, nbSubdomains,
+        [this, &x, &b](const auto& range)
+        {
+            for (auto s = range.start; s != range.end; ++s)
+            {
+                auto& subdomain = m_subdomains[s];
+                if (subdomain.rows.empty())
+                {
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < subdomain.rows.size(); ++i)
+                {
+                    Real r = b[subdomain.rows[i]];
+                    for (int k = subdomain.couplingRowBegin[i]; k < subdomain.couplingRowBegin[i + 1]; ++k)
+                    {
+                        r -= subdomain.couplingValues[k] * m_interfaceSolution[subdomain.interface[subdomain.couplingColsIndex[k]]];
+                    }
+                    subdomain.rhs[i] = r;
+                }
+                solveInterior(subdomain);
+
+                for (std::size_t i = 0; i < subdomain.rows.size(); ++i)
+                {
+                    x[subdomain.rows[i]] = subdomain.solution[i];
+                }
+            }
+        });
+}
+
+}
@@ -26,6 +26,7 @@
 #include <variant>
 #include <Eigen/SparseCore>
 #include <sofa/component/linearsolver/direct/EigenSolverFactory.h>
+#include <sofa/component/linearsolver/direct/IterativeRefinement.h>
 
 #include <sofa/helper/OptionsGroup.h>
 
@@ -66,8 +67,15 @@ public:
     void solve (Matrix& A, Vector& x, Vector& b) override;
     void invert(Matrix& A) override;
 
+    Data<bool> d_mixedPrecision; ///< If true, the factorization and the solves are done in single precision, and the solution is refined with residuals computed in the precision of the matrix.
+    Data<unsigned int> d_maxRefinementSteps; ///< Maximum number of iterative refinement steps in mixed precision
+    Data<Real> d_refinementTolerance; ///< Relative residual |b - Ax| / |b| under which the iterative refinement stops
+    Data<Real> d_refinementResidual; ///< Relative residual |b - Ax| / |b| reached by the last solve in mixed precision
+
 protected:
 
+    EigenDirectSparseSolver();
+
     DeprecatedAndRemoved d_orderingMethod;
     std::string m_selectedOrderingMethod;
 
@@ -83,6 +91,14 @@ protected:
     typename sofa::linearalgebra::CompressedRowSparseMatrix<Real>::VecIndex MfilteredcolsIndex;
 
     static constexpr unsigned int s_defaultOrderingMethod { 1 };
+
+    bool isMixedPrecision() const;
+
+    /// Solver and copy of Mfiltered in single precision used in mixed precision
+    std::unique_ptr<BaseEigenSolverProxy> m_singlePrecisionSolver;
+    sofa::type::vector<float> m_singlePrecisionValues;
+    std::unique_ptr<BaseEigenSolverProxy::EigenSparseMatrixMap<float> > m_singlePrecisionMap;
+    IterativeRefinement<Real, float> m_iterativeRefinement;
 };
 
 }
@@ -27,6 +27,16 @@
 
 namespace sofa::component::linearsolver::direct
 {
+template <class TBlockType, class EigenSolver>
+EigenDirectSparseSolver<TBlockType, EigenSolver>::EigenDirectSparseSolver()
+    : d_mixedPrecision(initData(&d_mixedPrecision, false, "mixedPrecision", "If true, the factorization and the solves are done in single precision, "
+                                                                              "halving the memory used by the factor. The solution is then refined iteratively, the residuals "
+                                                                              "being computed in the precision of the matrix."))
+    , d_maxRefinementSteps(initData(&d_maxRefinementSteps, 3u, "maxRefinementSteps", "Maximum number of iterative refinement steps in mixed precision"))
+    , d_refinementTolerance(initData(&d_refinementTolerance, static_cast<Real>(1e-12), "refinementTolerance", "Relative residual |b - Ax| / |b| under which the iterative refinement stops"))
+    , d_refinementResidual(initData(&d_refinementResidual, static_cast<Real>(0), "refinementResidual", "Relative residual |b - Ax| / |b| reached by the last solve in mixed precision", true, true))
+{}
+
 template <class TBlockType, class EigenSolver>
 void EigenDirectSparseSolver<TBlockType, EigenSolver>
     ::init()
@@ -48,6 +58,23 @@ void EigenDirectSparseSolver<TBlockType, EigenSolver>
 {
     SOFA_UNUSED(A);
 
+    if (isMixedPrecision())
+    {
+        m_iterativeRefinement.maxRefinementSteps = d_maxRefinementSteps.getValue();
+        m_iterativeRefinement.tolerance = d_refinementTolerance.getValue();
+
+        const auto n = static_cast<Eigen::Index>(x.size());
+        const Real residual = m_iterativeRefinement.solve(Mfiltered, x.ptr(), b.ptr(),
+            [this, n](const float* r, float* d)
+            {
+                const BaseEigenSolverProxy::EigenVectorXdMap<float> rMap(const_cast<float*>(r), n);
+                BaseEigenSolverProxy::EigenVectorXdMap<float> dMap(d, n);
+                m_singlePrecisionSolver->solve(rMap, dMap);
+            });
+        d_refinementResidual.setValue(residual);
+        return;
+    }
+
     EigenVectorXdMap xMap(x.ptr(), x.size());
     EigenVectorXdMap bMap(b.ptr(), b.size());
 
@@ -64,25 +91,57 @@ void EigenDirectSparseSolver<TBlockType, EigenSolver>
         Mfiltered.compress();
     }
 
-    m_map = std::make_unique<EigenSparseMatrixMap>(Mfiltered.rows(), Mfiltered.cols(), Mfiltered.getColsValue().size(),
-                                                   (typename EigenSparseMatrixMap::StorageIndex*)Mfiltered.rowBegin.data(),
-                                                   (typename EigenSparseMatrixMap::StorageIndex*)Mfiltered.colsIndex.data(),
-                                                   Mfiltered.colsValue.data());
-
     const bool analyzePattern = (MfilteredrowBegin != Mfiltered.rowBegin) || (MfilteredcolsIndex != Mfiltered.colsIndex);
 
-    if (analyzePattern)
+    if (isMixedPrecision())
     {
-        SCOPED_TIMER_VARNAME(patternAnalysisTimer, "patternAnalysis");
-        m_solver->analyzePattern(*m_map);
+        // Mfiltered keeps the matrix in its own precision, to compute the residuals
+        m_singlePrecisionValues.resize(Mfiltered.colsValue.size());
+        for (std::size_t i = 0; i < Mfiltered.colsValue.size(); ++i)
+        {
+            m_singlePrecisionValues[i] = static_cast<float>(Mfiltered.colsValue[i]);
+        }
 
-        MfilteredrowBegin = Mfiltered.rowBegin;
-        MfilteredcolsIndex = Mfiltered.colsIndex;
-    }
+        m_singlePrecisionMap = std::make_unique<BaseEigenSolverProxy::EigenSparseMatrixMap<float> >(
+            Mfiltered.rows(), Mfiltered.cols(), m_singlePrecisionValues.size(),
+            (typename BaseEigenSolverProxy::EigenSparseMatrixMap<float>::StorageIndex*)Mfiltered.rowBegin.data(),
+            (typename BaseEigenSolverProxy::EigenSparseMatrixMap<float>::StorageIndex*)Mfiltered.colsIndex.data(),
+            m_singlePrecisionValues.data());
 
+        if (analyzePattern)
+        {
+            SCOPED_TIMER_VARNAME(patternAnalysisTimer, "patternAnalysis");
+            m_singlePrecisionSolver->analyzePattern(*m_singlePrecisionMap);
+
+            MfilteredrowBegin = Mfiltered.rowBegin;
+            MfilteredcolsIndex = Mfiltered.colsIndex;
+        }
+
+        {
+            SCOPED_TIMER_VARNAME(factorizeTimer, "factorization");
+            m_singlePrecisionSolver->factorize(*m_singlePrecisionMap);
+        }
+    }
+    else
     {
-        SCOPED_TIMER_VARNAME(factorizeTimer, "factorization");
-        m_solver->factorize(*m_map);
+        m_map = std::make_unique<EigenSparseMatrixMap>(Mfiltered.rows(), Mfiltered.cols(), Mfiltered.getColsValue().size(),
+                                                       (typename EigenSparseMatrixMap::StorageIndex*)Mfiltered.rowBegin.data(),
+                                                       (typename EigenSparseMatrixMap::StorageIndex*)Mfiltered.colsIndex.data(),
+                                                       Mfiltered.colsValue.data());
+
+        if (analyzePattern)
+        {
+            SCOPED_TIMER_VARNAME(patternAnalysisTimer, "patternAnalysis");
+            m_solver->analyzePattern(*m_map);
+
+            MfilteredrowBegin = Mfiltered.rowBegin;
+            MfilteredcolsIndex = Mfiltered.colsIndex;
+        }
+
+        {
+            SCOPED_TIMER_VARNAME(factorizeTimer, "factorization");
+            m_solver->factorize(*m_map);
+        }
     }
 
     msg_error_when(getSolverInfo() == Eigen::ComputationInfo::InvalidInput) << "Solver cannot factorize: invalid input";
@@ -94,9 +153,20 @@ template <class TBlockType, class EigenSolver>
 Eigen::ComputationInfo EigenDirectSparseSolver<TBlockType, EigenSolver>
 ::getSolverInfo() const
 {
+    if (isMixedPrecision())
+    {
+        return m_singlePrecisionSolver->info();
+    }
     return m_solver->info();
 }
 
+template <class TBlockType, class EigenSolver>
+bool EigenDirectSparseSolver<TBlockType, EigenSolver>::isMixedPrecision() const
+{
+    // the single precision solver is missing if the ordering method has no float version
+    return d_mixedPrecision.getValue() && m_singlePrecisionSolver != nullptr;
+}
+
 template <class TBlockType, class EigenSolver>
 void EigenDirectSparseSolver<TBlockType, EigenSolver>::updateSolverOderingMethod()
 {
@@ -131,6 +201,31 @@ void EigenDirectSparseSolver<TBlockType, EigenSolver>::updateSolverOderingMethod
             MfilteredrowBegin.clear();
             MfilteredcolsIndex.clear();
             m_map.reset();
+            m_singlePrecisionMap.reset();
+            m_singlePrecisionSolver.reset();
+        }
+
+        if (d_mixedPrecision.getValue() && !m_singlePrecisionSolver)
+        {
+            if (EigenSolverFactory::template hasSolver<float>(m_selectedOrderingMethod))
+            {
+                m_singlePrecisionSolver = std::unique_ptr<BaseEigenSolverProxy>(EigenSolverFactory::template getSolver<float>(m_selectedOrderingMethod));
+                MfilteredrowBegin.clear();
+                MfilteredcolsIndex.clear();
+            }
+            else
+            {
+                msg_warning() << "No single precision solver is available for the ordering method '"
+                    << m_selectedOrderingMethod << "'. The factorization is done in the precision of the matrix.";
+            }
+        }
+        else if (!d_mixedPrecision.getValue() && m_singlePrecisionSolver)
+        {
+            // the pattern must be analyzed again by the solver in the precision of the matrix
+            m_singlePrecisionSolver.reset();
+            m_singlePrecisionMap.reset();
+            MfilteredrowBegin.clear();
+            MfilteredcolsIndex.clear();
         }
     }
     else
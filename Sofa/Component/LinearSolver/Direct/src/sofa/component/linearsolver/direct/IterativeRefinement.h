@@ -0,0 +1,154 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/direct/config.h>
+
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/type/vector.h>
+#include <cmath>
+
+namespace sofa::component::linearsolver::direct
+{
+
+/**
+ * Mixed-precision solve of A x = b by iterative refinement.
+ *
+ * The corrections are computed by a solver working in a lower precision
+ * (typically a single precision factorization of A), while the residuals
+ * r = b - A x are computed in the precision of A. A few steps are enough to
+ * recover a solution as accurate as a factorization in the precision of A,
+ * as long as A is not too ill-conditioned for the lower precision.
+ */
+template<class Real, class LowReal = float>
+class IterativeRefinement
+{
+public:
+    using Matrix = sofa::linearalgebra::CompressedRowSparseMatrix<Real>;
+
+    /// Maximum number of corrections after the first low precision solve
+    unsigned int maxRefinementSteps { 3 };
+
+    /// Stop when |b - A x| <= tolerance * |b|
+    Real tolerance { 1e-12 };
+
+    /**
+     * Compute x such that A x = b, A being the scalar matrix which was factorized.
+     * lowPrecisionSolve(r, d) must compute d = A^-1 r in low precision.
+     * Return the relative residual |b - A x| / |b| of the solution.
+     */
+    template<class LowPrecisionSolve>
+    Real solve(const Matrix& A, Real* x, const Real* b, LowPrecisionSolve&& lowPrecisionSolve)
+    {
+        const auto n = A.rowSize();
+        m_nbSolves = 0;
+
+        m_residual.resize(n);
+        m_lowResidual.resize(n);
+        m_lowCorrection.resize(n);
+
+        Real normB = 0;
+        for (sofa::Index i = 0; i < n; ++i)
+        {
+            x[i] = 0;
+            m_residual[i] = b[i];
+            normB += b[i] * b[i];
+        }
+        normB = std::sqrt(normB);
+        if (normB == 0)
+        {
+            return 0;
+        }
+
+        Real normResidual = normB;
+        Real relativeResidual = 1;
+        do
+        {
+            // the residual is normalized before being converted, so that it does
+            // not underflow in low precision when the solution is already accurate
+            const Real scale = normResidual;
+            for (sofa::Index i = 0; i < n; ++i)
+            {
+                m_lowResidual[i] = static_cast<LowReal>(m_residual[i] / scale);
+            }
+
+            lowPrecisionSolve(m_lowResidual.data(), m_lowCorrection.data());
+            ++m_nbSolves;
+
+            for (sofa::Index i = 0; i < n; ++i)
+            {
+                x[i] += scale * static_cast<Real>(m_lowCorrection[i]);
+            }
+
+            const Real previousNormResidual = normResidual;
+            normResidual = computeResidual(A, x, b);
+            relativeResidual = normResidual / normB;
+
+            // no more progress: the low precision solve is not accurate enough for
+            // this system, and the last correction is discarded
+            if (!(normResidual < previousNormResidual))
+            {
+                if (m_nbSolves > 1)
+                {
+                    for (sofa::Index i = 0; i < n; ++i)
+                    {
+                        x[i] -= scale * static_cast<Real>(m_lowCorrection[i]);
+                    }
+                    relativeResidual = previousNormResidual / normB;
+                }
+                break;
+            }
+        }
+        while (relativeResidual > tolerance && m_nbSolves <= maxRefinementSteps);
+
+        return relativeResidual;
+    }
+
+    /// Number of low precision solves done by the last call to solve
+    unsigned int getNbSolves() const { return m_nbSolves; }
+
+protected:
+
+    /// r = b - A x, in the precision of A. Return |r|.
+    Real computeResidual(const Matrix& A, const Real* x, const Real* b)
+    {
+        const auto n = A.rowSize();
+        Real norm = 0;
+        for (sofa::Index i = 0; i < n; ++i)
+        {
+            Real r = b[i];
+            for (auto k = A.rowBegin[i]; k < A.rowBegin[i + 1]; ++k)
+            {
+                r -= A.colsValue[k] * x[A.colsIndex[k]];
+            }
+            m_residual[i] = r;
+            norm += r * r;
+        }
+        return std::sqrt(norm);
+    }
+
+    unsigned int m_nbSolves { 0 };
+    type::vector<Real> m_residual;
+    type::vector<LowReal> m_lowResidual;
+    type::vector<LowReal> m_lowCorrection;
+};
+
+} // namespace sofa::component::linearsolver::direct
@@ -35,6 +35,7 @@
 #include <sofa/helper/map.h>
 #include <cmath>
 #include <sofa/component/linearsolver/direct/SparseLDLSolverImpl.h>
+#include <sofa/component/linearsolver/direct/IterativeRefinement.h>
 #include <sofa/linearalgebra/BaseMatrix.h>
 #include <sofa/core/objectmodel/DataFileName.h>
 
@@ -55,6 +56,7 @@ public :
     typedef typename Inherit::ResMatrixType ResMatrixType;
     typedef typename Inherit::JMatrixType JMatrixType;
     typedef SparseLDLImplInvertData<type::vector<int>, type::vector<Real> > InvertData;
+    typedef SparseLDLImplInvertData<type::vector<int>, type::vector<float> > SinglePrecisionInvertData;
 
     void init() override;
     void parse( sofa::core::objectmodel::BaseObjectDescription* arg ) override;
@@ -68,6 +70,11 @@ public :
         return new InvertData();
     }
 
+    Data<bool> d_mixedPrecision; ///< If true, the factorization and the triangular solves are done in single precision, and the solution is refined with residuals computed in the precision of the matrix.
+    Data<unsigned int> d_maxRefinementSteps; ///< Maximum number of iterative refinement steps in mixed precision
+    Data<Real> d_refinementTolerance; ///< Relative residual |b - Ax| / |b| under which the iterative refinement stops
+    Data<Real> d_refinementResidual; ///< Relative residual |b - Ax| / |b| reached by the last solve in mixed precision
+
 protected :
     SparseLDLSolver();
 
@@ -76,6 +83,15 @@ protected :
     sofa::linearalgebra::CompressedRowSparseMatrix<Real> Mfiltered;
 
     bool factorize(Matrix& M, InvertData * invertData);
+    bool factorize(Matrix& M, SinglePrecisionInvertData * invertData);
+
+    /// Copy the non-zero values of M in Mfiltered. Return true if the system cannot be factorized.
+    bool filterMatrix(Matrix& M);
+
+    /// Factorization in single precision used in mixed precision
+    SinglePrecisionInvertData m_singlePrecisionInvertData;
+    type::vector<float> m_singlePrecisionValues;
+    IterativeRefinement<Real, float> m_iterativeRefinement;
 
     void showInvalidSystemMessage(const std::string& reason) const;
 
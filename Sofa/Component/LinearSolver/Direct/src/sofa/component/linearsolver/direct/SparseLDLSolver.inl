@@ -41,6 +41,12 @@ namespace sofa::component::linearsolver::direct
 template<class TMatrix, class TVector, class TThreadManager>
 SparseLDLSolver<TMatrix,TVector,TThreadManager>::SparseLDLSolver()
     : numStep(0)
+    , d_mixedPrecision(initData(&d_mixedPrecision, false, "mixedPrecision", "If true, the factorization and the triangular solves are done in single precision, "
+                                                                              "halving the memory used by the factor. The solution is then refined iteratively, the residuals "
+                                                                              "being computed in the precision of the matrix."))
+    , d_maxRefinementSteps(initData(&d_maxRefinementSteps, 3u, "maxRefinementSteps", "Maximum number of iterative refinement steps in mixed precision"))
+    , d_refinementTolerance(initData(&d_refinementTolerance, static_cast<Real>(1e-12), "refinementTolerance", "Relative residual |b - Ax| / |b| under which the iterative refinement stops"))
+    , d_refinementResidual(initData(&d_refinementResidual, static_cast<Real>(0), "refinementResidual", "Relative residual |b - Ax| / |b| reached by the last solve in mixed precision", true, true))
 {}
 
 template <class TMatrix, class TVector, class TThreadManager>
@@ -87,12 +93,78 @@ template<class TMatrix, class TVector, class TThreadManager>
 void SparseLDLSolver<TMatrix,TVector,TThreadManager>::solve (Matrix& M, Vector& z, Vector& r)
 {
     SCOPED_TIMER_VARNAME(solveTimer, "solve");
+
+    if (d_mixedPrecision.getValue())
+    {
+        m_iterativeRefinement.maxRefinementSteps = d_maxRefinementSteps.getValue();
+        m_iterativeRefinement.tolerance = d_refinementTolerance.getValue();
+
+        const Real residual = m_iterativeRefinement.solve(Mfiltered, z.ptr(), r.ptr(),
+            [this](const float* b, float* x)
+            {
+                Inherit::solve_cpu(x, b, &m_singlePrecisionInvertData);
+            });
+        d_refinementResidual.setValue(residual);
+
+        msg_info() << "Mixed precision solve: relative residual " << residual
+                   << " after " << m_iterativeRefinement.getNbSolves() << " single precision solves";
+        return;
+    }
+
     Inherit::solve_cpu(z.ptr(), r.ptr(), (InvertData *) this->getMatrixInvertData(&M));
 }
 
 template <class TMatrix, class TVector, class TThreadManager>
 bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::factorize(
     Matrix& M, InvertData * invertData)
+{
+    if (filterMatrix(M))
+    {
+        return true;
+    }
+
+    const int n = M.colSize();
+    int * M_colptr = (int *)Mfiltered.getRowBegin().data();
+    int * M_rowind = (int *)Mfiltered.getColsIndex().data();
+    Real * M_values = (Real *)Mfiltered.getColsValue().data();
+
+    Inherit::factorize(n,M_colptr,M_rowind,M_values, invertData);
+
+    numStep++;
+
+    return false;
+}
+
+template <class TMatrix, class TVector, class TThreadManager>
+bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::factorize(
+    Matrix& M, SinglePrecisionInvertData * invertData)
+{
+    if (filterMatrix(M))
+    {
+        return true;
+    }
+
+    // Mfiltered keeps the matrix in its own precision, to compute the residuals
+    const auto& values = Mfiltered.getColsValue();
+    m_singlePrecisionValues.resize(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        m_singlePrecisionValues[i] = static_cast<float>(values[i]);
+    }
+
+    const int n = M.colSize();
+    int * M_colptr = (int *)Mfiltered.getRowBegin().data();
+    int * M_rowind = (int *)Mfiltered.getColsIndex().data();
+
+    Inherit::factorize(n, M_colptr, M_rowind, m_singlePrecisionValues.data(), invertData);
+
+    numStep++;
+
+    return false;
+}
+
+template <class TMatrix, class TVector, class TThreadManager>
+bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::filterMatrix(Matrix& M)
 {
     Mfiltered.copyNonZeros(M);
     Mfiltered.compress();
@@ -121,10 +193,6 @@ bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::factorize(
         return true;
     }
 
-    Inherit::factorize(n,M_colptr,M_rowind,M_values, invertData);
-
-    numStep++;
-
     return false;
 }
 
@@ -137,7 +205,14 @@ void SparseLDLSolver<TMatrix, TVector, TThreadManager>::showInvalidSystemMessage
 template<class TMatrix, class TVector, class TThreadManager>
 void SparseLDLSolver<TMatrix,TVector,TThreadManager>::invert(Matrix& M)
 {
-    factorize(M, (InvertData *) this->getMatrixInvertData(&M));
+    if (d_mixedPrecision.getValue())
+    {
+        factorize(M, &m_singlePrecisionInvertData);
+    }
+    else
+    {
+        factorize(M, (InvertData *) this->getMatrixInvertData(&M));
+    }
 }
 
 template <class TMatrix, class TVector, class TThreadManager>
@@ -284,6 +359,13 @@ template<class TMatrix, class TVector, class TThreadManager>
 bool SparseLDLSolver<TMatrix,TVector,TThreadManager>::addJMInvJtLocal(TMatrix * M, ResMatrixType * result,const JMatrixType * J, SReal fact) 
 {
 
+    if (d_mixedPrecision.getValue())
+    {
+        // each column is solved with iterative refinement, sequentially as the
+        // refinement buffers are shared
+        return this->singleThreadAddJMInvJtLocal(M, result, J, fact);
+    }
+
     InvertData* data = (InvertData*)this->getMatrixInvertData(M);
 
     return doAddJMInvJtLocal(result, J, fact, data);
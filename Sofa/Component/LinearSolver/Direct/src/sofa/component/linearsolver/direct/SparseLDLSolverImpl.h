@@ -176,9 +176,13 @@ protected :
     , d_L_nnz(initData(&d_L_nnz, 0, "L_nnz", "Number of non-zero values in the lower triangular matrix of the factorization. The lower, the faster the system is solved.", true, true))
     {}
 
+    /// The factorization and the solves are done in the scalar type of the invert data,
+    /// which can be float when the solver works in mixed precision
     template<class VecInt,class VecReal>
-    void solve_cpu(Real * x,const Real * b,SparseLDLImplInvertData<VecInt,VecReal> * data)
+    void solve_cpu(typename VecReal::value_type * x,const typename VecReal::value_type * b,SparseLDLImplInvertData<VecInt,VecReal> * data)
     {
+        using FactorReal = typename VecReal::value_type;
+
         int n = data->n;
         if (n == 0)
         {
@@ -187,8 +191,9 @@ protected :
 
         const int * perm = data->perm.data();
 
-        Tmp.clear();
-        Tmp.fastResize(n);
+        auto& tmp = workVector<FactorReal>(Tmp, TmpFloat);
+        tmp.clear();
+        tmp.fastResize(n);
 
         // A x = b
         //   <=> (L * D * L^T) * x = b
@@ -197,10 +202,10 @@ protected :
         //   <=> L^T * x = z                    # Step 3: compute x from the system L^T x = z
 
         // b, x, y and z can be read/written in the same vector:
-        Real* const bPermuted = Tmp.data();
-        Real* const xPermuted = Tmp.data();
-        Real* const y = Tmp.data();
-        Real* const z = Tmp.data();
+        FactorReal* const bPermuted = tmp.data();
+        FactorReal* const xPermuted = tmp.data();
+        FactorReal* const y = tmp.data();
+        FactorReal* const z = tmp.data();
 
         // apply the permutation to the right-hand side
         for (int i = 0; i < n; ++i)
@@ -228,7 +233,8 @@ protected :
         }
     }
 
-    void LDL_ordering(int n, int nnz, int* M_colptr, int* M_rowind, Real* M_values, int* perm, int* invperm)
+    template<class FactorReal>
+    void LDL_ordering(int n, int nnz, int* M_colptr, int* M_rowind, FactorReal* M_values, int* perm, int* invperm)
     {
         SOFA_UNUSED(M_values);
         core::behavior::BaseOrderingMethod::SparseMatrixPattern pattern;
@@ -252,19 +258,23 @@ protected :
         CSPARSE_symbolic(n,M_colptr,M_rowind,colptr,perm,invperm,Parent,Flag.data(),Lnz.data());
     }
 
+    template<class FactorReal>
     void LDL_numeric(int n,
-                     int* M_colptr, int* M_rowind, Real* M_values,
-                     int* colptr, int* rowind, Real* values,
-                     Real* D, int* perm, int* invperm, int* Parent)
+                     int* M_colptr, int* M_rowind, FactorReal* M_values,
+                     int* colptr, int* rowind, FactorReal* values,
+                     FactorReal* D, int* perm, int* invperm, int* Parent)
     {
-        Y.resize(n);
+        auto& y = workVector<FactorReal>(Y, YFloat);
+        y.resize(n);
 
-        CSPARSE_numeric<Real>(n,M_colptr,M_rowind,M_values,colptr,rowind,values,D,perm,invperm,Parent,Flag.data(),Lnz.data(),Pattern.data(),Y.data());
+        CSPARSE_numeric<FactorReal>(n,M_colptr,M_rowind,M_values,colptr,rowind,values,D,perm,invperm,Parent,Flag.data(),Lnz.data(),Pattern.data(),y.data());
     }
 
     template<class VecInt,class VecReal>
-    void factorize(int n,int * M_colptr, int * M_rowind, Real * M_values, SparseLDLImplInvertData<VecInt,VecReal> * data)
+    void factorize(int n,int * M_colptr, int * M_rowind, typename VecReal::value_type * M_values, SparseLDLImplInvertData<VecInt,VecReal> * data)
     {
+        using FactorReal = typename VecReal::value_type;
+
         data->new_factorization_needed =
             data->P_colptr.size() == 0 ||
             data->P_rowind.size() == 0 ||
@@ -274,7 +284,7 @@ protected :
         data->P_nnz = M_colptr[data->n];
         data->P_values.clear();
         data->P_values.fastResize(data->P_nnz);
-        memcpy(data->P_values.data(), M_values, data->P_nnz * sizeof(Real));
+        memcpy(data->P_values.data(), M_values, data->P_nnz * sizeof(FactorReal));
 
         // we test if the matrix has the same struct as previous factorized matrix
         if (data->new_factorization_needed  || !d_precomputeSymbolicDecomposition.getValue() )
@@ -312,13 +322,13 @@ protected :
             data->LT_values.clear();data->LT_values.fastResize(data->L_nnz);
         }
 
-        Real * D = data->invD.data();
+        FactorReal * D = data->invD.data();
         int * rowind = data->L_rowind.data();
         int * colptr = data->L_colptr.data();
-        Real * values = data->L_values.data();
+        FactorReal * values = data->L_values.data();
         int * tran_rowind = data->LT_rowind.data();
         int * tran_colptr = data->LT_colptr.data();
-        Real * tran_values = data->LT_values.data();
+        FactorReal * tran_values = data->LT_values.data();
 
         //Numeric Factorization
         {
@@ -371,6 +381,25 @@ protected : //the following variables are used during the factorization they can
     type::vector<Real> Y;
     type::vector<int> Lnz,Flag,Pattern;
     type::vector<int> tran_countvec;
+
+    /// Work vectors used when the factorization is done in single precision
+    type::vector<float> TmpFloat, YFloat;
+
+    template<class FactorReal>
+    static type::vector<FactorReal>& workVector(type::vector<Real>& realVector, type::vector<float>& floatVector)
+    {
+        if constexpr (std::is_same_v<FactorReal, Real>)
+        {
+            SOFA_UNUSED(floatVector);
+            return realVector;
+        }
+        else
+        {
+            static_assert(std::is_same_v<FactorReal, float>, "The factorization is done either in Real or in float");
+            SOFA_UNUSED(realVector);
+            return floatVector;
+        }
+    }
 };
 
 } // namespace sofa::component::linearsolver::direct
@@ -0,0 +1,245 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/component/linearsolver/direct/DomainDecompositionSolver.h>
+#include <sofa/component/linearsolver/direct/SparseLDLSolver.h>
+#include <sofa/component/linearsolver/direct/init.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+
+#include <sofa/testing/NumericTest.h>
+
+namespace
+{
+
+using MatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+using VectorType = sofa::linearalgebra::FullVector<SReal>;
+
+/// Laplacian of a grid of size n x n, shifted to be positive definite
+void buildGridLaplacian(const sofa::Index n, MatrixType& matrix)
+{
+    matrix.resize(n * n, n * n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        for (sofa::Index j = 0; j < n; ++j)
+        {
+            const sofa::Index row = i * n + j;
+            if (i > 0) matrix.add(row, row - n, -1_sreal);
+            if (j > 0) matrix.add(row, row - 1, -1_sreal);
+            matrix.add(row, row, 4.01_sreal);
+            if (j + 1 < n) matrix.add(row, row + 1, -1_sreal);
+            if (i + 1 < n) matrix.add(row, row + n, -1_sreal);
+        }
+    }
+    matrix.compress();
+}
+
+}
+
+TEST(DomainDecompositionSolver, SameSolutionAsSparseLDLSolver)
+{
+    sofa::component::linearsolver::direct::init();
+
+    using Solver = sofa::component::linearsolver::direct::DomainDecompositionSolver<SReal>;
+    using Reference = sofa::component::linearsolver::direct::SparseLDLSolver<MatrixType, VectorType>;
+
+    const sofa::simulation::Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+    constexpr sofa::Index n = 30;
+    MatrixType matrix;
+    buildGridLaplacian(n, matrix);
+
+    VectorType b(n * n);
+    for (sofa::Index i = 0; i < n * n; ++i)
+    {
+        b[i] = std::sin(static_cast<SReal>(i));
+    }
+
+    const Reference::SPtr reference = sofa::core::objectmodel::New<Reference>();
+    root->addObject(reference);
+    reference->init();
+    VectorType expected(n * n);
+    reference->invert(matrix);
+    reference->solve(matrix, expected, b);
+
+    for (const unsigned int nbSubdomains : {1u, 2u, 5u, 16u})
+    {
+        const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+        root->addObject(solver);
+        solver->d_nbSubdomains.setValue(nbSubdomains);
+        solver->init();
+
+        VectorType x(n * n);
+        solver->invert(matrix);
+        solver->solve(matrix, x, b);
+
+        if (nbSubdomains == 1)
+        {
+            EXPECT_EQ(solver->d_interfaceSize.getValue(), 0u);
+        }
+        else
+        {
+            EXPECT_GT(solver->d_interfaceSize.getValue(), 0u);
+            EXPECT_LT(solver->d_interfaceSize.getValue(), n * n / 2);
+        }
+
+        for (sofa::Index i = 0; i < n * n; ++i)
+        {
+            EXPECT_NEAR(x[i], expected[i], 1e-10) << "nbSubdomains = " << nbSubdomains << ", i = " << i;
+        }
+
+        root->removeObject(solver);
+    }
+
+    sofa::simulation::node::unload(root);
+}
+
+TEST(DomainDecompositionSolver, PartitionIsReusedWhileThePatternIsConstant)
+{
+    sofa::component::linearsolver::direct::init();
+
+    using Solver = sofa::component::linearsolver::direct::DomainDecompositionSolver<SReal>;
+
+    const sofa::simulation::Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+    const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+    root->addObject(solver);
+    solver->d_nbSubdomains.setValue(4);
+    solver->init();
+
+    constexpr sofa::Index n = 10;
+    MatrixType matrix;
+    buildGridLaplacian(n, matrix);
+
+    VectorType b(n * n);
+    for (sofa::Index i = 0; i < n * n; ++i)
+    {
+        b[i] = 1_sreal;
+    }
+
+    VectorType x(n * n);
+    solver->invert(matrix);
+    solver->solve(matrix, x, b);
+    EXPECT_EQ(solver->d_nbPartitions.getValue(), 1u);
+
+    // same pattern, different values: the partition is kept and the solution scales
+    MatrixType scaled;
+    buildGridLaplacian(n, scaled);
+    for (auto& value : scaled.colsValue)
+    {
+        value *= 2_sreal;
+    }
+
+    VectorType y(n * n);
+    solver->invert(scaled);
+    solver->solve(scaled, y, b);
+    EXPECT_EQ(solver->d_nbPartitions.getValue(), 1u);
+
+    for (sofa::Index i = 0; i < n * n; ++i)
+    {
+        EXPECT_NEAR(2_sreal * y[i], x[i], 1e-12);
+    }
+
+    // different pattern: the matrix is partitioned again
+    MatrixType larger;
+    buildGridLaplacian(n + 1, larger);
+    VectorType z((n + 1) * (n + 1));
+    VectorType c((n + 1) * (n + 1));
+    for (sofa::Index i = 0; i < (n + 1) * (n + 1); ++i)
+    {
+        c[i] = 1_sreal;
+    }
+    solver->invert(larger);
+    solver->solve(larger, z, c);
+    EXPECT_EQ(solver->d_nbPartitions.getValue(), 2u);
+
+    sofa::simulation::node::unload(root);
+}
+
+TEST(DomainDecompositionSolver, InitializesTheTaskScheduler)
+{
+    sofa::component::linearsolver::direct::init();
+
+    using Solver = sofa::component::linearsolver::direct::DomainDecompositionSolver<SReal>;
+
+    const sofa::simulation::Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+    const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+    root->addObject(solver);
+    solver->init();
+
+    const sofa::simulation::TaskScheduler* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
+    ASSERT_NE(taskScheduler, nullptr);
+    EXPECT_GE(taskScheduler->getThreadCount(), 1u);
+
+    sofa::simulation::node::unload(root);
+}
+
+TEST(DomainDecompositionSolver, DefaultParametersUseTheThreadsOfTheTaskScheduler)
+{
+    sofa::component::linearsolver::direct::init();
+    sofa::simulation::MainTaskSchedulerFactory::createInRegistry()->init(4);
+
+    using Solver = sofa::component::linearsolver::direct::DomainDecompositionSolver<SReal>;
+    using Reference = sofa::component::linearsolver::direct::SparseLDLSolver<MatrixType, VectorType>;
+
+    const sofa::simulation::Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+    constexpr sofa::Index n = 30;
+    MatrixType matrix;
+    buildGridLaplacian(n, matrix);
+
+    VectorType b(n * n);
+    for (sofa::Index i = 0; i < n * n; ++i)
+    {
+        b[i] = std::cos(static_cast<SReal>(i));
+    }
+
+    const Reference::SPtr reference = sofa::core::objectmodel::New<Reference>();
+    root->addObject(reference);
+    reference->init();
+    VectorType expected(n * n);
+    reference->invert(matrix);
+    reference->solve(matrix, expected, b);
+
+    // default parameters: one subdomain per thread, factorized and solved in parallel
+    const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+    root->addObject(solver);
+    solver->init();
+    EXPECT_EQ(solver->d_nbSubdomains.getValue(), 0u);
+    EXPECT_TRUE(solver->d_parallelSubdomains.getValue());
+
+    VectorType x(n * n);
+    solver->invert(matrix);
+    solver->solve(matrix, x, b);
+
+    EXPECT_GT(solver->d_interfaceSize.getValue(), 0u);
+    EXPECT_LT(solver->d_interfaceSize.getValue(), n * n / 2);
+    for (sofa::Index i = 0; i < n * n; ++i)
+    {
+        EXPECT_NEAR(x[i], expected[i], 1e-10) << "i = " << i;
+    }
+
+    sofa::simulation::node::unload(root);
+}
@@ -138,3 +138,59 @@ TEST(SparseLDLSolver, AssociatedLinearSystem)
 
     EXPECT_EQ(MatrixSystem::GetCustomTemplateName(), MatrixType::Name());
 }
+
+TEST(SparseLDLSolver, MixedPrecision)
+{
+    using MatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+    using VectorType = sofa::linearalgebra::FullVector<SReal>;
+    using Solver = sofa::component::linearsolver::direct::SparseLDLSolver<MatrixType, VectorType>;
+
+    // symmetric positive definite tridiagonal matrix
+    constexpr sofa::Index n = 200;
+    MatrixType matrix;
+    matrix.resize(n, n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            matrix.add(i, i - 1, -1_sreal);
+        }
+        matrix.add(i, i, 2.01_sreal);
+        if (i + 1 < n)
+        {
+            matrix.add(i, i + 1, -1_sreal);
+        }
+    }
+    matrix.compress();
+
+    VectorType b(n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        b[i] = std::sin(static_cast<SReal>(i));
+    }
+
+    const Solver::SPtr reference = sofa::core::objectmodel::New<Solver>();
+    reference->init();
+    VectorType expected(n);
+    reference->invert(matrix);
+    reference->solve(matrix, expected, b);
+
+    const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+    solver->d_mixedPrecision.setValue(true);
+    solver->init();
+    VectorType x(n);
+    solver->invert(matrix);
+    solver->solve(matrix, x, b);
+
+    const SReal tolerance = 1e4_sreal * std::numeric_limits<SReal>::epsilon();
+    EXPECT_LT(solver->d_refinementResidual.getValue(), tolerance);
+
+    SReal maxDifference = 0;
+    SReal maxValue = 0;
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        maxDifference = std::max(maxDifference, std::abs(x[i] - expected[i]));
+        maxValue = std::max(maxValue, std::abs(expected[i]));
+    }
+    EXPECT_LT(maxDifference, tolerance * maxValue * 100);
+}
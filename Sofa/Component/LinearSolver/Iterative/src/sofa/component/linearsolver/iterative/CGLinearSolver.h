@@ -23,6 +23,7 @@
 #include <sofa/component/linearsolver/iterative/config.h>
 
 #include <sofa/component/linearsolver/iterative/MatrixLinearSolver.h>
+#include <sofa/component/linearsolver/iterative/ParallelMatrixVectorProduct.h>
 #include <sofa/helper/map.h>
 
 namespace sofa::component::linearsolver::iterative
@@ -45,6 +46,7 @@ public:
     Data<Real> d_smallDenominatorThreshold; ///< Minimum value of the denominator (pT A p)^ in the conjugate Gradient solution
     Data<bool> d_warmStart; ///< Use previous solution as initial solution, which may improve the initial guess if your system is evolving smoothly
     Data<std::map < std::string, sofa::type::vector<Real> > > d_graph; ///< Graph of residuals at each iteration
+    Data<bool> d_parallelProduct; ///< Parallelize the matrix-vector products on assembled matrices made of blocks (e.g. CompressedRowSparseMatrixMat3x3)
 
 protected:
 
@@ -60,6 +62,9 @@ protected:
     int timeStepCount{0};
     bool equilibriumReached{false};
 
+    ParallelMatrixVectorProduct<TMatrix, TVector> m_product;
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+
 public:
     void init() override;
     void reinit() override {};
@@ -22,6 +22,7 @@
 #pragma once
 #include <sofa/component/linearsolver/iterative/CGLinearSolver.h>
 #include <sofa/simulation/MechanicalVisitor.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
 
 #include <sofa/helper/AdvancedTimer.h>
 #include <sofa/helper/ScopedAdvancedTimer.h>
@@ -38,6 +39,7 @@ CGLinearSolver<TMatrix,TVector>::CGLinearSolver()
     , d_smallDenominatorThreshold( initData(&d_smallDenominatorThreshold,(Real)1e-5,"threshold","Minimum value of the denominator (pT A p)^ in the conjugate Gradient solution") )
     , d_warmStart( initData(&d_warmStart,false,"warmStart","Use previous solution as initial solution, which may improve the initial guess if your system is evolving smoothly") )
     , d_graph( initData(&d_graph,"graph","Graph of residuals at each iteration") )
+    , d_parallelProduct( initData(&d_parallelProduct, false, "parallelProduct", "Parallelize the matrix-vector products on assembled matrices made of blocks (e.g. CompressedRowSparseMatrixMat3x3)") )
 {
     d_graph.setWidget("graph");
     d_maxIter.setRequired(true);
@@ -64,6 +66,18 @@ void CGLinearSolver<TMatrix,TVector>::init()
         d_smallDenominatorThreshold.setValue(1e-5);
     }
 
+    m_taskScheduler = nullptr;
+    if (d_parallelProduct.getValue())
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+
     timeStepCount = 0;
     equilibriumReached = false;
 }
@@ -115,7 +129,7 @@ void CGLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
     /// Compute the initial residual r depending on the warmStart option
     if( d_warmStart.getValue() )
     {
-        r = A * x;
+        m_product.multiply(m_taskScheduler, A, r, x);
         r.eq( b, r, -1.0 );   // initial residual r = b - Ax;
     }
     else
@@ -225,7 +239,7 @@ void CGLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
             /// 2) The matrix is not assembled (e.g. GraphScattered): visitors run and call addMBKdx on force
             /// fields (usually force fields implement addDForce). This method performs the matrix-vector product and
             /// store it in another vector without building explicitly the matrix. Projective constraints are also applied.
-            q = A*p;
+            m_product.multiply(m_taskScheduler, A, q, p);
             msg_info() << "q = A p : " << q;
 
             /// Compute the denominator : pT A p
@@ -301,7 +315,7 @@ void CGLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
         if( timeStepCount==0 )
         {
             p = r;
-            q = A*p;
+            m_product.multiply(m_taskScheduler, A, q, p);
             const auto den = p.dot(q);
 
             if(den != 0.0)
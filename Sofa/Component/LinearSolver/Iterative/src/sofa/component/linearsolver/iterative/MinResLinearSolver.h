@@ -23,6 +23,7 @@
 #include <sofa/component/linearsolver/iterative/config.h>
 
 #include <sofa/component/linearsolver/iterative/MatrixLinearSolver.h>
+#include <sofa/component/linearsolver/iterative/ParallelMatrixVectorProduct.h>
 #include <sofa/helper/map.h>
 
 #include <cmath>
@@ -50,11 +51,16 @@ public:
     sofa::core::objectmodel::lifecycle::RemovedData f_verbose{this, "v23.12", "v24.06", "verbose", "This Data is no longer used"};
 
     Data<std::map < std::string, sofa::type::vector<SReal> > > f_graph; ///< Graph of residuals at each iteration
+    Data<bool> d_parallelProduct; ///< Parallelize the matrix-vector products on assembled matrices made of blocks (e.g. CompressedRowSparseMatrixMat3x3)
 
 protected:
     MinResLinearSolver();
 
+    ParallelMatrixVectorProduct<TMatrix, TVector> m_product;
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+
 public:
+    void init() override;
     void resetSystem() override;
     void setSystemMBKMatrix(const sofa::core::MechanicalParams* mparams) override;
 
@@ -26,6 +26,7 @@
 #include <sofa/linearalgebra/SparseMatrix.h>
 #include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
 #include <sofa/simulation/MechanicalVisitor.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <sofa/helper/system/thread/CTime.h>
 #include <sofa/helper/AdvancedTimer.h>
 
@@ -41,6 +42,7 @@ MinResLinearSolver<TMatrix,TVector>::MinResLinearSolver()
     : f_maxIter( initData(&f_maxIter,(unsigned)25,"iterations","maximum number of iterations of the Conjugate Gradient solution") )
     , f_tolerance( initData(&f_tolerance,1e-5,"tolerance","desired precision of the Conjugate Gradient Solution (ratio of current residual norm over initial residual norm)") )
     , f_graph( initData(&f_graph,"graph","Graph of residuals at each iteration") )
+    , d_parallelProduct( initData(&d_parallelProduct, false, "parallelProduct", "Parallelize the matrix-vector products on assembled matrices made of blocks (e.g. CompressedRowSparseMatrixMat3x3)") )
 {
     f_graph.setWidget("graph");
 //    d_graph.setReadOnly(true);
@@ -49,6 +51,24 @@ MinResLinearSolver<TMatrix,TVector>::MinResLinearSolver()
 	f_tolerance.setRequired(true);
 }
 
+template<class TMatrix, class TVector>
+void MinResLinearSolver<TMatrix,TVector>::init()
+{
+    Inherit1::init();
+
+    m_taskScheduler = nullptr;
+    if (d_parallelProduct.getValue())
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+}
+
 template<class TMatrix, class TVector>
 void MinResLinearSolver<TMatrix,TVector>::resetSystem()
 {
@@ -100,7 +120,7 @@ void MinResLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
     Vector& v  = *vtmp.createTempVector();
 
 
-    *r1 = A * x;
+    m_product.multiply(m_taskScheduler, A, *r1, x);
     r1->eq( b, *r1, -1.0 );   //  r1 = b - r1;
 
 
@@ -158,7 +178,7 @@ void MinResLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
 //            v  = y;
 //            v *= s;         // v = vk if P = I
 
-            y = A * v;
+            m_product.multiply(m_taskScheduler, A, y, v);
             if(itn) y.peq( *r1, -beta/oldb );
 
             alpha = v.dot( y );	// alphak
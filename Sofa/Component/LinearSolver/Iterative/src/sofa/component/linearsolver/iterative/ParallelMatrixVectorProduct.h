@@ -0,0 +1,170 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/iterative/config.h>
+
+#include <sofa/linearalgebra/CompressedRowSparseMatrixMechanical.h>
+#include <sofa/linearalgebra/BlockSparseMatrixVectorProduct.h>
+#include <sofa/linearalgebra/FullVector.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+namespace sofa::component::linearsolver::iterative
+{
+
+/// True if the product of TMatrix with TVector can be computed with the block kernels
+template<class TMatrix, class TVector>
+struct IsBlockMatrixVectorProduct : std::false_type {};
+
+template<class TBlock, class TPolicy, class Real>
+struct IsBlockMatrixVectorProduct<linearalgebra::CompressedRowSparseMatrixMechanical<TBlock, TPolicy>, linearalgebra::FullVector<Real> >
+    : std::bool_constant<linearalgebra::CompressedRowSparseMatrixMechanical<TBlock, TPolicy>::IsFixedSizeBlock> {};
+
+/**
+ * Matrix-vector product res = A * x used by the iterative solvers.
+ *
+ * If A is an assembled matrix made of fixed-size blocks (e.g. CompressedRowSparseMatrix<Mat3x3>),
+ * the block rows are split in ranges of similar number of blocks, and the ranges are multiplied
+ * in parallel using the task scheduler. If only the upper triangular blocks are stored, the
+ * contributions of the transposed blocks are accumulated in a buffer per range, then summed.
+ * In deterministic execution (see simulation::setDeterministicExecution), the number of ranges
+ * of such a matrix does not depend on the number of threads, so that the sums do not either.
+ *
+ * Small block matrices are multiplied in a single thread with the same kernels, and the other
+ * matrix types use the product of the matrix type (A * x).
+ */
+template<class TMatrix, class TVector>
+class ParallelMatrixVectorProduct
+{
+public:
+    /// Below this number of blocks, the product is computed in a single thread
+    sofa::Size minNbBlocksPerThread { 512 };
+
+    /// Number of ranges of the matrices storing only the upper triangular blocks, in deterministic execution
+    sofa::Size nbDeterministicParts { 8 };
+
+    void multiply(simulation::TaskScheduler* taskScheduler, TMatrix& A, TVector& res, TVector& x)
+    {
+        if constexpr (IsBlockMatrixVectorProduct<TMatrix, TVector>::value)
+        {
+            A.compress();
+
+            const auto nbBlocks = static_cast<sofa::Size>(A.colsValue.size());
+            const sofa::Size nbThreads = taskScheduler ? taskScheduler->getThreadCount() : 1;
+            const sofa::Size maxNbParts = nbBlocks / std::max<sofa::Size>(minNbBlocksPerThread, 1);
+
+            // the sum of the transposed contributions depends on the partition of the rows
+            const bool fixedPartition = !TMatrix::Policy::StoreLowerTriangularBlock && simulation::isDeterministicExecution();
+            const sofa::Size nbParts = std::min(fixedPartition ? nbDeterministicParts : nbThreads, maxNbParts);
+
+            if (nbParts > 1)
+            {
+                multiplyParallel(taskScheduler, nbParts, A, res, x);
+            }
+            else
+            {
+                // written directly in res, without temporary vector
+                A.mul(res, x);
+            }
+        }
+        else
+        {
+            res = A * x;
+        }
+    }
+
+protected:
+
+    using Index = sofa::SignedIndex;
+    using Real = typename TMatrix::Real;
+
+    /// The parts are multiplied sequentially if there is no task scheduler
+    void multiplyParallel(simulation::TaskScheduler* taskScheduler, sofa::Size nbParts, TMatrix& A, TVector& res, TVector& x)
+    {
+        using Policy = typename TMatrix::Policy;
+
+        const auto n = A.rowSize();
+        res.resize(n);
+
+        const auto nbRows = static_cast<Index>(A.rowIndex.size());
+        sofa::linearalgebra::bsr::partitionRows(A.rowBegin.data(), nbRows, nbParts, m_boundaries);
+
+        if constexpr (!Policy::StoreLowerTriangularBlock)
+        {
+            m_transposedContributions.resize(nbParts);
+        }
+
+        // each range writes its own rows of the result
+        const auto multiplyPart = [&](const sofa::Size p)
+        {
+            sofa::linearalgebra::bsr::multiplyRows(A.rowIndex.data(), A.rowBegin.data(), A.colsIndex.data(), A.colsValue.data(),
+                x.ptr(), res.ptr(), m_boundaries[p], m_boundaries[p + 1]);
+
+            if constexpr (!Policy::StoreLowerTriangularBlock)
+            {
+                auto& contribution = m_transposedContributions[p];
+                contribution.assign(n, Real(0));
+                sofa::linearalgebra::bsr::addMultiplyTransposedOffDiagonalRows(A.rowIndex.data(), A.rowBegin.data(), A.colsIndex.data(), A.colsValue.data(),
+                    x.ptr(), contribution.data(), m_boundaries[p], m_boundaries[p + 1]);
+            }
+        };
+
+        if (taskScheduler)
+        {
+            simulation::parallelForEach(*taskScheduler, sofa::Size(0), nbParts, multiplyPart);
+        }
+        else
+        {
+            simulation::forEach(sofa::Size(0), nbParts, multiplyPart);
+        }
+
+        if constexpr (!Policy::StoreLowerTriangularBlock)
+        {
+            const auto sumContributions = [&](const auto& range)
+            {
+                for (auto i = range.start; i != range.end; ++i)
+                {
+                    Real sum = res[i];
+                    for (const auto& contribution : m_transposedContributions)
+                    {
+                        sum += contribution[i];
+                    }
+                    res[i] = sum;
+                }
+            };
+
+            if (taskScheduler)
+            {
+                simulation::parallelForEachRange(*taskScheduler, Index(0), static_cast<Index>(n), sumContributions);
+            }
+            else
+            {
+                simulation::forEachRange(Index(0), static_cast<Index>(n), sumContributions);
+            }
+        }
+    }
+
+    sofa::type::vector<Index> m_boundaries;
+    sofa::type::vector<sofa::type::vector<Real> > m_transposedContributions;
+};
+
+} // namespace sofa::component::linearsolver::iterative
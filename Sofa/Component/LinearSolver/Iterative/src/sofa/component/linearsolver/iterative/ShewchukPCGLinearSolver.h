@@ -25,6 +25,7 @@
 #include <sofa/core/behavior/LinearSolver.h>
 #include <sofa/component/linearsolver/iterative/MatrixLinearSolver.h>
 #include <sofa/helper/map.h>
+#include <sofa/helper/system/thread/CTime.h>
 
 #include <cmath>
 
@@ -49,6 +50,8 @@ public:
     Data<unsigned> f_update_step; ///< Number of steps before the next refresh of precondtioners
     Data<bool> f_build_precond; ///< Build the preconditioners, if false build the preconditioner only at the initial step
     Data<std::map < std::string, sofa::type::vector<double> > > f_graph; ///< Graph of residuals at each iteration
+    Data<unsigned> d_nbIterations; ///< Number of iterations of the last solve
+    Data<double> d_preconditionerTime; ///< Time (ms) spent in the update and the application of the preconditioner during the last solve
 
 protected:
     ShewchukPCGLinearSolver();
@@ -63,6 +66,9 @@ private :
     bool first;
     int newton_iter;
 
+    /// Time (in ticks) spent in the preconditioner since the last solve
+    sofa::helper::system::thread::ctime_t m_preconditionerTicks { 0 };
+
 protected:
     /// This method is separated from the rest to be able to use custom/optimized versions depending on the types of vectors.
     /// It computes: p = p*beta + r
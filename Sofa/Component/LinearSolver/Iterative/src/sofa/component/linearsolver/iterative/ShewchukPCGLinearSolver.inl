@@ -43,6 +43,8 @@ ShewchukPCGLinearSolver<TMatrix,TVector>::ShewchukPCGLinearSolver()
     , f_update_step( initData(&f_update_step,(unsigned)1,"update_step","Number of steps before the next refresh of precondtioners") )
     , f_build_precond( initData(&f_build_precond,true,"build_precond","Build the preconditioners, if false build the preconditioner only at the initial step") )
     , f_graph( initData(&f_graph,"graph","Graph of residuals at each iteration") )
+    , d_nbIterations( initData(&d_nbIterations, 0u, "nbIterations", "Number of iterations of the last solve", true, true) )
+    , d_preconditionerTime( initData(&d_preconditionerTime, 0., "preconditionerTime", "Time (ms) spent in the update and the application of the preconditioner during the last solve", true, true) )
     , next_refresh_step(0)
     , newton_iter(0)
 {
@@ -71,16 +73,9 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::init()
         }
         else
         {
-            if (l_preconditioner.get()->getTemplateName() == "GraphScattered")
-            {
-                msg_error() << "Can not use the preconditioner " << l_preconditioner.get()->getName() << " because it is templated on GraphScatteredType";
-                sofa::core::objectmodel::BaseObject::d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
-                return;
-            }
-            else
-            {
-                msg_info() << "Preconditioner path used: '" << l_preconditioner.getLinkedPath() << "'";
-            }
+            // a preconditioner templated on GraphScatteredType is matrix-free: it is applied directly on the
+            // vectors of the mechanical states, without assembling the system
+            msg_info() << "Preconditioner path used: '" << l_preconditioner.getLinkedPath() << "'";
         }
     }
 
@@ -100,6 +95,9 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::setSystemMBKMatrix(const core::Me
 
     if (l_preconditioner.get()==nullptr) return;
 
+    using sofa::helper::system::thread::CTime;
+    const auto startTicks = CTime::getRefTime();
+
     if (first) //We initialize all the preconditioners for the first step
     {
         l_preconditioner.get()->setSystemMBKMatrix(mparams);
@@ -126,6 +124,8 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::setSystemMBKMatrix(const core::Me
     }
 
     l_preconditioner.get()->updateSystemMatrix();
+
+    m_preconditionerTicks += CTime::getRefTime() - startTicks;
 }
 
 template<>
@@ -184,7 +184,9 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::solve (Matrix& M, Vector& x, Vect
         SCOPED_TIMER_VARNAME(applyPrecondTimer, "PCGLinearSolver::apply Precond");
         l_preconditioner.get()->setSystemLHVector(w);
         l_preconditioner.get()->setSystemRHVector(r);
+        const auto startTicks = sofa::helper::system::thread::CTime::getRefTime();
         l_preconditioner.get()->solveSystem();
+        m_preconditionerTicks += sofa::helper::system::thread::CTime::getRefTime() - startTicks;
     }
     else
     {
@@ -209,7 +211,9 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::solve (Matrix& M, Vector& x, Vect
             SCOPED_TIMER_VARNAME(applyPrecondTimer, "PCGLinearSolver::apply Precond");
             l_preconditioner.get()->setSystemLHVector(s);
             l_preconditioner.get()->setSystemRHVector(r);
+            const auto startTicks = sofa::helper::system::thread::CTime::getRefTime();
             l_preconditioner.get()->solveSystem();
+            m_preconditionerTicks += sofa::helper::system::thread::CTime::getRefTime() - startTicks;
         }
         else
         {
@@ -234,6 +238,14 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::solve (Matrix& M, Vector& x, Vect
     vtmp.deleteTempVector(&s);
 
     sofa::helper::AdvancedTimer::valSet("PCG iterations", iter);
+
+    d_nbIterations.setValue(iter - 1);
+    d_preconditionerTime.setValue(1000. * static_cast<double>(m_preconditionerTicks)
+                                  / static_cast<double>(sofa::helper::system::thread::CTime::getRefTicksPerSec()));
+    m_preconditionerTicks = 0;
+
+    msg_info() << "Solved in " << d_nbIterations.getValue() << " iterations (residual " << r_norm / b_norm
+               << "), " << d_preconditionerTime.getValue() << " ms in the preconditioner";
 }
 
 } // namespace sofa::component::linearsolver::iterative
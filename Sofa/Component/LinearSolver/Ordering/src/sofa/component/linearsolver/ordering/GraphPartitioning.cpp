@@ -0,0 +1,158 @@
+﻿/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/linearsolver/ordering/GraphPartitioning.h>
+
+#include <algorithm>
+
+namespace sofa::component::linearsolver::ordering
+{
+
+namespace
+{
+
+/// Set of vertices to split into a given number of consecutive parts
+struct PartitionRange
+{
+    sofa::type::vector<int> vertices;
+    int firstPart;
+    unsigned int nbParts;
+};
+
+/**
+ * Breadth-first search restricted to the vertices marked with the given stamp.
+ * All the connected components of the restricted graph are traversed, starting
+ * with the component of the start vertex.
+ */
+void breadthFirstOrder(
+    const core::behavior::BaseOrderingMethod::SparseMatrixPattern& pattern,
+    const sofa::type::vector<int>& vertices, int start, int stamp,
+    sofa::type::vector<int>& mark, sofa::type::vector<int>& order)
+{
+    order.clear();
+    order.reserve(vertices.size());
+
+    auto visit = [&](int root)
+    {
+        std::size_t front = order.size();
+        mark[root] = -stamp;
+        order.push_back(root);
+        while (front < order.size())
+        {
+            const int v = order[front++];
+            for (int k = pattern.rowBegin[v]; k < pattern.rowBegin[v + 1]; ++k)
+            {
+                const int w = pattern.colsIndex[k];
+                if (mark[w] == stamp)
+                {
+                    mark[w] = -stamp;
+                    order.push_back(w);
+                }
+            }
+        }
+    };
+
+    visit(start);
+    for (const int v : vertices)
+    {
+        if (mark[v] == stamp)
+        {
+            visit(v);
+        }
+    }
+
+    // restore the marks for a next traversal of the same set
+    for (const int v : vertices)
+    {
+        mark[v] = stamp;
+    }
+}
+
+}
+
+void partitionGraph(
+    const core::behavior::BaseOrderingMethod::SparseMatrixPattern& inPattern,
+    unsigned int nbParts,
+    sofa::type::vector<int>& outPart)
+{
+    const int n = inPattern.matrixSize;
+    outPart.assign(n, 0);
+    if (n == 0 || nbParts <= 1)
+    {
+        return;
+    }
+
+    // mark[v] identifies the range containing v. Stamps start at 1 so that
+    // their opposite can be used to flag the visited vertices.
+    sofa::type::vector<int> mark(n, 1);
+    int nextStamp = 1;
+
+    sofa::type::vector<PartitionRange> stack;
+    stack.push_back({{}, 0, nbParts});
+    stack.back().vertices.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+        stack.back().vertices[i] = i;
+    }
+
+    sofa::type::vector<int> order;
+    while (!stack.empty())
+    {
+        PartitionRange range = std::move(stack.back());
+        stack.pop_back();
+
+        if (range.nbParts <= 1 || range.vertices.size() <= 1)
+        {
+            for (const int v : range.vertices)
+            {
+                outPart[v] = range.firstPart;
+            }
+            continue;
+        }
+
+        const int stamp = nextStamp++;
+        for (const int v : range.vertices)
+        {
+            mark[v] = stamp;
+        }
+
+        // the last vertex reached by a traversal is far from the start: two
+        // traversals give a pseudo-peripheral vertex
+        int start = range.vertices.front();
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            breadthFirstOrder(inPattern, range.vertices, start, stamp, mark, order);
+            start = order.back();
+        }
+        breadthFirstOrder(inPattern, range.vertices, start, stamp, mark, order);
+
+        const unsigned int firstHalfParts = range.nbParts / 2;
+        const std::size_t firstHalfSize = order.size() * firstHalfParts / range.nbParts;
+
+        PartitionRange firstHalf { {order.begin(), order.begin() + firstHalfSize}, range.firstPart, firstHalfParts };
+        PartitionRange secondHalf { {order.begin() + firstHalfSize, order.end()}, range.firstPart + static_cast<int>(firstHalfParts), range.nbParts - firstHalfParts };
+
+        stack.push_back(std::move(firstHalf));
+        stack.push_back(std::move(secondHalf));
+    }
+}
+
+}
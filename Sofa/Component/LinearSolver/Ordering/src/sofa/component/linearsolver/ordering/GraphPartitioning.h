@@ -0,0 +1,49 @@
+﻿/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/linearsolver/ordering/config.h>
+#include <sofa/core/behavior/BaseOrderingMethod.h>
+#include <sofa/type/vector.h>
+
+namespace sofa::component::linearsolver::ordering
+{
+
+/**
+ * Partition the adjacency graph of a sparse matrix into parts of balanced sizes.
+ *
+ * The graph is split by recursive bisection: the vertices of a part are sorted
+ * by a breadth-first search started from a pseudo-peripheral vertex, and the
+ * part is cut along this level structure, which keeps the parts compact and the
+ * number of cut edges low on meshes. The pattern is expected to be symmetric.
+ *
+ * \param inPattern The sparse matrix pattern as an input
+ * \param nbParts The number of requested parts
+ * \param outPart The index of the part of each row of the matrix, in [0, nbParts[
+ */
+SOFA_COMPONENT_LINEARSOLVER_ORDERING_API
+void partitionGraph(
+    const core::behavior::BaseOrderingMethod::SparseMatrixPattern& inPattern,
+    unsigned int nbParts,
+    sofa::type::vector<int>& outPart);
+
+}
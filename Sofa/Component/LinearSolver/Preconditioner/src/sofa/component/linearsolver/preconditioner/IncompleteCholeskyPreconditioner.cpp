@@ -0,0 +1,39 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_INCOMPLETECHOLESKYPRECONDITIONER_CPP
+#include <sofa/component/linearsolver/preconditioner/IncompleteCholeskyPreconditioner.inl>
+#include <sofa/core/ObjectFactory.h>
+
+namespace sofa::component::linearsolver::preconditioner
+{
+
+using namespace sofa::linearalgebra;
+
+int IncompleteCholeskyPreconditionerClass = core::RegisterObject("Linear system solver / preconditioner based on an incomplete Cholesky factorization without fill-in (IC(0)), computed and applied level by level.")
+        .add< IncompleteCholeskyPreconditioner< CompressedRowSparseMatrix<SReal>, FullVector<SReal> > >(true)
+        .add< IncompleteCholeskyPreconditioner< CompressedRowSparseMatrix< type::Mat<3,3,SReal> >, FullVector<SReal> > >()
+        ;
+
+template class SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_API IncompleteCholeskyPreconditioner< CompressedRowSparseMatrix<SReal>, FullVector<SReal> >;
+template class SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_API IncompleteCholeskyPreconditioner< CompressedRowSparseMatrix< type::Mat<3,3,SReal> >, FullVector<SReal> >;
+
+} // namespace sofa::component::linearsolver::preconditioner
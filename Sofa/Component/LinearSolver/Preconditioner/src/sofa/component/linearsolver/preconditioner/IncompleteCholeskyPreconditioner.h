@@ -0,0 +1,109 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/preconditioner/config.h>
+
+#include <sofa/component/linearsolver/iterative/MatrixLinearSolver.h>
+#include <sofa/component/linearsolver/preconditioner/ScalarSparseMatrix.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+namespace sofa::component::linearsolver::preconditioner
+{
+
+/**
+ * Linear solver / preconditioner based on an incomplete Cholesky factorization without fill-in, IC(0).
+ *
+ * The factor L has the sparsity pattern of the lower triangular part of the matrix, and A ~ L L^T.
+ * If the factorization breaks down (non-positive pivot), it is computed again on A + shift * diag(A),
+ * the shift being increased until the factorization succeeds.
+ *
+ * The rows are grouped in levels: the rows of a level only depend on rows of the previous levels.
+ * The factorization and the triangular solves process the rows of a level in parallel.
+ * The levels and the pattern of the factor are kept while the sparsity pattern of the matrix does
+ * not change, only the numerical factorization is computed at each update of the preconditioner.
+ */
+template<class TMatrix, class TVector>
+class IncompleteCholeskyPreconditioner : public sofa::component::linearsolver::MatrixLinearSolver<TMatrix, TVector>
+{
+public:
+    SOFA_CLASS(SOFA_TEMPLATE2(IncompleteCholeskyPreconditioner,TMatrix,TVector),SOFA_TEMPLATE2(sofa::component::linearsolver::MatrixLinearSolver,TMatrix,TVector));
+
+    using Matrix = TMatrix;
+    using Vector = TVector;
+    using Real = typename Matrix::Real;
+    using Inherit = sofa::component::linearsolver::MatrixLinearSolver<TMatrix, TVector>;
+
+    Data<Real> d_shift; ///< Initial relative diagonal shift: A + shift * diag(A) is factorized
+    Data<bool> d_multithreading; ///< Process the rows of a level in parallel, in the factorization and in the triangular solves
+    Data<Real> d_appliedShift; ///< Relative diagonal shift used by the last factorization
+
+    void init() override;
+    void solve(Matrix& M, Vector& x, Vector& b) override;
+    void invert(Matrix& M) override;
+
+protected:
+    IncompleteCholeskyPreconditioner();
+
+    /// Pattern of the factor and levels, built when the sparsity pattern of the matrix changes
+    void buildSymbolicFactorization();
+
+    /// Return false if a non-positive pivot is found
+    bool numericFactorization(Real shift);
+
+    /// Call f(row) for the rows of each level, the levels being processed in order
+    template<class F>
+    void forEachRowByLevel(const sofa::type::vector<int>& levelBegin, const sofa::type::vector<int>& rows, F f);
+
+    ScalarSparseMatrix<Matrix> m_matrix;
+
+    /// Factor L, stored by rows. The diagonal is the last entry of each row.
+    sofa::type::vector<int> m_lowerBegin;
+    sofa::type::vector<int> m_lowerCols;
+    sofa::type::vector<Real> m_lowerValues;
+    /// Index of each entry of L in the values of the scalar matrix
+    sofa::type::vector<int> m_lowerSource;
+
+    /// L^T, stored by rows, as indices in the values of L. The diagonal is the first entry of each row.
+    sofa::type::vector<int> m_upperBegin;
+    sofa::type::vector<int> m_upperCols;
+    sofa::type::vector<int> m_upperFromLower;
+
+    /// Rows ordered by level, for the factorization and the forward substitution
+    sofa::type::vector<int> m_forwardLevelBegin;
+    sofa::type::vector<int> m_forwardRows;
+    /// Rows ordered by level, for the backward substitution
+    sofa::type::vector<int> m_backwardLevelBegin;
+    sofa::type::vector<int> m_backwardRows;
+
+    sofa::type::vector<Real> m_tmp;
+
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+    bool m_isFactorized { false };
+};
+
+#if !defined(SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_INCOMPLETECHOLESKYPRECONDITIONER_CPP)
+extern template class SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_API IncompleteCholeskyPreconditioner< linearalgebra::CompressedRowSparseMatrix<SReal>, linearalgebra::FullVector<SReal> >;
+extern template class SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_API IncompleteCholeskyPreconditioner< linearalgebra::CompressedRowSparseMatrix< type::Mat<3, 3, SReal> >, linearalgebra::FullVector<SReal> >;
+#endif // !defined(SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_INCOMPLETECHOLESKYPRECONDITIONER_CPP)
+
+} // namespace sofa::component::linearsolver::preconditioner
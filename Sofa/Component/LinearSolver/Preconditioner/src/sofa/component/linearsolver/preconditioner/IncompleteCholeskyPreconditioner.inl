@@ -0,0 +1,341 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/preconditioner/IncompleteCholeskyPreconditioner.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+
+#include <atomic>
+#include <cmath>
+
+namespace sofa::component::linearsolver::preconditioner
+{
+
+template<class TMatrix, class TVector>
+IncompleteCholeskyPreconditioner<TMatrix,TVector>::IncompleteCholeskyPreconditioner()
+    : d_shift(initData(&d_shift, static_cast<Real>(0), "shift", "Initial relative diagonal shift: A + shift * diag(A) is factorized. "
+                                                                 "The shift is increased if the factorization breaks down."))
+    , d_multithreading(initData(&d_multithreading, false, "multithreading", "Process the independent rows in parallel, in the factorization and in the triangular solves"))
+    , d_appliedShift(initData(&d_appliedShift, static_cast<Real>(0), "appliedShift", "Relative diagonal shift used by the last factorization", true, true))
+{
+}
+
+template<class TMatrix, class TVector>
+void IncompleteCholeskyPreconditioner<TMatrix,TVector>::init()
+{
+    Inherit1::init();
+
+    m_taskScheduler = nullptr;
+    if (d_multithreading.getValue())
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+}
+
+template<class TMatrix, class TVector>
+template<class F>
+void IncompleteCholeskyPreconditioner<TMatrix,TVector>::forEachRowByLevel(
+    const sofa::type::vector<int>& levelBegin, const sofa::type::vector<int>& rows, F f)
+{
+    // below this number of rows, a level is processed in the calling thread
+    static constexpr int minNbRowsPerParallelLevel = 256;
+
+    for (std::size_t l = 0; l + 1 < levelBegin.size(); ++l)
+    {
+        const int begin = levelBegin[l];
+        const int end = levelBegin[l + 1];
+        if (m_taskScheduler && end - begin >= minNbRowsPerParallelLevel)
+        {
+            simulation::parallelForEachRange(*m_taskScheduler, begin, end,
+                [&rows, &f](const auto& range)
+                {
+                    for (auto r = range.start; r != range.end; ++r)
+                    {
+                        f(rows[r]);
+                    }
+                });
+        }
+        else
+        {
+            for (int r = begin; r < end; ++r)
+            {
+                f(rows[r]);
+            }
+        }
+    }
+}
+
+/// Group the rows by level, level[i] being the level of the row i
+inline void sortRowsByLevel(const sofa::type::vector<int>& level,
+                                   sofa::type::vector<int>& levelBegin, sofa::type::vector<int>& rows)
+{
+    const int nbLevels = level.empty() ? 0 : *std::max_element(level.begin(), level.end()) + 1;
+    levelBegin.assign(nbLevels + 1, 0);
+    for (const int l : level)
+    {
+        ++levelBegin[l + 1];
+    }
+    for (int l = 0; l < nbLevels; ++l)
+    {
+        levelBegin[l + 1] += levelBegin[l];
+    }
+
+    rows.resize(level.size());
+    sofa::type::vector<int> next(levelBegin.begin(), levelBegin.end() - 1);
+    for (std::size_t i = 0; i < level.size(); ++i)
+    {
+        rows[next[level[i]]++] = static_cast<int>(i);
+    }
+}
+
+template<class TMatrix, class TVector>
+void IncompleteCholeskyPreconditioner<TMatrix,TVector>::buildSymbolicFactorization()
+{
+    SCOPED_TIMER_VARNAME(symbolicTimer, "IncompleteCholesky::symbolicFactorization");
+
+    const auto& A = m_matrix.matrix();
+    const int n = static_cast<int>(A.rows());
+    const int* outer = A.outerIndexPtr();
+    const int* inner = A.innerIndexPtr();
+
+    // lower triangular pattern, the diagonal being the last entry of each row
+    m_lowerBegin.resize(n + 1);
+    m_lowerCols.clear();
+    m_lowerSource.clear();
+    for (int i = 0; i < n; ++i)
+    {
+        m_lowerBegin[i] = static_cast<int>(m_lowerCols.size());
+        int diagonal = -1;
+        for (int e = outer[i]; e < outer[i + 1]; ++e)
+        {
+            const int j = inner[e];
+            if (j < i)
+            {
+                m_lowerCols.push_back(j);
+                m_lowerSource.push_back(e);
+            }
+            else if (j == i)
+            {
+                diagonal = e;
+            }
+        }
+        // a missing diagonal is considered as a zero entry
+        m_lowerCols.push_back(i);
+        m_lowerSource.push_back(diagonal);
+    }
+    m_lowerBegin[n] = static_cast<int>(m_lowerCols.size());
+    m_lowerValues.resize(m_lowerCols.size());
+
+    // transposed pattern: the entries of each column of L, sorted by row
+    m_upperBegin.assign(n + 1, 0);
+    for (const int j : m_lowerCols)
+    {
+        ++m_upperBegin[j + 1];
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        m_upperBegin[i + 1] += m_upperBegin[i];
+    }
+    m_upperCols.resize(m_lowerCols.size());
+    m_upperFromLower.resize(m_lowerCols.size());
+    {
+        sofa::type::vector<int> next(m_upperBegin.begin(), m_upperBegin.end() - 1);
+        for (int i = 0; i < n; ++i)
+        {
+            for (int p = m_lowerBegin[i]; p < m_lowerBegin[i + 1]; ++p)
+            {
+                const int u = next[m_lowerCols[p]]++;
+                m_upperCols[u] = i;
+                m_upperFromLower[u] = p;
+            }
+        }
+    }
+
+    // levels: a row depends on the rows of its off-diagonal entries
+    sofa::type::vector<int> level(n, 0);
+    for (int i = 0; i < n; ++i)
+    {
+        for (int p = m_lowerBegin[i]; p < m_lowerBegin[i + 1] - 1; ++p)
+        {
+            level[i] = std::max(level[i], level[m_lowerCols[p]] + 1);
+        }
+    }
+    sortRowsByLevel(level, m_forwardLevelBegin, m_forwardRows);
+
+    std::fill(level.begin(), level.end(), 0);
+    for (int i = n - 1; i >= 0; --i)
+    {
+        for (int u = m_upperBegin[i] + 1; u < m_upperBegin[i + 1]; ++u)
+        {
+            level[i] = std::max(level[i], level[m_upperCols[u]] + 1);
+        }
+    }
+    sortRowsByLevel(level, m_backwardLevelBegin, m_backwardRows);
+
+    m_tmp.resize(n);
+
+    msg_info() << "Symbolic factorization: " << n << " rows, " << m_lowerCols.size() << " non-zeros in the factor, "
+               << m_forwardLevelBegin.size() - 1 << " levels in the forward substitution, "
+               << m_backwardLevelBegin.size() - 1 << " levels in the backward substitution";
+}
+
+template<class TMatrix, class TVector>
+bool IncompleteCholeskyPreconditioner<TMatrix,TVector>::numericFactorization(const Real shift)
+{
+    const Real* a = m_matrix.matrix().valuePtr();
+    std::atomic<bool> success { true };
+
+    forEachRowByLevel(m_forwardLevelBegin, m_forwardRows, [this, a, shift, &success](const int i)
+    {
+        const int begin = m_lowerBegin[i];
+        const int diagonal = m_lowerBegin[i + 1] - 1;
+
+        for (int e = begin; e < diagonal; ++e)
+        {
+            const int j = m_lowerCols[e];
+            const int jDiagonal = m_lowerBegin[j + 1] - 1;
+
+            // L(i,j) = (A(i,j) - sum_k L(i,k) L(j,k)) / L(j,j), k < j
+            Real s = a[m_lowerSource[e]];
+            int p = begin;
+            int q = m_lowerBegin[j];
+            while (p < e && q < jDiagonal)
+            {
+                const int cp = m_lowerCols[p];
+                const int cq = m_lowerCols[q];
+                if (cp == cq)
+                {
+                    s -= m_lowerValues[p++] * m_lowerValues[q++];
+                }
+                else if (cp < cq)
+                {
+                    ++p;
+                }
+                else
+                {
+                    ++q;
+                }
+            }
+            m_lowerValues[e] = s / m_lowerValues[jDiagonal];
+        }
+
+        // L(i,i) = sqrt(A(i,i) - sum_k L(i,k)^2)
+        const Real aii = m_lowerSource[diagonal] < 0 ? 0 : a[m_lowerSource[diagonal]] * (1 + shift);
+        Real s = aii;
+        for (int p = begin; p < diagonal; ++p)
+        {
+            s -= m_lowerValues[p] * m_lowerValues[p];
+        }
+
+        if (!(s > std::numeric_limits<Real>::epsilon() * std::abs(aii)))
+        {
+            success = false;
+            s = 1;
+        }
+        m_lowerValues[diagonal] = std::sqrt(s);
+    });
+
+    return success;
+}
+
+template<class TMatrix, class TVector>
+void IncompleteCholeskyPreconditioner<TMatrix,TVector>::invert(Matrix& M)
+{
+    SCOPED_TIMER_VARNAME(factorizationTimer, "IncompleteCholesky::factorization");
+
+    if (m_matrix.update(M))
+    {
+        buildSymbolicFactorization();
+    }
+
+    static constexpr unsigned int maxNbAttempts = 20;
+
+    Real shift = std::max(d_shift.getValue(), static_cast<Real>(0));
+    m_isFactorized = false;
+    for (unsigned int attempt = 0; attempt < maxNbAttempts && !m_isFactorized; ++attempt)
+    {
+        m_isFactorized = numericFactorization(shift);
+        if (!m_isFactorized)
+        {
+            shift = shift > 0 ? 2 * shift : static_cast<Real>(1e-3);
+        }
+    }
+
+    if (m_isFactorized)
+    {
+        msg_info_when(shift != d_shift.getValue()) << "The factorization broke down, the diagonal shift has been increased to " << shift;
+        d_appliedShift.setValue(shift);
+    }
+    else
+    {
+        msg_error() << "The incomplete factorization failed, the preconditioner is not applied. "
+                       "The matrix may not be symmetric positive definite.";
+    }
+}
+
+template<class TMatrix, class TVector>
+void IncompleteCholeskyPreconditioner<TMatrix,TVector>::solve(Matrix& M, Vector& z, Vector& r)
+{
+    SOFA_UNUSED(M);
+    SCOPED_TIMER_VARNAME(solveTimer, "IncompleteCholesky::solve");
+
+    const int n = static_cast<int>(m_tmp.size());
+    if (!m_isFactorized || static_cast<int>(r.size()) != n)
+    {
+        z = r;
+        return;
+    }
+
+    // L y = r
+    Real* y = m_tmp.data();
+    forEachRowByLevel(m_forwardLevelBegin, m_forwardRows, [this, y, &r](const int i)
+    {
+        const int diagonal = m_lowerBegin[i + 1] - 1;
+        Real s = r[i];
+        for (int p = m_lowerBegin[i]; p < diagonal; ++p)
+        {
+            s -= m_lowerValues[p] * y[m_lowerCols[p]];
+        }
+        y[i] = s / m_lowerValues[diagonal];
+    });
+
+    // L^T z = y
+    forEachRowByLevel(m_backwardLevelBegin, m_backwardRows, [this, y, &z](const int i)
+    {
+        const int diagonal = m_upperFromLower[m_upperBegin[i]];
+        Real s = y[i];
+        for (int u = m_upperBegin[i] + 1; u < m_upperBegin[i + 1]; ++u)
+        {
+            s -= m_lowerValues[m_upperFromLower[u]] * z[m_upperCols[u]];
+        }
+        z[i] = s / m_lowerValues[diagonal];
+    });
+}
+
+} // namespace sofa::component::linearsolver::preconditioner
@@ -0,0 +1,134 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/preconditioner/config.h>
+
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/type/vector.h>
+#include <Eigen/SparseCore>
+
+namespace sofa::component::linearsolver::preconditioner
+{
+
+/**
+ * Scalar copy of an assembled CompressedRowSparseMatrix, stored as a row-major Eigen sparse matrix.
+ *
+ * For each scalar entry, the copy stores the location of its value in the blocks of the
+ * source matrix. As long as the sparsity pattern of the source matrix does not change,
+ * the values are gathered without rebuilding the pattern.
+ */
+template<class TMatrix>
+class ScalarSparseMatrix
+{
+public:
+    using Matrix = TMatrix;
+    using Real = typename Matrix::Real;
+    using Block = typename Matrix::Block;
+    using EigenMatrix = Eigen::SparseMatrix<Real, Eigen::RowMajor, int>;
+
+    static constexpr sofa::Size NL = Matrix::NL;
+    static constexpr sofa::Size NC = Matrix::NC;
+
+    static_assert(sizeof(Block) == NL * NC * sizeof(Real), "The blocks must be stored as contiguous scalars");
+
+    /// Copy the values of M. Return true if the sparsity pattern of M changed since the previous call.
+    bool update(Matrix& M)
+    {
+        M.compress();
+
+        const bool patternChanged = m_matrix.rows() != static_cast<Eigen::Index>(M.rowSize())
+            || m_rowIndex != M.rowIndex || m_rowBegin != M.rowBegin || m_colsIndex != M.colsIndex;
+
+        if (patternChanged)
+        {
+            buildPattern(M);
+        }
+
+        const Real* blockValues = reinterpret_cast<const Real*>(M.colsValue.data());
+        Real* values = m_matrix.valuePtr();
+        for (std::size_t e = 0; e < m_sourceIndex.size(); ++e)
+        {
+            values[e] = blockValues[m_sourceIndex[e]];
+        }
+
+        return patternChanged;
+    }
+
+    const EigenMatrix& matrix() const { return m_matrix; }
+
+protected:
+
+    void buildPattern(const Matrix& M)
+    {
+        m_rowIndex = M.rowIndex;
+        m_rowBegin = M.rowBegin;
+        m_colsIndex = M.colsIndex;
+
+        const auto n = static_cast<Eigen::Index>(M.rowSize());
+        const std::size_t nnz = M.colsValue.size() * NL * NC;
+
+        m_matrix.resize(n, static_cast<Eigen::Index>(M.colSize()));
+        m_matrix.resizeNonZeros(static_cast<Eigen::Index>(nnz));
+        m_sourceIndex.resize(nnz);
+
+        int* outer = m_matrix.outerIndexPtr();
+        int* inner = m_matrix.innerIndexPtr();
+
+        // the blocks of a row are sorted by column, and so are the scalars of a scalar row
+        std::size_t e = 0;
+        Eigen::Index row = 0;
+        for (std::size_t xi = 0; xi < M.rowIndex.size(); ++xi)
+        {
+            const auto blockRow = static_cast<Eigen::Index>(M.rowIndex[xi]);
+            for (sofa::Size bi = 0; bi < NL; ++bi)
+            {
+                const Eigen::Index scalarRow = blockRow * NL + bi;
+                for (; row <= scalarRow; ++row)
+                {
+                    outer[row] = static_cast<int>(e);
+                }
+
+                for (auto k = M.rowBegin[xi]; k < M.rowBegin[xi + 1]; ++k)
+                {
+                    for (sofa::Size bj = 0; bj < NC; ++bj)
+                    {
+                        inner[e] = static_cast<int>(M.colsIndex[k] * NC + bj);
+                        m_sourceIndex[e] = static_cast<std::size_t>(k) * NL * NC + bi * NC + bj;
+                        ++e;
+                    }
+                }
+            }
+        }
+        for (; row <= n; ++row)
+        {
+            outer[row] = static_cast<int>(e);
+        }
+    }
+
+    EigenMatrix m_matrix;
+    sofa::type::vector<std::size_t> m_sourceIndex;
+
+    /// pattern of the source matrix when the copy was built
+    typename Matrix::VecIndex m_rowIndex, m_rowBegin, m_colsIndex;
+};
+
+} // namespace sofa::component::linearsolver::preconditioner
@@ -0,0 +1,141 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/preconditioner/config.h>
+
+#include <sofa/component/linearsolver/iterative/MatrixLinearSolver.h>
+#include <sofa/component/linearsolver/preconditioner/ScalarSparseMatrix.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <Eigen/Dense>
+#include <Eigen/SparseCholesky>
+
+namespace sofa::component::linearsolver::preconditioner
+{
+
+/**
+ * Linear system solver / preconditioner based on a smoothed aggregation algebraic multigrid (AMG).
+ * One application of the preconditioner is a V-cycle with damped Jacobi smoothing, the coarsest
+ * level being solved with a sparse LDL^T factorization.
+ *
+ * The nodes (3x3 blocks) of the matrix are grouped in aggregates following the strength of their
+ * connections. The tentative prolongator of each aggregate interpolates the near null space of
+ * the operator: the rigid body modes (translations and rotations) when the positions of the nodes
+ * are available in the mechanical state of the context, the translations otherwise.
+ * The prolongator is then smoothed with one Jacobi iteration.
+ *
+ * The aggregates and the tentative prolongators are kept while the sparsity pattern of the matrix
+ * does not change: only the smoothed prolongators and the coarse operators are computed again at
+ * each update of the preconditioner.
+ */
+template<class TMatrix, class TVector>
+class SmoothedAggregationPreconditioner : public sofa::component::linearsolver::MatrixLinearSolver<TMatrix, TVector>
+{
+public:
+    SOFA_CLASS(SOFA_TEMPLATE2(SmoothedAggregationPreconditioner,TMatrix,TVector),SOFA_TEMPLATE2(sofa::component::linearsolver::MatrixLinearSolver,TMatrix,TVector));
+
+    using Matrix = TMatrix;
+    using Vector = TVector;
+    using Real = typename Matrix::Real;
+    using Inherit = sofa::component::linearsolver::MatrixLinearSolver<TMatrix, TVector>;
+    using EigenMatrix = typename ScalarSparseMatrix<Matrix>::EigenMatrix;
+    using DenseMatrix = Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic>;
+
+    Data<Real> d_strengthThreshold; ///< Two nodes are strongly connected if |A_ij| >= threshold * sqrt(|A_ii| |A_jj|) (Frobenius norms of the blocks)
+    Data<unsigned int> d_maxCoarseSize; ///< The coarsening stops when the number of unknowns is below this value
+    Data<unsigned int> d_maxNbLevels; ///< Maximum number of levels of the hierarchy
+    Data<unsigned int> d_nbSmoothingSteps; ///< Number of Jacobi iterations before and after the coarse correction
+    Data<Real> d_smootherDamping; ///< Damping factor of the Jacobi smoother
+    Data<bool> d_rigidBodyModes; ///< Use the rigid body modes as near null space, if the positions of the nodes are available
+    Data<bool> d_multithreading; ///< Compute the matrix-vector products and the smoothing in parallel
+    Data<unsigned int> d_nbLevels; ///< Number of levels of the hierarchy
+    Data<Real> d_operatorComplexity; ///< Sum of the non-zeros of the operators of all levels, divided by the non-zeros of the matrix
+
+    void init() override;
+    void solve(Matrix& M, Vector& x, Vector& b) override;
+    void invert(Matrix& M) override;
+
+protected:
+    SmoothedAggregationPreconditioner();
+
+    struct Level
+    {
+        /// Operator of the level (unused for the finest level, which is the scalar copy of the matrix)
+        EigenMatrix A;
+        sofa::type::vector<Real> invDiagonal;
+
+        /// Prolongator from the next level to this level, and its transpose
+        EigenMatrix tentativeProlongator;
+        EigenMatrix prolongator;
+        EigenMatrix restriction;
+
+        sofa::type::vector<Real> x, b, r;
+    };
+
+    const EigenMatrix& levelOperator(std::size_t l) const;
+
+    /// Aggregation and tentative prolongators: built when the sparsity pattern of the matrix changes
+    void buildHierarchy();
+
+    /// Smoothed prolongators and coarse operators, from the operator of each level
+    void updateOperators();
+
+    /// Smoothed prolongator of the level l, and operator of the level l+1
+    void computeCoarseOperator(std::size_t l);
+
+    void factorizeCoarsestLevel(bool analyzePattern);
+
+    /// Near null space of the finest level, one column per mode
+    void computeNearNullSpace(DenseMatrix& B) const;
+
+    /// Group the nodes in aggregates. Return the number of aggregates.
+    /// The nodes without strong connection are not aggregated (aggregate -1).
+    int aggregateNodes(const EigenMatrix& A, const sofa::type::vector<int>& nodeBegin, sofa::type::vector<int>& aggregate) const;
+
+    /// Tentative prolongator interpolating B on each aggregate, and the near null space of the coarse level
+    static void buildTentativeProlongator(const sofa::type::vector<int>& nodeBegin, const sofa::type::vector<int>& aggregate, int nbAggregates,
+                                          const DenseMatrix& B, EigenMatrix& T, DenseMatrix& coarseB, sofa::type::vector<int>& coarseNodeBegin);
+
+    void vcycle(std::size_t l);
+    void smooth(std::size_t l, unsigned int nbSteps);
+
+    /// y = M x, the rows being computed in parallel
+    void multiply(const EigenMatrix& M, const Real* x, Real* y);
+
+    template<class F>
+    void forEachRow(int n, F f);
+
+    ScalarSparseMatrix<Matrix> m_matrix;
+    std::vector<Level> m_levels;
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<Real> > m_coarseSolver;
+    Eigen::SparseMatrix<Real> m_coarseMatrix;
+    bool m_isCoarseSolverValid { false };
+
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+};
+
+#if !defined(SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_SMOOTHEDAGGREGATIONPRECONDITIONER_CPP)
+extern template class SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_API SmoothedAggregationPreconditioner< linearalgebra::CompressedRowSparseMatrix< type::Mat<3, 3, SReal> >, linearalgebra::FullVector<SReal> >;
+#endif // !defined(SOFA_COMPONENT_LINEARSOLVER_PRECONDITIONER_SMOOTHEDAGGREGATIONPRECONDITIONER_CPP)
+
+} // namespace sofa::component::linearsolver::preconditioner
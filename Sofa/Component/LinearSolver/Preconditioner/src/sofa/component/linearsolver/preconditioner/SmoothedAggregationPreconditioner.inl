@@ -0,0 +1,740 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/linearsolver/preconditioner/SmoothedAggregationPreconditioner.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/core/objectmodel/BaseContext.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+
+#include <cmath>
+
+namespace sofa::component::linearsolver::preconditioner
+{
+
+template<class TMatrix, class TVector>
+SmoothedAggregationPreconditioner<TMatrix,TVector>::SmoothedAggregationPreconditioner()
+    : d_strengthThreshold(initData(&d_strengthThreshold, static_cast<Real>(0.08), "strengthThreshold", "Two nodes are strongly connected if |A_ij| >= threshold * sqrt(|A_ii| |A_jj|), using the Frobenius norms of the blocks"))
+    , d_maxCoarseSize(initData(&d_maxCoarseSize, 500u, "maxCoarseSize", "The coarsening stops when the number of unknowns is below this value"))
+    , d_maxNbLevels(initData(&d_maxNbLevels, 10u, "maxNbLevels", "Maximum number of levels of the hierarchy"))
+    , d_nbSmoothingSteps(initData(&d_nbSmoothingSteps, 1u, "nbSmoothingSteps", "Number of Jacobi iterations before and after the coarse correction"))
+    , d_smootherDamping(initData(&d_smootherDamping, static_cast<Real>(2. / 3.), "smootherDamping", "Damping factor of the Jacobi smoother"))
+    , d_rigidBodyModes(initData(&d_rigidBodyModes, true, "rigidBodyModes", "Use the rigid body modes (translations and rotations) as near null space, "
+                                                                           "if the positions of the nodes are available in the mechanical state. Otherwise, only the translations are used."))
+    , d_multithreading(initData(&d_multithreading, false, "multithreading", "Compute the matrix-vector products and the smoothing in parallel"))
+    , d_nbLevels(initData(&d_nbLevels, 0u, "nbLevels", "Number of levels of the hierarchy", true, true))
+    , d_operatorComplexity(initData(&d_operatorComplexity, static_cast<Real>(0), "operatorComplexity", "Sum of the non-zeros of the operators of all levels, divided by the non-zeros of the matrix", true, true))
+{
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::init()
+{
+    Inherit1::init();
+
+    m_taskScheduler = nullptr;
+    if (d_multithreading.getValue())
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+}
+
+template<class TMatrix, class TVector>
+template<class F>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::forEachRow(const int n, F f)
+{
+    // below this number of rows, the loop is executed in the calling thread
+    static constexpr int minNbRowsParallel = 2048;
+
+    if (m_taskScheduler && n >= minNbRowsParallel)
+    {
+        simulation::parallelForEachRange(*m_taskScheduler, 0, n,
+            [&f](const auto& range)
+            {
+                for (auto i = range.start; i != range.end; ++i)
+                {
+                    f(i);
+                }
+            });
+    }
+    else
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            f(i);
+        }
+    }
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::multiply(const EigenMatrix& M, const Real* x, Real* y)
+{
+    const int* outer = M.outerIndexPtr();
+    const int* inner = M.innerIndexPtr();
+    const Real* values = M.valuePtr();
+    forEachRow(static_cast<int>(M.rows()), [outer, inner, values, x, y](const int i)
+    {
+        Real s = 0;
+        for (int e = outer[i]; e < outer[i + 1]; ++e)
+        {
+            s += values[e] * x[inner[e]];
+        }
+        y[i] = s;
+    });
+}
+
+template<class TMatrix, class TVector>
+auto SmoothedAggregationPreconditioner<TMatrix,TVector>::levelOperator(const std::size_t l) const -> const EigenMatrix&
+{
+    return l == 0 ? m_matrix.matrix() : m_levels[l].A;
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::computeNearNullSpace(DenseMatrix& B) const
+{
+    static constexpr int NL = Matrix::NL;
+    const auto n = m_matrix.matrix().rows();
+    const auto nbNodes = n / NL;
+
+    const core::behavior::BaseMechanicalState* mstate = this->getContext() ? this->getContext()->getMechanicalState() : nullptr;
+    const bool useRotations = NL == 3 && d_rigidBodyModes.getValue()
+        && mstate != nullptr && static_cast<Eigen::Index>(mstate->getSize()) == nbNodes;
+
+    msg_info_when(d_rigidBodyModes.getValue() && !useRotations) << "The positions of the nodes are not available: "
+        "only the translations are used as near null space";
+
+    B.setZero(n, useRotations ? 6 : NL);
+    for (Eigen::Index i = 0; i < nbNodes; ++i)
+    {
+        for (int d = 0; d < NL; ++d)
+        {
+            B(i * NL + d, d) = 1;
+        }
+    }
+
+    if (useRotations)
+    {
+        // positions relative to the centroid, for the conditioning of the modes
+        type::Vec<3, Real> centroid;
+        for (Eigen::Index i = 0; i < nbNodes; ++i)
+        {
+            centroid += type::Vec<3, Real>(mstate->getPX(i), mstate->getPY(i), mstate->getPZ(i));
+        }
+        centroid /= static_cast<Real>(std::max<Eigen::Index>(nbNodes, 1));
+
+        for (Eigen::Index i = 0; i < nbNodes; ++i)
+        {
+            const type::Vec<3, Real> p = type::Vec<3, Real>(mstate->getPX(i), mstate->getPY(i), mstate->getPZ(i)) - centroid;
+            // rotation around x: e_x ^ p
+            B(3 * i + 1, 3) = -p[2];
+            B(3 * i + 2, 3) = p[1];
+            // rotation around y: e_y ^ p
+            B(3 * i + 0, 4) = p[2];
+            B(3 * i + 2, 4) = -p[0];
+            // rotation around z: e_z ^ p
+            B(3 * i + 0, 5) = -p[1];
+            B(3 * i + 1, 5) = p[0];
+        }
+    }
+}
+
+template<class TMatrix, class TVector>
+int SmoothedAggregationPreconditioner<TMatrix,TVector>::aggregateNodes(
+    const EigenMatrix& A, const sofa::type::vector<int>& nodeBegin, sofa::type::vector<int>& aggregate) const
+{
+    const int nbNodes = static_cast<int>(nodeBegin.size()) - 1;
+    const int* outer = A.outerIndexPtr();
+    const int* inner = A.innerIndexPtr();
+    const Real* values = A.valuePtr();
+
+    sofa::type::vector<int> nodeOf(A.rows());
+    for (int i = 0; i < nbNodes; ++i)
+    {
+        for (int r = nodeBegin[i]; r < nodeBegin[i + 1]; ++r)
+        {
+            nodeOf[r] = i;
+        }
+    }
+
+    // squared Frobenius norms of the blocks of each node row
+    sofa::type::vector<int> neighbors;
+    sofa::type::vector<Real> blockNorm(nbNodes, 0);
+    sofa::type::vector<char> isNeighbor(nbNodes, 0);
+    sofa::type::vector<int> strongBegin(nbNodes + 1, 0);
+    sofa::type::vector<int> strongNeighbors;
+    sofa::type::vector<Real> strongNorms;
+    sofa::type::vector<Real> diagonalNorm(nbNodes, 0);
+
+    const auto forEachBlockNorm = [&](const int i, auto f)
+    {
+        neighbors.clear();
+        for (int r = nodeBegin[i]; r < nodeBegin[i + 1]; ++r)
+        {
+            for (int e = outer[r]; e < outer[r + 1]; ++e)
+            {
+                const int j = nodeOf[inner[e]];
+                if (!isNeighbor[j])
+                {
+                    isNeighbor[j] = 1;
+                    blockNorm[j] = 0;
+                    neighbors.push_back(j);
+                }
+                blockNorm[j] += values[e] * values[e];
+            }
+        }
+        for (const int j : neighbors)
+        {
+            f(j, std::sqrt(blockNorm[j]));
+            isNeighbor[j] = 0;
+        }
+    };
+
+    for (int i = 0; i < nbNodes; ++i)
+    {
+        forEachBlockNorm(i, [&](const int j, const Real norm)
+        {
+            if (j == i)
+            {
+                diagonalNorm[i] = norm;
+            }
+        });
+    }
+
+    const Real threshold = d_strengthThreshold.getValue();
+    for (int i = 0; i < nbNodes; ++i)
+    {
+        forEachBlockNorm(i, [&](const int j, const Real norm)
+        {
+            if (j != i && norm > 0 && norm >= threshold * std::sqrt(diagonalNorm[i] * diagonalNorm[j]))
+            {
+                strongNeighbors.push_back(j);
+                strongNorms.push_back(norm);
+            }
+        });
+        strongBegin[i + 1] = static_cast<int>(strongNeighbors.size());
+    }
+
+    static constexpr int notAggregated = -1;
+    static constexpr int isolated = -2;
+
+    aggregate.assign(nbNodes, notAggregated);
+    for (int i = 0; i < nbNodes; ++i)
+    {
+        if (strongBegin[i] == strongBegin[i + 1])
+        {
+            aggregate[i] = isolated;
+        }
+    }
+
+    int nbAggregates = 0;
+
+    // 1. aggregates made of a node and all its strong neighbors, if none of them is aggregated
+    for (int i = 0; i < nbNodes; ++i)
+    {
+        if (aggregate[i] != notAggregated)
+        {
+            continue;
+        }
+        bool isFree = true;
+        for (int s = strongBegin[i]; s < strongBegin[i + 1] && isFree; ++s)
+        {
+            isFree = aggregate[strongNeighbors[s]] == notAggregated;
+        }
+        if (isFree)
+        {
+            aggregate[i] = nbAggregates;
+            for (int s = strongBegin[i]; s < strongBegin[i + 1]; ++s)
+            {
+                aggregate[strongNeighbors[s]] = nbAggregates;
+            }
+            ++nbAggregates;
+        }
+    }
+
+    // 2. the remaining nodes join the aggregate of their strongest aggregated neighbor
+    const sofa::type::vector<int> firstPass = aggregate;
+    for (int i = 0; i < nbNodes; ++i)
+    {
+        if (aggregate[i] != notAggregated)
+        {
+            continue;
+        }
+        Real strongest = 0;
+        for (int s = strongBegin[i]; s < strongBegin[i + 1]; ++s)
+        {
+            const int a = firstPass[strongNeighbors[s]];
+            if (a >= 0 && strongNorms[s] > strongest)
+            {
+                strongest = strongNorms[s];
+                aggregate[i] = a;
+            }
+        }
+    }
+
+    // 3. new aggregates with the nodes still not aggregated
+    for (int i = 0; i < nbNodes; ++i)
+    {
+        if (aggregate[i] != notAggregated)
+        {
+            continue;
+        }
+        aggregate[i] = nbAggregates;
+        for (int s = strongBegin[i]; s < strongBegin[i + 1]; ++s)
+        {
+            if (aggregate[strongNeighbors[s]] == notAggregated)
+            {
+                aggregate[strongNeighbors[s]] = nbAggregates;
+            }
+        }
+        ++nbAggregates;
+    }
+
+    for (int& a : aggregate)
+    {
+        if (a == isolated)
+        {
+            a = -1;
+        }
+    }
+
+    return nbAggregates;
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::buildTentativeProlongator(
+    const sofa::type::vector<int>& nodeBegin, const sofa::type::vector<int>& aggregate, const int nbAggregates,
+    const DenseMatrix& B, EigenMatrix& T, DenseMatrix& coarseB, sofa::type::vector<int>& coarseNodeBegin)
+{
+    const int nbNodes = static_cast<int>(nodeBegin.size()) - 1;
+    const auto nbModes = B.cols();
+
+    // nodes of each aggregate
+    sofa::type::vector<int> aggregateBegin(nbAggregates + 1, 0);
+    for (const int a : aggregate)
+    {
+        if (a >= 0)
+        {
+            ++aggregateBegin[a + 1];
+        }
+    }
+    for (int a = 0; a < nbAggregates; ++a)
+    {
+        aggregateBegin[a + 1] += aggregateBegin[a];
+    }
+    sofa::type::vector<int> aggregateNodes(aggregateBegin.back());
+    {
+        sofa::type::vector<int> next(aggregateBegin.begin(), aggregateBegin.end() - 1);
+        for (int i = 0; i < nbNodes; ++i)
+        {
+            if (aggregate[i] >= 0)
+            {
+                aggregateNodes[next[aggregate[i]]++] = i;
+            }
+        }
+    }
+
+    std::vector<Eigen::Triplet<Real> > triplets;
+    std::vector<Eigen::Matrix<Real, 1, Eigen::Dynamic> > coarseRows;
+    coarseNodeBegin.assign(1, 0);
+
+    sofa::type::vector<int> rows;
+    DenseMatrix localB, Q;
+    for (int a = 0; a < nbAggregates; ++a)
+    {
+        rows.clear();
+        for (int k = aggregateBegin[a]; k < aggregateBegin[a + 1]; ++k)
+        {
+            const int node = aggregateNodes[k];
+            for (int r = nodeBegin[node]; r < nodeBegin[node + 1]; ++r)
+            {
+                rows.push_back(r);
+            }
+        }
+
+        localB.resize(static_cast<Eigen::Index>(rows.size()), nbModes);
+        for (std::size_t r = 0; r < rows.size(); ++r)
+        {
+            localB.row(static_cast<Eigen::Index>(r)) = B.row(rows[r]);
+        }
+
+        // orthonormalization of the modes restricted to the aggregate (modified Gram-Schmidt),
+        // the modes which are linearly dependent on the aggregate are dropped
+        Q.resize(localB.rows(), nbModes);
+        Eigen::Index nbKept = 0;
+        for (Eigen::Index c = 0; c < nbModes; ++c)
+        {
+            auto v = localB.col(c).eval();
+            const Real initialNorm = v.norm();
+            for (Eigen::Index k = 0; k < nbKept; ++k)
+            {
+                v -= Q.col(k).dot(v) * Q.col(k);
+            }
+            const Real norm = v.norm();
+            if (initialNorm > 0 && norm > static_cast<Real>(1e-8) * initialNorm)
+            {
+                Q.col(nbKept++) = v / norm;
+            }
+        }
+
+        const int firstColumn = coarseNodeBegin.back();
+        for (Eigen::Index k = 0; k < nbKept; ++k)
+        {
+            for (std::size_t r = 0; r < rows.size(); ++r)
+            {
+                const Real q = Q(static_cast<Eigen::Index>(r), k);
+                if (q != 0)
+                {
+                    triplets.emplace_back(rows[r], firstColumn + static_cast<int>(k), q);
+                }
+            }
+            // B = T Bc on the aggregate: Bc = Q^T B
+            coarseRows.push_back(Q.col(k).transpose() * localB);
+        }
+        coarseNodeBegin.push_back(firstColumn + static_cast<int>(nbKept));
+    }
+
+    const int nbCoarse = coarseNodeBegin.back();
+    T.resize(nodeBegin.back(), nbCoarse);
+    T.setFromTriplets(triplets.begin(), triplets.end());
+
+    coarseB.resize(nbCoarse, nbModes);
+    for (int r = 0; r < nbCoarse; ++r)
+    {
+        coarseB.row(r) = coarseRows[r];
+    }
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::computeCoarseOperator(const std::size_t l)
+{
+    Level& level = m_levels[l];
+    const EigenMatrix& A = levelOperator(l);
+    const int n = static_cast<int>(A.rows());
+
+    // estimation of the spectral radius of D^-1 A, by power iterations
+    sofa::type::vector<Real> v(n), w(n);
+    for (int i = 0; i < n; ++i)
+    {
+        v[i] = 1 + static_cast<Real>(i % 7) / 7;
+    }
+    Real rho = 1;
+    for (unsigned int it = 0; it < 15; ++it)
+    {
+        multiply(A, v.data(), w.data());
+        Real norm = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            w[i] *= level.invDiagonal[i];
+            norm += w[i] * w[i];
+        }
+        Real normV = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            normV += v[i] * v[i];
+        }
+        if (norm == 0 || normV == 0)
+        {
+            break;
+        }
+        rho = std::sqrt(norm / normV);
+        for (int i = 0; i < n; ++i)
+        {
+            v[i] = w[i] / std::sqrt(norm);
+        }
+    }
+
+    // P = (I - omega D^-1 A) T
+    const Real omega = static_cast<Real>(4. / 3.) / rho;
+    EigenMatrix AT = A * level.tentativeProlongator;
+    for (int i = 0; i < n; ++i)
+    {
+        const Real scale = omega * level.invDiagonal[i];
+        for (typename EigenMatrix::InnerIterator it(AT, i); it; ++it)
+        {
+            it.valueRef() *= scale;
+        }
+    }
+    level.prolongator = level.tentativeProlongator - AT;
+    level.restriction = level.prolongator.transpose();
+
+    const EigenMatrix AP = A * level.prolongator;
+    m_levels[l + 1].A = level.restriction * AP;
+}
+
+/// Inverse of the diagonal of A, zero where the diagonal is not positive
+template<class EigenMatrix, class Real>
+void computeInverseDiagonal(const EigenMatrix& A, sofa::type::vector<Real>& invDiagonal)
+{
+    invDiagonal.assign(A.rows(), 0);
+    for (Eigen::Index i = 0; i < A.outerSize(); ++i)
+    {
+        for (typename EigenMatrix::InnerIterator it(A, i); it; ++it)
+        {
+            if (it.col() == i && it.value() > 0)
+            {
+                invDiagonal[i] = 1 / it.value();
+            }
+        }
+    }
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::buildHierarchy()
+{
+    SCOPED_TIMER_VARNAME(setupTimer, "SmoothedAggregation::setup");
+
+    m_levels.clear();
+    m_levels.emplace_back();
+
+    const auto n = m_matrix.matrix().rows();
+    sofa::type::vector<int> nodeBegin(n / Matrix::NL + 1);
+    for (std::size_t i = 0; i < nodeBegin.size(); ++i)
+    {
+        nodeBegin[i] = static_cast<int>(i * Matrix::NL);
+    }
+
+    DenseMatrix B;
+    computeNearNullSpace(B);
+
+    sofa::type::vector<int> aggregate;
+    for (std::size_t l = 0; ; ++l)
+    {
+        const EigenMatrix& A = levelOperator(l);
+        computeInverseDiagonal(A, m_levels[l].invDiagonal);
+
+        if (A.rows() <= static_cast<Eigen::Index>(d_maxCoarseSize.getValue()) || l + 1 >= d_maxNbLevels.getValue())
+        {
+            break;
+        }
+
+        const int nbAggregates = aggregateNodes(A, nodeBegin, aggregate);
+
+        DenseMatrix coarseB;
+        sofa::type::vector<int> coarseNodeBegin;
+        EigenMatrix T;
+        buildTentativeProlongator(nodeBegin, aggregate, nbAggregates, B, T, coarseB, coarseNodeBegin);
+
+        // stop if the coarsening is too slow
+        if (T.cols() == 0 || 10 * T.cols() > 9 * A.rows())
+        {
+            break;
+        }
+
+        m_levels[l].tentativeProlongator = std::move(T);
+        m_levels.emplace_back();
+        computeCoarseOperator(l);
+
+        nodeBegin = std::move(coarseNodeBegin);
+        B = std::move(coarseB);
+    }
+
+    for (auto& level : m_levels)
+    {
+        level.r.resize(level.invDiagonal.size());
+    }
+    for (std::size_t l = 1; l < m_levels.size(); ++l)
+    {
+        m_levels[l].x.resize(m_levels[l].invDiagonal.size());
+        m_levels[l].b.resize(m_levels[l].invDiagonal.size());
+    }
+
+    factorizeCoarsestLevel(true);
+
+    Real nnz = 0;
+    std::stringstream sizes;
+    for (std::size_t l = 0; l < m_levels.size(); ++l)
+    {
+        nnz += static_cast<Real>(levelOperator(l).nonZeros());
+        sizes << (l ? ", " : "") << levelOperator(l).rows();
+    }
+    const Real nnz0 = static_cast<Real>(std::max<Eigen::Index>(m_matrix.matrix().nonZeros(), 1));
+    d_nbLevels.setValue(static_cast<unsigned int>(m_levels.size()));
+    d_operatorComplexity.setValue(nnz / nnz0);
+
+    msg_info() << m_levels.size() << " levels of sizes " << sizes.str()
+               << ", operator complexity " << d_operatorComplexity.getValue();
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::updateOperators()
+{
+    SCOPED_TIMER_VARNAME(updateTimer, "SmoothedAggregation::update");
+
+    for (std::size_t l = 0; l < m_levels.size(); ++l)
+    {
+        computeInverseDiagonal(levelOperator(l), m_levels[l].invDiagonal);
+        if (l + 1 < m_levels.size())
+        {
+            computeCoarseOperator(l);
+        }
+    }
+
+    factorizeCoarsestLevel(false);
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::factorizeCoarsestLevel(const bool analyzePattern)
+{
+    SCOPED_TIMER_VARNAME(coarseTimer, "SmoothedAggregation::coarseFactorization");
+
+    const bool samePattern = !analyzePattern && m_isCoarseSolverValid
+        && m_coarseMatrix.nonZeros() == levelOperator(m_levels.size() - 1).nonZeros();
+
+    m_coarseMatrix = levelOperator(m_levels.size() - 1);
+    if (samePattern)
+    {
+        m_coarseSolver.factorize(m_coarseMatrix);
+    }
+    else
+    {
+        m_coarseSolver.compute(m_coarseMatrix);
+    }
+
+    m_isCoarseSolverValid = m_coarseSolver.info() == Eigen::Success;
+    msg_warning_when(!m_isCoarseSolverValid) << "The factorization of the coarsest level failed: it is smoothed instead";
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::invert(Matrix& M)
+{
+    if (m_matrix.update(M) || m_levels.empty())
+    {
+        buildHierarchy();
+    }
+    else
+    {
+        updateOperators();
+    }
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::smooth(const std::size_t l, const unsigned int nbSteps)
+{
+    Level& level = m_levels[l];
+    const EigenMatrix& A = levelOperator(l);
+    const int* outer = A.outerIndexPtr();
+    const int* inner = A.innerIndexPtr();
+    const Real* values = A.valuePtr();
+    const Real damping = d_smootherDamping.getValue();
+
+    for (unsigned int s = 0; s < nbSteps; ++s)
+    {
+        // x += damping * D^-1 (b - A x)
+        Real* x = level.x.data();
+        const Real* b = level.b.data();
+        Real* r = level.r.data();
+        forEachRow(static_cast<int>(A.rows()), [outer, inner, values, x, b, r](const int i)
+        {
+            Real s = b[i];
+            for (int e = outer[i]; e < outer[i + 1]; ++e)
+            {
+                s -= values[e] * x[inner[e]];
+            }
+            r[i] = s;
+        });
+        const Real* invDiagonal = level.invDiagonal.data();
+        forEachRow(static_cast<int>(A.rows()), [x, r, invDiagonal, damping](const int i)
+        {
+            x[i] += damping * invDiagonal[i] * r[i];
+        });
+    }
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::vcycle(const std::size_t l)
+{
+    Level& level = m_levels[l];
+    const auto n = static_cast<int>(level.invDiagonal.size());
+    const unsigned int nbSteps = d_nbSmoothingSteps.getValue();
+
+    std::fill(level.x.begin(), level.x.end(), 0);
+
+    if (l + 1 == m_levels.size())
+    {
+        if (m_isCoarseSolverValid)
+        {
+            Eigen::Map<Eigen::Matrix<Real, Eigen::Dynamic, 1> >(level.x.data(), n) =
+                m_coarseSolver.solve(Eigen::Map<const Eigen::Matrix<Real, Eigen::Dynamic, 1> >(level.b.data(), n));
+        }
+        else
+        {
+            smooth(l, 2 * nbSteps + 1);
+        }
+        return;
+    }
+
+    smooth(l, nbSteps);
+
+    // restriction of the residual
+    const EigenMatrix& A = levelOperator(l);
+    multiply(A, level.x.data(), level.r.data());
+    for (int i = 0; i < n; ++i)
+    {
+        level.r[i] = level.b[i] - level.r[i];
+    }
+    Level& coarse = m_levels[l + 1];
+    multiply(level.restriction, level.r.data(), coarse.b.data());
+
+    vcycle(l + 1);
+
+    // coarse correction
+    multiply(level.prolongator, coarse.x.data(), level.r.data());
+    for (int i = 0; i < n; ++i)
+    {
+        level.x[i] += level.r[i];
+    }
+
+    smooth(l, nbSteps);
+}
+
+template<class TMatrix, class TVector>
+void SmoothedAggregationPreconditioner<TMatrix,TVector>::solve(Matrix& M, Vector& z, Vector& r)
+{
+    SOFA_UNUSED(M);
+    SCOPED_TIMER_VARNAME(solveTimer, "SmoothedAggregation::solve");
+
+    if (m_levels.empty() || static_cast<std::size_t>(r.size()) != m_levels.front().invDiagonal.size())
+    {
+        z = r;
+        return;
+    }
+
+    Level& finest = m_levels.front();
+    finest.b.assign(r.ptr(), r.ptr() + r.size());
+    finest.x.resize(finest.b.size());
+
+    vcycle(0);
+
+    for (std::size_t i = 0; i < finest.x.size(); ++i)
+    {
+        z[i] = finest.x[i];
+    }
+}
+
+} // namespace sofa::component::linearsolver::preconditioner
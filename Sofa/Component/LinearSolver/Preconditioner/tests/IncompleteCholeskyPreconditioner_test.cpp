@@ -0,0 +1,188 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/component/linearsolver/preconditioner/IncompleteCholeskyPreconditioner.h>
+#include <sofa/component/linearsolver/preconditioner/init.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+
+#include <Eigen/Dense>
+#include <cmath>
+
+namespace
+{
+
+using MatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+using VectorType = sofa::linearalgebra::FullVector<SReal>;
+using IncompleteCholeskyPreconditioner = sofa::component::linearsolver::preconditioner::IncompleteCholeskyPreconditioner<MatrixType, VectorType>;
+
+/// Gives access to the factor L, stored by rows, the diagonal being the last entry of each row
+class IncompleteCholeskyFactor : public IncompleteCholeskyPreconditioner
+{
+public:
+    using IncompleteCholeskyPreconditioner::m_lowerBegin;
+    using IncompleteCholeskyPreconditioner::m_lowerCols;
+    using IncompleteCholeskyPreconditioner::m_lowerValues;
+};
+
+/// Laplacian of a 3D grid of size n x n x n, with Dirichlet boundary conditions
+void buildGridLaplacian(const sofa::Index n, MatrixType& matrix)
+{
+    const sofa::Index size = n * n * n;
+    matrix.resize(size, size);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        for (sofa::Index j = 0; j < n; ++j)
+        {
+            for (sofa::Index k = 0; k < n; ++k)
+            {
+                const sofa::Index row = (i * n + j) * n + k;
+                if (i > 0) matrix.add(row, row - n * n, -1_sreal);
+                if (j > 0) matrix.add(row, row - n, -1_sreal);
+                if (k > 0) matrix.add(row, row - 1, -1_sreal);
+                matrix.add(row, row, 6_sreal);
+                if (k + 1 < n) matrix.add(row, row + 1, -1_sreal);
+                if (j + 1 < n) matrix.add(row, row + n, -1_sreal);
+                if (i + 1 < n) matrix.add(row, row + n * n, -1_sreal);
+            }
+        }
+    }
+    matrix.compress();
+}
+
+}
+
+/// A tridiagonal matrix has no fill-in: its incomplete factorization is its exact Cholesky factorization
+TEST(IncompleteCholeskyPreconditioner, ExactFactorOfTridiagonalMatrix)
+{
+    sofa::component::linearsolver::preconditioner::init();
+    const sofa::simulation::Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+    constexpr sofa::Index n = 50;
+    MatrixType matrix;
+    matrix.resize(n, n);
+    Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic> dense = Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic>::Zero(n, n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        const SReal diagonal = 2_sreal + std::sin(static_cast<SReal>(i)) * 0.5_sreal;
+        matrix.add(i, i, diagonal);
+        dense(i, i) = diagonal;
+        if (i + 1 < n)
+        {
+            const SReal offDiagonal = -1_sreal + std::cos(static_cast<SReal>(i)) * 0.1_sreal;
+            matrix.add(i, i + 1, offDiagonal);
+            matrix.add(i + 1, i, offDiagonal);
+            dense(i, i + 1) = offDiagonal;
+            dense(i + 1, i) = offDiagonal;
+        }
+    }
+    matrix.compress();
+
+    const sofa::core::sptr<IncompleteCholeskyFactor> preconditioner(new IncompleteCholeskyFactor);
+    root->addObject(preconditioner);
+    preconditioner->init();
+    preconditioner->invert(matrix);
+    EXPECT_EQ(preconditioner->d_appliedShift.getValue(), 0_sreal);
+
+    const Eigen::LLT<Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic> > cholesky(dense);
+    ASSERT_EQ(cholesky.info(), Eigen::Success);
+    const Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic> L = cholesky.matrixL();
+
+    ASSERT_EQ(preconditioner->m_lowerBegin.size(), n + 1);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        const int begin = preconditioner->m_lowerBegin[i];
+        const int end = preconditioner->m_lowerBegin[i + 1];
+        ASSERT_EQ(end - begin, i == 0 ? 1 : 2) << "row " << i;
+        for (int p = begin; p < end; ++p)
+        {
+            const int j = preconditioner->m_lowerCols[p];
+            EXPECT_NEAR(preconditioner->m_lowerValues[p], L(i, j), 1e-12) << "L(" << i << "," << j << ")";
+        }
+    }
+
+    // the preconditioner is then the inverse of the matrix
+    VectorType r(n), z(n);
+    Eigen::Matrix<SReal, Eigen::Dynamic, 1> rhs(n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        r[i] = rhs[i] = std::sin(3_sreal * static_cast<SReal>(i));
+    }
+    preconditioner->solve(matrix, z, r);
+    const Eigen::Matrix<SReal, Eigen::Dynamic, 1> expected = cholesky.solve(rhs);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        EXPECT_NEAR(z[i], expected[i], 1e-12) << "i = " << i;
+    }
+
+    sofa::simulation::node::unload(root);
+}
+
+/// The rows of a level are processed in parallel: the factorization and its application do not depend on it
+TEST(IncompleteCholeskyPreconditioner, LevelScheduledApplicationEqualsSequential)
+{
+    sofa::component::linearsolver::preconditioner::init();
+    const sofa::simulation::Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+    // the levels of a 3D grid are its diagonal planes, large enough to be processed in parallel
+    constexpr sofa::Index n = 30;
+    MatrixType matrix;
+    buildGridLaplacian(n, matrix);
+    const sofa::Index size = n * n * n;
+
+    VectorType r(size);
+    for (sofa::Index i = 0; i < size; ++i)
+    {
+        r[i] = std::sin(static_cast<SReal>(i));
+    }
+
+    // the default scheduler may have no worker thread on a single core machine
+    sofa::simulation::MainTaskSchedulerFactory::createInRegistry()->init(4);
+
+    VectorType sequential(size), parallel(size);
+    for (const bool multithreading : {false, true})
+    {
+        const IncompleteCholeskyPreconditioner::SPtr preconditioner = sofa::core::objectmodel::New<IncompleteCholeskyPreconditioner>();
+        root->addObject(preconditioner);
+        preconditioner->d_multithreading.setValue(multithreading);
+        preconditioner->init();
+        preconditioner->invert(matrix);
+        preconditioner->solve(matrix, multithreading ? parallel : sequential, r);
+        root->removeObject(preconditioner);
+    }
+
+    for (sofa::Index i = 0; i < size; ++i)
+    {
+        EXPECT_EQ(parallel[i], sequential[i]) << "i = " << i;
+    }
+
+    // the application is not the identity
+    SReal difference = 0;
+    for (sofa::Index i = 0; i < size; ++i)
+    {
+        difference = std::max(difference, std::abs(sequential[i] - r[i]));
+    }
+    EXPECT_GT(difference, 1e-3);
+
+    sofa::simulation::node::unload(root);
+}
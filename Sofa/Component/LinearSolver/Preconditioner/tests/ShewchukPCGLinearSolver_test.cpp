@@ -0,0 +1,137 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/linearsolver/iterative/ShewchukPCGLinearSolver.h>
+#include <sofa/component/linearsolver/iterative/GraphScatteredTypes.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/simpleapi/SimpleApi.h>
+#include <sofa/simulation/Node.h>
+
+namespace
+{
+
+using namespace sofa;
+using ShewchukPCGLinearSolver = component::linearsolver::iterative::ShewchukPCGLinearSolver<
+    component::linearsolver::GraphScatteredMatrix, component::linearsolver::GraphScatteredVector>;
+
+/** Number of iterations of the preconditioned conjugate gradient solving one implicit step of a stiff
+hexahedral beam clamped at one end, with the preconditioners assembling the matrix by 3x3 blocks */
+struct ShewchukPCGLinearSolver_test : public BaseSimulationTest
+{
+    static constexpr unsigned int maxNbIterations = 2000;
+
+    struct Solve
+    {
+        unsigned int nbIterations { 0 };
+        std::vector<SReal> positions;
+    };
+
+    /// One time step with the given preconditioner (none if empty)
+    static Solve solveStep(const std::string& preconditioner, const std::map<std::string, std::string>& preconditionerData = {})
+    {
+        SceneInstance scene;
+        const simulation::Node::SPtr root = scene.root;
+        root->setGravity({ 0, -10, 0 });
+        root->setDt(0.1);
+
+        simpleapi::createObject(root, "RequiredPlugin", {{"pluginName", "Sofa.Component"}});
+        simpleapi::createObject(root, "DefaultAnimationLoop");
+
+        const simulation::Node::SPtr beam = simpleapi::createChild(root, "beam");
+        simpleapi::createObject(beam, "EulerImplicitSolver", {{"rayleighStiffness", "0"}, {"rayleighMass", "0"}});
+
+        std::map<std::string, std::string> pcgData {{"name", "pcg"}, {"iterations", std::to_string(maxNbIterations)}, {"tolerance", "1e-16"}};
+        if (!preconditioner.empty())
+        {
+            pcgData["preconditioner"] = "@preconditioner";
+            std::map<std::string, std::string> data = preconditionerData;
+            data["name"] = "preconditioner";
+            data["template"] = "CompressedRowSparseMatrixMat3x3";
+            simpleapi::createObject(beam, preconditioner, data);
+        }
+        const auto pcg = simpleapi::createObject(beam, "ShewchukPCGLinearSolver", pcgData);
+
+        simpleapi::createObject(beam, "RegularGridTopology", {{"name", "grid"}, {"min", "0 0 0"}, {"max", "10 1 1"}, {"n", "21 3 3"}});
+        const auto mstate = simpleapi::createObject(beam, "MechanicalObject", {{"template", "Vec3"}, {"src", "@grid"}});
+        simpleapi::createObject(beam, "UniformMass", {{"totalMass", "1"}});
+        simpleapi::createObject(beam, "HexahedronFEMForceField", {{"youngModulus", "1e5"}, {"poissonRatio", "0.3"}});
+        simpleapi::createObject(beam, "FixedProjectiveConstraint", {{"indices", "0 21 42 63 84 105 126 147 168"}});
+
+        scene.initScene();
+        scene.simulate(0.1);
+
+        Solve solve;
+        const auto* solver = dynamic_cast<ShewchukPCGLinearSolver*>(pcg.get());
+        EXPECT_NE(solver, nullptr);
+        if (solver)
+        {
+            solve.nbIterations = solver->d_nbIterations.getValue();
+        }
+
+        const auto* state = dynamic_cast<core::behavior::BaseMechanicalState*>(mstate.get());
+        EXPECT_NE(state, nullptr);
+        if (state)
+        {
+            for (Size i = 0; i < state->getSize(); ++i)
+            {
+                solve.positions.push_back(state->getPY(i));
+            }
+        }
+        return solve;
+    }
+
+    static void expectSameDeflection(const Solve& a, const Solve& b)
+    {
+        ASSERT_EQ(a.positions.size(), b.positions.size());
+        for (std::size_t i = 0; i < a.positions.size(); ++i)
+        {
+            EXPECT_NEAR(a.positions[i], b.positions[i], 1e-6) << "node " << i;
+        }
+    }
+};
+
+TEST_F(ShewchukPCGLinearSolver_test, incompleteCholeskyReducesTheNumberOfIterations)
+{
+    const Solve cg = solveStep("");
+    const Solve ic = solveStep("IncompleteCholeskyPreconditioner");
+
+    EXPECT_LT(cg.nbIterations, maxNbIterations);
+    EXPECT_GT(ic.nbIterations, 0u);
+    EXPECT_LT(ic.nbIterations, cg.nbIterations);
+    expectSameDeflection(cg, ic);
+}
+
+TEST_F(ShewchukPCGLinearSolver_test, smoothedAggregationReducesTheNumberOfIterations)
+{
+    const Solve cg = solveStep("");
+    // a small maximum coarse size, so that the beam is coarsened
+    const Solve sa = solveStep("SmoothedAggregationPreconditioner", {{"maxCoarseSize", "60"}});
+
+    EXPECT_LT(cg.nbIterations, maxNbIterations);
+    EXPECT_GT(sa.nbIterations, 0u);
+    EXPECT_LT(sa.nbIterations, cg.nbIterations);
+    expectSameDeflection(cg, sa);
+}
+
+}
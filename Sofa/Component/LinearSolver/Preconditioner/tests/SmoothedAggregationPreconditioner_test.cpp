@@ -0,0 +1,120 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/component/linearsolver/preconditioner/SmoothedAggregationPreconditioner.h>
+#include <sofa/component/linearsolver/preconditioner/init.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+
+#include <Eigen/Eigenvalues>
+#include <cmath>
+
+namespace
+{
+
+using Block = sofa::type::Mat<3, 3, SReal>;
+using MatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<Block>;
+using VectorType = sofa::linearalgebra::FullVector<SReal>;
+using SmoothedAggregationPreconditioner = sofa::component::linearsolver::preconditioner::SmoothedAggregationPreconditioner<MatrixType, VectorType>;
+
+/// Laplacian of a 3D grid of n x n x n nodes, with Dirichlet boundary conditions, coupling the 3 dofs
+/// of the nodes with a symmetric positive definite block K: the matrix is the Kronecker product L x K
+void buildBlockGridLaplacian(const sofa::Index n, MatrixType& matrix)
+{
+    const Block K(Block::Line(1_sreal, 0.1_sreal, 0_sreal),
+                  Block::Line(0.1_sreal, 1_sreal, 0.1_sreal),
+                  Block::Line(0_sreal, 0.1_sreal, 1_sreal));
+
+    const sofa::Index nbNodes = n * n * n;
+    matrix.resize(3 * nbNodes, 3 * nbNodes);
+    const auto addBlock = [&matrix](const sofa::Index p, const sofa::Index q, const Block& block)
+    {
+        matrix.add(3 * p, 3 * q, block);
+    };
+
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        for (sofa::Index j = 0; j < n; ++j)
+        {
+            for (sofa::Index k = 0; k < n; ++k)
+            {
+                const sofa::Index node = (i * n + j) * n + k;
+                if (i > 0) addBlock(node, node - n * n, -K);
+                if (j > 0) addBlock(node, node - n, -K);
+                if (k > 0) addBlock(node, node - 1, -K);
+                addBlock(node, node, K * 6_sreal);
+                if (k + 1 < n) addBlock(node, node + 1, -K);
+                if (j + 1 < n) addBlock(node, node + n, -K);
+                if (i + 1 < n) addBlock(node, node + n * n, -K);
+            }
+        }
+    }
+    matrix.compress();
+}
+
+}
+
+TEST(SmoothedAggregationPreconditioner, VCycleIsSymmetricPositiveDefinite)
+{
+    sofa::component::linearsolver::preconditioner::init();
+    const sofa::simulation::Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+    constexpr sofa::Index n = 7;
+    MatrixType matrix;
+    buildBlockGridLaplacian(n, matrix);
+    const sofa::Index size = 3 * n * n * n;
+
+    const SmoothedAggregationPreconditioner::SPtr preconditioner = sofa::core::objectmodel::New<SmoothedAggregationPreconditioner>();
+    root->addObject(preconditioner);
+    preconditioner->init();
+    preconditioner->invert(matrix);
+
+    // more unknowns than the default maximum coarse size: the matrix is coarsened at least once
+    ASSERT_GT(size, preconditioner->d_maxCoarseSize.getValue());
+    EXPECT_GE(preconditioner->d_nbLevels.getValue(), 2u);
+    EXPECT_GT(preconditioner->d_operatorComplexity.getValue(), 1_sreal);
+
+    // the V-cycle is a linear operator: its matrix is built column by column
+    using DenseMatrix = Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic>;
+    DenseMatrix P(size, size);
+    VectorType e(size), z(size);
+    for (sofa::Index j = 0; j < size; ++j)
+    {
+        e.clear();
+        e[j] = 1_sreal;
+        preconditioner->solve(matrix, z, e);
+        for (sofa::Index i = 0; i < size; ++i)
+        {
+            P(i, j) = z[i];
+        }
+    }
+
+    const SReal maxValue = P.cwiseAbs().maxCoeff();
+    ASSERT_GT(maxValue, 0_sreal);
+    EXPECT_LT((P - P.transpose()).cwiseAbs().maxCoeff(), 1e-10 * maxValue);
+
+    const Eigen::SelfAdjointEigenSolver<DenseMatrix> eigenSolver(DenseMatrix(0.5_sreal * (P + P.transpose())), Eigen::EigenvaluesOnly);
+    ASSERT_EQ(eigenSolver.info(), Eigen::Success);
+    EXPECT_GT(eigenSolver.eigenvalues().minCoeff(), 0_sreal);
+
+    sofa::simulation::node::unload(root);
+}
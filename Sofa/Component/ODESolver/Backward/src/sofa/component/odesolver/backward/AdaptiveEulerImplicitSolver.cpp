@@ -0,0 +1,238 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/odesolver/backward/AdaptiveEulerImplicitSolver.h>
+
+#include <sofa/simulation/MechanicalOperations.h>
+#include <sofa/simulation/VectorOperations.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/UpdateContextVisitor.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/core/ObjectFactory.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace sofa::component::odesolver::backward
+{
+
+using namespace core::behavior;
+
+namespace
+{
+
+/// Set the time seen by the components of the solver node and of its descendants, as the animation loop does between two steps
+void setSubtreeTime(const core::ExecParams* params, core::objectmodel::BaseContext* context, SReal time)
+{
+    if (auto* node = dynamic_cast<simulation::Node*>(context))
+    {
+        node->setTime(time);
+        node->execute<simulation::UpdateSimulationContextVisitor>(params);
+    }
+}
+
+}
+
+int AdaptiveEulerImplicitSolverClass = core::RegisterObject("Implicit backward Euler time integrator taking adaptive substeps controlled by a predictor-corrector error estimate")
+        .add< AdaptiveEulerImplicitSolver >()
+        ;
+
+AdaptiveEulerImplicitSolver::AdaptiveEulerImplicitSolver()
+    : d_absoluteTolerance(initData(&d_absoluteTolerance, (SReal)1e-4, "absoluteTolerance", "Absolute tolerance on the local position error of a substep"))
+    , d_relativeTolerance(initData(&d_relativeTolerance, (SReal)1e-3, "relativeTolerance", "Relative tolerance on the local position error of a substep"))
+    , d_safetyFactor(initData(&d_safetyFactor, (SReal)0.9, "safetyFactor", "Safety factor applied on the optimal substep size, in ]0,1]"))
+    , d_minSubstep(initData(&d_minSubstep, (SReal)0, "minSubstep", "Smallest allowed substep. Below this size, substeps are accepted whatever their error. If 0, 1e-6 times the animation step is used"))
+    , d_maxSubsteps(initData(&d_maxSubsteps, 100u, "maxSubsteps", "Maximum number of accepted substeps in one animation step. The last substep covers the remaining time when this number is reached"))
+    , d_acceptedSubsteps(initData(&d_acceptedSubsteps, 0u, "acceptedSubsteps", "Output: number of accepted substeps during the last animation step"))
+    , d_rejectedSubsteps(initData(&d_rejectedSubsteps, 0u, "rejectedSubsteps", "Output: number of rejected substeps during the last animation step"))
+    , d_nextSubstep(initData(&d_nextSubstep, (SReal)0, "nextSubstep", "Output: substep size proposed by the error controller at the end of the last animation step, used as the first trial of the next one"))
+{
+    d_acceptedSubsteps.setReadOnly(true);
+    d_rejectedSubsteps.setReadOnly(true);
+    d_nextSubstep.setReadOnly(true);
+}
+
+void AdaptiveEulerImplicitSolver::init()
+{
+    EulerImplicitSolver::init();
+
+    if (d_absoluteTolerance.getValue() <= 0 && d_relativeTolerance.getValue() <= 0)
+    {
+        msg_warning() << "At least one of " << d_absoluteTolerance.getName() << " and " << d_relativeTolerance.getName()
+                      << " must be strictly positive. " << d_absoluteTolerance.getName() << " is set to 1e-4.";
+        d_absoluteTolerance.setValue(1e-4);
+    }
+
+    if (d_safetyFactor.getValue() <= 0 || d_safetyFactor.getValue() > 1)
+    {
+        msg_warning() << d_safetyFactor.getName() << " must be in ]0,1]. It is set to 0.9.";
+        d_safetyFactor.setValue(0.9);
+    }
+
+    if (d_maxSubsteps.getValue() == 0)
+    {
+        msg_warning() << d_maxSubsteps.getName() << " must be strictly positive. It is set to 1.";
+        d_maxSubsteps.setValue(1);
+    }
+}
+
+void AdaptiveEulerImplicitSolver::reset()
+{
+    EulerImplicitSolver::reset();
+    d_acceptedSubsteps.setValue(0);
+    d_rejectedSubsteps.setValue(0);
+    d_nextSubstep.setValue(0);
+}
+
+void AdaptiveEulerImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
+{
+    sofa::simulation::common::VectorOperations vop( params, this->getContext() );
+    sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
+
+    MultiVecCoord pos(&vop, core::VecCoordId::position() );
+    MultiVecDeriv vel(&vop, core::VecDerivId::velocity() );
+
+    // state at the beginning of the current substep, restored when a substep is rejected
+    MultiVecCoord curX(&vop);
+    MultiVecDeriv curV(&vop);
+    MultiVecDeriv dX(&vop);
+    MultiVecDeriv dV(&vop);
+
+    // the substeps are computed in place, starting from the current position and velocity
+    const bool inPlace = xResult.getDefaultId() == core::VecCoordId::position()
+                      && vResult.getDefaultId() == core::VecDerivId::velocity();
+    MultiVecCoord startX(&vop);
+    MultiVecDeriv startV(&vop);
+    if (!inPlace)
+    {
+        startX.eq(pos);
+        startV.eq(vel);
+    }
+
+    const SReal startTime = this->getTime();
+    const SReal endTime = startTime + dt;
+    const SReal atol = d_absoluteTolerance.getValue();
+    const SReal rtol = d_relativeTolerance.getValue();
+    const SReal safety = d_safetyFactor.getValue();
+    const SReal minSubstep = d_minSubstep.getValue() > 0 ? d_minSubstep.getValue() : dt * 1e-6;
+    const unsigned int maxSubsteps = d_maxSubsteps.getValue();
+
+    // do not let the step size controller grow or shrink the substep too abruptly
+    static constexpr SReal maxGrowth = 5;
+    static constexpr SReal minShrink = 0.2;
+
+    // size proposed by the error controller for the next substep
+    SReal hNext = d_nextSubstep.getValue() > 0 ? d_nextSubstep.getValue() : dt;
+    SReal t = startTime;
+    unsigned int accepted = 0;
+    unsigned int rejected = 0;
+
+    while (endTime - t > dt * 1e-12)
+    {
+        const bool lastAllowedSubstep = (accepted + 1 >= maxSubsteps);
+        const SReal h = lastAllowedSubstep ? endTime - t : std::min(hNext, endTime - t);
+
+        curX.eq(pos);
+        curV.eq(vel);
+
+        // time-dependent components (projective constraints, forces) see the beginning of the substep
+        setSubtreeTime(params, this->getContext(), t);
+
+        {
+            SCOPED_TIMER("Substep");
+            EulerImplicitSolver::solve(params, h, pos, vel);
+        }
+
+        // increment of the corrector, and corrector - predictor = h (v_{t+h} - v_t)
+        dX.eq(vel, h);
+        dV.eq(vel, curV, -1.0);
+
+        const SReal scale = std::max(atol + rtol * dX.norm(0), std::numeric_limits<SReal>::min());
+        const SReal error = SReal(0.5) * h * dV.norm(0) / scale;
+
+        const bool accept = error <= 1 || h <= minSubstep || lastAllowedSubstep;
+
+        // optimal size of the next substep, for an error estimate of order 1
+        SReal factor = maxGrowth;
+        if (error > 0)
+        {
+            factor = std::clamp(safety / std::sqrt(error), minShrink, maxGrowth);
+        }
+
+        if (accept)
+        {
+            if (error > 1)
+            {
+                msg_warning() << "Substep of size " << h << " accepted at time " << t << " with a relative error of " << error
+                              << " (" << (lastAllowedSubstep ? d_maxSubsteps.getName() : d_minSubstep.getName()) << " reached)";
+            }
+
+            t += h;
+            ++accepted;
+
+            msg_info() << "Substep " << accepted << " of size " << h << " accepted (error=" << error << ")";
+        }
+        else
+        {
+            ++rejected;
+            msg_info() << "Substep of size " << h << " rejected (error=" << error << ")";
+
+            pos.eq(curX);
+            vel.eq(curV);
+        }
+
+        // a substep truncated to reach the end of the animation step does not reduce the proposed size
+        const SReal hProposed = std::max(h * factor, minSubstep);
+        hNext = (accept && h < hNext) ? std::max(hNext, hProposed) : hProposed;
+
+        if (endTime - t > dt * 1e-12)
+        {
+            // the constraints are projected at the end of the accepted substep, as the animation loop does at the end of a step,
+            // and the forces of the next substep are computed on the propagated state
+            if (accept)
+            {
+                setSubtreeTime(params, this->getContext(), t);
+                mop.projectPositionAndVelocity(pos, vel, t);
+            }
+            mop.propagateXAndV(pos, vel);
+        }
+    }
+
+    // the animation loop advances the time itself at the end of the step
+    setSubtreeTime(params, this->getContext(), startTime);
+
+    d_acceptedSubsteps.setValue(accepted);
+    d_rejectedSubsteps.setValue(rejected);
+    d_nextSubstep.setValue(std::min(hNext, dt));
+
+    if (!inPlace)
+    {
+        MultiVecCoord newPos(&vop, xResult );
+        MultiVecDeriv newVel(&vop, vResult );
+        newPos.eq(pos);
+        newVel.eq(vel);
+        pos.eq(startX);
+        vel.eq(startV);
+    }
+}
+
+} // namespace sofa::component::odesolver::backward
@@ -0,0 +1,69 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/odesolver/backward/config.h>
+
+#include <sofa/component/odesolver/backward/EulerImplicitSolver.h>
+
+namespace sofa::component::odesolver::backward
+{
+
+/** Implicit Euler time integrator taking adaptive substeps inside one animation step.
+ *
+ * Each substep of size h is an EulerImplicitSolver step (the corrector). Its local error
+ * is estimated by comparing it to an explicit predictor using the velocity at the
+ * beginning of the substep:
+ *
+ *   \f$ x^p_{t+h} = x_t + h v_t \f$ (predictor)
+ *   \f$ x^c_{t+h} = x_t + h v_{t+h} \f$ (corrector)
+ *   \f$ e = \frac{1}{2} \| x^c_{t+h} - x^p_{t+h} \|_\infty = \frac{h}{2} \| v_{t+h} - v_t \|_\infty \f$
+ *
+ * The substep is accepted if \f$ e \leq atol + rtol \| x^c_{t+h} - x_t \|_\infty \f$,
+ * otherwise the state is restored and the substep is retried with a smaller size.
+ * The visual frame rate given by the animation loop is unchanged: only the mechanics
+ * takes more (or fewer) substeps inside one step.
+ */
+class SOFA_COMPONENT_ODESOLVER_BACKWARD_API AdaptiveEulerImplicitSolver : public EulerImplicitSolver
+{
+public:
+    SOFA_CLASS(AdaptiveEulerImplicitSolver, EulerImplicitSolver);
+
+    Data<SReal> d_absoluteTolerance; ///< Absolute tolerance on the local position error of a substep
+    Data<SReal> d_relativeTolerance; ///< Relative tolerance on the local position error of a substep
+    Data<SReal> d_safetyFactor; ///< Safety factor applied on the optimal substep size
+    Data<SReal> d_minSubstep; ///< Smallest allowed substep. Below this size, substeps are accepted whatever their error
+    Data<unsigned int> d_maxSubsteps; ///< Maximum number of accepted substeps in one animation step
+    Data<unsigned int> d_acceptedSubsteps; ///< Output: number of accepted substeps during the last animation step
+    Data<unsigned int> d_rejectedSubsteps; ///< Output: number of rejected substeps during the last animation step
+    Data<SReal> d_nextSubstep; ///< Output: substep size proposed by the error controller at the end of the last animation step
+
+protected:
+    AdaptiveEulerImplicitSolver();
+
+public:
+    void init() override;
+    void reset() override;
+
+    void solve (const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult) override;
+};
+
+} // namespace sofa::component::odesolver::backward
@@ -0,0 +1,317 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/odesolver/forward/AdaptiveRungeKuttaSolver.h>
+#include <sofa/simulation/MechanicalOperations.h>
+#include <sofa/simulation/VectorOperations.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/UpdateContextVisitor.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/core/ObjectFactory.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+
+namespace sofa::component::odesolver::forward
+{
+
+using namespace core::behavior;
+using namespace sofa::defaulttype;
+
+int AdaptiveRungeKuttaSolverClass = core::RegisterObject("An explicit time integrator taking adaptive substeps controlled by an embedded error estimate")
+        .add< AdaptiveRungeKuttaSolver >()
+        ;
+
+AdaptiveRungeKuttaSolver::AdaptiveRungeKuttaSolver()
+    : d_scheme(initData(&d_scheme, helper::OptionsGroup{{"HeunEuler", "RK45"}}.setSelectedItem(1), "scheme",
+                        "Embedded Runge-Kutta pair:\n"
+                        "-HeunEuler: order 2 solution, order 1 error estimate (2 force evaluations per substep)\n"
+                        "-RK45: Dormand-Prince pair, order 5 solution, order 4 error estimate (7 force evaluations per substep)"))
+    , d_absoluteTolerance(initData(&d_absoluteTolerance, (SReal)1e-6, "absoluteTolerance", "Absolute tolerance on the local error of a substep"))
+    , d_relativeTolerance(initData(&d_relativeTolerance, (SReal)1e-6, "relativeTolerance", "Relative tolerance on the local error of a substep"))
+    , d_safetyFactor(initData(&d_safetyFactor, (SReal)0.9, "safetyFactor", "Safety factor applied on the optimal substep size, in ]0,1]"))
+    , d_minSubstep(initData(&d_minSubstep, (SReal)0, "minSubstep", "Smallest allowed substep. Below this size, substeps are accepted whatever their error. If 0, 1e-6 times the animation step is used"))
+    , d_maxSubsteps(initData(&d_maxSubsteps, 1000u, "maxSubsteps", "Maximum number of accepted substeps in one animation step. The last substep covers the remaining time when this number is reached"))
+    , d_acceptedSubsteps(initData(&d_acceptedSubsteps, 0u, "acceptedSubsteps", "Output: number of accepted substeps during the last animation step"))
+    , d_rejectedSubsteps(initData(&d_rejectedSubsteps, 0u, "rejectedSubsteps", "Output: number of rejected substeps during the last animation step"))
+    , d_nextSubstep(initData(&d_nextSubstep, (SReal)0, "nextSubstep", "Output: substep size proposed by the error controller at the end of the last animation step, used as the first trial of the next one"))
+{
+    d_acceptedSubsteps.setReadOnly(true);
+    d_rejectedSubsteps.setReadOnly(true);
+    d_nextSubstep.setReadOnly(true);
+}
+
+void AdaptiveRungeKuttaSolver::init()
+{
+    OdeSolver::init();
+
+    if (d_absoluteTolerance.getValue() <= 0 && d_relativeTolerance.getValue() <= 0)
+    {
+        msg_warning() << "At least one of " << d_absoluteTolerance.getName() << " and " << d_relativeTolerance.getName()
+                      << " must be strictly positive. " << d_absoluteTolerance.getName() << " is set to 1e-6.";
+        d_absoluteTolerance.setValue(1e-6);
+    }
+
+    if (d_safetyFactor.getValue() <= 0 || d_safetyFactor.getValue() > 1)
+    {
+        msg_warning() << d_safetyFactor.getName() << " must be in ]0,1]. It is set to 0.9.";
+        d_safetyFactor.setValue(0.9);
+    }
+
+    if (d_maxSubsteps.getValue() == 0)
+    {
+        msg_warning() << d_maxSubsteps.getName() << " must be strictly positive. It is set to 1.";
+        d_maxSubsteps.setValue(1);
+    }
+}
+
+void AdaptiveRungeKuttaSolver::reset()
+{
+    d_acceptedSubsteps.setValue(0);
+    d_rejectedSubsteps.setValue(0);
+    d_nextSubstep.setValue(0);
+}
+
+const AdaptiveRungeKuttaSolver::ButcherTableau& AdaptiveRungeKuttaSolver::getTableau(unsigned int scheme)
+{
+    static const ButcherTableau heunEuler {
+        { 0, 1 },
+        { {}, { 1 } },
+        { 1./2, 1./2 },
+        { 1, 0 },
+        1
+    };
+
+    static const ButcherTableau dormandPrince {
+        { 0, 1./5, 3./10, 4./5, 8./9, 1, 1 },
+        {
+            {},
+            { 1./5 },
+            { 3./40, 9./40 },
+            { 44./45, -56./15, 32./9 },
+            { 19372./6561, -25360./2187, 64448./6561, -212./729 },
+            { 9017./3168, -355./33, 46732./5247, 49./176, -5103./18656 },
+            { 35./384, 0, 500./1113, 125./192, -2187./6784, 11./84 }
+        },
+        { 35./384, 0, 500./1113, 125./192, -2187./6784, 11./84, 0 },
+        { 5179./57600, 0, 7571./16695, 393./640, -92097./339200, 187./2100, 1./40 },
+        4
+    };
+
+    return scheme == 0 ? heunEuler : dormandPrince;
+}
+
+namespace
+{
+
+/// Set the time seen by the components of the solver node and of its descendants, as the animation loop does between two steps
+void setSubtreeTime(const core::ExecParams* params, core::objectmodel::BaseContext* context, SReal time)
+{
+    if (auto* node = dynamic_cast<simulation::Node*>(context))
+    {
+        node->setTime(time);
+        node->execute<simulation::UpdateSimulationContextVisitor>(params);
+    }
+}
+
+}
+
+void AdaptiveRungeKuttaSolver::solve(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
+{
+    typedef core::behavior::BaseMechanicalState::VMultiOp VMultiOp;
+
+    sofa::simulation::common::VectorOperations vop( params, this->getContext() );
+    sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
+    mop->setImplicit(false); // this solver is explicit only
+
+    const ButcherTableau& tableau = getTableau(d_scheme.getValue().getSelectedId());
+    const std::size_t nbStages = tableau.c.size();
+
+    MultiVecCoord pos(&vop, core::VecCoordId::position() );
+    MultiVecDeriv vel(&vop, core::VecDerivId::velocity() );
+    MultiVecCoord pos2(&vop, xResult );
+    MultiVecDeriv vel2(&vop, vResult );
+
+    // Allocate auxiliary vectors: the stage velocities and accelerations
+    std::vector<std::unique_ptr<MultiVecDeriv> > kv, ka;
+    for (std::size_t i = 0; i < nbStages; ++i)
+    {
+        kv.emplace_back(std::make_unique<MultiVecDeriv>(&vop));
+        ka.emplace_back(std::make_unique<MultiVecDeriv>(&vop));
+    }
+
+    // state at the beginning of the current substep
+    MultiVecCoord curX(&vop);
+    MultiVecDeriv curV(&vop);
+    // stage position, trial increments and error estimates
+    MultiVecCoord newX(&vop);
+    MultiVecDeriv dX(&vop);
+    MultiVecDeriv dV(&vop);
+    MultiVecDeriv errX(&vop);
+    MultiVecDeriv errV(&vop);
+
+    mop.addSeparateGravity(dt);	// v += dt*g . Used if mass wants to added G separately from the other forces to v.
+
+    curX.eq(pos);
+    curV.eq(vel);
+
+    const SReal startTime = this->getTime();
+    const SReal endTime = startTime + dt;
+    const SReal atol = d_absoluteTolerance.getValue();
+    const SReal rtol = d_relativeTolerance.getValue();
+    const SReal safety = d_safetyFactor.getValue();
+    const SReal exponent = SReal(1) / SReal(tableau.estimateOrder + 1);
+    const SReal minSubstep = d_minSubstep.getValue() > 0 ? d_minSubstep.getValue() : dt * 1e-6;
+    const unsigned int maxSubsteps = d_maxSubsteps.getValue();
+
+    // do not let the step size controller grow or shrink the substep too abruptly
+    static constexpr SReal maxGrowth = 5;
+    static constexpr SReal minShrink = 0.2;
+
+    // size proposed by the error controller for the next substep
+    SReal hNext = d_nextSubstep.getValue() > 0 ? d_nextSubstep.getValue() : dt;
+    SReal t = startTime;
+    unsigned int accepted = 0;
+    unsigned int rejected = 0;
+
+    while (endTime - t > dt * 1e-12)
+    {
+        const bool lastAllowedSubstep = (accepted + 1 >= maxSubsteps);
+        const SReal h = lastAllowedSubstep ? endTime - t : std::min(hNext, endTime - t);
+
+        // Runge-Kutta stages
+        for (std::size_t i = 0; i < nbStages; ++i)
+        {
+            VMultiOp ops(2);
+            ops[0].first = newX;
+            ops[0].second.emplace_back(curX.id(), 1.0);
+            ops[1].first = *kv[i];
+            ops[1].second.emplace_back(curV.id(), 1.0);
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                const SReal aij = tableau.a[i][j];
+                if (aij != 0)
+                {
+                    ops[0].second.emplace_back(kv[j]->id(), h * aij);
+                    ops[1].second.emplace_back(ka[j]->id(), h * aij);
+                }
+            }
+            vop.v_multiop(ops);
+
+            // time-dependent components (projective constraints, forces) see the time of the stage
+            setSubtreeTime(params, this->getContext(), t + tableau.c[i] * h);
+            mop.computeAcc(t + tableau.c[i] * h, *ka[i], newX, *kv[i]);
+        }
+
+        // increments and error estimates
+        {
+            VMultiOp ops(4);
+            ops[0].first = dX;
+            ops[1].first = dV;
+            ops[2].first = errX;
+            ops[3].first = errV;
+            for (std::size_t i = 0; i < nbStages; ++i)
+            {
+                const SReal b = tableau.b[i];
+                const SReal e = tableau.b[i] - tableau.bHat[i];
+                if (b != 0)
+                {
+                    ops[0].second.emplace_back(kv[i]->id(), h * b);
+                    ops[1].second.emplace_back(ka[i]->id(), h * b);
+                }
+                if (e != 0)
+                {
+                    ops[2].second.emplace_back(kv[i]->id(), h * e);
+                    ops[3].second.emplace_back(ka[i]->id(), h * e);
+                }
+            }
+            vop.v_multiop(ops);
+        }
+
+        const SReal scaleX = std::max(atol + rtol * dX.norm(0), std::numeric_limits<SReal>::min());
+        const SReal scaleV = std::max(atol + rtol * std::max(curV.norm(0), dV.norm(0)), std::numeric_limits<SReal>::min());
+        const SReal error = std::max(errX.norm(0) / scaleX, errV.norm(0) / scaleV);
+
+        const bool accept = error <= 1 || h <= minSubstep || lastAllowedSubstep;
+
+        // optimal size of the next substep
+        SReal factor = maxGrowth;
+        if (error > 0)
+        {
+            factor = std::clamp(safety * std::pow(error, -exponent), minShrink, maxGrowth);
+        }
+
+        if (accept)
+        {
+            if (error > 1)
+            {
+                msg_warning() << "Substep of size " << h << " accepted at time " << t << " with a relative error of " << error
+                              << " (" << (lastAllowedSubstep ? d_maxSubsteps.getName() : d_minSubstep.getName()) << " reached)";
+            }
+
+            VMultiOp ops(2);
+            ops[0].first = curX;
+            ops[0].second.emplace_back(curX.id(), 1.0);
+            ops[0].second.emplace_back(dX.id(), 1.0);
+            ops[1].first = curV;
+            ops[1].second.emplace_back(curV.id(), 1.0);
+            ops[1].second.emplace_back(dV.id(), 1.0);
+            vop.v_multiop(ops);
+
+            t += h;
+            ++accepted;
+
+            // the constraints are projected at the end of the accepted substep, as the animation loop does at the end of a step
+            if (endTime - t > dt * 1e-12)
+            {
+                setSubtreeTime(params, this->getContext(), t);
+                mop.projectPositionAndVelocity(curX, curV, t);
+            }
+
+            msg_info() << "Substep " << accepted << " of size " << h << " accepted (error=" << error << ")";
+        }
+        else
+        {
+            ++rejected;
+            msg_info() << "Substep of size " << h << " rejected (error=" << error << ")";
+        }
+
+        // a substep truncated to reach the end of the animation step does not reduce the proposed size
+        const SReal hProposed = std::max(h * factor, minSubstep);
+        hNext = (accept && h < hNext) ? std::max(hNext, hProposed) : hProposed;
+    }
+
+    // the animation loop advances the time itself at the end of the step
+    setSubtreeTime(params, this->getContext(), startTime);
+
+    d_acceptedSubsteps.setValue(accepted);
+    d_rejectedSubsteps.setValue(rejected);
+    d_nextSubstep.setValue(std::min(hNext, dt));
+
+    pos2.eq(curX);
+    vel2.eq(curV);
+    mop.solveConstraint(pos2, core::ConstraintOrder::POS);
+    mop.solveConstraint(vel2, core::ConstraintOrder::VEL);
+}
+
+} // namespace sofa::component::odesolver::forward
@@ -0,0 +1,118 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/odesolver/forward/config.h>
+
+#include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/helper/OptionsGroup.h>
+
+namespace sofa::component::odesolver::forward
+{
+
+/** Explicit time integrator with embedded error estimation and adaptive sub-stepping.
+ *
+ * The animation step dt is split into substeps whose size is chosen so that the local
+ * error, estimated by the difference between two embedded Runge-Kutta solutions, stays
+ * below the requested tolerance. The visual frame rate given by the animation loop is
+ * unchanged: only the mechanics takes more (or fewer) substeps inside one step.
+ *
+ * Available schemes:
+ * - HeunEuler: 2 stages, order 2 solution with an order 1 error estimate
+ * - RK45: Dormand-Prince, 7 stages, order 5 solution with an order 4 error estimate
+ *
+ * The local error of a substep h is measured as
+ *   \f$ err = \max( \frac{\|e_x\|_\infty}{atol + rtol \|\Delta x\|_\infty}, \frac{\|e_v\|_\infty}{atol + rtol \|v\|_\infty} ) \f$
+ * The substep is accepted if err <= 1, and the next substep size is
+ *   \f$ h_{new} = h \min(maxGrowth, \max(minShrink, safety\ err^{-1/(p+1)})) \f$
+ * with p the order of the embedded estimate.
+ */
+class SOFA_COMPONENT_ODESOLVER_FORWARD_API AdaptiveRungeKuttaSolver : public sofa::core::behavior::OdeSolver
+{
+public:
+    SOFA_CLASS(AdaptiveRungeKuttaSolver, sofa::core::behavior::OdeSolver);
+
+    Data<helper::OptionsGroup> d_scheme; ///< Embedded Runge-Kutta pair (HeunEuler, RK45)
+    Data<SReal> d_absoluteTolerance; ///< Absolute tolerance on the local error of a substep
+    Data<SReal> d_relativeTolerance; ///< Relative tolerance on the local error of a substep
+    Data<SReal> d_safetyFactor; ///< Safety factor applied on the optimal substep size
+    Data<SReal> d_minSubstep; ///< Smallest allowed substep. Below this size, substeps are accepted whatever their error
+    Data<unsigned int> d_maxSubsteps; ///< Maximum number of accepted substeps in one animation step
+    Data<unsigned int> d_acceptedSubsteps; ///< Output: number of accepted substeps during the last animation step
+    Data<unsigned int> d_rejectedSubsteps; ///< Output: number of rejected substeps during the last animation step
+    Data<SReal> d_nextSubstep; ///< Output: substep size proposed by the error controller at the end of the last animation step, used as the first trial of the next one
+
+protected:
+    AdaptiveRungeKuttaSolver();
+
+public:
+    void init() override;
+    void reset() override;
+
+    void solve (const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult) override;
+
+    /// Given an input derivative order (0 for position, 1 for velocity, 2 for acceleration),
+    /// how much will it affect the output derivative of the given order.
+    /// @todo use real factors depending on the current substep
+    SReal getIntegrationFactor(int inputDerivative, int outputDerivative) const override
+    {
+        const SReal dt = getContext()->getDt();
+        const SReal matrix[3][3] =
+        {
+            { 1, dt/2, 0},
+            { 0, 1, dt/2},
+            { 0, 0, 0}
+        };
+        if (inputDerivative >= 3 || outputDerivative >= 3)
+            return 0;
+        else
+            return matrix[outputDerivative][inputDerivative];
+    }
+
+    /// Given a solution of the linear system,
+    /// how much will it affect the output derivative of the given order.
+    /// @todo use real factors depending on the current substep
+    SReal getSolutionIntegrationFactor(int outputDerivative) const override
+    {
+        const SReal dt = getContext()->getDt();
+        const SReal vect[3] = { 0.0, dt/2, 1};
+        if (outputDerivative >= 3)
+            return 0;
+        else
+            return vect[outputDerivative];
+    }
+
+protected:
+
+    /// Butcher tableau of an embedded Runge-Kutta pair
+    struct ButcherTableau
+    {
+        type::vector<SReal> c; ///< nodes
+        type::vector<type::vector<SReal> > a; ///< Runge-Kutta matrix (strictly lower triangular)
+        type::vector<SReal> b; ///< weights of the propagated solution
+        type::vector<SReal> bHat; ///< weights of the embedded solution used for the error estimate
+        unsigned int estimateOrder; ///< order of the embedded solution
+    };
+
+    static const ButcherTableau& getTableau(unsigned int scheme);
+};
+
+} // namespace sofa::component::odesolver::forward
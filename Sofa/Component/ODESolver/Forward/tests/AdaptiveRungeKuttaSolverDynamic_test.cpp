@@ -0,0 +1,188 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/odesolver/testing/ODESolverSpringTest.h>
+
+//Including Simulation
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+#include <sofa/simulation/Node.h>
+
+// Including mechanical object
+#include <sofa/component/statecontainer/MechanicalObject.h>
+
+#include <sofa/component/odesolver/forward/AdaptiveRungeKuttaSolver.h>
+#include <sofa/defaulttype/VecTypes.h>
+
+#include <algorithm>
+
+namespace sofa {
+
+using namespace component;
+using namespace defaulttype;
+using namespace simulation;
+
+/**  Dynamic solver test.
+Test the dynamic behavior of the adaptive solver: study a mass-spring system under gravity initialized with spring rest length.
+Without damping, the mass oscillates around its equilibrium position and its position follows the equation:
+x(t) = x0 - g/w^2 (1 - cos(wt)) with w the pulsation w=sqrt(K/M), K the spring stiffness, M the mass and g the gravity.
+The animation step is large compared to the period of the oscillation: the solver must take several substeps per step
+to follow the analytic solution within the requested tolerance.
+*/
+template <typename _DataTypes>
+struct AdaptiveRungeKuttaSolverDynamic_test : public component::odesolver::testing::ODESolverSpringTest
+{
+    typedef _DataTypes DataTypes;
+    typedef typename DataTypes::Coord Coord;
+    typedef statecontainer::MechanicalObject<DataTypes> MechanicalObject;
+
+    odesolver::forward::AdaptiveRungeKuttaSolver::SPtr m_solver;
+
+    /// Create the context for the scene
+    void createScene(double K, double m, double l0, const std::string& scheme, double tolerance)
+    {
+        this->prepareScene(K, m, l0);
+        // add ODE Solver to test
+        const auto solver = simpleapi::createObject(m_si.root, "AdaptiveRungeKuttaSolver", {
+            { "scheme", scheme },
+            { "absoluteTolerance", simpleapi::str(tolerance) },
+            { "relativeTolerance", simpleapi::str(tolerance) }
+            });
+        m_solver = sofa::core::objectmodel::SPtr_dynamic_cast<odesolver::forward::AdaptiveRungeKuttaSolver>(solver);
+        ASSERT_NE(m_solver, nullptr);
+    }
+
+    /// After simulation compare the positions of points to the analytic positions.
+    void compareSimulatedToAnalyticPositions(double K, double m, double h, double tolerance)
+    {
+        const double g = 10;
+        const double x0 = 1;
+        const double w = std::sqrt(K / m);
+
+        m_si.initScene();
+
+        // Get mechanical object
+        const simulation::Node::SPtr massNode = m_si.root->getChild("MassNode");
+        typename MechanicalObject::SPtr dofs = massNode->get<MechanicalObject>(m_si.root->SearchDown);
+
+        unsigned int totalAcceptedSubsteps = 0;
+        double time = m_si.root->getTime();
+        do
+        {
+            m_si.simulate(h);
+            time = m_si.root->getTime();
+            totalAcceptedSubsteps += m_solver->d_acceptedSubsteps.getValue();
+
+            const Coord p0 = dofs->read(sofa::core::ConstVecCoordId::position())->getValue()[0];
+            const double expected = x0 - g / (w * w) * (1 - std::cos(w * time));
+
+            EXPECT_NEAR(p0[1], expected, tolerance) << "Position of mass at time " << time << " is wrong";
+        }
+        while (time < 2);
+
+        // the animation step is too large for the requested accuracy: substeps must have been taken
+        EXPECT_GT(totalAcceptedSubsteps, static_cast<unsigned int>(2 / h));
+    }
+};
+
+// Define the list of DataTypes to instantiate
+using ::testing::Types;
+typedef Types<
+    Vec3Types
+> DataTypes; // the types to instantiate.
+
+// Test suite for all the instantiations
+TYPED_TEST_SUITE(AdaptiveRungeKuttaSolverDynamic_test, DataTypes);
+
+TYPED_TEST( AdaptiveRungeKuttaSolverDynamic_test , heunEulerDynamicTest)
+{
+    this->createScene(100, 10, 1, "HeunEuler", 1e-6); // k,m,l0
+    this->compareSimulatedToAnalyticPositions(100, 10, 0.1, 1e-4);
+}
+
+TYPED_TEST( AdaptiveRungeKuttaSolverDynamic_test , rk45DynamicTest)
+{
+    this->createScene(1000, 10, 1, "RK45", 1e-9); // k,m,l0
+    this->compareSimulatedToAnalyticPositions(1000, 10, 0.1, 1e-6);
+}
+
+/** Time-dependent constraint test.
+A mass is attached with a spring to a point driven by a LinearMovementProjectiveConstraint, which stops in the middle of
+an animation step. Each substep must see the motion of the driven point at its own time: the trajectory of the mass
+must follow the one simulated with small animation steps by the RungeKutta4Solver.
+*/
+struct AdaptiveRungeKuttaSolverTimeDependentConstraint_test : public BaseSimulationTest
+{
+    typedef statecontainer::MechanicalObject<Vec3Types> MechanicalObject;
+
+    static Vec3Types::Coord readPosition(const simulation::Node::SPtr& root, const std::string& nodeName)
+    {
+        const simulation::Node::SPtr node = root->getChild(nodeName);
+        const MechanicalObject::SPtr dofs = node->get<MechanicalObject>(root->SearchDown);
+        return dofs->read(sofa::core::ConstVecCoordId::position())->getValue()[0];
+    }
+
+    void compareToSmallSteps(double K, double m, double l0, double h, unsigned int nbSteps, unsigned int nbSmallSteps, double tolerance)
+    {
+        SceneInstance reference;
+        component::odesolver::testing::ODESolverSpringTest::prepareDrivenScene(reference.root, K, m, l0);
+        simpleapi::createObject(reference.root, "RungeKutta4Solver", {});
+        reference.initScene();
+
+        SceneInstance adaptive;
+        component::odesolver::testing::ODESolverSpringTest::prepareDrivenScene(adaptive.root, K, m, l0);
+        simpleapi::createObject(adaptive.root, "AdaptiveRungeKuttaSolver", {
+            { "absoluteTolerance", simpleapi::str(1e-6) },
+            { "relativeTolerance", simpleapi::str(1e-6) }
+            });
+        adaptive.initScene();
+
+        for (unsigned int step = 0; step < nbSteps; ++step)
+        {
+            adaptive.simulate(h);
+            for (unsigned int i = 0; i < nbSmallSteps; ++i)
+            {
+                reference.simulate(h / nbSmallSteps);
+            }
+
+            const double time = adaptive.root->getTime();
+            EXPECT_NEAR(time, (step + 1) * h, 1e-10);
+
+            const auto expected = readPosition(reference.root, "MassNode");
+            const auto position = readPosition(adaptive.root, "MassNode");
+            EXPECT_NEAR(position[0], expected[0], tolerance) << "Position of mass at time " << time << " is wrong";
+
+            const auto driven = readPosition(adaptive.root, "DrivenPointNode");
+            EXPECT_NEAR(driven[0], 2 * std::min(time, 0.9), 1e-10) << "Position of driven point at time " << time << " is wrong";
+        }
+    }
+};
+
+TEST_F( AdaptiveRungeKuttaSolverTimeDependentConstraint_test , substepsFollowTheConstraintMotion)
+{
+    // the driven point stops at the time 0.9, in the middle of the third animation step
+    this->compareToSmallSteps(10, 1, 1, 0.4, 5, 400, 1e-2); // k,m,l0,h,steps,small steps per step,tolerance
+}
+
+} // namespace sofa
@@ -84,6 +84,61 @@ inline simulation::Node::SPtr createMassSpringSystem(
     return root;
 }
 
+/// Create a mass spring system whose other end follows a piecewise linear motion (LinearMovementProjectiveConstraint)
+inline simulation::Node::SPtr createDrivenMassSpringSystem(
+    simulation::Node::SPtr root,
+    const std::string& stiffness,
+    const std::string& mass,
+    const std::string& restLength,
+    const std::string& xDrivenPoint,
+    const std::string& keyTimes,
+    const std::string& movements,
+    const std::string& xMass)
+{
+    // Driven point
+    const auto drivenPointNode = simpleapi::createChild(root, "DrivenPointNode" );
+
+    simpleapi::createObject(drivenPointNode, "MechanicalObject", {
+        { "name","drivenPoint"},
+        { "template","Vec3"},
+        { "position", xDrivenPoint},
+    });
+
+    simpleapi::createObject(drivenPointNode, "LinearMovementProjectiveConstraint", {
+        { "name","movement"},
+        { "indices", "0"},
+        { "keyTimes", keyTimes},
+        { "movements", movements},
+    });
+
+    // Mass
+    const auto massNode = simpleapi::createChild(root, "MassNode");
+
+    simpleapi::createObject(massNode, "MechanicalObject", {
+        { "name","massDof"},
+        { "template","Vec3"},
+        { "position", xMass},
+    });
+
+    simpleapi::createObject(massNode, "UniformMass", {
+        { "name","mass"},
+        { "totalMass", mass}
+    });
+
+    std::ostringstream oss;
+    oss << 0 << " " << 0 << " " << stiffness << " " << 0 << " " << restLength;
+
+    // attach a spring
+    simpleapi::createObject(root, "StiffSpringForceField", {
+        { "name","ff"},
+        { "spring", oss.str()},
+        { "object1", "@DrivenPointNode/drivenPoint"},
+        { "object2", "@MassNode/massDof"},
+    });
+
+    return root;
+}
+
 template<typename DataTypes>
 inline simulation::Node::SPtr createMassSpringSystem(
     simulation::Node::SPtr root,
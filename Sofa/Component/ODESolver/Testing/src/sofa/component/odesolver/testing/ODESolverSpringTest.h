@@ -71,6 +71,39 @@ struct ODESolverSpringTest : public BaseSimulationTest
             std::string("0.0 1.0 0.0"),  // Initial position of mass
             std::string("0.0 0.0 0.0")); // Initial velocity of mass
     }
+
+    /// Scene without gravity where the spring is attached to a point moving at the speed 2 along x until the time 0.9,
+    /// then stopping. The solver to test is added by the caller.
+    inline static void prepareDrivenScene(simulation::Node::SPtr root, double K, double m, double l0)
+    {
+        root->setGravity({ 0, 0, 0 });
+
+        sofa::simpleapi::importPlugin("Sofa.Component.ODESolver");
+        sofa::simpleapi::importPlugin("Sofa.Component.LinearSolver.Iterative");
+        sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+        sofa::simpleapi::importPlugin("Sofa.Component.Mass");
+        sofa::simpleapi::importPlugin("Sofa.Component.Constraint.Projective");
+        sofa::simpleapi::importPlugin("Sofa.Component.SolidMechanics.Spring");
+
+        simpleapi::createObject(root, "DefaultAnimationLoop", {});
+        simpleapi::createObject(root, "DefaultVisualManagerLoop", {});
+
+        simpleapi::createObject(root, "CGLinearSolver", {
+            { "iterations", simpleapi::str(3000)},
+            { "tolerance", simpleapi::str(1e-12)},
+            { "threshold", simpleapi::str(1e-12)},
+            });
+
+        createDrivenMassSpringSystem(
+            root,
+            simpleapi::str(K),      // stiffness
+            simpleapi::str(m),      // mass
+            simpleapi::str(l0),     // spring rest length
+            std::string("0.0 0.0 0.0"),  // Initial position of driven point
+            std::string("0 0.9 10"),     // key times of the motion
+            std::string("0 0 0  1.8 0 0  1.8 0 0"), // displacements of the driven point at the key times
+            std::string("1.0 0.0 0.0")); // Initial position of mass
+    }
 };
 
 } // namespace sofa::component::odesolver::testing
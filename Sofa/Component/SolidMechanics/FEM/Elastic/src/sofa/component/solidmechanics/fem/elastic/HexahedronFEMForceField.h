@@ -24,6 +24,7 @@
 
 #include <sofa/core/behavior/ForceField.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/core/topology/ElementColoring.h>
 #include <sofa/component/topology/container/grid/SparseGridTopology.h>
 #include <sofa/type/vector.h>
 #include <sofa/defaulttype/VecTypes.h>
@@ -31,6 +32,7 @@
 #include <sofa/core/behavior/BaseRotationFinder.h>
 #include <sofa/helper/decompose.h>
 #include <sofa/helper/OptionsGroup.h>
+#include <sofa/simulation/TaskScheduler.h>
 
 namespace sofa::component::solidmechanics::fem::elastic
 {
@@ -121,6 +123,7 @@ public:
     Data< sofa::helper::OptionsGroup > _gatherBsize; ///< number of dof accumulated per threads during the gather operation (Only use in GPU version)
     Data<bool> f_drawing; ///< draw the forcefield if true
     Data<Real> f_drawPercentageOffset; ///< size of the hexa
+    Data<bool> d_multithreading; ///< Compute the forces and their derivatives in parallel, the hexahedra being processed by colors of independent elements
     bool needUpdateTopology;
 
     /// Link to be set to the topology container in the component graph. 
@@ -147,6 +150,9 @@ public:
 
     const Transformation& getElementRotation(const sofa::Index elemidx);
 
+    /// Stiffness matrices of the elements, in the rotated frame of each element
+    const type::vector<type::Mat<24, 24, Real> >& getElementStiffnesses() const { return _elementStiffnesses.getValue(); }
+
     void getNodeRotation(Transformation& R, sofa::Index nodeIdx) ;
     void getRotations(linearalgebra::BaseMatrix * rotations,int offset = 0) override ;
 
@@ -179,6 +185,7 @@ protected:
     typedef type::vector< CompressedValue > CompressedMatrix;
     CompressedMatrix _stiffnesses;
     SReal m_potentialEnergy;
+    type::vector<SReal> m_elementPotentialEnergies; ///< Potential energy of each element, summed in m_potentialEnergy
 
     sofa::core::topology::BaseMeshTopology* m_topology; ///< Pointer to the topology container. Will be set by link @sa l_topology
     topology::container::grid::SparseGridTopology* _sparseGrid;
@@ -186,6 +193,10 @@ protected:
 
     type::Mat<8,3,int> _coef; ///< coef of each vertices to compute the strain stress matrix
 
+    /// Colors of hexahedra sharing no vertex, processed in parallel if d_multithreading is set
+    core::topology::ElementColoring m_elementColoring;
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+
     HexahedronFEMForceFieldInternalData<DataTypes> *data;
     friend class HexahedronFEMForceFieldInternalData<DataTypes>;
 
@@ -222,6 +233,16 @@ protected:
     void initSmall(sofa::Index i, const Element&elem);
     virtual void accumulateForceSmall( WDataRefVecDeriv &f, RDataRefVecCoord &p, sofa::Index i, const Element&elem  );
 
+    /// Call f on each hexahedron, color after color, the hexahedra of a color being processed in parallel.
+    /// The hexahedra are processed sequentially if f is not thread-safe
+    template<class F>
+    void forEachElementByColor(F f, bool isThreadSafe = true);
+
+    /// Call assemble(e, K) on the stiffness matrix K of each hexahedron e, rotated in the world frame. The matrices
+    /// are computed in parallel if d_multithreading is set, and assembled one after the other
+    template<class F>
+    void forEachRotatedElementStiffness(F assemble);
+
     bool _alreadyInit;
 };
 
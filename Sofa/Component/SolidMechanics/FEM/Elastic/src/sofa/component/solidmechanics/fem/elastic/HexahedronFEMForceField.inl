@@ -28,6 +28,8 @@
 #include <sofa/core/MechanicalParams.h>
 #include <sofa/helper/decompose.h>
 #include <sofa/core/behavior/BaseLocalForceFieldMatrix.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 // WARNING: indices ordering is different than in topology node
 //
@@ -58,6 +60,7 @@ HexahedronFEMForceField<DataTypes>::HexahedronFEMForceField()
     , _gatherBsize(initData(&_gatherBsize,"gatherBsize","number of dof accumulated per threads during the gather operation (Only use in GPU version)"))
     , f_drawing(initData(&f_drawing,true,"drawing","draw the forcefield if true"))
     , f_drawPercentageOffset(initData(&f_drawPercentageOffset,(Real)0.15,"drawPercentageOffset","size of the hexa"))
+    , d_multithreading(initData(&d_multithreading,false,"multithreading","Compute the forces and their derivatives in parallel, the hexahedra being processed by colors of independent elements"))
     , needUpdateTopology(false)
     , l_topology(initLink("topology", "link to the topology container"))
     , _elementStiffnesses(initData(&_elementStiffnesses,"stiffnessMatrices", "Stiffness matrices per element (K_i)"))
@@ -140,6 +143,19 @@ void HexahedronFEMForceField<DataTypes>::init()
     _sparseGrid = dynamic_cast<topology::container::grid::SparseGridTopology*>(m_topology);
     m_potentialEnergy = 0;
 
+    m_taskScheduler = nullptr;
+    if (d_multithreading.getValue())
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+    m_elementColoring.invalidate();
+
     this->d_componentState.setValue(core::objectmodel::ComponentState::Valid);
     reinit();
 }
@@ -224,44 +240,51 @@ void HexahedronFEMForceField<DataTypes>::addForce (const core::MechanicalParams*
         needUpdateTopology = false;
     }
 
-    unsigned int i=0;
-    typename VecElement::const_iterator it;
-
     const auto* indexedElements = this->getIndexedElements();
 
+    // each element stores its potential energy, so that the elements of a color can be processed concurrently
+    m_elementPotentialEnergies.resize(indexedElements->size());
+
+    // the stiffness matrices are edited one element after the other when they are updated
+    const bool isThreadSafe = !f_updateStiffnessMatrix.getValue();
+
+    // make sure the stiffness matrices are up-to-date before they are read concurrently
+    _elementStiffnesses.getValue();
+
     switch(method)
     {
     case LARGE :
     {
-        m_potentialEnergy = 0;
-        for(it=indexedElements->begin(); it!=indexedElements->end(); ++it,++i)
+        forEachElementByColor([&](const sofa::Index i)
         {
-            accumulateForceLarge( _f, _p, i, *it );
-        }
-        m_potentialEnergy/=-2.0;
+            accumulateForceLarge( _f, _p, i, (*indexedElements)[i] );
+        }, isThreadSafe);
         break;
     }
     case POLAR :
     {
-        m_potentialEnergy = 0;
-        for(it=indexedElements->begin(); it!=indexedElements->end(); ++it,++i)
+        forEachElementByColor([&](const sofa::Index i)
         {
-            accumulateForcePolar( _f, _p, i, *it );
-        }
-        m_potentialEnergy/=-2.0;
+            accumulateForcePolar( _f, _p, i, (*indexedElements)[i] );
+        }, isThreadSafe);
         break;
     }
     case SMALL :
     {
-        m_potentialEnergy = 0;
-        for(it=indexedElements->begin(); it!=indexedElements->end(); ++it,++i)
+        forEachElementByColor([&](const sofa::Index i)
         {
-            accumulateForceSmall( _f, _p, i, *it );
-        }
-        m_potentialEnergy/=-2.0;
+            accumulateForceSmall( _f, _p, i, (*indexedElements)[i] );
+        }, isThreadSafe);
         break;
     }
     }
+
+    m_potentialEnergy = 0;
+    for (const SReal potentialEnergy : m_elementPotentialEnergies)
+    {
+        m_potentialEnergy += potentialEnergy;
+    }
+    m_potentialEnergy/=-2.0;
 }
 
 template<class DataTypes>
@@ -274,13 +297,13 @@ void HexahedronFEMForceField<DataTypes>::addDForce (const core::MechanicalParams
     if (_df.size() != _dx.size())
         _df.resize(_dx.size());
 
-    unsigned int i = 0;
-    typename VecElement::const_iterator it;
-
     const auto* indexedElements = this->getIndexedElements();
+    const auto& stiffnesses = _elementStiffnesses.getValue();
 
-    for(it = indexedElements->begin() ; it != indexedElements->end() ; ++it, ++i)
+    forEachElementByColor([&](const sofa::Index i)
     {
+        const Element& element = (*indexedElements)[i];
+
         // Transformation R_0_2;
         // R_0_2.transpose(_rotations[i]);
 
@@ -289,7 +312,7 @@ void HexahedronFEMForceField<DataTypes>::addDForce (const core::MechanicalParams
         for(int w=0; w<8; ++w)
         {
             Coord x_2;
-            x_2 = _rotations[i] * _dx[(*it)[w]];
+            x_2 = _rotations[i] * _dx[element[w]];
 
             X[w*3] = x_2[0];
             X[w*3+1] = x_2[1];
@@ -297,13 +320,34 @@ void HexahedronFEMForceField<DataTypes>::addDForce (const core::MechanicalParams
         }
 
         Displacement F;
-        computeForce( F, X, _elementStiffnesses.getValue()[i] );
+        computeForce( F, X, stiffnesses[i] );
 
         for(int w=0; w<8; ++w)
         {
-            _df[(*it)[w]] -= _rotations[i].multTranspose(Deriv(F[w*3], F[w*3+1], F[w*3+2])) * kFactor;
+            _df[element[w]] -= _rotations[i].multTranspose(Deriv(F[w*3], F[w*3+1], F[w*3+2])) * kFactor;
         }
+    });
+}
+
+template<class DataTypes>
+template<class F>
+void HexahedronFEMForceField<DataTypes>::forEachElementByColor(F f, const bool isThreadSafe)
+{
+    const auto nbElements = static_cast<sofa::Index>(this->getIndexedElements()->size());
+
+    if (m_taskScheduler == nullptr || !isThreadSafe)
+    {
+        for (sofa::Index i = 0; i < nbElements; ++i)
+        {
+            f(i);
+        }
+        return;
     }
+
+    // the colors are computed again only if the topology changed
+    m_elementColoring.update(m_topology, sofa::geometry::ElementType::HEXAHEDRON);
+
+    simulation::parallelForEachColor(*m_taskScheduler, m_elementColoring.getColors(), f);
 }
 
 template <class DataTypes>
@@ -780,24 +824,27 @@ void HexahedronFEMForceField<DataTypes>::accumulateForceSmall ( WDataRefVecDeriv
             D[index+j] = _rotatedInitialElements[i][k][j] - nodes[k][j];
     }
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(_elementStiffnesses);
     if(f_updateStiffnessMatrix.getValue())
+    {
+        auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(_elementStiffnesses);
         computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
+    }
 
     Displacement F; //forces
-    computeForce( F, D, stiffnesses[i] ); // compute force on element
+    computeForce( F, D, _elementStiffnesses.getValue()[i] ); // compute force on element
 
     for(int w=0; w<8; ++w)
         f[elem[w]] += Deriv( F[w*3],  F[w*3+1],   F[w*3+2]  ) ;
 
-    m_potentialEnergy += dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
-    m_potentialEnergy += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
-    m_potentialEnergy += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
-    m_potentialEnergy += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
-    m_potentialEnergy += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
-    m_potentialEnergy += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
-    m_potentialEnergy += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
-    m_potentialEnergy += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
+    SReal& potentialEnergy = m_elementPotentialEnergies[i];
+    potentialEnergy  = dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
+    potentialEnergy += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
+    potentialEnergy += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
+    potentialEnergy += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
+    potentialEnergy += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
+    potentialEnergy += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
+    potentialEnergy += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
+    potentialEnergy += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
 }
 
 
@@ -883,9 +930,11 @@ void HexahedronFEMForceField<DataTypes>::accumulateForceLarge( WDataRefVecDeriv
             D[index+j] = _rotatedInitialElements[i][k][j] - deformed[k][j];
     }
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(_elementStiffnesses);
     if(f_updateStiffnessMatrix.getValue())
+    {
+        auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(_elementStiffnesses);
         computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
+    }
 
     Displacement F; //forces
     computeForce( F, D, _elementStiffnesses.getValue()[i] ); // compute force on element
@@ -893,14 +942,15 @@ void HexahedronFEMForceField<DataTypes>::accumulateForceLarge( WDataRefVecDeriv
     for(int w=0; w<8; ++w)
         f[elem[w]] += _rotations[i].multTranspose( Deriv( F[w*3],  F[w*3+1],   F[w*3+2]  ) );
 
-    m_potentialEnergy += dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
-    m_potentialEnergy += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
-    m_potentialEnergy += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
-    m_potentialEnergy += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
-    m_potentialEnergy += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
-    m_potentialEnergy += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
-    m_potentialEnergy += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
-    m_potentialEnergy += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
+    SReal& potentialEnergy = m_elementPotentialEnergies[i];
+    potentialEnergy  = dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
+    potentialEnergy += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
+    potentialEnergy += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
+    potentialEnergy += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
+    potentialEnergy += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
+    potentialEnergy += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
+    potentialEnergy += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
+    potentialEnergy += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
 }
 
 
@@ -1081,9 +1131,11 @@ void HexahedronFEMForceField<DataTypes>::accumulateForcePolar( WDataRefVecDeriv
     //forces
     Displacement F;
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(_elementStiffnesses);
     if(f_updateStiffnessMatrix.getValue())
+    {
+        auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(_elementStiffnesses);
         computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0);
+    }
 
 
     // compute force on element
@@ -1093,14 +1145,15 @@ void HexahedronFEMForceField<DataTypes>::accumulateForcePolar( WDataRefVecDeriv
     for(int j=0; j<8; ++j)
             f[elem[j]] += _rotations[i].multTranspose( Deriv( F[j*3],  F[j*3+1],   F[j*3+2]  ) );
 
-    m_potentialEnergy += dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
-    m_potentialEnergy += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
-    m_potentialEnergy += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
-    m_potentialEnergy += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
-    m_potentialEnergy += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
-    m_potentialEnergy += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
-    m_potentialEnergy += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
-    m_potentialEnergy += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
+    SReal& potentialEnergy = m_elementPotentialEnergies[i];
+    potentialEnergy  = dot(Deriv( F[0], F[1], F[2] ) ,-Deriv( D[0], D[1], D[2]));
+    potentialEnergy += dot(Deriv( F[3], F[4], F[5] ) ,-Deriv( D[3], D[4], D[5] ));
+    potentialEnergy += dot(Deriv( F[6], F[7], F[8] ) ,-Deriv( D[6], D[7], D[8] ));
+    potentialEnergy += dot(Deriv( F[9], F[10], F[11]),-Deriv( D[9], D[10], D[11] ));
+    potentialEnergy += dot(Deriv( F[12], F[13], F[14]),-Deriv( D[12], D[13], D[14] ));
+    potentialEnergy += dot(Deriv( F[15], F[16], F[17]),-Deriv( D[15], D[16], D[17] ));
+    potentialEnergy += dot(Deriv( F[18], F[19], F[20]),-Deriv( D[18], D[19], D[20] ));
+    potentialEnergy += dot(Deriv( F[21], F[22], F[23]),-Deriv( D[21], D[22], D[23] ));
 }
 
 template<class DataTypes>
@@ -1132,6 +1185,63 @@ inline void HexahedronFEMForceField<DataTypes>::setMethod(int val)
 /////////////////////////////////////////////////
 
 
+template<class DataTypes>
+template<class F>
+void HexahedronFEMForceField<DataTypes>::forEachRotatedElementStiffness(F assemble)
+{
+    const auto& stiffnesses = _elementStiffnesses.getValue();
+    const std::size_t nbElements = this->getIndexedElements()->size();
+
+    const auto computeRange = [this, &stiffnesses](const auto& range)
+    {
+        type::vector<ElementStiffness> rotatedStiffnesses(range.end - range.start);
+        auto K = rotatedStiffnesses.begin();
+        for (auto e = range.start; e != range.end; ++e, ++K)
+        {
+            const ElementStiffness &Ke = stiffnesses[e];
+            const Transformation& Rot = getElementRotation(static_cast<sofa::Index>(e));
+
+            for (Element::size_type n1 = 0; n1 < Element::size(); n1++)
+            {
+                for (Element::size_type n2 = 0; n2 < Element::size(); n2++)
+                {
+                    const Mat33 tmp = Rot.multTranspose( Mat33(
+                            Coord(Ke[3*n1+0][3*n2+0],Ke[3*n1+0][3*n2+1],Ke[3*n1+0][3*n2+2]),
+                            Coord(Ke[3*n1+1][3*n2+0],Ke[3*n1+1][3*n2+1],Ke[3*n1+1][3*n2+2]),
+                            Coord(Ke[3*n1+2][3*n2+0],Ke[3*n1+2][3*n2+1],Ke[3*n1+2][3*n2+2])) ) * Rot;
+
+                    K->setsub(3 * n1, 3 * n2, tmp);
+                }
+            }
+        }
+        return rotatedStiffnesses;
+    };
+
+    const auto assembleRange = [&assemble](const auto& range, type::vector<ElementStiffness>& rotatedStiffnesses)
+    {
+        auto K = rotatedStiffnesses.begin();
+        for (auto e = range.start; e != range.end; ++e, ++K)
+        {
+            assemble(static_cast<sofa::Index>(e), *K);
+        }
+    };
+
+    // the matrices of a chunk of elements are stored until they are assembled
+    static constexpr std::size_t chunkSize = 1024;
+    for (std::size_t first = 0; first < nbElements; first += chunkSize)
+    {
+        const std::size_t last = std::min(first + chunkSize, nbElements);
+        if (m_taskScheduler != nullptr)
+        {
+            simulation::parallelForEachRangeWithMerge(*m_taskScheduler, first, last, computeRange, assembleRange);
+        }
+        else
+        {
+            simulation::forEachRangeWithMerge(first, last, computeRange, assembleRange);
+        }
+    }
+}
+
 template<class DataTypes>
 void HexahedronFEMForceField<DataTypes>::addKToMatrix(const core::MechanicalParams* mparams, const sofa::core::behavior::MultiMatrixAccessor* matrix)
 {
@@ -1140,16 +1250,11 @@ void HexahedronFEMForceField<DataTypes>::addKToMatrix(const core::MechanicalPara
     sofa::core::behavior::MultiMatrixAccessor::MatrixRef r = matrix->getMatrix(this->mstate);
     const Real kFactor = (Real)sofa::core::mechanicalparams::kFactorIncludingRayleighDamping(mparams, this->rayleighStiffness.getValue());
 
-    sofa::Index e { 0 }; //index of the element in the topology
-
-    const auto& stiffnesses = _elementStiffnesses.getValue();
     const auto* indexedElements = this->getIndexedElements();
 
-    for (const auto& element : *indexedElements)
+    forEachRotatedElementStiffness([&](const sofa::Index e, const ElementStiffness& K)
     {
-        const ElementStiffness &Ke = stiffnesses[e];
-        const Transformation Rot = getElementRotation(e);
-        e++;
+        const Element& element = (*indexedElements)[e];
 
         // find index of node 1
         for (Element::size_type n1 = 0; n1 < Element::size(); n1++)
@@ -1160,33 +1265,26 @@ void HexahedronFEMForceField<DataTypes>::addKToMatrix(const core::MechanicalPara
             {
                 const auto node2 = element[n2];
 
-                const Mat33 tmp = Rot.multTranspose( Mat33(
-                        Coord(Ke[3*n1+0][3*n2+0],Ke[3*n1+0][3*n2+1],Ke[3*n1+0][3*n2+2]),
-                        Coord(Ke[3*n1+1][3*n2+0],Ke[3*n1+1][3*n2+1],Ke[3*n1+1][3*n2+2]),
-                        Coord(Ke[3*n1+2][3*n2+0],Ke[3*n1+2][3*n2+1],Ke[3*n1+2][3*n2+2])) ) * Rot;
+                Mat33 tmp(type::NOINIT);
+                K.getsub(3 * n1, 3 * n2, tmp);
 
                 r.matrix->add( r.offset + 3 * node1, r.offset + 3 * node2, tmp * (-kFactor));
             }
         }
-    }
+    });
 }
 
 template<class DataTypes>
 void HexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::StiffnessMatrix* matrix)
 {
-    sofa::Index e { 0 }; //index of the element in the topology
-
-    const auto& stiffnesses = _elementStiffnesses.getValue();
     const auto* indexedElements = this->getIndexedElements();
 
     auto dfdx = matrix->getForceDerivativeIn(this->mstate)
                        .withRespectToPositionsIn(this->mstate);
 
-    for (const auto& element : *indexedElements)
+    forEachRotatedElementStiffness([&](const sofa::Index e, const ElementStiffness& K)
     {
-        const ElementStiffness &Ke = stiffnesses[e];
-        const Transformation& Rot = getElementRotation(e);
-        e++;
+        const Element& element = (*indexedElements)[e];
 
         for (Element::size_type n1 = 0; n1 < Element::size(); n1++)
         {
@@ -1195,15 +1293,13 @@ void HexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
             {
                 const auto node2 = element[n2];
 
-                const Mat33 tmp = Rot.multTranspose( Mat33(
-                        Coord(Ke[3*n1+0][3*n2+0],Ke[3*n1+0][3*n2+1],Ke[3*n1+0][3*n2+2]),
-                        Coord(Ke[3*n1+1][3*n2+0],Ke[3*n1+1][3*n2+1],Ke[3*n1+1][3*n2+2]),
-                        Coord(Ke[3*n1+2][3*n2+0],Ke[3*n1+2][3*n2+1],Ke[3*n1+2][3*n2+2])) ) * Rot;
+                Mat33 tmp(type::NOINIT);
+                K.getsub(3 * n1, 3 * n2, tmp);
 
                 dfdx(3 * node1, 3 * node2) += - tmp;
             }
         }
-    }
+    });
 }
 
 template<class DataTypes>
@@ -24,6 +24,8 @@
 
 #include <sofa/core/behavior/ForceField.h>
 #include <sofa/core/topology/TopologyData.h>
+#include <sofa/core/topology/ElementColoring.h>
+#include <sofa/simulation/TaskScheduler.h>
 #include <sofa/type/vector.h>
 #include <sofa/type/Vec.h>
 #include <sofa/type/Mat.h>
@@ -153,6 +155,7 @@ public:
     Data<sofa::type::RGBAColor> drawColor3; ///<  draw color for faces 3
     Data<sofa::type::RGBAColor> drawColor4; ///<  draw color for faces 4
     Data<std::map < std::string, sofa::type::vector<double> > > _volumeGraph;
+    Data<bool> d_multithreading; ///< Compute the forces and their derivatives in parallel, the tetrahedra being processed by colors of independent elements
 
     /// Link to be set to the topology container in the component graph. 
     SingleLink<TetrahedralCorotationalFEMForceField<DataTypes>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_topology;
@@ -161,6 +164,10 @@ protected:
 
     /// Pointer to the topology container. Will be set by link @sa l_topology
     sofa::core::topology::BaseMeshTopology* m_topology;
+
+    /// Colors of tetrahedra sharing no vertex, processed in parallel if d_multithreading is set
+    core::topology::ElementColoring m_elementColoring;
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
 public:
 
     void setPoissonRatio(Real val) { this->_poissonRatio.setValue(val); }
@@ -234,16 +241,26 @@ protected:
     ////////////// large displacements method
     void initLarge(int i, Index&a, Index&b, Index&c, Index&d);
     void computeRotationLarge( Transformation &r, const Vector &p, const Index &a, const Index &b, const Index &c);
-    void accumulateForceLarge( Vector& f, const Vector & p, Index elementIndex );
+    void accumulateForceLarge( Vector& f, const Vector & p, Index elementIndex, type::vector<TetrahedronInformation>& tetrahedronInf );
     void applyStiffnessLarge( Vector& f, const Vector& x, int i=0, Index a=0,Index b=1,Index c=2,Index d=3, SReal fact=1.0 );
 
     ////////////// polar decomposition method
     void initPolar(int i, Index&a, Index&b, Index&c, Index&d);
-    void accumulateForcePolar( Vector& f, const Vector & p,Index elementIndex );
+    void accumulateForcePolar( Vector& f, const Vector & p,Index elementIndex, type::vector<TetrahedronInformation>& tetrahedronInf );
     void applyStiffnessPolar( Vector& f, const Vector& x, int i=0, Index a=0,Index b=1,Index c=2,Index d=3, SReal fact=1.0 );
 
     void printStiffnessMatrix(int idTetra);
 
+    /// Call f on each tetrahedron, color after color, the tetrahedra of a color being processed in parallel.
+    /// The tetrahedra are processed sequentially if f is not thread-safe
+    template<class F>
+    void forEachElementByColor(F f, bool isThreadSafe = true);
+
+    /// Call assemble(i, K) on the stiffness matrix K of each tetrahedron i, rotated in the world frame. The matrices
+    /// are computed in parallel if d_multithreading is set, and assembled one after the other
+    template<class F>
+    void forEachRotatedElementStiffness(F assemble);
+
 };
 
 #if !defined(SOFA_COMPONENT_FORCEFIELD_TETRAHEDRALCOROTATIONALFEMFORCEFIELD_CPP)
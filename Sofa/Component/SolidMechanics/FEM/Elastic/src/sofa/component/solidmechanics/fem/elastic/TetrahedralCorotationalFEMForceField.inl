@@ -25,6 +25,8 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/helper/decompose.h>
 #include <sofa/core/topology/TopologyData.inl>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 
 namespace sofa::component::solidmechanics::fem::elastic
@@ -79,6 +81,7 @@ TetrahedralCorotationalFEMForceField<DataTypes>::TetrahedralCorotationalFEMForce
     , drawColor2(initData(&drawColor2,sofa::type::RGBAColor(0.0f,0.5f,1.0f,1.0f),"drawColor2"," draw color for faces 2"))
     , drawColor3(initData(&drawColor3,sofa::type::RGBAColor(0.0f,1.0f,1.0f,1.0f),"drawColor3"," draw color for faces 3"))
     , drawColor4(initData(&drawColor4,sofa::type::RGBAColor(0.5f,1.0f,1.0f,1.0f),"drawColor4"," draw color for faces 4"))
+    , d_multithreading(initData(&d_multithreading,false,"multithreading","Compute the forces and their derivatives in parallel, the tetrahedra being processed by colors of independent elements"))
     , l_topology(initLink("topology", "link to the topology container"))
 {
     this->addAlias(&_assembling, "assembling");
@@ -114,6 +117,19 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::init()
         msg_warning() << "No tetrahedra found in linked Topology.";
     }
 
+    m_taskScheduler = nullptr;
+    if (d_multithreading.getValue())
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+    m_elementColoring.invalidate();
+
     reinit(); // compute per-element stiffness matrices and other precomputed values
 }
 
@@ -165,33 +181,44 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::addForce(const core::Mecha
     VecDeriv& f = *d_f.beginEdit();
     const VecCoord& p = d_x.getValue();
 
+    // the tetrahedron information is edited once for all the elements, which can then be processed concurrently
+    type::vector<TetrahedronInformation>& tetrahedronInf = *(tetrahedronInfo.beginEdit());
+
+    // make sure the topology and the rest positions are up-to-date before they are read concurrently
+    m_topology->getTetrahedra();
+    this->mstate->read(core::ConstVecCoordId::restPosition())->getValue();
+
+    // the assembled stiffness matrix is shared by the elements
+    const bool isThreadSafe = !_assembling.getValue();
+
     switch(method)
     {
     case SMALL :
     {
-        for(Size i = 0 ; i<m_topology->getNbTetrahedra(); ++i)
+        forEachElementByColor([&](const Index i)
         {
             accumulateForceSmall( f, p, i );
-        }
+        }, isThreadSafe);
         break;
     }
     case LARGE :
     {
-        for(Size i = 0 ; i<m_topology->getNbTetrahedra(); ++i)
+        forEachElementByColor([&](const Index i)
         {
-            accumulateForceLarge( f, p, i );
-        }
+            accumulateForceLarge( f, p, i, tetrahedronInf );
+        }, isThreadSafe);
         break;
     }
     case POLAR :
     {
-        for(Size i = 0 ; i<m_topology->getNbTetrahedra(); ++i)
+        forEachElementByColor([&](const Index i)
         {
-            accumulateForcePolar( f, p, i );
-        }
+            accumulateForcePolar( f, p, i, tetrahedronInf );
+        }, isThreadSafe);
         break;
     }
     }
+    tetrahedronInfo.endEdit();
     d_f.endEdit();
 }
 
@@ -204,33 +231,36 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::addDForce(const core::Mech
     Real kFactor = (Real)sofa::core::mechanicalparams::kFactorIncludingRayleighDamping(mparams, this->rayleighStiffness.getValue());
     const auto& tetraArray = m_topology->getTetrahedra();
 
+    // make sure the tetrahedron information is up-to-date before it is read concurrently
+    tetrahedronInfo.getValue();
+
     switch(method)
     {
     case SMALL :
     {
-        for(Size tetraId = 0; tetraId<tetraArray.size(); ++tetraId)
+        forEachElementByColor([&](const Index tetraId)
         {
             const core::topology::BaseMeshTopology::Tetrahedron& tetra = tetraArray[tetraId];
             applyStiffnessSmall( df, dx, tetraId, tetra[0], tetra[1], tetra[2], tetra[3], kFactor );
-        }
+        });
         break;
     }
     case LARGE :
     {
-        for(Size tetraId = 0; tetraId<tetraArray.size(); ++tetraId)
+        forEachElementByColor([&](const Index tetraId)
         {
             const core::topology::BaseMeshTopology::Tetrahedron& tetra = tetraArray[tetraId];
             applyStiffnessLarge( df, dx, tetraId, tetra[0], tetra[1], tetra[2], tetra[3], kFactor );
-        }
+        });
         break;
     }
     case POLAR :
     {
-        for(Size tetraId = 0; tetraId<tetraArray.size(); ++tetraId)
+        forEachElementByColor([&](const Index tetraId)
         {
             const core::topology::BaseMeshTopology::Tetrahedron& tetra = tetraArray[tetraId];
             applyStiffnessPolar( df, dx, tetraId, tetra[0], tetra[1], tetra[2], tetra[3], kFactor );
-        }
+        });
         break;
     }
     }
@@ -238,6 +268,27 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::addDForce(const core::Mech
     d_df.endEdit();
 }
 
+template<class DataTypes>
+template<class F>
+void TetrahedralCorotationalFEMForceField<DataTypes>::forEachElementByColor(F f, const bool isThreadSafe)
+{
+    const auto nbElements = static_cast<Index>(m_topology->getNbTetrahedra());
+
+    if (m_taskScheduler == nullptr || !isThreadSafe)
+    {
+        for (Index i = 0; i < nbElements; ++i)
+        {
+            f(i);
+        }
+        return;
+    }
+
+    // the colors are computed again only if the topology changed
+    m_elementColoring.update(m_topology, sofa::geometry::ElementType::TETRAHEDRON);
+
+    simulation::parallelForEachColor(*m_taskScheduler, m_elementColoring.getColors(), f);
+}
+
 template<class DataTypes>
 void TetrahedralCorotationalFEMForceField<DataTypes>::computeStrainDisplacement( StrainDisplacementTransposed &J, Coord a, Coord b, Coord c, Coord d )
 {
@@ -923,12 +974,10 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::initLarge(int i, Index&a,
 }
 
 template<class DataTypes>
-void TetrahedralCorotationalFEMForceField<DataTypes>::accumulateForceLarge( Vector& f, const Vector & p, Index elementIndex )
+void TetrahedralCorotationalFEMForceField<DataTypes>::accumulateForceLarge( Vector& f, const Vector & p, Index elementIndex, type::vector<TetrahedronInformation>& tetrahedronInf )
 {
     const core::topology::BaseMeshTopology::Tetrahedron t=m_topology->getTetrahedron(elementIndex);
 
-    type::vector<typename TetrahedralCorotationalFEMForceField<DataTypes>::TetrahedronInformation>& tetrahedronInf = *(tetrahedronInfo.beginEdit());
-
     // Rotation matrix (deformed and displaced Tetrahedron/world)
     Transformation R_0_2;
     computeRotationLarge( R_0_2, p, t[0],t[1],t[2]);
@@ -1036,8 +1085,6 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::accumulateForceLarge( Vect
         for(int i=0; i<12; i+=3)
             f[t[i/3]] += Deriv( F[i], F[i+1],  F[i+2] );
     }
-
-    tetrahedronInfo.endEdit();
 }
 
 template<class DataTypes>
@@ -1112,7 +1159,7 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::initPolar(int i, Index& a,
 }
 
 template<class DataTypes>
-void TetrahedralCorotationalFEMForceField<DataTypes>::accumulateForcePolar( Vector& f, const Vector & p, Index elementIndex )
+void TetrahedralCorotationalFEMForceField<DataTypes>::accumulateForcePolar( Vector& f, const Vector & p, Index elementIndex, type::vector<TetrahedronInformation>& tetrahedronInf )
 {
     const core::topology::BaseMeshTopology::Tetrahedron t=m_topology->getTetrahedron(elementIndex);
 
@@ -1124,8 +1171,6 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::accumulateForcePolar( Vect
     Transformation R_0_2;
     helper::Decompose<Real>::polarDecomposition(A, R_0_2);
 
-    type::vector<typename TetrahedralCorotationalFEMForceField<DataTypes>::TetrahedronInformation>& tetrahedronInf = *(tetrahedronInfo.beginEdit());
-
     tetrahedronInf[elementIndex].rotation.transpose( R_0_2 );
 
     // positions of the deformed and displaced Tetrahedre in its frame
@@ -1165,14 +1210,12 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::accumulateForcePolar( Vect
     {
         msg_error() << "TODO(TetrahedralCorotationalFEMForceField): support for assembling system matrix when using polar method.";
     }
-
-    tetrahedronInfo.endEdit();
 }
 
 template<class DataTypes>
 void TetrahedralCorotationalFEMForceField<DataTypes>::applyStiffnessPolar( Vector& f, const Vector& x, int i, Index a, Index b, Index c, Index d, SReal fact )
 {
-    type::vector<typename TetrahedralCorotationalFEMForceField<DataTypes>::TetrahedronInformation>& tetrahedronInf = *(tetrahedronInfo.beginEdit());
+    const type::vector<typename TetrahedralCorotationalFEMForceField<DataTypes>::TetrahedronInformation>& tetrahedronInf = tetrahedronInfo.getValue();
 
     Transformation R_0_2;
     R_0_2.transpose( tetrahedronInf[i].rotation );
@@ -1208,8 +1251,6 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::applyStiffnessPolar( Vecto
     f[b] -= tetrahedronInf[i].rotation * Deriv( F[3], F[4],  F[5] );
     f[c] -= tetrahedronInf[i].rotation * Deriv( F[6], F[7],  F[8] );
     f[d] -= tetrahedronInf[i].rotation * Deriv( F[9], F[10], F[11] );
-
-    tetrahedronInfo.endEdit();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -1303,56 +1344,79 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::draw(const core::visual::V
 
 
 template<class DataTypes>
-void TetrahedralCorotationalFEMForceField<DataTypes>::addKToMatrix(sofa::linearalgebra::BaseMatrix *mat, SReal k, unsigned int &offset)
+template<class F>
+void TetrahedralCorotationalFEMForceField<DataTypes>::forEachRotatedElementStiffness(F assemble)
 {
-    // Build Matrix Block for this ForceField
-    Transformation Rot;
-    StiffnessMatrix JKJt,tmp;
+    Transformation identity;
+    identity.identity();
 
-    const type::vector<typename TetrahedralCorotationalFEMForceField<DataTypes>::TetrahedronInformation>& tetrahedronInf = tetrahedronInfo.getValue();
+    const type::vector<TetrahedronInformation>& tetrahedronInf = tetrahedronInfo.getValue();
+    const std::size_t nbElements = m_topology->getNbTetrahedra();
 
-    Rot[0][0]=Rot[1][1]=Rot[2][2]=1;
-    Rot[0][1]=Rot[0][2]=0;
-    Rot[1][0]=Rot[1][2]=0;
-    Rot[2][0]=Rot[2][1]=0;
-    const sofa::core::topology::BaseMeshTopology::SeqTetrahedra& tetras = m_topology->getTetrahedra();
-    for(int IT=0 ; IT != (int)tetras.size() ; ++IT)
+    const auto computeRange = [this, &tetrahedronInf, &identity](const auto& range)
     {
-        if (method == SMALL)
-            computeStiffnessMatrix(JKJt,tmp,tetrahedronInf[IT].materialMatrix,tetrahedronInf[IT].strainDisplacementTransposedMatrix,Rot);
-        else
-            computeStiffnessMatrix(JKJt,tmp,tetrahedronInf[IT].materialMatrix,tetrahedronInf[IT].strainDisplacementTransposedMatrix,tetrahedronInf[IT].rotation);
+        type::vector<StiffnessMatrix> rotatedStiffnesses(range.end - range.start);
+        auto RJKJtRt = rotatedStiffnesses.begin();
+        for (auto tetraId = range.start; tetraId != range.end; ++tetraId, ++RJKJtRt)
+        {
+            StiffnessMatrix JKJt;
+            const auto& rotation = method == SMALL ? identity : tetrahedronInf[tetraId].rotation;
+            computeStiffnessMatrix(JKJt, *RJKJtRt, tetrahedronInf[tetraId].materialMatrix,
+                                   tetrahedronInf[tetraId].strainDisplacementTransposedMatrix, rotation);
+        }
+        return rotatedStiffnesses;
+    };
+
+    const auto assembleRange = [&assemble](const auto& range, type::vector<StiffnessMatrix>& rotatedStiffnesses)
+    {
+        auto RJKJtRt = rotatedStiffnesses.begin();
+        for (auto tetraId = range.start; tetraId != range.end; ++tetraId, ++RJKJtRt)
+        {
+            assemble(static_cast<Index>(tetraId), *RJKJtRt);
+        }
+    };
 
-        const core::topology::BaseMeshTopology::Tetrahedron t=tetras[IT];
-        Inherit1::addToMatrix(mat, offset, t, tmp, -k);
+    // the matrices of a chunk of elements are stored until they are assembled
+    static constexpr std::size_t chunkSize = 1024;
+    for (std::size_t first = 0; first < nbElements; first += chunkSize)
+    {
+        const std::size_t last = std::min(first + chunkSize, nbElements);
+        if (m_taskScheduler != nullptr)
+        {
+            simulation::parallelForEachRangeWithMerge(*m_taskScheduler, first, last, computeRange, assembleRange);
+        }
+        else
+        {
+            simulation::forEachRangeWithMerge(first, last, computeRange, assembleRange);
+        }
     }
 }
 
+template<class DataTypes>
+void TetrahedralCorotationalFEMForceField<DataTypes>::addKToMatrix(sofa::linearalgebra::BaseMatrix *mat, SReal k, unsigned int &offset)
+{
+    // Build Matrix Block for this ForceField
+    const sofa::core::topology::BaseMeshTopology::SeqTetrahedra& tetras = m_topology->getTetrahedra();
+
+    forEachRotatedElementStiffness([&](const Index tetraId, const StiffnessMatrix& RJKJtRt)
+    {
+        const core::topology::BaseMeshTopology::Tetrahedron t=tetras[tetraId];
+        Inherit1::addToMatrix(mat, offset, t, RJKJtRt, -k);
+    });
+}
+
 template <class DataTypes>
 void TetrahedralCorotationalFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::StiffnessMatrix* matrix)
 {
-    StiffnessMatrix JKJt, RJKJtRt;
     sofa::type::Mat<3, 3, Real> localMatrix(type::NOINIT);
 
-    static constexpr Transformation identity = []
-    {
-        Transformation i;
-        i.identity();
-        return i;
-    }();
-
-    const type::vector<TetrahedronInformation>& tetrahedronInf = tetrahedronInfo.getValue();
     const sofa::core::topology::BaseMeshTopology::SeqTetrahedra& tetrahedra = m_topology->getTetrahedra();
 
     auto dfdx = matrix->getForceDerivativeIn(this->mstate)
                        .withRespectToPositionsIn(this->mstate);
 
-    for (std::size_t tetraId = 0; tetraId != tetrahedra.size(); ++tetraId)
+    forEachRotatedElementStiffness([&](const Index tetraId, const StiffnessMatrix& RJKJtRt)
     {
-        const auto& rotation = method == SMALL ? identity : tetrahedronInf[tetraId].rotation;
-        computeStiffnessMatrix(JKJt, RJKJtRt, tetrahedronInf[tetraId].materialMatrix,
-                               tetrahedronInf[tetraId].strainDisplacementTransposedMatrix, rotation);
-
         const core::topology::BaseMeshTopology::Tetrahedron tetra = tetrahedra[tetraId];
 
         static constexpr auto S = DataTypes::deriv_total_size; // size of node blocks
@@ -1364,7 +1428,7 @@ void TetrahedralCorotationalFEMForceField<DataTypes>::buildStiffnessMatrix(core:
                 dfdx(S * tetra[n1], S * tetra[n2]) += -localMatrix;
             }
         }
-    }
+    });
 }
 template <class DataTypes>
 void TetrahedralCorotationalFEMForceField<DataTypes>::buildDampingMatrix(core::behavior::DampingMatrix*)
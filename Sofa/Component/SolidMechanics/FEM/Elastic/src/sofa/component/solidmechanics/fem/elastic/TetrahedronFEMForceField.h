@@ -275,6 +275,10 @@ public:
     void init() override;
     void reinit() override;
 
+    /// The element rotations, strain-displacement matrices and plastic strains evolve during the simulation
+    void storeInternalState(std::ostream& out) const override;
+    void restoreInternalState(std::istream& in) override;
+
     void addForce(const core::MechanicalParams* mparams, DataVecDeriv& d_f, const DataVecCoord& d_x, const DataVecDeriv& d_v) override;
     void addDForce(const core::MechanicalParams* mparams, DataVecDeriv& d_df, const DataVecDeriv& d_dx) override;
 
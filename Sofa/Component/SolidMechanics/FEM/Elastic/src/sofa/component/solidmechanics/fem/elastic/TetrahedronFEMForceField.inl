@@ -31,6 +31,7 @@
 #include <sofa/simulation/AnimateBeginEvent.h>
 #include <sofa/simulation/AnimateEndEvent.h>
 #include <sofa/core/behavior/BaseLocalForceFieldMatrix.h>
+#include <sofa/helper/io/BinaryStream.h>
 
 namespace sofa::component::solidmechanics::fem::elastic
 {
@@ -1520,6 +1521,25 @@ void TetrahedronFEMForceField<DataTypes>::reset()
 }
 
 
+template <class DataTypes>
+void TetrahedronFEMForceField<DataTypes>::storeInternalState(std::ostream& out) const
+{
+    helper::io::binary::write(out, rotations);
+    helper::io::binary::write(out, strainDisplacements);
+    helper::io::binary::write(out, _plasticStrains);
+}
+
+template <class DataTypes>
+void TetrahedronFEMForceField<DataTypes>::restoreInternalState(std::istream& in)
+{
+    if (!helper::io::binary::read(in, rotations)
+        || !helper::io::binary::read(in, strainDisplacements)
+        || !helper::io::binary::read(in, _plasticStrains))
+    {
+        msg_error() << "Cannot restore the element rotations and strains";
+    }
+}
+
 template <class DataTypes>
 inline void TetrahedronFEMForceField<DataTypes>::reinit()
 {
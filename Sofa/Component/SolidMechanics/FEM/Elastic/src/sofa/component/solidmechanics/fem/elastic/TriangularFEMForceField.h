@@ -28,6 +28,8 @@
 #include <sofa/defaulttype/VecTypes.h>
 #include <sofa/type/Mat.h>
 #include <sofa/core/topology/TopologyData.h>
+#include <sofa/core/topology/ElementColoring.h>
+#include <sofa/simulation/TaskScheduler.h>
 
 #ifdef PLOT_CURVE
 #include <map>
@@ -247,8 +249,21 @@ protected :
     void accumulateForceLarge( VecCoord& f, const VecCoord & p);
     void applyStiffnessLarge( VecCoord& f, Real h, const VecCoord& x, const Real &kFactor );
 
+    /// Call f on each triangle, color after color, the triangles of a color being processed in parallel
+    template<class F>
+    void forEachElementByColor(F f);
+
+    /// Call assemble(i, K) on the stiffness matrix K of each triangle i, rotated in the world frame. The matrices
+    /// are computed in parallel if d_multithreading is set, and assembled one after the other
+    template<class F>
+    void forEachRotatedElementStiffness(F assemble);
+
     bool updateMatrix;
 
+    /// Colors of triangles sharing no vertex, processed in parallel if d_multithreading is set
+    core::topology::ElementColoring m_elementColoring;
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+
 public:
 
     /// Forcefield intern paramaters
@@ -271,6 +286,7 @@ public:
     Data<bool> showFracturableTriangles; ///< Flag activating rendering of triangles to fracture
 
     Data<bool> f_computePrincipalStress; ///< Compute principal stress for each triangle
+    Data<bool> d_multithreading; ///< Compute the forces and their derivatives in parallel, the triangles being processed by colors of independent elements
 
     /// Link to be set to the topology container in the component graph.
     SingleLink<TriangularFEMForceField<DataTypes>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_topology;
@@ -28,8 +28,11 @@
 #include <sofa/type/RGBAColor.h>
 
 #include <sofa/core/topology/TopologyData.inl>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 #include <Eigen/SVD>
+#include <atomic>
 #include <limits>
 
 namespace sofa::component::solidmechanics::fem::elastic
@@ -57,6 +60,7 @@ TriangularFEMForceField<DataTypes>::TriangularFEMForceField()
     , showStressVector(initData(&showStressVector, false, "showStressVector", "Flag activating rendering of stress directions within each triangle"))
     , showFracturableTriangles(initData(&showFracturableTriangles, false, "showFracturableTriangles", "Flag activating rendering of triangles to fracture"))
     , f_computePrincipalStress(initData(&f_computePrincipalStress, false, "computePrincipalStress", "Compute principal stress for each triangle"))
+    , d_multithreading(initData(&d_multithreading, false, "multithreading", "Compute the forces and their derivatives in parallel, the triangles being processed by colors of independent elements"))
     , l_topology(initLink("topology", "link to the topology container"))
 #ifdef PLOT_CURVE
     , elementID(initData(&elementID, (Real)0, "id", "element id to follow in the graphs"))
@@ -146,6 +150,19 @@ void TriangularFEMForceField<DataTypes>::init()
     else if (f_method.getValue() == "large")
         method = LARGE;
 
+    m_taskScheduler = nullptr;
+    if (d_multithreading.getValue())
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+    m_elementColoring.invalidate();
+
     reinit();
 }
 
@@ -396,27 +413,85 @@ void TriangularFEMForceField<DataTypes>::computeElementStiffnessMatrix(type::Mat
 }
 
 template <class DataTypes>
-void TriangularFEMForceField<DataTypes>::addKToMatrix(sofa::linearalgebra::BaseMatrix* mat, SReal k, unsigned int& offset)
+template <class F>
+void TriangularFEMForceField<DataTypes>::forEachElementByColor(F f)
+{
+    const auto nbTriangles = static_cast<sofa::Index>(m_topology->getNbTriangles());
+
+    if (m_taskScheduler == nullptr)
+    {
+        for (sofa::Index i = 0; i < nbTriangles; ++i)
+        {
+            f(i);
+        }
+        return;
+    }
+
+    // the colors are computed again only if the topology changed
+    m_elementColoring.update(m_topology, sofa::geometry::ElementType::TRIANGLE);
+
+    simulation::parallelForEachColor(*m_taskScheduler, m_elementColoring.getColors(), f);
+}
+
+template <class DataTypes>
+template <class F>
+void TriangularFEMForceField<DataTypes>::forEachRotatedElementStiffness(F assemble)
 {
     const auto& triangleInf = triangleInfo.getValue();
-    const auto& triangles = m_topology->getTriangles();
-    const auto nbTriangles = m_topology->getNbTriangles();
+    const std::size_t nbTriangles = m_topology->getNbTriangles();
 
-    for (sofa::Index i = 0; i < nbTriangles; i++)
+    const auto computeRange = [this, &triangleInf](const auto& range)
     {
-        const TriangleInformation& tInfo = triangleInf[i];
-        const Triangle& tri = triangles[i];
+        type::vector<type::Mat<9, 9, Real> > rotatedStiffnesses(range.end - range.start);
+        auto RJKJtRt = rotatedStiffnesses.begin();
+        for (auto i = range.start; i != range.end; ++i, ++RJKJtRt)
+        {
+            const TriangleInformation& tInfo = triangleInf[i];
+            type::Mat<9, 9, Real> JKJt(type::NOINIT);
+            computeElementStiffnessMatrix(JKJt, *RJKJtRt, tInfo.materialMatrix, tInfo.strainDisplacementMatrix, tInfo.rotation);
+        }
+        return rotatedStiffnesses;
+    };
+
+    const auto assembleRange = [&assemble](const auto& range, type::vector<type::Mat<9, 9, Real> >& rotatedStiffnesses)
+    {
+        auto RJKJtRt = rotatedStiffnesses.begin();
+        for (auto i = range.start; i != range.end; ++i, ++RJKJtRt)
+        {
+            assemble(static_cast<sofa::Index>(i), *RJKJtRt);
+        }
+    };
 
-        type::Mat<9, 9, Real> JKJt(type::NOINIT), RJKJtRt(type::NOINIT);
-        computeElementStiffnessMatrix(JKJt, RJKJtRt, tInfo.materialMatrix, tInfo.strainDisplacementMatrix, tInfo.rotation);
-        this->addToMatrix(mat, offset, tri, RJKJtRt, -k);
+    // the matrices of a chunk of elements are stored until they are assembled
+    static constexpr std::size_t chunkSize = 1024;
+    for (std::size_t first = 0; first < nbTriangles; first += chunkSize)
+    {
+        const std::size_t last = std::min(first + chunkSize, nbTriangles);
+        if (m_taskScheduler != nullptr)
+        {
+            simulation::parallelForEachRangeWithMerge(*m_taskScheduler, first, last, computeRange, assembleRange);
+        }
+        else
+        {
+            simulation::forEachRangeWithMerge(first, last, computeRange, assembleRange);
+        }
     }
 }
 
+template <class DataTypes>
+void TriangularFEMForceField<DataTypes>::addKToMatrix(sofa::linearalgebra::BaseMatrix* mat, SReal k, unsigned int& offset)
+{
+    const auto& triangles = m_topology->getTriangles();
+
+    forEachRotatedElementStiffness([&](const sofa::Index i, const type::Mat<9, 9, Real>& RJKJtRt)
+    {
+        this->addToMatrix(mat, offset, triangles[i], RJKJtRt, -k);
+    });
+}
+
 template <class DataTypes>
 void TriangularFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::StiffnessMatrix* matrix)
 {
-    type::Mat<9, 9, Real> JKJt, RJKJtRt;
     sofa::type::Mat<3, 3, Real> localMatrix(type::NOINIT);
 
     constexpr auto S = DataTypes::deriv_total_size; // size of node blocks
@@ -424,17 +499,12 @@ void TriangularFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
     auto dfdx = matrix->getForceDerivativeIn(this->mstate)
                        .withRespectToPositionsIn(this->mstate);
 
-    const auto& triangleInf = triangleInfo.getValue();
     const auto& triangles = m_topology->getTriangles();
-    const auto nbTriangles = m_topology->getNbTriangles();
 
-    for (sofa::Index i = 0; i < nbTriangles; i++)
+    forEachRotatedElementStiffness([&](const sofa::Index i, const type::Mat<9, 9, Real>& RJKJtRt)
     {
-        const TriangleInformation& tInfo = triangleInf[i];
         const Triangle& tri = triangles[i];
 
-        computeElementStiffnessMatrix(JKJt, RJKJtRt, tInfo.materialMatrix, tInfo.strainDisplacementMatrix, tInfo.rotation);
-
         for (sofa::Index n1 = 0; n1 < Element::size(); ++n1)
         {
             for (sofa::Index n2 = 0; n2 < Element::size(); ++n2)
@@ -443,7 +513,7 @@ void TriangularFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
                 dfdx(tri[n1] * S, tri[n2] * S) += -localMatrix;
             }
         }
-    }
+    });
 }
 
 template <class DataTypes>
@@ -1010,17 +1080,17 @@ void TriangularFEMForceField<DataTypes>::computeStressAlongDirection(Real& stres
 template <class DataTypes>
 void TriangularFEMForceField<DataTypes>::applyStiffnessSmall(VecCoord& v, Real h, const VecCoord& x, const Real& kFactor)
 {
-    Displacement dX;
-    type::vector<TriangleInformation>& triangleInf = *(triangleInfo.beginEdit());
-    const unsigned int nbTriangles = m_topology->getNbTriangles();
-    for (unsigned int i = 0; i < nbTriangles; i++)
+    const type::vector<TriangleInformation>& triangleInf = triangleInfo.getValue();
+    const auto& triangles = m_topology->getTriangles();
+    forEachElementByColor([&](const sofa::Index i)
     {
-        TriangleInformation& tInfo = triangleInf[i];
-        const Triangle& tri = m_topology->getTriangle(i);
+        const TriangleInformation& tInfo = triangleInf[i];
+        const Triangle& tri = triangles[i];
         Index a = tri[0];
         Index b = tri[1];
         Index c = tri[2];
 
+        Displacement dX;
         dX[0] = x[a][0];
         dX[1] = x[a][1];
 
@@ -1046,8 +1116,7 @@ void TriangularFEMForceField<DataTypes>::applyStiffnessSmall(VecCoord& v, Real h
         v[a] += (Coord(-h * F[0], -h * F[1], 0)) * kFactor;
         v[b] += (Coord(-h * F[2], -h * F[3], 0)) * kFactor;
         v[c] += (Coord(-h * F[4], -h * F[5], 0)) * kFactor;
-    }
-    triangleInfo.endEdit();
+    });
 }
 
 
@@ -1070,15 +1139,11 @@ void TriangularFEMForceField<DataTypes>::applyStiffness(VecCoord& v, Real h, con
 template <class DataTypes>
 void TriangularFEMForceField<DataTypes>::applyStiffnessLarge(VecCoord& v, Real h, const VecCoord& x, const Real& kFactor)
 {
-    Displacement dX;
-    Coord x_2;
-    type::vector<TriangleInformation>& triangleInf = *(triangleInfo.beginWriteOnly());
-
-    const unsigned int nbTriangles = m_topology->getNbTriangles();
+    const type::vector<TriangleInformation>& triangleInf = triangleInfo.getValue();
     const auto& triangles = m_topology->getTriangles();
-    for (unsigned int i = 0; i < nbTriangles; i++)
+    forEachElementByColor([&](const sofa::Index i)
     {
-        TriangleInformation& tInfo = triangleInf[i];
+        const TriangleInformation& tInfo = triangleInf[i];
         const Element& tri = triangles[i];
         const Index a = tri[0];
         const Index b = tri[1];
@@ -1087,7 +1152,8 @@ void TriangularFEMForceField<DataTypes>::applyStiffnessLarge(VecCoord& v, Real h
         Transformation R_0_2;
         R_0_2.transpose(tInfo.rotation);
 
-        x_2 = R_0_2 * x[a];
+        Displacement dX;
+        Coord x_2 = R_0_2 * x[a];
         dX[0] = x_2[0];
         dX[1] = x_2[1];
 
@@ -1114,8 +1180,7 @@ void TriangularFEMForceField<DataTypes>::applyStiffnessLarge(VecCoord& v, Real h
         v[a] += (tInfo.rotation * Coord(-h * F[0], -h * F[1], 0)) * kFactor;
         v[b] += (tInfo.rotation * Coord(-h * F[2], -h * F[3], 0)) * kFactor;
         v[c] += (tInfo.rotation * Coord(-h * F[4], -h * F[5], 0)) * kFactor;
-    }
-    triangleInfo.endEdit();
+    });
 }
 
 
@@ -1126,11 +1191,12 @@ template <class DataTypes>
 void TriangularFEMForceField<DataTypes>::accumulateForceSmall(VecCoord& f, const VecCoord& p)
 {
     type::vector<TriangleInformation>& triangleInf = *(triangleInfo.beginWriteOnly());
-    const unsigned int nbTriangles = m_topology->getNbTriangles();
-    for (unsigned int i = 0; i < nbTriangles; i++)
+    const auto& triangles = m_topology->getTriangles();
+    std::atomic_bool isInvalid { false };
+    forEachElementByColor([&](const sofa::Index i)
     {
         TriangleInformation& tInfo = triangleInf[i];
-        const Element& tri = m_topology->getTriangle(i);
+        const Element& tri = triangles[i];
         Index a = tri[0];
         Index b = tri[1];
         Index c = tri[2];
@@ -1153,9 +1219,9 @@ void TriangularFEMForceField<DataTypes>::accumulateForceSmall(VecCoord& f, const
         catch (const std::exception& e)
         {
             msg_error() << e.what();
-            sofa::core::objectmodel::BaseObject::d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
-            break;
-        }        
+            isInvalid = true;
+            return;
+        }
 
         // compute strain
         type::Vec<3, Real> strain(type::NOINIT);
@@ -1176,9 +1242,15 @@ void TriangularFEMForceField<DataTypes>::accumulateForceSmall(VecCoord& f, const
         tInfo.strainDisplacementMatrix = J;
         tInfo.strain = strain;
         tInfo.stress = stress;
-    }
+    });
 
     triangleInfo.endEdit();
+
+    // the component state is not set from the elements processed concurrently
+    if (isInvalid)
+    {
+        sofa::core::objectmodel::BaseObject::d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+    }
 }
 
 
@@ -1189,9 +1261,9 @@ template <class DataTypes>
 void TriangularFEMForceField<DataTypes>::accumulateForceLarge(VecCoord& f, const VecCoord& p)
 {
     type::vector<TriangleInformation>& triangleInf = *(triangleInfo.beginWriteOnly());
-    const sofa::Size nbTriangles = m_topology->getNbTriangles();
     const auto& triangles = m_topology->getTriangles();
-    for (sofa::Index i = 0; i < nbTriangles; i++)
+    std::atomic_bool isInvalid { false };
+    forEachElementByColor([&](const sofa::Index i)
     {
         TriangleInformation& tInfo = triangleInf[i];
         const Triangle& tri = triangles[i];
@@ -1221,9 +1293,9 @@ void TriangularFEMForceField<DataTypes>::accumulateForceLarge(VecCoord& f, const
         catch (const std::exception& e)
         {
             msg_error() << e.what();
-            sofa::core::objectmodel::BaseObject::d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
-            break;
-        }        
+            isInvalid = true;
+            return;
+        }
 
         // compute strain
         type::Vec<3, Real> strain(type::NOINIT);
@@ -1252,8 +1324,14 @@ void TriangularFEMForceField<DataTypes>::accumulateForceLarge(VecCoord& f, const
         tInfo.stress = stress;
         tInfo.rotation = R_2_0;
         //tInfo.stiffness = K;
-    }
+    });
     triangleInfo.endEdit();
+
+    // the component state is not set from the elements processed concurrently
+    if (isInvalid)
+    {
+        sofa::core::objectmodel::BaseObject::d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+    }
 }
 
 
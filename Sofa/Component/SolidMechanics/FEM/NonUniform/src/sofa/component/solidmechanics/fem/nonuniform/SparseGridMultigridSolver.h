@@ -0,0 +1,183 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/solidmechanics/fem/nonuniform/config.h>
+
+#include <sofa/component/linearsolver/iterative/MatrixLinearSolver.h>
+#include <sofa/component/solidmechanics/fem/elastic/HexahedronFEMForceField.h>
+#include <sofa/component/topology/container/grid/SparseGridTopology.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/helper/OptionsGroup.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+
+#include <array>
+
+namespace sofa::component::solidmechanics::fem::nonuniform
+{
+
+/**
+ * Preconditioner applying one geometric multigrid V-cycle, for the hexahedral finite elements of a
+ * HexahedronFEMForceField (or a derived force field) on a SparseGridTopology. It is meant to be linked as
+ * the preconditioner of a ShewchukPCGLinearSolver, which iterates on the exact, unassembled, operator of
+ * the scene.
+ *
+ * The levels of the V-cycle are the sparse grid of the force field and coarser sparse grids built from
+ * it, each one condensing 2x2x2 cubes of the previous one. The transfer operators are the trilinear
+ * interpolation weights computed by the sparse grids between two levels.
+ *
+ * Nothing is assembled but the coarsest level: the operator of the finest level is applied element by
+ * element from the stiffness matrices and the rotations of the force field, the operators of the
+ * coarser levels are stored per element as the Galerkin projections of the element matrices of
+ * their children. The smoothers (damped Jacobi or Chebyshev) process in parallel the elements of a
+ * same color, i.e. the cubes with the same parity of their coordinates in the grid, which do not
+ * share nodes.
+ *
+ * The mass, damping and other force fields acting on the nodes of the grid are approximated by the row
+ * sums of their contributions, and the fixed degrees of freedom (projective constraints) are removed
+ * from the finest level. The other mechanical states of the system are not preconditioned.
+ */
+template<class TMatrix, class TVector>
+class SparseGridMultigridSolver : public sofa::component::linearsolver::MatrixLinearSolver<TMatrix, TVector>
+{
+public:
+    SOFA_CLASS(SOFA_TEMPLATE2(SparseGridMultigridSolver,TMatrix,TVector),SOFA_TEMPLATE2(sofa::component::linearsolver::MatrixLinearSolver,TMatrix,TVector));
+
+    using Matrix = TMatrix;
+    using Vector = TVector;
+    using Real = typename Matrix::Real;
+    using Inherit = sofa::component::linearsolver::MatrixLinearSolver<TMatrix, TVector>;
+    using DataTypes = defaulttype::Vec3Types;
+    using FEMForceField = elastic::HexahedronFEMForceField<DataTypes>;
+    using SparseGrid = topology::container::grid::SparseGridTopology;
+    using Hexa = core::topology::BaseMeshTopology::Hexa;
+    using ElementMatrix = type::Mat<24, 24, Real>;
+    using EigenMatrix = Eigen::SparseMatrix<Real, Eigen::RowMajor>;
+
+    Data<unsigned int> d_maxNbLevels; ///< Maximum number of levels of the hierarchy
+    Data<unsigned int> d_maxCoarseSize; ///< The coarsening stops when the number of unknowns is below this value
+    Data<helper::OptionsGroup> d_smoother; ///< Smoother of the levels: Jacobi or Chebyshev
+    Data<unsigned int> d_nbSmoothingSteps; ///< Number of smoothing iterations before and after the coarse correction
+    Data<Real> d_jacobiDamping; ///< Damping factor of the Jacobi smoother
+    Data<Real> d_chebyshevRange; ///< Ratio between the largest and the smallest eigenvalues targeted by the Chebyshev smoother
+    Data<bool> d_multithreading; ///< Apply the operators and smooth the levels in parallel
+    Data<unsigned int> d_nbLevels; ///< Number of levels of the hierarchy
+
+    SingleLink<SparseGridMultigridSolver<TMatrix, TVector>, FEMForceField, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_forceField;
+
+    void init() override;
+    void reinit() override;
+
+    void setSystemMBKMatrix(const core::MechanicalParams* mparams) override;
+
+    /// x = M^-1 b, M^-1 being one V-cycle on the degrees of freedom of the force field
+    void solve(Matrix& A, Vector& x, Vector& b) override;
+
+protected:
+    SparseGridMultigridSolver();
+
+    struct Level
+    {
+        SparseGrid* grid { nullptr };
+        /// Grids built by the solver (null for the finest level, which is the grid of the force field)
+        typename SparseGrid::SPtr ownedGrid;
+
+        sofa::type::vector<Hexa> elements;
+        /// Elements of each color: two elements of a same color do not share any node
+        std::array<sofa::type::vector<sofa::Index>, 8> colors;
+
+        /// Element matrices of the coarse levels (the finest level uses the force field)
+        sofa::type::vector<ElementMatrix> elementMatrices;
+
+        /// Contribution of the mass, the damping and the other force fields, lumped on the diagonal
+        sofa::type::vector<Real> nodalTerm;
+        sofa::type::vector<Real> invDiagonal;
+        /// Upper bound of the spectrum of D^-1 A, for the Chebyshev smoother
+        Real lambdaMax { 0 };
+
+        /// Interpolation from the next level to this level, and its transpose
+        EigenMatrix prolongator;
+        EigenMatrix restriction;
+
+        sofa::type::vector<Real> x, b, r, d;
+
+        std::size_t size() const { return nodalTerm.size(); }
+    };
+
+    /// Coarse grids and transfer operators: built when the topology of the force field changes
+    void buildHierarchy();
+
+    /// Element matrices, diagonals and coarsest factorization, from the current state of the system
+    void updateOperators(Matrix& A, typename Inherit::TempVectorContainer& vtmp);
+
+    /// Element matrices of the level l+1, Galerkin projections of the element matrices of the level l
+    void computeCoarseElementMatrices(std::size_t l);
+
+    /// Matrix of the element e of the level l, in the global frame and scaled as in the system.
+    /// On the finest level, the fixed degrees of freedom are removed.
+    void getElementMatrix(std::size_t l, sofa::Index e, ElementMatrix& K);
+
+    void computeDiagonal(std::size_t l);
+    void estimateLargestEigenvalue(std::size_t l);
+    void factorizeCoarsestLevel();
+
+    /// y = A_l x
+    void applyOperator(std::size_t l, const sofa::type::vector<Real>& x, sofa::type::vector<Real>& y);
+
+    void vcycle(std::size_t l);
+    void smooth(std::size_t l, unsigned int nbSteps);
+    void smoothJacobi(std::size_t l, unsigned int nbSteps);
+    void smoothChebyshev(std::size_t l, unsigned int nbSteps);
+
+    /// y = M x, the rows being computed in parallel
+    void multiply(const EigenMatrix& M, const Real* x, Real* y);
+
+    template<class F>
+    void forEachRow(int n, F f);
+
+    /// Call f on each element of the level l, the elements of a same color being processed in parallel
+    template<class F>
+    void forEachElement(std::size_t l, F f);
+
+    FEMForceField* m_forceField { nullptr };
+    core::behavior::MechanicalState<DataTypes>* m_mstate { nullptr };
+
+    std::vector<Level> m_levels;
+    /// Degrees of freedom of the finest level removed by the projective constraints
+    sofa::type::vector<bool> m_isFixed;
+    /// Factor of the stiffness of the force field in the system
+    Real m_stiffnessFactor { 0 };
+
+    bool m_needsUpdate { true };
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<Real> > m_coarseSolver;
+    bool m_isCoarseSolverValid { false };
+
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+};
+
+#if !defined(SOFA_COMPONENT_SOLIDMECHANICS_FEM_NONUNIFORM_SPARSEGRIDMULTIGRIDSOLVER_CPP)
+extern template class SOFA_COMPONENT_SOLIDMECHANICS_FEM_NONUNIFORM_API SparseGridMultigridSolver< linearsolver::GraphScatteredMatrix, linearsolver::GraphScatteredVector >;
+#endif // !defined(SOFA_COMPONENT_SOLIDMECHANICS_FEM_NONUNIFORM_SPARSEGRIDMULTIGRIDSOLVER_CPP)
+
+} // namespace sofa::component::solidmechanics::fem::nonuniform
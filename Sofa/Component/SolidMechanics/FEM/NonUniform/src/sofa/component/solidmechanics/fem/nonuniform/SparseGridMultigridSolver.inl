@@ -0,0 +1,915 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/solidmechanics/fem/nonuniform/SparseGridMultigridSolver.h>
+#include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/core/objectmodel/BaseContext.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/helper/accessor.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sofa::component::solidmechanics::fem::nonuniform
+{
+
+template<class TMatrix, class TVector>
+SparseGridMultigridSolver<TMatrix,TVector>::SparseGridMultigridSolver()
+    : d_maxNbLevels(initData(&d_maxNbLevels, 10u, "maxNbLevels", "Maximum number of levels of the hierarchy"))
+    , d_maxCoarseSize(initData(&d_maxCoarseSize, 3000u, "maxCoarseSize", "The coarsening stops when the number of unknowns is below this value. "
+                                                                         "The coarsest level is factorized if its size is below this value, smoothed otherwise."))
+    , d_smoother(initData(&d_smoother, helper::OptionsGroup{{"Jacobi", "Chebyshev"}}.setSelectedItem(1), "smoother", "Smoother of the levels: damped Jacobi or Chebyshev iterations"))
+    , d_nbSmoothingSteps(initData(&d_nbSmoothingSteps, 2u, "nbSmoothingSteps", "Number of smoothing iterations before and after the coarse correction"))
+    , d_jacobiDamping(initData(&d_jacobiDamping, static_cast<Real>(0.6), "jacobiDamping", "Damping factor of the Jacobi smoother"))
+    , d_chebyshevRange(initData(&d_chebyshevRange, static_cast<Real>(30), "chebyshevRange", "Ratio between the largest and the smallest eigenvalues of D^-1 A damped by the Chebyshev smoother"))
+    , d_multithreading(initData(&d_multithreading, false, "multithreading", "Apply the operators and smooth the levels in parallel"))
+    , d_nbLevels(initData(&d_nbLevels, 0u, "nbLevels", "Number of levels of the hierarchy", true, true))
+    , l_forceField(initLink("forceField", "Hexahedral force field on a sparse grid. If not set, the first one found in the context is used."))
+{
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::init()
+{
+    Inherit1::init();
+
+    if (!l_forceField)
+    {
+        l_forceField.set(this->getContext()->template get<FEMForceField>(core::objectmodel::BaseContext::SearchDown));
+    }
+    if (!l_forceField)
+    {
+        msg_error() << "No hexahedral force field found: set the link 'forceField'";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    m_taskScheduler = nullptr;
+    if (d_multithreading.getValue())
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+
+    // the topology of the force field may not be initialized yet: the hierarchy is built at the first solve
+    m_levels.clear();
+    m_needsUpdate = true;
+    this->d_componentState.setValue(core::objectmodel::ComponentState::Valid);
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::reinit()
+{
+    m_levels.clear();
+    m_needsUpdate = true;
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::setSystemMBKMatrix(const core::MechanicalParams* mparams)
+{
+    Inherit::setSystemMBKMatrix(mparams);
+    m_needsUpdate = true;
+}
+
+template<class TMatrix, class TVector>
+template<class F>
+void SparseGridMultigridSolver<TMatrix,TVector>::forEachRow(const int n, F f)
+{
+    // below this number of rows, the loop is executed in the calling thread
+    static constexpr int minNbRowsParallel = 2048;
+
+    if (m_taskScheduler && n >= minNbRowsParallel)
+    {
+        simulation::parallelForEachRange(*m_taskScheduler, 0, n,
+            [&f](const auto& range)
+            {
+                for (auto i = range.start; i != range.end; ++i)
+                {
+                    f(i);
+                }
+            });
+    }
+    else
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            f(i);
+        }
+    }
+}
+
+template<class TMatrix, class TVector>
+template<class F>
+void SparseGridMultigridSolver<TMatrix,TVector>::forEachElement(const std::size_t l, F f)
+{
+    // below this number of elements in a color, the color is processed in the calling thread
+    static constexpr std::size_t minNbElementsParallel = 256;
+
+    for (const auto& color : m_levels[l].colors)
+    {
+        if (m_taskScheduler && color.size() >= minNbElementsParallel)
+        {
+            simulation::parallelForEachRange(*m_taskScheduler, color.begin(), color.end(),
+                [&f](const auto& range)
+                {
+                    for (auto it = range.start; it != range.end; ++it)
+                    {
+                        f(*it);
+                    }
+                });
+        }
+        else
+        {
+            for (const sofa::Index e : color)
+            {
+                f(e);
+            }
+        }
+    }
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::multiply(const EigenMatrix& M, const Real* x, Real* y)
+{
+    const int* outer = M.outerIndexPtr();
+    const int* inner = M.innerIndexPtr();
+    const Real* values = M.valuePtr();
+    forEachRow(static_cast<int>(M.rows()), [outer, inner, values, x, y](const int i)
+    {
+        Real s = 0;
+        for (int e = outer[i]; e < outer[i + 1]; ++e)
+        {
+            s += values[e] * x[inner[e]];
+        }
+        y[i] = s;
+    });
+}
+
+/// Colors of the elements of a grid: the parity of the coordinates of the cubes in the grid
+template<class Level>
+void computeElementColors(const core::topology::BaseMeshTopology* topology, Level& level)
+{
+    for (auto& color : level.colors)
+    {
+        color.clear();
+    }
+    if (level.elements.empty())
+    {
+        return;
+    }
+
+    const auto position = [topology](const sofa::Index i)
+    {
+        return type::Vec3(topology->getPX(i), topology->getPY(i), topology->getPZ(i));
+    };
+
+    type::Vec3 origin = position(0);
+    for (sofa::Size i = 1; i < topology->getNbPoints(); ++i)
+    {
+        const type::Vec3 p = position(i);
+        for (int a = 0; a < 3; ++a)
+        {
+            origin[a] = std::min(origin[a], p[a]);
+        }
+    }
+
+    const auto corners = [&position](const auto& hexa, type::Vec3& cmin, type::Vec3& cmax)
+    {
+        cmin = cmax = position(hexa[0]);
+        for (int n = 1; n < 8; ++n)
+        {
+            const type::Vec3 p = position(hexa[n]);
+            for (int a = 0; a < 3; ++a)
+            {
+                cmin[a] = std::min(cmin[a], p[a]);
+                cmax[a] = std::max(cmax[a], p[a]);
+            }
+        }
+    };
+
+    type::Vec3 cellMin, cellSize;
+    corners(level.elements[0], cellMin, cellSize);
+    cellSize -= cellMin;
+
+    for (sofa::Index e = 0; e < level.elements.size(); ++e)
+    {
+        type::Vec3 cmin, cmax;
+        corners(level.elements[e], cmin, cmax);
+        unsigned int color = 0;
+        for (int a = 0; a < 3; ++a)
+        {
+            const auto coordinate = cellSize[a] > 0 ? std::llround((cmin[a] - origin[a]) / cellSize[a]) : 0;
+            color |= static_cast<unsigned int>(coordinate & 1) << a;
+        }
+        level.colors[color].push_back(e);
+    }
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::buildHierarchy()
+{
+    SCOPED_TIMER_VARNAME(buildTimer, "SparseGridMultigrid::buildHierarchy");
+
+    for (const Level& level : m_levels)
+    {
+        if (level.ownedGrid)
+        {
+            this->removeSlave(level.ownedGrid.get());
+        }
+    }
+    m_levels.clear();
+
+    m_forceField = l_forceField.get();
+    m_mstate = m_forceField->getMState();
+    core::topology::BaseMeshTopology* topology = m_forceField->l_topology.get();
+    if (!topology)
+    {
+        topology = m_forceField->getContext()->getMeshTopology();
+    }
+    if (!m_mstate || !topology || topology->getNbHexahedra() == 0)
+    {
+        msg_error() << "The force field " << m_forceField->getPathName() << " has no mechanical state or no hexahedra";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+    if (topology->getNbPoints() != m_mstate->getSize())
+    {
+        msg_error() << "The number of points of the topology (" << topology->getNbPoints()
+                    << ") differs from the size of the mechanical state (" << m_mstate->getSize() << ")";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    const auto initLevel = [](Level& level, core::topology::BaseMeshTopology* levelTopology)
+    {
+        const auto& hexahedra = levelTopology->getHexahedra();
+        level.elements.assign(hexahedra.begin(), hexahedra.end());
+        computeElementColors(levelTopology, level);
+
+        const std::size_t n = 3 * levelTopology->getNbPoints();
+        level.nodalTerm.assign(n, 0);
+        level.invDiagonal.assign(n, 0);
+        level.x.assign(n, 0);
+        level.b.assign(n, 0);
+        level.r.assign(n, 0);
+        level.d.assign(n, 0);
+    };
+
+    m_levels.emplace_back();
+    m_levels[0].grid = dynamic_cast<SparseGrid*>(topology);
+    initLevel(m_levels[0], topology);
+    m_isFixed.assign(m_levels[0].size(), false);
+
+    msg_warning_when(!m_levels[0].grid) << "The topology of the force field is not a SparseGridTopology: "
+                                           "no coarse level can be built, the preconditioner is reduced to the smoother";
+
+    const unsigned int maxNbLevels = std::max(d_maxNbLevels.getValue(), 1u);
+    while (m_levels.size() < maxNbLevels && m_levels.back().grid
+           && m_levels.back().size() > d_maxCoarseSize.getValue())
+    {
+        SparseGrid* fine = m_levels.back().grid;
+
+        typename SparseGrid::SPtr coarse = sofa::core::objectmodel::New<SparseGrid>(true);
+        this->addSlave(coarse);
+
+        // building a coarser grid overwrites the links of the finer grid toward its own coarser grid, which may be used by the scene
+        const auto inverseHierarchicalPointMap = fine->_inverseHierarchicalPointMap;
+        const auto inverseHierarchicalCubeMap = fine->_inverseHierarchicalCubeMap;
+        const auto inversePointMap = fine->_inversePointMap;
+        SparseGrid* coarserSparseGrid = fine->getCoarserSparseGrid();
+
+        coarse->setFinerSparseGrid(fine);
+        coarse->init();
+
+        fine->_inverseHierarchicalPointMap = inverseHierarchicalPointMap;
+        fine->_inverseHierarchicalCubeMap = inverseHierarchicalCubeMap;
+        fine->_inversePointMap = inversePointMap;
+        fine->setCoarserSparseGrid(coarserSparseGrid);
+
+        if (!coarse->isComponentStateValid() || coarse->getNbHexahedra() == 0
+            || coarse->getNbPoints() >= fine->getNbPoints())
+        {
+            this->removeSlave(coarse.get());
+            break;
+        }
+
+        // interpolation weights between the two grids
+        const sofa::Size nbFinePoints = fine->getNbPoints();
+        const sofa::Size nbCoarsePoints = coarse->getNbPoints();
+        std::vector<Eigen::Triplet<Real> > triplets;
+        for (sofa::Index j = 0; j < nbCoarsePoints; ++j)
+        {
+            for (const auto& [i, weight] : coarse->_hierarchicalPointMap[j])
+            {
+                for (int a = 0; a < 3; ++a)
+                {
+                    triplets.emplace_back(3 * i + a, 3 * j + a, static_cast<Real>(weight));
+                }
+            }
+        }
+
+        Level& fineLevel = m_levels.back();
+        fineLevel.prolongator.resize(3 * nbFinePoints, 3 * nbCoarsePoints);
+        fineLevel.prolongator.setFromTriplets(triplets.begin(), triplets.end());
+        fineLevel.restriction = fineLevel.prolongator.transpose();
+
+        Level coarseLevel;
+        coarseLevel.grid = coarse.get();
+        coarseLevel.ownedGrid = coarse;
+        initLevel(coarseLevel, coarse.get());
+        m_levels.push_back(std::move(coarseLevel));
+    }
+
+    d_nbLevels.setValue(static_cast<unsigned int>(m_levels.size()));
+
+    std::stringstream sizes;
+    for (std::size_t l = 0; l < m_levels.size(); ++l)
+    {
+        sizes << (l ? ", " : "") << m_levels[l].size() << " (" << m_levels[l].elements.size() << " elements)";
+    }
+    msg_info() << m_levels.size() << " levels of sizes " << sizes.str();
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::getElementMatrix(const std::size_t l, const sofa::Index e, ElementMatrix& K)
+{
+    if (l > 0)
+    {
+        K = m_levels[l].elementMatrices[e];
+        return;
+    }
+
+    const ElementMatrix& Ke = m_forceField->getElementStiffnesses()[e];
+    const auto& R = m_forceField->getElementRotation(e);
+    const Hexa& hexa = m_levels[0].elements[e];
+
+    for (int n1 = 0; n1 < 8; ++n1)
+    {
+        for (int n2 = 0; n2 < 8; ++n2)
+        {
+            type::Mat<3, 3, Real> block;
+            for (int a = 0; a < 3; ++a)
+            {
+                for (int b = 0; b < 3; ++b)
+                {
+                    block[a][b] = Ke[3 * n1 + a][3 * n2 + b];
+                }
+            }
+            const type::Mat<3, 3, Real> globalBlock = R.multTranspose(block * R);
+
+            for (int a = 0; a < 3; ++a)
+            {
+                const auto i = 3 * hexa[n1] + a;
+                for (int b = 0; b < 3; ++b)
+                {
+                    const auto j = 3 * hexa[n2] + b;
+                    // the couplings of the fixed degrees of freedom are removed, their diagonal is kept to
+                    // constrain the coarse levels
+                    K[3 * n1 + a][3 * n2 + b] = (i != j && (m_isFixed[i] || m_isFixed[j])) ? 0 : m_stiffnessFactor * globalBlock[a][b];
+                }
+            }
+        }
+    }
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::computeCoarseElementMatrices(const std::size_t l)
+{
+    Level& coarse = m_levels[l + 1];
+    const auto& children = coarse.grid->_hierarchicalCubeMap;
+    const auto& weights = coarse.grid->_hierarchicalPointMap;
+    const Level& fine = m_levels[l];
+
+    coarse.elementMatrices.resize(coarse.elements.size());
+
+    forEachRow(static_cast<int>(coarse.elements.size()), [this, l, &coarse, &children, &weights, &fine](const int c)
+    {
+        ElementMatrix& Kc = coarse.elementMatrices[c];
+        Kc.clear();
+
+        const Hexa& coarseHexa = coarse.elements[c];
+        ElementMatrix Kf, KW;
+        for (int k = 0; k < 8; ++k)
+        {
+            const sofa::Index child = children[c][k];
+            if (child == sofa::InvalidID)
+            {
+                continue;
+            }
+            getElementMatrix(l, child, Kf);
+
+            // interpolation weights of the coarse corners at the nodes of the child
+            const Hexa& fineHexa = fine.elements[child];
+            type::Mat<8, 8, Real> W;
+            for (int J = 0; J < 8; ++J)
+            {
+                const auto& coarseWeights = weights[coarseHexa[J]];
+                for (int n = 0; n < 8; ++n)
+                {
+                    const auto it = coarseWeights.find(fineHexa[n]);
+                    W[n][J] = it != coarseWeights.end() ? static_cast<Real>(it->second) : 0;
+                }
+            }
+
+            // Kc += (W x I3)^T Kf (W x I3)
+            for (int i = 0; i < 24; ++i)
+            {
+                for (int J = 0; J < 8; ++J)
+                {
+                    for (int b = 0; b < 3; ++b)
+                    {
+                        Real s = 0;
+                        for (int n = 0; n < 8; ++n)
+                        {
+                            s += Kf[i][3 * n + b] * W[n][J];
+                        }
+                        KW[i][3 * J + b] = s;
+                    }
+                }
+            }
+            for (int I = 0; I < 8; ++I)
+            {
+                for (int a = 0; a < 3; ++a)
+                {
+                    for (int j = 0; j < 24; ++j)
+                    {
+                        Real s = 0;
+                        for (int n = 0; n < 8; ++n)
+                        {
+                            s += W[n][I] * KW[3 * n + a][j];
+                        }
+                        Kc[3 * I + a][j] += s;
+                    }
+                }
+            }
+        }
+    });
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::computeDiagonal(const std::size_t l)
+{
+    Level& level = m_levels[l];
+    sofa::type::vector<Real>& diagonal = level.r;
+    std::copy(level.nodalTerm.begin(), level.nodalTerm.end(), diagonal.begin());
+
+    forEachElement(l, [this, l, &level, &diagonal](const sofa::Index e)
+    {
+        ElementMatrix K;
+        getElementMatrix(l, e, K);
+        const Hexa& hexa = level.elements[e];
+        for (int n = 0; n < 8; ++n)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                diagonal[3 * hexa[n] + a] += K[3 * n + a][3 * n + a];
+            }
+        }
+    });
+
+    for (std::size_t i = 0; i < level.size(); ++i)
+    {
+        const bool isFixed = l == 0 && m_isFixed[i];
+        level.invDiagonal[i] = (isFixed || diagonal[i] <= 0) ? 0 : 1 / diagonal[i];
+    }
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::estimateLargestEigenvalue(const std::size_t l)
+{
+    // a few power iterations on D^-1 A, with a safety margin
+    static constexpr unsigned int nbIterations = 10;
+
+    Level& level = m_levels[l];
+    const std::size_t n = level.size();
+    sofa::type::vector<Real>& v = level.d;
+    sofa::type::vector<Real>& w = level.x;
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        v[i] = level.invDiagonal[i] != 0 ? 1 + static_cast<Real>(0.5) * std::sin(static_cast<Real>(i)) : 0;
+    }
+
+    Real lambda = 0;
+    for (unsigned int it = 0; it < nbIterations; ++it)
+    {
+        applyOperator(l, v, w);
+        Real normV = 0, normW = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            w[i] *= level.invDiagonal[i];
+            normV += v[i] * v[i];
+            normW += w[i] * w[i];
+        }
+        if (normV == 0 || normW == 0)
+        {
+            break;
+        }
+        normV = std::sqrt(normV);
+        normW = std::sqrt(normW);
+        lambda = normW / normV;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            v[i] = w[i] / normW;
+        }
+    }
+
+    level.lambdaMax = static_cast<Real>(1.1) * lambda;
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::factorizeCoarsestLevel()
+{
+    SCOPED_TIMER_VARNAME(coarseTimer, "SparseGridMultigrid::coarseFactorization");
+
+    const std::size_t l = m_levels.size() - 1;
+    const Level& level = m_levels[l];
+    const auto n = static_cast<Eigen::Index>(level.size());
+
+    m_isCoarseSolverValid = false;
+    if (level.size() > d_maxCoarseSize.getValue())
+    {
+        return;
+    }
+
+    std::vector<Eigen::Triplet<Real> > triplets;
+    triplets.reserve(level.elements.size() * 24 * 24 + level.size());
+    ElementMatrix K;
+    for (sofa::Index e = 0; e < level.elements.size(); ++e)
+    {
+        getElementMatrix(l, e, K);
+        const Hexa& hexa = level.elements[e];
+        for (int i = 0; i < 24; ++i)
+        {
+            for (int j = 0; j < 24; ++j)
+            {
+                if (K[i][j] != 0)
+                {
+                    triplets.emplace_back(3 * hexa[i / 3] + i % 3, 3 * hexa[j / 3] + j % 3, K[i][j]);
+                }
+            }
+        }
+    }
+    for (Eigen::Index i = 0; i < n; ++i)
+    {
+        triplets.emplace_back(i, i, level.nodalTerm[i]);
+    }
+
+    Eigen::SparseMatrix<Real> coarseMatrix(n, n);
+    coarseMatrix.setFromTriplets(triplets.begin(), triplets.end());
+    m_coarseSolver.compute(coarseMatrix);
+
+    m_isCoarseSolverValid = m_coarseSolver.info() == Eigen::Success;
+    msg_warning_when(!m_isCoarseSolverValid) << "The factorization of the coarsest level failed: it is smoothed instead";
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::updateOperators(Matrix& A, typename Inherit::TempVectorContainer& vtmp)
+{
+    SCOPED_TIMER_VARNAME(updateTimer, "SparseGridMultigrid::update");
+
+    using Deriv = typename DataTypes::Deriv;
+
+    m_stiffnessFactor = -static_cast<Real>(A.mparams.kFactorIncludingRayleighDamping(m_forceField->rayleighStiffness.getValue()));
+
+    // The operator applied on a uniform translation: the stiffness of the force field vanishes, leaving the
+    // row sums of the mass, the damping and the other force fields. The projection of the uniform
+    // translation gives the fixed degrees of freedom.
+    Vector& u = *vtmp.createTempVector();
+    Vector& w = *vtmp.createTempVector();
+    u.clear();
+    {
+        auto ones = helper::getWriteOnlyAccessor(*m_mstate->write(core::VecDerivId(u.id().getId(m_mstate))));
+        std::fill(ones.begin(), ones.end(), Deriv(1, 1, 1));
+    }
+    w = A * u;
+    A.parent->projectResponse(u);
+
+    Level& fine = m_levels[0];
+    {
+        const auto& rowSums = m_mstate->read(core::ConstVecDerivId(w.id().getId(m_mstate)))->getValue();
+        const auto& projected = m_mstate->read(core::ConstVecDerivId(u.id().getId(m_mstate)))->getValue();
+        for (std::size_t i = 0; i < rowSums.size(); ++i)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                m_isFixed[3 * i + a] = projected[i][a] == 0;
+                fine.nodalTerm[3 * i + a] = m_isFixed[3 * i + a] ? 0 : std::max(static_cast<Real>(rowSums[i][a]), static_cast<Real>(0));
+            }
+        }
+    }
+    vtmp.deleteTempVector(&u);
+    vtmp.deleteTempVector(&w);
+
+    const bool chebyshev = d_smoother.getValue().getSelectedId() == 1;
+    for (std::size_t l = 0; l < m_levels.size(); ++l)
+    {
+        computeDiagonal(l);
+        if (chebyshev)
+        {
+            estimateLargestEigenvalue(l);
+        }
+        if (l + 1 < m_levels.size())
+        {
+            computeCoarseElementMatrices(l);
+            multiply(m_levels[l].restriction, m_levels[l].nodalTerm.data(), m_levels[l + 1].nodalTerm.data());
+        }
+    }
+
+    factorizeCoarsestLevel();
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::applyOperator(const std::size_t l, const sofa::type::vector<Real>& x, sofa::type::vector<Real>& y)
+{
+    Level& level = m_levels[l];
+    const Real* nodalTerm = level.nodalTerm.data();
+    forEachRow(static_cast<int>(level.size()), [nodalTerm, &x, &y](const int i)
+    {
+        y[i] = nodalTerm[i] * x[i];
+    });
+
+    if (l == 0)
+    {
+        // element by element, from the stiffness matrices and the rotations of the force field
+        const auto& stiffnesses = m_forceField->getElementStiffnesses();
+        const Real factor = m_stiffnessFactor;
+        forEachElement(0, [this, &level, &stiffnesses, factor, &x, &y](const sofa::Index e)
+        {
+            const Hexa& hexa = level.elements[e];
+            const auto& R = m_forceField->getElementRotation(e);
+
+            type::Vec<24, Real> localX;
+            for (int n = 0; n < 8; ++n)
+            {
+                const type::Vec<3, Real> xn(x[3 * hexa[n]], x[3 * hexa[n] + 1], x[3 * hexa[n] + 2]);
+                const type::Vec<3, Real> rxn = R * xn;
+                for (int a = 0; a < 3; ++a)
+                {
+                    localX[3 * n + a] = rxn[a];
+                }
+            }
+
+            const type::Vec<24, Real> localF = stiffnesses[e] * localX;
+
+            for (int n = 0; n < 8; ++n)
+            {
+                const type::Vec<3, Real> fn = R.multTranspose(type::Vec<3, Real>(localF[3 * n], localF[3 * n + 1], localF[3 * n + 2]));
+                for (int a = 0; a < 3; ++a)
+                {
+                    y[3 * hexa[n] + a] += factor * fn[a];
+                }
+            }
+        });
+
+        for (std::size_t i = 0; i < level.size(); ++i)
+        {
+            if (m_isFixed[i])
+            {
+                y[i] = 0;
+            }
+        }
+    }
+    else
+    {
+        forEachElement(l, [&level, &x, &y](const sofa::Index e)
+        {
+            const Hexa& hexa = level.elements[e];
+            type::Vec<24, Real> localX;
+            for (int n = 0; n < 8; ++n)
+            {
+                for (int a = 0; a < 3; ++a)
+                {
+                    localX[3 * n + a] = x[3 * hexa[n] + a];
+                }
+            }
+
+            const type::Vec<24, Real> localF = level.elementMatrices[e] * localX;
+
+            for (int n = 0; n < 8; ++n)
+            {
+                for (int a = 0; a < 3; ++a)
+                {
+                    y[3 * hexa[n] + a] += localF[3 * n + a];
+                }
+            }
+        });
+    }
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::smooth(const std::size_t l, const unsigned int nbSteps)
+{
+    if (d_smoother.getValue().getSelectedId() == 1 && m_levels[l].lambdaMax > 0)
+    {
+        smoothChebyshev(l, nbSteps);
+    }
+    else
+    {
+        smoothJacobi(l, nbSteps);
+    }
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::smoothJacobi(const std::size_t l, const unsigned int nbSteps)
+{
+    Level& level = m_levels[l];
+    const Real damping = d_jacobiDamping.getValue();
+
+    for (unsigned int s = 0; s < nbSteps; ++s)
+    {
+        // x += damping * D^-1 (b - A x)
+        applyOperator(l, level.x, level.r);
+        Real* x = level.x.data();
+        const Real* b = level.b.data();
+        const Real* r = level.r.data();
+        const Real* invDiagonal = level.invDiagonal.data();
+        forEachRow(static_cast<int>(level.size()), [x, b, r, invDiagonal, damping](const int i)
+        {
+            x[i] += damping * invDiagonal[i] * (b[i] - r[i]);
+        });
+    }
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::smoothChebyshev(const std::size_t l, const unsigned int nbSteps)
+{
+    Level& level = m_levels[l];
+    const Real lambdaMax = level.lambdaMax;
+    const Real lambdaMin = lambdaMax / std::max(d_chebyshevRange.getValue(), static_cast<Real>(1.1));
+    const Real theta = (lambdaMax + lambdaMin) / 2;
+    const Real delta = (lambdaMax - lambdaMin) / 2;
+    const Real sigma = theta / delta;
+    Real rho = 1 / sigma;
+
+    Real* x = level.x.data();
+    const Real* b = level.b.data();
+    const Real* r = level.r.data();
+    Real* d = level.d.data();
+    const Real* invDiagonal = level.invDiagonal.data();
+    const int n = static_cast<int>(level.size());
+
+    // d = D^-1 (b - A x) / theta
+    applyOperator(l, level.x, level.r);
+    forEachRow(n, [b, r, d, invDiagonal, theta](const int i)
+    {
+        d[i] = invDiagonal[i] * (b[i] - r[i]) / theta;
+    });
+
+    for (unsigned int s = 0; s < nbSteps; ++s)
+    {
+        forEachRow(n, [x, d](const int i)
+        {
+            x[i] += d[i];
+        });
+        if (s + 1 == nbSteps)
+        {
+            break;
+        }
+
+        applyOperator(l, level.x, level.r);
+        const Real nextRho = 1 / (2 * sigma - rho);
+        const Real a = nextRho * rho;
+        const Real c = 2 * nextRho / delta;
+        forEachRow(n, [b, r, d, invDiagonal, a, c](const int i)
+        {
+            d[i] = a * d[i] + c * invDiagonal[i] * (b[i] - r[i]);
+        });
+        rho = nextRho;
+    }
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::vcycle(const std::size_t l)
+{
+    Level& level = m_levels[l];
+    const auto n = static_cast<int>(level.size());
+    const unsigned int nbSteps = d_nbSmoothingSteps.getValue();
+
+    std::fill(level.x.begin(), level.x.end(), 0);
+
+    if (l + 1 == m_levels.size())
+    {
+        if (m_isCoarseSolverValid)
+        {
+            Eigen::Map<Eigen::Matrix<Real, Eigen::Dynamic, 1> >(level.x.data(), n) =
+                m_coarseSolver.solve(Eigen::Map<const Eigen::Matrix<Real, Eigen::Dynamic, 1> >(level.b.data(), n));
+        }
+        else
+        {
+            smooth(l, 2 * nbSteps + 1);
+        }
+        return;
+    }
+
+    smooth(l, nbSteps);
+
+    // restriction of the residual
+    applyOperator(l, level.x, level.r);
+    for (int i = 0; i < n; ++i)
+    {
+        level.r[i] = level.b[i] - level.r[i];
+    }
+    Level& coarse = m_levels[l + 1];
+    multiply(level.restriction, level.r.data(), coarse.b.data());
+
+    vcycle(l + 1);
+
+    // coarse correction, without the fixed degrees of freedom
+    multiply(level.prolongator, coarse.x.data(), level.r.data());
+    for (int i = 0; i < n; ++i)
+    {
+        if (l != 0 || !m_isFixed[i])
+        {
+            level.x[i] += level.r[i];
+        }
+    }
+
+    smooth(l, nbSteps);
+}
+
+template<class TMatrix, class TVector>
+void SparseGridMultigridSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
+{
+    SCOPED_TIMER_VARNAME(solveTimer, "SparseGridMultigrid::solve");
+
+    const core::ExecParams* params = core::execparams::defaultInstance();
+    typename Inherit::TempVectorContainer vtmp(this, params, A, x, b);
+
+    if (this->isComponentStateValid()
+        && (m_levels.empty() || m_levels[0].elements.size() != l_forceField->getElementStiffnesses().size()))
+    {
+        buildHierarchy();
+        m_needsUpdate = true;
+    }
+
+    // the other mechanical states are not preconditioned
+    x = b;
+
+    if (!this->isComponentStateValid())
+    {
+        return;
+    }
+    if (m_needsUpdate)
+    {
+        updateOperators(A, vtmp);
+        m_needsUpdate = false;
+    }
+
+    Level& fine = m_levels[0];
+    {
+        const auto& residual = m_mstate->read(core::ConstVecDerivId(b.id().getId(m_mstate)))->getValue();
+        for (std::size_t i = 0; i < residual.size(); ++i)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                fine.b[3 * i + a] = m_isFixed[3 * i + a] ? 0 : static_cast<Real>(residual[i][a]);
+            }
+        }
+    }
+
+    {
+        SCOPED_TIMER_VARNAME(vcycleTimer, "SparseGridMultigrid::vcycle");
+        vcycle(0);
+    }
+
+    {
+        auto correction = helper::getWriteOnlyAccessor(*m_mstate->write(core::VecDerivId(x.id().getId(m_mstate))));
+        for (std::size_t i = 0; i < correction.size(); ++i)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                correction[i][a] = fine.x[3 * i + a];
+            }
+        }
+    }
+    A.parent->projectResponse(x);
+}
+
+} // namespace sofa::component::solidmechanics::fem::nonuniform
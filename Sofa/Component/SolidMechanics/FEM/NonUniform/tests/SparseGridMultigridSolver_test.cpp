@@ -0,0 +1,171 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/linearsolver/iterative/ShewchukPCGLinearSolver.h>
+#include <sofa/component/linearsolver/iterative/GraphScatteredTypes.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/simpleapi/SimpleApi.h>
+#include <sofa/simulation/Node.h>
+
+namespace
+{
+
+using namespace sofa;
+using ShewchukPCGLinearSolver = component::linearsolver::iterative::ShewchukPCGLinearSolver<
+    component::linearsolver::GraphScatteredMatrix, component::linearsolver::GraphScatteredVector>;
+
+/** One implicit step of a stiff hexahedral beam on a sparse grid, clamped at one end, solved with a
+conjugate gradient and with a conjugate gradient preconditioned by the multigrid V-cycle */
+struct SparseGridMultigridSolver_test : public BaseSimulationTest
+{
+    static constexpr unsigned int maxNbIterations = 2000;
+
+    enum class Solver { CG, PCG, Multigrid };
+
+    struct Solve
+    {
+        unsigned int nbIterations { 0 };
+        std::vector<SReal> positions;
+    };
+
+    static Solve solveStep(const Solver solver, const std::map<std::string, std::string>& multigridData = {})
+    {
+        SceneInstance scene;
+        const simulation::Node::SPtr root = scene.root;
+        root->setGravity({ 0, -10, 0 });
+        root->setDt(0.1);
+
+        simpleapi::createObject(root, "RequiredPlugin", {{"pluginName", "Sofa.Component"}});
+        simpleapi::createObject(root, "DefaultAnimationLoop");
+
+        const simulation::Node::SPtr beam = simpleapi::createChild(root, "beam");
+        simpleapi::createObject(beam, "EulerImplicitSolver", {{"rayleighStiffness", "0"}, {"rayleighMass", "0"}});
+
+        core::objectmodel::BaseObject::SPtr linearSolver;
+        if (solver == Solver::CG)
+        {
+            linearSolver = simpleapi::createObject(beam, "CGLinearSolver", {{"iterations", std::to_string(maxNbIterations)}, {"tolerance", "1e-16"}, {"threshold", "1e-30"}});
+        }
+        else
+        {
+            std::map<std::string, std::string> pcgData {{"name", "pcg"}, {"iterations", std::to_string(maxNbIterations)}, {"tolerance", "1e-16"}};
+            if (solver == Solver::Multigrid)
+            {
+                pcgData["preconditioner"] = "@multigrid";
+            }
+            linearSolver = simpleapi::createObject(beam, "ShewchukPCGLinearSolver", pcgData);
+            if (solver == Solver::Multigrid)
+            {
+                std::map<std::string, std::string> data = multigridData;
+                data["name"] = "multigrid";
+                // a small maximum coarse size, so that the beam is coarsened
+                data.emplace("maxCoarseSize", "100");
+                simpleapi::createObject(beam, "SparseGridMultigridSolver", data);
+            }
+        }
+
+        // the surface of the box [0,8]x[0,1]x[0,1], voxelized in cells of size 0.25
+        simpleapi::createObject(beam, "SparseGridTopology", {
+            {"name", "grid"},
+            {"position", "0 0 0  8 0 0  8 1 0  0 1 0  0 0 1  8 0 1  8 1 1  0 1 1"},
+            {"quads", "0 3 2 1  4 5 6 7  0 1 5 4  3 7 6 2  0 4 7 3  1 2 6 5"},
+            {"min", "-0.25 -0.25 -0.25"}, {"max", "8.25 1.25 1.25"}, {"n", "35 7 7"}});
+        const auto mstate = simpleapi::createObject(beam, "MechanicalObject", {{"template", "Vec3"}});
+        simpleapi::createObject(beam, "UniformMass", {{"totalMass", "1"}});
+        simpleapi::createObject(beam, "HexahedronFEMForceField", {{"youngModulus", "1e5"}, {"poissonRatio", "0.3"}, {"method", "large"}});
+        simpleapi::createObject(beam, "BoxROI", {{"name", "clamped"}, {"box", "-1 -1 -1 0.1 2 2"}});
+        simpleapi::createObject(beam, "FixedProjectiveConstraint", {{"indices", "@clamped.indices"}});
+
+        scene.initScene();
+        scene.simulate(0.1);
+
+        Solve solve;
+        if (solver != Solver::CG)
+        {
+            const auto* pcg = dynamic_cast<ShewchukPCGLinearSolver*>(linearSolver.get());
+            EXPECT_NE(pcg, nullptr);
+            if (pcg)
+            {
+                solve.nbIterations = pcg->d_nbIterations.getValue();
+            }
+        }
+
+        const auto* state = dynamic_cast<core::behavior::BaseMechanicalState*>(mstate.get());
+        EXPECT_NE(state, nullptr);
+        if (state)
+        {
+            for (Size i = 0; i < state->getSize(); ++i)
+            {
+                solve.positions.push_back(state->getPY(i));
+            }
+        }
+        return solve;
+    }
+
+    static void expectSameDeflection(const Solve& a, const Solve& b)
+    {
+        ASSERT_EQ(a.positions.size(), b.positions.size());
+        ASSERT_FALSE(a.positions.empty());
+        for (std::size_t i = 0; i < a.positions.size(); ++i)
+        {
+            EXPECT_NEAR(a.positions[i], b.positions[i], 1e-6) << "node " << i;
+        }
+    }
+};
+
+TEST_F(SparseGridMultigridSolver_test, sameSolutionAsConjugateGradient)
+{
+    const Solve cg = solveStep(Solver::CG);
+    const Solve multigrid = solveStep(Solver::Multigrid);
+
+    EXPECT_GT(multigrid.nbIterations, 0u);
+    EXPECT_LT(multigrid.nbIterations, maxNbIterations);
+    expectSameDeflection(cg, multigrid);
+}
+
+TEST_F(SparseGridMultigridSolver_test, reducesTheNumberOfIterations)
+{
+    const Solve pcg = solveStep(Solver::PCG);
+    const Solve jacobi = solveStep(Solver::Multigrid, {{"smoother", "Jacobi"}});
+    const Solve chebyshev = solveStep(Solver::Multigrid, {{"smoother", "Chebyshev"}});
+
+    EXPECT_LT(pcg.nbIterations, maxNbIterations);
+    EXPECT_GT(jacobi.nbIterations, 0u);
+    EXPECT_LT(jacobi.nbIterations, pcg.nbIterations);
+    EXPECT_GT(chebyshev.nbIterations, 0u);
+    EXPECT_LT(chebyshev.nbIterations, pcg.nbIterations);
+    expectSameDeflection(pcg, jacobi);
+    expectSameDeflection(pcg, chebyshev);
+}
+
+TEST_F(SparseGridMultigridSolver_test, multithreading)
+{
+    const Solve sequential = solveStep(Solver::Multigrid);
+    const Solve parallel = solveStep(Solver::Multigrid, {{"multithreading", "true"}});
+
+    EXPECT_EQ(parallel.nbIterations, sequential.nbIterations);
+    expectSameDeflection(sequential, parallel);
+}
+
+}
@@ -23,6 +23,8 @@
 #include <sofa/component/solidmechanics/spring/config.h>
 
 #include <sofa/component/solidmechanics/spring/StiffSpringForceField.h>
+#include <sofa/core/topology/ElementColoring.h>
+#include <sofa/simulation/TaskScheduler.h>
 #include <set>
 
 namespace sofa::component::solidmechanics::spring
@@ -45,6 +47,7 @@ public:
     using Inherit1::mstate1;
     using Inherit1::mstate2;
     using Inherit1::springs;
+    using Spring = typename Inherit1::Spring;
 
 protected:
     Data< Real >  d_linesStiffness; ///< Stiffness for the Lines
@@ -65,9 +68,23 @@ protected:
     /// optional range of local DOF indices. Any computation involving only indices outside of this range are discarded (useful for parallelization using mesh partitionning)
     Data< type::Vec<2, sofa::Index> > d_localRange;
 
+    Data< bool >  d_multithreading; ///< Compute the forces and their derivatives in parallel, the springs being processed by colors of independent springs
+
     /// Link to be set to the topology container in the component graph.
     SingleLink<MeshSpringForceField<DataTypes>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_topology;
 
+    /// Colors of springs sharing no vertex, processed in parallel if d_multithreading is set
+    core::topology::ElementColoring m_springColoring;
+    /// Counter of the springs Data when the colors were computed
+    int m_springColoringCounter { -1 };
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+    /// Potential energy of each spring, summed in m_potentialEnergy
+    type::vector<Real> m_springPotentialEnergies;
+
+    /// Call f on each spring, color after color, the springs of a color being processed in parallel
+    template<class F>
+    void forEachSpringByColor(F f);
+
     void addSpring(std::set<std::pair<sofa::Index, sofa::Index> >& sset, sofa::Index m1, sofa::Index m2, Real stiffness, Real damping);
 
     MeshSpringForceField() ;
@@ -145,6 +162,9 @@ public:
 
     void init() override;
 
+    void addForce(const core::MechanicalParams* mparams, DataVecDeriv& data_f1, DataVecDeriv& data_f2, const DataVecCoord& data_x1, const DataVecCoord& data_x2, const DataVecDeriv& data_v1, const DataVecDeriv& data_v2) override;
+    void addDForce(const core::MechanicalParams* mparams, DataVecDeriv& data_df1, DataVecDeriv& data_df2, const DataVecDeriv& data_dx1, const DataVecDeriv& data_dx2) override;
+
     void draw(const core::visual::VisualParams* vparams) override;
 };
 
@@ -25,6 +25,8 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/type/RGBAColor.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 #include <iostream>
 
 namespace sofa::component::solidmechanics::spring
@@ -47,6 +49,7 @@ MeshSpringForceField<DataTypes>::MeshSpringForceField()
     , d_drawMaxElongationRange(initData(&d_drawMaxElongationRange, Real(15.), "drawMaxElongationRange","Max range of elongation (red eongation - blue neutral - green compression)"))
     , d_drawSpringSize(initData(&d_drawSpringSize, Real(8.), "drawSpringSize","Size of drawed lines"))
     , d_localRange( initData(&d_localRange, type::Vec<2, sofa::Index>(sofa::InvalidID, sofa::InvalidID), "localRange", "optional range of local DOF indices. Any computation involving only indices outside of this range are discarded (useful for parallelization using mesh partitionning)" ) )
+    , d_multithreading(initData(&d_multithreading, false, "multithreading", "Compute the forces and their derivatives in parallel, the springs being processed by colors of independent springs"))
     , l_topology(initLink("topology", "link to the topology container"))
 {
 	this->ks.setDisplayed(false);
@@ -206,9 +209,114 @@ void MeshSpringForceField<DataTypes>::init()
         }
     }
 
+    m_taskScheduler = nullptr;
+    if (d_multithreading.getValue())
+    {
+        if (mstate1 == mstate2)
+        {
+            m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+            assert(m_taskScheduler);
+            if (m_taskScheduler->getThreadCount() < 1)
+            {
+                m_taskScheduler->init(0);
+                msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+            }
+        }
+        else
+        {
+            msg_warning() << "Multithreading is only supported when the springs connect the points of a single mechanical state";
+        }
+    }
+    m_springColoringCounter = -1;
+
     StiffSpringForceField<DataTypes>::init();
 }
 
+template<class DataTypes>
+template<class F>
+void MeshSpringForceField<DataTypes>::forEachSpringByColor(F f)
+{
+    const sofa::type::vector<Spring>& s = springs.getValue();
+
+    // the colors are computed again only if the springs changed
+    if (m_springColoringCounter != springs.getCounter())
+    {
+        sofa::type::vector<sofa::type::fixed_array<sofa::Index, 2> > springVertices;
+        springVertices.reserve(s.size());
+        for (const Spring& spring : s)
+        {
+            springVertices.emplace_back(spring.m1, spring.m2);
+        }
+        m_springColoring.compute(springVertices);
+        m_springColoringCounter = springs.getCounter();
+    }
+
+    simulation::parallelForEachColor(*m_taskScheduler, m_springColoring.getColors(), f);
+}
+
+template<class DataTypes>
+void MeshSpringForceField<DataTypes>::addForce(const core::MechanicalParams* mparams, DataVecDeriv& data_f1, DataVecDeriv& data_f2, const DataVecCoord& data_x1, const DataVecCoord& data_x2, const DataVecDeriv& data_v1, const DataVecDeriv& data_v2)
+{
+    if (m_taskScheduler == nullptr)
+    {
+        Inherit1::addForce(mparams, data_f1, data_f2, data_x1, data_x2, data_v1, data_v2);
+        return;
+    }
+
+    // the springs connect the points of a single mechanical state: f1 and f2 are the same vector
+    const VecCoord& x = data_x1.getValue();
+    const VecDeriv& v = data_v1.getValue();
+    sofa::helper::WriteOnlyAccessor<sofa::Data<VecDeriv> > f = sofa::helper::getWriteOnlyAccessor(data_f1);
+    SOFA_UNUSED(data_f2);
+    SOFA_UNUSED(data_x2);
+    SOFA_UNUSED(data_v2);
+
+    const sofa::type::vector<Spring>& s = springs.getValue();
+    f.resize(x.size());
+    this->dfdx.resize(s.size());
+
+    // each spring stores its potential energy, so that the springs of a color can be processed concurrently
+    m_springPotentialEnergies.assign(s.size(), 0);
+
+    forEachSpringByColor([&](const sofa::Index i)
+    {
+        this->addSpringForce(m_springPotentialEnergies[i], f.wref(), x, v, f.wref(), x, v, i, s[i]);
+    });
+
+    this->m_potentialEnergy = 0;
+    for (const Real energy : m_springPotentialEnergies)
+    {
+        this->m_potentialEnergy += energy;
+    }
+}
+
+template<class DataTypes>
+void MeshSpringForceField<DataTypes>::addDForce(const core::MechanicalParams* mparams, DataVecDeriv& data_df1, DataVecDeriv& data_df2, const DataVecDeriv& data_dx1, const DataVecDeriv& data_dx2)
+{
+    if (m_taskScheduler == nullptr)
+    {
+        Inherit1::addDForce(mparams, data_df1, data_df2, data_dx1, data_dx2);
+        return;
+    }
+
+    // the springs connect the points of a single mechanical state: df1 and df2 are the same vector
+    const VecDeriv& dx = data_dx1.getValue();
+    sofa::helper::WriteOnlyAccessor<sofa::Data<VecDeriv> > df = sofa::helper::getWriteOnlyAccessor(data_df1);
+    SOFA_UNUSED(data_df2);
+    SOFA_UNUSED(data_dx2);
+
+    const Real kFactor = (Real)sofa::core::mechanicalparams::kFactorIncludingRayleighDamping(mparams, this->rayleighStiffness.getValue());
+    const Real bFactor = (Real)sofa::core::mechanicalparams::bFactor(mparams);
+
+    const sofa::type::vector<Spring>& s = springs.getValue();
+    df.resize(dx.size());
+
+    forEachSpringByColor([&](const sofa::Index i)
+    {
+        this->addSpringDForce(df.wref(), dx, df.wref(), dx, i, s[i], kFactor, bFactor);
+    });
+}
+
 
 template<class DataTypes>
 void MeshSpringForceField<DataTypes>::draw(const core::visual::VisualParams* vparams)
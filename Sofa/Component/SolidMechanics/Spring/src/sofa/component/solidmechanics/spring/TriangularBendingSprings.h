@@ -27,6 +27,8 @@
 #include <sofa/type/Vec.h>
 #include <sofa/type/Mat.h>
 #include <sofa/core/topology/TopologyData.h>
+#include <sofa/core/topology/ElementColoring.h>
+#include <sofa/simulation/TaskScheduler.h>
 
 namespace sofa::component::solidmechanics::spring
 {
@@ -63,6 +65,7 @@ public:
     Data<Real> d_ks; ///< uniform stiffness for the all springs
     Data<Real> d_kd; ///< uniform damping for the all springs
     Data<bool> d_showSprings; ///< option to draw springs
+    Data<bool> d_multithreading; ///< Compute the forces and their derivatives in parallel, the springs being processed by colors of independent springs
 
     /// Link to be set to the topology container in the component graph.
     SingleLink<TriangularBendingSprings<DataTypes>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_topology;
@@ -166,6 +169,18 @@ protected:
 
     /// Pointer to the linked topology used to create this spring forcefield
     sofa::core::topology::BaseMeshTopology* m_topology;
+
+    /// Colors of springs sharing no vertex, processed in parallel if d_multithreading is set
+    core::topology::ElementColoring m_springColoring;
+    /// Revision of the topology when the colors were computed
+    int m_springColoringRevision { -1 };
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+    /// Potential energy of each spring, summed in m_potentialEnergy
+    type::vector<Real> m_springPotentialEnergies;
+
+    /// Call f on each edge, color after color, the edges whose springs are in the same color being processed in parallel
+    template<class F>
+    void forEachSpringByColor(F f);
 };
 
 #if !defined(SOFA_COMPONENT_FORCEFIELD_TRIANGULARBENDINGSPRINGS_CPP)
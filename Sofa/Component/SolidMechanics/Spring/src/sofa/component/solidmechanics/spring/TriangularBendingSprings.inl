@@ -26,6 +26,8 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/type/RGBAColor.h>
 #include <sofa/core/topology/TopologyData.inl>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 namespace sofa::component::solidmechanics::spring
 {
@@ -288,6 +290,7 @@ TriangularBendingSprings<DataTypes>::TriangularBendingSprings()
     : d_ks(initData(&d_ks, Real(100000.0),"stiffness","uniform stiffness for the all springs"))
     , d_kd(initData(&d_kd, Real(1.0),"damping","uniform damping for the all springs"))
     , d_showSprings(initData(&d_showSprings, true, "showSprings", "option to draw springs"))
+    , d_multithreading(initData(&d_multithreading, false, "multithreading", "Compute the forces and their derivatives in parallel, the springs being processed by colors of independent springs"))
     , l_topology(initLink("topology", "link to the topology container"))
     , edgeInfo(initData(&edgeInfo, "edgeInfo", "Internal edge data"))
     , m_potentialEnergy(0.0)
@@ -366,9 +369,63 @@ void TriangularBendingSprings<DataTypes>::init()
         applyPointRenumbering(pRenum->getIndexArray());
     });
 
+    m_taskScheduler = nullptr;
+    if (d_multithreading.getValue())
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+
     this->reinit();
 }
 
+template<class DataTypes>
+template<class F>
+void TriangularBendingSprings<DataTypes>::forEachSpringByColor(F f)
+{
+    const auto nbEdges = static_cast<sofa::Index>(m_topology->getNbEdges());
+
+    if (m_taskScheduler == nullptr)
+    {
+        for (sofa::Index i = 0; i < nbEdges; ++i)
+        {
+            f(i);
+        }
+        return;
+    }
+
+    // the springs are computed again by the topology callbacks, so the colors are computed again only if the
+    // topology changed
+    if (m_springColoringRevision != m_topology->getRevision() || m_springColoring.getElementColors().size() != nbEdges)
+    {
+        const type::vector<EdgeInformation>& edgeInf = edgeInfo.getValue();
+
+        // the spring of an edge connects the vertices opposite to the edge, and an edge without spring has no vertex
+        sofa::type::vector<Index> springBegin;
+        sofa::type::vector<Index> springVertices;
+        springBegin.reserve(nbEdges + 1);
+        springBegin.push_back(0);
+        for (sofa::Index i = 0; i < nbEdges; ++i)
+        {
+            if (edgeInf[i].is_activated)
+            {
+                springVertices.push_back(edgeInf[i].m1);
+                springVertices.push_back(edgeInf[i].m2);
+            }
+            springBegin.push_back(static_cast<Index>(springVertices.size()));
+        }
+        m_springColoring.compute(springBegin, springVertices);
+        m_springColoringRevision = m_topology->getRevision();
+    }
+
+    simulation::parallelForEachColor(*m_taskScheduler, m_springColoring.getColors(), f);
+}
+
 
 template<class DataTypes>
 void TriangularBendingSprings<DataTypes>::reinit()
@@ -445,14 +502,15 @@ void TriangularBendingSprings<DataTypes>::addForce(const core::MechanicalParams*
     sofa::helper::WriteOnlyAccessor< core::objectmodel::Data< type::vector<EdgeInformation> > > edgeInf = edgeInfo;
 
     f.resize(x.size());
-    m_potentialEnergy = 0;
+    // each spring stores its potential energy, so that the springs of a color can be processed concurrently
+    m_springPotentialEnergies.assign(nbEdges, 0);
 
-    for(sofa::Index i=0; i<nbEdges; i++ )
+    forEachSpringByColor([&](const sofa::Index i)
     {
         EdgeInformation& einfo = edgeInf[i];
 
         if (!einfo.is_activated) // edge not in middle of 2 triangles
-            continue;
+            return;
 
         int a = einfo.m1;
         int b = einfo.m2;
@@ -463,7 +521,7 @@ void TriangularBendingSprings<DataTypes>::addForce(const core::MechanicalParams*
             Real inverseLength = 1.0f/d;
             u *= inverseLength;
             Real elongation = (Real)(d - einfo.restlength);
-            m_potentialEnergy += elongation * elongation * einfo.ks / 2;
+            m_springPotentialEnergies[i] = elongation * elongation * einfo.ks / 2;
 
             Deriv relativeVelocity = v[b]-v[a];
             Real elongationVelocity = dot(u,relativeVelocity);
@@ -494,6 +552,12 @@ void TriangularBendingSprings<DataTypes>::addForce(const core::MechanicalParams*
                 }
             }
         }
+    });
+
+    m_potentialEnergy = 0;
+    for (const Real energy : m_springPotentialEnergies)
+    {
+        m_potentialEnergy += energy;
     }
 
     d_f.endEdit();
@@ -506,16 +570,15 @@ void TriangularBendingSprings<DataTypes>::addDForce(const core::MechanicalParams
     const VecDeriv& dx = d_dx.getValue();
     Real kFactor = (Real)sofa::core::mechanicalparams::kFactorIncludingRayleighDamping(mparams, this->rayleighStiffness.getValue());
 
-    const size_t nbEdges=m_topology->getNbEdges();
     const type::vector<EdgeInformation>& edgeInf = edgeInfo.getValue();
     df.resize(dx.size());
 
-    for(sofa::Index i=0; i<nbEdges; i++ )
+    forEachSpringByColor([&](const sofa::Index i)
     {
         const EdgeInformation& einfo = edgeInf[i];
 
         if (!einfo.is_activated) // edge not in middle of 2 triangles
-            continue;
+            return;
 
         const int a = einfo.m1;
         const int b = einfo.m2;
@@ -523,7 +586,7 @@ void TriangularBendingSprings<DataTypes>::addDForce(const core::MechanicalParams
         const Deriv dforce = einfo.DfDx*d;
         df[a]+= dforce * kFactor;
         df[b]-= dforce * kFactor;
-    }
+    });
 }
 
 template <class DataTypes>
@@ -145,6 +145,11 @@ void PointSetTopologyContainer::init()
 
 }
 
+void PointSetTopologyContainer::restoreInternalState(std::istream& /*in*/)
+{
+    init();
+}
+
 void PointSetTopologyContainer::addPoints(const Size nPoints)
 {
     setNbPoints(d_nbPoints.getValue() + nPoints );
@@ -48,6 +48,9 @@ public:
 
     void init() override;
 
+    /// The neighborhood buffers are not Data: rebuild them from the restored elements
+    void restoreInternalState(std::istream& in) override;
+
     /// Procedural creation methods
     /// @{
     void clear() override;
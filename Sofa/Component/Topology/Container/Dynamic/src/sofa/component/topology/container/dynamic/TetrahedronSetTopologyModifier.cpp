@@ -63,6 +63,12 @@ void TetrahedronSetTopologyModifier::reinit()
 
 void TetrahedronSetTopologyModifier::addTetrahedra(const sofa::type::vector<Tetrahedron> &tetrahedra)
 {
+    if (m_tetrahedraTransaction.isOpen())
+    {
+        m_tetrahedraTransaction.recordAddition(tetrahedra);
+        return;
+    }
+
     const size_t ntetra = m_container->getNbTetrahedra();
 
     /// effectively add triangles in the topology container
@@ -86,6 +92,12 @@ void TetrahedronSetTopologyModifier::addTetrahedra(const sofa::type::vector<Tetr
         const sofa::type::vector<sofa::type::vector<TetrahedronID> > &ancestors,
         const sofa::type::vector<sofa::type::vector<SReal> > &baryCoefs)
 {
+    if (m_tetrahedraTransaction.isOpen())
+    {
+        m_tetrahedraTransaction.recordAddition(tetrahedra, ancestors, baryCoefs);
+        return;
+    }
+
     const size_t ntetra = m_container->getNbTetrahedra();
 
     /// effectively add triangles in the topology container
@@ -605,6 +617,13 @@ void TetrahedronSetTopologyModifier::renumberPointsProcess( const sofa::type::ve
 
 void TetrahedronSetTopologyModifier::removeTetrahedra(const sofa::type::vector<TetrahedronID> &tetrahedraIds, const bool removeIsolatedItems)
 {
+    if (m_tetrahedraTransaction.isOpen())
+    {
+        m_tetrahedraTransaction.recordRemoval(tetrahedraIds);
+        m_transactionRemoveIsolatedItems = m_transactionRemoveIsolatedItems || removeIsolatedItems;
+        return;
+    }
+
     sofa::type::vector<TetrahedronID> tetrahedraIds_filtered;
     for (size_t i = 0; i < tetrahedraIds.size(); i++)
     {
@@ -637,6 +656,49 @@ void TetrahedronSetTopologyModifier::removeTetrahedra(const sofa::type::vector<T
     m_container->addRemovedTetraIndex(tetrahedraIds_filtered);
 }
 
+void TetrahedronSetTopologyModifier::beginTetrahedraTransaction()
+{
+    if (m_tetrahedraTransaction.isOpen())
+    {
+        msg_warning() << "A tetrahedra transaction is already open, the changes collected so far are kept.";
+        return;
+    }
+
+    m_tetrahedraTransaction.open();
+    m_transactionRemoveIsolatedItems = false;
+}
+
+void TetrahedronSetTopologyModifier::commitTetrahedraTransaction()
+{
+    if (!m_tetrahedraTransaction.isOpen())
+    {
+        msg_warning() << "No tetrahedra transaction to commit.";
+        return;
+    }
+
+    SCOPED_TIMER("commitTetrahedraTransaction");
+
+    // close the transaction before applying the changes
+    TopologyChangeTransaction<Tetrahedron> transaction;
+    std::swap(transaction, m_tetrahedraTransaction);
+
+    // additions first: they are appended, so the removed indices remain valid
+    const auto& addedTetrahedra = transaction.getAddedElements();
+    if (!addedTetrahedra.empty())
+    {
+        if (transaction.getAncestors().empty())
+            addTetrahedra(addedTetrahedra);
+        else
+            addTetrahedra(addedTetrahedra, transaction.getAncestors(), transaction.getBaryCoefs());
+    }
+
+    const auto removedTetrahedra = transaction.getRemovedElements();
+    if (!removedTetrahedra.empty())
+    {
+        removeTetrahedra(removedTetrahedra, m_transactionRemoveIsolatedItems);
+    }
+}
+
 void TetrahedronSetTopologyModifier::removeItems(const sofa::type::vector< TetrahedronID >& items)
 {
     removeTetrahedra(items);
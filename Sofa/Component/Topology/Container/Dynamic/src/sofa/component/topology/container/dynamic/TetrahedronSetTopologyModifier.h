@@ -101,6 +101,21 @@ public:
     */
     void RemoveTetraBall(TetrahedronID ind_ta, TetrahedronID ind_tb);
 
+    /** \brief Start collecting the tetrahedra added by @sa addTetrahedra and removed by @sa removeTetrahedra, instead of applying them one call at a time.
+    *
+    * The collected changes are applied by @sa commitTetrahedraTransaction, so that the TopologyData linked to this topology are updated
+    * once for all the additions and once for all the removals of a time step (e.g. for cutting or tearing).
+    * The removed indices refer to the tetrahedra at the start of the transaction, followed by the tetrahedra added during the transaction.
+    */
+    void beginTetrahedraTransaction();
+
+    /** \brief Apply the changes collected since @sa beginTetrahedraTransaction: all the added tetrahedra, then all the removed tetrahedra.
+    */
+    void commitTetrahedraTransaction();
+
+    /// Return true if the tetrahedron changes are currently collected. @sa beginTetrahedraTransaction
+    bool isTetrahedraTransactionOpen() const { return m_tetrahedraTransaction.isOpen(); }
+
 protected:
     /** \brief Sends a message to warn that some tetrahedra were added in this topology.
     *
@@ -211,6 +226,10 @@ protected:
     /// \brief function to propagate topological change events by parsing the list of TopologyHandlers linked to this topology.
     void propagateTopologicalEngineChanges() override;
 
+    /// Tetrahedron changes collected between @sa beginTetrahedraTransaction and @sa commitTetrahedraTransaction
+    TopologyChangeTransaction<Tetrahedron> m_tetrahedraTransaction;
+    bool m_transactionRemoveIsolatedItems { false };
+
 private:
     TetrahedronSetTopologyContainer* 	m_container;
 };
@@ -0,0 +1,96 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/topology/container/dynamic/config.h>
+
+#include <sofa/type/vector.h>
+#include <algorithm>
+
+namespace sofa::component::topology::container::dynamic
+{
+
+/**
+ * Changes of one kind of topological elements collected during a transaction of a topology modifier
+ * (@sa TriangleSetTopologyModifier::beginTrianglesTransaction), to be applied as a single addition
+ * followed by a single removal, instead of one event per call.
+ *
+ * The removed indices refer to the elements at the start of the transaction, followed by the elements
+ * added during the transaction, as the additions are applied first.
+ */
+template<class Element>
+class TopologyChangeTransaction
+{
+public:
+    using ElementID = sofa::Index;
+
+    void open()
+    {
+        *this = TopologyChangeTransaction();
+        m_isOpen = true;
+    }
+
+    bool isOpen() const { return m_isOpen; }
+
+    void recordAddition(const sofa::type::vector<Element>& elements,
+        const sofa::type::vector< sofa::type::vector<ElementID> >& ancestors = {},
+        const sofa::type::vector< sofa::type::vector<SReal> >& baryCoefs = {})
+    {
+        // ancestors are either empty for all the added elements, or given for each of them (possibly empty)
+        if (!ancestors.empty() || !m_ancestors.empty())
+        {
+            m_ancestors.resize(m_addedElements.size());
+            m_baryCoefs.resize(m_addedElements.size());
+            m_ancestors.insert(m_ancestors.end(), ancestors.begin(), ancestors.end());
+            m_baryCoefs.insert(m_baryCoefs.end(), baryCoefs.begin(), baryCoefs.end());
+            m_ancestors.resize(m_addedElements.size() + elements.size());
+            m_baryCoefs.resize(m_addedElements.size() + elements.size());
+        }
+        m_addedElements.insert(m_addedElements.end(), elements.begin(), elements.end());
+    }
+
+    void recordRemoval(const sofa::type::vector<ElementID>& elementIds)
+    {
+        m_removedElements.insert(m_removedElements.end(), elementIds.begin(), elementIds.end());
+    }
+
+    const sofa::type::vector<Element>& getAddedElements() const { return m_addedElements; }
+    const sofa::type::vector< sofa::type::vector<ElementID> >& getAncestors() const { return m_ancestors; }
+    const sofa::type::vector< sofa::type::vector<SReal> >& getBaryCoefs() const { return m_baryCoefs; }
+
+    /// Removed indices, without duplicates
+    sofa::type::vector<ElementID> getRemovedElements() const
+    {
+        sofa::type::vector<ElementID> removed = m_removedElements;
+        std::sort(removed.begin(), removed.end());
+        removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+        return removed;
+    }
+
+protected:
+    bool m_isOpen { false };
+    sofa::type::vector<Element> m_addedElements;
+    sofa::type::vector< sofa::type::vector<ElementID> > m_ancestors;
+    sofa::type::vector< sofa::type::vector<SReal> > m_baryCoefs;
+    sofa::type::vector<ElementID> m_removedElements;
+};
+
+} //namespace sofa::component::topology::container::dynamic
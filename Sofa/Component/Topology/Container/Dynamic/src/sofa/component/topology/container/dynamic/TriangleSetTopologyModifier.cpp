@@ -92,6 +92,12 @@ void TriangleSetTopologyModifier::reinit()
 
 void TriangleSetTopologyModifier::addTriangles(const sofa::type::vector<Triangle> &triangles)
 {
+    if (m_trianglesTransaction.isOpen())
+    {
+        m_trianglesTransaction.recordAddition(triangles);
+        return;
+    }
+
     const size_t nTriangles = m_container->getNbTriangles();
 
     // Test if the topology will still fulfill the conditions if this triangles is added.
@@ -128,6 +134,12 @@ void TriangleSetTopologyModifier::addTriangles(const sofa::type::vector<Triangle
         const sofa::type::vector<sofa::type::vector<TriangleID> > &ancestors,
         const sofa::type::vector<sofa::type::vector<SReal> > &baryCoefs)
 {
+    if (m_trianglesTransaction.isOpen())
+    {
+        m_trianglesTransaction.recordAddition(triangles, ancestors, baryCoefs);
+        return;
+    }
+
     const size_t nTriangles = m_container->getNbTriangles();
 
     // Test if the topology will still fulfill the conditions if this triangles is added.
@@ -313,6 +325,14 @@ void TriangleSetTopologyModifier::removeTriangles(const sofa::type::vector<Trian
         const bool removeIsolatedEdges,
         const bool removeIsolatedPoints)
 {
+    if (m_trianglesTransaction.isOpen())
+    {
+        m_trianglesTransaction.recordRemoval(triangleIds);
+        m_transactionRemoveIsolatedEdges = m_transactionRemoveIsolatedEdges || removeIsolatedEdges;
+        m_transactionRemoveIsolatedPoints = m_transactionRemoveIsolatedPoints || removeIsolatedPoints;
+        return;
+    }
+
     SCOPED_TIMER_VARNAME(removeTrianglesTimer, "removeTriangles");
 
     sofa::type::vector<TriangleID> triangleIds_filtered;
@@ -353,6 +373,52 @@ void TriangleSetTopologyModifier::removeTriangles(const sofa::type::vector<Trian
 }
 
 
+void TriangleSetTopologyModifier::beginTrianglesTransaction()
+{
+    if (m_trianglesTransaction.isOpen())
+    {
+        msg_warning() << "A triangles transaction is already open, the changes collected so far are kept.";
+        return;
+    }
+
+    m_trianglesTransaction.open();
+    m_transactionRemoveIsolatedEdges = false;
+    m_transactionRemoveIsolatedPoints = false;
+}
+
+
+void TriangleSetTopologyModifier::commitTrianglesTransaction()
+{
+    if (!m_trianglesTransaction.isOpen())
+    {
+        msg_warning() << "No triangles transaction to commit.";
+        return;
+    }
+
+    SCOPED_TIMER("commitTrianglesTransaction");
+
+    // close the transaction before applying the changes
+    TopologyChangeTransaction<Triangle> transaction;
+    std::swap(transaction, m_trianglesTransaction);
+
+    // additions first: they are appended, so the removed indices remain valid
+    const auto& addedTriangles = transaction.getAddedElements();
+    if (!addedTriangles.empty())
+    {
+        if (transaction.getAncestors().empty())
+            addTriangles(addedTriangles);
+        else
+            addTriangles(addedTriangles, transaction.getAncestors(), transaction.getBaryCoefs());
+    }
+
+    const auto removedTriangles = transaction.getRemovedElements();
+    if (!removedTriangles.empty())
+    {
+        removeTriangles(removedTriangles, m_transactionRemoveIsolatedEdges, m_transactionRemoveIsolatedPoints);
+    }
+}
+
+
 void TriangleSetTopologyModifier::removeTrianglesWarning(sofa::type::vector<TriangleID> &triangles)
 {
     m_container->setTriangleTopologyToDirty();
@@ -23,6 +23,7 @@
 #include <sofa/component/topology/container/dynamic/config.h>
 
 #include <sofa/component/topology/container/dynamic/EdgeSetTopologyModifier.h>
+#include <sofa/component/topology/container/dynamic/TopologyChangeTransaction.h>
 
 namespace sofa::component::topology::container::dynamic
 {
@@ -119,6 +120,21 @@ public:
             sofa::type::vector< TriangleID >& trianglesIndex2remove);
 
 
+    /** \brief Start collecting the triangles added by @sa addTriangles and removed by @sa removeTriangles, instead of applying them one call at a time.
+     *
+     * The collected changes are applied by @sa commitTrianglesTransaction, so that the TopologyData linked to this topology are updated
+     * once for all the additions and once for all the removals of a time step.
+     * The removed indices refer to the triangles at the start of the transaction, followed by the triangles added during the transaction.
+     */
+    void beginTrianglesTransaction();
+
+    /** \brief Apply the changes collected since @sa beginTrianglesTransaction: all the added triangles, then all the removed triangles.
+     */
+    void commitTrianglesTransaction();
+
+    /// Return true if the triangle changes are currently collected. @sa beginTrianglesTransaction
+    bool isTrianglesTransactionOpen() const { return m_trianglesTransaction.isOpen(); }
+
     /** \brief Duplicates the given edge. Only works if at least one of its points is adjacent to a border.
      * @returns the number of newly created points, or -1 if the incision failed.
      */
@@ -279,6 +295,11 @@ protected:
     virtual void addTrianglesPostProcessing(const sofa::type::vector<Triangle>& triangles);
 
     Data<sofa::type::vector<TriangleID> > list_Out; ///< triangles with at least one null values.
+
+    /// Triangle changes collected between @sa beginTrianglesTransaction and @sa commitTrianglesTransaction
+    TopologyChangeTransaction<Triangle> m_trianglesTransaction;
+    bool m_transactionRemoveIsolatedEdges { false };
+    bool m_transactionRemoveIsolatedPoints { false };
 private:
     TriangleSetTopologyContainer*	m_container;
 };
@@ -24,6 +24,7 @@
 #include <sofa/testing/BaseTest.h>
 #include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyContainer.h>
 #include <sofa/component/topology/container/dynamic/TetrahedronSetGeometryAlgorithms.h>
+#include <sofa/component/topology/container/dynamic/TetrahedronSetTopologyModifier.h>
 #include <sofa/helper/system/FileRepository.h>
 
 using namespace sofa::component::topology::container::dynamic;
@@ -40,6 +41,7 @@ public:
     bool testVertexBuffers();
     bool checkTopology();
     bool testTetrahedronGeometry();
+    bool testRemovingTetrahedraTransaction();
 
     // ground truth from obj file;
     int nbrTetrahedron = 44;
@@ -439,6 +441,54 @@ bool TetrahedronSetTopology_test::testTetrahedronGeometry()
 }
 
 
+bool TetrahedronSetTopology_test::testRemovingTetrahedraTransaction()
+{
+    fake_TopologyScene* sceneRef = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::geometry::ElementType::TETRAHEDRON);
+    fake_TopologyScene* scene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::geometry::ElementType::TETRAHEDRON);
+
+    TetrahedronSetTopologyContainer* topoConRef = dynamic_cast<TetrahedronSetTopologyContainer*>(sceneRef->getNode().get()->getMeshTopology());
+    TetrahedronSetTopologyContainer* topoCon = dynamic_cast<TetrahedronSetTopologyContainer*>(scene->getNode().get()->getMeshTopology());
+    TetrahedronSetTopologyModifier* topoModRef = sceneRef->getNode()->get<TetrahedronSetTopologyModifier>();
+    TetrahedronSetTopologyModifier* topoMod = scene->getNode()->get<TetrahedronSetTopologyModifier>();
+
+    if (topoConRef == nullptr || topoCon == nullptr || topoModRef == nullptr || topoMod == nullptr)
+    {
+        delete sceneRef;
+        delete scene;
+        return false;
+    }
+
+    // reference: all the tetrahedra removed in a single call
+    topoModRef->removeTetrahedra({ 2, 5, 10, 43 });
+
+    // transaction: removals collected over several calls, indices referring to the topology at the start of the transaction
+    topoMod->beginTetrahedraTransaction();
+    EXPECT_TRUE(topoMod->isTetrahedraTransactionOpen());
+    topoMod->removeTetrahedra({ 2 });
+    topoMod->removeTetrahedra({ 10, 5 });
+    topoMod->removeTetrahedra({ 43, 2 });
+    EXPECT_EQ(topoCon->getNumberOfTetrahedra(), nbrTetrahedron);
+
+    topoMod->commitTetrahedraTransaction();
+    EXPECT_FALSE(topoMod->isTetrahedraTransactionOpen());
+
+    EXPECT_EQ(topoCon->getNumberOfTetrahedra(), nbrTetrahedron - 4);
+    for (sofa::Index tetraId = 0; tetraId < topoConRef->getNumberOfTetrahedra(); ++tetraId)
+    {
+        const auto& tetra = topoCon->getTetrahedron(tetraId);
+        const auto& tetraRef = topoConRef->getTetrahedron(tetraId);
+        for (unsigned int j = 0; j < 4; ++j)
+            EXPECT_EQ(tetra[j], tetraRef[j]);
+    }
+    EXPECT_EQ(topoCon->getNbPoints(), topoConRef->getNbPoints());
+    EXPECT_TRUE(topoCon->checkTopology());
+
+    delete sceneRef;
+    delete scene;
+
+    return true;
+}
+
 
 TEST_F(TetrahedronSetTopology_test, testEmptyContainer)
 {
@@ -475,6 +525,11 @@ TEST_F(TetrahedronSetTopology_test, testTetrahedronGeometry)
     ASSERT_TRUE(testTetrahedronGeometry());
 }
 
+TEST_F(TetrahedronSetTopology_test, testRemovingTetrahedraTransaction)
+{
+    ASSERT_TRUE(testRemovingTetrahedraTransaction());
+}
+
 
 
 // TODO epernod 2018-07-05: test element on Border
@@ -37,6 +37,9 @@
 
 #include <sofa/component/topology/container/grid/SparseGridTopology.h>
 
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+
 #include <sstream>
 #include <map>
 #include <memory>
@@ -118,6 +121,8 @@ VisualModelImpl::VisualModelImpl() //const std::string &name, std::string filena
     , d_handleDynamicTopology (initData   (&d_handleDynamicTopology, true, "handleDynamicTopology", "True if topological changes should be handled"))
     , d_fixMergedUVSeams (initData   (&d_fixMergedUVSeams, true, "fixMergedUVSeams", "True if UV seams should be handled even when duplicate UVs are merged"))
     , d_keepLines (initData   (&d_keepLines, false, "keepLines", "keep and draw lines (false by default)"))
+    , d_multithreading (initData   (&d_multithreading, false, "multithreading", "Compute normals and tangents concurrently"))
+    , d_normalsUpdateThreshold (initData   (&d_normalsUpdateThreshold, (Real)0, "normalsUpdateThreshold", "If positive, only update normals and tangents around vertices that moved more than this distance since their last update"))
     , d_vertices2       (initData   (&d_vertices2, "vertices", "vertices of the model (only if vertices have multiple normals/texcoords, otherwise positions are used)"))
     , d_vtexcoords      (initData   (&d_vtexcoords, "texcoords", "coordinates of the texture"))
     , d_vtangents       (initData   (&d_vtangents, "tangents", "tangents for normal mapping"))
@@ -986,8 +991,15 @@ void VisualModelImpl::computeNormals()
 {
     const VecCoord& vertices = getVertices();
 
+    m_dirtyVertices.clear();
     if (vertices.empty() || (!d_updateNormals.getValue() && (m_vnormals.getValue()).size() == (vertices).size())) return;
 
+    if (d_multithreading.getValue() || d_normalsUpdateThreshold.getValue() > 0)
+    {
+        computeNormalsFromAdjacency();
+        return;
+    }
+
     const VecVisualTriangle& triangles = d_triangles.getValue();
     const VecVisualQuad& quads = d_quads.getValue();
     const type::vector<visual_index_type> &vertNormIdx = d_vertNormIdx.getValue();
@@ -1102,6 +1114,12 @@ void VisualModelImpl::computeTangents()
 {
     if (!d_computeTangents.getValue() || !d_vtexcoords.getValue().size()) return;
 
+    if (d_multithreading.getValue() || d_normalsUpdateThreshold.getValue() > 0)
+    {
+        computeTangentsFromAdjacency();
+        return;
+    }
+
     const VecVisualTriangle& triangles = d_triangles.getValue();
     const VecVisualQuad& quads = d_quads.getValue();
     const VecCoord& vertices = getVertices();
@@ -1192,6 +1210,364 @@ void VisualModelImpl::computeTangents()
 
 }
 
+namespace
+{
+
+/// Build the faces around each node, a node being a vertex or a normal index given by nodeOf
+template<class NodeOf>
+void buildFaceAdjacency(type::vector<sofa::Index>& begin, type::vector<sofa::Index>& slots, std::size_t nbNodes,
+                        const VisualModelImpl::VecVisualTriangle& triangles, const VisualModelImpl::VecVisualQuad& quads,
+                        const NodeOf& nodeOf)
+{
+    begin.assign(nbNodes + 1, 0);
+    for (const auto& triangle : triangles)
+        for (int k = 0; k < 3; ++k)
+            ++begin[nodeOf(triangle[k]) + 1];
+    for (const auto& quad : quads)
+        for (int k = 0; k < 4; ++k)
+            ++begin[nodeOf(quad[k]) + 1];
+    for (std::size_t i = 0; i < nbNodes; ++i)
+        begin[i + 1] += begin[i];
+
+    slots.resize(begin[nbNodes]);
+    type::vector<sofa::Index> next(begin.begin(), begin.end() - 1);
+    const auto nbTriangles = sofa::Index(triangles.size());
+    for (sofa::Index t = 0; t < triangles.size(); ++t)
+        for (int k = 0; k < 3; ++k)
+            slots[next[nodeOf(triangles[t][k])]++] = t;
+    for (sofa::Index q = 0; q < quads.size(); ++q)
+        for (int k = 0; k < 4; ++k)
+            slots[next[nodeOf(quads[q][k])]++] = nbTriangles + 4 * q + k;
+}
+
+simulation::TaskScheduler* getTaskScheduler()
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    if (taskScheduler->getThreadCount() < 1)
+        taskScheduler->init(0);
+    return taskScheduler;
+}
+
+}
+
+void VisualModelImpl::updateFaceAdjacency()
+{
+    const VecVisualTriangle& triangles = d_triangles.getValue();
+    const VecVisualQuad& quads = d_quads.getValue();
+    const type::vector<visual_index_type>& vertNormIdx = d_vertNormIdx.getValue();
+    const std::size_t nbVertices = getVertices().size();
+
+    const std::array<std::size_t, 4> key { std::size_t(d_triangles.getCounter()), std::size_t(d_quads.getCounter()),
+                                           std::size_t(d_vertNormIdx.getCounter()), nbVertices };
+    if (key == m_faceAdjacencyKey && m_vertexFaces.begin.size() == nbVertices + 1)
+        return;
+    m_faceAdjacencyKey = key;
+
+    buildFaceAdjacency(m_vertexFaces.begin, m_vertexFaces.slots, nbVertices, triangles, quads,
+                       [](visual_index_type v) { return std::size_t(v); });
+    if (!vertNormIdx.empty())
+    {
+        const std::size_t nbn = static_cast<std::size_t>(*std::max_element(vertNormIdx.begin(), vertNormIdx.end())) + 1;
+        buildFaceAdjacency(m_normalFaces.begin, m_normalFaces.slots, nbn, triangles, quads,
+                           [&vertNormIdx](visual_index_type v) { return std::size_t(vertNormIdx[v]); });
+        m_indexedNormals.resize(nbn);
+    }
+    else
+    {
+        m_normalFaces = FaceAdjacency();
+        m_indexedNormals.clear();
+    }
+
+    const std::size_t nbSlots = triangles.size() + 4 * quads.size();
+    m_slotNormals.resize(nbSlots);
+    m_slotTangents.resize(nbSlots);
+    m_slotBitangents.resize(nbSlots);
+
+    // the next update cannot be partial
+    m_normalsReferencePositions.clear();
+    m_tangentsRevision = -1;
+}
+
+void VisualModelImpl::computeNormalsFromAdjacency()
+{
+    const VecCoord& vertices = getVertices();
+    const VecVisualTriangle& triangles = d_triangles.getValue();
+    const VecVisualQuad& quads = d_quads.getValue();
+    const type::vector<visual_index_type>& vertNormIdx = d_vertNormIdx.getValue();
+
+    updateFaceAdjacency();
+
+    const std::size_t nbVertices = vertices.size();
+    const auto nbTriangles = sofa::Index(triangles.size());
+    const auto execution = d_multithreading.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+    simulation::TaskScheduler* taskScheduler = getTaskScheduler();
+
+    const Real threshold = d_normalsUpdateThreshold.getValue();
+    const bool partial = threshold > 0
+        && m_normalsReferencePositions.size() == nbVertices
+        && m_vnormals.getValue().size() == nbVertices;
+
+    m_dirtySlots.resize(m_slotNormals.size());
+    m_dirtyVertices.resize(nbVertices);
+    if (!partial)
+    {
+        std::fill(m_dirtySlots.begin(), m_dirtySlots.end(), 1);
+        std::fill(m_dirtyVertices.begin(), m_dirtyVertices.end(), 1);
+        if (threshold > 0)
+            m_normalsReferencePositions = vertices;
+    }
+    else
+    {
+        // Vertices that moved more than the threshold, then the faces around them
+        const Real threshold2 = threshold * threshold;
+        simulation::forEachRange(execution, *taskScheduler, std::size_t(0), nbVertices,
+            [&](const simulation::Range<std::size_t>& range)
+            {
+                for (std::size_t i = range.start; i < range.end; ++i)
+                {
+                    const bool moved = (vertices[i] - m_normalsReferencePositions[i]).norm2() > threshold2;
+                    m_dirtyVertices[i] = moved;
+                    if (moved)
+                        m_normalsReferencePositions[i] = vertices[i];
+                }
+            });
+        simulation::forEachRange(execution, *taskScheduler, sofa::Index(0), nbTriangles,
+            [&](const simulation::Range<sofa::Index>& range)
+            {
+                for (sofa::Index t = range.start; t < range.end; ++t)
+                {
+                    const auto& triangle = triangles[t];
+                    m_dirtySlots[t] = m_dirtyVertices[triangle[0]] || m_dirtyVertices[triangle[1]] || m_dirtyVertices[triangle[2]];
+                }
+            });
+        simulation::forEachRange(execution, *taskScheduler, sofa::Index(0), sofa::Index(quads.size()),
+            [&](const simulation::Range<sofa::Index>& range)
+            {
+                for (sofa::Index q = range.start; q < range.end; ++q)
+                {
+                    const auto& quad = quads[q];
+                    const char dirty = m_dirtyVertices[quad[0]] || m_dirtyVertices[quad[1]] || m_dirtyVertices[quad[2]] || m_dirtyVertices[quad[3]];
+                    std::fill_n(m_dirtySlots.begin() + nbTriangles + 4 * q, 4, dirty);
+                }
+            });
+        // Vertices around these faces
+        simulation::forEachRange(execution, *taskScheduler, std::size_t(0), nbVertices,
+            [&](const simulation::Range<std::size_t>& range)
+            {
+                for (std::size_t i = range.start; i < range.end; ++i)
+                {
+                    char dirty = 0;
+                    for (sofa::Index s = m_vertexFaces.begin[i]; s < m_vertexFaces.begin[i + 1] && !dirty; ++s)
+                        dirty = m_dirtySlots[m_vertexFaces.slots[s]];
+                    m_dirtyVertices[i] = dirty;
+                }
+            });
+    }
+
+    // Normal of each face, and of each quad corner
+    simulation::forEachRange(execution, *taskScheduler, sofa::Index(0), nbTriangles,
+        [&](const simulation::Range<sofa::Index>& range)
+        {
+            for (sofa::Index t = range.start; t < range.end; ++t)
+            {
+                if (!m_dirtySlots[t]) continue;
+                const Coord& v1 = vertices[ triangles[t][0] ];
+                const Coord& v2 = vertices[ triangles[t][1] ];
+                const Coord& v3 = vertices[ triangles[t][2] ];
+                m_slotNormals[t] = cross(v2-v1, v3-v1);
+            }
+        });
+    simulation::forEachRange(execution, *taskScheduler, sofa::Index(0), sofa::Index(quads.size()),
+        [&](const simulation::Range<sofa::Index>& range)
+        {
+            for (sofa::Index q = range.start; q < range.end; ++q)
+            {
+                const sofa::Index slot = nbTriangles + 4 * q;
+                if (!m_dirtySlots[slot]) continue;
+                const Coord & v1 = vertices[ quads[q][0] ];
+                const Coord & v2 = vertices[ quads[q][1] ];
+                const Coord & v3 = vertices[ quads[q][2] ];
+                const Coord & v4 = vertices[ quads[q][3] ];
+                m_slotNormals[slot    ] = cross(v2-v1, v4-v1);
+                m_slotNormals[slot + 1] = cross(v3-v2, v1-v2);
+                m_slotNormals[slot + 2] = cross(v4-v3, v2-v3);
+                m_slotNormals[slot + 3] = cross(v1-v4, v3-v4);
+            }
+        });
+
+    // Gather the contributions, in the same order as computeNormals
+    const auto gather = [this](const FaceAdjacency& adjacency, std::size_t node)
+    {
+        Coord normal;
+        for (sofa::Index s = adjacency.begin[node]; s < adjacency.begin[node + 1]; ++s)
+            normal += m_slotNormals[adjacency.slots[s]];
+        normal.normalize();
+        return normal;
+    };
+
+    auto normals = sofa::helper::getWriteAccessor(m_vnormals);
+    normals.resize(nbVertices);
+
+    if (vertNormIdx.empty())
+    {
+        simulation::forEachRange(execution, *taskScheduler, std::size_t(0), nbVertices,
+            [&](const simulation::Range<std::size_t>& range)
+            {
+                for (std::size_t i = range.start; i < range.end; ++i)
+                    if (m_dirtyVertices[i])
+                        normals[i] = gather(m_vertexFaces, i);
+            });
+    }
+    else
+    {
+        const std::size_t nbn = m_indexedNormals.size();
+        m_dirtyIndexedNormals.resize(nbn);
+        simulation::forEachRange(execution, *taskScheduler, std::size_t(0), nbn,
+            [&](const simulation::Range<std::size_t>& range)
+            {
+                for (std::size_t n = range.start; n < range.end; ++n)
+                {
+                    char dirty = !partial;
+                    for (sofa::Index s = m_normalFaces.begin[n]; s < m_normalFaces.begin[n + 1] && !dirty; ++s)
+                        dirty = m_dirtySlots[m_normalFaces.slots[s]];
+                    m_dirtyIndexedNormals[n] = dirty;
+                    if (dirty)
+                        m_indexedNormals[n] = gather(m_normalFaces, n);
+                }
+            });
+        simulation::forEachRange(execution, *taskScheduler, std::size_t(0), nbVertices,
+            [&](const simulation::Range<std::size_t>& range)
+            {
+                for (std::size_t i = range.start; i < range.end; ++i)
+                {
+                    if (m_dirtyIndexedNormals[vertNormIdx[i]])
+                    {
+                        normals[i] = m_indexedNormals[vertNormIdx[i]];
+                        m_dirtyVertices[i] = 1;
+                    }
+                }
+            });
+    }
+
+    ++m_normalsRevision;
+}
+
+void VisualModelImpl::computeTangentsFromAdjacency()
+{
+    const VecVisualTriangle& triangles = d_triangles.getValue();
+    const VecVisualQuad& quads = d_quads.getValue();
+    const VecCoord& vertices = getVertices();
+    const VecTexCoord& texcoords = d_vtexcoords.getValue();
+    const auto& normals = m_vnormals.getValue();
+
+    updateFaceAdjacency();
+
+    const std::size_t nbVertices = vertices.size();
+    const auto nbTriangles = sofa::Index(triangles.size());
+    const auto execution = d_multithreading.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+    simulation::TaskScheduler* taskScheduler = getTaskScheduler();
+
+    auto tangents = sofa::helper::getWriteAccessor(d_vtangents);
+    auto bitangents = sofa::helper::getWriteAccessor(d_vbitangents);
+
+    // Only the vertices around the faces updated by computeNormals, if the tangents followed all its previous updates
+    const bool partial = m_dirtyVertices.size() == nbVertices
+        && m_tangentsRevision + 1 == m_normalsRevision
+        && tangents.size() == nbVertices && bitangents.size() == nbVertices;
+
+    tangents.resize(nbVertices);
+    bitangents.resize(nbVertices);
+
+    const bool fixMergedUVSeams = d_fixMergedUVSeams.getValue();
+    simulation::forEachRange(execution, *taskScheduler, sofa::Index(0), nbTriangles,
+        [&](const simulation::Range<sofa::Index>& range)
+        {
+            for (sofa::Index i = range.start; i < range.end; ++i)
+            {
+                if (partial && !m_dirtySlots[i]) continue;
+                const Coord& v1 = vertices[triangles[i][0]];
+                const Coord& v2 = vertices[triangles[i][1]];
+                const Coord& v3 = vertices[triangles[i][2]];
+                const TexCoord& t1 = texcoords[triangles[i][0]];
+                TexCoord t2 = texcoords[triangles[i][1]];
+                TexCoord t3 = texcoords[triangles[i][2]];
+                if (fixMergedUVSeams)
+                {
+                    for (Size j=0; j<TexCoord::size(); ++j)
+                    {
+                        t2[j] += helper::rnear(t1[j]-t2[j]);
+                        t3[j] += helper::rnear(t1[j]-t3[j]);
+                    }
+                }
+                m_slotTangents[i] = computeTangent(v1, v2, v3, t1, t2, t3);
+                m_slotBitangents[i] = computeBitangent(v1, v2, v3, t1, t2, t3);
+            }
+        });
+
+    simulation::forEachRange(execution, *taskScheduler, sofa::Index(0), sofa::Index(quads.size()),
+        [&](const simulation::Range<sofa::Index>& range)
+        {
+            for (sofa::Index i = range.start; i < range.end; ++i)
+            {
+                const sofa::Index slot = nbTriangles + 4 * i;
+                if (partial && !m_dirtySlots[slot]) continue;
+                const Coord& v1 = vertices[quads[i][0]];
+                const Coord& v2 = vertices[quads[i][1]];
+                const Coord& v3 = vertices[quads[i][2]];
+                const Coord& v4 = vertices[quads[i][3]];
+                const TexCoord& t1 = texcoords[quads[i][0]];
+                const TexCoord& t2 = texcoords[quads[i][1]];
+                const TexCoord& t3 = texcoords[quads[i][2]];
+                const TexCoord& t4 = texcoords[quads[i][3]];
+
+                // Same split as computeTangents
+                const Coord t123 = computeTangent  (v1, v2, v3, t1, t2, t3);
+                const Coord b123 = computeBitangent(v1, v2, v2, t1, t2, t3);
+                const Coord t234 = computeTangent  (v2, v3, v4, t2, t3, t4);
+                const Coord b234 = computeBitangent(v2, v3, v4, t2, t3, t4);
+                const Coord t341 = computeTangent  (v3, v4, v1, t3, t4, t1);
+                const Coord b341 = computeBitangent(v3, v4, v1, t3, t4, t1);
+                const Coord t412 = computeTangent  (v4, v1, v2, t4, t1, t2);
+                const Coord b412 = computeBitangent(v4, v1, v2, t4, t1, t2);
+
+                m_slotTangents  [slot    ] = t123        + t341 + t412;
+                m_slotBitangents[slot    ] = b123        + b341 + b412;
+                m_slotTangents  [slot + 1] = t123 + t234        + t412;
+                m_slotBitangents[slot + 1] = b123 + b234        + b412;
+                m_slotTangents  [slot + 2] = t123 + t234 + t341;
+                m_slotBitangents[slot + 2] = b123 + b234 + b341;
+                m_slotTangents  [slot + 3] =        t234 + t341 + t412;
+                m_slotBitangents[slot + 3] =        b234 + b341 + b412;
+            }
+        });
+
+    simulation::forEachRange(execution, *taskScheduler, std::size_t(0), nbVertices,
+        [&](const simulation::Range<std::size_t>& range)
+        {
+            for (std::size_t i = range.start; i < range.end; ++i)
+            {
+                if (partial && !m_dirtyVertices[i]) continue;
+                Coord t, b;
+                for (sofa::Index s = m_vertexFaces.begin[i]; s < m_vertexFaces.begin[i + 1]; ++s)
+                {
+                    t += m_slotTangents[m_vertexFaces.slots[s]];
+                    b += m_slotBitangents[m_vertexFaces.slots[s]];
+                }
+                const Coord& n = normals[i];
+                b = sofa::type::cross(n, t.normalized());
+                t = sofa::type::cross(b, n);
+                tangents[i] = t;
+                bitangents[i] = b;
+            }
+        });
+
+    m_tangentsRevision = m_normalsRevision;
+}
+
 void VisualModelImpl::computeBBox(const core::ExecParams*, bool)
 {
     const VecCoord& x = getVertices(); //m_vertices.getValue();
@@ -30,6 +30,7 @@
 #include <sofa/core/objectmodel/DataFileName.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 
+#include <array>
 #include <string>
 
 namespace sofa::component::visual
@@ -142,6 +143,8 @@ public:
     Data<bool> d_handleDynamicTopology; ///< True if topological changes should be handled
     Data<bool> d_fixMergedUVSeams; ///< True if UV seams should be handled even when duplicate UVs are merged
     Data<bool> d_keepLines; ///< keep and draw lines (false by default)
+    Data<bool> d_multithreading; ///< Compute normals and tangents concurrently
+    Data<Real> d_normalsUpdateThreshold; ///< If positive, only update normals and tangents around vertices that moved more than this distance since their last update
 
     Data< VecCoord > d_vertices2; ///< vertices of the model (only if vertices have multiple normals/texcoords, otherwise positions are used)
     core::topology::PointData< VecTexCoord > d_vtexcoords; ///< coordinates of the texture
@@ -443,6 +446,9 @@ public:
     virtual void computeMesh();
     virtual void computeNormals();
     virtual void computeTangents();
+    void computeNormalsFromAdjacency();
+    void computeTangentsFromAdjacency();
+    void updateFaceAdjacency();
     void computeBBox(const core::ExecParams* params, bool=false) override;
     virtual void computeUVSphereProjection();
 
@@ -494,6 +500,30 @@ protected:
 
     /// Internal buffer similar to @sa m_dirtyTriangles but to be used by topolgy Data @sa d_quads callback when points are removed.
     std::set< sofa::core::topology::BaseMeshTopology::QuadID> m_dirtyQuads;
+
+    /// Faces around each vertex (or normal index), in compressed row format.
+    /// Faces are stored as contribution slots: one per triangle, then one per quad corner.
+    /// Normals and tangents are computed per slot, then gathered per vertex without write conflicts.
+    struct FaceAdjacency
+    {
+        type::vector<sofa::Index> begin; ///< first entry of each vertex in slots, plus the total size
+        type::vector<sofa::Index> slots; ///< contribution slots, in face order
+    };
+    FaceAdjacency m_vertexFaces;
+    FaceAdjacency m_normalFaces; ///< only used with d_vertNormIdx
+    /// Counters of the topology Data and number of vertices the adjacency was built for
+    std::array<std::size_t, 4> m_faceAdjacencyKey {};
+
+    VecCoord m_slotNormals;
+    VecCoord m_slotTangents;
+    VecCoord m_slotBitangents;
+    VecCoord m_indexedNormals; ///< normal of each normal index, with d_vertNormIdx
+    VecCoord m_normalsReferencePositions; ///< positions at the last normals update, with d_normalsUpdateThreshold
+    type::vector<char> m_dirtySlots;
+    type::vector<char> m_dirtyVertices;
+    type::vector<char> m_dirtyIndexedNormals;
+    int m_normalsRevision {0};
+    int m_tangentsRevision {-1};
 };
 
 
@@ -120,4 +120,111 @@ TEST( VisualModelImpl_test , checkThatMembersAreCorrectlyConstructed )
     ASSERT_EQ(1u, visualModel.xforms.size());
 }
 
+/// Grid of triangles and quads, with texture coordinates
+void setGridMesh(component::visual::VisualModelImpl& visualModel, int n)
+{
+    using VisualModelImpl = component::visual::VisualModelImpl;
+    VisualModelImpl::VecCoord positions;
+    VisualModelImpl::VecTexCoord texcoords;
+    for (int y = 0; y < n; ++y)
+        for (int x = 0; x < n; ++x)
+        {
+            positions.emplace_back(x, y, 0.1 * ((x * 7 + y * 3) % 5));
+            texcoords.emplace_back(float(x) / n, float(y) / n);
+        }
+    VisualModelImpl::VecVisualTriangle triangles;
+    VisualModelImpl::VecVisualQuad quads;
+    for (int y = 0; y + 1 < n; ++y)
+        for (int x = 0; x + 1 < n; ++x)
+        {
+            const auto i = VisualModelImpl::visual_index_type(x + y * n);
+            if ((x + y) % 2)
+            {
+                triangles.push_back({ i, i + 1, i + n + 1 });
+                triangles.push_back({ i, i + n + 1, i + n });
+            }
+            else
+            {
+                quads.push_back({ i, i + 1, i + n + 1, i + n });
+            }
+        }
+    visualModel.m_positions.setValue(positions);
+    visualModel.d_vtexcoords.setValue(texcoords);
+    visualModel.d_triangles.setValue(triangles);
+    visualModel.d_quads.setValue(quads);
+    visualModel.d_computeTangents.setValue(true);
+}
+
+void expectSameNormalsAndTangents(const component::visual::VisualModelImpl& expected, const component::visual::VisualModelImpl& actual)
+{
+    const auto& expectedNormals = expected.m_vnormals.getValue();
+    const auto& actualNormals = actual.m_vnormals.getValue();
+    ASSERT_EQ(expectedNormals.size(), actualNormals.size());
+    for (std::size_t i = 0; i < expectedNormals.size(); ++i)
+        EXPECT_EQ(expectedNormals[i], actualNormals[i]) << "normal " << i;
+
+    const auto& expectedTangents = expected.d_vtangents.getValue();
+    const auto& actualTangents = actual.d_vtangents.getValue();
+    const auto& expectedBitangents = expected.d_vbitangents.getValue();
+    const auto& actualBitangents = actual.d_vbitangents.getValue();
+    ASSERT_EQ(expectedTangents.size(), actualTangents.size());
+    ASSERT_EQ(expectedBitangents.size(), actualBitangents.size());
+    for (std::size_t i = 0; i < expectedTangents.size(); ++i)
+    {
+        EXPECT_EQ(expectedTangents[i], actualTangents[i]) << "tangent " << i;
+        EXPECT_EQ(expectedBitangents[i], actualBitangents[i]) << "bitangent " << i;
+    }
+}
+
+TEST( VisualModelImpl_test , multithreadedNormalsMatchSequential )
+{
+    StubVisualModelImpl sequential;
+    StubVisualModelImpl multithreaded;
+    setGridMesh(sequential, 12);
+    setGridMesh(multithreaded, 12);
+    multithreaded.d_multithreading.setValue(true);
+
+    sequential.computeNormals();
+    sequential.computeTangents();
+    multithreaded.computeNormals();
+    multithreaded.computeTangents();
+
+    expectSameNormalsAndTangents(sequential, multithreaded);
+}
+
+TEST( VisualModelImpl_test , normalsUpdateThreshold )
+{
+    StubVisualModelImpl full;
+    StubVisualModelImpl partial;
+    setGridMesh(full, 12);
+    setGridMesh(partial, 12);
+    partial.d_normalsUpdateThreshold.setValue(0.01);
+
+    const auto update = [](StubVisualModelImpl& visualModel)
+    {
+        visualModel.computeNormals();
+        visualModel.computeTangents();
+    };
+    update(full);
+    update(partial);
+    expectSameNormalsAndTangents(full, partial);
+
+    // a displacement above the threshold updates the normals around the vertex
+    auto positions = full.m_positions.getValue();
+    positions[30][2] += 0.5;
+    positions[100][0] -= 0.2;
+    full.m_positions.setValue(positions);
+    partial.m_positions.setValue(positions);
+    update(full);
+    update(partial);
+    expectSameNormalsAndTangents(full, partial);
+
+    // a displacement below the threshold is ignored
+    const auto normals = partial.m_vnormals.getValue();
+    positions[60][2] += 0.001;
+    partial.m_positions.setValue(positions);
+    update(partial);
+    EXPECT_EQ(normals[60], partial.m_vnormals.getValue()[60]);
+}
+
 } //sofa
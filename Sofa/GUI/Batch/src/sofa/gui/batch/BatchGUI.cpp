@@ -35,6 +35,8 @@
 #include <string>
 #include <iomanip>
 #include <sofa/gui/batch/ProgressBar.h>
+#include <sofa/gui/batch/BatchRunner.h>
+#include <sofa/core/loader/LoaderCache.h>
 
 
 namespace sofa::gui::batch
@@ -57,6 +59,11 @@ BatchGUI::~BatchGUI()
 
 int BatchGUI::mainLoop()
 {
+    if (!sweepFilename.empty())
+    {
+        return runSweep();
+    }
+
     if (groot)
     {   
         if (nbIter != -1)
@@ -124,6 +131,23 @@ int BatchGUI::mainLoop()
     return 0;
 }
 
+int BatchGUI::runSweep()
+{
+    BatchRunner runner;
+    if (!runner.readSweep(sweepFilename))
+    {
+        return 1;
+    }
+    runner.setOutputs(sweepOutputs);
+    runner.setNbConcurrentRuns(nbConcurrentRuns);
+
+    const std::string results = resultsFilename.empty() ?
+        sofa::helper::system::SetDirectory::GetFileNameWithoutExtension(filename.c_str()) + "_results.csv" : resultsFilename;
+
+    // the scene loaded by the application is only used to fill the cache of the loaders
+    return runner.run(filename, nbIter, results) ? 0 : 1;
+}
+
 void BatchGUI::redraw()
 {
 }
@@ -203,6 +227,27 @@ int BatchGUI::RegisterGUIParameters(ArgumentParser* argumentParser)
         "hideProgressBar",
         "if defined, hides the progress bar"
     );
+    argumentParser->addArgument(
+        cxxopts::value<std::string>(sweepFilename),
+        "sweep",
+        "(only batch) Run a parameter sweep: CSV file listing the paths of the swept Data on its first line, then the values of one run per line",
+        BatchGUI::OnSweepChange
+    );
+    argumentParser->addArgument(
+        cxxopts::value<std::string>(resultsFilename),
+        "results",
+        "(only batch) CSV file where the results of the sweep are written (default: <scene>_results.csv)"
+    );
+    argumentParser->addArgument(
+        cxxopts::value<std::vector<std::string> >(sweepOutputs),
+        "outputs",
+        "(only batch) Comma-separated paths of the Data written in the results of the sweep at the end of each run"
+    );
+    argumentParser->addArgument(
+        cxxopts::value<unsigned int>(nbConcurrentRuns)->default_value("0"),
+        "concurrentRuns",
+        "(only batch) Maximum number of runs of the sweep simulated at the same time (0: number of threads)"
+    );
     return 0;
 }
 
@@ -227,6 +272,16 @@ void BatchGUI::OnNbIterChange(const ArgumentParser* argumentParser, const std::s
     }
 }
 
+void BatchGUI::OnSweepChange(const ArgumentParser* argumentParser, const std::string& strValue)
+{
+    SOFA_UNUSED(argumentParser);
+
+    sweepFilename = strValue;
+
+    // the files read by the loaders are shared between the instances of the scene
+    sofa::core::loader::LoaderCache::getInstance().setEnabled(!sweepFilename.empty());
+}
+
 bool BatchGUI::canExportJson(const std::string& timerOutputStr, const std::string& timerId)
 {
     const auto outputType = AdvancedTimer::getOutputType(AdvancedTimer::IdTimer(timerId));
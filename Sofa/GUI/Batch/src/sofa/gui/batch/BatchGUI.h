@@ -26,6 +26,7 @@
 #include <sofa/simulation/fwd.h>
 #include <string>
 #include <sstream>
+#include <vector>
 
 namespace sofa::gui::common
 {
@@ -63,6 +64,7 @@ public:
     static BaseGUI* CreateGUI(const char* name, sofa::simulation::NodeSPtr groot = nullptr, const char* filename = nullptr);
     static int RegisterGUIParameters(common::ArgumentParser* argumentParser);
     static void OnNbIterChange(const common::ArgumentParser*, const std::string& strValue);
+    static void OnSweepChange(const common::ArgumentParser*, const std::string& strValue);
 
 
     static const signed int DEFAULT_NUMBER_OF_ITERATIONS;
@@ -85,6 +87,16 @@ protected:
     static std::string nbIterInp;
     inline static bool hideProgressBar { false };
 
+    /// @name parameter sweep (see BatchRunner)
+    /// @{
+    inline static std::string sweepFilename;
+    inline static std::string resultsFilename;
+    inline static std::vector<std::string> sweepOutputs;
+    inline static unsigned int nbConcurrentRuns { 0 };
+
+    int runSweep();
+    /// @}
+
     /// Return true if the timer output string has a json string and the timer is setup to output json
     static bool canExportJson(const std::string& timerOutputStr, const std::string& timerId);
 
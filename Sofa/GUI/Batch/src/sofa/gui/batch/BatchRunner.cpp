@@ -0,0 +1,291 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/gui/batch/BatchRunner.h>
+
+#include <sofa/core/PathResolver.h>
+#include <sofa/core/objectmodel/BaseData.h>
+#include <sofa/helper/logging/Messaging.h>
+#include <sofa/helper/system/thread/CTime.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <sofa/simulation/Simulation.h>
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+namespace sofa::gui::batch
+{
+
+namespace
+{
+
+/// Write a field of a CSV file, quoted if needed
+void writeField(std::ostream& out, const std::string& field)
+{
+    if (field.find_first_of(",\"\n") == std::string::npos)
+    {
+        out << field;
+        return;
+    }
+
+    out << '"';
+    for (const char c : field)
+    {
+        if (c == '"')
+        {
+            out << '"';
+        }
+        out << (c == '\n' ? ' ' : c);
+    }
+    out << '"';
+}
+
+std::string trim(const std::string& s)
+{
+    const auto first = s.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+    {
+        return {};
+    }
+    const auto last = s.find_last_not_of(" \t\r");
+    return s.substr(first, last - first + 1);
+}
+
+}
+
+std::vector<std::string> BatchRunner::splitLine(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::string::size_type begin = 0;
+    while (true)
+    {
+        const auto end = line.find(',', begin);
+        fields.push_back(trim(line.substr(begin, end == std::string::npos ? std::string::npos : end - begin)));
+        if (end == std::string::npos)
+        {
+            break;
+        }
+        begin = end + 1;
+    }
+    return fields;
+}
+
+bool BatchRunner::readSweep(const std::string& sweepFilename)
+{
+    std::ifstream in(sweepFilename);
+    if (!in.good())
+    {
+        msg_error("BatchRunner") << "Cannot read the sweep file '" << sweepFilename << "'";
+        return false;
+    }
+
+    m_parameters.clear();
+    m_runs.clear();
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        const std::string trimmed = trim(line);
+        if (trimmed.empty() || trimmed.front() == '#')
+        {
+            continue;
+        }
+
+        auto fields = splitLine(trimmed);
+        if (m_parameters.empty())
+        {
+            m_parameters = std::move(fields);
+        }
+        else if (fields.size() != m_parameters.size())
+        {
+            msg_error("BatchRunner") << sweepFilename << ":" << lineNumber << ": " << fields.size()
+                                     << " values are given for " << m_parameters.size() << " parameters";
+            return false;
+        }
+        else
+        {
+            m_runs.push_back(std::move(fields));
+        }
+    }
+
+    msg_info("BatchRunner") << m_runs.size() << " runs of " << m_parameters.size() << " parameters read from '" << sweepFilename << "'";
+    return !m_parameters.empty();
+}
+
+sofa::simulation::NodeSPtr BatchRunner::createInstance(const std::string& sceneFilename,
+    const std::vector<std::string>& values, std::string& error) const
+{
+    sofa::simulation::NodeSPtr root = sofa::simulation::node::load(sceneFilename);
+    if (!root)
+    {
+        error = "cannot load the scene";
+        return nullptr;
+    }
+
+    for (std::size_t i = 0; i < m_parameters.size(); ++i)
+    {
+        sofa::core::objectmodel::BaseData* data = sofa::core::PathResolver::FindBaseDataFromPath(root.get(), m_parameters[i]);
+        if (data == nullptr)
+        {
+            error = "cannot find the Data " + m_parameters[i];
+        }
+        else if (!data->read(values[i]))
+        {
+            error = "cannot set the value '" + values[i] + "' to " + m_parameters[i];
+        }
+
+        if (!error.empty())
+        {
+            sofa::simulation::node::unload(root);
+            return nullptr;
+        }
+    }
+
+    sofa::simulation::node::initRoot(root.get());
+    return root;
+}
+
+void BatchRunner::writeHeader(std::ostream& out) const
+{
+    out << "run,status";
+    for (const auto& parameter : m_parameters)
+    {
+        out << ',';
+        writeField(out, parameter);
+    }
+    for (const auto& output : m_outputs)
+    {
+        out << ',';
+        writeField(out, output);
+    }
+    out << ",time,duration\n";
+}
+
+bool BatchRunner::run(const std::string& sceneFilename, const int nbIterations, const std::string& resultsFilename) const
+{
+    if (nbIterations < 0)
+    {
+        msg_error("BatchRunner") << "A finite number of iterations is required to run a sweep";
+        return false;
+    }
+
+    std::ofstream out(resultsFilename);
+    if (!out.good())
+    {
+        msg_error("BatchRunner") << "Cannot write the results file '" << resultsFilename << "'";
+        return false;
+    }
+    writeHeader(out);
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    const std::size_t nbConcurrentRuns = std::max<std::size_t>(1,
+        m_nbConcurrentRuns > 0 ? m_nbConcurrentRuns : taskScheduler->getThreadCount());
+
+    msg_info("BatchRunner") << "Computing " << m_runs.size() << " runs of " << nbIterations << " iterations, "
+                            << nbConcurrentRuns << " at the same time";
+
+    using sofa::helper::system::thread::CTime;
+    const double ticksPerSec = static_cast<double>(CTime::getRefTicksPerSec());
+
+    struct Instance
+    {
+        sofa::simulation::NodeSPtr root;
+        std::string error;
+        double duration { 0 };
+    };
+
+    for (std::size_t first = 0; first < m_runs.size(); first += nbConcurrentRuns)
+    {
+        std::vector<Instance> instances(std::min(nbConcurrentRuns, m_runs.size() - first));
+
+        // the instances are created in sequence: the loading and the initialization rely on global resources
+        for (std::size_t i = 0; i < instances.size(); ++i)
+        {
+            instances[i].root = createInstance(sceneFilename, m_runs[first + i], instances[i].error);
+        }
+
+        std::vector<std::size_t> indices(instances.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        simulation::parallelForEach(*taskScheduler, indices.begin(), indices.end(),
+            [&instances, nbIterations, ticksPerSec](const std::size_t i)
+            {
+                Instance& instance = instances[i];
+                if (!instance.root)
+                {
+                    return;
+                }
+
+                const auto start = CTime::getRefTime();
+                for (int it = 0; it < nbIterations; ++it)
+                {
+                    sofa::simulation::node::animate(instance.root.get());
+                }
+                instance.duration = static_cast<double>(CTime::getRefTime() - start) / ticksPerSec;
+            });
+
+        for (std::size_t i = 0; i < instances.size(); ++i)
+        {
+            Instance& instance = instances[i];
+            msg_error_when(!instance.root, "BatchRunner") << "Run " << first + i << ": " << instance.error;
+
+            out << first + i << ',';
+            writeField(out, instance.root ? "ok" : instance.error);
+            for (const auto& value : m_runs[first + i])
+            {
+                out << ',';
+                writeField(out, value);
+            }
+            for (const auto& output : m_outputs)
+            {
+                out << ',';
+                const sofa::core::objectmodel::BaseData* data = instance.root ?
+                    sofa::core::PathResolver::FindBaseDataFromPath(instance.root.get(), output) : nullptr;
+                if (data)
+                {
+                    writeField(out, data->getValueString());
+                }
+            }
+            out << ',' << (instance.root ? instance.root->getTime() : 0) << ',' << instance.duration << '\n';
+
+            if (instance.root)
+            {
+                sofa::simulation::node::unload(instance.root);
+            }
+        }
+        out.flush();
+    }
+
+    msg_info("BatchRunner") << "Results written in '" << resultsFilename << "'";
+    return true;
+}
+
+} // namespace sofa::gui::batch
@@ -0,0 +1,80 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/gui/batch/config.h>
+#include <sofa/simulation/fwd.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace sofa::gui::batch
+{
+
+/**
+ * Run a parameter sweep on a scene: many runs of the same scene, differing only by the values of
+ * a few Data.
+ *
+ * The sweep file lists the paths of the swept Data on its first line (e.g. @/Liver/FEM.youngModulus),
+ * then the values of one run per line. The values are separated by commas, the lines starting
+ * with # are ignored.
+ *
+ * Each run is an instance of the scene, in which the swept Data are set before the initialization.
+ * The files read by the loaders are read only once, and shared between the instances as long as
+ * they are not modified (see sofa::core::loader::LoaderCache).
+ * The instances are stepped concurrently on the task scheduler. The values of the output Data of
+ * all the runs, at the end of the simulation, are written in a CSV results file.
+ */
+class SOFA_GUI_BATCH_API BatchRunner
+{
+public:
+    /// Read the swept Data and their values. Return false if the file cannot be read or is ill-formed.
+    bool readSweep(const std::string& sweepFilename);
+
+    /// Paths of the Data to record at the end of each run
+    void setOutputs(const std::vector<std::string>& outputs) { m_outputs = outputs; }
+
+    /// Maximum number of instances of the scene living at the same time. 0 means the number of threads of the task scheduler.
+    void setNbConcurrentRuns(unsigned int nbConcurrentRuns) { m_nbConcurrentRuns = nbConcurrentRuns; }
+
+    std::size_t getNbRuns() const { return m_runs.size(); }
+
+    /// Simulate nbIterations time steps of each run, and write the results of all the runs
+    bool run(const std::string& sceneFilename, int nbIterations, const std::string& resultsFilename) const;
+
+    /// Split a line of a CSV file, the fields being trimmed
+    static std::vector<std::string> splitLine(const std::string& line);
+
+protected:
+    /// Load an instance of the scene, set the Data of the run and initialize the instance.
+    /// Return nullptr and the reason in error if it fails.
+    sofa::simulation::NodeSPtr createInstance(const std::string& sceneFilename, const std::vector<std::string>& values, std::string& error) const;
+
+    void writeHeader(std::ostream& out) const;
+
+    std::vector<std::string> m_parameters;
+    std::vector<std::vector<std::string> > m_runs;
+    std::vector<std::string> m_outputs;
+    unsigned int m_nbConcurrentRuns { 0 };
+};
+
+} // namespace sofa::gui::batch
@@ -63,10 +63,25 @@ void DataEngine::updateAllInputs()
 }
 
 void DataEngine::update()
+{
+    beginUpdate();
+    computeUpdate();
+    endUpdate();
+}
+
+void DataEngine::beginUpdate()
 {
     updateAllInputs();
     DDGNode::cleanDirty();
+}
+
+void DataEngine::computeUpdate()
+{
     doUpdate();
+}
+
+void DataEngine::endUpdate()
+{
     m_dataTracker.clean();
 }
 } // namespace sofa::core
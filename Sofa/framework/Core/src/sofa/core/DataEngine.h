@@ -84,6 +84,20 @@ public:
     /// User implementation moved to doUpdate()
     void update() final;
 
+    /// Returns true if doUpdate() only reads the inputs and writes the outputs of this engine,
+    /// so that it can run concurrently with the update of other engines.
+    virtual bool isThreadSafe() const { return false; }
+
+    /// @name Staged update
+    /// update() is equivalent to beginUpdate(), computeUpdate() and endUpdate() called in sequence.
+    /// Used to run the computeUpdate() of independent thread-safe engines concurrently,
+    /// while the bookkeeping of the data dependency graph stays on the calling thread.
+    /// @{
+    void beginUpdate();
+    void computeUpdate();
+    void endUpdate();
+    /// @}
+
     /// Add a new input to this engine
     /// Automatically adds the input fields to the datatracker
     void addInput(sofa::core::objectmodel::BaseData* data);
@@ -0,0 +1,153 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/core/loader/LoaderCache.h>
+#include <sofa/core/loader/BaseLoader.h>
+
+#include <filesystem>
+#include <sstream>
+
+namespace sofa::core::loader
+{
+
+LoaderCache& LoaderCache::getInstance()
+{
+    static LoaderCache cache;
+    return cache;
+}
+
+void LoaderCache::setEnabled(const bool enabled)
+{
+    m_isEnabled = enabled;
+    if (!enabled)
+    {
+        clear();
+    }
+}
+
+void LoaderCache::clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_entries.clear();
+}
+
+std::size_t LoaderCache::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
+
+std::string LoaderCache::computeKey(const BaseLoader* loader) const
+{
+    if (!m_isEnabled || loader == nullptr)
+    {
+        return {};
+    }
+
+    const std::string& filename = loader->d_filename.getFullPath();
+    std::error_code error;
+    const auto lastWriteTime = std::filesystem::last_write_time(filename, error);
+    if (filename.empty() || error)
+    {
+        return {};
+    }
+
+    std::ostringstream key;
+    key << loader->getClassName() << '<' << loader->getTemplateName() << ">|" << filename
+        << '|' << lastWriteTime.time_since_epoch().count();
+
+    for (const objectmodel::BaseData* data : loader->getDataFields())
+    {
+        if (data->isSet() && data != &loader->d_filename && data->getName() != "name")
+        {
+            key << '|' << data->getName() << '=' << data->getValueString();
+        }
+    }
+    return key.str();
+}
+
+bool LoaderCache::restore(const std::string& key, BaseLoader* loader) const
+{
+    if (key.empty())
+    {
+        return false;
+    }
+
+    std::lock_guard lock(m_mutex);
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        return false;
+    }
+
+    for (const auto& [name, value] : it->second)
+    {
+        if (objectmodel::BaseData* data = loader->findData(name))
+        {
+            data->updateValueFromLink(value.get());
+        }
+    }
+    return true;
+}
+
+LoaderCache::DataCounters LoaderCache::getCounters(const BaseLoader* loader)
+{
+    DataCounters counters;
+    for (objectmodel::BaseData* data : loader->getDataFields())
+    {
+        counters.emplace_back(data, data->getCounter());
+    }
+    return counters;
+}
+
+void LoaderCache::store(const std::string& key, const BaseLoader* loader, const DataCounters& countersBeforeLoading)
+{
+    if (key.empty())
+    {
+        return;
+    }
+
+    Entry entry;
+    for (const auto& [data, counter] : countersBeforeLoading)
+    {
+        if (data->getCounter() == counter)
+        {
+            continue;
+        }
+
+        // the value is shared with the loader until one of them is modified
+        std::unique_ptr<objectmodel::BaseData> value(data->getNewInstance());
+        if (value && value->updateValueFromLink(data))
+        {
+            entry.emplace_back(data->getName(), std::move(value));
+        }
+        else
+        {
+            msg_warning(loader) << "Data '" << data->getName() << "' cannot be cached: the file will be read again by the next loader";
+            return;
+        }
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_entries[key] = std::move(entry);
+}
+
+} // namespace sofa::core::loader
@@ -0,0 +1,91 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/core/config.h>
+#include <sofa/core/objectmodel/BaseData.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sofa::core::loader
+{
+
+class BaseLoader;
+
+/**
+ * Process-wide cache of the Data loaded from files by the loaders.
+ *
+ * When the cache is enabled, the Data written by a loader while reading a file are stored in the
+ * cache. A loader of the same type, reading the same (unmodified) file with the same parameters,
+ * then gets its Data from the cache instead of reading the file again.
+ * The cached values are shared with the loaders (copy-on-write): the memory is duplicated only
+ * when a loader, or a component linked to its Data, modifies them.
+ *
+ * The cache is disabled by default. It is meant for applications instantiating the same scene many
+ * times in the same process, such as parameter sweeps.
+ */
+class SOFA_CORE_API LoaderCache
+{
+public:
+    /// Counter of each Data of a loader, used to find the Data written by the loading
+    using DataCounters = std::vector<std::pair<objectmodel::BaseData*, int> >;
+
+    static LoaderCache& getInstance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_isEnabled; }
+
+    /// Remove all the entries of the cache
+    void clear();
+
+    /// Number of entries in the cache
+    std::size_t size() const;
+
+    /// Key identifying the loading of the file of a loader: type of the loader, path and modification
+    /// date of the file, and values of the Data set by the user.
+    /// Empty if the cache is disabled or if the file does not exist.
+    std::string computeKey(const BaseLoader* loader) const;
+
+    /// Copy the Data stored for this key into the loader.
+    /// Return false if there is no entry for this key.
+    bool restore(const std::string& key, BaseLoader* loader) const;
+
+    static DataCounters getCounters(const BaseLoader* loader);
+
+    /// Store the Data of the loader modified since the counters have been taken
+    void store(const std::string& key, const BaseLoader* loader, const DataCounters& countersBeforeLoading);
+
+private:
+    LoaderCache() = default;
+
+    using Entry = std::vector<std::pair<std::string, std::unique_ptr<objectmodel::BaseData> > >;
+
+    std::map<std::string, Entry> m_entries;
+    mutable std::mutex m_mutex;
+    bool m_isEnabled { false };
+};
+
+} // namespace sofa::core::loader
@@ -20,6 +20,7 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/core/loader/MeshLoader.h>
+#include <sofa/core/loader/LoaderCache.h>
 #include <sofa/helper/io/Mesh.h>
 #include <sofa/helper/system/FileRepository.h>
 #include <sofa/helper/accessor.h>
@@ -243,6 +244,16 @@ void MeshLoader::reinit()
 
 bool MeshLoader::load()
 {
+    // The same file may have already been loaded with the same parameters
+    LoaderCache& cache = LoaderCache::getInstance();
+    const std::string cacheKey = cache.computeKey(this);
+    if (cache.restore(cacheKey, this))
+    {
+        return true;
+    }
+
+    const LoaderCache::DataCounters counters = cacheKey.empty() ? LoaderCache::DataCounters() : LoaderCache::getCounters(this);
+
     // Clear previously loaded buffers
     clearBuffers();
 
@@ -251,6 +262,8 @@ bool MeshLoader::load()
     // Clear (potentially) partially filled buffers
     if (!loaded)
         clearBuffers();
+    else
+        cache.store(cacheKey, this, counters);
     return loaded;
 }
 
@@ -76,6 +76,9 @@ Base::Base()
 
 Base::~Base()
 {
+    // the queued messages may refer to this component
+    if (helper::logging::MessageDispatcher::isAsynchronous())
+        helper::logging::MessageDispatcher::flush();
 }
 
 void Base::addRef()
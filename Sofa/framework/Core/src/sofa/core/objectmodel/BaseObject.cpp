@@ -333,6 +333,12 @@ void BaseObject::reset()
 void BaseObject::cleanup()
 { }
 
+void BaseObject::storeInternalState(std::ostream& /*out*/) const
+{ }
+
+void BaseObject::restoreInternalState(std::istream& /*in*/)
+{ }
+
 void BaseObject::handleEvent( Event* /*e*/ )
 { }
 
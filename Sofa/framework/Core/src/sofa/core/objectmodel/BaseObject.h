@@ -25,6 +25,8 @@
 #include <sofa/core/DataTracker.h>
 #include <sofa/core/fwd.h>
 
+#include <iosfwd>
+
 namespace sofa::core::objectmodel
 {
 
@@ -97,6 +99,15 @@ public:
     /// so any references this object holds should still be valid.
     virtual void cleanup();
 
+    /// Write the internal state of the component which is not stored in its Data (e.g. warm-start or
+    /// history variables), to be saved in a checkpoint of the simulation.
+    virtual void storeInternalState(std::ostream& out) const;
+
+    /// Restore the internal state written by storeInternalState. It is called after the Data of the
+    /// component have been restored from a checkpoint, if some of them have changed or if the
+    /// internal state is not empty.
+    virtual void restoreInternalState(std::istream& in);
+
     /// @}
 
     /// Render internal data of this object, for debugging purposes.
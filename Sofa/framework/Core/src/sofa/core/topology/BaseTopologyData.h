@@ -96,6 +96,9 @@ public:
     /// Remove the values corresponding to the points removed.
     virtual void remove( const sofa::type::vector<unsigned int>& ) {}
 
+    /// Remove the values corresponding to the elements removed by a topological event, which can share its renumbering between the Data.
+    virtual void remove( const sofa::type::vector<unsigned int>& index, const TopologyChange* /*removalEvent*/ ) { remove(index); }
+
     /// Swaps values at indices i1 and i2.
     virtual void swap( unsigned int , unsigned int ) {}
 
@@ -0,0 +1,189 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/core/topology/ElementColoring.h>
+#include <sofa/core/topology/BaseMeshTopology.h>
+
+#include <algorithm>
+
+namespace sofa::core::topology
+{
+
+namespace
+{
+
+Size getNbElements(BaseMeshTopology* topology, sofa::geometry::ElementType elementType)
+{
+    switch (elementType)
+    {
+    case sofa::geometry::ElementType::EDGE: return topology->getNbEdges();
+    case sofa::geometry::ElementType::TRIANGLE: return topology->getNbTriangles();
+    case sofa::geometry::ElementType::QUAD: return topology->getNbQuads();
+    case sofa::geometry::ElementType::TETRAHEDRON: return topology->getNbTetrahedra();
+    case sofa::geometry::ElementType::HEXAHEDRON: return topology->getNbHexahedra();
+    default: return 0;
+    }
+}
+
+}
+
+bool ElementColoring::update(BaseMeshTopology* topology, sofa::geometry::ElementType elementType, Strategy strategy)
+{
+    if (topology == nullptr)
+    {
+        return false;
+    }
+
+    const int revision = topology->getRevision();
+    const Size nbElements = getNbElements(topology, elementType);
+
+    if (m_isValid && revision == m_revision && nbElements == m_nbElements
+        && elementType == m_elementType && strategy == m_strategy)
+    {
+        return false;
+    }
+
+    switch (elementType)
+    {
+    case sofa::geometry::ElementType::EDGE: compute(topology->getEdges(), strategy); break;
+    case sofa::geometry::ElementType::TRIANGLE: compute(topology->getTriangles(), strategy); break;
+    case sofa::geometry::ElementType::QUAD: compute(topology->getQuads(), strategy); break;
+    case sofa::geometry::ElementType::TETRAHEDRON: compute(topology->getTetrahedra(), strategy); break;
+    case sofa::geometry::ElementType::HEXAHEDRON: compute(topology->getHexahedra(), strategy); break;
+    default:
+        m_colors.clear();
+        m_elementColors.clear();
+        m_isValid = false;
+        return false;
+    }
+
+    m_revision = revision;
+    m_elementType = elementType;
+    return true;
+}
+
+void ElementColoring::compute(const sofa::type::vector<Index>& elementBegin, const sofa::type::vector<Index>& elementVertices, Strategy strategy)
+{
+    const Size nbElements = elementBegin.empty() ? 0 : static_cast<Size>(elementBegin.size() - 1);
+    const Size nbVertices = elementVertices.empty() ? 0 : *std::max_element(elementVertices.begin(), elementVertices.end()) + 1;
+
+    // elements around each vertex, in compressed format
+    sofa::type::vector<Index> vertexBegin(nbVertices + 1, 0);
+    for (const Index v : elementVertices)
+    {
+        ++vertexBegin[v + 1];
+    }
+    for (Size v = 0; v < nbVertices; ++v)
+    {
+        vertexBegin[v + 1] += vertexBegin[v];
+    }
+    sofa::type::vector<Index> vertexElements(elementVertices.size());
+    {
+        sofa::type::vector<Index> position(vertexBegin.begin(), vertexBegin.end() - 1);
+        for (Index e = 0; e < nbElements; ++e)
+        {
+            for (Index k = elementBegin[e]; k < elementBegin[e + 1]; ++k)
+            {
+                vertexElements[position[elementVertices[k]]++] = e;
+            }
+        }
+    }
+
+    // forbidden[c] == e if the color c is used by a neighbor of the element e
+    sofa::type::vector<Index> forbidden;
+    sofa::type::vector<Size> colorSizes;
+
+    const auto colorElements = [&](const bool balanced)
+    {
+        m_elementColors.assign(nbElements, sofa::InvalidID);
+        forbidden.assign(colorSizes.size(), sofa::InvalidID);
+        if (!balanced)
+        {
+            colorSizes.clear();
+        }
+        else
+        {
+            std::fill(colorSizes.begin(), colorSizes.end(), 0);
+        }
+
+        for (Index e = 0; e < nbElements; ++e)
+        {
+            for (Index k = elementBegin[e]; k < elementBegin[e + 1]; ++k)
+            {
+                const Index v = elementVertices[k];
+                for (Index n = vertexBegin[v]; n < vertexBegin[v + 1]; ++n)
+                {
+                    const Index neighborColor = m_elementColors[vertexElements[n]];
+                    if (neighborColor != sofa::InvalidID)
+                    {
+                        forbidden[neighborColor] = e;
+                    }
+                }
+            }
+
+            Index color = sofa::InvalidID;
+            for (Index c = 0; c < colorSizes.size(); ++c)
+            {
+                if (forbidden[c] != e && (color == sofa::InvalidID || (balanced && colorSizes[c] < colorSizes[color])))
+                {
+                    color = c;
+                    if (!balanced)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            if (color == sofa::InvalidID)
+            {
+                color = static_cast<Index>(colorSizes.size());
+                colorSizes.push_back(0);
+                forbidden.push_back(sofa::InvalidID);
+            }
+
+            m_elementColors[e] = color;
+            ++colorSizes[color];
+        }
+    };
+
+    colorElements(false);
+    if (strategy == Strategy::Balanced)
+    {
+        colorElements(true);
+    }
+
+    m_colors.clear();
+    m_colors.resize(colorSizes.size());
+    for (Index c = 0; c < colorSizes.size(); ++c)
+    {
+        m_colors[c].reserve(colorSizes[c]);
+    }
+    for (Index e = 0; e < nbElements; ++e)
+    {
+        m_colors[m_elementColors[e]].push_back(e);
+    }
+
+    m_nbElements = nbElements;
+    m_strategy = strategy;
+    m_isValid = true;
+}
+
+} //namespace sofa::core::topology
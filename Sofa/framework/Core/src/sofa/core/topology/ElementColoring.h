@@ -0,0 +1,116 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/core/config.h>
+
+#include <sofa/geometry/ElementType.h>
+#include <sofa/type/vector.h>
+
+namespace sofa::core::topology
+{
+
+class BaseMeshTopology;
+
+/** \brief Partition of the elements of a mesh into colors, two elements of the same color sharing no vertex.
+*
+* The elements of a color can be processed concurrently when each element accumulates values on its vertices,
+* for instance the forces of a force field, without atomic operations nor per-thread copies of the result.
+* The colors are processed one after the other.
+*
+* Two strategies are available:
+* - Greedy: each element takes the first color not used by its neighbors. It gives few colors, the first ones
+*   being larger than the last ones.
+* - Balanced: the number of colors of the greedy coloring is kept, and each element takes the least used color
+*   among the ones not used by its neighbors. The colors have similar sizes, which balances the parallel work.
+*
+* The colors of the elements of a topology are computed again only when the topology changes
+* (@sa BaseMeshTopology::getRevision), so that they can be updated at each time step at no cost.
+*/
+class SOFA_CORE_API ElementColoring
+{
+public:
+    enum class Strategy : unsigned char
+    {
+        Greedy,
+        Balanced
+    };
+
+    /// Indices of the elements of a color
+    using Color = sofa::type::vector<Index>;
+
+    /**
+    * Update the colors of the elements of the given type in the topology. They are computed again only if the
+    * revision of the topology, its number of elements, the element type or the strategy changed since the last
+    * computation, or if the colors have been invalidated.
+    * Supported element types are edges, triangles, quads, tetrahedra and hexahedra.
+    * \return true if the colors have been computed
+    */
+    bool update(BaseMeshTopology* topology, sofa::geometry::ElementType elementType, Strategy strategy = Strategy::Balanced);
+
+    /// Compute the colors of a list of elements, each element being an array of vertex indices
+    template<class VecElement>
+    void compute(const VecElement& elements, Strategy strategy = Strategy::Balanced)
+    {
+        sofa::type::vector<Index> elementBegin;
+        sofa::type::vector<Index> elementVertices;
+        elementBegin.reserve(elements.size() + 1);
+        elementBegin.push_back(0);
+        for (const auto& element : elements)
+        {
+            for (const auto vertex : element)
+            {
+                elementVertices.push_back(static_cast<Index>(vertex));
+            }
+            elementBegin.push_back(static_cast<Index>(elementVertices.size()));
+        }
+        compute(elementBegin, elementVertices, strategy);
+    }
+
+    /**
+    * Compute the colors of elements given in compressed format: the vertices of the element i are
+    * elementVertices[elementBegin[i]] to elementVertices[elementBegin[i+1] - 1].
+    */
+    void compute(const sofa::type::vector<Index>& elementBegin, const sofa::type::vector<Index>& elementVertices, Strategy strategy = Strategy::Balanced);
+
+    /// The colors will be computed again at the next update
+    void invalidate() { m_isValid = false; }
+
+    /// Elements of each color
+    const sofa::type::vector<Color>& getColors() const { return m_colors; }
+
+    Size getNbColors() const { return static_cast<Size>(m_colors.size()); }
+
+    /// Color of each element
+    const sofa::type::vector<Index>& getElementColors() const { return m_elementColors; }
+
+protected:
+    sofa::type::vector<Color> m_colors;
+    sofa::type::vector<Index> m_elementColors;
+
+    bool m_isValid { false };
+    int m_revision { -1 };
+    Size m_nbElements { 0 };
+    sofa::geometry::ElementType m_elementType { sofa::geometry::ElementType::UNKNOWN };
+    Strategy m_strategy { Strategy::Balanced };
+};
+
+} //namespace sofa::core::topology
@@ -278,6 +278,19 @@ bool TopologyChange::read(std::istream& /* in */)
     return false;
 }
 
+std::shared_ptr<const TopologyRemovalRenumbering> TopologyChange::getRemovalRenumbering(Size nbElements, const sofa::type::vector<Index>& removedIndices) const
+{
+    for (const auto& renumbering : m_removalRenumberings)
+    {
+        if (renumbering->getNbElements() == nbElements)
+            return renumbering;
+    }
+
+    auto renumbering = std::make_shared<const TopologyRemovalRenumbering>(nbElements, removedIndices);
+    m_removalRenumberings.push_back(renumbering);
+    return renumbering;
+}
+
 EndingEvent::~EndingEvent()
 {
 }
@@ -22,8 +22,10 @@
 #pragma once
 
 #include <sofa/core/topology/Topology.h>
+#include <sofa/core/topology/TopologyRemovalRenumbering.h>
 #include <sofa/core/objectmodel/Data.h>
 #include <sofa/helper/list.h>
+#include <memory>
 
 namespace sofa::core::topology
 {
@@ -348,12 +350,22 @@ public:
     /// Input (empty) stream
     SOFA_CORE_API friend std::istream& operator>> ( std::istream& in, const TopologyChange*& );
 
+    /** \brief Returns the renumbering of a buffer of @param nbElements elements implied by the removal of @param removedIndices.
+    *
+    * Only meaningful for removal events. The renumbering is computed on the first request and cached in this event, so that
+    * all the TopologyData reacting to the same event share it instead of replaying the removals one by one.
+    */
+    std::shared_ptr<const TopologyRemovalRenumbering> getRemovalRenumbering(Size nbElements, const sofa::type::vector<Index>& removedIndices) const;
+
 protected:
     TopologyChange( TopologyChangeType changeType = BASE )
         : m_changeType(changeType)
     {}
 
     TopologyChangeType m_changeType; ///< A code that tells the nature of the Topology modification event (could be an enum).
+
+    /// Renumberings already computed for this event, one per buffer size. @sa getRemovalRenumbering
+    mutable sofa::type::vector< std::shared_ptr<const TopologyRemovalRenumbering> > m_removalRenumberings;
 };
 
 /** notifies the end for the current sequence of topological change events */
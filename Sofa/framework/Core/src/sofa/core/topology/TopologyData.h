@@ -86,6 +86,12 @@ public:
     /// Remove the values corresponding to the elements removed.
     void remove(const sofa::type::vector<Index>& index) override;
 
+    /** Remove the values corresponding to the elements removed by a topological event, compacting this container in a single pass.
+    * @param index indices of the removed elements, sorted in decreasing order
+    * @param removalEvent event holding the renumbering shared by all the Data linked to the topology. If null, the renumbering is computed locally.
+    */
+    void remove(const sofa::type::vector<Index>& index, const TopologyChange* removalEvent) override;
+
     /// Add some values. Values are added at the end of the vector.
     /// This (new) version gives more information for element indices and ancestry
     virtual void add(const sofa::type::vector<Index>& index,
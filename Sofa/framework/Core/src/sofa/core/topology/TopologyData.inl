@@ -262,29 +262,37 @@ void TopologyData <ElementType, VecT>::swap(Index i1, Index i2)
 
 template <typename ElementType, typename VecT>
 void TopologyData <ElementType, VecT>::remove(const sofa::type::vector<Index>& index)
+{
+    remove(index, nullptr);
+}
+
+
+template <typename ElementType, typename VecT>
+void TopologyData <ElementType, VecT>::remove(const sofa::type::vector<Index>& index, const TopologyChange* removalEvent)
 {
     helper::WriteOnlyAccessor<Data< container_type > > data = this;
     if (data.size() > 0)
     {
-        // make sure m_lastElementIndex is up to date before removing
-        this->m_lastElementIndex = static_cast<Index>(data.size()) - 1;
+        const Size nbElements = Size(data.size());
+        const auto renumbering = removalEvent
+            ? removalEvent->getRemovalRenumbering(nbElements, index)
+            : std::make_shared<const TopologyRemovalRenumbering>(nbElements, index);
 
-        // Loop over the indices to remove. As in topology process when removing elements:
-        // 1- propagate event by calling callback if it has been set.
-        // 2- really remove element using swap + pop_back. 
-        // 3- Update m_lastElementIndex in case it is used in callback while removing several elements
-        for (std::size_t i = 0; i < index.size(); ++i)
+        // 1- propagate event by calling callback if it has been set. The removed values are not moved before all the
+        // callbacks are called and m_lastElementIndex is updated as if the elements were removed one by one.
+        if (p_onDestructionCallback)
         {
-            if (p_onDestructionCallback)
+            const Index lastElementIndex = Index(nbElements) - 1;
+            for (std::size_t i = 0; i < index.size(); ++i)
             {
+                this->m_lastElementIndex = lastElementIndex - Index(i);
                 p_onDestructionCallback(index[i], data[index[i]]);
             }
-
-            this->swap(index[i], this->m_lastElementIndex);
-            --this->m_lastElementIndex;
         }
 
-        data.resize(data.size() - index.size());
+        // 2- really remove the elements: move the last values in the holes in a single pass and shrink the container.
+        renumbering->apply(data.wref());
+        this->m_lastElementIndex = Index(renumbering->getNbRemainingElements()) - 1;
     }
 }
 
@@ -149,7 +149,7 @@ void TopologyDataHandler<ElementType,  VecT>::ApplyTopologyChange(const EAdded*
 template <typename ElementType, typename VecT>
 void TopologyDataHandler<ElementType,  VecT>::ApplyTopologyChange(const ERemoved* event)
 {
-    m_topologyData->remove(event->getArray());
+    m_topologyData->remove(event->getArray(), event);
 }
 
 /// Apply renumbering on elements.
@@ -0,0 +1,105 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/core/topology/TopologyRemovalRenumbering.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace sofa::core::topology
+{
+
+TopologyRemovalRenumbering::TopologyRemovalRenumbering(Size nbElements, const sofa::type::vector<Index>& removedIndices)
+    : m_nbElements(nbElements)
+{
+    m_removedIndices.reserve(removedIndices.size());
+    for (const Index elemId : removedIndices)
+    {
+        if (elemId < nbElements)
+            m_removedIndices.push_back(elemId);
+    }
+    std::sort(m_removedIndices.begin(), m_removedIndices.end());
+    m_removedIndices.erase(std::unique(m_removedIndices.begin(), m_removedIndices.end()), m_removedIndices.end());
+
+    m_nbRemainingElements = m_nbElements - Size(m_removedIndices.size());
+
+    // Replay the swap-with-last removals of the containers, only keeping track of the positions which were
+    // overwritten: occupant[position] is the index, before the removal, of the element now stored at position.
+    std::unordered_map<Index, Index> occupant;
+    occupant.reserve(m_removedIndices.size());
+    const auto elementAt = [&occupant](Index position)
+    {
+        const auto it = occupant.find(position);
+        return it == occupant.end() ? position : it->second;
+    };
+
+    Index last = Index(m_nbElements);
+    for (auto it = m_removedIndices.rbegin(); it != m_removedIndices.rend(); ++it)
+    {
+        --last;
+        if (*it != last)
+        {
+            occupant[*it] = elementAt(last);
+        }
+    }
+
+    // Positions beyond the new size have been popped, the others are the destinations of the moves
+    m_moves.reserve(occupant.size());
+    for (const auto& [position, source] : occupant)
+    {
+        if (position < m_nbRemainingElements)
+            m_moves.emplace_back(position, source);
+    }
+    std::sort(m_moves.begin(), m_moves.end());
+
+    m_movesBySource.reserve(m_moves.size());
+    for (const auto& [destination, source] : m_moves)
+    {
+        m_movesBySource.emplace_back(source, destination);
+    }
+    std::sort(m_movesBySource.begin(), m_movesBySource.end());
+}
+
+bool TopologyRemovalRenumbering::isRemoved(Index elemId) const
+{
+    return std::binary_search(m_removedIndices.begin(), m_removedIndices.end(), elemId);
+}
+
+Index TopologyRemovalRenumbering::getNewIndex(Index elemId) const
+{
+    if (elemId >= m_nbElements)
+        return elemId;
+
+    if (isRemoved(elemId))
+        return sofa::InvalidID;
+
+    if (elemId < m_nbRemainingElements)
+        return elemId;
+
+    // element beyond the new size and not removed: it has been moved into a hole
+    const auto it = std::lower_bound(m_movesBySource.begin(), m_movesBySource.end(), Move(elemId, 0));
+    if (it != m_movesBySource.end() && it->first == elemId)
+        return it->second;
+
+    return sofa::InvalidID;
+}
+
+} //namespace sofa::core::topology
@@ -0,0 +1,94 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/core/config.h>
+
+#include <sofa/type/vector.h>
+#include <utility>
+
+namespace sofa::core::topology
+{
+
+/** \brief Renumbering of the elements of a topology buffer implied by a removal event.
+*
+* The topology containers remove elements one by one, in decreasing index order, each removed element being
+* replaced by the last element of the buffer. This class computes once the global result of this sequence:
+* the final index of every remaining element and the list of moves to compact a buffer following the topology.
+* It is computed in O(k log k) for k removed elements, independently of the size of the buffer, and can be
+* shared by all the TopologyData linked to the same topology (@sa TopologyChange::getRemovalRenumbering).
+*/
+class SOFA_CORE_API TopologyRemovalRenumbering
+{
+public:
+    /// A move (destination, source): the element at index source before the removal takes index destination.
+    using Move = std::pair<Index, Index>;
+
+    /**
+    * @param nbElements number of elements in the buffer before the removal
+    * @param removedIndices indices of the removed elements. Duplicated and out of bounds indices are ignored.
+    */
+    TopologyRemovalRenumbering(Size nbElements, const sofa::type::vector<Index>& removedIndices);
+
+    /// Number of elements in the buffer before the removal
+    Size getNbElements() const { return m_nbElements; }
+
+    /// Number of elements in the buffer after the removal
+    Size getNbRemainingElements() const { return m_nbRemainingElements; }
+
+    /** Moves to apply to a buffer to compact it, sorted by destination.
+    * A source is never the destination of another move, so the moves are independent and can be applied in any order.
+    */
+    const sofa::type::vector<Move>& getMoves() const { return m_moves; }
+
+    /// Return true if the element of index @param elemId is removed
+    bool isRemoved(Index elemId) const;
+
+    /// Return the index of the element @param elemId after the removal, sofa::InvalidID if it is removed.
+    /// Indices out of the buffer are returned unchanged.
+    Index getNewIndex(Index elemId) const;
+
+    /// Apply the moves to a buffer of getNbElements() values and resize it to getNbRemainingElements()
+    template<class Container>
+    void apply(Container& buffer) const
+    {
+        for (const auto& [destination, source] : m_moves)
+        {
+            buffer[destination] = std::move(buffer[source]);
+        }
+        buffer.resize(m_nbRemainingElements);
+    }
+
+protected:
+    Size m_nbElements { 0 };
+    Size m_nbRemainingElements { 0 };
+
+    /// Removed indices sorted in increasing order
+    sofa::type::vector<Index> m_removedIndices;
+
+    /// Moves sorted by destination
+    sofa::type::vector<Move> m_moves;
+
+    /// Moves as (source, destination) sorted by source, to look up the new index of a moved element
+    sofa::type::vector<Move> m_movesBySource;
+};
+
+} //namespace sofa::core::topology
@@ -82,6 +82,12 @@ public:
     */
     virtual const type::vector<Index> indicesOfElement(Index index) const;
 
+    /** Method to return the element stored at a given position of the vector map @sa m_map2Elements
+    * @param {Index} position in the vector map
+    * @return {Index} element index of the full Data vector. return sofa::InvalidID if out of the map.
+    */
+    virtual Index elementOfIndex(Index posId) const;
+
     /// Swaps values of this subsetmap at indices i1 and i2. (only if i1 and i2 < subset size())
     void swap(Index i1, Index i2) override;
 
@@ -105,8 +111,10 @@ public:
         const sofa::type::vector< sofa::type::vector< SReal > >& coefs,
         const sofa::type::vector< AncestorElem >& ancestorElems) override;
 
-    /// Remove elems with inputted indices. Will remove only the data contains by this subset.
-    void remove(const sofa::type::vector<Index>& index) override;
+    using TopologyData<ElementType, VecT>::remove;
+
+    /// Remove elems with inputted indices. Will remove only the data contains by this subset and renumber the others, in a single pass.
+    void remove(const sofa::type::vector<Index>& index, const TopologyChange* removalEvent) override;
 
     /// Reorder the values. TODO epernod 2021-05-24: check if needed and implement it if needed.
     void renumber(const sofa::type::vector<Index>& index) override;
@@ -133,12 +141,6 @@ protected:
     */
     virtual void swapPostProcess(Index i1, Index i2);
 
-    /**
-    * Internal method called at the end of @sa remove method to apply internal mechanism, such as updating the map size
-    * @param nbElements Number of element removed.
-    */
-    virtual void removePostProcess(sofa::Index elemId);
-
     /**
     * Internal method called at the end of @sa add method to apply internal mechanism, such as updating the map size.
     * @param dataLastId Index of the last element id in the TopologyData tracked
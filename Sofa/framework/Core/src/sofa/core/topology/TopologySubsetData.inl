@@ -86,6 +86,12 @@ const type::vector<Index> TopologySubsetData <ElementType, VecT>::indicesOfEleme
     return returnVec;
 }
 
+template <typename ElementType, typename VecT>
+Index TopologySubsetData <ElementType, VecT>::elementOfIndex(Index posId) const
+{
+    return (posId < m_map2Elements.size()) ? m_map2Elements[posId] : sofa::InvalidID;
+}
+
 template <typename ElementType, typename VecT>
 void TopologySubsetData <ElementType, VecT>::add(sofa::Size nbElements,
     const sofa::type::vector<sofa::type::vector<Index> >& ancestors,
@@ -169,48 +175,57 @@ void TopologySubsetData <ElementType, VecT>::move(const sofa::type::vector<Index
 
 
 template <typename ElementType, typename VecT>
-void TopologySubsetData<ElementType, VecT>::remove(const sofa::type::vector<Index>& index)
+void TopologySubsetData<ElementType, VecT>::remove(const sofa::type::vector<Index>& index, const TopologyChange* removalEvent)
 {
     helper::WriteOnlyAccessor<Data<container_type> > data = this;
-    
+    if (data.size() == 0)
+        return;
+
     // Update last element index before removing elements. Warn is sent before updating Topology buffer
-    Index lastTopoElemId = this->getLastElementIndex();
-    
-    // check for each element index to remove if it concern this subsetData
-    // The index vector is supposed to be sorted in descendent index order
-    for (Index elemId : index)
+    const Index lastTopoElemId = this->getLastElementIndex();
+    const Size nbTopoElements = (lastTopoElemId == sofa::InvalidID) ? 0 : Size(lastTopoElemId + 1);
+    const auto renumbering = removalEvent
+        ? removalEvent->getRemovalRenumbering(nbTopoElements, index)
+        : std::make_shared<const TopologyRemovalRenumbering>(nbTopoElements, index);
+
+    // Single pass over the subset: drop the entries of removed elements (keeping the list order)
+    // and follow the renumbering of the topology for the others.
+    // The entries without element in the map are kept as they are.
+    Index nbKept = 0;
+    Index nbMappedKept = 0;
+    for (Index id = 0; id < data.size(); ++id)
     {
-        if (data.size() == 0)
-            return;
-
-        // Check if this element is inside the subset map
-        auto dataIds = this->indicesOfElement(elemId);
-        //Need to delete in descendent order to guarantee that indices of elements to delete are kept constant after the deletion.
-        std::sort(dataIds.begin(),dataIds.end(),std::greater<>());
-        for(const Index & id : dataIds)
+        const Index elemId = elementOfIndex(id);
+        const bool isMapped = (elemId != sofa::InvalidID);
+        const Index newElemId = isMapped ? renumbering->getNewIndex(elemId) : sofa::InvalidID;
+        if (isMapped && newElemId == sofa::InvalidID)
         {
             // if in the map, apply callback if set
             if (this->p_onDestructionCallback)
             {
                 this->p_onDestructionCallback(id, data[id]);
             }
-
-            //Erase instead of swap to keep the list order
-            data.erase(data.begin() + id);
-            removePostProcess(id);
-        }
-
-        // Need to check if last element index is in the map. If yes need to replace that value to follow topological changes
-        if (lastTopoElemId == sofa::InvalidID)
             continue;
+        }
 
-        auto lastTopoId = this->indicesOfElement(lastTopoElemId);
-        for(const Index & id : lastTopoId)
+        if (nbKept != id)
         {
-            updateLastIndex(id, elemId);
+            data[nbKept] = data[id];
+            if (id < m_map2Elements.size())
+                m_map2Elements[nbKept] = m_map2Elements[id];
         }
-        lastTopoElemId--;
+
+        if (isMapped && newElemId != elemId)
+            updateLastIndex(nbKept, newElemId);
+
+        if (id < m_map2Elements.size())
+            ++nbMappedKept;
+        ++nbKept;
     }
+
+    data.resize(nbKept);
+    if (m_map2Elements.size() > nbMappedKept)
+        m_map2Elements.resize(nbMappedKept);
 }
 
 template <typename ElementType, typename VecT>
@@ -244,13 +259,6 @@ void TopologySubsetData <ElementType, VecT>::swapPostProcess(Index i1, Index i2)
 }
 
 
-template <typename ElementType, typename VecT>
-void TopologySubsetData <ElementType, VecT>::removePostProcess(sofa::Index elemId)
-{
-        m_map2Elements.erase(m_map2Elements.begin() + elemId);
-}
-
-
 template <typename ElementType, typename VecT>
 void TopologySubsetData<ElementType, VecT>::addPostProcess(sofa::Index dataLastId)
 {
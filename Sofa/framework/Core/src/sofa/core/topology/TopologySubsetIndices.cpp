@@ -60,6 +60,12 @@ const type::vector<Index> TopologySubsetIndices::indicesOfElement(Index index) c
     return returnVec;
 }
 
+Index TopologySubsetIndices::elementOfIndex(Index posId) const
+{
+    const container_type& data = m_value.getValue();
+    return (posId < data.size()) ? data[posId] : sofa::InvalidID;
+}
+
 void TopologySubsetIndices::createTopologyHandler(sofa::core::topology::BaseMeshTopology* _topology)
 {
     this->Inherit::createTopologyHandler(_topology);
@@ -79,13 +85,6 @@ void TopologySubsetIndices::swapPostProcess(Index i1, Index i2)
 }
 
 
-void TopologySubsetIndices::removePostProcess(sofa::Index elemId)
-{
-    // nothing to do here
-    SOFA_UNUSED(elemId);
-}
-
-
 void TopologySubsetIndices::addPostProcess(sofa::Index dataLastId)
 {
     this->m_lastElementIndex = dataLastId;
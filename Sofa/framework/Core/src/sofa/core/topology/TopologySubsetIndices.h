@@ -49,6 +49,8 @@ public:
 
     const type::vector<Index> indicesOfElement(Index index) const override;
 
+    Index elementOfIndex(Index posId) const override;
+
     void createTopologyHandler(sofa::core::topology::BaseMeshTopology* _topology) override;
 
     Index getLastElementIndex() const override;
@@ -57,8 +59,6 @@ public:
 protected:
     void swapPostProcess(Index i1, Index i2) override;
 
-    void removePostProcess(sofa::Index elemId) override;
-
     void addPostProcess(sofa::Index dataLastId) override;
 
     void updateLastIndex(Index posLastIndex, Index newGlobalId) override;
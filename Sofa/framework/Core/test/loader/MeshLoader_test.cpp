@@ -20,6 +20,10 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/core/loader/MeshLoader.h>
+#include <sofa/core/loader/LoaderCache.h>
+
+#include <filesystem>
+#include <fstream>
 
 #include <sofa/testing/BaseTest.h>
 using sofa::testing::BaseTest ;
@@ -101,4 +105,59 @@ TEST_F(MeshLoader_test, createSubElements)
 
 }
 
+/// Loader counting the number of times the file is actually read
+class CountingMeshLoader : public MeshLoader
+{
+public:
+    bool doLoad() override
+    {
+        ++nbReads;
+        auto positions = helper::getWriteOnlyAccessor(d_positions);
+        positions.push_back({1., 2., 3.});
+        positions.push_back({4., 5., 6.});
+        return true;
+    }
+
+    void doClearBuffers() override {}
+
+    unsigned int nbReads { 0 };
+};
+
+TEST(LoaderCache, sharedLoading)
+{
+    const std::string filename = (std::filesystem::temp_directory_path() / "LoaderCache_test.txt").string();
+    std::ofstream(filename) << "mesh";
+
+    LoaderCache& cache = LoaderCache::getInstance();
+    cache.setEnabled(true);
+
+    CountingMeshLoader first;
+    first.d_filename.setValue(filename);
+    EXPECT_TRUE(first.load());
+    EXPECT_EQ(first.nbReads, 1u);
+    EXPECT_EQ(cache.size(), 1u);
+
+    CountingMeshLoader second;
+    second.d_filename.setValue(filename);
+    EXPECT_TRUE(second.load());
+    EXPECT_EQ(second.nbReads, 0u);
+    ASSERT_EQ(second.d_positions.getValue().size(), 2u);
+
+    // the loaded values are shared until one of the loaders modifies them
+    EXPECT_EQ(&first.d_positions.getValue(), &second.d_positions.getValue());
+    helper::getWriteAccessor(second.d_positions)[0] = {0., 0., 0.};
+    EXPECT_EQ(first.d_positions.getValue()[0], type::Vec3(1., 2., 3.));
+
+    // different parameters: the file is read again
+    CountingMeshLoader flipped;
+    flipped.d_filename.setValue(filename);
+    flipped.d_flipNormals.setValue(true);
+    EXPECT_TRUE(flipped.load());
+    EXPECT_EQ(flipped.nbReads, 1u);
+
+    cache.setEnabled(false);
+    EXPECT_EQ(cache.size(), 0u);
+    std::filesystem::remove(filename);
+}
+
 }// namespace sofa
@@ -0,0 +1,156 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/core/topology/ElementColoring.h>
+#include <sofa/type/fixed_array.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+namespace sofa::core::topology
+{
+
+namespace
+{
+
+using Hexahedron = type::fixed_array<Index, 8>;
+
+/// Hexahedra of a regular grid of n x n x n cells
+type::vector<Hexahedron> makeGrid(Size n)
+{
+    const auto id = [n](Size i, Size j, Size k) { return static_cast<Index>(i + (n + 1) * (j + (n + 1) * k)); };
+
+    type::vector<Hexahedron> hexahedra;
+    for (Size k = 0; k < n; ++k)
+        for (Size j = 0; j < n; ++j)
+            for (Size i = 0; i < n; ++i)
+            {
+                hexahedra.push_back(Hexahedron(
+                    id(i, j, k), id(i + 1, j, k), id(i + 1, j + 1, k), id(i, j + 1, k),
+                    id(i, j, k + 1), id(i + 1, j, k + 1), id(i + 1, j + 1, k + 1), id(i, j + 1, k + 1)));
+            }
+    return hexahedra;
+}
+
+template<class VecElement>
+void checkColoring(const VecElement& elements, const ElementColoring& coloring)
+{
+    const auto& colors = coloring.getColors();
+    const auto& elementColors = coloring.getElementColors();
+    ASSERT_EQ(elementColors.size(), elements.size());
+
+    Size nbColoredElements = 0;
+    for (Index c = 0; c < colors.size(); ++c)
+    {
+        EXPECT_FALSE(colors[c].empty());
+        nbColoredElements += colors[c].size();
+
+        type::vector<bool> isVertexUsed;
+        for (const Index e : colors[c])
+        {
+            EXPECT_EQ(elementColors[e], c);
+            for (const Index v : elements[e])
+            {
+                if (v >= isVertexUsed.size())
+                {
+                    isVertexUsed.resize(v + 1, false);
+                }
+                EXPECT_FALSE(isVertexUsed[v]) << "vertex " << v << " shared by two elements of color " << c;
+                isVertexUsed[v] = true;
+            }
+        }
+    }
+    EXPECT_EQ(nbColoredElements, elements.size());
+}
+
+}
+
+TEST(ElementColoring_test, empty)
+{
+    ElementColoring coloring;
+    coloring.compute(type::vector<Hexahedron>());
+    EXPECT_EQ(coloring.getNbColors(), 0);
+    EXPECT_TRUE(coloring.getElementColors().empty());
+}
+
+TEST(ElementColoring_test, greedyGrid)
+{
+    const auto hexahedra = makeGrid(6);
+
+    ElementColoring coloring;
+    coloring.compute(hexahedra, ElementColoring::Strategy::Greedy);
+    checkColoring(hexahedra, coloring);
+
+    // the parity of the cell coordinates gives 8 colors, which is optimal
+    EXPECT_EQ(coloring.getNbColors(), 8);
+}
+
+TEST(ElementColoring_test, balancedGrid)
+{
+    const auto hexahedra = makeGrid(5);
+
+    ElementColoring greedy;
+    greedy.compute(hexahedra, ElementColoring::Strategy::Greedy);
+
+    ElementColoring balanced;
+    balanced.compute(hexahedra, ElementColoring::Strategy::Balanced);
+    checkColoring(hexahedra, balanced);
+
+    const auto colorSizes = [](const ElementColoring& coloring)
+    {
+        type::vector<Size> sizes;
+        for (const auto& color : coloring.getColors())
+        {
+            sizes.push_back(color.size());
+        }
+        return sizes;
+    };
+
+    const auto greedySizes = colorSizes(greedy);
+    const auto balancedSizes = colorSizes(balanced);
+    ASSERT_FALSE(balancedSizes.empty());
+
+    const auto [greedyMin, greedyMax] = std::minmax_element(greedySizes.begin(), greedySizes.end());
+    const auto [balancedMin, balancedMax] = std::minmax_element(balancedSizes.begin(), balancedSizes.end());
+    EXPECT_LE(*balancedMax - *balancedMin, *greedyMax - *greedyMin);
+}
+
+TEST(ElementColoring_test, shuffledElements)
+{
+    auto hexahedra = makeGrid(4);
+    std::shuffle(hexahedra.begin(), hexahedra.end(), std::mt19937(0));
+
+    for (const auto strategy : {ElementColoring::Strategy::Greedy, ElementColoring::Strategy::Balanced})
+    {
+        ElementColoring coloring;
+        coloring.compute(hexahedra, strategy);
+        checkColoring(hexahedra, coloring);
+    }
+}
+
+TEST(ElementColoring_test, update)
+{
+    ElementColoring coloring;
+    EXPECT_FALSE(coloring.update(nullptr, geometry::ElementType::HEXAHEDRON));
+}
+
+}
@@ -0,0 +1,174 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/core/topology/TopologyRemovalRenumbering.h>
+#include <sofa/core/topology/TopologyChange.h>
+#include <sofa/core/topology/TopologySubsetData.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace sofa::core::topology
+{
+
+namespace
+{
+
+using SubsetData = TopologySubsetData<BaseMeshTopology::Point, type::vector<Index> >;
+
+/// Reference: removal one by one, each removed element being replaced by the last one, as in the topology containers
+type::vector<Index> removeOneByOne(Size nbElements, type::vector<Index> removedIndices)
+{
+    std::sort(removedIndices.begin(), removedIndices.end(), std::greater<>());
+
+    type::vector<Index> elements(nbElements);
+    std::iota(elements.begin(), elements.end(), 0);
+    for (const Index elemId : removedIndices)
+    {
+        elements[elemId] = elements.back();
+        elements.pop_back();
+    }
+    return elements;
+}
+
+void checkAgainstOneByOne(Size nbElements, const type::vector<Index>& removedIndices)
+{
+    const type::vector<Index> expected = removeOneByOne(nbElements, removedIndices);
+    const TopologyRemovalRenumbering renumbering(nbElements, removedIndices);
+
+    ASSERT_EQ(expected.size(), renumbering.getNbRemainingElements());
+
+    type::vector<Index> elements(nbElements);
+    std::iota(elements.begin(), elements.end(), 0);
+    renumbering.apply(elements);
+    EXPECT_EQ(expected, elements);
+
+    for (Index newId = 0; newId < expected.size(); ++newId)
+    {
+        EXPECT_EQ(newId, renumbering.getNewIndex(expected[newId]));
+    }
+    for (const Index elemId : removedIndices)
+    {
+        EXPECT_TRUE(renumbering.isRemoved(elemId));
+        EXPECT_EQ(sofa::InvalidID, renumbering.getNewIndex(elemId));
+    }
+}
+
+}
+
+TEST(TopologyRemovalRenumbering_test, removeLast)
+{
+    const TopologyRemovalRenumbering renumbering(5, {4, 3});
+
+    EXPECT_EQ(3, renumbering.getNbRemainingElements());
+    EXPECT_TRUE(renumbering.getMoves().empty());
+    EXPECT_EQ(2, renumbering.getNewIndex(2));
+    EXPECT_EQ(sofa::InvalidID, renumbering.getNewIndex(4));
+}
+
+TEST(TopologyRemovalRenumbering_test, removeFirst)
+{
+    const TopologyRemovalRenumbering renumbering(4, {1, 0});
+
+    ASSERT_EQ(2, renumbering.getMoves().size());
+    EXPECT_EQ(TopologyRemovalRenumbering::Move(0, 2), renumbering.getMoves()[0]);
+    EXPECT_EQ(TopologyRemovalRenumbering::Move(1, 3), renumbering.getMoves()[1]);
+    EXPECT_EQ(0, renumbering.getNewIndex(2));
+    EXPECT_EQ(1, renumbering.getNewIndex(3));
+}
+
+TEST(TopologyRemovalRenumbering_test, ignoreDuplicatesAndOutOfBounds)
+{
+    const TopologyRemovalRenumbering renumbering(4, {7, 2, 2, 0});
+
+    EXPECT_EQ(2, renumbering.getNbRemainingElements());
+    EXPECT_EQ(7, renumbering.getNewIndex(7));
+    checkAgainstOneByOne(4, {2, 0});
+}
+
+TEST(TopologyRemovalRenumbering_test, randomRemovals)
+{
+    std::mt19937 generator(42);
+    for (Size nbElements : {1u, 2u, 10u, 1000u})
+    {
+        for (unsigned int trial = 0; trial < 20; ++trial)
+        {
+            type::vector<Index> elements(nbElements);
+            std::iota(elements.begin(), elements.end(), 0);
+            std::shuffle(elements.begin(), elements.end(), generator);
+
+            const auto nbRemoved = std::uniform_int_distribution<Size>(0, nbElements)(generator);
+            type::vector<Index> removedIndices;
+            removedIndices.assign(elements.begin(), elements.begin() + nbRemoved);
+            checkAgainstOneByOne(nbElements, removedIndices);
+        }
+    }
+}
+
+TEST(TopologyRemovalRenumbering_test, sharedByEvent)
+{
+    const PointsRemoved event({3, 1});
+
+    const auto renumbering = event.getRemovalRenumbering(5, event.getArray());
+    EXPECT_EQ(renumbering, event.getRemovalRenumbering(5, event.getArray()));
+    EXPECT_NE(renumbering, event.getRemovalRenumbering(4, event.getArray()));
+    EXPECT_EQ(1, renumbering->getNewIndex(4));
+}
+
+TEST(TopologyRemovalRenumbering_test, subsetDataFollowsRenumbering)
+{
+    SubsetData subset(SubsetData::InitData{});
+    subset.setDataSetArraySize(6);
+    subset.setValue({10, 11, 12, 13});
+    subset.setMap2Elements({0, 2, 5, 3});
+
+    type::vector<Index> destroyed;
+    subset.setDestructionCallback([&destroyed](Index, Index& value) { destroyed.push_back(value); });
+
+    // removing 2 then 0 moves the element 5 to 2 and the element 4 to 0
+    subset.remove({2, 0}, nullptr);
+
+    EXPECT_EQ(type::vector<Index>({10, 11}), destroyed);
+    EXPECT_EQ(type::vector<Index>({12, 13}), subset.getValue());
+    EXPECT_EQ(type::vector<Index>({2, 3}), subset.getMap2Elements());
+}
+
+TEST(TopologyRemovalRenumbering_test, subsetDataKeepsUnmappedEntries)
+{
+    SubsetData subset(SubsetData::InitData{});
+    subset.setDataSetArraySize(6);
+    subset.setValue({10, 11, 12, 13});
+    subset.setMap2Elements({1, 5});
+
+    type::vector<Index> destroyed;
+    subset.setDestructionCallback([&destroyed](Index, Index& value) { destroyed.push_back(value); });
+
+    // removing 1 moves the element 5 to 1, the last two entries have no element in the map
+    subset.remove({1}, nullptr);
+
+    EXPECT_EQ(type::vector<Index>({10}), destroyed);
+    EXPECT_EQ(type::vector<Index>({11, 12, 13}), subset.getValue());
+    EXPECT_EQ(type::vector<Index>({1}), subset.getMap2Elements());
+}
+
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/helper/config.h>
+#include <sofa/type/vector.h>
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+/// Read and write values in binary streams, in the native representation of the machine.
+/// Only meant for data written and read by the same build (e.g. the checkpoints of a simulation).
+namespace sofa::helper::io::binary
+{
+
+template<class T>
+void write(std::ostream& out, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written as raw memory");
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+void write(std::ostream& out, const sofa::type::vector<T>& values)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written as raw memory");
+    write(out, static_cast<std::uint64_t>(values.size()));
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+inline void write(std::ostream& out, const std::string& value)
+{
+    write(out, static_cast<std::uint64_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+/// Return false if the stream does not contain enough bytes
+template<class T>
+bool read(std::istream& in, T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read as raw memory");
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return in.good();
+}
+
+template<class T>
+bool read(std::istream& in, sofa::type::vector<T>& values)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read as raw memory");
+    std::uint64_t size = 0;
+    if (!read(in, size))
+    {
+        return false;
+    }
+    values.resize(size);
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T)));
+    return in.good() || (size == 0 && !in.bad());
+}
+
+inline bool read(std::istream& in, std::string& value)
+{
+    std::uint64_t size = 0;
+    if (!read(in, size))
+    {
+        return false;
+    }
+    value.resize(size);
+    in.read(value.data(), static_cast<std::streamsize>(size));
+    return !in.fail();
+}
+
+} // namespace sofa::helper::io::binary
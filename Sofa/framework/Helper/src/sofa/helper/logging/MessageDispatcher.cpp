@@ -50,6 +50,12 @@ using sofa::helper::logging::DefaultStyleMessageFormatter;
 using std::lock_guard ;
 using std::mutex;
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <thread>
+
 
 namespace sofa::helper::logging
 {
@@ -59,6 +65,8 @@ namespace sofa::helper::logging
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Threading issues...
 ///     a mutex is serializing the access to the message API.
+///     In asynchronous mode, the messages are pushed in a lock-free list by the emitting threads
+///     and processed by the handlers (under the mutex) in a background thread.
 /// Memory management:
 ///     object are passed to the message info.
 ///     some of them are duplicated
@@ -71,9 +79,23 @@ std::vector<MessageHandler*> getDefaultMessageHandlers(){
     return messageHandlers;
 }
 
+/// Message waiting in the asynchronous queue
+struct QueuedMessage
+{
+    Message m_message;
+    QueuedMessage* m_next { nullptr };
+};
+
 class MessageDispatcherImpl
 {
 public:
+    ~MessageDispatcherImpl()
+    {
+        // the handlers may already be destroyed: the remaining messages are dropped
+        stopConsumer();
+        deleteQueue(m_queue.exchange(nullptr));
+    }
+
     mutex m_mutex ;
     mutex& getMutex()
     {
@@ -114,6 +136,106 @@ public:
             m_messageHandlers[i]->process(m) ;
         }
     }
+
+    std::atomic<bool> m_asynchronous { false };
+
+    /// Lock-free list of the queued messages, the most recent first
+    std::atomic<QueuedMessage*> m_queue { nullptr };
+
+    /// Serializes the changes of mode
+    mutex m_modeMutex;
+
+    std::thread m_consumer;
+    mutex m_consumerMutex;
+    std::condition_variable m_consumerWakeUp;
+    bool m_stopConsumer { false };
+
+    /// Called by the emitting threads: a single compare-and-swap, no lock
+    void enqueue(const Message& m)
+    {
+        auto* node = new QueuedMessage{ m, nullptr };
+        QueuedMessage* head = m_queue.load(std::memory_order_relaxed);
+        do
+        {
+            node->m_next = head;
+        }
+        while (!m_queue.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+
+        // the consumer also wakes up periodically, a missed notification only delays the processing
+        if (head == nullptr)
+            m_consumerWakeUp.notify_one();
+    }
+
+    /// Process the queued messages in their emission order. Must be called with m_mutex locked.
+    void processQueue()
+    {
+        QueuedMessage* node = m_queue.exchange(nullptr, std::memory_order_acquire);
+        QueuedMessage* ordered = nullptr;
+        while (node)
+        {
+            QueuedMessage* next = node->m_next;
+            node->m_next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        while (ordered)
+        {
+            process(ordered->m_message);
+            QueuedMessage* next = ordered->m_next;
+            delete ordered;
+            ordered = next;
+        }
+    }
+
+    static void deleteQueue(QueuedMessage* node)
+    {
+        while (node)
+        {
+            QueuedMessage* next = node->m_next;
+            delete node;
+            node = next;
+        }
+    }
+
+    void consume()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<mutex> lock(m_consumerMutex);
+                m_consumerWakeUp.wait_for(lock, std::chrono::milliseconds(10), [this]()
+                {
+                    return m_stopConsumer || m_queue.load(std::memory_order_relaxed) != nullptr;
+                });
+                if (m_stopConsumer)
+                    return;
+            }
+
+            lock_guard<mutex> guard(m_mutex);
+            processQueue();
+        }
+    }
+
+    void startConsumer()
+    {
+        if (m_consumer.joinable())
+            return;
+        m_stopConsumer = false;
+        m_consumer = std::thread(&MessageDispatcherImpl::consume, this);
+    }
+
+    void stopConsumer()
+    {
+        if (!m_consumer.joinable())
+            return;
+        {
+            lock_guard<mutex> lock(m_consumerMutex);
+            m_stopConsumer = true;
+        }
+        m_consumerWakeUp.notify_one();
+        m_consumer.join();
+    }
 };
 
 MessageDispatcherImpl* getMainInstance(){
@@ -129,22 +251,62 @@ std::vector<MessageHandler*>& MessageDispatcher::getHandlers()
 
 int MessageDispatcher::addHandler(MessageHandler* o){
     PUBLIC_API_ENTRY_POINT_MUTEX ;
+    getMainInstance()->processQueue();
     return getMainInstance()->addHandler(o);
 }
 
 int MessageDispatcher::rmHandler(MessageHandler* o){
     PUBLIC_API_ENTRY_POINT_MUTEX ;
+    getMainInstance()->processQueue();
     return getMainInstance()->rmHandler(o);
 }
 
 void MessageDispatcher::clearHandlers(){
     PUBLIC_API_ENTRY_POINT_MUTEX ;
+    getMainInstance()->processQueue();
     getMainInstance()->clearHandlers();
 }
 
 void MessageDispatcher::process(sofa::helper::logging::Message& m){
+    MessageDispatcherImpl* dispatcher = getMainInstance();
+    if (dispatcher->m_asynchronous.load(std::memory_order_relaxed) && m.type() < Message::Error)
+    {
+        dispatcher->enqueue(m);
+        return;
+    }
+
+    PUBLIC_API_ENTRY_POINT_MUTEX ;
+    dispatcher->processQueue();
+    dispatcher->process(m);
+}
+
+void MessageDispatcher::setAsynchronous(bool value){
+    MessageDispatcherImpl* dispatcher = getMainInstance();
+    lock_guard<mutex> guard(dispatcher->m_modeMutex);
+    if (value)
+    {
+        // process the last messages before the destruction of the handlers registered until now
+        static const int s_flushAtExit = std::atexit([]() { MessageDispatcher::setAsynchronous(false); });
+        SOFA_UNUSED(s_flushAtExit);
+
+        dispatcher->startConsumer();
+        dispatcher->m_asynchronous = true;
+    }
+    else
+    {
+        dispatcher->m_asynchronous = false;
+        dispatcher->stopConsumer();
+        flush();
+    }
+}
+
+bool MessageDispatcher::isAsynchronous(){
+    return getMainInstance()->m_asynchronous.load(std::memory_order_relaxed);
+}
+
+void MessageDispatcher::flush(){
     PUBLIC_API_ENTRY_POINT_MUTEX ;
-    getMainInstance()->process(m);
+    getMainInstance()->processQueue();
 }
 
 
@@ -113,6 +113,17 @@ public:
         /// and can be called manually on a hand-made (possibly predefined) Message
         static void process(sofa::helper::logging::Message& m);
 
+        /// In asynchronous mode, the emitting thread only pushes the Message in a lock-free queue
+        /// and the handlers process it later in a background thread, so that logging from parallel
+        /// code does not serialize the threads on the dispatcher mutex.
+        /// Error and Fatal messages are still processed synchronously, after the queued ones, as
+        /// some handlers react to them (e.g. ExceptionMessageHandler).
+        static void setAsynchronous(bool value);
+        static bool isAsynchronous();
+
+        /// Process all the queued messages before returning.
+        static void flush();
+
     private:
 
         // static interface
@@ -0,0 +1,62 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/logging/MessageRateLimiter.h>
+#include <chrono>
+
+namespace sofa::helper::logging
+{
+
+namespace
+{
+long long nowInNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+MessageRateLimiter::MessageRateLimiter(unsigned int maxPerSecond)
+    : m_maxPerSecond(maxPerSecond)
+    , m_windowStart(nowInNanoseconds())
+{
+}
+
+bool MessageRateLimiter::allow()
+{
+    static constexpr long long windowDuration = 1000000000LL;
+
+    const long long now = nowInNanoseconds();
+    long long windowStart = m_windowStart.load(std::memory_order_relaxed);
+    if (now - windowStart >= windowDuration
+        && m_windowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed))
+    {
+        m_nbAllowed.store(0, std::memory_order_relaxed);
+    }
+
+    if (m_nbAllowed.fetch_add(1, std::memory_order_relaxed) < m_maxPerSecond)
+        return true;
+
+    m_nbAllowed.fetch_sub(1, std::memory_order_relaxed);
+    m_nbSuppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+} // namespace sofa::helper::logging
@@ -0,0 +1,53 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/helper/config.h>
+#include <atomic>
+
+
+namespace sofa::helper::logging
+{
+
+/// Limits the number of messages emitted by a call site per second.
+/// It is used by the msg_*_ratelimited macros, each call site owning its own limiter, to prevent
+/// a message emitted in hot code (per step, per element, per contact...) from flooding the log.
+/// allow() is lock-free so that the limiter can be shared by parallel threads.
+class SOFA_HELPER_API MessageRateLimiter
+{
+public:
+    explicit MessageRateLimiter(unsigned int maxPerSecond);
+
+    /// Return true if one more message can be emitted in the current one-second window
+    bool allow();
+
+    /// Number of messages refused since the creation of the limiter
+    unsigned long long getNbSuppressed() const { return m_nbSuppressed.load(std::memory_order_relaxed); }
+
+private:
+    const unsigned int m_maxPerSecond;
+    std::atomic<long long> m_windowStart; ///< start of the current window, in nanoseconds
+    std::atomic<unsigned int> m_nbAllowed { 0 };
+    std::atomic<unsigned long long> m_nbSuppressed { 0 };
+};
+
+} // namespace sofa::helper::logging
@@ -79,9 +79,21 @@
 #define MESSAGING_H
 
 #include <sofa/helper/logging/MessageDispatcher.h>
+#include <sofa/helper/logging/MessageRateLimiter.h>
 
 #define msgendl "  \n"
 
+/// Compile-time filtering: the info and advice messages of a type lower than SOFA_MSG_MIN_TYPE
+/// (a Message::Type value, e.g. 2 to remove both) are compiled out, their streamed expressions
+/// are never evaluated. Warnings, errors and fatal messages are always kept.
+#ifndef SOFA_MSG_MIN_TYPE
+#define SOFA_MSG_MIN_TYPE 0
+#endif
+#define SOFA_MSG_TYPE_ENABLED(type) (int(sofa::helper::logging::Message::type) >= SOFA_MSG_MIN_TYPE)
+
+/// Evaluates to true at most maxPerSecond times per second for a given call site
+#define SOFA_MSG_RATE_LIMIT(maxPerSecond) [&]() { static sofa::helper::logging::MessageRateLimiter s_msgRateLimiter(maxPerSecond); return s_msgRateLimiter.allow(); }()
+
 #define nmsg_info(emitter)       sofa::helper::logging::MessageDispatcher::null()
 #define nmsg_deprecated(emitter) sofa::helper::logging::MessageDispatcher::null()
 #define nmsg_advice(emitter) sofa::helper::logging::MessageDispatcher::null()
@@ -135,8 +147,8 @@
 #define TWO_FUNC_RECOMPOSER(argsWithParentheses) TWO_FUNC_CHOOSER argsWithParentheses
 
 /// THE INFO BEAST
-#define MSGINFO_1(x) if( sofa::helper::logging::notMuted(x) ) oldmsg_info(x)
-#define MSGINFO_0()  if( sofa::helper::logging::notMuted(this) ) oldmsg_info(this)
+#define MSGINFO_1(x) if( SOFA_MSG_TYPE_ENABLED(Info) && sofa::helper::logging::notMuted(x) ) oldmsg_info(x)
+#define MSGINFO_0()  if( SOFA_MSG_TYPE_ENABLED(Info) && sofa::helper::logging::notMuted(this) ) oldmsg_info(this)
 
 #define MSGINFO_CHOOSE_FROM_ARG_COUNT(...) TWO_FUNC_RECOMPOSER((__VA_ARGS__, MSGINFO_1, ))
 #define MSGINFO_NO_ARG_EXPANDER() ,MSGINFO_0
@@ -194,8 +206,8 @@
 
 
 /// THE ADVICE BEAST
-#define MSGADVICE_1(x) if( sofa::helper::logging::notMuted(x) ) oldmsg_advice(x)
-#define MSGADVICE_0()  if( sofa::helper::logging::notMuted(this) ) oldmsg_advice(this)
+#define MSGADVICE_1(x) if( SOFA_MSG_TYPE_ENABLED(Advice) && sofa::helper::logging::notMuted(x) ) oldmsg_advice(x)
+#define MSGADVICE_0()  if( SOFA_MSG_TYPE_ENABLED(Advice) && sofa::helper::logging::notMuted(this) ) oldmsg_advice(this)
 
 #define MSGADVICE_CHOOSE_FROM_ARG_COUNT(...) TWO_FUNC_RECOMPOSER((__VA_ARGS__, MSGADVICE_1, ))
 #define MSGADVICE_NO_ARG_EXPANDER() ,MSGADVICE_0
@@ -205,12 +217,22 @@
 #define msg_advice_when(cond, ...) if(cond) msg_advice(__VA_ARGS__)
 
 
+/// THE RATE-LIMITED BEASTS
+/// At most maxPerSecond messages per second are emitted by the call site, the others are dropped
+/// without evaluating the streamed expressions. To use in hot code, e.g. msg_warning_ratelimited(10) << ...
+#define msg_info_ratelimited(maxPerSecond, ...) if( SOFA_MSG_RATE_LIMIT(maxPerSecond) ) msg_info(__VA_ARGS__)
+#define msg_advice_ratelimited(maxPerSecond, ...) if( SOFA_MSG_RATE_LIMIT(maxPerSecond) ) msg_advice(__VA_ARGS__)
+#define msg_deprecated_ratelimited(maxPerSecond, ...) if( SOFA_MSG_RATE_LIMIT(maxPerSecond) ) msg_deprecated(__VA_ARGS__)
+#define msg_warning_ratelimited(maxPerSecond, ...) if( SOFA_MSG_RATE_LIMIT(maxPerSecond) ) msg_warning(__VA_ARGS__)
+#define msg_error_ratelimited(maxPerSecond, ...) if( SOFA_MSG_RATE_LIMIT(maxPerSecond) ) msg_error(__VA_ARGS__)
+
+
 ////////////////////////////////// DMSG
 /// THESE MACRO BEASTS ARE FOR AUTOMATIC DETECTION OF MACRO NO or ONE ARGUMENTS
 
 /// THE INFO BEAST
-#define DMSGINFO_1(x) if( sofa::helper::logging::notMuted(x) ) olddmsg_info(x)
-#define DMSGINFO_0()  if( sofa::helper::logging::notMuted(this) ) olddmsg_info(this)
+#define DMSGINFO_1(x) if( SOFA_MSG_TYPE_ENABLED(Info) && sofa::helper::logging::notMuted(x) ) olddmsg_info(x)
+#define DMSGINFO_0()  if( SOFA_MSG_TYPE_ENABLED(Info) && sofa::helper::logging::notMuted(this) ) olddmsg_info(this)
 
 #define DMSGINFO_CHOOSE_FROM_ARG_COUNT(...) TWO_FUNC_RECOMPOSER((__VA_ARGS__, DMSGINFO_1, ))
 #define DMSGINFO_NO_ARG_EXPANDER() ,DMSGINFO_0
@@ -268,8 +290,8 @@
 
 
 /// THE ADVICE BEAST
-#define DMSGADVICE_1(x) if( sofa::helper::logging::notMuted(x) ) olddmsg_advice(x)
-#define DMSGADVICE_0()  if( sofa::helper::logging::notMuted(this) ) olddmsg_advice(this)
+#define DMSGADVICE_1(x) if( SOFA_MSG_TYPE_ENABLED(Advice) && sofa::helper::logging::notMuted(x) ) olddmsg_advice(x)
+#define DMSGADVICE_0()  if( SOFA_MSG_TYPE_ENABLED(Advice) && sofa::helper::logging::notMuted(this) ) olddmsg_advice(this)
 
 #define DMSGADVICE_CHOOSE_FROM_ARG_COUNT(...) TWO_FUNC_RECOMPOSER((__VA_ARGS__, DMSGADVICE_1, ))
 #define DMSGADVICE_NO_ARG_EXPANDER() ,DMSGADVICE_0
@@ -189,6 +189,63 @@ TEST(LoggingTest, threadingTests)
 }
 
 
+TEST(LoggingTest, asynchronousMode)
+{
+    MessageDispatcher::clearHandlers() ;
+
+    MyMessageHandler h;
+    MessageDispatcher::addHandler(&h) ;
+
+    MessageDispatcher::setAsynchronous(true) ;
+    EXPECT_TRUE(MessageDispatcher::isAsynchronous()) ;
+
+    std::vector<std::thread> threads;
+    for(unsigned int t=0;t<4;t++)
+    {
+        threads.emplace_back([t]()
+        {
+            for(unsigned int i=0;i<1000;i++)
+                msg_warning("AsyncThread") << "thread " << t << " message " << i ;
+        });
+    }
+    for(auto& thread : threads)
+        thread.join() ;
+
+    MessageDispatcher::flush() ;
+    EXPECT_EQ( h.numMessages(), 4000u ) ;
+
+    // the errors are processed synchronously, after the queued messages
+    msg_info("") << "queued info" ;
+    msg_error("") << "synchronous error" ;
+    ASSERT_EQ( h.numMessages(), 4002u ) ;
+    EXPECT_EQ( h.messages()[4000].type(), Message::Info ) ;
+    EXPECT_EQ( h.messages()[4001].type(), Message::Error ) ;
+
+    MessageDispatcher::setAsynchronous(false) ;
+    EXPECT_FALSE(MessageDispatcher::isAsynchronous()) ;
+
+    msg_warning("") << "synchronous warning" ;
+    EXPECT_EQ( h.numMessages(), 4003u ) ;
+}
+
+TEST(LoggingTest, rateLimitedMessages)
+{
+    MessageDispatcher::clearHandlers() ;
+
+    MyMessageHandler h;
+    MessageDispatcher::addHandler(&h) ;
+
+    unsigned int nbEvaluations = 0;
+    for(unsigned int i=0;i<1000;i++)
+        msg_warning_ratelimited(10, "") << "flooding warning " << ++nbEvaluations ;
+
+    // a window may have started during the loop
+    EXPECT_GE( h.numMessages(), 10u ) ;
+    EXPECT_LE( h.numMessages(), 20u ) ;
+    // the dropped messages are not formatted
+    EXPECT_EQ( nbEvaluations, h.numMessages() ) ;
+}
+
 TEST(LoggingTest, withoutDevMode)
 {
     MessageDispatcher::clearHandlers() ;
@@ -0,0 +1,146 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/linearalgebra/config.h>
+#include <sofa/type/Mat.h>
+#include <sofa/type/vector.h>
+#include <algorithm>
+
+namespace sofa::linearalgebra::bsr
+{
+
+/**
+ * Kernels computing the product of a block compressed row matrix (BSR) with a vector.
+ *
+ * The matrix is given by its raw compressed arrays, as stored in CompressedRowSparseMatrixGeneric:
+ * rowIndex[xi] is the block row of the compressed row xi, its blocks are in the range
+ * [rowBegin[xi], rowBegin[xi+1]) of colsIndex (block column) and blocks (values).
+ * The blocks are fixed-size matrices, so that the inner loops are fully unrolled and
+ * vectorized by the compiler.
+ *
+ * The kernels work on a range of compressed rows, so that the product can be split
+ * among threads.
+ */
+
+/// res = M * x on the compressed rows [firstRow, lastRow).
+/// The scalar rows without any block are not written.
+template<sofa::Size NL, sofa::Size NC, class Real, class Index, class Real2>
+void multiplyRows(const Index* rowIndex, const Index* rowBegin, const Index* colsIndex,
+                  const type::Mat<NL, NC, Real>* blocks,
+                  const Real2* x, Real2* res, Index firstRow, Index lastRow)
+{
+    for (Index xi = firstRow; xi < lastRow; ++xi)
+    {
+        Real2 r[NL] {};
+        for (Index k = rowBegin[xi]; k < rowBegin[xi + 1]; ++k)
+        {
+            const type::Mat<NL, NC, Real>& b = blocks[k];
+            const Real2* xj = x + colsIndex[k] * NC;
+            for (sofa::Size bi = 0; bi < NL; ++bi)
+            {
+                for (sofa::Size bj = 0; bj < NC; ++bj)
+                {
+                    r[bi] += b(bi, bj) * xj[bj];
+                }
+            }
+        }
+
+        Real2* ri = res + rowIndex[xi] * NL;
+        for (sofa::Size bi = 0; bi < NL; ++bi)
+        {
+            ri[bi] = r[bi];
+        }
+    }
+}
+
+/// res += M_offdiag^T * x on the compressed rows [firstRow, lastRow).
+/// Used when only the upper triangular blocks of a symmetric matrix are stored: the product
+/// is then multiplyRows followed by this function.
+template<sofa::Size NL, sofa::Size NC, class Real, class Index, class Real2>
+void addMultiplyTransposedOffDiagonalRows(const Index* rowIndex, const Index* rowBegin, const Index* colsIndex,
+                                          const type::Mat<NL, NC, Real>* blocks,
+                                          const Real2* x, Real2* res, Index firstRow, Index lastRow)
+{
+    for (Index xi = firstRow; xi < lastRow; ++xi)
+    {
+        const Index row = rowIndex[xi];
+        const Real2* xi_ = x + row * NL;
+        for (Index k = rowBegin[xi]; k < rowBegin[xi + 1]; ++k)
+        {
+            const Index col = colsIndex[k];
+            if (col == row)
+            {
+                continue;
+            }
+
+            const type::Mat<NL, NC, Real>& b = blocks[k];
+            Real2* rj = res + col * NC;
+            for (sofa::Size bi = 0; bi < NL; ++bi)
+            {
+                for (sofa::Size bj = 0; bj < NC; ++bj)
+                {
+                    rj[bj] += b(bi, bj) * xi_[bi];
+                }
+            }
+        }
+    }
+}
+
+/// Split the nbRows compressed rows in nbParts contiguous ranges of similar cost.
+/// The cost of a row is its number of blocks, plus one for the row itself.
+/// The range p is [boundaries[p], boundaries[p+1]).
+template<class Index>
+void partitionRows(const Index* rowBegin, Index nbRows, std::size_t nbParts, sofa::type::vector<Index>& boundaries)
+{
+    nbParts = std::max<std::size_t>(nbParts, 1);
+    boundaries.resize(nbParts + 1);
+    boundaries.front() = 0;
+    boundaries.back() = nbRows;
+
+    // the cumulated cost up to the row i is rowBegin[i] - rowBegin[0] + i, which is increasing
+    const auto cost = [rowBegin](Index i) { return static_cast<std::size_t>(rowBegin[i] - rowBegin[0] + i); };
+    const std::size_t totalCost = cost(nbRows);
+
+    Index first = 0;
+    for (std::size_t p = 1; p < nbParts; ++p)
+    {
+        const std::size_t target = totalCost * p / nbParts;
+        Index count = nbRows - first;
+        while (count > 0)
+        {
+            const Index step = count / 2;
+            if (cost(first + step) < target)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        boundaries[p] = first;
+    }
+}
+
+} // namespace sofa::linearalgebra::bsr
@@ -27,6 +27,7 @@
 
 #include <sofa/linearalgebra/config.h>
 #include <sofa/linearalgebra/CompressedRowSparseMatrixGeneric.h>
+#include <sofa/linearalgebra/BlockSparseMatrixVectorProduct.h>
 #include <sofa/type/trait/is_vector.h>
 #include <sofa/helper/narrow_cast.h>
 
@@ -79,6 +80,9 @@ public:
     enum { NL = CRSMatrix::NL };  ///< Number of rows of a block
     enum { NC = CRSMatrix::NC };  ///< Number of columns of a block
 
+    /// True if the blocks are fixed-size matrices, for which block kernels are available (see BlockSparseMatrixVectorProduct.h)
+    static constexpr bool IsFixedSizeBlock = std::is_same_v<Block, type::Mat<NL, NC, Real> >;
+
     /// Size
     Index nRow,nCol;         ///< Mathematical size of the matrix, in scalars
     static_assert(!Policy::AutoSize,
@@ -1025,6 +1029,21 @@ protected:
 
         ((Matrix*)this)->compress();
         vresize(res, this->rowBSize(), this->rowSize());
+
+        if constexpr (IsFixedSizeBlock && std::is_same_v<V1, FullVector<Real2> > && std::is_same_v<V2, FullVector<Real2> >)
+        {
+            // contiguous vectors: use the block kernels
+            const Index nbRows = static_cast<Index>(this->rowIndex.size());
+            bsr::multiplyRows(this->rowIndex.data(), this->rowBegin.data(), this->colsIndex.data(), this->colsValue.data(),
+                              vec.ptr(), res.ptr(), Index(0), nbRows);
+            if constexpr (!Policy::StoreLowerTriangularBlock)
+            {
+                bsr::addMultiplyTransposedOffDiagonalRows(this->rowIndex.data(), this->rowBegin.data(), this->colsIndex.data(), this->colsValue.data(),
+                                                          vec.ptr(), res.ptr(), Index(0), nbRows);
+            }
+            return;
+        }
+
         for (Index xi = 0; xi < (Index)this->rowIndex.size(); ++xi)  // for each non-empty block row
         {
             type::Vec<NL, Real2> r;  // local block-sized vector to accumulate the product of the block row  with the large vector
@@ -1051,6 +1070,34 @@ protected:
             for (Index bi = 0; bi < NL; ++bi)
                 vset(res, this->rowIndex[xi], NL, bi, r[bi]);
         }
+
+        // only the upper triangular blocks are stored: add the product of the transposed off-diagonal blocks,
+        // once all the rows are set, as the block kernels do
+        if constexpr (!Policy::StoreLowerTriangularBlock)
+        {
+            for (Index xi = 0; xi < (Index)this->rowIndex.size(); ++xi)
+            {
+                type::Vec<NL, Real2> v;
+                for (Index bi = 0; bi < NL; ++bi)
+                    v[bi] = vget(vec, this->rowIndex[xi], NL, bi);
+
+                Range rowRange(this->rowBegin[xi], this->rowBegin[xi + 1]);
+                for (Index xj = rowRange.begin(); xj < rowRange.end(); ++xj)
+                {
+                    if (this->colsIndex[xj] == this->rowIndex[xi])
+                        continue;
+
+                    const Block& b = this->colsValue[xj];
+                    for (Index bj = 0; bj < NC; ++bj)
+                    {
+                        Real2 r = 0;
+                        for (Index bi = 0; bi < NL; ++bi)
+                            r += traits::v(b, bi, bj) * v[bi];
+                        vadd(res, this->colsIndex[xj], NC, bj, r);
+                    }
+                }
+            }
+        }
     }
 
 
@@ -381,3 +381,149 @@ TEST(CompressedRowSparseMatrixConstraint, emptyMatrixGetRowRange)
     checkIterator(begin);
     checkIterator(end);
 }
+
+/// Only the upper triangular blocks of the symmetric matrix are stored
+class CRSUpperSymmetricPolicy : public sofa::linearalgebra::CRSMechanicalPolicy
+{
+public:
+    static constexpr bool StoreLowerTriangularBlock = false;
+};
+
+/**
+ * A random symmetric matrix made of NxN blocks is built twice: with all its blocks, and with its
+ * upper triangular blocks only. The products with a vector, computed with the block kernels on
+ * a FullVector and with the generic path on a vector of blocks, are compared to the product
+ * computed scalar by scalar.
+ */
+template<sofa::Size N>
+void checkBlockProduct(long seed)
+{
+    using Block = sofa::type::Mat<N, N, SReal>;
+    using FullMatrix = sofa::linearalgebra::CompressedRowSparseMatrixMechanical<Block>;
+    using UpperMatrix = sofa::linearalgebra::CompressedRowSparseMatrixMechanical<Block, CRSUpperSymmetricPolicy>;
+    using Vector = sofa::linearalgebra::FullVector<SReal>;
+
+    constexpr sofa::SignedIndex nbBlocks = 50;
+    constexpr sofa::SignedIndex size = nbBlocks * static_cast<sofa::SignedIndex>(N);
+
+    FullMatrix full;
+    UpperMatrix upper;
+    full.resize(size, size);
+    upper.resize(size, size);
+
+    sofa::helper::RandomGenerator randomGenerator;
+    randomGenerator.initSeed(seed);
+
+    for (sofa::SignedIndex k = 0; k < 10 * size; ++k)
+    {
+        const auto value = static_cast<SReal>(sofa::helper::drand(1));
+        const auto i = static_cast<sofa::SignedIndex>(randomGenerator.random<sofa::Index>(0, size));
+        const auto j = static_cast<sofa::SignedIndex>(randomGenerator.random<sofa::Index>(0, size));
+
+        full.add(i, j, value);
+        if (i != j)
+        {
+            full.add(j, i, value);
+        }
+
+        const auto bi = i / static_cast<sofa::SignedIndex>(N);
+        const auto bj = j / static_cast<sofa::SignedIndex>(N);
+        if (bi == bj)
+        {
+            upper.add(i, j, value);
+            if (i != j)
+            {
+                upper.add(j, i, value);
+            }
+        }
+        else if (bi < bj)
+        {
+            upper.add(i, j, value);
+        }
+        else
+        {
+            upper.add(j, i, value);
+        }
+    }
+    full.compress();
+    upper.compress();
+
+    Vector x(size);
+    for (sofa::SignedIndex i = 0; i < size; ++i)
+    {
+        x[i] = static_cast<SReal>(sofa::helper::drand(1));
+    }
+
+    Vector expected;
+    expected.resize(size); // zero-initialized, unlike the sized constructor
+    for (sofa::SignedIndex i = 0; i < size; ++i)
+    {
+        for (sofa::SignedIndex j = 0; j < size; ++j)
+        {
+            expected[i] += full.element(i, j) * x[j];
+        }
+    }
+
+    Vector fullResult, upperResult;
+    full.mul(fullResult, x);
+    upper.mul(upperResult, x);
+
+    // the generic path is used for the vectors of blocks, such as the vectors of mechanical states
+    using BlockVector = sofa::type::vector<sofa::type::Vec<N, SReal> >;
+    BlockVector blockX(nbBlocks);
+    for (sofa::SignedIndex i = 0; i < size; ++i)
+    {
+        blockX[i / N][i % N] = x[i];
+    }
+    BlockVector fullGenericResult, upperGenericResult;
+    full.mul(fullGenericResult, blockX);
+    upper.mul(upperGenericResult, blockX);
+
+    ASSERT_EQ(fullResult.size(), size);
+    ASSERT_EQ(upperResult.size(), size);
+    ASSERT_EQ(fullGenericResult.size(), nbBlocks);
+    ASSERT_EQ(upperGenericResult.size(), nbBlocks);
+    for (sofa::SignedIndex i = 0; i < size; ++i)
+    {
+        EXPECT_NEAR(fullResult[i], expected[i], 1e-10) << "row " << i;
+        EXPECT_NEAR(upperResult[i], expected[i], 1e-10) << "row " << i;
+        EXPECT_NEAR(fullGenericResult[i / N][i % N], expected[i], 1e-10) << "row " << i;
+        EXPECT_NEAR(upperGenericResult[i / N][i % N], expected[i], 1e-10) << "row " << i;
+    }
+}
+
+TEST(CompressedRowSparseMatrix, blockProduct3x3)
+{
+    checkBlockProduct<3>(14);
+}
+
+TEST(CompressedRowSparseMatrix, blockProduct6x6)
+{
+    checkBlockProduct<6>(15);
+}
+
+TEST(CompressedRowSparseMatrix, partitionRows)
+{
+    sofa::linearalgebra::CompressedRowSparseMatrix<sofa::type::Mat<3, 3, SReal> > matrix;
+    generateMatrix(matrix, 300, 300, 0.05, 16);
+
+    const auto nbRows = static_cast<sofa::SignedIndex>(matrix.rowIndex.size());
+    sofa::type::vector<sofa::SignedIndex> boundaries;
+    sofa::linearalgebra::bsr::partitionRows(matrix.rowBegin.data(), nbRows, 4, boundaries);
+
+    ASSERT_EQ(boundaries.size(), 5);
+    EXPECT_EQ(boundaries.front(), 0);
+    EXPECT_EQ(boundaries.back(), nbRows);
+
+    const auto cost = [&](sofa::SignedIndex first, sofa::SignedIndex last)
+    {
+        return matrix.rowBegin[last] - matrix.rowBegin[first] + last - first;
+    };
+    const auto totalCost = cost(0, nbRows);
+    const auto maxRowCost = 1 + 300 / 3;
+    for (std::size_t p = 0; p < 4; ++p)
+    {
+        EXPECT_LE(boundaries[p], boundaries[p + 1]);
+        EXPECT_LE(std::abs(cost(boundaries[p], boundaries[p + 1]) - totalCost / 4), maxRowCost);
+    }
+}
@@ -0,0 +1,337 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/Checkpoint.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/core/objectmodel/BaseData.h>
+#include <sofa/defaulttype/AbstractTypeInfo.h>
+#include <sofa/helper/io/BinaryStream.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace sofa::simulation
+{
+
+namespace
+{
+
+constexpr std::string_view checkpointMagic { "SOFA_CHECKPOINT" };
+constexpr std::uint32_t checkpointVersion { 1 };
+
+/// Call f(base, object, path) for each node and component of the graph, only once for the nodes with several parents
+template<class F>
+void forEachComponent(Node* node, std::set<const Node*>& visitedNodes, F& f)
+{
+    if (!visitedNodes.insert(node).second)
+    {
+        return;
+    }
+
+    f(static_cast<core::objectmodel::Base*>(node), nullptr, "node:" + node->getPathName());
+    for (const auto& object : node->object)
+    {
+        f(static_cast<core::objectmodel::Base*>(object.get()), object.get(), "object:" + object->getPathName());
+    }
+    for (const auto& child : node->child)
+    {
+        forEachComponent(child.get(), visitedNodes, f);
+    }
+}
+
+template<class F>
+void forEachComponent(Node* root, F f)
+{
+    std::set<const Node*> visitedNodes;
+    forEachComponent(root, visitedNodes, f);
+}
+
+/// True if the value can be copied as raw memory: a sequence of integer or scalar values
+bool isRawCopyable(const defaulttype::AbstractTypeInfo* typeInfo)
+{
+    return typeInfo && typeInfo->ValidInfo() && typeInfo->SimpleLayout()
+        && (typeInfo->Integer() || typeInfo->Scalar())
+        && typeInfo->BaseType() && typeInfo->BaseType()->FixedSize();
+}
+
+}
+
+void Checkpoint::store(Node* root)
+{
+    m_components.clear();
+    if (!root)
+    {
+        return;
+    }
+
+    forEachComponent(root, [this](core::objectmodel::Base* base, const core::objectmodel::BaseObject* object, const std::string& path)
+    {
+        ComponentState& state = m_components.emplace_back();
+        state.path = path;
+
+        for (core::objectmodel::BaseData* data : base->getDataFields())
+        {
+            if (data->getParent())
+            {
+                continue;
+            }
+
+            DataValue& value = state.data.emplace_back();
+            value.name = data->getName();
+
+            // the value is shared with the Data of the graph until one of them is modified
+            value.value.reset(data->getNewInstance());
+            if (!value.value || !value.value->updateValueFromLink(data))
+            {
+                value.value.reset();
+                serialize(data, value);
+            }
+        }
+
+        if (object)
+        {
+            std::ostringstream out(std::ios::binary);
+            object->storeInternalState(out);
+            state.internalState = out.str();
+        }
+    });
+}
+
+bool Checkpoint::restore(Node* root) const
+{
+    if (!root)
+    {
+        return false;
+    }
+
+    std::map<std::string, const ComponentState*> states;
+    for (const auto& state : m_components)
+    {
+        states.emplace(state.path, &state);
+    }
+
+    std::size_t nbRestored = 0;
+    forEachComponent(root, [&states, &nbRestored](core::objectmodel::Base* base, core::objectmodel::BaseObject* object, const std::string& path)
+    {
+        const auto it = states.find(path);
+        if (it == states.end())
+        {
+            return;
+        }
+        ++nbRestored;
+
+        const ComponentState& state = *it->second;
+        bool isModified = false;
+        for (const auto& value : state.data)
+        {
+            core::objectmodel::BaseData* data = base->findData(value.name);
+            if (data && !data->getParent())
+            {
+                isModified = restoreData(data, value) || isModified;
+            }
+        }
+
+        if (object && (isModified || !state.internalState.empty()))
+        {
+            std::istringstream in(state.internalState, std::ios::binary);
+            object->restoreInternalState(in);
+        }
+    });
+
+    msg_warning_when(nbRestored != m_components.size(), "Checkpoint") << m_components.size() - nbRestored
+        << " nodes or components of the checkpoint have not been found in the graph";
+
+    return nbRestored == m_components.size();
+}
+
+bool Checkpoint::restoreData(core::objectmodel::BaseData* data, const DataValue& value)
+{
+    const defaulttype::AbstractTypeInfo* typeInfo = data->getValueTypeInfo();
+
+    if (value.value)
+    {
+        // still shared: not modified since the checkpoint
+        if (data->getValueVoidPtr() == value.value->getValueVoidPtr())
+        {
+            return false;
+        }
+        if (typeInfo && typeInfo->ValidInfo() && !typeInfo->Container()
+            && data->getValueString() == value.value->getValueString())
+        {
+            return false;
+        }
+        return data->updateValueFromLink(value.value.get());
+    }
+
+    if (!value.raw)
+    {
+        if (data->getValueString() == value.serialized)
+        {
+            return false;
+        }
+        return data->read(value.serialized);
+    }
+
+    if (!isRawCopyable(typeInfo) || value.serialized.size() != value.nbValues * typeInfo->byteSize())
+    {
+        msg_warning("Checkpoint") << "The type of the Data " << data->getName() << " does not match the checkpoint";
+        return false;
+    }
+
+    const void* current = data->getValueVoidPtr();
+    if (typeInfo->size(current) == value.nbValues
+        && (value.serialized.empty() || std::memcmp(typeInfo->getValuePtr(current), value.serialized.data(), value.serialized.size()) == 0))
+    {
+        return false;
+    }
+
+    void* ptr = data->beginEditVoidPtr();
+    typeInfo->setSize(ptr, static_cast<sofa::Size>(value.nbValues));
+    const bool isResized = typeInfo->size(ptr) == value.nbValues;
+    if (isResized && !value.serialized.empty())
+    {
+        std::memcpy(typeInfo->getValuePtr(ptr), value.serialized.data(), value.serialized.size());
+    }
+    data->endEditVoidPtr();
+
+    msg_warning_when(!isResized, "Checkpoint") << "The size of the Data " << data->getName() << " does not match the checkpoint";
+    return isResized;
+}
+
+void Checkpoint::serialize(const core::objectmodel::BaseData* data, DataValue& value)
+{
+    const defaulttype::AbstractTypeInfo* typeInfo = data->getValueTypeInfo();
+    value.raw = isRawCopyable(typeInfo);
+    if (value.raw)
+    {
+        const void* ptr = data->getValueVoidPtr();
+        value.nbValues = typeInfo->size(ptr);
+        const std::size_t nbBytes = value.nbValues * typeInfo->byteSize();
+        value.serialized.assign(nbBytes ? static_cast<const char*>(typeInfo->getValuePtr(ptr)) : "", nbBytes);
+    }
+    else
+    {
+        value.nbValues = 0;
+        value.serialized = data->getValueString();
+    }
+}
+
+bool Checkpoint::write(std::ostream& out) const
+{
+    using namespace sofa::helper::io;
+
+    out.write(checkpointMagic.data(), static_cast<std::streamsize>(checkpointMagic.size()));
+    binary::write(out, checkpointVersion);
+    binary::write(out, static_cast<std::uint64_t>(m_components.size()));
+
+    DataValue serialized;
+    for (const auto& state : m_components)
+    {
+        binary::write(out, state.path);
+        binary::write(out, static_cast<std::uint64_t>(state.data.size()));
+        for (const auto& value : state.data)
+        {
+            const DataValue* written = &value;
+            if (value.value)
+            {
+                serialize(value.value.get(), serialized);
+                written = &serialized;
+            }
+
+            binary::write(out, value.name);
+            binary::write(out, static_cast<std::uint8_t>(written->raw));
+            binary::write(out, written->nbValues);
+            binary::write(out, written->serialized);
+        }
+        binary::write(out, state.internalState);
+    }
+
+    return out.good();
+}
+
+bool Checkpoint::read(std::istream& in)
+{
+    using namespace sofa::helper::io;
+
+    m_components.clear();
+
+    std::string magic(checkpointMagic.size(), '\0');
+    in.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    std::uint32_t version = 0;
+    if (!in.good() || magic != checkpointMagic || !binary::read(in, version) || version != checkpointVersion)
+    {
+        msg_error("Checkpoint") << "The stream does not contain a checkpoint, or its version is not supported";
+        return false;
+    }
+
+    std::uint64_t nbComponents = 0;
+    bool success = binary::read(in, nbComponents);
+    for (std::uint64_t c = 0; success && c < nbComponents; ++c)
+    {
+        ComponentState& state = m_components.emplace_back();
+        std::uint64_t nbData = 0;
+        success = binary::read(in, state.path) && binary::read(in, nbData);
+        for (std::uint64_t d = 0; success && d < nbData; ++d)
+        {
+            DataValue& value = state.data.emplace_back();
+            std::uint8_t raw = 0;
+            success = binary::read(in, value.name) && binary::read(in, raw)
+                && binary::read(in, value.nbValues) && binary::read(in, value.serialized);
+            value.raw = raw != 0;
+        }
+        success = success && binary::read(in, state.internalState);
+    }
+
+    if (!success)
+    {
+        msg_error("Checkpoint") << "The checkpoint is truncated";
+        m_components.clear();
+    }
+    return success;
+}
+
+bool Checkpoint::write(const std::string& filename) const
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.good() || !write(out))
+    {
+        msg_error("Checkpoint") << "Cannot write the checkpoint in '" << filename << "'";
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::read(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.good())
+    {
+        msg_error("Checkpoint") << "Cannot read the checkpoint '" << filename << "'";
+        return false;
+    }
+    return read(in);
+}
+
+} // namespace sofa::simulation
@@ -0,0 +1,102 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/config.h>
+#include <sofa/simulation/fwd.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sofa::core::objectmodel
+{
+class Base;
+class BaseData;
+}
+
+namespace sofa::simulation
+{
+
+/**
+ * Snapshot of the state of a simulation graph: the values of the Data of all its nodes and
+ * components, and the internal state of the components (see BaseObject::storeInternalState).
+ *
+ * In memory, the values of the Data are shared with the graph (copy-on-write): storing a checkpoint
+ * does not duplicate the values, and restoring it only copies back the Data modified in between.
+ * Copies of a checkpoint share the same values, so that many simulations can branch from the same state.
+ *
+ * A checkpoint can also be written to, and read from, a binary stream or file. It can then be
+ * restored in a graph loaded from the same scene.
+ * The Data whose value comes from a parent Data are not stored: they are updated from their parent.
+ */
+class SOFA_SIMULATION_CORE_API Checkpoint
+{
+public:
+    /// Store the state of the graph under root
+    void store(Node* root);
+
+    /// Restore the state of the graph under root.
+    /// Return false if some of the nodes or components of the checkpoint are not found in the graph.
+    bool restore(Node* root) const;
+
+    bool empty() const { return m_components.empty(); }
+
+    bool write(std::ostream& out) const;
+    bool read(std::istream& in);
+
+    bool write(const std::string& filename) const;
+    bool read(const std::string& filename);
+
+private:
+    struct DataValue
+    {
+        std::string name;
+
+        /// Value shared with the Data of the graph, if the checkpoint has been stored from a graph
+        std::shared_ptr<core::objectmodel::BaseData> value;
+
+        /// Value read from a stream: raw memory of nbValues values if raw, text otherwise
+        bool raw { false };
+        std::uint64_t nbValues { 0 };
+        std::string serialized;
+    };
+
+    struct ComponentState
+    {
+        /// Identifier of the node or component in the graph
+        std::string path;
+        std::vector<DataValue> data;
+        std::string internalState;
+    };
+
+    /// Return true if the value of the Data has been modified
+    static bool restoreData(core::objectmodel::BaseData* data, const DataValue& value);
+
+    static void serialize(const core::objectmodel::BaseData* data, DataValue& value);
+
+    std::vector<ComponentState> m_components;
+};
+
+} // namespace sofa::simulation
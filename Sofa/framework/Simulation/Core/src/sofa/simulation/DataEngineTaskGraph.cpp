@@ -0,0 +1,302 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/DataEngineTaskGraph.h>
+
+#include <sofa/core/DataEngine.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace sofa::simulation
+{
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(const Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+using DDGNodeSet = std::unordered_set<core::objectmodel::DDGNode*>;
+
+/// The engine and all the nodes downstream of it: setting the outputs of the engine writes their dirty flags
+/// (DDGNode::setDirtyOutputs) and notifies them (DDGNode::notifyEndEdit)
+DDGNodeSet downstreamClosure(core::objectmodel::DDGNode* engine)
+{
+    DDGNodeSet closure { engine };
+    sofa::type::vector<core::objectmodel::DDGNode*> stack { engine };
+    while (!stack.empty())
+    {
+        core::objectmodel::DDGNode* node = stack.back();
+        stack.pop_back();
+        for (core::objectmodel::DDGNode* output : node->getOutputs())
+        {
+            if (closure.insert(output).second)
+            {
+                stack.push_back(output);
+            }
+        }
+    }
+    return closure;
+}
+
+bool intersects(const DDGNodeSet& a, const DDGNodeSet& b)
+{
+    const DDGNodeSet& smallest = a.size() < b.size() ? a : b;
+    const DDGNodeSet& largest = a.size() < b.size() ? b : a;
+    for (core::objectmodel::DDGNode* node : smallest)
+    {
+        if (largest.count(node))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+void DataEngineTaskGraph::clear()
+{
+    m_levels.clear();
+    m_batchIndices.clear();
+    m_nbBatches.clear();
+    m_timings.clear();
+}
+
+std::size_t DataEngineTaskGraph::getNbNodes() const
+{
+    std::size_t nbNodes = 0;
+    for (const auto& level : m_levels)
+    {
+        nbNodes += level.size();
+    }
+    return nbNodes;
+}
+
+void DataEngineTaskGraph::build(simulation::Node* root)
+{
+    sofa::type::vector<core::DataEngine*> engines;
+    if (root)
+    {
+        root->getTreeObjects<core::DataEngine>(&engines);
+    }
+
+    sofa::type::vector<core::objectmodel::DDGNode*> targets;
+    targets.reserve(engines.size());
+    for (core::DataEngine* engine : engines)
+    {
+        targets.push_back(engine);
+    }
+    build(targets);
+}
+
+void DataEngineTaskGraph::build(const sofa::type::vector<core::objectmodel::DDGNode*>& targets)
+{
+    clear();
+
+    // The level of a node is the length of the longest chain of dirty nodes leading to it:
+    // all the dirty inputs of a node belong to lower levels
+    static constexpr unsigned int InProgress = std::numeric_limits<unsigned int>::max();
+    std::unordered_map<core::objectmodel::DDGNode*, unsigned int> levels;
+
+    const std::function<unsigned int(core::objectmodel::DDGNode*)> visit =
+        [&](core::objectmodel::DDGNode* node) -> unsigned int
+    {
+        const auto [it, inserted] = levels.emplace(node, InProgress);
+        if (!inserted)
+        {
+            // a node being visited is part of a cycle, which is broken here
+            return it->second == InProgress ? 0 : it->second;
+        }
+
+        unsigned int level = 0;
+        for (core::objectmodel::DDGNode* input : node->getInputs())
+        {
+            if (input->isDirty())
+            {
+                level = std::max(level, visit(input) + 1);
+            }
+        }
+
+        levels[node] = level;
+        if (m_levels.size() <= level)
+        {
+            m_levels.resize(level + 1);
+        }
+        m_levels[level].push_back(node);
+        return level;
+    };
+
+    for (core::objectmodel::DDGNode* target : targets)
+    {
+        if (target && target->isDirty())
+        {
+            visit(target);
+        }
+    }
+
+    buildBatches();
+}
+
+void DataEngineTaskGraph::buildBatches()
+{
+    m_batchIndices.resize(m_levels.size());
+    m_nbBatches.assign(m_levels.size(), 0);
+
+    sofa::type::vector<std::size_t> concurrentNodes;
+    sofa::type::vector<DDGNodeSet> claimed;
+
+    for (std::size_t level = 0; level < m_levels.size(); ++level)
+    {
+        const auto& nodes = m_levels[level];
+        auto& batchIndices = m_batchIndices[level];
+        batchIndices.assign(nodes.size(), NoBatch);
+
+        concurrentNodes.clear();
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            const auto* engine = dynamic_cast<core::DataEngine*>(nodes[i]);
+            if (engine && engine->isThreadSafe())
+            {
+                concurrentNodes.push_back(i);
+            }
+        }
+
+        if (concurrentNodes.size() == 1)
+        {
+            batchIndices[concurrentNodes.front()] = 0;
+            m_nbBatches[level] = 1;
+            continue;
+        }
+
+        // Engines sharing downstream nodes would write the same dirty flags concurrently when setting
+        // their outputs: each engine goes in the first batch whose downstream nodes are disjoint from its own
+        claimed.clear();
+        for (const std::size_t i : concurrentNodes)
+        {
+            const DDGNodeSet closure = downstreamClosure(nodes[i]);
+            unsigned int batch = 0;
+            while (batch < claimed.size() && intersects(closure, claimed[batch]))
+            {
+                ++batch;
+            }
+            if (batch == claimed.size())
+            {
+                claimed.emplace_back();
+            }
+            claimed[batch].insert(closure.begin(), closure.end());
+            batchIndices[i] = batch;
+        }
+        m_nbBatches[level] = static_cast<unsigned int>(claimed.size());
+    }
+}
+
+void DataEngineTaskGraph::evaluate(TaskScheduler* taskScheduler)
+{
+    m_timings.clear();
+
+    sofa::type::vector<sofa::type::vector<core::DataEngine*> > batches;
+
+    for (unsigned int level = 0; level < m_levels.size(); ++level)
+    {
+        const auto& nodes = m_levels[level];
+        batches.resize(m_nbBatches[level]);
+        for (auto& batch : batches)
+        {
+            batch.clear();
+        }
+
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            core::objectmodel::DDGNode* node = nodes[i];
+            if (!node->isDirty())
+            {
+                continue; // already pulled by the update of another node
+            }
+
+            const unsigned int batchIndex = m_batchIndices[level][i];
+            if (taskScheduler && batchIndex != NoBatch)
+            {
+                batches[batchIndex].push_back(static_cast<core::DataEngine*>(node));
+                continue;
+            }
+
+            auto* engine = dynamic_cast<core::DataEngine*>(node);
+            const auto start = Clock::now();
+            node->update();
+            if (engine)
+            {
+                m_timings.push_back({engine, engine->getName(), level, false, millisecondsSince(start)});
+            }
+        }
+
+        for (const auto& batch : batches)
+        {
+            if (!batch.empty())
+            {
+                evaluateBatch(taskScheduler, batch, level);
+            }
+        }
+    }
+}
+
+void DataEngineTaskGraph::evaluateBatch(TaskScheduler* taskScheduler, const sofa::type::vector<core::DataEngine*>& engines, unsigned int level)
+{
+    // The bookkeeping of the dependency graph is done on this thread: the inputs of the
+    // engines are already up-to-date, so that the engines only read them concurrently
+    for (core::DataEngine* engine : engines)
+    {
+        engine->beginUpdate();
+    }
+
+    sofa::type::vector<double> durations(engines.size(), 0.);
+    const auto computeUpdate = [&engines, &durations](const std::size_t i)
+    {
+        const auto start = Clock::now();
+        engines[i]->computeUpdate();
+        durations[i] = millisecondsSince(start);
+    };
+
+    if (engines.size() == 1)
+    {
+        computeUpdate(0);
+    }
+    else
+    {
+        parallelForEach(*taskScheduler, std::size_t(0), engines.size(), computeUpdate);
+    }
+
+    for (std::size_t i = 0; i < engines.size(); ++i)
+    {
+        engines[i]->endUpdate();
+        m_timings.push_back({engines[i], engines[i]->getName(), level, engines.size() > 1, durations[i]});
+    }
+}
+
+} // namespace sofa::simulation
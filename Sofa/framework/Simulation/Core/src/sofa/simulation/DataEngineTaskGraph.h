@@ -0,0 +1,97 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/config.h>
+#include <sofa/core/fwd.h>
+#include <sofa/simulation/fwd.h>
+#include <sofa/type/vector.h>
+
+#include <limits>
+#include <string>
+
+namespace sofa::core::objectmodel
+{
+class DDGNode;
+}
+
+namespace sofa::simulation
+{
+
+class TaskScheduler;
+
+/**
+ * Snapshot of the dirty part of the data dependency graph, sorted in levels so that
+ * the engines of a level only depend on nodes of the previous levels.
+ *
+ * The evaluation updates the levels in order. Within a level, the engines declaring
+ * themselves thread-safe (core::DataEngine::isThreadSafe) compute their outputs
+ * concurrently on the task scheduler, by batches of engines without common downstream node:
+ * setting an output propagates the dirtiness to the downstream nodes, which must not be
+ * written by two threads. The batches are computed when the snapshot is built. The other
+ * nodes are updated on the calling thread, as a lazy evaluation would do.
+ */
+class SOFA_SIMULATION_CORE_API DataEngineTaskGraph
+{
+public:
+    struct EngineTiming
+    {
+        core::DataEngine* engine { nullptr };
+        std::string name;
+        unsigned int level { 0 };
+        bool concurrent { false }; ///< true if the engine was updated on the task scheduler
+        double milliseconds { 0 };
+    };
+
+    /// Snapshot the dirty nodes upstream of the given nodes (included)
+    void build(const sofa::type::vector<core::objectmodel::DDGNode*>& targets);
+
+    /// Snapshot the dirty nodes upstream of the engines of the given scene graph node and its descendants
+    void build(simulation::Node* root);
+
+    /// Update the snapshot level by level. Without task scheduler, all the nodes are updated on the calling thread.
+    void evaluate(TaskScheduler* taskScheduler);
+
+    void clear();
+
+    std::size_t getNbLevels() const { return m_levels.size(); }
+    std::size_t getNbNodes() const;
+
+    /// Duration of the update of each engine during the last evaluation
+    const sofa::type::vector<EngineTiming>& getTimings() const { return m_timings; }
+
+private:
+    static constexpr unsigned int NoBatch = std::numeric_limits<unsigned int>::max();
+
+    /// Split the thread-safe engines of each level in batches without common downstream node
+    void buildBatches();
+
+    /// Update engines without common downstream node, concurrently if there are several of them
+    void evaluateBatch(TaskScheduler* taskScheduler, const sofa::type::vector<core::DataEngine*>& engines, unsigned int level);
+
+    sofa::type::vector<sofa::type::vector<core::objectmodel::DDGNode*> > m_levels;
+    sofa::type::vector<sofa::type::vector<unsigned int> > m_batchIndices; ///< batch of each node of m_levels, NoBatch if updated on the calling thread
+    sofa::type::vector<unsigned int> m_nbBatches; ///< number of batches of each level
+    sofa::type::vector<EngineTiming> m_timings;
+};
+
+} // namespace sofa::simulation
@@ -41,6 +41,7 @@
 #include <sofa/simulation/CollisionBeginEvent.h>
 #include <sofa/simulation/CollisionEndEvent.h>
 #include <sofa/simulation/CollisionVisitor.h>
+#include <sofa/simulation/DataEngineTaskGraph.h>
 #include <sofa/simulation/IntegrateBeginEvent.h>
 #include <sofa/simulation/IntegrateEndEvent.h>
 #include <sofa/simulation/MainTaskSchedulerFactory.h>
@@ -69,6 +70,9 @@ This loop triggers the following steps:
 DefaultAnimationLoop::DefaultAnimationLoop(simulation::Node* _m_node)
     : Inherit()
     , d_parallelODESolving(initData(&d_parallelODESolving, false, "parallelODESolving", "If true, solves all the ODEs in parallel"))
+    , d_parallelEngineEvaluation(initData(&d_parallelEngineEvaluation, false, "parallelEngineEvaluation",
+        "If true, the dirty engines are evaluated at the beginning of the step, level by level of the data dependency graph. "
+        "The independent engines declared thread-safe are evaluated in parallel"))
 {
     SOFA_UNUSED(_m_node);
     this->addUpdateCallback("parallelODESolving", {&d_parallelODESolving},
@@ -77,24 +81,40 @@ DefaultAnimationLoop::DefaultAnimationLoop(simulation::Node* _m_node)
         SOFA_UNUSED(tracker);
         if (d_parallelODESolving.getValue())
         {
-            simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
-            assert(taskScheduler);
-
-            if (taskScheduler->getThreadCount() < 1)
-            {
-                taskScheduler->init(0);
-                msg_info() << "Task scheduler initialized on " << taskScheduler->getThreadCount() << " threads";
-            }
-            else
-            {
-                msg_info() << "Task scheduler already initialized on " << taskScheduler->getThreadCount() << " threads";
-            }
+            initTaskScheduler();
+        }
+        return d_componentState.getValue();
+    },
+{});
+    this->addUpdateCallback("parallelEngineEvaluation", {&d_parallelEngineEvaluation},
+    [this](const core::DataTracker& tracker) -> sofa::core::objectmodel::ComponentState
+    {
+        SOFA_UNUSED(tracker);
+        if (d_parallelEngineEvaluation.getValue())
+        {
+            initTaskScheduler();
         }
         return d_componentState.getValue();
     },
 {});
 }
 
+void DefaultAnimationLoop::initTaskScheduler()
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+        msg_info() << "Task scheduler initialized on " << taskScheduler->getThreadCount() << " threads";
+    }
+    else
+    {
+        msg_info() << "Task scheduler already initialized on " << taskScheduler->getThreadCount() << " threads";
+    }
+}
+
 DefaultAnimationLoop::~DefaultAnimationLoop() = default;
 
 void DefaultAnimationLoop::init()
@@ -122,6 +142,30 @@ void DefaultAnimationLoop::behaviorUpdatePosition(const core::ExecParams* params
     m_node->execute(beh);
 }
 
+void DefaultAnimationLoop::evaluateEngines() const
+{
+    if (!d_parallelEngineEvaluation.getValue())
+    {
+        return;
+    }
+
+    SCOPED_TIMER("EvaluateEngines");
+    DataEngineTaskGraph graph;
+    graph.build(m_node);
+    graph.evaluate(simulation::MainTaskSchedulerFactory::createInRegistry());
+
+    if (f_printLog.getValue() && !graph.getTimings().empty())
+    {
+        std::stringstream timings;
+        for (const auto& timing : graph.getTimings())
+        {
+            timings << "\n  [" << timing.level << "] " << timing.name << (timing.concurrent ? " (parallel)" : "")
+                    << ": " << timing.milliseconds << " ms";
+        }
+        msg_info() << graph.getNbNodes() << " dirty nodes evaluated in " << graph.getNbLevels() << " levels:" << timings.str();
+    }
+}
+
 void DefaultAnimationLoop::updateInternalData(const core::ExecParams* params) const
 {
     SCOPED_TIMER("UpdateInternalDataVisitor");
@@ -311,6 +355,7 @@ void DefaultAnimationLoop::step(const core::ExecParams* params, SReal dt)
 #endif
 
     propagateAnimateBeginEvent(params, dt);
+    evaluateEngines();
     animate(params, dt);
     updateSimulationContext(params, dt, m_node->getTime());
     propagateAnimateEndEvent(params, dt);
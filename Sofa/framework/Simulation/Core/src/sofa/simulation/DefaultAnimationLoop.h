@@ -55,6 +55,7 @@ protected:
 
 public:
     Data<bool> d_parallelODESolving; ///< If true, solves all the ODEs in parallel
+    Data<bool> d_parallelEngineEvaluation; ///< If true, the dirty engines are evaluated at the beginning of the step, the independent thread-safe engines in parallel
 
     void init() override;
 
@@ -86,7 +87,9 @@ protected :
     void updateMapping(const sofa::core::ExecParams* params, SReal dt) const;
     void computeBoundingBox(const sofa::core::ExecParams* params) const;
     void propagateAnimateBeginEvent(const sofa::core::ExecParams* params, SReal dt) const;
+    void evaluateEngines() const;
 
+    void initTaskScheduler();
 };
 
 } // namespace sofa::simulation
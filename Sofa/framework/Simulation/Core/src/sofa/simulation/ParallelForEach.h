@@ -26,6 +26,11 @@
 #include <sofa/simulation/CpuTaskStatus.h>
 #include <sofa/type/vector_T.h>
 
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+
 namespace sofa::simulation
 {
 
@@ -104,6 +109,72 @@ makeRangesForLoop(const InputIt first, const InputIt last, const unsigned int nb
     return ranges;
 }
 
+/**
+ * Function returning a list of ranges of a fixed number of elements from an iterable container.
+ * All the ranges contain chunkSize elements, except the last one which may contain less.
+ * The ranges only depend on the container, not on the number of threads.
+ */
+template<class InputIt>
+sofa::type::vector<Range<InputIt> >
+makeFixedSizeRangesForLoop(const InputIt first, const InputIt last, const unsigned int chunkSize)
+{
+    sofa::type::vector<Range<InputIt> > ranges;
+
+    unsigned int nbElements = 0;
+    if constexpr (std::is_integral_v<InputIt>)
+    {
+        nbElements = static_cast<unsigned int>(last - first);
+    }
+    else
+    {
+        nbElements = static_cast<unsigned int>(std::distance(first, last));
+    }
+
+    const unsigned int size = std::max(chunkSize, 1u);
+    ranges.reserve((nbElements + size - 1) / size);
+
+    Range<InputIt> r { first, first };
+    for (unsigned int i = 0; i < nbElements; i += size)
+    {
+        sofa::simulation::advance(r.end, std::min(size, nbElements - i));
+        ranges.emplace_back(r);
+        r.start = r.end;
+    }
+
+    return ranges;
+}
+
+/**
+ * Deterministic execution of the parallel algorithms (disabled by default).
+ * When it is enabled:
+ * - the reductions (parallelReduce, reduce) split the elements in ranges of fixed size, and
+ * combine the partial results in a fixed tree. The result does not depend on the number of threads.
+ * - the merges of parallelForEachRangeWithMerge are applied in the order of the ranges.
+ */
+SOFA_SIMULATION_CORE_API void setDeterministicExecution(bool deterministic);
+SOFA_SIMULATION_CORE_API bool isDeterministicExecution();
+
+/// Number of elements of the ranges of the reductions in deterministic execution
+inline constexpr unsigned int deterministicReductionRangeSize = 1024;
+
+/**
+ * Combines the values pairwise with the binary operation op: (v0 op v1) op (v2 op v3)...
+ * The order of the operations only depends on the number of values.
+ * The values are modified. They must not be empty.
+ */
+template<class T, class BinaryOperation>
+T pairwiseReduce(sofa::type::vector<T>& values, BinaryOperation op)
+{
+    for (std::size_t stride = 1; stride < values.size(); stride *= 2)
+    {
+        for (std::size_t i = 0; i + stride < values.size(); i += 2 * stride)
+        {
+            values[i] = op(values[i], values[i + stride]);
+        }
+    }
+    return values.front();
+}
+
 /**
  * Applies the given function object f to the result of dereferencing every iterator in the
  * range [first, last), in order.
@@ -195,6 +266,207 @@ UnaryFunction parallelForEach(TaskScheduler& taskScheduler, InputIt first, Input
     return f;
 }
 
+/**
+ * Applies the given function object f to the indices of a list of colors, color after color. The
+ * indices of a color are processed in parallel: the function must be safe to call concurrently on
+ * two indices of the same color, for instance elements sharing no vertex (@sa core::topology::ElementColoring).
+ * A color having less than minNbElementsParallel indices is processed in the calling thread.
+ *
+ * The signature of the function f should be equivalent to the following:
+ * void fun(Index i);
+ */
+template<class Colors, class UnaryFunction>
+UnaryFunction parallelForEachColor(TaskScheduler& taskScheduler, const Colors& colors, UnaryFunction f,
+                                   const std::size_t minNbElementsParallel = 256)
+{
+    for (const auto& color : colors)
+    {
+        if (color.size() >= minNbElementsParallel)
+        {
+            parallelForEach(taskScheduler, color.begin(), color.end(),
+                [&f](const auto i) { f(i); });
+        }
+        else
+        {
+            for (const auto i : color)
+            {
+                f(i);
+            }
+        }
+    }
+    return f;
+}
+
+/**
+ * Reduces the range [first, last): the function object f computes the result of a range, and the
+ * results are combined with the binary operation op, starting from init.
+ *
+ * The signature of the function f should be equivalent to the following:
+ * T fun(const Range<InputIt>& a);
+ *
+ * In deterministic execution, the elements are split in ranges of fixed size, in the same way as
+ * parallelReduce, so that the sequential and the parallel reductions give the same result.
+ */
+template<class InputIt, class T, class RangeFunction, class BinaryOperation>
+T reduce(InputIt first, InputIt last, T init, RangeFunction f, BinaryOperation op)
+{
+    if (first == last)
+    {
+        return init;
+    }
+
+    if (!isDeterministicExecution())
+    {
+        return op(init, f(Range<InputIt>{ first, last }));
+    }
+
+    const auto ranges = makeFixedSizeRangesForLoop<InputIt>(first, last, deterministicReductionRangeSize);
+    sofa::type::vector<T> results;
+    results.reserve(ranges.size());
+    for (const Range<InputIt>& r : ranges)
+    {
+        results.push_back(f(r));
+    }
+    return op(init, pairwiseReduce(results, op));
+}
+
+/**
+ * Reduces in parallel the range [first, last): the function object f computes the result of a
+ * range, and the results of the ranges are combined pairwise with the binary operation op,
+ * starting from init.
+ *
+ * The signature of the function f should be equivalent to the following:
+ * T fun(const Range<InputIt>& a);
+ *
+ * In deterministic execution, the ranges have a fixed size: the order of the operations, hence the
+ * rounding of floating-point sums, does not depend on the number of threads.
+ */
+template<class InputIt, class T, class RangeFunction, class BinaryOperation>
+T parallelReduce(TaskScheduler& taskScheduler, InputIt first, InputIt last, T init, RangeFunction f, BinaryOperation op)
+{
+    if (first == last)
+    {
+        return init;
+    }
+
+    const auto taskSchedulerThreadCount = taskScheduler.getThreadCount();
+    if (taskSchedulerThreadCount == 0)
+    {
+        msg_error("parallelReduce") << "Task scheduler does not appear to be initialized. Cannot perform parallel tasks.";
+        return reduce(first, last, init, f, op);
+    }
+
+    const auto ranges = isDeterministicExecution() ?
+        makeFixedSizeRangesForLoop<InputIt>(first, last, deterministicReductionRangeSize) :
+        makeRangesForLoop<InputIt>(first, last, taskSchedulerThreadCount);
+
+    sofa::type::vector<T> results(ranges.size(), init);
+
+    CpuTaskStatus status;
+    for (std::size_t i = 0; i < ranges.size(); ++i)
+    {
+        taskScheduler.addTask(status, [&ranges, &results, &f, i]()
+        {
+            results[i] = f(ranges[i]);
+        });
+    }
+    taskScheduler.workUntilDone(&status);
+
+    return op(init, pairwiseReduce(results, op));
+}
+
+/**
+ * Applies the given function object f to the Range [first, last), then merges its result with
+ * the function object merge.
+ *
+ * The signature of the functions should be equivalent to the following:
+ * R fun(const Range<InputIt>& a);
+ * void merge(const Range<InputIt>& a, R& result);
+ */
+template<class InputIt, class RangeFunction, class MergeFunction>
+void forEachRangeWithMerge(InputIt first, InputIt last, RangeFunction f, MergeFunction merge)
+{
+    const Range<InputIt> r{ first, last };
+    auto result = f(r);
+    merge(r, result);
+}
+
+/**
+ * Applies in parallel the given function object f to a list of ranges generated from [first, last),
+ * and merges the result of each range with the function object merge. The merges are never
+ * executed concurrently.
+ *
+ * The signature of the functions should be equivalent to the following:
+ * R fun(const Range<InputIt>& a);
+ * void merge(const Range<InputIt>& a, R& result);
+ *
+ * A result is merged as soon as it is available. In deterministic execution, the results are
+ * merged in the order of the ranges: if merge accumulates the contribution of each element
+ * separately (e.g. the force of each element in a force vector), the accumulation follows the
+ * order of the elements, whatever the number of threads.
+ */
+template<class InputIt, class RangeFunction, class MergeFunction>
+void parallelForEachRangeWithMerge(TaskScheduler& taskScheduler, InputIt first, InputIt last, RangeFunction f, MergeFunction merge)
+{
+    if (first == last)
+    {
+        return;
+    }
+
+    const auto taskSchedulerThreadCount = taskScheduler.getThreadCount();
+    if (taskSchedulerThreadCount == 0)
+    {
+        msg_error("parallelForEach") << "Task scheduler does not appear to be initialized. Cannot perform parallel tasks.";
+        forEachRangeWithMerge(first, last, f, merge);
+        return;
+    }
+
+    using Result = std::decay_t<std::invoke_result_t<RangeFunction&, const Range<InputIt>&> >;
+
+    const auto ranges = makeRangesForLoop<InputIt>(first, last, taskSchedulerThreadCount);
+    std::mutex mutex;
+    CpuTaskStatus status;
+
+    // in deterministic execution, the results which cannot be merged yet are kept until the
+    // results of the previous ranges are merged
+    std::vector<std::optional<Result> > results;
+    std::size_t nextToMerge = 0;
+
+    if (!isDeterministicExecution())
+    {
+        for (const Range<InputIt>& r : ranges)
+        {
+            taskScheduler.addTask(status, [&r, &f, &merge, &mutex]()
+            {
+                auto result = f(r);
+                std::lock_guard guard(mutex);
+                merge(r, result);
+            });
+        }
+    }
+    else
+    {
+        results.resize(ranges.size());
+
+        for (std::size_t i = 0; i < ranges.size(); ++i)
+        {
+            taskScheduler.addTask(status, [&ranges, &results, &nextToMerge, &f, &merge, &mutex, i]()
+            {
+                auto result = f(ranges[i]);
+                std::lock_guard guard(mutex);
+                results[i].emplace(std::move(result));
+                for (; nextToMerge < results.size() && results[nextToMerge].has_value(); ++nextToMerge)
+                {
+                    merge(ranges[nextToMerge], *results[nextToMerge]);
+                    results[nextToMerge].reset();
+                }
+            });
+        }
+    }
+
+    taskScheduler.workUntilDone(&status);
+}
+
 
 enum class ForEachExecutionPolicy : bool
 {
@@ -226,4 +498,27 @@ UnaryFunction forEach(const ForEachExecutionPolicy execution, TaskScheduler& tas
     return forEach(first, last, f);
 }
 
+template<class InputIt, class T, class RangeFunction, class BinaryOperation>
+T reduce(const ForEachExecutionPolicy execution, TaskScheduler& taskScheduler,
+         InputIt first, InputIt last, T init, RangeFunction f, BinaryOperation op)
+{
+    if (execution == ForEachExecutionPolicy::PARALLEL)
+    {
+        return parallelReduce(taskScheduler, first, last, init, f, op);
+    }
+    return reduce(first, last, init, f, op);
+}
+
+template<class InputIt, class RangeFunction, class MergeFunction>
+void forEachRangeWithMerge(const ForEachExecutionPolicy execution, TaskScheduler& taskScheduler,
+                           InputIt first, InputIt last, RangeFunction f, MergeFunction merge)
+{
+    if (execution == ForEachExecutionPolicy::PARALLEL)
+    {
+        parallelForEachRangeWithMerge(taskScheduler, first, last, f, merge);
+        return;
+    }
+    forEachRangeWithMerge(first, last, f, merge);
+}
+
 }
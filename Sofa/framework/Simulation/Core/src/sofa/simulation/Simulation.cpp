@@ -20,6 +20,7 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/Checkpoint.h>
 #include <sofa/simulation/PrintVisitor.h>
 #include <sofa/simulation/ExportGnuplotVisitor.h>
 #include <sofa/simulation/InitVisitor.h>
@@ -471,6 +472,18 @@ void unload(NodeSPtr root)
     root->execute<CleanupVisitor>(params);
     root->execute<DeleteVisitor>(params);
 }
+
+Checkpoint checkpoint(Node* root)
+{
+    Checkpoint checkpoint;
+    checkpoint.store(root);
+    return checkpoint;
+}
+
+bool restore(Node* root, const Checkpoint& checkpoint)
+{
+    return checkpoint.restore(root);
+}
 }
 
 Simulation::Simulation()
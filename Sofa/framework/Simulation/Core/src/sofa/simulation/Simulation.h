@@ -29,6 +29,7 @@ namespace sofa::simulation
 {
     class Node;
     typedef sofa::core::sptr<Node> NodeSPtr;
+    class Checkpoint;
 }
 
 namespace sofa::simulation
@@ -83,6 +84,10 @@ void SOFA_SIMULATION_CORE_API dumpState( Node* root, std::ofstream& out );
 NodeSPtr SOFA_SIMULATION_CORE_API load(const std::string& /* filename */, bool reload = false, const std::vector<std::string>& sceneArgs = std::vector<std::string>(0));
 /// Unload a scene from a Node.
 void SOFA_SIMULATION_CORE_API unload(NodeSPtr root);
+/// Store the state of the simulation (all the Data and the internal states of the components) in a checkpoint
+Checkpoint SOFA_SIMULATION_CORE_API checkpoint(Node* root);
+/// Restore the state of the simulation from a checkpoint. Return false if the graph does not match the checkpoint.
+bool SOFA_SIMULATION_CORE_API restore(Node* root, const Checkpoint& checkpoint);
 
 }
 
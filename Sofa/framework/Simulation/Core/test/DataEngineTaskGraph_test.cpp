@@ -0,0 +1,208 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/DataEngineTaskGraph.h>
+
+#include <sofa/core/DataEngine.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <sofa/testing/BaseTest.h>
+#include <gtest/gtest.h>
+
+namespace sofa
+{
+
+/// Computes the sum of its inputs, multiplied by a factor
+class SumEngine : public core::DataEngine
+{
+public:
+    SOFA_CLASS(SumEngine, core::DataEngine);
+
+    Data<int> a;
+    Data<int> b;
+    Data<int> factor;
+    Data<int> output;
+    bool threadSafe { true };
+    int nbUpdates { 0 };
+
+    SumEngine()
+        : a(initData(&a, 0, "a", "a"))
+        , b(initData(&b, 0, "b", "b"))
+        , factor(initData(&factor, 1, "factor", "factor"))
+        , output(initData(&output, 0, "output", "output"))
+    {
+        addInput(&a);
+        addInput(&b);
+        addInput(&factor);
+        addOutput(&output);
+    }
+
+    bool isThreadSafe() const override { return threadSafe; }
+
+    void doUpdate() override
+    {
+        ++nbUpdates;
+        output.setValue(factor.getValue() * (a.getValue() + b.getValue()));
+    }
+};
+
+struct DataEngineTaskGraph_test : public testing::BaseTest
+{
+    SumEngine::SPtr left = core::objectmodel::New<SumEngine>();
+    SumEngine::SPtr right = core::objectmodel::New<SumEngine>();
+    SumEngine::SPtr sum = core::objectmodel::New<SumEngine>();
+    simulation::DataEngineTaskGraph graph;
+
+    void SetUp() override
+    {
+        // left and right are independent, sum depends on both of them
+        left->a.setValue(1);
+        left->b.setValue(2);
+        right->a.setValue(3);
+        right->b.setValue(4);
+        right->factor.setValue(10);
+        sum->a.setParent(&left->output);
+        sum->b.setParent(&right->output);
+    }
+
+    void evaluate(simulation::TaskScheduler* taskScheduler)
+    {
+        graph.build({sum.get()});
+
+        EXPECT_EQ(graph.getNbLevels(), 4u); // engine, output, parented input, engine
+        ASSERT_EQ(graph.getNbNodes(), 7u);
+
+        graph.evaluate(taskScheduler);
+
+        EXPECT_FALSE(left->isDirty());
+        EXPECT_FALSE(right->isDirty());
+        EXPECT_FALSE(sum->isDirty());
+        EXPECT_EQ(left->nbUpdates, 1);
+        EXPECT_EQ(right->nbUpdates, 1);
+        EXPECT_EQ(sum->nbUpdates, 1);
+
+        EXPECT_EQ(sum->output.getValue(), 73);
+        EXPECT_EQ(sum->nbUpdates, 1); // reading the output does not trigger a new update
+
+        ASSERT_EQ(graph.getTimings().size(), 3u);
+        EXPECT_EQ(graph.getTimings().back().engine, sum.get());
+        EXPECT_EQ(graph.getTimings().back().level, 3u);
+    }
+};
+
+TEST_F(DataEngineTaskGraph_test, sequential)
+{
+    evaluate(nullptr);
+}
+
+TEST_F(DataEngineTaskGraph_test, parallel)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    ASSERT_NE(taskScheduler, nullptr);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+    evaluate(taskScheduler);
+}
+
+TEST_F(DataEngineTaskGraph_test, enginesWithACommonConsumerAreNotConcurrent)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    ASSERT_NE(taskScheduler, nullptr);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    // left and right both dirty sum when setting their outputs
+    evaluate(taskScheduler);
+
+    for (const auto& timing : graph.getTimings())
+    {
+        EXPECT_FALSE(timing.concurrent) << timing.engine->getName();
+    }
+}
+
+TEST_F(DataEngineTaskGraph_test, enginesWithDisjointConsumersAreConcurrent)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    ASSERT_NE(taskScheduler, nullptr);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    // left and right feed different engines
+    sum->b.setParent(nullptr);
+    const SumEngine::SPtr rightConsumer = core::objectmodel::New<SumEngine>();
+    rightConsumer->a.setParent(&right->output);
+
+    graph.build({sum.get(), rightConsumer.get()});
+    graph.evaluate(taskScheduler);
+
+    EXPECT_EQ(sum->output.getValue(), 3);
+    EXPECT_EQ(rightConsumer->output.getValue(), 70);
+    EXPECT_EQ(left->nbUpdates, 1);
+    EXPECT_EQ(right->nbUpdates, 1);
+
+    ASSERT_EQ(graph.getTimings().size(), 4u);
+    for (const auto& timing : graph.getTimings())
+    {
+        EXPECT_TRUE(timing.concurrent) << timing.engine->getName();
+    }
+}
+
+TEST_F(DataEngineTaskGraph_test, notThreadSafeEnginesAreUpdatedOnTheCallingThread)
+{
+    left->threadSafe = false;
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    ASSERT_NE(taskScheduler, nullptr);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+    evaluate(taskScheduler);
+
+    for (const auto& timing : graph.getTimings())
+    {
+        EXPECT_FALSE(timing.concurrent);
+    }
+}
+
+TEST_F(DataEngineTaskGraph_test, onlyDirtyNodesAreEvaluated)
+{
+    EXPECT_EQ(sum->output.getValue(), 73);
+
+    right->factor.setValue(100);
+
+    graph.build({sum.get()});
+    EXPECT_EQ(graph.getNbNodes(), 4u); // right, its output, sum input and sum
+
+    graph.evaluate(nullptr);
+    EXPECT_EQ(left->nbUpdates, 1);
+    EXPECT_EQ(right->nbUpdates, 2);
+    EXPECT_EQ(sum->output.getValue(), 703);
+}
+
+}
@@ -25,6 +25,8 @@
 #include <sofa/simulation/ParallelForEach.h>
 #include <sofa/testing/TestMessageHandler.h>
 
+#include <algorithm>
+#include <functional>
 #include <numeric>
 
 
@@ -248,4 +250,157 @@ TEST(ParallelForEachRange, integers)
     }
 }
 
+TEST(ParallelForEach, makeFixedSizeRangesForLoop)
+{
+    std::vector<int> integers = makeTestData(1000);
+
+    const auto ranges = simulation::makeFixedSizeRangesForLoop(integers.begin(), integers.end(), 64u);
+    EXPECT_EQ(ranges.size(), 16);
+
+    for (unsigned int i = 0; i < ranges.size() - 1; ++i)
+    {
+        EXPECT_EQ(std::distance(ranges[i].start, ranges[i].end), 64);
+    }
+    EXPECT_EQ(std::distance(ranges.back().start, ranges.back().end), 1000 - 15 * 64);
+    EXPECT_EQ(ranges.back().end, integers.end());
+}
+
+TEST(ParallelForEachColor, noConcurrentWrite)
+{
+    simulation::TaskScheduler* scheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    scheduler->init(0);
+
+    // element i writes on the values i and i + 1: consecutive elements conflict, hence 2 colors
+    constexpr std::size_t nbElements = 2000;
+    std::vector<std::vector<std::size_t> > colors(2);
+    for (std::size_t i = 0; i < nbElements; ++i)
+    {
+        colors[i % 2].push_back(i);
+    }
+    colors.push_back({}); // empty colors are allowed
+
+    std::vector<int> values(nbElements + 1, 0);
+    std::vector<int> visits(nbElements, 0);
+    simulation::parallelForEachColor(*scheduler, colors, [&values, &visits](const std::size_t i)
+    {
+        ++values[i];
+        ++values[i + 1];
+        ++visits[i];
+    });
+
+    for (std::size_t i = 0; i < nbElements; ++i)
+    {
+        EXPECT_EQ(visits[i], 1);
+    }
+    EXPECT_EQ(values.front(), 1);
+    EXPECT_EQ(values.back(), 1);
+    for (std::size_t i = 1; i < nbElements; ++i)
+    {
+        EXPECT_EQ(values[i], 2);
+    }
+}
+
+double sumOfInverses(simulation::TaskScheduler& scheduler, const std::size_t nbElements)
+{
+    return simulation::parallelReduce(scheduler, static_cast<std::size_t>(0), nbElements, 0.,
+        [](const auto& range)
+        {
+            double sum = 0.;
+            for (auto i = range.start; i != range.end; ++i)
+            {
+                sum += 1. / static_cast<double>(i + 1);
+            }
+            return sum;
+        },
+        std::plus<double>());
+}
+
+TEST(ParallelReduce, sum)
+{
+    simulation::TaskScheduler* scheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    scheduler->init(0);
+
+    std::vector<int> integers = makeTestData();
+    const int sum = simulation::parallelReduce(*scheduler, integers.begin(), integers.end(), 10,
+        [](const auto& range) { return std::accumulate(range.start, range.end, 0); },
+        std::plus<int>());
+
+    EXPECT_EQ(sum, 10 + 1023 * 1024 / 2);
+}
+
+TEST(ParallelReduce, deterministicExecution)
+{
+    simulation::setDeterministicExecution(true);
+
+    constexpr std::size_t nbElements = 100000;
+    simulation::TaskScheduler* scheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+
+    scheduler->init(1);
+    const double reference = sumOfInverses(*scheduler, nbElements);
+
+    for (const unsigned int nbThreads : {2u, 3u, 5u, 8u})
+    {
+        scheduler->init(nbThreads);
+        EXPECT_EQ(sumOfInverses(*scheduler, nbElements), reference) << nbThreads << " threads";
+    }
+
+    // the sequential reduction gives the same result as the parallel one
+    const double sequential = simulation::reduce(static_cast<std::size_t>(0), nbElements, 0.,
+        [](const auto& range)
+        {
+            double sum = 0.;
+            for (auto i = range.start; i != range.end; ++i)
+            {
+                sum += 1. / static_cast<double>(i + 1);
+            }
+            return sum;
+        },
+        std::plus<double>());
+    EXPECT_EQ(sequential, reference);
+
+    simulation::setDeterministicExecution(false);
+    scheduler->init(0);
+}
+
+TEST(ParallelForEachRangeWithMerge, deterministicExecution)
+{
+    simulation::setDeterministicExecution(true);
+
+    simulation::TaskScheduler* scheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    scheduler->init(4);
+
+    std::vector<std::size_t> mergeOrder;
+    simulation::parallelForEachRangeWithMerge(*scheduler, static_cast<std::size_t>(0), static_cast<std::size_t>(1000),
+        [](const auto& range)
+        {
+            return std::vector<std::size_t>(range.end - range.start, range.start);
+        },
+        [&mergeOrder](const auto& range, std::vector<std::size_t>& result)
+        {
+            EXPECT_EQ(result.size(), range.end - range.start);
+            mergeOrder.push_back(range.start);
+        });
+
+    ASSERT_FALSE(mergeOrder.empty());
+    EXPECT_TRUE(std::is_sorted(mergeOrder.begin(), mergeOrder.end()));
+    EXPECT_EQ(mergeOrder.front(), 0);
+
+    simulation::setDeterministicExecution(false);
+    scheduler->init(0);
+}
+
+TEST(ParallelForEachRangeWithMerge, sum)
+{
+    simulation::TaskScheduler* scheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    scheduler->init(0);
+
+    std::vector<int> integers = makeTestData();
+    int sum = 0;
+    simulation::parallelForEachRangeWithMerge(*scheduler, integers.begin(), integers.end(),
+        [](const auto& range) { return std::accumulate(range.start, range.end, 0); },
+        [&sum](const auto&, const int rangeSum) { sum += rangeSum; });
+
+    EXPECT_EQ(sum, 1023 * 1024 / 2);
+}
+
 }
@@ -0,0 +1,151 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <sofa/defaulttype/VecTypes.h>
+using sofa::defaulttype::Vec3Types;
+
+#include <sofa/component/statecontainer/MechanicalObject.h>
+typedef sofa::component::statecontainer::MechanicalObject<Vec3Types> MechanicalObject3;
+
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/helper/io/BinaryStream.h>
+#include <sofa/simulation/Checkpoint.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+#include <sofa/simulation/Node.h>
+
+#include <sstream>
+
+namespace sofa
+{
+
+/// Component with a member which is not a Data
+class InternalStateObject : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(InternalStateObject, core::objectmodel::BaseObject);
+
+    void storeInternalState(std::ostream& out) const override
+    {
+        helper::io::binary::write(out, m_counter);
+    }
+
+    void restoreInternalState(std::istream& in) override
+    {
+        helper::io::binary::read(in, m_counter);
+    }
+
+    int m_counter { 0 };
+};
+
+struct Checkpoint_test : public BaseTest
+{
+    simulation::Node::SPtr m_root;
+    MechanicalObject3::SPtr m_state;
+    InternalStateObject::SPtr m_object;
+
+    void onSetUp() override
+    {
+        m_root = simulation::getSimulation()->createNewGraph("root");
+        const simulation::Node::SPtr child = m_root->createChild("child");
+
+        m_state = core::objectmodel::New<MechanicalObject3>();
+        m_state->resize(2);
+        {
+            auto x = helper::getWriteAccessor(m_state->x);
+            x[0] = { 1, 2, 3 };
+            x[1] = { 4, 5, 6 };
+        }
+        child->addObject(m_state);
+
+        m_object = core::objectmodel::New<InternalStateObject>();
+        m_object->m_counter = 7;
+        child->addObject(m_object);
+
+        m_root->setTime(1.5);
+    }
+
+    void onTearDown() override
+    {
+        simulation::node::unload(m_root);
+    }
+
+    void modify()
+    {
+        m_root->setTime(3.0);
+        m_object->m_counter = 12;
+        m_state->resize(3);
+        auto x = helper::getWriteAccessor(m_state->x);
+        x[0] = { -1, -1, -1 };
+    }
+
+    void checkRestored()
+    {
+        EXPECT_DOUBLE_EQ(m_root->getTime(), 1.5);
+        EXPECT_EQ(m_object->m_counter, 7);
+
+        const auto& x = m_state->x.getValue();
+        ASSERT_EQ(x.size(), 2u);
+        EXPECT_EQ(x[0], Vec3Types::Coord(1, 2, 3));
+        EXPECT_EQ(x[1], Vec3Types::Coord(4, 5, 6));
+    }
+};
+
+TEST_F(Checkpoint_test, restoreInMemory)
+{
+    const simulation::Checkpoint checkpoint = simulation::node::checkpoint(m_root.get());
+    ASSERT_FALSE(checkpoint.empty());
+
+    modify();
+
+    ASSERT_TRUE(simulation::node::restore(m_root.get(), checkpoint));
+    checkRestored();
+}
+
+TEST_F(Checkpoint_test, restoreFromStream)
+{
+    std::stringstream buffer;
+    {
+        const simulation::Checkpoint checkpoint = simulation::node::checkpoint(m_root.get());
+        ASSERT_TRUE(checkpoint.write(buffer));
+    }
+
+    modify();
+
+    simulation::Checkpoint checkpoint;
+    ASSERT_TRUE(checkpoint.read(buffer));
+    ASSERT_TRUE(simulation::node::restore(m_root.get(), checkpoint));
+    checkRestored();
+}
+
+TEST_F(Checkpoint_test, readInvalidStream)
+{
+    std::stringstream buffer("not a checkpoint");
+    simulation::Checkpoint checkpoint;
+    EXPECT_MSG_EMIT(Error);
+    EXPECT_FALSE(checkpoint.read(buffer));
+    EXPECT_TRUE(checkpoint.empty());
+}
+
+}
@@ -0,0 +1,299 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <ArticulatedSystemPlugin/init.h>
+#include <ArticulatedSystemPlugin/ArticulatedBodyConstraintCorrection.h>
+#include <sofa/component/linearsolver/iterative/ShewchukPCGLinearSolver.h>
+#include <sofa/component/linearsolver/iterative/GraphScatteredTypes.h>
+#include <sofa/core/ConstraintParams.h>
+#include <sofa/core/behavior/BaseMass.h>
+#include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/linearalgebra/FullMatrix.h>
+#include <sofa/simulation/Node.h>
+
+#include <Eigen/Dense>
+
+namespace
+{
+
+using namespace sofa;
+using ShewchukPCGLinearSolver = component::linearsolver::iterative::ShewchukPCGLinearSolver<
+    component::linearsolver::GraphScatteredMatrix, component::linearsolver::GraphScatteredVector>;
+using ArticulatedBodyConstraintCorrection = component::constraint::lagrangian::correction::ArticulatedBodyConstraintCorrection;
+using Mapping = component::linearsolver::ArticulatedBodyAlgorithm::Mapping;
+using Articulations = core::behavior::MechanicalState<defaulttype::Vec1Types>;
+
+/** One implicit step of a chain of four rigid bodies articulated around the z axis, the first one being the
+fixed base of the chain */
+struct ArticulatedBodySolver_test : public BaseSimulationTest
+{
+    static constexpr unsigned int maxNbIterations = 1000;
+
+    void onSetUp() override
+    {
+        articulatedsystem::initArticulatedSystemPlugin();
+    }
+
+    static std::string chainScene(const std::string& linearSolver, const bool springs)
+    {
+        return R"(
+<Node name="root" dt="0.01" gravity="0 -9.81 0">
+    <RequiredPlugin name="Sofa.Component.Constraint.Projective"/>
+    <RequiredPlugin name="Sofa.Component.LinearSolver.Iterative"/>
+    <RequiredPlugin name="Sofa.Component.Mass"/>
+    <RequiredPlugin name="Sofa.Component.ODESolver.Backward"/>
+    <RequiredPlugin name="Sofa.Component.SolidMechanics.Spring"/>
+    <RequiredPlugin name="Sofa.Component.StateContainer"/>
+    <DefaultAnimationLoop/>
+    <Node name="Chain">
+        <EulerImplicitSolver name="odesolver" rayleighStiffness="0" rayleighMass="0"/>
+        )" + linearSolver + R"(
+        <Node name="restarticulation">
+            <MechanicalObject name="rest" template="Vec1d" position="0 0 0 0"/>
+            <FixedProjectiveConstraint indices="0 1 2 3"/>
+        </Node>
+        <Node name="articulation">
+            <MechanicalObject name="articulations" template="Vec1d" position="0.1 -0.2 0.3 0"/>
+            <ArticulatedBodyConstraintCorrection/>
+            <Node name="bodies">
+                <MechanicalObject template="Rigid3d" name="DOFs" position="0 0 0  0 0 0 1  1 0 0  0 0 0 1  3 0 0  0 0 0 1  5 0 0  0 0 0 1  7 0 0  0 0 0 1"/>
+                <UniformMass template="Rigid3d" vertexMass="0.1 0.1 [1 0 0,0 1 0,0 0 1]"/>
+                <ArticulatedSystemMapping input1="@../articulations" output="@DOFs"/>
+            </Node>
+            <ArticulatedHierarchyContainer/>
+            <Node name="articulationCenters">
+                <Node name="articulationCenter1">
+                    <ArticulationCenter parentIndex="0" childIndex="1" posOnParent="0 0 0" posOnChild="-1 0 0" articulationProcess="2"/>
+                    <Node name="articulations">
+                        <Articulation translation="0" rotation="1" rotationAxis="0 0 1" articulationIndex="0"/>
+                    </Node>
+                </Node>
+                <Node name="articulationCenter2">
+                    <ArticulationCenter parentIndex="1" childIndex="2" posOnParent="1 0 0" posOnChild="-1 0 0" articulationProcess="2"/>
+                    <Node name="articulations">
+                        <Articulation translation="0" rotation="1" rotationAxis="0 0 1" articulationIndex="1"/>
+                    </Node>
+                </Node>
+                <Node name="articulationCenter3">
+                    <ArticulationCenter parentIndex="2" childIndex="3" posOnParent="1 0 0" posOnChild="-1 0 0" articulationProcess="0"/>
+                    <Node name="articulations">
+                        <Articulation translation="0" rotation="1" rotationAxis="0 0 1" articulationIndex="2"/>
+                    </Node>
+                </Node>
+                <Node name="articulationCenter4">
+                    <ArticulationCenter parentIndex="3" childIndex="4" posOnParent="1 0 0" posOnChild="-1 0 0" articulationProcess="1"/>
+                    <Node name="articulations">
+                        <Articulation translation="0" rotation="1" rotationAxis="0 0 1" articulationIndex="3"/>
+                    </Node>
+                </Node>
+            </Node>
+        </Node>
+        )" + (springs ? R"(<StiffSpringForceField object1="@articulation" object2="@restarticulation" spring="0 0 10.0 1.0 0.0  1 1 10.0 1.0 0.0  2 2 10.0 1.0 0.0  3 3 10.0 1.0 0.0"/>)" : "") + R"(
+    </Node>
+</Node>)";
+    }
+
+    static std::string conjugateGradient()
+    {
+        return R"(<CGLinearSolver name="linearsolver" iterations=")" + std::to_string(maxNbIterations) + R"(" tolerance="1e-20" threshold="1e-30"/>)";
+    }
+
+    static std::string preconditionedConjugateGradient(const bool articulatedBody)
+    {
+        return R"(<ShewchukPCGLinearSolver name="linearsolver" iterations=")" + std::to_string(maxNbIterations) + R"(" tolerance="1e-20")"
+            + (articulatedBody ? R"( preconditioner="@articulatedBody"/><ArticulatedBodySolver name="articulatedBody"/>)" : "/>");
+    }
+
+    /// The mechanical state of the articulations of the chain (the rest articulations have the same type)
+    static Articulations* getArticulations(const simulation::Node::SPtr& root)
+    {
+        const simulation::Node* chain = root->getChild("Chain");
+        const simulation::Node* articulation = chain ? chain->getChild("articulation") : nullptr;
+        return articulation ? dynamic_cast<Articulations*>(articulation->getMechanicalState()) : nullptr;
+    }
+
+    struct Step
+    {
+        unsigned int nbIterations { 0 };
+        std::vector<SReal> articulations;
+    };
+
+    static Step step(const std::string& linearSolver, const bool springs)
+    {
+        SceneInstance scene("xml", chainScene(linearSolver, springs));
+        scene.initScene();
+        scene.simulate(0.01);
+
+        Step step;
+        const auto* pcg = scene.root->get<ShewchukPCGLinearSolver>(core::objectmodel::BaseContext::SearchDown);
+        if (pcg)
+        {
+            step.nbIterations = pcg->d_nbIterations.getValue();
+        }
+
+        const auto* articulations = getArticulations(scene.root);
+        EXPECT_NE(articulations, nullptr);
+        if (articulations)
+        {
+            for (const auto& q : articulations->read(core::ConstVecCoordId::position())->getValue())
+            {
+                step.articulations.push_back(q[0]);
+            }
+        }
+        return step;
+    }
+
+    static void expectSameArticulations(const Step& a, const Step& b)
+    {
+        ASSERT_EQ(a.articulations.size(), 4u);
+        ASSERT_EQ(b.articulations.size(), 4u);
+        for (std::size_t i = 0; i < a.articulations.size(); ++i)
+        {
+            EXPECT_NEAR(a.articulations[i], b.articulations[i], 1e-8) << "articulation " << i;
+        }
+    }
+};
+
+TEST_F(ArticulatedBodySolver_test, sameStepAsConjugateGradient)
+{
+    const Step cg = step(conjugateGradient(), true);
+    const Step pcg = step(preconditionedConjugateGradient(false), true);
+    const Step articulatedBody = step(preconditionedConjugateGradient(true), true);
+
+    expectSameArticulations(cg, articulatedBody);
+    EXPECT_GT(articulatedBody.nbIterations, 0u);
+    EXPECT_LT(articulatedBody.nbIterations, pcg.nbIterations);
+}
+
+TEST_F(ArticulatedBodySolver_test, inertiaOnlyConvergesInOneIteration)
+{
+    const Step cg = step(conjugateGradient(), false);
+    const Step articulatedBody = step(preconditionedConjugateGradient(true), false);
+
+    expectSameArticulations(cg, articulatedBody);
+    EXPECT_EQ(articulatedBody.nbIterations, 1u);
+}
+
+/// The compliance of the constraint correction on the articulations is the inverse of J^T M J, J being the
+/// Jacobian of the mapping and M the mass of the bodies
+TEST_F(ArticulatedBodySolver_test, complianceIsTheInverseOfTheMappedMass)
+{
+    SceneInstance scene("xml", chainScene(conjugateGradient(), false));
+    scene.initScene();
+    scene.simulate(0.01);
+
+    auto* articulations = getArticulations(scene.root);
+    auto* mapping = scene.root->get<Mapping>(core::objectmodel::BaseContext::SearchDown);
+    auto* correction = scene.root->get<ArticulatedBodyConstraintCorrection>(core::objectmodel::BaseContext::SearchDown);
+    const auto* odeSolver = scene.root->get<core::behavior::OdeSolver>(core::objectmodel::BaseContext::SearchDown);
+    ASSERT_NE(articulations, nullptr);
+    ASSERT_NE(mapping, nullptr);
+    ASSERT_NE(correction, nullptr);
+    ASSERT_NE(odeSolver, nullptr);
+    ASSERT_FALSE(mapping->getToModels().empty());
+
+    const auto* bodies = mapping->getToModels()[0];
+    core::behavior::BaseMass* mass = bodies->getContext()->getMass();
+    ASSERT_NE(mass, nullptr);
+
+    const std::size_t nbArticulations = articulations->getSize();
+    const std::size_t nbBodies = bodies->getSize();
+    ASSERT_EQ(nbArticulations, 4u);
+
+    // dense reference: J^T M J, the columns of J being the velocities of the bodies for unit articulation velocities
+    std::vector<Eigen::Matrix<SReal, Eigen::Dynamic, 1> > columns(nbArticulations, Eigen::Matrix<SReal, Eigen::Dynamic, 1>::Zero(6 * nbBodies));
+    for (std::size_t k = 0; k < nbArticulations; ++k)
+    {
+        defaulttype::Vec1Types::VecDeriv in(nbArticulations);
+        in[k][0] = 1;
+        defaulttype::Rigid3Types::VecDeriv out;
+        mapping->applyJ(out, in, nullptr);
+        ASSERT_EQ(out.size(), nbBodies);
+        for (std::size_t b = 0; b < nbBodies; ++b)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                columns[k][6 * b + a] = out[b].getVCenter()[a];
+                columns[k][6 * b + 3 + a] = out[b].getVOrientation()[a];
+            }
+        }
+    }
+
+    Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic> M = Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic>::Zero(6 * nbBodies, 6 * nbBodies);
+    linearalgebra::FullMatrix<SReal> elementMass(6, 6);
+    for (std::size_t b = 0; b < nbBodies; ++b)
+    {
+        mass->getElementMass(sofa::Index(b), &elementMass);
+        for (int r = 0; r < 6; ++r)
+        {
+            for (int c = 0; c < 6; ++c)
+            {
+                M(6 * b + r, 6 * b + c) = elementMass.element(r, c);
+            }
+        }
+    }
+
+    Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic> JtMJ(nbArticulations, nbArticulations);
+    for (std::size_t i = 0; i < nbArticulations; ++i)
+    {
+        for (std::size_t j = 0; j < nbArticulations; ++j)
+        {
+            JtMJ(i, j) = columns[i].dot(M * columns[j]);
+        }
+    }
+    const Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic> reference = JtMJ.inverse();
+
+    // one constraint per articulation, with a unit Jacobian
+    {
+        auto& constraintJacobian = *articulations->write(core::MatrixDerivId::constraintJacobian());
+        auto& J = *constraintJacobian.beginEdit();
+        J.clear();
+        for (std::size_t k = 0; k < nbArticulations; ++k)
+        {
+            auto row = J.writeLine(sofa::Index(k));
+            row.addCol(sofa::Index(k), defaulttype::Vec1Types::Deriv(1));
+        }
+        J.compress();
+        constraintJacobian.endEdit();
+    }
+
+    core::ConstraintParams cparams;
+    cparams.setOrder(core::ConstraintOrder::POS_AND_VEL);
+    linearalgebra::FullMatrix<SReal> W(sofa::Index(nbArticulations), sofa::Index(nbArticulations));
+    W.clear();
+    correction->addComplianceInConstraintSpace(&cparams, &W);
+
+    const SReal factor = odeSolver->getPositionIntegrationFactor();
+    ASSERT_NE(factor, 0);
+    for (std::size_t i = 0; i < nbArticulations; ++i)
+    {
+        for (std::size_t j = 0; j < nbArticulations; ++j)
+        {
+            EXPECT_NEAR(W.element(i, j) / factor, reference(i, j), 1e-8 * reference.norm()) << "(" << i << ", " << j << ")";
+        }
+    }
+}
+
+}
@@ -0,0 +1,225 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <ArticulatedSystemPlugin/ArticulatedBodyAlgorithm.h>
+#include <ArticulatedSystemPlugin/ArticulatedHierarchyContainer.h>
+
+#include <sofa/core/behavior/BaseMass.h>
+#include <sofa/core/objectmodel/BaseContext.h>
+#include <sofa/linearalgebra/FullMatrix.h>
+
+namespace sofa::component::linearsolver
+{
+
+ArticulatedBodyAlgorithm::Mat6 ArticulatedBodyAlgorithm::inertiaAtOrigin(const Mat6& inertiaAtCenter, const type::Vec3& c)
+{
+    // twist at the center from the twist at the origin: v_c = v_o - c x w
+    Mat6 T = Mat6::Identity();
+    T(0, 4) =  c[2]; T(0, 5) = -c[1];
+    T(1, 3) = -c[2]; T(1, 5) =  c[0];
+    T(2, 3) =  c[1]; T(2, 4) = -c[0];
+    return T.transpose() * inertiaAtCenter * T;
+}
+
+bool ArticulatedBodyAlgorithm::factorize(Mapping* mapping, const SReal massFactor, const type::vector<bool>& isLocked)
+{
+    m_joints.clear();
+    m_articulatedInertias.clear();
+    m_nbArticulations = 0;
+    m_nbSingularArticulations = 0;
+
+    if (!mapping || mapping->getFromModels1().empty() || mapping->getToModels().empty())
+    {
+        return false;
+    }
+
+    core::State<defaulttype::Vec1Types>* articulations = mapping->getFromModels1()[0];
+    core::State<defaulttype::Rigid3Types>* bodies = mapping->getToModels()[0];
+    const auto& axes = mapping->getArticulationAxes();
+    const auto& positions = mapping->getArticulationPositions();
+    const auto& x = bodies->read(core::ConstVecCoordId::position())->getValue();
+
+    m_nbArticulations = articulations->getSize();
+    if (axes.size() < m_nbArticulations || positions.size() < m_nbArticulations)
+    {
+        return false;
+    }
+
+    // inertia of the bodies, at the origin
+    core::behavior::BaseMass* bodyMass = bodies->getContext()->getMass();
+    linearalgebra::FullMatrix<SReal> elementMass(6, 6);
+    m_articulatedInertias.resize(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        Mat6 inertia = Mat6::Zero();
+        if (bodyMass)
+        {
+            bodyMass->getElementMass(sofa::Index(i), &elementMass);
+            for (int r = 0; r < 6; ++r)
+            {
+                for (int c = 0; c < 6; ++c)
+                {
+                    inertia(r, c) = elementMass.element(r, c);
+                }
+            }
+        }
+        m_articulatedInertias[i] = massFactor * inertiaAtOrigin(inertia, x[i].getCenter());
+    }
+
+    // the articulation centers, in the order of the mapping: a parent is moved before its children
+    for (auto* center : mapping->articulationCenters)
+    {
+        const int parent = center->parentIndex.getValue();
+        const int child = center->childIndex.getValue();
+        if (parent < 0 || child < 0 || parent == child || std::size_t(parent) >= x.size() || std::size_t(child) >= x.size())
+        {
+            return false;
+        }
+
+        Joint joint;
+        joint.parent = sofa::Index(parent);
+        joint.child = sofa::Index(child);
+
+        type::vector<Vec6> columns;
+        for (const auto* articulation : center->getArticulations())
+        {
+            const int ind = articulation->articulationIndex.getValue();
+            if (ind < 0 || std::size_t(ind) >= m_nbArticulations)
+            {
+                return false;
+            }
+            if (std::size_t(ind) < isLocked.size() && isLocked[ind])
+            {
+                continue;
+            }
+
+            const auto& axis = axes[ind];
+            Vec6 s = Vec6::Zero();
+            if (articulation->rotation.getValue())
+            {
+                const auto moment = type::cross(positions[ind], axis);
+                s.head<3>() += Eigen::Matrix<SReal, 3, 1>(moment[0], moment[1], moment[2]);
+                s.tail<3>() += Eigen::Matrix<SReal, 3, 1>(axis[0], axis[1], axis[2]);
+            }
+            if (articulation->translation.getValue())
+            {
+                s.head<3>() += Eigen::Matrix<SReal, 3, 1>(axis[0], axis[1], axis[2]);
+            }
+
+            joint.indices.push_back(sofa::Index(ind));
+            columns.push_back(s);
+        }
+
+        joint.S.resize(6, Eigen::Index(columns.size()));
+        for (std::size_t k = 0; k < columns.size(); ++k)
+        {
+            joint.S.col(Eigen::Index(k)) = columns[k];
+        }
+        m_joints.push_back(std::move(joint));
+    }
+
+    // diagonal masses of the articulations
+    core::behavior::BaseMass* articulationMass = articulations->getContext()->getMass();
+
+    // backward pass: the inertia of each subtree is condensed on the parent of its root
+    for (auto it = m_joints.rbegin(); it != m_joints.rend(); ++it)
+    {
+        Joint& joint = *it;
+        const Mat6& childInertia = m_articulatedInertias[joint.child];
+        Mat6& parentInertia = m_articulatedInertias[joint.parent];
+
+        if (!joint.indices.empty())
+        {
+            joint.U = childInertia * joint.S;
+            MatX D = joint.S.transpose() * joint.U;
+            if (articulationMass)
+            {
+                for (std::size_t k = 0; k < joint.indices.size(); ++k)
+                {
+                    D(Eigen::Index(k), Eigen::Index(k)) += massFactor * articulationMass->getElementMass(joint.indices[k]);
+                }
+            }
+
+            const Eigen::FullPivLU<MatX> lu(D);
+            if (lu.isInvertible())
+            {
+                joint.Dinv = lu.inverse();
+                parentInertia += childInertia - joint.U * joint.Dinv * joint.U.transpose();
+                continue;
+            }
+
+            // no inertia can be associated to the motion of the articulations: they are locked
+            m_nbSingularArticulations += joint.indices.size();
+            joint.indices.clear();
+            joint.S.resize(6, 0);
+            joint.U.resize(6, 0);
+        }
+        parentInertia += childInertia;
+    }
+
+    return true;
+}
+
+void ArticulatedBodyAlgorithm::solve(const type::vector<SReal>& f, type::vector<SReal>& a) const
+{
+    a.assign(m_nbArticulations, 0);
+    m_biasForces.assign(m_articulatedInertias.size(), Vec6::Zero());
+    m_accelerations.assign(m_articulatedInertias.size(), Vec6::Zero());
+    m_jointForces.resize(m_joints.size());
+
+    // backward pass: the articulation forces are propagated to the base
+    for (std::size_t j = m_joints.size(); j-- > 0;)
+    {
+        const Joint& joint = m_joints[j];
+        const Vec6 childForce = m_biasForces[joint.child];
+        if (!joint.indices.empty())
+        {
+            VecX& u = m_jointForces[j];
+            u.resize(Eigen::Index(joint.indices.size()));
+            for (std::size_t k = 0; k < joint.indices.size(); ++k)
+            {
+                u(Eigen::Index(k)) = joint.indices[k] < f.size() ? f[joint.indices[k]] : 0;
+            }
+            u -= joint.S.transpose() * childForce;
+            m_biasForces[joint.parent] += joint.U * (joint.Dinv * u);
+        }
+        m_biasForces[joint.parent] += childForce;
+    }
+
+    // forward pass: the accelerations are propagated from the base
+    for (std::size_t j = 0; j < m_joints.size(); ++j)
+    {
+        const Joint& joint = m_joints[j];
+        const Vec6 parentAcceleration = m_accelerations[joint.parent];
+        m_accelerations[joint.child] = parentAcceleration;
+        if (!joint.indices.empty())
+        {
+            const VecX qdd = joint.Dinv * (m_jointForces[j] - joint.U.transpose() * parentAcceleration);
+            m_accelerations[joint.child] += joint.S * qdd;
+            for (std::size_t k = 0; k < joint.indices.size(); ++k)
+            {
+                a[joint.indices[k]] = qdd(Eigen::Index(k));
+            }
+        }
+    }
+}
+
+} // namespace sofa::component::linearsolver
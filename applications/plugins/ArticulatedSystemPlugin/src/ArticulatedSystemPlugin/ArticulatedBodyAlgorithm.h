@@ -0,0 +1,100 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <ArticulatedSystemPlugin/config.h>
+
+#include <ArticulatedSystemPlugin/ArticulatedSystemMapping.h>
+#include <sofa/defaulttype/RigidTypes.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/type/vector.h>
+
+#include <Eigen/Dense>
+
+namespace sofa::component::linearsolver
+{
+
+/**
+ * Articulated-body algorithm (Featherstone) on the tree of articulation centers of an ArticulatedSystemMapping.
+ *
+ * It computes, in O(n) operations for n articulations, the solution of (m J^T M J + D) a = f, where J is the
+ * Jacobian of the mapping, M the masses of the rigid bodies, D the (optional) diagonal masses of the
+ * articulations and m a mass factor. This is the system that the mapped formulation solves when only the
+ * inertia is considered: the same velocity propagation and the same inertia matrices are used, so that
+ * the results match.
+ *
+ * The motions of the bodies are expressed as twists at the origin of the global frame, in the (linear, angular)
+ * order of the rigid derivatives. The base of the system (the body with no parent articulation) is fixed.
+ * Articulations can be locked: they then transmit the whole inertia of the subtree to their parent.
+ */
+class SOFA_ARTICULATEDSYSTEMPLUGIN_API ArticulatedBodyAlgorithm
+{
+public:
+    using Mapping = mapping::ArticulatedSystemMapping<defaulttype::Vec1Types, defaulttype::Rigid3Types, defaulttype::Rigid3Types>;
+    using Mat6 = Eigen::Matrix<SReal, 6, 6>;
+    using Vec6 = Eigen::Matrix<SReal, 6, 1>;
+    using Mat6X = Eigen::Matrix<SReal, 6, Eigen::Dynamic, 0, 6, 6>;
+    using MatX = Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic, 0, 6, 6>;
+    using VecX = Eigen::Matrix<SReal, Eigen::Dynamic, 1, 0, 6, 1>;
+
+    /// Compute the articulated inertias from the current state of the mapping (positions of the bodies, axes
+    /// and positions of the articulations) and the masses found in the contexts of its input and output states.
+    /// isLocked can be empty, or give for each articulation if it is fixed.
+    /// Returns false if the mapping is not usable; articulations with a singular inertia are locked.
+    bool factorize(Mapping* mapping, SReal massFactor, const type::vector<bool>& isLocked);
+
+    /// a = (m J^T M J + D)^-1 f, f and a being indexed by the articulation indices
+    void solve(const type::vector<SReal>& f, type::vector<SReal>& a) const;
+
+    std::size_t getNbArticulations() const { return m_nbArticulations; }
+
+    /// Number of articulations locked because their articulated inertia is singular, at the last factorization
+    std::size_t getNbSingularArticulations() const { return m_nbSingularArticulations; }
+
+    /// Spatial inertia at the origin of the global frame of a body of center c, given its inertia at its center
+    static Mat6 inertiaAtOrigin(const Mat6& inertiaAtCenter, const type::Vec3& c);
+
+protected:
+    struct Joint
+    {
+        sofa::Index parent;
+        sofa::Index child;
+        /// Articulation indices of the free degrees of freedom of the articulation center
+        type::vector<sofa::Index> indices;
+        /// Motion subspace: twist of the child relative to the parent, per unit velocity of each articulation
+        Mat6X S;
+        /// U = I^A S and Dinv = (S^T I^A S + D)^-1, I^A being the articulated inertia of the child
+        Mat6X U;
+        MatX Dinv;
+    };
+
+    type::vector<Joint> m_joints;
+    type::vector<Mat6> m_articulatedInertias;
+    std::size_t m_nbArticulations { 0 };
+    std::size_t m_nbSingularArticulations { 0 };
+
+    /// Forces and accelerations of the bodies, forces of the articulations: buffers of the solve
+    mutable type::vector<Vec6> m_biasForces;
+    mutable type::vector<Vec6> m_accelerations;
+    mutable type::vector<VecX> m_jointForces;
+};
+
+} // namespace sofa::component::linearsolver
@@ -0,0 +1,378 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <ArticulatedSystemPlugin/ArticulatedBodyConstraintCorrection.h>
+
+#include <sofa/core/ConstraintParams.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/core/behavior/ProjectiveConstraintSet.h>
+#include <sofa/linearalgebra/BaseMatrix.h>
+#include <sofa/linearalgebra/BaseVector.h>
+
+namespace sofa::component::constraint::lagrangian::correction
+{
+
+ArticulatedBodyConstraintCorrection::ArticulatedBodyConstraintCorrection(sofa::core::behavior::MechanicalState<DataTypes>* mm)
+    : Inherit(mm)
+    , l_mapping(initLink("mapping", "Mapping of the articulated system. If not set, the first one found in the context is used."))
+    , l_ODESolver(initLink("ODESolver", "Link towards the ODE solver used to recover the integration factors"))
+{
+}
+
+void ArticulatedBodyConstraintCorrection::init()
+{
+    Inherit::init();
+
+    sofa::core::objectmodel::BaseContext* context = this->getContext();
+
+    if (l_mapping.empty())
+    {
+        l_mapping.set(context->get<Mapping>(sofa::core::objectmodel::BaseContext::SearchDown));
+    }
+    if (l_mapping.get() == nullptr)
+    {
+        msg_error() << "No ArticulatedSystemMapping found at path: " << l_mapping.getLinkedPath() << ", nor in current context: " << context->name;
+        d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    if (l_ODESolver.empty())
+    {
+        l_ODESolver.set(context->get<sofa::core::behavior::OdeSolver>(sofa::core::objectmodel::BaseContext::Local));
+        if (l_ODESolver.get() == nullptr)
+        {
+            l_ODESolver.set(context->get<sofa::core::behavior::OdeSolver>(sofa::core::objectmodel::BaseContext::SearchRoot));
+        }
+    }
+    if (l_ODESolver.get() == nullptr)
+    {
+        msg_error() << "No ODESolver component found at path: " << l_ODESolver.getLinkedPath() << ", nor in current context: " << context->name;
+        d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    if (mstate == nullptr)
+    {
+        d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    const core::State<DataTypes>* articulations = l_mapping->getFromModels1().empty() ? nullptr : l_mapping->getFromModels1()[0].get();
+    if (articulations != mstate)
+    {
+        msg_error() << "The mechanical state " << mstate->getPathName() << " is not the input of the mapping " << l_mapping->getPathName();
+        d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    d_componentState.setValue(sofa::core::objectmodel::ComponentState::Valid);
+}
+
+void ArticulatedBodyConstraintCorrection::factorize()
+{
+    // the projection of a unit velocity on all the articulations gives the locked ones
+    Data<VecDeriv> ones;
+    {
+        auto v = helper::getWriteOnlyAccessor(ones);
+        v.resize(mstate->getSize());
+        for (auto& vi : v)
+        {
+            vi[0] = 1;
+        }
+    }
+    std::vector<sofa::core::behavior::ProjectiveConstraintSet<DataTypes>*> projectiveConstraints;
+    this->getContext()->get<sofa::core::behavior::ProjectiveConstraintSet<DataTypes> >(&projectiveConstraints, sofa::core::objectmodel::BaseContext::Local);
+    for (auto* projectiveConstraint : projectiveConstraints)
+    {
+        projectiveConstraint->projectResponse(core::mechanicalparams::defaultInstance(), ones);
+    }
+
+    const VecDeriv& projected = ones.getValue();
+    m_isLocked.resize(projected.size());
+    for (std::size_t i = 0; i < projected.size(); ++i)
+    {
+        m_isLocked[i] = projected[i][0] == 0;
+    }
+
+    if (!m_algorithm.factorize(l_mapping.get(), 1_sreal, m_isLocked))
+    {
+        msg_error() << "The articulated system of the mapping " << l_mapping->getPathName() << " is not valid";
+        d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+    msg_warning_when(m_algorithm.getNbSingularArticulations() > 0) << m_algorithm.getNbSingularArticulations()
+        << " articulations have no inertia: they are locked";
+}
+
+void ArticulatedBodyConstraintCorrection::computeDx(const VecDeriv& f, VecDeriv& dx) const
+{
+    m_force.resize(f.size());
+    for (std::size_t i = 0; i < f.size(); ++i)
+    {
+        m_force[i] = f[i][0];
+    }
+
+    m_algorithm.solve(m_force, m_acceleration);
+
+    dx.resize(f.size());
+    for (std::size_t i = 0; i < dx.size(); ++i)
+    {
+        dx[i][0] = i < m_acceleration.size() ? m_acceleration[i] : 0;
+    }
+}
+
+void ArticulatedBodyConstraintCorrection::addComplianceInConstraintSpace(const sofa::core::ConstraintParams* cparams, sofa::linearalgebra::BaseMatrix* W)
+{
+    if (!this->isComponentStateValid())
+        return;
+
+    factorize();
+    if (!this->isComponentStateValid())
+        return;
+
+    // use the OdeSolver to get the position integration factor
+    SReal factor = 1.0_sreal;
+
+    switch (cparams->constOrder())
+    {
+    case core::ConstraintOrder::POS_AND_VEL :
+    case core::ConstraintOrder::POS :
+        factor = l_ODESolver->getPositionIntegrationFactor();
+        break;
+
+    case core::ConstraintOrder::ACC :
+    case core::ConstraintOrder::VEL :
+        factor = l_ODESolver->getVelocityIntegrationFactor();
+        break;
+
+    default :
+        break;
+    }
+
+    const MatrixDeriv& constraints = cparams->readJ(this->mstate)->getValue();
+    const std::size_t nbArticulations = this->mstate->getSize();
+
+    // response of the articulations to each constraint direction: (J^T M J)^-1 J_c^T
+    type::vector<MatrixDerivRowConstIterator> rows;
+    type::vector<type::vector<SReal> > responses;
+    for (MatrixDerivRowConstIterator rowIt = constraints.begin(), rowItEnd = constraints.end(); rowIt != rowItEnd; ++rowIt)
+    {
+        if (rowIt.row().empty()) continue; // ignore constraints with empty Jacobians
+
+        m_force.assign(nbArticulations, 0);
+        for (MatrixDerivColConstIterator colIt = rowIt.begin(), colItEnd = rowIt.end(); colIt != colItEnd; ++colIt)
+        {
+            m_force[colIt.index()] += colIt.val()[0];
+        }
+
+        rows.push_back(rowIt);
+        responses.emplace_back();
+        m_algorithm.solve(m_force, responses.back());
+    }
+
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+        const int indexCurRowConst = rows[i].index();
+        for (std::size_t j = i; j < rows.size(); ++j)
+        {
+            const int indexCurColConst = rows[j].index();
+
+            SReal w = 0.0;
+            for (MatrixDerivColConstIterator colIt = rows[j].begin(), colItEnd = rows[j].end(); colIt != colItEnd; ++colIt)
+            {
+                w += colIt.val()[0] * responses[i][colIt.index()];
+            }
+            w *= factor;
+
+            if (i == j)
+            {
+                W->add(indexCurRowConst, indexCurRowConst, w);
+            }
+            else if (w != 0.0)
+            {
+                W->add(indexCurRowConst, indexCurColConst, w);
+                W->add(indexCurColConst, indexCurRowConst, w);
+            }
+        }
+    }
+}
+
+void ArticulatedBodyConstraintCorrection::getComplianceMatrix(linearalgebra::BaseMatrix* m) const
+{
+    if (!this->isComponentStateValid())
+        return;
+
+    const SReal factor = l_ODESolver.get()->getPositionIntegrationFactor();
+    const std::size_t nbArticulations = this->mstate->getSize();
+
+    m->resize(linearalgebra::BaseMatrix::Index(nbArticulations), linearalgebra::BaseMatrix::Index(nbArticulations));
+
+    for (std::size_t j = 0; j < nbArticulations; ++j)
+    {
+        m_force.assign(nbArticulations, 0);
+        m_force[j] = 1;
+        m_algorithm.solve(m_force, m_acceleration);
+        for (std::size_t i = 0; i < nbArticulations && i < m_acceleration.size(); ++i)
+        {
+            if (m_acceleration[i] != 0)
+            {
+                m->set(linearalgebra::BaseMatrix::Index(i), linearalgebra::BaseMatrix::Index(j), m_acceleration[i] * factor);
+            }
+        }
+    }
+}
+
+void ArticulatedBodyConstraintCorrection::computeMotionCorrection(const core::ConstraintParams* cparams, core::MultiVecDerivId dx, core::MultiVecDerivId f)
+{
+    SOFA_UNUSED(cparams);
+
+    if (!this->isComponentStateValid())
+        return;
+
+    auto writeDx = sofa::helper::getWriteAccessor(*dx[this->getMState()].write());
+    const Data<VecDeriv>& f_d = *f[this->getMState()].read();
+    computeDx(f_d.getValue(), writeDx.wref());
+}
+
+void ArticulatedBodyConstraintCorrection::applyMotionCorrection(const sofa::core::ConstraintParams* cparams, Data< VecCoord >& x_d, Data< VecDeriv >& v_d, Data< VecDeriv >& dx_d, const Data< VecDeriv >& correction_d)
+{
+    if (!this->isComponentStateValid())
+        return;
+
+    auto x = sofa::helper::getWriteAccessor(x_d);
+    auto v = sofa::helper::getWriteAccessor(v_d);
+    auto dx = sofa::helper::getWriteAccessor(dx_d);
+
+    const VecDeriv& correction = correction_d.getValue();
+    const VecCoord& x_free = cparams->readX(mstate)->getValue();
+    const VecDeriv& v_free = cparams->readV(mstate)->getValue();
+
+    const SReal positionFactor = l_ODESolver.get()->getPositionIntegrationFactor();
+    const SReal velocityFactor = l_ODESolver.get()->getVelocityIntegrationFactor();
+
+    for (std::size_t i = 0; i < mstate->getSize(); i++)
+    {
+        const Deriv dxi = correction[i] * positionFactor;
+        const Deriv dvi = correction[i] * velocityFactor;
+        x[i] = x_free[i] + dxi;
+        v[i] = v_free[i] + dvi;
+        dx[i] = dxi;
+    }
+}
+
+void ArticulatedBodyConstraintCorrection::applyPositionCorrection(const sofa::core::ConstraintParams* cparams, Data< VecCoord >& x_d, Data< VecDeriv >& dx_d, const Data< VecDeriv >& correction_d)
+{
+    if (!this->isComponentStateValid())
+        return;
+
+    auto x = sofa::helper::getWriteAccessor(x_d);
+    auto dx = sofa::helper::getWriteAccessor(dx_d);
+
+    const VecDeriv& correction = correction_d.getValue();
+    const VecCoord& x_free = cparams->readX(mstate)->getValue();
+
+    const SReal positionFactor = l_ODESolver.get()->getPositionIntegrationFactor();
+    for (std::size_t i = 0; i < mstate->getSize(); i++)
+    {
+        const Deriv dxi = correction[i] * positionFactor;
+        x[i] = x_free[i] + dxi;
+        dx[i] = dxi;
+    }
+}
+
+void ArticulatedBodyConstraintCorrection::applyVelocityCorrection(const sofa::core::ConstraintParams* cparams, Data< VecDeriv >& v_d, Data< VecDeriv >& dv_d, const Data< VecDeriv >& correction_d)
+{
+    if (!this->isComponentStateValid())
+        return;
+
+    auto v = sofa::helper::getWriteAccessor(v_d);
+    auto dv = sofa::helper::getWriteAccessor(dv_d);
+
+    const VecDeriv& correction = correction_d.getValue();
+    const VecDeriv& v_free = cparams->readV(mstate)->getValue();
+
+    const SReal velocityFactor = l_ODESolver.get()->getVelocityIntegrationFactor();
+    for (std::size_t i = 0; i < mstate->getSize(); i++)
+    {
+        const Deriv dvi = correction[i] * velocityFactor;
+        v[i] = v_free[i] + dvi;
+        dv[i] = dvi;
+    }
+}
+
+void ArticulatedBodyConstraintCorrection::applyContactForce(const linearalgebra::BaseVector* f)
+{
+    if (!this->isComponentStateValid())
+        return;
+
+    auto force = sofa::helper::getWriteAccessor(*mstate->write(core::VecDerivId::externalForce()));
+    const MatrixDeriv& constraints = mstate->read(core::ConstMatrixDerivId::constraintJacobian())->getValue();
+
+    force.resize(mstate->getSize());
+    for (MatrixDerivRowConstIterator rowIt = constraints.begin(), rowItEnd = constraints.end(); rowIt != rowItEnd; ++rowIt)
+    {
+        const SReal fC1 = f->element(rowIt.index());
+        if (fC1 != 0.0)
+        {
+            for (MatrixDerivColConstIterator colIt = rowIt.begin(), colItEnd = rowIt.end(); colIt != colItEnd; ++colIt)
+            {
+                force[colIt.index()] += colIt.val() * fC1;
+            }
+        }
+    }
+
+    auto dx = sofa::helper::getWriteAccessor(*mstate->write(core::VecDerivId::dx()));
+    auto x = sofa::helper::getWriteAccessor(*mstate->write(core::VecCoordId::position()));
+    auto v = sofa::helper::getWriteAccessor(*mstate->write(core::VecDerivId::velocity()));
+    const VecDeriv& v_free = mstate->read(core::ConstVecDerivId::freeVelocity())->getValue();
+    const VecCoord& x_free = mstate->read(core::ConstVecCoordId::freePosition())->getValue();
+
+    const SReal positionFactor = l_ODESolver.get()->getPositionIntegrationFactor();
+    const SReal velocityFactor = l_ODESolver.get()->getVelocityIntegrationFactor();
+
+    computeDx(force.ref(), dx.wref());
+    for (std::size_t i = 0; i < dx.size(); i++)
+    {
+        const Deriv dxi = dx[i] * positionFactor;
+        const Deriv dvi = dx[i] * velocityFactor;
+        x[i] = x_free[i] + dxi;
+        v[i] = v_free[i] + dvi;
+        dx[i] = dxi;
+    }
+}
+
+void ArticulatedBodyConstraintCorrection::resetContactForce()
+{
+    auto force = sofa::helper::getWriteAccessor(*mstate->write(core::VecDerivId::externalForce()));
+    for (auto& fi : force)
+    {
+        fi = Deriv();
+    }
+}
+
+// Register in the Factory
+int ArticulatedBodyConstraintCorrectionClass = core::RegisterObject("Constraint correction on the articulations of an ArticulatedSystemMapping, "
+                                                                    "using the articulated-body algorithm to apply the inverse of the joint-space inertia")
+        .add< ArticulatedBodyConstraintCorrection >()
+        ;
+
+} // namespace sofa::component::constraint::lagrangian::correction
@@ -0,0 +1,110 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <ArticulatedSystemPlugin/config.h>
+
+#include <ArticulatedSystemPlugin/ArticulatedBodyAlgorithm.h>
+#include <sofa/core/behavior/ConstraintCorrection.h>
+#include <sofa/core/behavior/OdeSolver.h>
+
+namespace sofa::component::constraint::lagrangian::correction
+{
+
+/**
+ *  \brief Component computing constraint forces on the articulations of an ArticulatedSystemMapping using the
+ *  compliance method.
+ *
+ *  The compliance is the inverse of the joint-space inertia J^T M J of the articulated system (plus the masses of
+ *  the articulations, if any), applied in O(n) operations per constraint by the articulated-body algorithm:
+ *  W = J_c (J^T M J)^-1 J_c^T, J_c being the constraint Jacobian on the articulations. As with
+ *  UncoupledConstraintCorrection, the stiffness of the force fields is not taken into account. The base of the
+ *  system is fixed, and the articulations fixed by the projective constraints of the node are locked.
+ */
+class SOFA_ARTICULATEDSYSTEMPLUGIN_API ArticulatedBodyConstraintCorrection : public sofa::core::behavior::ConstraintCorrection< defaulttype::Vec1Types >
+{
+public:
+    SOFA_CLASS(ArticulatedBodyConstraintCorrection, SOFA_TEMPLATE(sofa::core::behavior::ConstraintCorrection, defaulttype::Vec1Types));
+
+    typedef defaulttype::Vec1Types DataTypes;
+    typedef DataTypes::Real Real;
+    typedef DataTypes::VecCoord VecCoord;
+    typedef DataTypes::VecDeriv VecDeriv;
+    typedef DataTypes::MatrixDeriv MatrixDeriv;
+    typedef DataTypes::Deriv Deriv;
+    typedef DataTypes::MatrixDeriv::RowConstIterator MatrixDerivRowConstIterator;
+    typedef DataTypes::MatrixDeriv::ColConstIterator MatrixDerivColConstIterator;
+    typedef linearsolver::ArticulatedBodyAlgorithm::Mapping Mapping;
+
+    typedef sofa::core::behavior::ConstraintCorrection< DataTypes > Inherit;
+
+protected:
+    ArticulatedBodyConstraintCorrection(sofa::core::behavior::MechanicalState<DataTypes>* mm = nullptr);
+    ~ArticulatedBodyConstraintCorrection() override = default;
+
+public:
+    void init() override;
+
+    void addComplianceInConstraintSpace(const sofa::core::ConstraintParams* cparams, sofa::linearalgebra::BaseMatrix* W) override;
+
+    void getComplianceMatrix(linearalgebra::BaseMatrix* m) const override;
+
+    /// @name Correction API
+    /// @{
+
+    void computeMotionCorrection(const core::ConstraintParams* cparams, core::MultiVecDerivId dx, core::MultiVecDerivId f) override;
+
+    void applyMotionCorrection(const sofa::core::ConstraintParams* cparams, Data< VecCoord >& x, Data< VecDeriv >& v, Data< VecDeriv >& dx, const Data< VecDeriv >& correction) override;
+
+    void applyPositionCorrection(const sofa::core::ConstraintParams* cparams, Data< VecCoord >& x, Data< VecDeriv >& dx, const Data< VecDeriv >& correction) override;
+
+    void applyVelocityCorrection(const sofa::core::ConstraintParams* cparams, Data< VecDeriv >& v, Data< VecDeriv >& dv, const Data< VecDeriv >& correction) override;
+
+    /// @}
+
+    /// @name Deprecated API
+    /// @{
+
+    void applyContactForce(const linearalgebra::BaseVector* f) override;
+
+    void resetContactForce() override;
+
+    /// @}
+
+    SingleLink<ArticulatedBodyConstraintCorrection, Mapping, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_mapping; ///< Mapping of the articulated system
+    SingleLink<ArticulatedBodyConstraintCorrection, sofa::core::behavior::OdeSolver, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_ODESolver; ///< Link towards the ODE solver used to recover the integration factors
+
+protected:
+    /// Articulated inertias from the current state of the mapping
+    void factorize();
+
+    /// dx = (J^T M J)^-1 f
+    void computeDx(const VecDeriv& f, VecDeriv& dx) const;
+
+    linearsolver::ArticulatedBodyAlgorithm m_algorithm;
+
+    /// Articulations fixed by the projective constraints
+    type::vector<bool> m_isLocked;
+    mutable type::vector<SReal> m_force;
+    mutable type::vector<SReal> m_acceleration;
+};
+
+} // namespace sofa::component::constraint::lagrangian::correction
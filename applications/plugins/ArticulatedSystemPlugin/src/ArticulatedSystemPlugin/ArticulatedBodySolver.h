@@ -0,0 +1,90 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <ArticulatedSystemPlugin/config.h>
+
+#include <ArticulatedSystemPlugin/ArticulatedBodyAlgorithm.h>
+#include <sofa/component/linearsolver/iterative/MatrixLinearSolver.h>
+#include <sofa/core/behavior/MechanicalState.h>
+
+namespace sofa::component::linearsolver
+{
+
+/**
+ * Preconditioner for the articulated systems of an ArticulatedSystemMapping, using the articulated-body
+ * algorithm (Featherstone) on the tree of articulation centers.
+ *
+ * It is meant to be linked as the preconditioner of a ShewchukPCGLinearSolver, solving the system of an
+ * implicit ODE solver (for instance EulerImplicitSolver) integrating the articulations. The inertia of the rigid
+ * bodies is inverted exactly in O(n) operations by the articulated-body algorithm, instead of assembling the
+ * mapped system. The other terms of the system (stiffness, damping, other mechanical states) are taken into
+ * account by the conjugate gradient iterating on the exact, unassembled, operator of the scene: with inertia
+ * only, it converges in one iteration to the solution of the mapped formulation.
+ *
+ * The base of the system is considered fixed, and the articulations fixed by projective constraints are locked.
+ */
+template<class TMatrix, class TVector>
+class ArticulatedBodySolver : public sofa::component::linearsolver::MatrixLinearSolver<TMatrix, TVector>
+{
+public:
+    SOFA_CLASS(SOFA_TEMPLATE2(ArticulatedBodySolver,TMatrix,TVector),SOFA_TEMPLATE2(sofa::component::linearsolver::MatrixLinearSolver,TMatrix,TVector));
+
+    using Matrix = TMatrix;
+    using Vector = TVector;
+    using Real = typename Matrix::Real;
+    using Inherit = sofa::component::linearsolver::MatrixLinearSolver<TMatrix, TVector>;
+    using Mapping = ArticulatedBodyAlgorithm::Mapping;
+    using DataTypes = defaulttype::Vec1Types;
+
+    SingleLink<ArticulatedBodySolver<TMatrix, TVector>, Mapping, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_mapping;
+
+    void init() override;
+
+    void setSystemMBKMatrix(const core::MechanicalParams* mparams) override;
+
+    /// x = M^-1 b, M^-1 being the articulated-body algorithm on the articulations
+    void solve(Matrix& A, Vector& x, Vector& b) override;
+
+    const ArticulatedBodyAlgorithm& getArticulatedBodyAlgorithm() const { return m_algorithm; }
+
+protected:
+    ArticulatedBodySolver();
+
+    /// Articulated inertias from the current state of the mapping and the mass factor of the system
+    void updateAlgorithm(Matrix& A, typename Inherit::TempVectorContainer& vtmp);
+
+    ArticulatedBodyAlgorithm m_algorithm;
+    core::behavior::MechanicalState<DataTypes>* m_mstate { nullptr };
+
+    /// Articulations fixed by the projective constraints
+    type::vector<bool> m_isLocked;
+    type::vector<SReal> m_force;
+    type::vector<SReal> m_acceleration;
+
+    bool m_needsUpdate { true };
+};
+
+#if !defined(SOFA_COMPONENT_LINEARSOLVER_ARTICULATEDBODYSOLVER_CPP)
+extern template class SOFA_ARTICULATEDSYSTEMPLUGIN_API ArticulatedBodySolver< GraphScatteredMatrix, GraphScatteredVector >;
+#endif // !defined(SOFA_COMPONENT_LINEARSOLVER_ARTICULATEDBODYSOLVER_CPP)
+
+} // namespace sofa::component::linearsolver
@@ -0,0 +1,164 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <ArticulatedSystemPlugin/ArticulatedBodySolver.h>
+#include <sofa/core/behavior/BaseMass.h>
+#include <sofa/core/objectmodel/BaseContext.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/helper/accessor.h>
+
+namespace sofa::component::linearsolver
+{
+
+template<class TMatrix, class TVector>
+ArticulatedBodySolver<TMatrix,TVector>::ArticulatedBodySolver()
+    : l_mapping(initLink("mapping", "Mapping of the articulated system. If not set, the first one found in the context is used."))
+{
+}
+
+template<class TMatrix, class TVector>
+void ArticulatedBodySolver<TMatrix,TVector>::init()
+{
+    Inherit1::init();
+
+    if (!l_mapping)
+    {
+        l_mapping.set(this->getContext()->template get<Mapping>(core::objectmodel::BaseContext::SearchDown));
+    }
+    if (!l_mapping)
+    {
+        msg_error() << "No ArticulatedSystemMapping found: set the link 'mapping'";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    m_mstate = nullptr;
+    if (!l_mapping->getFromModels1().empty())
+    {
+        core::State<DataTypes>* articulations = l_mapping->getFromModels1()[0];
+        m_mstate = dynamic_cast<core::behavior::MechanicalState<DataTypes>*>(articulations);
+    }
+    if (!m_mstate)
+    {
+        msg_error() << "The mapping " << l_mapping->getPathName() << " has no mechanical state of articulations";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    m_needsUpdate = true;
+    this->d_componentState.setValue(core::objectmodel::ComponentState::Valid);
+}
+
+template<class TMatrix, class TVector>
+void ArticulatedBodySolver<TMatrix,TVector>::setSystemMBKMatrix(const core::MechanicalParams* mparams)
+{
+    Inherit::setSystemMBKMatrix(mparams);
+    m_needsUpdate = true;
+}
+
+template<class TMatrix, class TVector>
+void ArticulatedBodySolver<TMatrix,TVector>::updateAlgorithm(Matrix& A, typename Inherit::TempVectorContainer& vtmp)
+{
+    SCOPED_TIMER_VARNAME(updateTimer, "ArticulatedBody::factorize");
+
+    // the projection of a unit velocity on all the articulations gives the locked ones
+    Vector& u = *vtmp.createTempVector();
+    u.clear();
+    {
+        auto ones = helper::getWriteOnlyAccessor(*m_mstate->write(core::VecDerivId(u.id().getId(m_mstate))));
+        for (auto& v : ones)
+        {
+            v[0] = 1;
+        }
+    }
+    A.parent->projectResponse(u);
+    {
+        const auto& projected = m_mstate->read(core::ConstVecDerivId(u.id().getId(m_mstate)))->getValue();
+        m_isLocked.resize(projected.size());
+        for (std::size_t i = 0; i < projected.size(); ++i)
+        {
+            m_isLocked[i] = projected[i][0] == 0;
+        }
+    }
+    vtmp.deleteTempVector(&u);
+
+    const core::behavior::BaseMass* bodyMass = nullptr;
+    if (!l_mapping->getToModels().empty())
+    {
+        bodyMass = l_mapping->getToModels()[0]->getContext()->getMass();
+    }
+    const SReal massFactor = A.mparams.mFactorIncludingRayleighDamping(bodyMass ? bodyMass->rayleighMass.getValue() : 0);
+
+    if (!m_algorithm.factorize(l_mapping.get(), massFactor, m_isLocked))
+    {
+        msg_error() << "The articulated system of the mapping " << l_mapping->getPathName() << " is not valid";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+    msg_warning_when(m_algorithm.getNbSingularArticulations() > 0) << m_algorithm.getNbSingularArticulations()
+        << " articulations have no inertia: they are locked in the preconditioner";
+}
+
+template<class TMatrix, class TVector>
+void ArticulatedBodySolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
+{
+    SCOPED_TIMER_VARNAME(solveTimer, "ArticulatedBody::solve");
+
+    const core::ExecParams* params = core::execparams::defaultInstance();
+    typename Inherit::TempVectorContainer vtmp(this, params, A, x, b);
+
+    if (this->isComponentStateValid() && m_needsUpdate)
+    {
+        updateAlgorithm(A, vtmp);
+        m_needsUpdate = false;
+    }
+
+    // the other mechanical states are not preconditioned
+    x = b;
+
+    if (!this->isComponentStateValid())
+    {
+        return;
+    }
+
+    {
+        const auto& residual = m_mstate->read(core::ConstVecDerivId(b.id().getId(m_mstate)))->getValue();
+        m_force.resize(residual.size());
+        for (std::size_t i = 0; i < residual.size(); ++i)
+        {
+            m_force[i] = residual[i][0];
+        }
+    }
+
+    m_algorithm.solve(m_force, m_acceleration);
+
+    {
+        auto correction = helper::getWriteOnlyAccessor(*m_mstate->write(core::VecDerivId(x.id().getId(m_mstate))));
+        for (std::size_t i = 0; i < correction.size() && i < m_acceleration.size(); ++i)
+        {
+            correction[i][0] = m_acceleration[i];
+        }
+    }
+    A.parent->projectResponse(x);
+}
+
+} // namespace sofa::component::linearsolver
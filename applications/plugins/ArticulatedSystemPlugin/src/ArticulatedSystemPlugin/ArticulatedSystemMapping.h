@@ -214,6 +214,11 @@ public:
 
     void draw(const core::visual::VisualParams* vparams) override;
 
+    /// Axis of each articulation in the global frame, updated in apply
+    const std::vector< sofa::type::Vec<3,OutReal> >& getArticulationAxes() const { return ArticulationAxis; }
+    /// Position of each articulation in the global frame, updated in apply
+    const std::vector< sofa::type::Vec<3,OutReal> >& getArticulationPositions() const { return ArticulationPos; }
+
     /**
     *	Stores al the articulation centers
     */
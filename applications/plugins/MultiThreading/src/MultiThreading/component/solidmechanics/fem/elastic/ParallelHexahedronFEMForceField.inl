@@ -103,32 +103,33 @@ void ParallelHexahedronFEMForceField<DataTypes>::addForce(const sofa::core::Mech
         first = false;
     }
 
-    std::mutex mutex;
+    using ElementForces = std::vector<std::pair<sofa::type::Vec<8, Deriv>, SReal> >;
 
-    sofa::simulation::parallelForEachRange(*m_taskScheduler,
+    // the forces and the energies are accumulated in the order of the elements in deterministic execution
+    sofa::simulation::parallelForEachRangeWithMerge(*m_taskScheduler,
         indexedElements->begin(), indexedElements->end(),
-        [this, &_p, &elementStiffnesses, &mutex, &_f](const auto& range)
+        [this, &_p, &elementStiffnesses](const auto& range)
         {
             auto elementId = std::distance(this->getIndexedElements()->begin(), range.start);
 
-            std::vector<sofa::type::Vec<8, Deriv>> fElements;
+            ElementForces fElements;
             fElements.reserve(std::distance(range.start, range.end));
 
-            SReal potentialEnergy { 0_sreal };
             for (auto it = range.start; it != range.end; ++it, ++elementId)
             {
                 sofa::type::Vec<8, Deriv> forceInElement;
+                SReal potentialEnergy { 0_sreal };
                 this->computeTaskForceLarge(_p, elementId, *it, elementStiffnesses, potentialEnergy, forceInElement);
-                fElements.emplace_back(forceInElement);
+                fElements.emplace_back(forceInElement, potentialEnergy);
             }
-
-            std::lock_guard guard(mutex);
-
-            this->m_potentialEnergy += potentialEnergy;
-
+            return fElements;
+        },
+        [this, &_f](const auto& range, ElementForces& fElements)
+        {
             auto it = range.start;
-            for (const auto& forceInElement : fElements)
+            for (const auto& [forceInElement, potentialEnergy] : fElements)
             {
+                this->m_potentialEnergy += potentialEnergy;
                 for (int w = 0; w < 8; ++w)
                 {
                     _f[(*it)[w]] += forceInElement[w];
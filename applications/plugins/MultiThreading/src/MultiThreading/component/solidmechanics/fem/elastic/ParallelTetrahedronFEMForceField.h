@@ -42,6 +42,9 @@ namespace multithreading::component::solidmechanics::fem::elastic
  * The following methods are executed in parallel:
  * - addDForce
  * - addKToMatrix
+ *
+ * In deterministic execution (see sofa::simulation::setDeterministicExecution), the contributions
+ * of the elements are gathered on each vertex in the order of the elements.
  */
 template<class DataTypes>
 class SOFA_MULTITHREADING_PLUGIN_API ParallelTetrahedronFEMForceField :
@@ -84,6 +87,13 @@ protected:
     void addDForceGeneric(VecDeriv& df, const VecDeriv& dx, Real kFactor,
                            const VecElement& indexedElements, Function f);
 
+    template<class Function>
+    void addDForceDeterministic(VecDeriv& df, const VecDeriv& dx, Real kFactor,
+                                const VecElement& indexedElements, Function f);
+
+    /// Builds the list of the element vertices around each vertex, if the topology changed
+    void updateElementVerticesAroundVertex(std::size_t nbVertices, const VecElement& indexedElements);
+
     void addDForceSmall(VecDeriv& df, const VecDeriv& dx, Real kFactor,
                            const VecElement& indexedElements);
     void addDForceCorotational(VecDeriv& df, const VecDeriv& dx, Real kFactor,
@@ -99,6 +109,13 @@ protected:
 
     std::map<std::thread::id, VecDeriv> m_threadLocal_df;
 
+    /// Contribution to df of each vertex of each element (4 per element)
+    sofa::type::vector<Deriv> m_elementsDf;
+    /// Compressed storage of the element vertices (indices in m_elementsDf) around each vertex
+    sofa::type::vector<sofa::Index> m_elementVerticesAroundVertexBegin;
+    sofa::type::vector<sofa::Index> m_elementVerticesAroundVertex;
+    int m_elementVerticesAroundVertexRevision { -1 };
+
 };
 
 #if  !defined(SOFA_MULTITHREADING_PARALLELTETRAHEDRONFEMFORCEFIELD_CPP)
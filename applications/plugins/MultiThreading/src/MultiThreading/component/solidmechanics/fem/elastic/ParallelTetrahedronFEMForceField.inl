@@ -68,6 +68,12 @@ template <class Function>
 void ParallelTetrahedronFEMForceField<DataTypes>::addDForceGeneric(VecDeriv& df, const VecDeriv& dx,
     Real kFactor, const VecElement& indexedElements, Function f)
 {
+    if (sofa::simulation::isDeterministicExecution())
+    {
+        addDForceDeterministic(df, dx, kFactor, indexedElements, f);
+        return;
+    }
+
     std::mutex mutex;
     sofa::simulation::parallelForEachRange(*m_taskScheduler, indexedElements.begin(), indexedElements.end(),
            [&indexedElements, this, kFactor, &dx, &df, &f, &mutex](const auto& range)
@@ -98,6 +104,90 @@ void ParallelTetrahedronFEMForceField<DataTypes>::addDForceGeneric(VecDeriv& df,
            });
 }
 
+template <class DataTypes>
+template <class Function>
+void ParallelTetrahedronFEMForceField<DataTypes>::addDForceDeterministic(VecDeriv& df, const VecDeriv& dx,
+    Real kFactor, const VecElement& indexedElements, Function f)
+{
+    updateElementVerticesAroundVertex(df.size(), indexedElements);
+    m_elementsDf.resize(indexedElements.size() * Element::size());
+
+    // the contribution of each element is computed on a local copy of its vertices
+    sofa::simulation::parallelForEachRange(*m_taskScheduler, indexedElements.begin(), indexedElements.end(),
+        [&indexedElements, this, kFactor, &dx, &f](const auto& range)
+        {
+            auto elementId = std::distance(indexedElements.begin(), range.start);
+
+            VecDeriv local_dx(Element::size());
+            VecDeriv local_df(Element::size());
+
+            for (auto it = range.start; it != range.end; ++it, ++elementId)
+            {
+                for (sofa::Index v = 0; v < Element::size(); ++v)
+                {
+                    local_dx[v] = dx[(*it)[v]];
+                    local_df[v] = Deriv();
+                }
+
+                f( local_df, local_dx, elementId, 0,1,2,3, kFactor );
+
+                std::copy(local_df.begin(), local_df.end(), m_elementsDf.begin() + elementId * Element::size());
+            }
+        });
+
+    // the contributions are gathered on each vertex, in the order of the elements
+    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), df.size(),
+        [this, &df](const auto& range)
+        {
+            for (auto vertexId = range.start; vertexId != range.end; ++vertexId)
+            {
+                for (auto i = m_elementVerticesAroundVertexBegin[vertexId]; i < m_elementVerticesAroundVertexBegin[vertexId + 1]; ++i)
+                {
+                    df[vertexId] += m_elementsDf[m_elementVerticesAroundVertex[i]];
+                }
+            }
+        });
+}
+
+template <class DataTypes>
+void ParallelTetrahedronFEMForceField<DataTypes>::updateElementVerticesAroundVertex(
+    const std::size_t nbVertices, const VecElement& indexedElements)
+{
+    const int revision = this->m_topology ? this->m_topology->getRevision() : 0;
+    if (revision == m_elementVerticesAroundVertexRevision
+        && m_elementVerticesAroundVertexBegin.size() == nbVertices + 1
+        && m_elementVerticesAroundVertex.size() == indexedElements.size() * Element::size())
+    {
+        return;
+    }
+    m_elementVerticesAroundVertexRevision = revision;
+
+    m_elementVerticesAroundVertexBegin.assign(nbVertices + 1, 0);
+    for (const auto& element : indexedElements)
+    {
+        for (const auto vertexId : element)
+        {
+            ++m_elementVerticesAroundVertexBegin[vertexId + 1];
+        }
+    }
+    for (std::size_t i = 0; i < nbVertices; ++i)
+    {
+        m_elementVerticesAroundVertexBegin[i + 1] += m_elementVerticesAroundVertexBegin[i];
+    }
+
+    // the elements are visited in increasing order, so they are sorted around each vertex
+    m_elementVerticesAroundVertex.resize(indexedElements.size() * Element::size());
+    std::vector<sofa::Index> next(m_elementVerticesAroundVertexBegin.begin(), m_elementVerticesAroundVertexBegin.end() - 1);
+    for (std::size_t elementId = 0; elementId < indexedElements.size(); ++elementId)
+    {
+        for (sofa::Index v = 0; v < Element::size(); ++v)
+        {
+            const auto vertexId = indexedElements[elementId][v];
+            m_elementVerticesAroundVertex[next[vertexId]++] = static_cast<sofa::Index>(elementId * Element::size() + v);
+        }
+    }
+}
+
 template <class DataTypes>
 void ParallelTetrahedronFEMForceField<DataTypes>::addDForceSmall(VecDeriv& df, const VecDeriv& dx, const Real kFactor, const VecElement& indexedElements)
 {
@@ -152,17 +242,15 @@ void ParallelTetrahedronFEMForceField<DataTypes>::addKToMatrix(sofa::linearalgeb
 
     const auto m = this->method;
 
-    std::mutex mutex;
-
     static constexpr auto S = DataTypes::deriv_total_size; // size of node blocks
     static constexpr auto N = Element::size();
     using Block = sofa::type::fixed_array<sofa::type::fixed_array<sofa::type::Mat<S, S, double>, 4>, 4>;
 
-    sofa::simulation::parallelForEachRange(*m_taskScheduler, indexedElements.begin(), indexedElements.end(),
-        [&indexedElements, m, &Rot, this, &offset, mat, &mutex, kFactor](const auto& range)
+    // the blocks are added in the order of the elements in deterministic execution
+    sofa::simulation::parallelForEachRangeWithMerge(*m_taskScheduler, indexedElements.begin(), indexedElements.end(),
+        [&indexedElements, m, &Rot, this, kFactor](const auto& range)
         {
 
-
             StiffnessMatrix JKJt,tmp;
 
             auto elementId = std::distance(indexedElements.begin(), range.start);
@@ -194,9 +282,10 @@ void ParallelTetrahedronFEMForceField<DataTypes>::addKToMatrix(sofa::linearalgeb
 
                 blocks.emplace_back(tmpBlock);
             }
-
-            std::lock_guard guard(mutex);
-
+            return blocks;
+        },
+        [&offset, mat](const auto& range, sofa::type::vector<Block>& blocks)
+        {
             auto blockIt = blocks.begin();
             for (auto it = range.start; it != range.end; ++it, ++blockIt)
             {
@@ -33,4 +33,16 @@ void ParallelMeshSpringForceField<DataTypes>::init()
     this->initTaskScheduler();
 }
 
+template <class DataTypes>
+void ParallelMeshSpringForceField<DataTypes>::addForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& data_f1, DataVecDeriv& data_f2, const DataVecCoord& data_x1, const DataVecCoord& data_x2, const DataVecDeriv& data_v1, const DataVecDeriv& data_v2)
+{
+    ParallelStiffSpringForceField<DataTypes>::addForce(mparams, data_f1, data_f2, data_x1, data_x2, data_v1, data_v2);
+}
+
+template <class DataTypes>
+void ParallelMeshSpringForceField<DataTypes>::addDForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& data_df1, DataVecDeriv& data_df2, const DataVecDeriv& data_dx1, const DataVecDeriv& data_dx2)
+{
+    ParallelStiffSpringForceField<DataTypes>::addDForce(mparams, data_df1, data_df2, data_dx1, data_dx2);
+}
+
 }
@@ -55,10 +55,9 @@ void ParallelStiffSpringForceField<DataTypes>::addForce(const sofa::core::Mechan
     f2.resize(x2.size());
     this->m_potentialEnergy = 0;
 
-    std::mutex mutex;
-
-    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), springs.size(),
-        [this, &springs, &x1, &v1, &x2, &v2, &mutex, &f1, &f2](const auto& range)
+    // the forces are accumulated in the order of the springs in deterministic execution
+    sofa::simulation::parallelForEachRangeWithMerge(*m_taskScheduler, static_cast<std::size_t>(0), springs.size(),
+        [this, &springs, &x1, &v1, &x2, &v2](const auto& range)
         {
             sofa::type::vector<std::unique_ptr<SpringForce> > springForces;
             springForces.reserve(range.end - range.start);
@@ -67,9 +66,10 @@ void ParallelStiffSpringForceField<DataTypes>::addForce(const sofa::core::Mechan
                 std::unique_ptr<SpringForce> springForce = this->computeSpringForce(x1, v1, x2, v2, springs[i]);
                 springForces.push_back(std::move(springForce));
             }
-
-            std::lock_guard lock(mutex);
-
+            return springForces;
+        },
+        [this, &springs, &f1, &f2](const auto& range, sofa::type::vector<std::unique_ptr<SpringForce> >& springForces)
+        {
             std::size_t i = range.start;
             for (auto& springForce : springForces)
             {
@@ -116,10 +116,8 @@ void ParallelStiffSpringForceField<DataTypes>::addDForce(
 
     const sofa::type::vector<Spring>& springs= this->springs.getValue();
 
-    std::mutex mutex;
-
-    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), springs.size(),
-        [this, &springs, &df1, &df2, &dx1, &dx2, kFactor, bFactor, &mutex](const auto& range)
+    sofa::simulation::parallelForEachRangeWithMerge(*m_taskScheduler, static_cast<std::size_t>(0), springs.size(),
+        [this, &springs, &df1, &df2, &dx1, &dx2, kFactor, bFactor](const auto& range)
         {
             sofa::type::vector<typename DataTypes::DPos> dforces;
             dforces.reserve(range.end - range.start);
@@ -128,9 +126,10 @@ void ParallelStiffSpringForceField<DataTypes>::addDForce(
                 dforces.push_back(
                     this->computeSpringDForce(df1.wref(), dx1, df2.wref(), dx2, i, springs[i], kFactor, bFactor));
             }
-
-            std::lock_guard lock(mutex);
-
+            return dforces;
+        },
+        [&springs, &df1, &df2](const auto& range, sofa::type::vector<typename DataTypes::DPos>& dforces)
+        {
             auto dforceIt = dforces.begin();
             for (auto i = range.start; i < range.end; ++i)
             {
@@ -25,6 +25,8 @@
 #include <SofaDistanceGrid/DistanceGrid.h>
 using sofa::component::container::DistanceGrid ;
 
+#include <sofa/helper/io/Mesh.h>
+
 namespace sofa
 {
 namespace component
@@ -72,12 +74,52 @@ struct DistanceGrid_test : public sofa::testing::NumericTest<SReal>
                           DistanceGrid::Coord(mx,my,mz),
                           DistanceGrid::Coord(ex,ey,ez)) ;
     }
+
+    /// Signed distance to the cube [-1,1]^3
+    static SReal cubeDistance(const Vec3& p)
+    {
+        Vec3 outside;
+        SReal inside = -1;
+        for (int c=0; c<3; ++c)
+        {
+            const SReal d = std::abs(p[c]) - 1;
+            outside[c] = std::max(d, (SReal)0);
+            inside = std::max(inside, d);
+        }
+        return inside < 0 ? inside : outside.norm();
+    }
+
+    void checkParallelBuildOnCube(){
+        helper::io::Mesh mesh;
+        auto& vertices = mesh.getVertices();
+        for (int i=0; i<8; ++i)
+            vertices.push_back(Vec3((i&1)?1:-1, (i&2)?1:-1, (i&4)?1:-1));
+        const int quads[6][4] = { {0,2,3,1}, {4,5,7,6}, {0,1,5,4}, {2,6,7,3}, {0,4,6,2}, {1,3,7,5} };
+        for (const auto& q : quads)
+            mesh.getFacets().push_back({ { (sofa::Index)q[0], (sofa::Index)q[1], (sofa::Index)q[2], (sofa::Index)q[3] } });
+
+        DistanceGrid grid(20, 20, 20, DistanceGrid::Coord(-1.5,-1.5,-1.5), DistanceGrid::Coord(1.5,1.5,1.5));
+        grid.calcDistanceParallel(&mesh);
+
+        const SReal tolerance = grid.getCellWidth()[0] * 0.1;
+        for (int z=0; z<grid.getNz(); ++z)
+            for (int y=0; y<grid.getNy(); ++y)
+                for (int x=0; x<grid.getNx(); ++x)
+                {
+                    const Vec3 p = grid.coord(x,y,z);
+                    EXPECT_NEAR(grid[grid.index(x,y,z)], cubeDistance(p), tolerance) << "at " << p;
+                }
+    }
 };
 
 TEST_F(DistanceGrid_test, chekcValidConstructorsCube) {
     ASSERT_NO_THROW(this->chekcValidConstructorsCube()) ;
 }
 
+TEST_F(DistanceGrid_test, checkParallelBuildOnCube) {
+    ASSERT_NO_THROW(this->checkParallelBuildOnCube()) ;
+}
+
 TEST_F(DistanceGrid_test, chekcInvalidConstructorsCube) {
     std::vector< std::vector< float >> values = {
         {-10, 10, 10,  -1,-1,-1,  1, 1,1},
@@ -32,8 +32,15 @@
 
 #include <fstream>
 #include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <algorithm>
+#include <cstdio>
 
 #include <sofa/helper/logging/Messaging.h>
+#include <sofa/helper/system/FileSystem.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 #define FMM_VERBOSE false
 
@@ -117,10 +124,18 @@ bool DistanceGrid::release()
     return true;
 }
 
-//todo(dmarchal) we should make a loader for that...
 DistanceGrid* DistanceGrid::load(const std::string& filename,
                                  double scale, double sampling,
                                  int nx, int ny, int nz, Coord pmin, Coord pmax)
+{
+    return load(filename, scale, sampling, nx, ny, nz, pmin, pmax, BuildOptions());
+}
+
+//todo(dmarchal) we should make a loader for that...
+DistanceGrid* DistanceGrid::load(const std::string& filename,
+                                 double scale, double sampling,
+                                 int nx, int ny, int nz, Coord pmin, Coord pmax,
+                                 const BuildOptions& options)
 {
     double absscale=fabs(scale);
     if (filename == "#cube")
@@ -270,7 +285,30 @@ DistanceGrid* DistanceGrid::load(const std::string& filename,
             }
         }
         DistanceGrid* grid = new DistanceGrid(nx, ny, nz, pmin, pmax);
-        grid->calcDistance(mesh, scale);
+
+        std::string cacheFilename;
+        if (!options.cacheDirectory.empty())
+        {
+            cacheFilename = getCacheFilename(options.cacheDirectory, mesh, scale, nx, ny, nz, pmin, pmax, options.parallel);
+        }
+
+        if (!cacheFilename.empty() && grid->readCache(cacheFilename))
+        {
+            msg_info("DistanceGrid") << "Distance field of " << filename << " read from cache " << cacheFilename;
+        }
+        else
+        {
+            if (options.parallel)
+                grid->calcDistanceParallel(mesh, scale);
+            else
+                grid->calcDistance(mesh, scale);
+
+            if (!cacheFilename.empty() && !grid->writeCache(cacheFilename))
+            {
+                msg_warning("DistanceGrid") << "Could not write the distance field cache " << cacheFilename;
+            }
+        }
+
         if (sampling)
             grid->sampleSurface(sampling);
         else
@@ -1141,6 +1179,562 @@ void DistanceGrid::fmm_push(int index)
     }
 }
 
+namespace
+{
+
+using Triangle = type::fixed_array<Coord, 3>;
+
+/// Squared distance between a point and a triangle
+/// (see Ericson, Real-Time Collision Detection, section 5.1.5)
+SReal pointTriangleSquaredDistance(const Coord& p, const Triangle& t)
+{
+    const Coord& a = t[0];
+    const Coord& b = t[1];
+    const Coord& c = t[2];
+    const Coord ab = b - a;
+    const Coord ac = c - a;
+
+    const Coord ap = p - a;
+    const SReal d1 = ab * ap;
+    const SReal d2 = ac * ap;
+    if (d1 <= 0 && d2 <= 0) return ap.norm2(); // vertex a
+
+    const Coord bp = p - b;
+    const SReal d3 = ab * bp;
+    const SReal d4 = ac * bp;
+    if (d3 >= 0 && d4 <= d3) return bp.norm2(); // vertex b
+
+    const SReal vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) // edge ab
+        return (p - (a + ab * (d1 / (d1 - d3)))).norm2();
+
+    const Coord cp = p - c;
+    const SReal d5 = ab * cp;
+    const SReal d6 = ac * cp;
+    if (d6 >= 0 && d5 <= d6) return cp.norm2(); // vertex c
+
+    const SReal vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) // edge ac
+        return (p - (a + ac * (d2 / (d2 - d6)))).norm2();
+
+    const SReal va = d3 * d6 - d5 * d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) // edge bc
+        return (p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))))).norm2();
+
+    const SReal sum = va + vb + vc;
+    if (sum <= 0) // degenerated triangle
+        return std::min({ap.norm2(), bp.norm2(), cp.norm2()});
+
+    // inside the face
+    return (p - (a + ab * (vb / sum) + ac * (vc / sum))).norm2();
+}
+
+/// Bounding volume hierarchy over triangles, used to find the triangle closest to a point
+class TriangleBVH
+{
+public:
+    explicit TriangleBVH(const type::vector<Triangle>& triangles)
+        : m_triangles(triangles)
+    {
+        m_indices.resize(triangles.size());
+        m_centers.resize(triangles.size());
+        for (std::size_t i = 0; i < triangles.size(); ++i)
+        {
+            m_indices[i] = static_cast<int>(i);
+            m_centers[i] = (triangles[i][0] + triangles[i][1] + triangles[i][2]) / 3;
+        }
+        if (!triangles.empty())
+        {
+            m_nodes.reserve(2 * triangles.size() / LeafSize + 1);
+            m_nodes.emplace_back();
+            build(0, 0, static_cast<int>(triangles.size()));
+        }
+    }
+
+    /// Index of the triangle closest to p, or -1 if no triangle is closer than sqrt(sqDist).
+    /// sqDist is updated with the squared distance to the returned triangle.
+    int closest(const Coord& p, SReal& sqDist) const
+    {
+        if (m_nodes.empty()) return -1;
+
+        int result = -1;
+        int stack[64];
+        int stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            const Node& node = m_nodes[stack[--stackSize]];
+            if (boxSquaredDistance(node, p) >= sqDist) continue;
+
+            if (node.count > 0)
+            {
+                for (int i = node.first; i < node.first + node.count; ++i)
+                {
+                    const SReal d = pointTriangleSquaredDistance(p, m_triangles[m_indices[i]]);
+                    if (d < sqDist)
+                    {
+                        sqDist = d;
+                        result = m_indices[i];
+                    }
+                }
+            }
+            else
+            {
+                // visit the nearest child first
+                const int left = node.first;
+                const int right = node.first + 1;
+                const bool leftFirst = boxSquaredDistance(m_nodes[left], p) <= boxSquaredDistance(m_nodes[right], p);
+                stack[stackSize++] = leftFirst ? right : left;
+                stack[stackSize++] = leftFirst ? left : right;
+            }
+        }
+        return result;
+    }
+
+private:
+    static constexpr int LeafSize = 4;
+
+    struct Node
+    {
+        Coord bbmin, bbmax;
+        int first { 0 }; ///< first triangle of a leaf, or first child of an inner node
+        int count { 0 }; ///< number of triangles of a leaf, 0 for an inner node
+    };
+
+    static SReal boxSquaredDistance(const Node& node, const Coord& p)
+    {
+        SReal d = 0;
+        for (int c = 0; c < 3; ++c)
+        {
+            const SReal v = std::max({node.bbmin[c] - p[c], (SReal)0, p[c] - node.bbmax[c]});
+            d += v * v;
+        }
+        return d;
+    }
+
+    void build(int nodeId, int begin, int end)
+    {
+        Coord bbmin = m_triangles[m_indices[begin]][0];
+        Coord bbmax = bbmin;
+        Coord cmin = m_centers[m_indices[begin]];
+        Coord cmax = cmin;
+        for (int i = begin; i < end; ++i)
+        {
+            for (const Coord& v : m_triangles[m_indices[i]])
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    bbmin[c] = std::min(bbmin[c], v[c]);
+                    bbmax[c] = std::max(bbmax[c], v[c]);
+                }
+            }
+            const Coord& center = m_centers[m_indices[i]];
+            for (int c = 0; c < 3; ++c)
+            {
+                cmin[c] = std::min(cmin[c], center[c]);
+                cmax[c] = std::max(cmax[c], center[c]);
+            }
+        }
+        m_nodes[nodeId].bbmin = bbmin;
+        m_nodes[nodeId].bbmax = bbmax;
+
+        if (end - begin <= LeafSize)
+        {
+            m_nodes[nodeId].first = begin;
+            m_nodes[nodeId].count = end - begin;
+            return;
+        }
+
+        // median split along the largest extent of the triangle centers
+        const Coord extent = cmax - cmin;
+        const int axis = (extent[0] >= extent[1] && extent[0] >= extent[2]) ? 0 : (extent[1] >= extent[2] ? 1 : 2);
+        const int mid = (begin + end) / 2;
+        std::nth_element(m_indices.begin() + begin, m_indices.begin() + mid, m_indices.begin() + end,
+                         [this, axis](int a, int b) { return m_centers[a][axis] < m_centers[b][axis]; });
+
+        const int left = static_cast<int>(m_nodes.size());
+        m_nodes.emplace_back();
+        m_nodes.emplace_back();
+        m_nodes[nodeId].first = left;
+        m_nodes[nodeId].count = 0;
+        build(left, begin, mid);
+        build(left + 1, mid, end);
+    }
+
+    const type::vector<Triangle>& m_triangles;
+    type::vector<int> m_indices;
+    type::vector<Coord> m_centers;
+    type::vector<Node> m_nodes;
+};
+
+/// Orientation of the 2D triangle (0,0),(x1,y1),(x2,y2), with a consistent tie-breaking when the
+/// triangle is degenerated, so that a ray crossing an edge shared by two triangles is counted once.
+/// Returns the sign and computes twice the signed area.
+int orientation(SReal x1, SReal y1, SReal x2, SReal y2, SReal& twiceSignedArea)
+{
+    twiceSignedArea = y1 * x2 - x1 * y2;
+    if (twiceSignedArea > 0) return 1;
+    if (twiceSignedArea < 0) return -1;
+    if (y2 > y1) return 1;
+    if (y2 < y1) return -1;
+    if (x1 > x2) return 1;
+    if (x1 < x2) return -1;
+    return 0;
+}
+
+/// Test if the 2D point (x0,y0) is inside the 2D triangle, and compute its barycentric coordinates
+bool pointInTriangle2D(SReal x0, SReal y0,
+                       SReal x1, SReal y1, SReal x2, SReal y2, SReal x3, SReal y3,
+                       SReal& a, SReal& b, SReal& c)
+{
+    x1 -= x0; x2 -= x0; x3 -= x0;
+    y1 -= y0; y2 -= y0; y3 -= y0;
+    const int signa = orientation(x2, y2, x3, y3, a);
+    if (signa == 0) return false;
+    const int signb = orientation(x3, y3, x1, y1, b);
+    if (signb != signa) return false;
+    const int signc = orientation(x1, y1, x2, y2, c);
+    if (signc != signa) return false;
+    const SReal sum = a + b + c;
+    if (sum == 0) return false;
+    a /= sum;
+    b /= sum;
+    c /= sum;
+    return true;
+}
+
+/// 64-bit FNV-1a hash
+struct FNV1aHash
+{
+    std::uint64_t value { 14695981039346656037ull };
+
+    void add(const void* data, std::size_t size)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            value ^= bytes[i];
+            value *= 1099511628211ull;
+        }
+    }
+
+    template<class T>
+    void add(const T& v) { add(&v, sizeof(T)); }
+};
+
+constexpr char CacheMagic[8] = { 'S', 'O', 'F', 'A', 'D', 'G', 'R', 'D' };
+constexpr std::uint32_t CacheVersion = 1;
+
+} // namespace
+
+/// Compute distance field from given mesh, using the task scheduler
+void DistanceGrid::calcDistanceParallel(sofa::helper::io::Mesh* mesh, double scale, int exactBand)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    std::fill(m_dists.begin(), m_dists.end(), maxDist());
+    if (m_nxnynz == 0) return;
+
+    const auto& vertices = mesh->getVertices();
+    const auto& facets = mesh->getFacets();
+
+    // Triangulate the facets, in grid coordinates
+    type::vector<Triangle> triangles;
+    for (const auto& facet : facets)
+    {
+        const auto& pts = facet[0];
+        for (std::size_t pt2 = 2; pt2 < pts.size(); ++pt2)
+        {
+            triangles.push_back({ Coord(vertices[pts[0]]) * scale,
+                                  Coord(vertices[pts[pt2 - 1]]) * scale,
+                                  Coord(vertices[pts[pt2]]) * scale });
+        }
+    }
+    dmsg_info("DistanceGrid") << "Parallel build: " << triangles.size() << " triangles.";
+
+    const TriangleBVH bvh(triangles);
+
+    // Closest triangle of each grid point, -1 if unknown
+    type::vector<int> closest(m_nxnynz, -1);
+
+    // Exact distances in a narrow band around the triangles
+    {
+        type::vector<char> inBand(m_nxnynz, 0);
+        for (const Triangle& t : triangles)
+        {
+            Coord bbmin = t[0], bbmax = t[0];
+            for (int c = 0; c < 3; ++c)
+            {
+                bbmin[c] = std::min({t[0][c], t[1][c], t[2][c]});
+                bbmax[c] = std::max({t[0][c], t[1][c], t[2][c]});
+            }
+            const int x0 = std::max(ix(bbmin) - exactBand, 0), x1 = std::min(ix(bbmax) + exactBand + 1, m_nx - 1);
+            const int y0 = std::max(iy(bbmin) - exactBand, 0), y1 = std::min(iy(bbmax) + exactBand + 1, m_ny - 1);
+            const int z0 = std::max(iz(bbmin) - exactBand, 0), z1 = std::min(iz(bbmax) + exactBand + 1, m_nz - 1);
+            for (int z = z0; z <= z1; ++z)
+                for (int y = y0; y <= y1; ++y)
+                    for (int x = x0; x <= x1; ++x)
+                        inBand[index(x, y, z)] = 1;
+        }
+
+        type::vector<int> band;
+        for (int ind = 0; ind < m_nxnynz; ++ind)
+            if (inBand[ind]) band.push_back(ind);
+
+        dmsg_info("DistanceGrid") << "Parallel build: " << band.size() << " points in the exact band.";
+
+        simulation::parallelForEachRange(*taskScheduler, std::size_t(0), band.size(),
+            [&](const simulation::Range<std::size_t>& range)
+            {
+                for (std::size_t b = range.start; b < range.end; ++b)
+                {
+                    const int ind = band[b];
+                    const Coord pos = coord(ind % m_nx, (ind / m_nx) % m_ny, ind / m_nxny);
+                    SReal sqDist = maxDist();
+                    closest[ind] = bvh.closest(pos, sqDist);
+                    if (closest[ind] >= 0)
+                        m_dists[ind] = std::sqrt(sqDist);
+                }
+            });
+    }
+
+    // Fast sweeping: the closest triangle is propagated in the 8 diagonal directions.
+    // Points on the same plane x'+y'+z'=L (in the sweeping frame) only depend on
+    // the points of the previous planes, so each plane is updated in parallel.
+    const auto update = [&](int x, int y, int z, int dx, int dy, int dz)
+    {
+        const int ind = index(x, y, z);
+        const Coord pos = coord(x, y, z);
+        const int px = x - dx, py = y - dy, pz = z - dz;
+        const bool hasX = px >= 0 && px < m_nx;
+        const bool hasY = py >= 0 && py < m_ny;
+        const bool hasZ = pz >= 0 && pz < m_nz;
+        const int neighbors[7][4] = {
+            { hasX, px, y, z }, { hasY, x, py, z }, { hasZ, x, y, pz },
+            { hasX && hasY, px, py, z }, { hasX && hasZ, px, y, pz }, { hasY && hasZ, x, py, pz },
+            { hasX && hasY && hasZ, px, py, pz } };
+
+        SReal best = m_dists[ind];
+        for (const auto& n : neighbors)
+        {
+            if (!n[0]) continue;
+            const int t = closest[index(n[1], n[2], n[3])];
+            if (t < 0 || t == closest[ind]) continue;
+            const SReal d = std::sqrt(pointTriangleSquaredDistance(pos, triangles[t]));
+            if (d < best)
+            {
+                best = d;
+                closest[ind] = t;
+            }
+        }
+        m_dists[ind] = best;
+    };
+
+    static constexpr int nbPasses = 2;
+    static constexpr std::size_t minPointsPerTask = 256;
+    const int nbLevels = m_nx + m_ny + m_nz - 2;
+    for (int pass = 0; pass < nbPasses; ++pass)
+    {
+        for (int dir = 0; dir < 8; ++dir)
+        {
+            const int dx = (dir & 1) ? -1 : 1;
+            const int dy = (dir & 2) ? -1 : 1;
+            const int dz = (dir & 4) ? -1 : 1;
+            for (int level = 0; level < nbLevels; ++level)
+            {
+                // range of x' on the plane x'+y'+z'=level
+                const int sx0 = std::max(0, level - (m_ny - 1) - (m_nz - 1));
+                const int sx1 = std::min(m_nx - 1, level);
+                const std::size_t planeSize = std::size_t(sx1 - sx0 + 1) * std::min(m_ny, m_nz);
+
+                const simulation::ForEachExecutionPolicy execution = planeSize >= minPointsPerTask * taskScheduler->getThreadCount() ?
+                    simulation::ForEachExecutionPolicy::PARALLEL :
+                    simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+                simulation::forEachRange(execution, *taskScheduler, sx0, sx1 + 1,
+                    [&](const simulation::Range<int>& range)
+                    {
+                        for (int sx = range.start; sx < range.end; ++sx)
+                        {
+                            const int sy0 = std::max(0, level - sx - (m_nz - 1));
+                            const int sy1 = std::min(m_ny - 1, level - sx);
+                            for (int sy = sy0; sy <= sy1; ++sy)
+                            {
+                                const int sz = level - sx - sy;
+                                update(dx > 0 ? sx : m_nx - 1 - sx,
+                                       dy > 0 ? sy : m_ny - 1 - sy,
+                                       dz > 0 ? sz : m_nz - 1 - sz,
+                                       dx, dy, dz);
+                            }
+                        }
+                    });
+            }
+        }
+    }
+
+    // Sign: parity of the number of surface crossings along X, before each point.
+    // Each task owns a range of Z slices, so the crossings are counted without conflicts.
+    type::vector<char> crossingParity(m_nxnynz, 0);
+    simulation::parallelForEachRange(*taskScheduler, 0, m_nz,
+        [&](const simulation::Range<int>& range)
+        {
+            for (const Triangle& t : triangles)
+            {
+                // triangle in grid units
+                Coord g[3];
+                for (int v = 0; v < 3; ++v)
+                    for (int c = 0; c < 3; ++c)
+                        g[v][c] = (t[v][c] - m_pmin[c]) * m_invCellWidth[c];
+
+                const int z0 = std::max(range.start, (int)std::ceil(std::min({g[0][2], g[1][2], g[2][2]})));
+                const int z1 = std::min(range.end - 1, (int)std::floor(std::max({g[0][2], g[1][2], g[2][2]})));
+                const int y0 = std::max(0, (int)std::ceil(std::min({g[0][1], g[1][1], g[2][1]})));
+                const int y1 = std::min(m_ny - 1, (int)std::floor(std::max({g[0][1], g[1][1], g[2][1]})));
+
+                for (int z = z0; z <= z1; ++z)
+                {
+                    for (int y = y0; y <= y1; ++y)
+                    {
+                        SReal a, b, c;
+                        if (pointInTriangle2D(y, z, g[0][1], g[0][2], g[1][1], g[1][2], g[2][1], g[2][2], a, b, c))
+                        {
+                            // the crossing is counted on the first point after it along X
+                            const SReal fx = a * g[0][0] + b * g[1][0] + c * g[2][0];
+                            const int x = std::max(0, (int)std::ceil(fx));
+                            if (x < m_nx)
+                                crossingParity[index(x, y, z)] ^= 1;
+                        }
+                    }
+                }
+            }
+
+            for (int z = range.start; z < range.end; ++z)
+            {
+                for (int y = 0; y < m_ny; ++y)
+                {
+                    char inside = 0;
+                    for (int x = 0, ind = index(0, y, z); x < m_nx; ++x, ++ind)
+                    {
+                        inside ^= crossingParity[ind];
+                        if (inside)
+                            m_dists[ind] = -m_dists[ind];
+                    }
+                }
+            }
+        });
+
+    msg_info("DistanceGrid") << "Parallel build: DONE.";
+}
+
+std::string DistanceGrid::getCacheFilename(const std::string& cacheDirectory, Mesh* mesh, double scale,
+                                           int nx, int ny, int nz, const Coord& pmin, const Coord& pmax, bool parallel)
+{
+    FNV1aHash hash;
+    for (const auto& v : mesh->getVertices())
+    {
+        for (int c = 0; c < 3; ++c)
+            hash.add(static_cast<double>(v[c]));
+    }
+    for (const auto& facet : mesh->getFacets())
+    {
+        hash.add(static_cast<std::uint64_t>(facet[0].size()));
+        for (const auto id : facet[0])
+            hash.add(static_cast<std::int64_t>(id));
+    }
+    hash.add(scale);
+    hash.add(nx);
+    hash.add(ny);
+    hash.add(nz);
+    for (int c = 0; c < 3; ++c)
+    {
+        hash.add(static_cast<double>(pmin[c]));
+        hash.add(static_cast<double>(pmax[c]));
+    }
+    hash.add(parallel);
+    hash.add(sizeof(SReal));
+
+    std::ostringstream name;
+    name << "distancegrid_" << std::hex << std::setw(16) << std::setfill('0') << hash.value << ".bin";
+    return helper::system::FileSystem::append(cacheDirectory, name.str());
+}
+
+bool DistanceGrid::readCache(const std::string& filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    char magic[sizeof(CacheMagic)];
+    std::uint32_t version = 0, realSize = 0;
+    int dims[3] = { 0, 0, 0 };
+    double bounds[6];
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&realSize), sizeof(realSize));
+    in.read(reinterpret_cast<char*>(dims), sizeof(dims));
+    in.read(reinterpret_cast<char*>(bounds), sizeof(bounds));
+    if (!in || !std::equal(magic, magic + sizeof(magic), CacheMagic) || version != CacheVersion || realSize != sizeof(SReal)
+        || dims[0] != m_nx || dims[1] != m_ny || dims[2] != m_nz)
+    {
+        msg_warning("DistanceGrid") << "Ignoring invalid or outdated distance field cache " << filename;
+        return false;
+    }
+    for (int c = 0; c < 3; ++c)
+    {
+        if (bounds[c] != (double)m_pmin[c] || bounds[3 + c] != (double)m_pmax[c])
+        {
+            msg_warning("DistanceGrid") << "Ignoring distance field cache " << filename << " computed for other grid bounds";
+            return false;
+        }
+    }
+
+    VecSReal dists(m_nxnynz);
+    in.read(reinterpret_cast<char*>(dists.data()), m_nxnynz * sizeof(SReal));
+    if (!in)
+    {
+        msg_warning("DistanceGrid") << "Ignoring truncated distance field cache " << filename;
+        return false;
+    }
+    m_dists.swap(dists);
+    return true;
+}
+
+bool DistanceGrid::writeCache(const std::string& filename) const
+{
+    const std::string directory = helper::system::FileSystem::getParentDirectory(filename);
+    if (!directory.empty() && !helper::system::FileSystem::exists(directory))
+    {
+        helper::system::FileSystem::createDirectory(directory);
+    }
+
+    // write to a temporary file first, so that concurrent readers never see a partial file
+    const std::string tmpFilename = filename + ".tmp";
+    {
+        std::ofstream out(tmpFilename.c_str(), std::ios::out | std::ios::binary);
+        if (!out.is_open())
+            return false;
+
+        const std::uint32_t version = CacheVersion;
+        const std::uint32_t realSize = sizeof(SReal);
+        const int dims[3] = { m_nx, m_ny, m_nz };
+        const double bounds[6] = { m_pmin[0], m_pmin[1], m_pmin[2], m_pmax[0], m_pmax[1], m_pmax[2] };
+        out.write(CacheMagic, sizeof(CacheMagic));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&realSize), sizeof(realSize));
+        out.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+        out.write(reinterpret_cast<const char*>(bounds), sizeof(bounds));
+        out.write(reinterpret_cast<const char*>(m_dists.data()), m_nxnynz * sizeof(SReal));
+        if (!out)
+            return false;
+    }
+    return std::rename(tmpFilename.c_str(), filename.c_str()) == 0;
+}
+
 /// Sample the surface with points approximately separated by the given sampling distance (expressed in voxels if the value is negative)
 void DistanceGrid::sampleSurface(double sampling)
 {
@@ -1237,6 +1831,13 @@ void DistanceGrid::sampleSurface(double sampling)
 
 DistanceGrid* DistanceGrid::loadShared(const std::string& filename,
                                        double scale, double sampling, int nx, int ny, int nz, Coord pmin, Coord pmax)
+{
+    return loadShared(filename, scale, sampling, nx, ny, nz, pmin, pmax, BuildOptions());
+}
+
+DistanceGrid* DistanceGrid::loadShared(const std::string& filename,
+                                       double scale, double sampling, int nx, int ny, int nz, Coord pmin, Coord pmax,
+                                       const BuildOptions& options)
 {
     DistanceGridParams params;
     params.filename = filename;
@@ -1247,13 +1848,14 @@ DistanceGrid* DistanceGrid::loadShared(const std::string& filename,
     params.nz = nz;
     params.pmin = pmin;
     params.pmax = pmax;
+    params.parallel = options.parallel;
     std::map<DistanceGridParams, DistanceGrid*>& shared = getShared();
     std::map<DistanceGridParams, DistanceGrid*>::iterator it = shared.find(params);
     if (it != shared.end())
         return it->second->addRef();
     else
     {
-        return shared[params] = load(filename, scale, sampling, nx, ny, nz, pmin, pmax);
+        return shared[params] = load(filename, scale, sampling, nx, ny, nz, pmin, pmax, options);
     }
 }
 
@@ -1389,6 +1991,7 @@ bool DistanceGrid::DistanceGridParams::operator==(const DistanceGridParams& v) c
     if (!(pmax[0]  == v.pmax[0] )) return false;
     if (!(pmax[1]  == v.pmax[1] )) return false;
     if (!(pmax[2]  == v.pmax[2] )) return false;
+    if (!(parallel == v.parallel)) return false;
     return true;
 }
 
@@ -1418,6 +2021,8 @@ bool DistanceGrid::DistanceGridParams::operator<(const DistanceGridParams& v) co
     if (pmax[1]  > v.pmax[1] ) return true;
     if (pmax[2]  < v.pmax[2] ) return false;
     if (pmax[2]  > v.pmax[2] ) return true;
+    if (parallel < v.parallel) return false;
+    if (parallel > v.parallel) return true;
     return false;
 }
 
@@ -1447,6 +2052,8 @@ bool DistanceGrid::DistanceGridParams::operator>(const DistanceGridParams& v) co
     if (pmax[1]  < v.pmax[1] ) return true;
     if (pmax[2]  > v.pmax[2] ) return false;
     if (pmax[2]  < v.pmax[2] ) return true;
+    if (parallel > v.parallel) return false;
+    if (parallel < v.parallel) return true;
     return false;
 }
 
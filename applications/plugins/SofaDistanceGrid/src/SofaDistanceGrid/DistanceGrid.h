@@ -64,6 +64,16 @@ public:
 
     ~DistanceGrid();
 
+    /// Options controlling how the distance field of a mesh is computed
+    struct BuildOptions
+    {
+        /// Use the parallel fast-sweeping build (calcDistanceParallel) instead of the serial fast-marching one (calcDistance)
+        bool parallel { false };
+        /// Directory where the computed fields are cached, keyed by a hash of the mesh and of the grid parameters.
+        /// The cache is disabled if empty.
+        std::string cacheDirectory;
+    };
+
 public:
     /// Load a distance grid
     static DistanceGrid* load(const std::string& filename,
@@ -71,6 +81,13 @@ public:
                               int m_nx=64, int m_ny=64, int m_nz=64,
                               Coord m_pmin = Coord(), Coord m_pmax = Coord());
 
+    /// Load a distance grid, computing the field of a mesh with the given options
+    static DistanceGrid* load(const std::string& filename,
+                              double scale, double sampling,
+                              int m_nx, int m_ny, int m_nz,
+                              Coord m_pmin, Coord m_pmax,
+                              const BuildOptions& options);
+
     static DistanceGrid* loadVTKFile(const std::string& filename,
                                      double scale=1.0, double sampling=0.0);
 
@@ -80,6 +97,13 @@ public:
                                     int m_nx=64, int m_ny=64, int m_nz=64,
                                     Coord m_pmin = Coord(), Coord m_pmax = Coord());
 
+    /// Load or reuse a distance grid, computing the field of a mesh with the given options
+    static DistanceGrid* loadShared(const std::string& filename,
+                                    double scale, double sampling,
+                                    int m_nx, int m_ny, int m_nz,
+                                    Coord m_pmin, Coord m_pmax,
+                                    const BuildOptions& options);
+
     /// Add one reference to this grid. Note that loadShared already does this.
     DistanceGrid* addRef();
 
@@ -92,6 +116,13 @@ public:
     /// Compute distance field from given mesh
     void calcDistance(Mesh* mesh, double scale=1.0);
 
+    /// Compute distance field from given mesh, using the task scheduler.
+    /// Exact distances are computed near the surface with a bounding volume hierarchy of the triangles,
+    /// then propagated to the rest of the grid by fast sweeping. The sign is given by the parity of
+    /// the number of surface crossings along the X axis, so the mesh is expected to be closed.
+    /// @param exactBand width, in cells, of the band around the triangles where distances are exact
+    void calcDistanceParallel(Mesh* mesh, double scale=1.0, int exactBand=1);
+
     /// Compute distance field for a cube of the given half-size.
     /// Also create a mesh of points using np points per axis
     void calcCubeDistance(SReal dim=1, int np=5);
@@ -242,6 +273,12 @@ protected:
     void fmm_push(int index);
     void fmm_swap(int entry1, int entry2);
 
+    /// On-disk cache of computed fields
+    static std::string getCacheFilename(const std::string& cacheDirectory, Mesh* mesh, double scale,
+                                        int nx, int ny, int nz, const Coord& pmin, const Coord& pmax, bool parallel);
+    bool readCache(const std::string& filename);
+    bool writeCache(const std::string& filename) const;
+
     /// Grid shared resources
     struct DistanceGridParams
     {
@@ -250,6 +287,7 @@ protected:
         double sampling;
         int nx,ny,nz;
         Coord pmin,pmax;
+        bool parallel { false };
         bool operator==(const DistanceGridParams& v) const ;
         bool operator<(const DistanceGridParams& v) const ;
         bool operator>(const DistanceGridParams& v) const ;
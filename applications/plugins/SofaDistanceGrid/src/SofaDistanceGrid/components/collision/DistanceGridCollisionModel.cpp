@@ -80,6 +80,8 @@ RigidDistanceGridCollisionModel::RigidDistanceGridCollisionModel()
     , ny( initData( &ny, 64, "ny", "number of values on Y axis") )
     , nz( initData( &nz, 64, "nz", "number of values on Z axis") )
     , dumpfilename( initData( &dumpfilename, "dumpfilename","write distance grid to specified file"))
+    , parallelBuild( initData( &parallelBuild, false, "parallelBuild", "compute the distance field of a mesh with the parallel fast-sweeping method instead of the serial fast-marching method"))
+    , cacheDirectory( initData( &cacheDirectory, "cacheDirectory", "if not empty: directory where the computed distance fields are cached, keyed by the mesh and the grid parameters"))
     , usePoints( initData( &usePoints, true, "usePoints", "use mesh vertices for collision detection"))
     , flipNormals( initData( &flipNormals, false, "flipNormals", "reverse surface direction, i.e. points are considered in collision if they move outside of the object instead of inside"))
     , showMeshPoints( initData( &showMeshPoints, true, "showMeshPoints", "Enable rendering of mesh points"))
@@ -119,7 +121,11 @@ void RigidDistanceGridCollisionModel::init()
     if (sampling.getValue()!=0.0) msg_info()<<" sampling="<<sampling.getValue();
     if (box.getValue()[0][0]<box.getValue()[1][0]) msg_info()<<" bbox=<"<<box.getValue()[0]<<">-<"<<box.getValue()[0]<<">";
 
-    grid = DistanceGrid::loadShared(fileRigidDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1]);
+    DistanceGrid::BuildOptions buildOptions;
+    buildOptions.parallel = parallelBuild.getValue();
+    buildOptions.cacheDirectory = cacheDirectory.getValue();
+
+    grid = DistanceGrid::loadShared(fileRigidDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1], buildOptions);
     if (grid->getNx() != this->nx.getValue())
         this->nx.setValue(grid->getNx());
     if (grid->getNy() != this->ny.getValue())
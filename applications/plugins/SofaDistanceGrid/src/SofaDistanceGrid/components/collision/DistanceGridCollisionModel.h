@@ -134,6 +134,8 @@ public:
     Data< int > ny; ///< number of values on Y axis
     Data< int > nz; ///< number of values on Z axis
     sofa::core::objectmodel::DataFileName dumpfilename;
+    Data< bool > parallelBuild; ///< compute the distance field of a mesh with the parallel fast-sweeping method instead of the serial fast-marching method
+    Data< std::string > cacheDirectory; ///< if not empty: directory where the computed distance fields are cached, keyed by the mesh and the grid parameters
 
     Data< bool > usePoints; ///< use mesh vertices for collision detection
     Data< bool > flipNormals; ///< reverse surface direction, i.e. points are considered in collision if they move outside of the object instead of inside
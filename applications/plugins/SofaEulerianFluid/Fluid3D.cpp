@@ -58,7 +58,8 @@ Fluid3D::Fluid3D():
     f_height ( initData(&f_height, 5.0f, "height", "initial fluid height") ),
     f_dir ( initData(&f_dir, vec3(0,1,0), "dir", "initial fluid surface normal") ),
     f_tstart ( initData(&f_tstart, 0.0f, "tstart", "starting time for fluid source") ),
-    f_tstop ( initData(&f_tstop, 60.0f, "tstop", "stopping time for fluid source") )
+    f_tstop ( initData(&f_tstop, 60.0f, "tstop", "stopping time for fluid source") ),
+    f_parallel ( initData(&f_parallel, false, "parallel", "compute the grid update using the task scheduler") )
 {
     fluid = new Grid3D;
     fnext = new Grid3D;
@@ -103,6 +104,7 @@ void Fluid3D::reset()
 void Fluid3D::updatePosition(SReal dt)
 {
     fnext->gravity = getContext()->getGravity()/f_cellwidth.getValue();
+    fnext->parallel = f_parallel.getValue();
     fnext->step(fluid, ftemp, (real)dt);
     Grid3D* p = fluid; fluid=fnext; fnext=p;
 }
@@ -63,6 +63,7 @@ public:
     sofa::core::objectmodel::Data<vec3> f_dir; ///< initial fluid surface normal
     sofa::core::objectmodel::Data<real> f_tstart; ///< starting time for fluid source
     sofa::core::objectmodel::Data<real> f_tstop; ///< stopping time for fluid source
+    sofa::core::objectmodel::Data<bool> f_parallel; ///< compute the grid update using the task scheduler
 protected:
     Fluid3D();
     ~Fluid3D() override;
@@ -22,7 +22,12 @@
 #include <iostream>
 #include <SofaEulerianFluid/Grid3D.h>
 #include <sofa/core/visual/VisualParams.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 #include <cstring>
+#include <algorithm>
+#include <numeric>
+#include <vector>
 
 // set to true/false to activate extra verbose FMM.
 #define EMIT_EXTRA_FMM_MESSAGE false
@@ -81,6 +86,32 @@ const unsigned long* Grid3D::obstacles = NULL;
       }                                         \
 }
 
+// Slab macros: same as above, but each z slab can be processed by a
+// different thread. Loops accumulating a sum store one partial sum per
+// slab, so that the result does not depend on the number of threads.
+
+#define FOR_ALL_SLABS(cmd)                      \
+forEachSlab(0, nz, [&](int z)                   \
+{                                               \
+  int ind = index(0,0,z);                       \
+  for (int y=0;y<ny;y++)                        \
+    for (int x=0;x<nx;x++,ind+=index(1,0,0))    \
+    {                                           \
+  cmd;                                      \
+    }                                           \
+})
+
+#define FOR_INNER_SLABS(cmd)                    \
+forEachSlab(1, nz-1, [&](int z)                 \
+{                                               \
+  int ind = index(1,1,z);                       \
+  for (int y=1;y<ny-1;y++,ind+=index(2,0,0))    \
+    for (int x=1;x<nx-1;x++,ind+=index(1,0,0))  \
+    {                                           \
+  cmd;                                      \
+    }                                           \
+})
+
 // Surface cells  are inner  cells and borders  between a  fluid inner
 // cell and an empty out cell (right or bottom side)
 
@@ -101,6 +132,7 @@ Grid3D::Grid3D()
       t(0), tend(60),
       max_pressure(0.0),
       gravity(0,-5,0),
+      parallel(false),
       fmm_status(NULL),
       fmm_heap(NULL),
       fmm_heap_size(0)
@@ -118,6 +150,28 @@ Grid3D::~Grid3D()
     if (fmm_heap!=NULL) delete[] fmm_heap;
 }
 
+template<class F>
+void Grid3D::forEachSlab(int zBegin, int zEnd, const F& f) const
+{
+    if (parallel && zEnd - zBegin > 1)
+    {
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        if (taskScheduler->getThreadCount() < 1)
+            taskScheduler->init(0);
+        simulation::parallelForEachRange(*taskScheduler, zBegin, zEnd,
+            [&f](const simulation::Range<int>& r)
+            {
+                for (int z = r.start; z < r.end; ++z)
+                    f(z);
+            });
+    }
+    else
+    {
+        for (int z = zBegin; z < zEnd; ++z)
+            f(z);
+    }
+}
+
 void Grid3D::clear(int _nx, int _ny, int _nz)
 {
     t = 0;
@@ -241,7 +295,7 @@ void Grid3D::step_init(const Grid3D* prev, Grid3D* /*temp*/, real /*dt*/, real /
     int lnsize = (nx+7)/8;
     int plsize = lnsize*ny;
 
-    FOR_ALL_CELLS(fdata,
+    FOR_ALL_SLABS(
     {
         //levelset[ind] = 5;
         levelset[ind] = prev->levelset[ind];
@@ -607,7 +661,7 @@ void Grid3D::step_forces(const Grid3D* prev, Grid3D* /*temp*/, real dt, real /*d
     //vec3 f(0,0,-9.81*dt/scale);
     vec3 f = gravity * dt; //(0,-5*dt,0);
 
-    FOR_INNER_CELLS(fdata,
+    FOR_INNER_SLABS(
     {
         vec3 u = f;
         int p0 = fdata[ind].type;
@@ -835,7 +889,7 @@ void Grid3D::step_advect(const Grid3D* /*prev*/, Grid3D* temp, real dt, real /*d
 
     memset(temp->fdata,0,temp->ncell*sizeof(Cell));
 
-    FOR_INNER_CELLS(temp->fdata,
+    FOR_INNER_SLABS(
     {
         // X Axis
         vec3 px( x-0.5f - dt*(fdata[ind].u[0]),
@@ -871,7 +925,7 @@ void Grid3D::step_diffuse(const Grid3D* /*prev*/, Grid3D* temp, real /*dt*/, rea
     real a = diff;
     real inv_c = 1.0f / (1.0001f + 6*a);
 
-    FOR_INNER_CELLS(fdata,
+    FOR_INNER_SLABS(
     {
         fdata[ind].u = (temp->fdata[ind].u +
         (temp->fdata[ind+index(-1,0,0)].u+temp->fdata[ind+index(1,0,0)].u+
@@ -903,10 +957,11 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
     real a = -1.0f/dt;
 
     double b_norm2 = 0.0;
+    std::vector<double> slabSum(nz, 0.0); // per-slab partial sums of the reductions below
 
     //  int nbdiag[7]={0,0,0,0,0,0,0};
 
-    FOR_INNER_CELLS(diag,
+    FOR_INNER_SLABS(
     {
         if (fdata[ind].type>0)
         {
@@ -922,17 +977,18 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
         }
     });
 
-    FOR_INNER_CELLS(b,
+    FOR_INNER_SLABS(
     {
         if (fdata[ind].type>0)
         {
             real bi = a*(fdata[ind+index(1,0,0)].u[0]-fdata[ind].u[0] + fdata[ind+index(0,1,0)].u[1]-fdata[ind].u[1] + fdata[ind+index(0,0,1)].u[2]-fdata[ind].u[2]);
             b[ind] = bi;
-            b_norm2 += bi*bi;
+            slabSum[z] += bi*bi;
         }
     });
+    b_norm2 = std::accumulate(slabSum.begin(), slabSum.end(), 0.0);
 
-    FOR_ALL_CELLS(pressure,
+    FOR_ALL_SLABS(
     {
         if (fdata[ind].type>0)
             pressure[ind] = prev->pressure[ind]; // use previous pressure as initial estimate
@@ -942,7 +998,7 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
     double err = 0.0;
 
     // r = b - Ax
-    FOR_INNER_CELLS(r,
+    FOR_INNER_SLABS(
     {
         if (diag[ind] != 0)
         {
@@ -952,7 +1008,7 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
         }
     });
 
-    FOR_ALL_CELLS(g,
+    FOR_ALL_SLABS(
     {
         g[ind] = r[ind]; // first direction is r
     });
@@ -963,25 +1019,26 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
     for (step=0; step<100; step++)
     {
         double err_old = err;
-        err = 0.0;
-        FOR_READ_INNER_CELLS(
+        std::fill(slabSum.begin(), slabSum.end(), 0.0);
+        FOR_INNER_SLABS(
         {
-            err += r[ind]*r[ind];
+            slabSum[z] += r[ind]*r[ind];
         });
+        err = std::accumulate(slabSum.begin(), slabSum.end(), 0.0);
 
         if (err<=min_err) break;
         if (step>0)
         {
             real beta = (real)(err/err_old);
             // g = g*beta + r
-            FOR_ALL_CELLS(g,
+            FOR_ALL_SLABS(
             {
                 g[ind] = g[ind]*beta + r[ind];
             });
         }
-        double g_q = 0.0;
+        std::fill(slabSum.begin(), slabSum.end(), 0.0);
         // q = Ag
-        FOR_INNER_CELLS(q,
+        FOR_INNER_SLABS(
         {
             if (diag[ind] != 0)
             {
@@ -989,13 +1046,14 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
                 -g[ind+index(-1,0,0)]-g[ind+index(0,-1,0)]-g[ind+index(0,0,-1)]
                 -g[ind+index( 1,0,0)]-g[ind+index(0, 1,0)]-g[ind+index(0,0, 1)]);
                 q[ind] = Ag;
-                g_q += g[ind]*Ag;
+                slabSum[z] += g[ind]*Ag;
             }
         });
+        double g_q = std::accumulate(slabSum.begin(), slabSum.end(), 0.0);
 
         real alpha = (real)(err/g_q);
 
-        FOR_ALL_CELLS(pressure,
+        FOR_ALL_SLABS(
         {
             pressure[ind] += alpha*g[ind];
             r[ind] -= alpha*q[ind];
@@ -1010,7 +1068,7 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
     //max_pressure = 0.0;
     max_pressure = prev->max_pressure;
 
-    FOR_INNER_CELLS(fdata,
+    FOR_INNER_SLABS(
     {
         if (fdata[ind].type>=PART_EMPTY)
         {
@@ -83,6 +83,9 @@ public:
 
     static const unsigned long* obstacles;
 
+    /// Run the per-cell loops of step() on the task scheduler, one range of z slabs per task
+    bool parallel;
+
     Grid3D();
     ~Grid3D();
 
@@ -287,6 +290,9 @@ public:
     void step_project(const Grid3D* prev, Grid3D* temp, real dt, real diff);
     void step_color(const Grid3D* prev, Grid3D* temp, real dt, real diff);
 
+    /// Call f(z) for each z in [zBegin,zEnd), in parallel if the parallel flag is set
+    template<class F> void forEachSlab(int zBegin, int zEnd, const F& f) const;
+
     // internal helper function
     //  template<int C> inline real find_velocity(int x, int y, int z, int ind, int ind2, const Grid3D* prev, const Grid3D* temp);
 
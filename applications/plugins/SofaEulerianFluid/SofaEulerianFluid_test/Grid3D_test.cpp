@@ -0,0 +1,106 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaEulerianFluid/Grid3D.h>
+#include <sofa/testing/BaseTest.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <memory>
+#include <vector>
+
+using sofa::component::behaviormodel::eulerianfluid::Grid3D;
+
+namespace
+{
+
+/// State of a fluid grid after a few steps
+struct FluidState
+{
+    std::vector<Grid3D::vec3> velocity;
+    std::vector<int> type;
+    std::vector<Grid3D::real> pressure;
+    std::vector<Grid3D::real> levelset;
+};
+
+/// Simulate a tilted fluid surface falling under gravity, as Fluid3D does
+FluidState simulate(int n, int nbSteps, bool parallel)
+{
+    auto fluid = std::make_unique<Grid3D>();
+    auto fnext = std::make_unique<Grid3D>();
+    auto ftemp = std::make_unique<Grid3D>();
+
+    fluid->clear(n, n, n);
+    fnext->clear(n, n, n);
+    ftemp->clear(n, n, n);
+    fluid->seed(Grid3D::real(n) / 2, Grid3D::vec3(0.3f, 1, 0.2f));
+
+    Grid3D* current = fluid.get();
+    Grid3D* next = fnext.get();
+    for (int i = 0; i < nbSteps; ++i)
+    {
+        next->parallel = parallel;
+        next->step(current, ftemp.get());
+        std::swap(current, next);
+    }
+
+    FluidState state;
+    for (int c = 0; c < current->ncell; ++c)
+    {
+        state.velocity.push_back(current->fdata[c].u);
+        state.type.push_back(current->fdata[c].type);
+        state.pressure.push_back(current->pressure[c]);
+        state.levelset.push_back(current->levelset[c]);
+    }
+    return state;
+}
+
+}
+
+/// The parallel step processes z slabs on the task scheduler and sums the reductions per slab:
+/// it must give exactly the same result as the sequential step
+TEST(Grid3D_test, parallelStepEqualsSequentialStep)
+{
+    // several threads, even on a machine with a single core
+    sofa::simulation::TaskScheduler* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
+    taskScheduler->init(4);
+
+    const FluidState sequential = simulate(16, 10, false);
+    const FluidState parallel = simulate(16, 10, true);
+
+    ASSERT_EQ(sequential.velocity.size(), parallel.velocity.size());
+
+    // the fluid must have moved, otherwise the comparison is meaningless
+    bool moving = false;
+    for (const auto& u : sequential.velocity)
+    {
+        moving = moving || u.norm2() > 0;
+    }
+    EXPECT_TRUE(moving);
+
+    for (std::size_t c = 0; c < sequential.velocity.size(); ++c)
+    {
+        EXPECT_EQ(sequential.velocity[c], parallel.velocity[c]) << "cell " << c;
+        EXPECT_EQ(sequential.type[c], parallel.type[c]) << "cell " << c;
+        EXPECT_EQ(sequential.pressure[c], parallel.pressure[c]) << "cell " << c;
+        EXPECT_EQ(sequential.levelset[c], parallel.levelset[c]) << "cell " << c;
+    }
+}
@@ -0,0 +1,70 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaEulerianFluid/Grid3D.h>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <utility>
+
+namespace sofa::eulerianfluid::benchmarks
+{
+
+namespace
+{
+
+using component::behaviormodel::eulerianfluid::Grid3D;
+
+/// Step of a n x n x n Eulerian fluid grid, in a single thread (0) or over z slabs on the task scheduler (1)
+void BM_Grid3D_step(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+
+    auto fluid = std::make_unique<Grid3D>();
+    auto fnext = std::make_unique<Grid3D>();
+    auto ftemp = std::make_unique<Grid3D>();
+    fluid->clear(n, n, n);
+    fnext->clear(n, n, n);
+    ftemp->clear(n, n, n);
+    fluid->seed(static_cast<Grid3D::real>(n) / 2, Grid3D::vec3(0.3f, 1, 0.2f));
+
+    Grid3D* current = fluid.get();
+    Grid3D* next = fnext.get();
+    for (auto _ : state)
+    {
+        next->parallel = state.range(1) != 0;
+        next->step(current, ftemp.get());
+        std::swap(current, next);
+        benchmark::DoNotOptimize(current->fdata);
+    }
+
+    state.SetItemsProcessed(state.iterations() * current->ncell);
+    state.SetLabel(state.range(1) ? "parallel" : "sequential");
+}
+
+}
+
+BENCHMARK(BM_Grid3D_step)
+    ->ArgsProduct({ benchmark::CreateRange(32, 256, 2), { 0, 1 } })
+    ->ArgNames({ "cells", "parallel" })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace sofa::eulerianfluid::benchmarks
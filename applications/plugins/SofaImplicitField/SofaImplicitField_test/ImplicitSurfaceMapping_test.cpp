@@ -0,0 +1,107 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnuSceneCreator_test.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+
+#include <sofa/testing/BaseTest.h>
+
+#include <sofa/defaulttype/VecTypes.h>
+using sofa::defaulttype::Vec3dTypes ;
+
+#include <SofaImplicitField/components/mapping/ImplicitSurfaceMapping.h>
+using sofa::component::mapping::ImplicitSurfaceMapping ;
+
+namespace
+{
+
+typedef ImplicitSurfaceMapping<Vec3dTypes, Vec3dTypes> Mapping;
+
+class ImplicitSurfaceMappingTest : public sofa::testing::BaseTest
+{
+public:
+    Mapping::SPtr createMapping(bool parallel)
+    {
+        Mapping::SPtr mapping = sofa::core::objectmodel::New<Mapping>();
+        mapping->setStep(0.25);
+        mapping->setRadius(0.75);
+        mapping->setIsoValue(0.5);
+        mapping->findData("parallel")->read(parallel ? "true" : "false");
+        return mapping;
+    }
+
+    static Vec3dTypes::VecCoord createParticles()
+    {
+        Vec3dTypes::VecCoord particles;
+        for (int z=0; z<4; ++z)
+            for (int y=0; y<3; ++y)
+                for (int x=0; x<5; ++x)
+                    particles.emplace_back(0.6*x + 0.05*y, 0.55*y + 0.03*z, 0.5*z + 0.02*x);
+        return particles;
+    }
+
+    /// Check that both implementations give exactly the same surface
+    void checkSameSurface(Mapping* serial, Mapping* parallel, const Vec3dTypes::VecCoord& particles)
+    {
+        sofa::Data<Vec3dTypes::VecCoord> in, serialOut, parallelOut;
+        in.setValue(particles);
+        serial->apply(nullptr, serialOut, in);
+        parallel->apply(nullptr, parallelOut, in);
+
+        const auto& serialPoints = serialOut.getValue();
+        const auto& parallelPoints = parallelOut.getValue();
+        ASSERT_FALSE(serialPoints.empty());
+        ASSERT_EQ(serialPoints.size(), parallelPoints.size());
+        for (std::size_t i=0; i<serialPoints.size(); ++i)
+            EXPECT_EQ(serialPoints[i], parallelPoints[i]) << "at vertex " << i;
+
+        const auto& serialTriangles = serial->getTriangles();
+        const auto& parallelTriangles = parallel->getTriangles();
+        ASSERT_FALSE(serialTriangles.empty());
+        ASSERT_EQ(serialTriangles.size(), parallelTriangles.size());
+        for (std::size_t i=0; i<serialTriangles.size(); ++i)
+            for (std::size_t j=0; j<3; ++j)
+                EXPECT_EQ(serialTriangles[i][j], parallelTriangles[i][j]) << "at triangle " << i;
+    }
+};
+
+TEST_F(ImplicitSurfaceMappingTest, parallelMatchesSerial)
+{
+    const Mapping::SPtr serial = createMapping(false);
+    const Mapping::SPtr parallel = createMapping(true);
+    checkSameSurface(serial.get(), parallel.get(), createParticles());
+}
+
+TEST_F(ImplicitSurfaceMappingTest, parallelUpdatesMovedParticles)
+{
+    const Mapping::SPtr serial = createMapping(false);
+    const Mapping::SPtr parallel = createMapping(true);
+    Vec3dTypes::VecCoord particles = createParticles();
+    checkSameSurface(serial.get(), parallel.get(), particles);
+
+    // Same grid: only the planes around the moved particle are re-evaluated
+    particles[17][0] += 0.1;
+    checkSameSurface(serial.get(), parallel.get(), particles);
+
+    // The grid grows: everything is re-evaluated
+    particles[0] -= Vec3dTypes::Coord(1,1,1);
+    checkSameSurface(serial.get(), parallel.get(), particles);
+}
+
+}
@@ -27,6 +27,8 @@
 #include <sofa/component/topology/container/constant/MeshTopology.h>
 #include <sofa/helper/MarchingCubeUtility.h>
 #include <sofa/defaulttype/VecTypes.h>
+#include <map>
+#include <list>
 
 
 namespace sofa
@@ -73,7 +75,11 @@ protected:
           mRadius(initData(&mRadius,2.0,"radius","Radius")),
           mIsoValue(initData(&mIsoValue,0.5,"isoValue","Iso Value")),
           mGridMin(initData(&mGridMin,InCoord(-100,-100,-100),"min","Grid Min")),
-          mGridMax(initData(&mGridMax,InCoord(100,100,100),"max","Grid Max"))
+          mGridMax(initData(&mGridMax,InCoord(100,100,100),"max","Grid Max")),
+          mParallel(initData(&mParallel,false,"parallel","Compute the iso-surface using the task scheduler (two passes: count, then emit into preallocated arrays)")),
+          mFieldOrigin(0,0,0),
+          mFieldSize(0,0,0),
+          mFieldRadius(0)
     {
     }
 
@@ -121,6 +127,7 @@ protected:
 
     Data< InCoord > mGridMin; ///< Grid Min
     Data< InCoord > mGridMax; ///< Grid Max
+    Data< bool > mParallel; ///< Compute the iso-surface using the task scheduler
 
     // Marching cube data
 
@@ -149,6 +156,25 @@ protected:
 
     void newPlane();
 
+    /// Parallel marching cube over the grid of origin gridOrigin and size gridSize.
+    /// A first pass counts the vertices and triangles of each z plane, a second pass writes them
+    /// at their final place. Planes whose particles did not move since the last call are not re-evaluated.
+    void applyParallel(OutVecCoord& out, const std::map<int, std::list< InCoord > >& sortParticles,
+                       const type::Vec3i& gridOrigin, const type::Vec3i& gridSize, InReal r);
+
+    /// Field values at each grid point, used by the parallel marching cube
+    sofa::type::vector<OutReal> mField;
+    /// Index of the vertex on the 3 edges ending at each grid point (-1 if none)
+    sofa::type::vector<int> mEdgeVertex;
+    /// Particles used to compute each plane of mField
+    sofa::type::vector< sofa::type::vector<InCoord> > mPlaneParticles;
+    /// Per plane number of vertices and triangles, then turned into offsets
+    sofa::type::vector<int> mPlaneVertices;
+    sofa::type::vector<int> mPlaneTriangles;
+    type::Vec3i mFieldOrigin;
+    type::Vec3i mFieldSize;
+    InReal mFieldRadius;
+
     template<int C>
     int addPoint(OutVecCoord& out, int x,int y,int z, OutReal v0, OutReal v1, OutReal iso)
     {
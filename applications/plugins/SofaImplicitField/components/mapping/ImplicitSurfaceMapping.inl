@@ -25,6 +25,10 @@
 #include "ImplicitSurfaceMapping.h"
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/helper/rmath.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <list>
 
@@ -117,6 +121,13 @@ void ImplicitSurfaceMapping<In,Out>::apply(const core::MechanicalParams * /*mpar
     const int x0 = helper::rceil(xmin-r) - 1;
     const int nx = helper::rfloor(xmax+r) - x0 + 2;
 
+    if (mParallel.getValue())
+    {
+        applyParallel(out, sortParticles, type::Vec3i(x0,y0,z0), type::Vec3i(nx,ny,nz), r);
+        dOut.endEdit();
+        return;
+    }
+
     (*planes.beginEdit()).resize(2*nx*ny);
     P0 = (*planes.beginEdit()).begin()+0;
     P1 = (*planes.beginEdit()).begin()+nx*ny;
@@ -250,6 +261,199 @@ void ImplicitSurfaceMapping<In,Out>::apply(const core::MechanicalParams * /*mpar
     dOut.endEdit();
 }
 
+template <class In, class Out>
+void ImplicitSurfaceMapping<In,Out>::applyParallel(OutVecCoord& out, const std::map<int, std::list< InCoord > >& sortParticles,
+                                                   const type::Vec3i& gridOrigin, const type::Vec3i& gridSize, InReal r)
+{
+    const int x0 = gridOrigin[0], y0 = gridOrigin[1], z0 = gridOrigin[2];
+    const int nx = gridSize[0], ny = gridSize[1], nz = gridSize[2];
+    const int dx = 1;
+    const int dy = nx;
+    const int dz = nx*ny;
+
+    const OutReal isoval = (OutReal) getIsoValue();
+    const OutReal r2 = (OutReal)sqr(r);
+    const OutReal step = (OutReal) mStep.getValue();
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    if (taskScheduler->getThreadCount() < 1)
+        taskScheduler->init(0);
+    const auto forEachPlane = [taskScheduler](int first, int last, const auto& f)
+    {
+        simulation::parallelForEachRange(*taskScheduler, first, last,
+            [&f](const simulation::Range<int>& range)
+            {
+                for (int z = range.start; z < range.end; ++z)
+                    f(z);
+            });
+    };
+
+    // The field of a plane only depends on its particles, so it is kept if they did not move
+    const bool sameGrid = (gridOrigin == mFieldOrigin && gridSize == mFieldSize && r == mFieldRadius);
+    mFieldOrigin = gridOrigin;
+    mFieldSize = gridSize;
+    mFieldRadius = r;
+    mField.resize(dz*nz);
+    mEdgeVertex.resize(3*dz*nz);
+    mPlaneParticles.resize(nz);
+    mPlaneVertices.assign(nz+1, 0);
+    mPlaneTriangles.assign(nz+1, 0);
+
+    const auto field = [this, dz](int z, int i) { return mField[z*dz+i]; };
+
+    // Compute the data
+    forEachPlane(0, nz, [&](int z)
+    {
+        static const std::list<InCoord> noParticles;
+        const auto found = sortParticles.find(z0+z);
+        const std::list<InCoord>& particles = (found != sortParticles.end()) ? found->second : noParticles;
+        sofa::type::vector<InCoord>& previous = mPlaneParticles[z];
+        if (sameGrid && std::equal(particles.begin(), particles.end(), previous.begin(), previous.end()))
+            return;
+        previous.assign(particles.begin(), particles.end());
+
+        OutReal* plane = mField.data() + z*dz;
+        std::fill(plane, plane+dz, (OutReal)0);
+        for (const InCoord& c : particles)
+        {
+            int cx0 = helper::rceil(c[0]-r);
+            int cx1 = helper::rfloor(c[0]+r);
+            int cy0 = helper::rceil(c[1]-r);
+            int cy1 = helper::rfloor(c[1]+r);
+            OutCoord dp2;
+            dp2[2] = (OutReal)sqr(z0+z-c[2]);
+            int i = (cx0-x0)+(cy0-y0)*nx;
+            for (int y = cy0 ; y <= cy1 ; y++)
+            {
+                dp2[1] = (OutReal)sqr(y-c[1]);
+                int ix = i;
+                for (int x = cx0 ; x <= cx1 ; x++, ix++)
+                {
+                    dp2[0] = (OutReal)sqr(x-c[0]);
+                    OutReal d2 = dp2[0]+dp2[1]+dp2[2];
+                    if (d2 < r2)
+                    {
+                        // Soft object field function from the Wyvill brothers
+                        d2 /= r2;
+                        plane[ix] += (1 + (-4*d2*d2*d2 + 17*d2*d2 - 22*d2)/9);
+                    }
+                }
+                i += nx;
+            }
+        }
+    });
+
+    const auto cubeConfiguration = [&](int z, int i)
+    {
+        int mk = 0;
+        if (field(z-1,i-dx-dy) > isoval) mk = 1;
+        if (field(z-1,i   -dy) > isoval) mk|= 2;
+        if (field(z-1,i      ) > isoval) mk|= 4;
+        if (field(z-1,i-dx   ) > isoval) mk|= 8;
+        if (field(z  ,i-dx-dy) > isoval) mk|= 16;
+        if (field(z  ,i   -dy) > isoval) mk|= 32;
+        if (field(z  ,i      ) > isoval) mk|= 64;
+        if (field(z  ,i-dx   ) > isoval) mk|= 128;
+        return mk;
+    };
+
+    // First pass: count the vertices and triangles of each plane (the first plane is all zero)
+    forEachPlane(1, nz, [&](int z)
+    {
+        int nbVertices = 0;
+        int nbTriangles = 0;
+        for (int y=1; y<ny; y++)
+        {
+            for (int x=1, i=1+y*nx; x<nx; x++, i++)
+            {
+                const bool inside = field(z,i) > isoval;
+                nbVertices += (inside ^ (field(z,i-dx) > isoval));
+                nbVertices += (inside ^ (field(z,i-dy) > isoval));
+                nbVertices += (inside ^ (field(z-1,i) > isoval));
+                for (const int* tri = sofa::helper::MarchingCubeTriTable[cubeConfiguration(z,i)]; *tri>=0; tri+=3)
+                    ++nbTriangles;
+            }
+        }
+        mPlaneVertices[z+1] = nbVertices;
+        mPlaneTriangles[z+1] = nbTriangles;
+    });
+
+    for (int z=0; z<nz; ++z)
+    {
+        mPlaneVertices[z+1] += mPlaneVertices[z];
+        mPlaneTriangles[z+1] += mPlaneTriangles[z];
+    }
+
+    out.resize(mPlaneVertices[nz]);
+    SeqTriangles& triangles = *seqTriangles.beginEdit();
+    triangles.resize(mPlaneTriangles[nz]);
+
+    // Second pass: create the vertices, in the same order as the sequential marching cube
+    std::fill(mEdgeVertex.begin(), mEdgeVertex.begin()+3*dz, -1);
+    forEachPlane(1, nz, [&](int z)
+    {
+        int* edges = mEdgeVertex.data() + 3*z*dz;
+        std::fill(edges, edges+3*dz, -1);
+        int p = mPlaneVertices[z];
+        const auto addPoint = [&](int i, int c, int x, int y, int neighbor)
+        {
+            const OutReal v0 = field(z,i);
+            const OutReal v1 = mField[neighbor];
+            OutCoord pos = OutCoord((OutReal)(x0+x),(OutReal)(y0+y),(OutReal)(z0+z));
+            pos[c] -= (isoval-v0)/(v1-v0);
+            out[p] = pos * step;
+            edges[3*i+c] = p++;
+        };
+        for (int y=1; y<ny; y++)
+        {
+            for (int x=1, i=1+y*nx; x<nx; x++, i++)
+            {
+                const bool inside = field(z,i) > isoval;
+                if (inside ^ (field(z,i-dx) > isoval)) addPoint(i, 0, x, y, z*dz+i-dx);
+                if (inside ^ (field(z,i-dy) > isoval)) addPoint(i, 1, x, y, z*dz+i-dy);
+                if (inside ^ (field(z-1,i) > isoval)) addPoint(i, 2, x, y, (z-1)*dz+i);
+            }
+        }
+    });
+
+    // Then the triangles, which use the vertices of the plane and of the previous one
+    const int edgeplane[12] = {-1,-1,-1,-1,0,0,0,0,0,0,0,0};
+    const int edgecube[12] = {-dy,0,0,-dx,-dy,0,0,-dx,-dx-dy,-dy,0,-dx};
+    const int edgepts[12] = {0,1,0,1,0,1,0,1,2,2,2,2};
+    std::atomic<bool> invalidFaces { false };
+    forEachPlane(1, nz, [&](int z)
+    {
+        int f = mPlaneTriangles[z];
+        const auto vertex = [&](int i, int e) { return mEdgeVertex[3*((z+edgeplane[e])*dz+i+edgecube[e])+edgepts[e]]; };
+        for (int y=1; y<ny; y++)
+        {
+            for (int x=1, i=1+y*nx; x<nx; x++, i++)
+            {
+                for (const int* tri = sofa::helper::MarchingCubeTriTable[cubeConfiguration(z,i)]; *tri>=0; tri+=3)
+                {
+                    const int p1 = vertex(i, tri[0]);
+                    const int p2 = vertex(i, tri[1]);
+                    const int p3 = vertex(i, tri[2]);
+                    if (p1 < 0 || p2 < 0 || p3 < 0)
+                        invalidFaces = true;
+                    triangles[f++] = Triangle(p1, p3, p2);
+                }
+            }
+        }
+    });
+
+    if (invalidFaces)
+    {
+        msg_error() << "Invalid faces were generated and removed";
+        const auto nbp = out.size();
+        triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [nbp](const Triangle& t)
+        {
+            return t[0] >= nbp || t[1] >= nbp || t[2] >= nbp;
+        }), triangles.end());
+    }
+    seqTriangles.endEdit();
+}
+
 template <class In, class Out>
 void ImplicitSurfaceMapping<In,Out>::newPlane()
 {
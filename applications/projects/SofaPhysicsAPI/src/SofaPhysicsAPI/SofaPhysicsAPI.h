@@ -53,10 +53,12 @@ typedef void* ID;           ///< Type used for IDs
 #define API_MESH_NULL -2                ///< If SofaPhysicsOutputMesh requested/accessed is null
 #define API_SCENE_NULL -10              ///< Scene creation failed. I.e Root node is null
 #define API_SCENE_FAILED -11            ///< Scene loading failed. I.e root node is null but scene is still empty
+#define API_ASYNC_FAILED -12            ///< Asynchronous mode could not be started. I.e the GUI is used
 #define API_PLUGIN_INVALID_LOADING -20  ///< Error while loading SOFA plugin. Plugin library file is invalid.
 #define API_PLUGIN_MISSING_SYMBOL -21   ///< Error while loading SOFA plugin. Plugin library has missing symbol such as: initExternalModule
 #define API_PLUGIN_FILE_NOT_FOUND -22   ///< Error while loading SOFA plugin. Plugin library file not found
 #define API_PLUGIN_LOADING_FAILED -23   ///< Error while loading SOFA plugin. Plugin library loading fail for another unknown reason.
+#define API_SHARED_MEMORY_FAILED -30    ///< Shared memory segment could not be created or mapped.
 
 /// Internal implementation sub-class
 class SofaPhysicsSimulation;
@@ -85,16 +87,34 @@ public:
     virtual void createScene();
 
     /// Start the simulation
-    /// Currently this simply sets the animated flag to true, but this might
-    /// start a separate computation thread in a future version
+    /// This simply sets the animated flag to true, the steps are computed
+    /// by step() or by the simulation thread of the asynchronous mode (@sa startAsync)
     void start();
 
     /// Stop/pause the simulation
     void stop();
 
-    /// Compute one simulation time-step
+    /// Compute one simulation time-step. Does nothing in asynchronous mode, where the steps are computed by the simulation thread.
     void step();
 
+    /// Start the asynchronous mode: the simulation steps are computed on a separate thread, as long as the simulation is animated.
+    /// The output meshes are then read through their snapshots (@sa SofaPhysicsOutputMesh::acquireSnapshot),
+    /// and the other methods of this API wait for the end of the current step. Return error code.
+    int startAsync();
+
+    /// Stop the asynchronous mode, waiting for the end of the current step
+    void stopAsync();
+
+    /// Return true if the simulation steps are computed on a separate thread
+    bool isAsync() const;
+
+    /// Publish the output mesh snapshots at each step into a shared memory segment named @param name, with buffers of
+    /// @param bufferSize bytes, to be read by another process (@sa SofaPhysicsSharedMemory.h). Return error code.
+    int openSharedMemory(const char* name, unsigned int bufferSize);
+
+    /// Stop publishing in the shared memory segment and remove it
+    void closeSharedMemory();
+
     /// Reset the simulation to its initial state
     void reset();
 
@@ -125,8 +145,8 @@ public:
     SofaPhysicsOutputMesh** getOutputMeshes();
 
     /// Return true if the simulation is running
-    /// Note that currently you must call the step() method
-    /// periodically to actually animate the scene
+    /// Note that you must call the step() method periodically
+    /// to actually animate the scene, unless in asynchronous mode
     bool isAnimated() const;
 
     /// Set the animated state to a given value (requires a
@@ -226,6 +246,21 @@ public:
     int getQuads(int* values); ///< get the quad topology inside ouput @param values, of type int[ 4*nbQuads ]. Return error code.
     int getQuadsRevision();    ///< changes each time quads data is updated
 
+    /// Snapshots of this mesh, published at the end of each step in asynchronous mode (@sa SofaPhysicsAPI::startAsync).
+    /// Unlike the methods above, they can be read from another thread while the simulation is computing the next step, without copy.
+    /// acquireSnapshot selects the last published snapshot, which remains valid and unchanged until the next call to acquireSnapshot.
+    int acquireSnapshot();                  ///< select the last published snapshot and return its revision (0 if none was published yet)
+    double getSnapshotTime();               ///< simulated time of the snapshot
+    unsigned int getSnapshotNbVertices();   ///< number of vertices of the snapshot
+    const Real* getSnapshotVPositions();    ///< vertices positions of the snapshot (Vec3)
+    const Real* getSnapshotVNormals();      ///< vertices normals of the snapshot (Vec3)
+    int getSnapshotVerticesRevision();      ///< changes each time positions and normals are updated
+    unsigned int getSnapshotNbTriangles();  ///< number of triangles of the snapshot
+    const Index* getSnapshotTriangles();    ///< triangles topology of the snapshot (3 indices / triangle)
+    unsigned int getSnapshotNbQuads();      ///< number of quads of the snapshot
+    const Index* getSnapshotQuads();        ///< quads topology of the snapshot (4 indices / quad)
+    int getSnapshotTopologyRevision();      ///< changes each time triangles or quads are updated
+
     /// Internal implementation sub-class
     class Impl;
     /// Internal implementation sub-class
@@ -149,6 +149,57 @@ void sofaPhysicsAPI_reset(void* api_ptr)
 
 
 
+int sofaPhysicsAPI_startAsync(void* api_ptr)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api) {
+        return api->startAsync();
+    }
+    else
+        return API_NULL;
+}
+
+
+void sofaPhysicsAPI_stopAsync(void* api_ptr)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api) {
+        return api->stopAsync();
+    }
+}
+
+
+int sofaPhysicsAPI_isAsync(void* api_ptr)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api) {
+        return api->isAsync() ? 1 : 0;
+    }
+    else
+        return API_NULL;
+}
+
+
+int sofaPhysicsAPI_openSharedMemory(void* api_ptr, const char* name, unsigned int bufferSize)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api) {
+        return api->openSharedMemory(name, bufferSize);
+    }
+    else
+        return API_NULL;
+}
+
+
+void sofaPhysicsAPI_closeSharedMemory(void* api_ptr)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api) {
+        return api->closeSharedMemory();
+    }
+}
+
+
 float sofaPhysicsAPI_time(void* api_ptr)
 {
     SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
@@ -427,3 +478,122 @@ int sofaVisualModel_getQuads(void* api_ptr, const char* name, int* buffer)
     return API_NULL;
 }
 
+
+int sofaVisualModel_acquireSnapshot(void* api_ptr, const char* name)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api)
+    {
+        SofaPhysicsOutputMesh* mesh = api->getOutputMeshPtr(name);
+        if (mesh == nullptr)
+            return API_MESH_NULL;
+        else
+            return mesh->acquireSnapshot();
+    }
+
+    return API_NULL;
+}
+
+
+int sofaVisualModel_getSnapshotNbVertices(void* api_ptr, const char* name)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api)
+    {
+        SofaPhysicsOutputMesh* mesh = api->getOutputMeshPtr(name);
+        if (mesh == nullptr)
+            return API_MESH_NULL;
+        else
+            return mesh->getSnapshotNbVertices();
+    }
+
+    return API_NULL;
+}
+
+
+const float* sofaVisualModel_getSnapshotVertices(void* api_ptr, const char* name)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api)
+    {
+        SofaPhysicsOutputMesh* mesh = api->getOutputMeshPtr(name);
+        if (mesh != nullptr)
+            return mesh->getSnapshotVPositions();
+    }
+
+    return nullptr;
+}
+
+
+const float* sofaVisualModel_getSnapshotNormals(void* api_ptr, const char* name)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api)
+    {
+        SofaPhysicsOutputMesh* mesh = api->getOutputMeshPtr(name);
+        if (mesh != nullptr)
+            return mesh->getSnapshotVNormals();
+    }
+
+    return nullptr;
+}
+
+
+int sofaVisualModel_getSnapshotNbTriangles(void* api_ptr, const char* name)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api)
+    {
+        SofaPhysicsOutputMesh* mesh = api->getOutputMeshPtr(name);
+        if (mesh == nullptr)
+            return API_MESH_NULL;
+        else
+            return mesh->getSnapshotNbTriangles();
+    }
+
+    return API_NULL;
+}
+
+
+const int* sofaVisualModel_getSnapshotTriangles(void* api_ptr, const char* name)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api)
+    {
+        SofaPhysicsOutputMesh* mesh = api->getOutputMeshPtr(name);
+        if (mesh != nullptr)
+            return (const int*)mesh->getSnapshotTriangles();
+    }
+
+    return nullptr;
+}
+
+
+int sofaVisualModel_getSnapshotNbQuads(void* api_ptr, const char* name)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api)
+    {
+        SofaPhysicsOutputMesh* mesh = api->getOutputMeshPtr(name);
+        if (mesh == nullptr)
+            return API_MESH_NULL;
+        else
+            return mesh->getSnapshotNbQuads();
+    }
+
+    return API_NULL;
+}
+
+
+const int* sofaVisualModel_getSnapshotQuads(void* api_ptr, const char* name)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api)
+    {
+        SofaPhysicsOutputMesh* mesh = api->getOutputMeshPtr(name);
+        if (mesh != nullptr)
+            return (const int*)mesh->getSnapshotQuads();
+    }
+
+    return nullptr;
+}
@@ -60,6 +60,13 @@ EXPORT_API void sofaPhysicsAPI_stop(void* api_ptr); ///< Method to stop simulati
 EXPORT_API void sofaPhysicsAPI_step(void* api_ptr); ///< Method to perform a single simulation step
 EXPORT_API void sofaPhysicsAPI_reset(void* api_ptr); ///< Method to reset current simulation
 
+/// Asynchronous mode: the simulation steps on its own thread and the output meshes are read through their snapshots
+EXPORT_API int sofaPhysicsAPI_startAsync(void* api_ptr); ///< Method to start stepping the simulation on its own thread. Return error code.
+EXPORT_API void sofaPhysicsAPI_stopAsync(void* api_ptr); ///< Method to stop and join the simulation thread
+EXPORT_API int sofaPhysicsAPI_isAsync(void* api_ptr); ///< Return 1 if the simulation thread is running, 0 otherwise, or error code.
+EXPORT_API int sofaPhysicsAPI_openSharedMemory(void* api_ptr, const char* name, unsigned int bufferSize); ///< Method to publish the output meshes into the shared memory segment @param name, of 3 buffers of @param bufferSize bytes. Return error code.
+EXPORT_API void sofaPhysicsAPI_closeSharedMemory(void* api_ptr); ///< Method to stop publishing into the shared memory segment
+
 EXPORT_API float sofaPhysicsAPI_time(void* api_ptr); ///< Getter to the current simulation time
 EXPORT_API float sofaPhysicsAPI_timeStep(void* api_ptr); ///< Getter to the current simulation time stepping
 EXPORT_API void sofaPhysicsAPI_setTimeStep(void* api_ptr, double value); ///< Setter to the current simulation time stepping
@@ -96,3 +103,14 @@ EXPORT_API int sofaVisualModel_getTriangles(void* api_ptr, const char* name, int
 
 EXPORT_API int sofaVisualModel_getNbQuads(void* api_ptr, const char* name); ///< Return the number of quads of the SofaPhysicsOutputMesh with name: @param name
 EXPORT_API int sofaVisualModel_getQuads(void* api_ptr, const char* name, int* buffer); ///< Get the quads using ouput @param values (type int[ 4*nbQuads ]) of the SofaPhysicsOutputMesh with name: @param name. Return error code.
+
+/// API to read the last snapshot published by the simulation thread, without copy.
+/// The returned pointers remain valid until the next call to sofaVisualModel_acquireSnapshot on the same SofaPhysicsOutputMesh.
+EXPORT_API int sofaVisualModel_acquireSnapshot(void* api_ptr, const char* name); ///< Select the last published snapshot of the SofaPhysicsOutputMesh with name: @param name. Return its revision or error code.
+EXPORT_API int sofaVisualModel_getSnapshotNbVertices(void* api_ptr, const char* name); ///< Return the number of vertices of the acquired snapshot
+EXPORT_API const float* sofaVisualModel_getSnapshotVertices(void* api_ptr, const char* name); ///< Return the positions (type float[ 3*nbVertices ]) of the acquired snapshot, or nullptr
+EXPORT_API const float* sofaVisualModel_getSnapshotNormals(void* api_ptr, const char* name); ///< Return the normals (type float[ 3*nbVertices ]) of the acquired snapshot, or nullptr
+EXPORT_API int sofaVisualModel_getSnapshotNbTriangles(void* api_ptr, const char* name); ///< Return the number of triangles of the acquired snapshot
+EXPORT_API const int* sofaVisualModel_getSnapshotTriangles(void* api_ptr, const char* name); ///< Return the triangles (type int[ 3*nbTriangles ]) of the acquired snapshot, or nullptr
+EXPORT_API int sofaVisualModel_getSnapshotNbQuads(void* api_ptr, const char* name); ///< Return the number of quads of the acquired snapshot
+EXPORT_API const int* sofaVisualModel_getSnapshotQuads(void* api_ptr, const char* name); ///< Return the quads (type int[ 4*nbQuads ]) of the acquired snapshot, or nullptr
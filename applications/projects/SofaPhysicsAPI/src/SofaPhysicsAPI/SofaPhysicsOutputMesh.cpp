@@ -165,6 +165,61 @@ int SofaPhysicsOutputMesh::getQuadsRevision()    ///< changes each time quads da
     return impl->getQuadsRevision();
 }
 
+int SofaPhysicsOutputMesh::acquireSnapshot()
+{
+    return impl->acquireSnapshot();
+}
+
+double SofaPhysicsOutputMesh::getSnapshotTime()
+{
+    return impl->getSnapshotTime();
+}
+
+unsigned int SofaPhysicsOutputMesh::getSnapshotNbVertices()
+{
+    return impl->getSnapshotNbVertices();
+}
+
+const Real* SofaPhysicsOutputMesh::getSnapshotVPositions()
+{
+    return impl->getSnapshotVPositions();
+}
+
+const Real* SofaPhysicsOutputMesh::getSnapshotVNormals()
+{
+    return impl->getSnapshotVNormals();
+}
+
+int SofaPhysicsOutputMesh::getSnapshotVerticesRevision()
+{
+    return impl->getSnapshotVerticesRevision();
+}
+
+unsigned int SofaPhysicsOutputMesh::getSnapshotNbTriangles()
+{
+    return impl->getSnapshotNbTriangles();
+}
+
+const Index* SofaPhysicsOutputMesh::getSnapshotTriangles()
+{
+    return impl->getSnapshotTriangles();
+}
+
+unsigned int SofaPhysicsOutputMesh::getSnapshotNbQuads()
+{
+    return impl->getSnapshotNbQuads();
+}
+
+const Index* SofaPhysicsOutputMesh::getSnapshotQuads()
+{
+    return impl->getSnapshotQuads();
+}
+
+int SofaPhysicsOutputMesh::getSnapshotTopologyRevision()
+{
+    return impl->getSnapshotTopologyRevision();
+}
+
 ////////////////////////////////////////
 ////////////////////////////////////////
 ////////////////////////////////////////
@@ -439,3 +494,101 @@ int SofaPhysicsOutputMesh::Impl::getQuadsRevision()    ///< changes each time qu
     data->getValue(); // make sure the data is updated
     return data->getCounter();
 }
+
+
+int SofaPhysicsOutputMesh::Impl::acquireSnapshot()
+{
+    if (m_nextSnapshotId.load(std::memory_order_relaxed) & NewSnapshotFlag)
+    {
+        const unsigned char nextSnapshotId = m_nextSnapshotId.exchange(m_readSnapshotId, std::memory_order_acq_rel);
+        m_readSnapshotId = nextSnapshotId & ~NewSnapshotFlag;
+    }
+    return m_snapshots[m_readSnapshotId].revision;
+}
+
+double SofaPhysicsOutputMesh::Impl::getSnapshotTime()
+{
+    return m_snapshots[m_readSnapshotId].time;
+}
+
+unsigned int SofaPhysicsOutputMesh::Impl::getSnapshotNbVertices()
+{
+    return (unsigned int) (m_snapshots[m_readSnapshotId].positions.size() / 3);
+}
+
+const Real* SofaPhysicsOutputMesh::Impl::getSnapshotVPositions()
+{
+    return m_snapshots[m_readSnapshotId].positions.data();
+}
+
+const Real* SofaPhysicsOutputMesh::Impl::getSnapshotVNormals()
+{
+    return m_snapshots[m_readSnapshotId].normals.data();
+}
+
+int SofaPhysicsOutputMesh::Impl::getSnapshotVerticesRevision()
+{
+    return m_snapshots[m_readSnapshotId].verticesRevision;
+}
+
+unsigned int SofaPhysicsOutputMesh::Impl::getSnapshotNbTriangles()
+{
+    return (unsigned int) (m_snapshots[m_readSnapshotId].triangles.size() / 3);
+}
+
+const Index* SofaPhysicsOutputMesh::Impl::getSnapshotTriangles()
+{
+    return m_snapshots[m_readSnapshotId].triangles.data();
+}
+
+unsigned int SofaPhysicsOutputMesh::Impl::getSnapshotNbQuads()
+{
+    return (unsigned int) (m_snapshots[m_readSnapshotId].quads.size() / 4);
+}
+
+const Index* SofaPhysicsOutputMesh::Impl::getSnapshotQuads()
+{
+    return m_snapshots[m_readSnapshotId].quads.data();
+}
+
+int SofaPhysicsOutputMesh::Impl::getSnapshotTopologyRevision()
+{
+    return m_snapshots[m_readSnapshotId].topologyRevision;
+}
+
+void SofaPhysicsOutputMesh::Impl::publishSnapshot(int revision, double time)
+{
+    if (!sObj)
+        return;
+
+    Snapshot& snapshot = m_snapshots[m_writeSnapshotId];
+    snapshot.revision = revision;
+    snapshot.time = time;
+
+    const int verticesRevision = getVerticesRevision();
+    if (snapshot.verticesRevision != verticesRevision)
+    {
+        const unsigned int nbVertices = getNbVertices();
+        snapshot.positions.resize(3 * nbVertices);
+        getVPositions(snapshot.positions.data());
+        snapshot.normals.resize(3 * nbVertices);
+        if (sObj->m_vnormals.getValue().size() == nbVertices)
+            getVNormals(snapshot.normals.data());
+        else
+            std::fill(snapshot.normals.begin(), snapshot.normals.end(), Real(0));
+        snapshot.verticesRevision = verticesRevision;
+    }
+
+    const int topologyRevision = getTrianglesRevision() + getQuadsRevision();
+    if (snapshot.topologyRevision != topologyRevision)
+    {
+        const Index* triangles = getTriangles();
+        snapshot.triangles.assign(triangles, triangles + 3 * getNbTriangles());
+        const Index* quads = getQuads();
+        snapshot.quads.assign(quads, quads + 4 * getNbQuads());
+        snapshot.topologyRevision = topologyRevision;
+    }
+
+    const unsigned char prevSnapshotId = m_nextSnapshotId.exchange(m_writeSnapshotId | NewSnapshotFlag, std::memory_order_acq_rel);
+    m_writeSnapshotId = prevSnapshotId & ~NewSnapshotFlag;
+}
@@ -27,6 +27,9 @@
 #include <sofa/core/visual/VisualModel.h>
 #include <sofa/core/visual/Shader.h>
 
+#include <atomic>
+#include <vector>
+
 class SOFA_SOFAPHYSICSAPI_API SofaPhysicsOutputMesh::Impl
 {
 public:
@@ -69,6 +72,23 @@ public:
     int getQuads(int* values); ///< get the quad topology inside ouput @param values, of type int[ 4*nbQuads ]
     int getQuadsRevision();    ///< changes each time quads data is updated
 
+    int acquireSnapshot();                  ///< select the last published snapshot and return its revision
+    double getSnapshotTime();               ///< simulated time of the snapshot
+    unsigned int getSnapshotNbVertices();   ///< number of vertices of the snapshot
+    const Real* getSnapshotVPositions();    ///< vertices positions of the snapshot (Vec3)
+    const Real* getSnapshotVNormals();      ///< vertices normals of the snapshot (Vec3)
+    int getSnapshotVerticesRevision();      ///< changes each time positions and normals are updated
+    unsigned int getSnapshotNbTriangles();  ///< number of triangles of the snapshot
+    const Index* getSnapshotTriangles();    ///< triangles topology of the snapshot (3 indices / triangle)
+    unsigned int getSnapshotNbQuads();      ///< number of quads of the snapshot
+    const Index* getSnapshotQuads();        ///< quads topology of the snapshot (4 indices / quad)
+    int getSnapshotTopologyRevision();      ///< changes each time triangles or quads are updated
+
+    /// Copy the current state of the mesh in a snapshot and publish it. Called by the simulation thread at the end of a step.
+    /// @param revision revision of the step
+    /// @param time simulated time of the step
+    void publishSnapshot(int revision, double time);
+
     typedef sofa::core::visual::VisualModel SofaVisualOutputMesh;
     typedef sofa::component::visual::VisualModelImpl SofaOutputMesh;
     typedef SofaOutputMesh::DataTypes DataTypes;
@@ -86,6 +106,29 @@ protected:
     /// Default static name in case component creation failed
     std::string defaultName = "None";
 
+    /// Copy of the mesh published by the simulation thread
+    struct Snapshot
+    {
+        int revision = 0;
+        double time = 0.0;
+        int verticesRevision = -1;
+        int topologyRevision = -1;
+        std::vector<Real> positions;
+        std::vector<Real> normals;
+        std::vector<Index> triangles;
+        std::vector<Index> quads;
+    };
+
+    /// Triple buffer of snapshots: the simulation thread writes in its own buffer and publishes it by exchanging it with the
+    /// last published one, the reader exchanges its buffer with the last published one in acquireSnapshot. Neither waits for the other.
+    /// Each buffer only copies the data whose revision changed since it was last written.
+    Snapshot m_snapshots[3];
+    /// Flag of the published snapshot id (m_nextSnapshotId) meaning that it has not been acquired by the reader yet
+    static constexpr unsigned char NewSnapshotFlag = 4;
+    std::atomic<unsigned char> m_nextSnapshotId { 1 }; ///< Last published snapshot id
+    unsigned char m_readSnapshotId { 0 }; ///< Snapshot id in use by the reader
+    unsigned char m_writeSnapshotId { 2 }; ///< Snapshot id written by the simulation thread
+
 public:
     SofaOutputMesh* getObject() { return sObj.get(); }
     void setObject(SofaOutputMesh* o);
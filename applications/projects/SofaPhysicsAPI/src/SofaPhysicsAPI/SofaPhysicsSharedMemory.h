@@ -0,0 +1,298 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+/// Shared memory transport of the output mesh snapshots, so that another process can consume them.
+/// This header only depends on the standard library and the OS, so that it can be used by the consumer process.
+///
+/// The segment holds a SofaPhysicsSharedMemoryHeader followed by three buffers used as a triple buffer:
+/// the simulation writes a frame in its own buffer and publishes it by exchanging it with the last published one,
+/// the consumer exchanges its buffer with the last published one when a new frame is available.
+/// Neither side ever waits for the other. Only one consumer process is supported.
+///
+/// A frame is a SofaPhysicsSharedFrameHeader followed by nbMeshes meshes, each one being a SofaPhysicsSharedMeshHeader
+/// followed by its positions (Real[3*nbVertices]), normals (Real[3*nbVertices]), triangles (Index[3*nbTriangles])
+/// and quads (Index[4*nbQuads]).
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct SofaPhysicsSharedMemoryHeader
+{
+    static constexpr unsigned int Magic = 0x41464F53; ///< "SOFA"
+    static constexpr unsigned int Version = 1;
+    /// Flag of the published buffer id (nextBufferId) meaning that it has not been used by the consumer yet
+    static constexpr unsigned char NewBufferFlag = 4;
+
+    unsigned int magic;
+    unsigned int version;
+    unsigned int bufferSize; ///< size in bytes of each of the three buffers
+    std::atomic<unsigned char> nextBufferId; ///< last published buffer id
+};
+static_assert(std::atomic<unsigned char>::is_always_lock_free, "shared memory transport requires lock-free atomics");
+
+struct SofaPhysicsSharedFrameHeader
+{
+    double time;              ///< simulated time of the frame
+    int revision;             ///< revision of the frame, increased at each published simulation step
+    unsigned int nbMeshes;    ///< number of meshes following this header
+    unsigned int usedBytes;   ///< number of bytes used by the frame, including this header
+    unsigned int padding;
+};
+
+struct SofaPhysicsSharedMeshHeader
+{
+    typedef float Real;
+    typedef unsigned int Index;
+
+    char name[64];             ///< name of the output mesh (truncated)
+    unsigned int nbVertices;
+    unsigned int nbTriangles;
+    unsigned int nbQuads;
+    int verticesRevision;      ///< changes each time positions and normals are updated
+    int topologyRevision;      ///< changes each time triangles or quads are updated
+
+    const Real* positions() const { return reinterpret_cast<const Real*>(this + 1); }
+    const Real* normals() const { return positions() + 3 * nbVertices; }
+    const Index* triangles() const { return reinterpret_cast<const Index*>(normals() + 3 * nbVertices); }
+    const Index* quads() const { return triangles() + 3 * nbTriangles; }
+
+    Real* positions() { return reinterpret_cast<Real*>(this + 1); }
+    Real* normals() { return positions() + 3 * nbVertices; }
+    Index* triangles() { return reinterpret_cast<Index*>(normals() + 3 * nbVertices); }
+    Index* quads() { return triangles() + 3 * nbTriangles; }
+
+    /// Number of bytes of a mesh of the given sizes, including its header
+    static std::size_t byteSize(unsigned int nbVertices, unsigned int nbTriangles, unsigned int nbQuads)
+    {
+        return sizeof(SofaPhysicsSharedMeshHeader) + 6 * nbVertices * sizeof(Real) + (3 * nbTriangles + 4 * nbQuads) * sizeof(Index);
+    }
+    std::size_t byteSize() const { return byteSize(nbVertices, nbTriangles, nbQuads); }
+
+    const SofaPhysicsSharedMeshHeader* next() const
+    {
+        return reinterpret_cast<const SofaPhysicsSharedMeshHeader*>(reinterpret_cast<const char*>(this) + byteSize());
+    }
+};
+
+
+/// Mapping of a SofaPhysics shared memory segment, either as the simulation (writer) or as the consumer (reader).
+class SofaPhysicsSharedMemory
+{
+public:
+    SofaPhysicsSharedMemory() = default;
+    SofaPhysicsSharedMemory(const SofaPhysicsSharedMemory&) = delete;
+    SofaPhysicsSharedMemory& operator=(const SofaPhysicsSharedMemory&) = delete;
+    ~SofaPhysicsSharedMemory() { close(); }
+
+    /// Create the segment @param name with three buffers of at least @param bufferSize bytes, as the writer. Return true on success.
+    /// The size is rounded up so that every buffer is suitably aligned for the frame header (@sa getBufferSize).
+    bool create(const char* name, unsigned int bufferSize)
+    {
+        close();
+        constexpr unsigned int alignment = alignof(std::max_align_t);
+        bufferSize = (bufferSize + alignment - 1) / alignment * alignment;
+        const std::size_t size = buffersOffset() + 3 * std::size_t(bufferSize);
+        if (!map(name, size, true))
+            return false;
+
+        m_isWriter = true;
+        m_name = name;
+        auto* header = new (m_data) SofaPhysicsSharedMemoryHeader;
+        header->magic = SofaPhysicsSharedMemoryHeader::Magic;
+        header->version = SofaPhysicsSharedMemoryHeader::Version;
+        header->bufferSize = bufferSize;
+        header->nextBufferId.store(1, std::memory_order_release);
+        m_ownBufferId = 2;
+        return true;
+    }
+
+    /// Open the existing segment @param name, as the reader. Return true on success.
+    bool open(const char* name)
+    {
+        close();
+        if (!map(name, 0, false))
+            return false;
+
+        const auto* header = getHeader();
+        if (header->magic != SofaPhysicsSharedMemoryHeader::Magic || header->version != SofaPhysicsSharedMemoryHeader::Version
+            || m_size < buffersOffset() + 3 * std::size_t(header->bufferSize))
+        {
+            close();
+            return false;
+        }
+        m_isWriter = false;
+        m_ownBufferId = 0;
+        return true;
+    }
+
+    void close()
+    {
+        if (m_data == nullptr)
+            return;
+#ifdef WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_handle);
+        m_handle = nullptr;
+#else
+        munmap(m_data, m_size);
+        if (m_isWriter)
+            shm_unlink(m_name.c_str());
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    unsigned int getBufferSize() const { return isOpen() ? getHeader()->bufferSize : 0; }
+
+    /// Writer: buffer in which the next frame is written
+    unsigned char* getWriteBuffer() { return getBuffer(m_ownBufferId); }
+
+    /// Writer: publish the frame written in the write buffer, and get a new write buffer
+    void publish()
+    {
+        const unsigned char prevBufferId = getHeader()->nextBufferId.exchange(m_ownBufferId | SofaPhysicsSharedMemoryHeader::NewBufferFlag, std::memory_order_acq_rel);
+        m_ownBufferId = prevBufferId & ~SofaPhysicsSharedMemoryHeader::NewBufferFlag;
+    }
+
+    /// Reader: get the last published frame (of revision 0 if none was published yet). It remains valid and unchanged until the next call.
+    const SofaPhysicsSharedFrameHeader* acquire()
+    {
+        auto& nextBufferId = getHeader()->nextBufferId;
+        if (nextBufferId.load(std::memory_order_relaxed) & SofaPhysicsSharedMemoryHeader::NewBufferFlag)
+        {
+            const unsigned char newBufferId = nextBufferId.exchange(m_ownBufferId, std::memory_order_acq_rel);
+            m_ownBufferId = newBufferId & ~SofaPhysicsSharedMemoryHeader::NewBufferFlag;
+        }
+        return reinterpret_cast<const SofaPhysicsSharedFrameHeader*>(getBuffer(m_ownBufferId));
+    }
+
+    /// First mesh of a frame returned by acquire()
+    static const SofaPhysicsSharedMeshHeader* firstMesh(const SofaPhysicsSharedFrameHeader* frame)
+    {
+        return reinterpret_cast<const SofaPhysicsSharedMeshHeader*>(frame + 1);
+    }
+
+    /// Offset of the buffers from the start of the segment
+    static constexpr std::size_t buffersOffset() { return 64; }
+
+protected:
+    static_assert(sizeof(SofaPhysicsSharedMemoryHeader) <= 64, "shared memory header must fit before the buffers");
+    static_assert(64 % alignof(std::max_align_t) == 0, "buffers must be aligned for the frame header");
+
+    SofaPhysicsSharedMemoryHeader* getHeader() const { return reinterpret_cast<SofaPhysicsSharedMemoryHeader*>(m_data); }
+
+    unsigned char* getBuffer(unsigned char bufferId) const
+    {
+        return static_cast<unsigned char*>(m_data) + buffersOffset() + std::size_t(bufferId) * getHeader()->bufferSize;
+    }
+
+    bool map(const char* name, std::size_t size, bool create)
+    {
+#ifdef WIN32
+        if (create)
+        {
+            const unsigned long long size64 = size;
+            m_handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, DWORD(size64 >> 32), DWORD(size64 & 0xFFFFFFFF), name);
+        }
+        else
+        {
+            m_handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+        }
+        if (m_handle == nullptr)
+            return false;
+
+        m_data = MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (m_data == nullptr)
+        {
+            CloseHandle(m_handle);
+            m_handle = nullptr;
+            return false;
+        }
+        if (!create)
+        {
+            MEMORY_BASIC_INFORMATION info;
+            VirtualQuery(m_data, &info, sizeof(info));
+            size = info.RegionSize;
+        }
+#else
+        const int fd = create ? shm_open(name, O_CREAT | O_RDWR, 0600) : shm_open(name, O_RDWR, 0);
+        if (fd < 0)
+            return false;
+
+        if (create)
+        {
+            if (ftruncate(fd, off_t(size)) != 0)
+            {
+                ::close(fd);
+                shm_unlink(name);
+                return false;
+            }
+        }
+        else
+        {
+            struct stat st;
+            if (fstat(fd, &st) != 0 || std::size_t(st.st_size) < buffersOffset())
+            {
+                ::close(fd);
+                return false;
+            }
+            size = std::size_t(st.st_size);
+        }
+
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            if (create)
+                shm_unlink(name);
+            return false;
+        }
+        m_data = data;
+#endif
+        m_size = size;
+        return true;
+    }
+
+    void* m_data { nullptr };
+    std::size_t m_size { 0 };
+    bool m_isWriter { false };
+    unsigned char m_ownBufferId { 0 };
+    std::string m_name;
+#ifdef WIN32
+    HANDLE m_handle { nullptr };
+#endif
+};
@@ -47,8 +47,11 @@
 
 #include <sofa/type/Vec.h>
 
+#include <chrono>
 #include <cmath>
+#include <cstring>
 #include <iostream>
+#include <type_traits>
 
 #include <sofa/simpleapi/SimpleApi.h>
 
@@ -143,6 +146,31 @@ void SofaPhysicsAPI::step()
     impl->step();
 }
 
+int SofaPhysicsAPI::startAsync()
+{
+    return impl->startAsync();
+}
+
+void SofaPhysicsAPI::stopAsync()
+{
+    impl->stopAsync();
+}
+
+bool SofaPhysicsAPI::isAsync() const
+{
+    return impl->isAsync();
+}
+
+int SofaPhysicsAPI::openSharedMemory(const char* name, unsigned int bufferSize)
+{
+    return impl->openSharedMemory(name, bufferSize);
+}
+
+void SofaPhysicsAPI::closeSharedMemory()
+{
+    impl->closeSharedMemory();
+}
+
 void SofaPhysicsAPI::reset()
 {
     impl->reset();
@@ -356,6 +384,9 @@ SofaPhysicsSimulation::SofaPhysicsSimulation(bool useGUI_, int GUIFramerate_)
 
 SofaPhysicsSimulation::~SofaPhysicsSimulation()
 {
+    stopAsync();
+    closeSharedMemory();
+
     for (std::map<SofaOutputMesh*, SofaPhysicsOutputMesh*>::const_iterator it = outputMeshMap.begin(), itend = outputMeshMap.end(); it != itend; ++it)
     {
         if (it->second) delete it->second;
@@ -391,6 +422,7 @@ const char *SofaPhysicsSimulation::APIName()
 
 int SofaPhysicsSimulation::load(const char* cfilename)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     std::string filename = cfilename;
     sofa::helper::BackTrace::autodump();
 
@@ -422,6 +454,7 @@ int SofaPhysicsSimulation::load(const char* cfilename)
 
 int SofaPhysicsSimulation::unload()
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (m_RootNode.get())
     {
         sofa::simulation::node::unload(m_RootNode);
@@ -452,6 +485,7 @@ int SofaPhysicsSimulation::loadPlugin(const char* pluginPath)
 
 void SofaPhysicsSimulation::createScene()
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     m_RootNode = sofa::simulation::getSimulation()->createNewGraph("root");
     sofa::simpleapi::createObject(m_RootNode, "CollisionPipeline", { {"name","Collision Pipeline"} });
     sofa::simpleapi::createObject(m_RootNode, "BruteForceBroadPhase", { {"name","Broad Phase Detection"} });
@@ -487,6 +521,7 @@ void SofaPhysicsSimulation::createScene_impl()
 
 void SofaPhysicsSimulation::sendValue(const char* name, double value)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     // send a GUIEvent to the tree
     if (m_RootNode!=0)
     {
@@ -500,6 +535,7 @@ void SofaPhysicsSimulation::sendValue(const char* name, double value)
 
 bool SofaPhysicsSimulation::isAnimated() const
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (getScene())
         return getScene()->getContext()->getAnimate();
     return false;
@@ -507,12 +543,14 @@ bool SofaPhysicsSimulation::isAnimated() const
 
 void SofaPhysicsSimulation::setAnimated(bool val)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (val) start();
     else stop();
 }
 
 double SofaPhysicsSimulation::getTimeStep() const
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (getScene())
         return getScene()->getContext()->getDt();
     else
@@ -521,6 +559,7 @@ double SofaPhysicsSimulation::getTimeStep() const
 
 void SofaPhysicsSimulation::setTimeStep(double dt)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (getScene())
     {
         getScene()->getContext()->setDt(dt);
@@ -529,6 +568,7 @@ void SofaPhysicsSimulation::setTimeStep(double dt)
 
 double SofaPhysicsSimulation::getTime() const
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (getScene())
         return getScene()->getContext()->getTime();
     else
@@ -542,6 +582,7 @@ double SofaPhysicsSimulation::getCurrentFPS() const
 
 double *SofaPhysicsSimulation::getGravity() const
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     double* gravityVec = new double[3];
 
     if (getScene())
@@ -557,6 +598,7 @@ double *SofaPhysicsSimulation::getGravity() const
 
 int SofaPhysicsSimulation::getGravity(double* values) const
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (getScene())
     {
         const auto& g = getScene()->getContext()->getGravity();
@@ -573,6 +615,7 @@ int SofaPhysicsSimulation::getGravity(double* values) const
 
 void SofaPhysicsSimulation::setGravity(double* gravity)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     const auto& g = sofa::type::Vec3d(gravity[0], gravity[1], gravity[2]);
     getScene()->getContext()->setGravity(g);
 }
@@ -580,6 +623,7 @@ void SofaPhysicsSimulation::setGravity(double* gravity)
 
 void SofaPhysicsSimulation::start()
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (isAnimated()) return;
     if (getScene())
     {
@@ -590,6 +634,7 @@ void SofaPhysicsSimulation::start()
 
 void SofaPhysicsSimulation::stop()
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (!isAnimated()) return;
     if (getScene())
     {
@@ -601,15 +646,19 @@ void SofaPhysicsSimulation::stop()
 
 void SofaPhysicsSimulation::reset()
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (getScene())
     {
         sofa::simulation::node::reset(getScene());
         this->update();
+        if (isAsync() || m_sharedMemory)
+            publishSnapshots();
     }
 }
 
 void SofaPhysicsSimulation::resetView()
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (getScene() && currentCamera)
     {
         currentCamera->setDefaultView(getScene()->getGravity());
@@ -627,6 +676,15 @@ void SofaPhysicsSimulation::update()
 }
 
 void SofaPhysicsSimulation::step()
+{
+    if (isAsync())
+        return; // the steps are computed by the simulation thread
+
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
+    animateStep();
+}
+
+void SofaPhysicsSimulation::animateStep()
 {
     sofa::simulation::Node* groot = getScene();
     if (!groot) return;
@@ -658,6 +716,166 @@ void SofaPhysicsSimulation::endStep()
     update();
     updateCurrentFPS();
     updateOutputMeshes();
+    if (isAsync() || m_sharedMemory)
+        publishSnapshots();
+}
+
+int SofaPhysicsSimulation::startAsync()
+{
+    if (isAsync())
+        return API_SUCCESS;
+
+    if (useGUI)
+    {
+        msg_error("SofaPhysicsSimulation") << "Asynchronous mode is not available with the GUI, which must be stepped by the main thread.";
+        return API_ASYNC_FAILED;
+    }
+
+    {
+        const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
+        if (!getScene())
+            return API_SCENE_NULL;
+
+        m_asyncRunning = true;
+        // the current state is available to the reader before the first step
+        publishSnapshots();
+    }
+
+    m_asyncThread = std::thread(&SofaPhysicsSimulation::asyncLoop, this);
+    return API_SUCCESS;
+}
+
+void SofaPhysicsSimulation::stopAsync()
+{
+    if (!m_asyncThread.joinable())
+        return;
+
+    m_asyncRunning = false;
+    m_asyncThread.join();
+}
+
+bool SofaPhysicsSimulation::isAsync() const
+{
+    return m_asyncRunning;
+}
+
+void SofaPhysicsSimulation::asyncLoop()
+{
+    while (m_asyncRunning)
+    {
+        bool stepped = false;
+        {
+            const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
+            sofa::simulation::Node* groot = getScene();
+            if (groot && groot->getContext()->getAnimate())
+            {
+                animateStep();
+                stepped = true;
+            }
+        }
+
+        // let the API calls waiting for the scene take it between two steps
+        if (stepped)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+int SofaPhysicsSimulation::openSharedMemory(const char* name, unsigned int bufferSize)
+{
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
+
+    auto sharedMemory = std::make_unique<SofaPhysicsSharedMemory>();
+    if (!sharedMemory->create(name, bufferSize))
+    {
+        msg_error("SofaPhysicsSimulation") << "Unable to create the shared memory segment '" << name << "' of " << bufferSize << " bytes per buffer.";
+        return API_SHARED_MEMORY_FAILED;
+    }
+    m_sharedMemory = std::move(sharedMemory);
+
+    if (getScene())
+        publishSnapshots();
+
+    return API_SUCCESS;
+}
+
+void SofaPhysicsSimulation::closeSharedMemory()
+{
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
+    m_sharedMemory.reset();
+}
+
+void SofaPhysicsSimulation::publishSnapshots()
+{
+    ++m_snapshotRevision;
+    const double time = getScene() ? getScene()->getTime() : 0.0;
+    for (SofaPhysicsOutputMesh* mesh : outputMeshes)
+    {
+        mesh->impl->publishSnapshot(m_snapshotRevision, time);
+    }
+
+    if (m_sharedMemory)
+        writeSharedMemory();
+}
+
+void SofaPhysicsSimulation::writeSharedMemory()
+{
+    static_assert(std::is_same_v<Real, SofaPhysicsSharedMeshHeader::Real>, "shared memory and API coordinates types must match");
+    static_assert(std::is_same_v<Index, SofaPhysicsSharedMeshHeader::Index>, "shared memory and API indices types must match");
+
+    unsigned char* buffer = m_sharedMemory->getWriteBuffer();
+    const std::size_t bufferSize = m_sharedMemory->getBufferSize();
+
+    std::size_t usedBytes = sizeof(SofaPhysicsSharedFrameHeader);
+    unsigned int nbMeshes = 0;
+    for (SofaPhysicsOutputMesh* mesh : outputMeshes)
+    {
+        SofaPhysicsOutputMesh::Impl* meshImpl = mesh->impl;
+        const unsigned int nbVertices = meshImpl->getNbVertices();
+        const unsigned int nbTriangles = meshImpl->getNbTriangles();
+        const unsigned int nbQuads = meshImpl->getNbQuads();
+
+        const std::size_t meshBytes = SofaPhysicsSharedMeshHeader::byteSize(nbVertices, nbTriangles, nbQuads);
+        if (usedBytes + meshBytes > bufferSize)
+        {
+            msg_warning_when(!m_sharedMemoryOverflow, "SofaPhysicsSimulation") << "The shared memory buffers of " << bufferSize
+                << " bytes are too small for all the output meshes: the last ones are not published.";
+            m_sharedMemoryOverflow = true;
+            break;
+        }
+
+        auto* meshHeader = new (buffer + usedBytes) SofaPhysicsSharedMeshHeader;
+        std::strncpy(meshHeader->name, meshImpl->getNameStr().c_str(), sizeof(meshHeader->name) - 1);
+        meshHeader->name[sizeof(meshHeader->name) - 1] = '\0';
+        meshHeader->nbVertices = nbVertices;
+        meshHeader->nbTriangles = nbTriangles;
+        meshHeader->nbQuads = nbQuads;
+        meshHeader->verticesRevision = meshImpl->getVerticesRevision();
+        meshHeader->topologyRevision = meshImpl->getTrianglesRevision() + meshImpl->getQuadsRevision();
+
+        meshImpl->getVPositions(meshHeader->positions());
+        if (meshImpl->getObject()->m_vnormals.getValue().size() == nbVertices)
+            meshImpl->getVNormals(meshHeader->normals());
+        else
+            std::fill(meshHeader->normals(), meshHeader->normals() + 3 * nbVertices, Real(0));
+        if (nbTriangles > 0)
+            std::memcpy(meshHeader->triangles(), meshImpl->getTriangles(), 3 * nbTriangles * sizeof(Index));
+        if (nbQuads > 0)
+            std::memcpy(meshHeader->quads(), meshImpl->getQuads(), 4 * nbQuads * sizeof(Index));
+
+        usedBytes += meshBytes;
+        ++nbMeshes;
+    }
+
+    auto* frame = new (buffer) SofaPhysicsSharedFrameHeader;
+    frame->time = getScene() ? getScene()->getTime() : 0.0;
+    frame->revision = m_snapshotRevision;
+    frame->nbMeshes = nbMeshes;
+    frame->usedBytes = (unsigned int) usedBytes;
+    frame->padding = 0;
+
+    m_sharedMemory->publish();
 }
 
 void SofaPhysicsSimulation::updateCurrentFPS()
@@ -717,11 +935,13 @@ int SofaPhysicsSimulation::updateOutputMeshes()
 
 unsigned int SofaPhysicsSimulation::getNbOutputMeshes() const
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     return outputMeshes.size();
 }
 
 SofaPhysicsOutputMesh* SofaPhysicsSimulation::getOutputMeshPtr(unsigned int meshID) const
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (meshID >= outputMeshes.size())
         return nullptr;
     else
@@ -730,6 +950,7 @@ SofaPhysicsOutputMesh* SofaPhysicsSimulation::getOutputMeshPtr(unsigned int mesh
 
 SofaPhysicsOutputMesh* SofaPhysicsSimulation::getOutputMeshPtr(const char* name) const
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     const auto nameStr = std::string(name);
     for (SofaPhysicsOutputMesh* mesh : outputMeshes)
     {
@@ -742,6 +963,7 @@ SofaPhysicsOutputMesh* SofaPhysicsSimulation::getOutputMeshPtr(const char* name)
 
 SofaPhysicsOutputMesh** SofaPhysicsSimulation::getOutputMesh(unsigned int meshID)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (meshID >= outputMeshes.size())
         return nullptr;
     else
@@ -750,6 +972,7 @@ SofaPhysicsOutputMesh** SofaPhysicsSimulation::getOutputMesh(unsigned int meshID
 
 SofaPhysicsOutputMesh** SofaPhysicsSimulation::getOutputMeshes()
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     if (outputMeshes.empty())
         return nullptr;
     else
@@ -872,6 +1095,7 @@ SofaPhysicsDataController** SofaPhysicsSimulation::getDataControllers()
 
 void SofaPhysicsSimulation::drawGL()
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_sceneMutex);
     GLint viewport[4];
     glGetIntegerv(GL_VIEWPORT,viewport);
 
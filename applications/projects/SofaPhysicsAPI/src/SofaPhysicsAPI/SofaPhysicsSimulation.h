@@ -24,6 +24,7 @@
 #include <SofaPhysicsAPI/config.h>
 #include "SofaPhysicsAPI.h"
 #include "SofaPhysicsOutputMesh_impl.h"
+#include "SofaPhysicsSharedMemory.h"
 
 #include <sofa/helper/system/thread/CTime.h>
 #include <sofa/simulation/Simulation.h>
@@ -35,6 +36,9 @@
 #include <sofa/helper/logging/LoggingMessageHandler.h>
 
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #if SOFAPHYSICSAPI_HAVE_SOFAVALIDATION == 1
 #include "SofaPhysicsDataMonitor_impl.h"
@@ -62,6 +66,18 @@ public:
     void start();
     void stop();
     void step();
+
+    /// Start the simulation thread of the asynchronous mode. Return error code.
+    int startAsync();
+    /// Stop the simulation thread of the asynchronous mode, waiting for the end of the current step.
+    void stopAsync();
+    /// Return true if the simulation thread of the asynchronous mode is running.
+    bool isAsync() const;
+
+    /// Create the shared memory segment @param name in which the snapshots are published at each step. Return error code.
+    int openSharedMemory(const char* name, unsigned int bufferSize);
+    /// Remove the shared memory segment
+    void closeSharedMemory();
     void reset();
     void resetView();
     void sendValue(const char* name, double value);
@@ -156,7 +172,26 @@ protected:
     int frameCounter;
     double currentFPS;
 
+    /// Serializes the accesses to the scene between the simulation thread of the asynchronous mode and the API calls
+    mutable std::recursive_mutex m_sceneMutex;
+    std::thread m_asyncThread;
+    std::atomic<bool> m_asyncRunning { false };
+    /// Revision of the last published snapshots
+    int m_snapshotRevision { 0 };
+    /// Optional shared memory segment in which the snapshots are published
+    std::unique_ptr<SofaPhysicsSharedMemory> m_sharedMemory;
+    /// True once the shared memory buffers were found too small, to warn only once
+    bool m_sharedMemoryOverflow { false };
+
     void update();
+    /// Compute one step of the simulation, the scene being locked
+    void animateStep();
+    /// Loop of the simulation thread of the asynchronous mode
+    void asyncLoop();
+    /// Publish the snapshots of all output meshes, and write them in the shared memory if any
+    void publishSnapshots();
+    /// Write the current output meshes in the shared memory
+    void writeSharedMemory();
     int updateOutputMeshes();
     void updateCurrentFPS();
     void beginStep();
@@ -0,0 +1,139 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaPhysicsAPI/SofaPhysicsAPI.h>
+#include <SofaPhysicsAPI/SofaPhysicsSharedMemory.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+const std::string sceneFilename = std::string(SOFAPHYSICSAPI_TEST_SCENES_DIR) + "/FallingQuad.scn";
+
+/// The vertices of the quad fall together: the last one stays one unit above the first one
+void expectRigidQuad(const Real* positions)
+{
+    EXPECT_NEAR(positions[9] - positions[0], 1.f, 1e-5f);
+    EXPECT_NEAR(positions[10] - positions[1], 1.f, 1e-5f);
+}
+
+}
+
+TEST(SofaPhysicsAPI, asynchronousSnapshots)
+{
+    SofaPhysicsAPI api(false);
+    ASSERT_EQ(api.load(sceneFilename.c_str()), API_SUCCESS);
+
+    SofaPhysicsOutputMesh* mesh = api.getOutputMeshPtr("mesh");
+    ASSERT_NE(mesh, nullptr);
+
+    api.start();
+    ASSERT_EQ(api.startAsync(), API_SUCCESS);
+    EXPECT_TRUE(api.isAsync());
+
+    // the state before the first step is published when the asynchronous mode starts
+    int revision = mesh->acquireSnapshot();
+    EXPECT_GE(revision, 1);
+
+    constexpr int nbRevisions = 50;
+    double time = mesh->getSnapshotTime();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (revision < nbRevisions && std::chrono::steady_clock::now() < deadline)
+    {
+        const int newRevision = mesh->acquireSnapshot();
+        EXPECT_GE(newRevision, revision);
+        revision = newRevision;
+
+        // a snapshot is never modified while it is acquired
+        EXPECT_GE(mesh->getSnapshotTime(), time);
+        time = mesh->getSnapshotTime();
+        ASSERT_EQ(mesh->getSnapshotNbVertices(), 4u);
+        ASSERT_EQ(mesh->getSnapshotNbTriangles(), 2u);
+        expectRigidQuad(mesh->getSnapshotVPositions());
+
+        std::this_thread::yield();
+    }
+    EXPECT_GE(revision, nbRevisions);
+
+    api.stopAsync();
+    EXPECT_FALSE(api.isAsync());
+
+    // the quad falls
+    const int lastRevision = mesh->acquireSnapshot();
+    EXPECT_GE(lastRevision, revision);
+    EXPECT_GT(mesh->getSnapshotTime(), 0.);
+    EXPECT_LT(mesh->getSnapshotVPositions()[1], 0.f);
+}
+
+TEST(SofaPhysicsAPI, sharedMemoryFrames)
+{
+#ifdef WIN32
+    const std::string name = "SofaPhysicsAPI_test_" + std::to_string(GetCurrentProcessId());
+#else
+    const std::string name = "/SofaPhysicsAPI_test_" + std::to_string(getpid());
+#endif
+
+    SofaPhysicsAPI api(false);
+    ASSERT_EQ(api.load(sceneFilename.c_str()), API_SUCCESS);
+    ASSERT_EQ(api.openSharedMemory(name.c_str(), 4096), API_SUCCESS);
+
+    SofaPhysicsSharedMemory reader;
+    ASSERT_TRUE(reader.open(name.c_str()));
+
+    // the current state is published when the segment is opened
+    const SofaPhysicsSharedFrameHeader* frame = reader.acquire();
+    const int firstRevision = frame->revision;
+    EXPECT_GE(firstRevision, 1);
+
+    api.start();
+    for (int i = 0; i < 10; ++i)
+    {
+        api.step();
+    }
+
+    frame = reader.acquire();
+    EXPECT_EQ(frame->revision, firstRevision + 10);
+    EXPECT_NEAR(frame->time, 0.1, 1e-9);
+    ASSERT_EQ(frame->nbMeshes, 1u);
+
+    const SofaPhysicsSharedMeshHeader* mesh = SofaPhysicsSharedMemory::firstMesh(frame);
+    EXPECT_STREQ(mesh->name, "mesh");
+    ASSERT_EQ(mesh->nbVertices, 4u);
+    ASSERT_EQ(mesh->nbTriangles, 2u);
+    EXPECT_EQ(mesh->nbQuads, 0u);
+    EXPECT_EQ(mesh->triangles()[3], 1u);
+    expectRigidQuad(mesh->positions());
+    EXPECT_LT(mesh->positions()[1], 0.f);
+
+    EXPECT_EQ(frame->usedBytes, sizeof(SofaPhysicsSharedFrameHeader) + mesh->byteSize());
+
+    api.closeSharedMemory();
+}
@@ -0,0 +1,203 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaPhysicsAPI/SofaPhysicsSharedMemory.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+/// Segment name unique to the test process, so that concurrent test runs do not share it
+std::string segmentName(const char* test)
+{
+#ifdef WIN32
+    return std::string("SofaPhysicsSharedMemory_test_") + test + "_" + std::to_string(GetCurrentProcessId());
+#else
+    return std::string("/SofaPhysicsSharedMemory_test_") + test + "_" + std::to_string(getpid());
+#endif
+}
+
+/// Write a frame of the given revision in the write buffer, with a single mesh whose coordinates are all equal to the revision
+void writeFrame(SofaPhysicsSharedMemory& writer, int revision, unsigned int nbVertices)
+{
+    auto* frame = reinterpret_cast<SofaPhysicsSharedFrameHeader*>(writer.getWriteBuffer());
+    frame->time = 0.01 * revision;
+    frame->revision = revision;
+    frame->nbMeshes = 1;
+
+    auto* mesh = reinterpret_cast<SofaPhysicsSharedMeshHeader*>(frame + 1);
+    std::strncpy(mesh->name, "mesh", sizeof(mesh->name));
+    mesh->nbVertices = nbVertices;
+    mesh->nbTriangles = 0;
+    mesh->nbQuads = 0;
+    mesh->verticesRevision = revision;
+    mesh->topologyRevision = 0;
+    for (unsigned int i = 0; i < 3 * nbVertices; ++i)
+    {
+        mesh->positions()[i] = static_cast<SofaPhysicsSharedMeshHeader::Real>(revision);
+        mesh->normals()[i] = static_cast<SofaPhysicsSharedMeshHeader::Real>(revision);
+    }
+    frame->usedBytes = static_cast<unsigned int>(sizeof(SofaPhysicsSharedFrameHeader) + mesh->byteSize());
+}
+
+std::size_t frameSize(unsigned int nbVertices)
+{
+    return sizeof(SofaPhysicsSharedFrameHeader) + SofaPhysicsSharedMeshHeader::byteSize(nbVertices, 0, 0);
+}
+
+}
+
+TEST(SofaPhysicsSharedMemory, createAndOpen)
+{
+    const std::string name = segmentName("createAndOpen");
+
+    SofaPhysicsSharedMemory reader;
+    EXPECT_FALSE(reader.open(name.c_str()));
+    EXPECT_FALSE(reader.isOpen());
+
+    SofaPhysicsSharedMemory writer;
+    ASSERT_TRUE(writer.create(name.c_str(), 100));
+    EXPECT_TRUE(writer.isOpen());
+
+    // the buffers are rounded up so that the frame headers are aligned
+    EXPECT_GE(writer.getBufferSize(), 100u);
+    EXPECT_EQ(writer.getBufferSize() % alignof(std::max_align_t), 0u);
+
+    ASSERT_TRUE(reader.open(name.c_str()));
+    EXPECT_EQ(reader.getBufferSize(), writer.getBufferSize());
+
+    // nothing published yet
+    const SofaPhysicsSharedFrameHeader* frame = reader.acquire();
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->revision, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(frame) % alignof(SofaPhysicsSharedFrameHeader), 0u);
+
+    // the writer removes the segment
+    reader.close();
+    writer.close();
+    EXPECT_FALSE(reader.open(name.c_str()));
+}
+
+TEST(SofaPhysicsSharedMemory, acquireTheLastPublishedFrame)
+{
+    const std::string name = segmentName("acquireTheLastPublishedFrame");
+    constexpr unsigned int nbVertices = 10;
+
+    SofaPhysicsSharedMemory writer;
+    ASSERT_TRUE(writer.create(name.c_str(), static_cast<unsigned int>(frameSize(nbVertices))));
+    SofaPhysicsSharedMemory reader;
+    ASSERT_TRUE(reader.open(name.c_str()));
+
+    writeFrame(writer, 1, nbVertices);
+    writer.publish();
+
+    const SofaPhysicsSharedFrameHeader* frame = reader.acquire();
+    EXPECT_EQ(frame->revision, 1);
+    EXPECT_DOUBLE_EQ(frame->time, 0.01);
+    ASSERT_EQ(frame->nbMeshes, 1u);
+    const SofaPhysicsSharedMeshHeader* mesh = SofaPhysicsSharedMemory::firstMesh(frame);
+    EXPECT_STREQ(mesh->name, "mesh");
+    ASSERT_EQ(mesh->nbVertices, nbVertices);
+    EXPECT_EQ(mesh->positions()[3 * nbVertices - 1], 1.f);
+
+    // the acquired frame is not modified by the writer until the next acquisition
+    writeFrame(writer, 2, nbVertices);
+    writer.publish();
+    writeFrame(writer, 3, nbVertices);
+    writer.publish();
+    writeFrame(writer, 4, nbVertices); // not published
+    EXPECT_EQ(frame->revision, 1);
+    EXPECT_EQ(mesh->positions()[0], 1.f);
+
+    // the frames published in between are skipped
+    frame = reader.acquire();
+    EXPECT_EQ(frame->revision, 3);
+    EXPECT_EQ(SofaPhysicsSharedMemory::firstMesh(frame)->positions()[0], 3.f);
+
+    // without new publication, the same frame is returned
+    EXPECT_EQ(reader.acquire(), frame);
+    EXPECT_EQ(frame->revision, 3);
+
+    writer.publish();
+    EXPECT_EQ(reader.acquire()->revision, 4);
+}
+
+TEST(SofaPhysicsSharedMemory, concurrentWriter)
+{
+    const std::string name = segmentName("concurrentWriter");
+    constexpr unsigned int nbVertices = 1000;
+    constexpr int nbFrames = 20000;
+
+    SofaPhysicsSharedMemory writer;
+    ASSERT_TRUE(writer.create(name.c_str(), static_cast<unsigned int>(frameSize(nbVertices))));
+    SofaPhysicsSharedMemory reader;
+    ASSERT_TRUE(reader.open(name.c_str()));
+
+    std::thread writerThread([&writer]()
+    {
+        for (int revision = 1; revision <= nbFrames; ++revision)
+        {
+            writeFrame(writer, revision, nbVertices);
+            writer.publish();
+        }
+    });
+
+    int lastRevision = 0;
+    int nbAcquiredFrames = 0;
+    bool consistent = true;
+    while (lastRevision < nbFrames && consistent)
+    {
+        const SofaPhysicsSharedFrameHeader* frame = reader.acquire();
+        const int revision = frame->revision;
+        EXPECT_GE(revision, lastRevision);
+        if (revision != lastRevision)
+        {
+            ++nbAcquiredFrames;
+        }
+        lastRevision = revision;
+        if (revision == 0)
+        {
+            continue;
+        }
+
+        // a frame is never modified while it is acquired: all its values are the ones of its revision
+        const SofaPhysicsSharedMeshHeader* mesh = SofaPhysicsSharedMemory::firstMesh(frame);
+        const auto value = static_cast<SofaPhysicsSharedMeshHeader::Real>(revision);
+        consistent = mesh->verticesRevision == revision && mesh->nbVertices == nbVertices;
+        for (unsigned int i = 0; consistent && i < 3 * nbVertices; ++i)
+        {
+            consistent = mesh->positions()[i] == value && mesh->normals()[i] == value;
+        }
+        EXPECT_TRUE(consistent) << "frame of revision " << revision << " modified while acquired";
+    }
+
+    writerThread.join();
+    EXPECT_EQ(reader.acquire()->revision, nbFrames);
+    EXPECT_GT(nbAcquiredFrames, 0);
+}
@@ -39,6 +39,7 @@ using std::vector;
 #include <sofa/simulation/graph/DAGSimulation.h>
 using sofa::simulation::Node;
 #include <sofa/simulation/SceneLoaderFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 #include <SceneChecking/SceneCheckerListener.h>
 using sofa::scenechecking::SceneCheckerListener;
 
@@ -157,6 +158,7 @@ int main(int argc, char** argv)
     bool        testMode = false;
     bool        noAutoloadPlugins = false;
     bool        noSceneCheck = false;
+    bool        deterministic = false;
     unsigned int nbMSSASamples = 1;
     bool computationTimeAtBegin = false;
     unsigned int computationTimeSampling=0; ///< Frequency of display of the computation time statistics, in number of animation steps. 0 means never.
@@ -247,6 +249,13 @@ int main(int argc, char** argv)
         "noscenecheck",
         "disable scene checking for each scene loading"
     );
+    argParser->addArgument(
+        cxxopts::value<bool>(deterministic)
+        ->default_value("false")
+        ->implicit_value("true"),
+        "deterministic",
+        "results of the parallel computations do not depend on the number of threads"
+    );
     argParser->addArgument(
         cxxopts::value<bool>(printFactory)
         ->default_value("false")
@@ -328,6 +337,8 @@ int main(int argc, char** argv)
     // even if everything is ok e.g. asking for help
     sofa::simulation::graph::init();
 
+    sofa::simulation::setDeterministicExecution(deterministic);
+
     if (simulationType == "tree")
         msg_warning("runSofa") << "Tree based simulation, switching back to graph simulation.";
     assert(sofa::simulation::getSimulation());